@@ -8,6 +8,9 @@ from .joint_acceleration_lower_limit import *
 from .joint_acceleration_upper_limit import *
 from .joint_torques_lower_limit import *
 from .joint_torques_upper_limit import *
+from .joint_box_limit import *
 from .friction_cone import *
 from .impulse_friction_cone import *
+from .smooth_friction_cone import *
+from .impulse_smooth_friction_cone import *
 from .constraints import *
\ No newline at end of file
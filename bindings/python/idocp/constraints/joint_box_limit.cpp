@@ -0,0 +1,34 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
+
+#include "idocp/constraints/joint_box_limit.hpp"
+
+
+namespace idocp {
+namespace python {
+
+namespace py = pybind11;
+
+PYBIND11_MODULE(joint_box_limit, m) {
+  py::enum_<JointVariable>(m, "JointVariable")
+    .value("Position", JointVariable::Position)
+    .value("Velocity", JointVariable::Velocity)
+    .value("Acceleration", JointVariable::Acceleration)
+    .value("Torques", JointVariable::Torques);
+
+  py::class_<JointBoxLimit, ConstraintComponentBase, 
+             std::shared_ptr<JointBoxLimit>>(m, "JointBoxLimit")
+    .def(py::init<const Robot&, const JointVariable, const double, const double>(),
+         py::arg("robot"), py::arg("variable"), py::arg("barrier")=1.0e-04,
+         py::arg("fraction_to_boundary_rule")=0.995)
+    .def(py::init<const Robot&, const JointVariable, const Eigen::VectorXd&, 
+                  const Eigen::VectorXd&, const double, const double>(),
+         py::arg("robot"), py::arg("variable"), py::arg("xmin"), 
+         py::arg("xmax"), py::arg("barrier")=1.0e-04,
+         py::arg("fraction_to_boundary_rule")=0.995)
+    .def("variable", &JointBoxLimit::variable);
+}
+
+} // namespace python
+} // namespace idocp
@@ -0,0 +1,26 @@
+#include <pybind11/pybind11.h>
+
+#include "idocp/constraints/smooth_friction_cone.hpp"
+
+
+namespace idocp {
+namespace python {
+
+namespace py = pybind11;
+
+PYBIND11_MODULE(smooth_friction_cone, m) {
+  py::class_<SmoothFrictionCone, ConstraintComponentBase, 
+             std::shared_ptr<SmoothFrictionCone>>(m, "SmoothFrictionCone")
+    .def(py::init<const Robot&, const double, const double, const double>(),
+         py::arg("robot"), py::arg("mu"), py::arg("barrier")=1.0e-04,
+         py::arg("fraction_to_boundary_rule")=0.995)
+    .def("set_friction_coefficient", &SmoothFrictionCone::setFrictionCoefficient)
+    .def("set_smoothing_parameter", &SmoothFrictionCone::setSmoothingParameter);
+
+  m.def("create_smooth_friction_cone", [](const Robot& robot, const double mu) {
+    return std::make_shared<SmoothFrictionCone>(robot, mu);
+  });
+}
+
+} // namespace python
+} // namespace idocp
\ No newline at end of file
@@ -17,6 +17,7 @@ PYBIND11_MODULE(time_varying_com_cost, m) {
     .def(py::init<const Robot&, 
                   const std::shared_ptr<TimeVaryingCoMRefBase>&>())
     .def("set_ref", &TimeVaryingCoMCost::set_ref)
+    .def("invalidate_ref_cache", &TimeVaryingCoMCost::invalidateRefCache)
     .def("set_q_weight", &TimeVaryingCoMCost::set_q_weight)
     .def("set_qf_weight", &TimeVaryingCoMCost::set_qf_weight)
     .def("set_qi_weight", &TimeVaryingCoMCost::set_qi_weight);
@@ -17,6 +17,7 @@ PYBIND11_MODULE(time_varying_configuration_space_cost, m) {
     .def(py::init<const Robot&, 
                   const std::shared_ptr<TimeVaryingConfigurationRefBase>&>())
     .def("set_ref", &TimeVaryingConfigurationSpaceCost::set_ref)
+    .def("invalidate_ref_cache", &TimeVaryingConfigurationSpaceCost::invalidateRefCache)
     .def("set_q_weight", &TimeVaryingConfigurationSpaceCost::set_q_weight)
     .def("set_qf_weight", &TimeVaryingConfigurationSpaceCost::set_qf_weight)
     .def("set_qi_weight", &TimeVaryingConfigurationSpaceCost::set_qi_weight);
@@ -16,6 +16,7 @@ PYBIND11_MODULE(time_varying_task_space_3d_cost, m) {
     .def(py::init<const Robot&, const int, 
                   const std::shared_ptr<TimeVaryingTaskSpace3DRefBase>&>())
     .def("set_ref", &TimeVaryingTaskSpace3DCost::set_ref)
+    .def("invalidate_ref_cache", &TimeVaryingTaskSpace3DCost::invalidateRefCache)
     .def("set_q_weight", &TimeVaryingTaskSpace3DCost::set_q_weight)
     .def("set_qf_weight", &TimeVaryingTaskSpace3DCost::set_qf_weight)
     .def("set_qi_weight", &TimeVaryingTaskSpace3DCost::set_qi_weight);
@@ -16,6 +16,7 @@ PYBIND11_MODULE(time_varying_task_space_6d_cost, m) {
     .def(py::init<const Robot&, const int, 
                   const std::shared_ptr<TimeVaryingTaskSpace6DRefBase>&>())
     .def("set_ref", &TimeVaryingTaskSpace6DCost::set_ref)
+    .def("invalidate_ref_cache", &TimeVaryingTaskSpace6DCost::invalidateRefCache)
     .def("set_q_weight", &TimeVaryingTaskSpace6DCost::set_q_weight)
     .def("set_qf_weight", &TimeVaryingTaskSpace6DCost::set_qf_weight)
     .def("set_qi_weight", &TimeVaryingTaskSpace6DCost::set_qi_weight);
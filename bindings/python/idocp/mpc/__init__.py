@@ -1,2 +1,3 @@
 from .mpc_quadrupedal_walking import *
-from .mpc_quadrupedal_trotting import *
\ No newline at end of file
+from .mpc_quadrupedal_trotting import *
+from .async_mpc import *
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
+
+#include "idocp/mpc/async_mpc.hpp"
+#include "idocp/solver/policy_evaluator.hpp"
+#include "idocp/mpc/mpc_quadrupedal_trotting.hpp"
+#include "idocp/mpc/mpc_quadrupedal_walking.hpp"
+
+
+namespace idocp {
+namespace python {
+
+namespace py = pybind11;
+
+template <typename MPCType>
+void defineAsyncMPC(py::module& m, const char* name) {
+  py::class_<AsyncMPC<MPCType>>(m, name)
+    .def(py::init<MPCType&, const Robot&, const int, const int>(),
+         py::arg("mpc"), py::arg("robot"), py::arg("num_iteration")=1,
+         py::arg("num_stages")=1, py::keep_alive<1, 2>())
+    .def("set_real_time_profile", &AsyncMPC<MPCType>::setRealTimeProfile,
+         py::arg("profile"))
+    .def("start", &AsyncMPC<MPCType>::start,
+         py::call_guard<py::gil_scoped_release>())
+    .def("stop", &AsyncMPC<MPCType>::stop,
+         py::call_guard<py::gil_scoped_release>())
+    .def("is_running", &AsyncMPC<MPCType>::isRunning)
+    .def("has_failed", &AsyncMPC<MPCType>::hasFailed)
+    .def("rethrow_if_failed", &AsyncMPC<MPCType>::rethrowIfFailed)
+    .def("set_state", &AsyncMPC<MPCType>::setState,
+         py::arg("t"), py::arg("q"), py::arg("v"),
+         py::call_guard<py::gil_scoped_release>())
+    .def("get_control_policy", &AsyncMPC<MPCType>::getControlPolicy,
+         py::return_value_policy::copy)
+    .def("get_control_input", &AsyncMPC<MPCType>::getControlInput,
+         py::return_value_policy::copy)
+    .def("num_solves", &AsyncMPC<MPCType>::numSolves);
+}
+
+
+PYBIND11_MODULE(async_mpc, m) {
+  py::class_<ControlPolicy>(m, "ControlPolicy")
+    .def(py::init<const Robot&, const int>(),
+         py::arg("robot"), py::arg("num_stages")=1)
+    .def_readonly("t", &ControlPolicy::t)
+    .def_readonly("u", &ControlPolicy::u)
+    .def_readonly("Kq", &ControlPolicy::Kq)
+    .def_readonly("Kv", &ControlPolicy::Kv)
+    .def_readonly("t_traj", &ControlPolicy::t_traj)
+    .def_readonly("q_traj", &ControlPolicy::q_traj)
+    .def_readonly("v_traj", &ControlPolicy::v_traj)
+    .def_readonly("u_traj", &ControlPolicy::u_traj)
+    .def_readonly("Kq_traj", &ControlPolicy::Kq_traj)
+    .def_readonly("Kv_traj", &ControlPolicy::Kv_traj)
+    .def("num_stages", &ControlPolicy::numStages);
+
+  py::class_<PolicyEvaluator>(m, "PolicyEvaluator")
+    .def(py::init<const Robot&, const int>(),
+         py::arg("robot"), py::arg("num_stages")=1)
+    .def("set_policy", &PolicyEvaluator::setPolicy,
+         py::arg("policy"))
+    .def("compute_control_input", 
+         static_cast<const Eigen::VectorXd& (PolicyEvaluator::*)(const double, const Eigen::VectorXd&, const Eigen::VectorXd&)>(&PolicyEvaluator::computeControlInput),
+         py::arg("t"), py::arg("q"), py::arg("v"),
+         py::return_value_policy::copy);
+  defineAsyncMPC<MPCQuadrupedalTrotting>(m, "AsyncMPCQuadrupedalTrotting");
+  defineAsyncMPC<MPCQuadrupedalWalking>(m, "AsyncMPCQuadrupedalWalking");
+}
+
+} // namespace python
+} // namespace idocp
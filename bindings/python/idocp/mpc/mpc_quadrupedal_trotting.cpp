@@ -22,16 +22,27 @@ PYBIND11_MODULE(mpc_quadrupedal_trotting, m) {
     .def("set_gait_pattern", &MPCQuadrupedalTrotting::setGaitPattern,
          py::arg("step_length"), py::arg("step_height"), py::arg("swing_time"), 
          py::arg("t0"))
+    .def("set_discretization_grid", &MPCQuadrupedalTrotting::setDiscretizationGrid)
+    .def("set_geometric_discretization_grid", 
+         &MPCQuadrupedalTrotting::setGeometricDiscretizationGrid)
     .def("init", &MPCQuadrupedalTrotting::init,
-          py::arg("t"), py::arg("q"), py::arg("v"), py::arg("num_iteration"))
+          py::arg("t"), py::arg("q"), py::arg("v"), py::arg("num_iteration"),
+          py::call_guard<py::gil_scoped_release>())
     .def("update_solution", &MPCQuadrupedalTrotting::updateSolution,
-          py::arg("t"), py::arg("q"), py::arg("v"), py::arg("num_iteration"))
+          py::arg("t"), py::arg("q"), py::arg("v"), py::arg("num_iteration"),
+          py::call_guard<py::gil_scoped_release>())
     .def("get_initial_control_input", &MPCQuadrupedalTrotting::getInitialControlInput)
     .def("KKT_error", static_cast<double (MPCQuadrupedalTrotting::*)()>(&MPCQuadrupedalTrotting::KKTError))
     .def("KKT_error", static_cast<double (MPCQuadrupedalTrotting::*)(const double, const Eigen::VectorXd&, const Eigen::VectorXd&)>(&MPCQuadrupedalTrotting::KKTError),
-          py::arg("t"), py::arg("q"), py::arg("v"))
+          py::arg("t"), py::arg("q"), py::arg("v"),
+          py::call_guard<py::gil_scoped_release>())
 //     .def("check_formulation", &MPCQuadrupedalTrotting::checkFormulation)
-    .def("show_info", &MPCQuadrupedalTrotting::showInfo);
+    .def("show_info", &MPCQuadrupedalTrotting::showInfo)
+    .def("start_recording", &MPCQuadrupedalTrotting::startRecording,
+          py::arg("file_name"), py::arg("t"))
+    .def("stop_recording", &MPCQuadrupedalTrotting::stopRecording)
+    .def("apply_real_time_profile", &MPCQuadrupedalTrotting::applyRealTimeProfile,
+          py::arg("profile"), py::arg("t"), py::arg("q"), py::arg("v"));
 }
 
 } // namespace python
@@ -22,16 +22,27 @@ PYBIND11_MODULE(mpc_quadrupedal_walking, m) {
     .def("set_gait_pattern", &MPCQuadrupedalWalking::setGaitPattern,
          py::arg("step_length"), py::arg("step_height"), py::arg("swing_time"), 
          py::arg("t0"))
+    .def("set_discretization_grid", &MPCQuadrupedalWalking::setDiscretizationGrid)
+    .def("set_geometric_discretization_grid", 
+         &MPCQuadrupedalWalking::setGeometricDiscretizationGrid)
     .def("init", &MPCQuadrupedalWalking::init,
-          py::arg("t"), py::arg("q"), py::arg("v"), py::arg("num_iteration"))
+          py::arg("t"), py::arg("q"), py::arg("v"), py::arg("num_iteration"),
+          py::call_guard<py::gil_scoped_release>())
     .def("update_solution", &MPCQuadrupedalWalking::updateSolution,
-          py::arg("t"), py::arg("q"), py::arg("v"), py::arg("num_iteration"))
+          py::arg("t"), py::arg("q"), py::arg("v"), py::arg("num_iteration"),
+          py::call_guard<py::gil_scoped_release>())
     .def("get_initial_control_input", &MPCQuadrupedalWalking::getInitialControlInput)
     .def("KKT_error", static_cast<double (MPCQuadrupedalWalking::*)()>(&MPCQuadrupedalWalking::KKTError))
     .def("KKT_error", static_cast<double (MPCQuadrupedalWalking::*)(const double, const Eigen::VectorXd&, const Eigen::VectorXd&)>(&MPCQuadrupedalWalking::KKTError),
-          py::arg("t"), py::arg("q"), py::arg("v"))
+          py::arg("t"), py::arg("q"), py::arg("v"),
+          py::call_guard<py::gil_scoped_release>())
 //     .def("check_formulation", &MPCQuadrupedalWalking::checkFormulation)
-    .def("show_info", &MPCQuadrupedalWalking::showInfo);
+    .def("show_info", &MPCQuadrupedalWalking::showInfo)
+    .def("start_recording", &MPCQuadrupedalWalking::startRecording,
+          py::arg("file_name"), py::arg("t"))
+    .def("stop_recording", &MPCQuadrupedalWalking::stopRecording)
+    .def("apply_real_time_profile", &MPCQuadrupedalWalking::applyRealTimeProfile,
+          py::arg("profile"), py::arg("t"), py::arg("q"), py::arg("v"));
 }
 
 } // namespace python
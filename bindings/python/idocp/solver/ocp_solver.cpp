@@ -12,6 +12,91 @@ namespace python {
 namespace py = pybind11;
 
 PYBIND11_MODULE(ocp_solver, m) {
+  py::enum_<IterationLevel>(m, "IterationLevel")
+    .value("Full", IterationLevel::Full)
+    .value("Jacobian", IterationLevel::Jacobian)
+    .value("Residual", IterationLevel::Residual);
+
+  py::class_<WarmStartKey>(m, "WarmStartKey")
+    .def(py::init<>())
+    .def(py::init([](const int gait, const double phase, 
+                     const Eigen::VectorXd& command) {
+        return WarmStartKey{gait, phase, command};
+      }), py::arg("gait"), py::arg("phase"), py::arg("command"))
+    .def_readwrite("gait", &WarmStartKey::gait)
+    .def_readwrite("phase", &WarmStartKey::phase)
+    .def_readwrite("command", &WarmStartKey::command);
+
+  py::class_<WarmStartLibraryBuilder>(m, "WarmStartLibraryBuilder")
+    .def(py::init<const Robot&, const int>(),
+          py::arg("robot"), py::arg("dim_command"))
+    .def("save", &WarmStartLibraryBuilder::save,
+          py::arg("file_name"))
+    .def("num_entries", &WarmStartLibraryBuilder::numEntries);
+
+  py::class_<WarmStartLibrary>(m, "WarmStartLibrary")
+    .def(py::init<>())
+    .def(py::init<const std::string&>(),
+          py::arg("file_name"))
+    .def("open", &WarmStartLibrary::open,
+          py::arg("file_name"))
+    .def("close", &WarmStartLibrary::close)
+    .def("is_open", &WarmStartLibrary::isOpen)
+    .def("num_entries", &WarmStartLibrary::numEntries)
+    .def("dim_command", &WarmStartLibrary::dimCommand)
+    .def("key", &WarmStartLibrary::key,
+          py::arg("entry"))
+    .def("find_nearest", &WarmStartLibrary::findNearest,
+          py::arg("key"), py::arg("phase_weight")=1.0);
+
+  py::class_<RealTimeProfile>(m, "RealTimeProfile")
+    .def(py::init<>())
+    .def("set_memory_locking", &RealTimeProfile::setMemoryLocking,
+          py::arg("lock_memory"))
+    .def("set_cpu_affinity", &RealTimeProfile::setCPUAffinity,
+          py::arg("cpus"))
+    .def("set_scheduling_priority", &RealTimeProfile::setSchedulingPriority,
+          py::arg("priority"))
+    .def("set_stack_prefault_size", &RealTimeProfile::setStackPrefaultSize,
+          py::arg("size"))
+    .def("memory_locking", &RealTimeProfile::memoryLocking)
+    .def("cpu_affinity", &RealTimeProfile::cpuAffinity)
+    .def("scheduling_priority", &RealTimeProfile::schedulingPriority)
+    .def("stack_prefault_size", &RealTimeProfile::stackPrefaultSize)
+    .def("show_info", &RealTimeProfile::showInfo);
+
+  py::enum_<PerfCounterEvent>(m, "PerfCounterEvent")
+    .value("Cycles", PerfCounterEvent::Cycles)
+    .value("Instructions", PerfCounterEvent::Instructions)
+    .value("L1DMisses", PerfCounterEvent::L1DMisses)
+    .value("LLCMisses", PerfCounterEvent::LLCMisses)
+    .value("BranchMisses", PerfCounterEvent::BranchMisses);
+
+  py::enum_<OCPSolverPhase>(m, "OCPSolverPhase")
+    .value("Discretization", OCPSolverPhase::Discretization)
+    .value("KKTSystem", OCPSolverPhase::KKTSystem)
+    .value("SwitchingTimeOptimization", 
+           OCPSolverPhase::SwitchingTimeOptimization)
+    .value("BackwardRiccatiRecursion", OCPSolverPhase::BackwardRiccatiRecursion)
+    .value("ForwardRiccatiRecursion", OCPSolverPhase::ForwardRiccatiRecursion)
+    .value("Direction", OCPSolverPhase::Direction)
+    .value("LineSearch", OCPSolverPhase::LineSearch)
+    .value("Integration", OCPSolverPhase::Integration);
+
+  py::class_<PerfCounters, std::shared_ptr<PerfCounters>>(m, "PerfCounters")
+    .def("is_available", 
+          static_cast<bool (PerfCounters::*)() const>(&PerfCounters::isAvailable))
+    .def("num_phases", &PerfCounters::numPhases)
+    .def("phase_name", &PerfCounters::phaseName,
+          py::arg("phase"))
+    .def("num_samples", &PerfCounters::numSamples,
+          py::arg("phase"))
+    .def("count", [](const PerfCounters& self, const OCPSolverPhase phase, 
+                     const PerfCounterEvent event) {
+        return self.count(static_cast<int>(phase), event);
+      }, py::arg("phase"), py::arg("event"))
+    .def("show_info", &PerfCounters::showInfo);
+
   py::class_<OCPSolver>(m, "OCPSolver")
     .def(py::init<const Robot&, const std::shared_ptr<CostFunction>&,
                   const std::shared_ptr<Constraints>&, const double, const int, 
@@ -19,10 +104,17 @@ PYBIND11_MODULE(ocp_solver, m) {
          py::arg("robot"), py::arg("cost"), py::arg("constraints"),
          py::arg("T"), py::arg("N"), py::arg("max_num_impulse")=0,
          py::arg("nthreads")=1)
-    .def("init_constraints", &OCPSolver::initConstraints)
+    .def("set_discretization_grid", &OCPSolver::setDiscretizationGrid)
+    .def("set_geometric_discretization_grid", 
+          &OCPSolver::setGeometricDiscretizationGrid)
+    .def("set_sto_parameters", &OCPSolver::setSTOParameters,
+          py::arg("hessian")=1.0e03, py::arg("max_step_size")=0.01)
+    .def("init_constraints", &OCPSolver::initConstraints,
+          py::call_guard<py::gil_scoped_release>())
     .def("update_solution", &OCPSolver::updateSolution,
           py::arg("t"), py::arg("q"), py::arg("v"), 
-          py::arg("line_search")=false)
+          py::arg("line_search")=false,
+          py::call_guard<py::gil_scoped_release>())
     .def("get_solution", static_cast<const SplitSolution& (OCPSolver::*)(const int stage) const>(&OCPSolver::getSolution))
     .def("get_solution", static_cast<std::vector<Eigen::VectorXd> (OCPSolver::*)(const std::string&, const std::string&) const>(&OCPSolver::getSolution),
           py::arg("name"), py::arg("option")="")
@@ -34,11 +126,40 @@ PYBIND11_MODULE(ocp_solver, m) {
           py::arg("t"), py::arg("extrapolate_solution")=false)
     .def("pop_front_contact_status", &OCPSolver::popFrontContactStatus,
           py::arg("t"), py::arg("extrapolate_solution")=false)
-    .def("compute_KKT_residual", &OCPSolver::computeKKTResidual)
+    .def("compute_KKT_residual", &OCPSolver::computeKKTResidual,
+          py::call_guard<py::gil_scoped_release>())
     .def("KKT_error", &OCPSolver::KKTError)
     .def("cost", &OCPSolver::cost)
+    .def("regularization", &OCPSolver::regularization)
+    .def("set_second_order_correction", &OCPSolver::setSecondOrderCorrection,
+          py::arg("second_order_correction"))
+    .def("set_mixed_precision_riccati", &OCPSolver::setMixedPrecisionRiccati,
+          py::arg("mixed_precision"))
+    .def("set_multi_level_iteration", &OCPSolver::setMultiLevelIteration,
+          py::arg("full_update_interval"), py::arg("jacobian_update_interval"))
+    .def("iteration_level", &OCPSolver::iterationLevel)
     .def("is_formulation_tractable", &OCPSolver::isFormulationTractable)
-    .def("show_info", &OCPSolver::showInfo);
+    .def("show_info", &OCPSolver::showInfo)
+    .def("save_snapshot", static_cast<bool (OCPSolver::*)(const std::string&, const double) const>(&OCPSolver::saveSnapshot),
+          py::arg("file_name"), py::arg("t"))
+    .def("load_snapshot", static_cast<bool (OCPSolver::*)(const std::string&)>(&OCPSolver::loadSnapshot),
+          py::arg("file_name"))
+    .def("add_warm_start_entry", &OCPSolver::addWarmStartEntry,
+          py::arg("builder"), py::arg("key"), py::arg("t"))
+    .def("load_warm_start", &OCPSolver::loadWarmStart,
+          py::arg("library"), py::arg("key"), py::arg("t"), 
+          py::arg("phase_weight")=1.0)
+    .def("start_recording", &OCPSolver::startRecording,
+          py::arg("file_name"), py::arg("t"))
+    .def("stop_recording", &OCPSolver::stopRecording)
+    .def("is_recording", &OCPSolver::isRecording)
+    .def("apply_real_time_profile", &OCPSolver::applyRealTimeProfile,
+          py::arg("profile"), py::arg("t"), py::arg("q"), py::arg("v"))
+    .def("start_perf_counters", &OCPSolver::startPerfCounters)
+    .def("stop_perf_counters", &OCPSolver::stopPerfCounters)
+    .def("get_perf_counters", [](const OCPSolver& self) {
+        return std::const_pointer_cast<PerfCounters>(self.getPerfCounters());
+      });
 }
 
 } // namespace python
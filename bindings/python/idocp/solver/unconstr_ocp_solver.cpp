@@ -18,14 +18,17 @@ PYBIND11_MODULE(unconstr_ocp_solver, m) {
                   const int>(),
          py::arg("robot"), py::arg("cost"), py::arg("constraints"),
          py::arg("T"), py::arg("N"), py::arg("nthreads")=1)
-    .def("init_constraints", &UnconstrOCPSolver::initConstraints)
+    .def("init_constraints", &UnconstrOCPSolver::initConstraints,
+          py::call_guard<py::gil_scoped_release>())
     .def("update_solution", &UnconstrOCPSolver::updateSolution,
           py::arg("t"), py::arg("q"), py::arg("v"), 
-          py::arg("line_search")=false)
+          py::arg("line_search")=false,
+          py::call_guard<py::gil_scoped_release>())
     .def("get_solution", static_cast<const SplitSolution& (UnconstrOCPSolver::*)(const int stage) const>(&UnconstrOCPSolver::getSolution))
     .def("get_solution", static_cast<std::vector<Eigen::VectorXd> (UnconstrOCPSolver::*)(const std::string&) const>(&UnconstrOCPSolver::getSolution))
     .def("set_solution", &UnconstrOCPSolver::setSolution)
-    .def("compute_KKT_residual", &UnconstrOCPSolver::computeKKTResidual)
+    .def("compute_KKT_residual", &UnconstrOCPSolver::computeKKTResidual,
+          py::call_guard<py::gil_scoped_release>())
     .def("KKT_error", &UnconstrOCPSolver::KKTError)
     .def("cost", &UnconstrOCPSolver::cost);
 }
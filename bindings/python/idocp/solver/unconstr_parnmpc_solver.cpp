@@ -18,14 +18,27 @@ PYBIND11_MODULE(unconstr_parnmpc_solver, m) {
                   const int>(),
          py::arg("robot"), py::arg("cost"), py::arg("constraints"),
          py::arg("T"), py::arg("N"), py::arg("nthreads")=1)
-    .def("init_constraints", &UnconstrParNMPCSolver::initConstraints)
+    .def("init_constraints", &UnconstrParNMPCSolver::initConstraints,
+          py::call_guard<py::gil_scoped_release>())
+    .def("init_backward_correction", 
+          &UnconstrParNMPCSolver::initBackwardCorrection,
+          py::arg("t"), py::call_guard<py::gil_scoped_release>())
     .def("update_solution", &UnconstrParNMPCSolver::updateSolution,
           py::arg("t"), py::arg("q"), py::arg("v"), 
-          py::arg("line_search")=false)
+          py::arg("line_search")=false,
+          py::call_guard<py::gil_scoped_release>())
+    .def("set_async_iteration", &UnconstrParNMPCSolver::setAsyncIteration,
+          py::arg("max_sweeps"), py::arg("tol"), 
+          py::arg("deterministic")=false)
+    .def("update_solution_async", &UnconstrParNMPCSolver::updateSolutionAsync,
+          py::arg("t"), py::arg("q"), py::arg("v"), 
+          py::call_guard<py::gil_scoped_release>())
+    .def("num_async_sweeps", &UnconstrParNMPCSolver::numAsyncSweeps)
     .def("get_solution", static_cast<const SplitSolution& (UnconstrParNMPCSolver::*)(const int stage) const>(&UnconstrParNMPCSolver::getSolution))
     .def("get_solution", static_cast<std::vector<Eigen::VectorXd> (UnconstrParNMPCSolver::*)(const std::string&) const>(&UnconstrParNMPCSolver::getSolution))
     .def("set_solution", &UnconstrParNMPCSolver::setSolution)
-    .def("compute_KKT_residual", &UnconstrParNMPCSolver::computeKKTResidual)
+    .def("compute_KKT_residual", &UnconstrParNMPCSolver::computeKKTResidual,
+          py::call_guard<py::gil_scoped_release>())
     .def("KKT_error", &UnconstrParNMPCSolver::KKTError)
     .def("cost", &UnconstrParNMPCSolver::cost);
 }
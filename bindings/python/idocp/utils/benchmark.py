@@ -25,3 +25,16 @@ def convergence(ocp_solver, t, q, v, num_iteration, line_search=False, logger=No
         if logger is not None:
             logger.take_log(ocp_solver)
     print('-----------------------------------')
+
+
+def hardware_counters(ocp_solver, t, q, v, num_iteration, line_search=False):
+    print('---------- OCP benchmark : Hardware counters ----------')
+    if not ocp_solver.start_perf_counters():
+        print('hardware performance counters are not available')
+        print('-----------------------------------')
+        return
+    for i in range(num_iteration):
+        ocp_solver.update_solution(t, q, v, line_search)
+    print('number of updates: ' + str(num_iteration))
+    ocp_solver.get_perf_counters().show_info()
+    ocp_solver.stop_perf_counters()
@@ -0,0 +1,173 @@
+#include <string>
+#include <memory>
+#include <cstdlib>
+#include <iostream>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/mpc/mpc_quadrupedal_trotting.hpp"
+#include "idocp/cost/cost_function.hpp"
+#include "idocp/cost/configuration_space_cost.hpp"
+#include "idocp/cost/time_varying_task_space_3d_cost.hpp"
+#include "idocp/cost/time_varying_com_cost.hpp"
+#include "idocp/cost/periodic_foot_track_ref2.hpp"
+#include "idocp/cost/periodic_com_ref2.hpp"
+#include "idocp/constraints/constraints.hpp"
+#include "idocp/constraints/joint_position_lower_limit.hpp"
+#include "idocp/constraints/joint_position_upper_limit.hpp"
+#include "idocp/constraints/joint_velocity_lower_limit.hpp"
+#include "idocp/constraints/joint_velocity_upper_limit.hpp"
+#include "idocp/constraints/joint_torques_lower_limit.hpp"
+#include "idocp/constraints/joint_torques_upper_limit.hpp"
+
+#include "idocp/sim/closed_loop_simulator.hpp"
+
+
+// Closed-loop benchmark of MPCQuadrupedalTrotting without GUI.
+// Usage: ./mpc_benchmark [N] [nthreads] [num_iteration] [latency]
+int main(int argc, char *argv[]) {
+  const int N = (argc > 1) ? std::atoi(argv[1]) : 20;
+  const int nthreads = (argc > 2) ? std::atoi(argv[2]) : 4;
+  const int num_iteration = (argc > 3) ? std::atoi(argv[3]) : 2;
+  const double latency = (argc > 4) ? std::atof(argv[4]) : 0.0;
+
+  const int LF_foot_id = 12;
+  const int LH_foot_id = 22;
+  const int RF_foot_id = 32;
+  const int RH_foot_id = 42;
+  std::vector<int> contact_frames = {LF_foot_id, LH_foot_id, RF_foot_id, RH_foot_id}; // LF, LH, RF, RH
+  const std::string path_to_urdf = "../anymal_b_simple_description/urdf/anymal.urdf";
+  const double baumgarte_time_step = 0.05;
+  idocp::Robot robot(path_to_urdf, idocp::BaseJointType::FloatingBase,
+                     contact_frames, baumgarte_time_step);
+
+  const double step_length = 0.15;
+  const double step_height = 0.1;
+  const double period_swing = 0.5;
+  const double t0 = 0.5;
+
+  auto cost = std::make_shared<idocp::CostFunction>();
+  Eigen::VectorXd q_standing(Eigen::VectorXd::Zero(robot.dimq()));
+  q_standing << 0, 0, 0.4842, 0, 0, 0, 1,
+                -0.1,  0.7, -1.0,
+                -0.1, -0.7,  1.0,
+                 0.1,  0.7, -1.0,
+                 0.1, -0.7,  1.0;
+  Eigen::VectorXd q_weight(Eigen::VectorXd::Zero(robot.dimv()));
+  q_weight << 0, 0, 0, 100, 100, 100,
+              0.001, 0.001, 0.001,
+              0.001, 0.001, 0.001,
+              0.001, 0.001, 0.001,
+              0.001, 0.001, 0.001;
+  Eigen::VectorXd v_weight = Eigen::VectorXd::Constant(robot.dimv(), 1);
+  Eigen::VectorXd u_weight = Eigen::VectorXd::Constant(robot.dimu(), 1e-02);
+  Eigen::VectorXd qi_weight(Eigen::VectorXd::Zero(robot.dimv()));
+  qi_weight << 0, 0, 0, 100, 100, 100,
+               1, 1, 1,
+               1, 1, 1,
+               1, 1, 1,
+               1, 1, 1;
+  Eigen::VectorXd vi_weight = Eigen::VectorXd::Constant(robot.dimv(), 1);
+  Eigen::VectorXd dvi_weight = Eigen::VectorXd::Constant(robot.dimv(), 1e-03);
+  auto config_cost = std::make_shared<idocp::ConfigurationSpaceCost>(robot);
+  config_cost->set_q_ref(q_standing);
+  config_cost->set_q_weight(q_weight);
+  config_cost->set_qf_weight(q_weight);
+  config_cost->set_qi_weight(qi_weight);
+  config_cost->set_v_weight(v_weight);
+  config_cost->set_vf_weight(v_weight);
+  config_cost->set_vi_weight(vi_weight);
+  config_cost->set_dvi_weight(dvi_weight);
+  config_cost->set_u_weight(u_weight);
+  cost->push_back(config_cost);
+
+  robot.updateFrameKinematics(q_standing);
+  const Eigen::Vector3d q0_3d_LF = robot.framePosition(LF_foot_id);
+  const Eigen::Vector3d q0_3d_LH = robot.framePosition(LH_foot_id);
+  const Eigen::Vector3d q0_3d_RF = robot.framePosition(RF_foot_id);
+  const Eigen::Vector3d q0_3d_RH = robot.framePosition(RH_foot_id);
+  const double LF_t0 = t0 + period_swing;
+  const double LH_t0 = t0;
+  const double RF_t0 = t0;
+  const double RH_t0 = t0 + period_swing;
+  auto LF_foot_ref = std::make_shared<idocp::PeriodicFootTrackRef2>(q0_3d_LF, step_length, step_height,
+                                                                    LF_t0, period_swing, period_swing, false);
+  auto LH_foot_ref = std::make_shared<idocp::PeriodicFootTrackRef2>(q0_3d_LH, step_length, step_height,
+                                                                    LH_t0, period_swing, period_swing, true);
+  auto RF_foot_ref = std::make_shared<idocp::PeriodicFootTrackRef2>(q0_3d_RF, step_length, step_height,
+                                                                    RF_t0, period_swing, period_swing, true);
+  auto RH_foot_ref = std::make_shared<idocp::PeriodicFootTrackRef2>(q0_3d_RH, step_length, step_height,
+                                                                    RH_t0, period_swing, period_swing, false);
+  auto LF_cost = std::make_shared<idocp::TimeVaryingTaskSpace3DCost>(robot, LF_foot_id, LF_foot_ref);
+  auto LH_cost = std::make_shared<idocp::TimeVaryingTaskSpace3DCost>(robot, LH_foot_id, LH_foot_ref);
+  auto RF_cost = std::make_shared<idocp::TimeVaryingTaskSpace3DCost>(robot, RF_foot_id, RF_foot_ref);
+  auto RH_cost = std::make_shared<idocp::TimeVaryingTaskSpace3DCost>(robot, RH_foot_id, RH_foot_ref);
+  const Eigen::Vector3d foot_track_weight = Eigen::Vector3d::Constant(1.0e04);
+  LF_cost->set_q_weight(foot_track_weight);
+  LH_cost->set_q_weight(foot_track_weight);
+  RF_cost->set_q_weight(foot_track_weight);
+  RH_cost->set_q_weight(foot_track_weight);
+  cost->push_back(LF_cost);
+  cost->push_back(LH_cost);
+  cost->push_back(RF_cost);
+  cost->push_back(RH_cost);
+
+  Eigen::Vector3d CoM_ref0 = (q0_3d_LF + q0_3d_LH + q0_3d_RF + q0_3d_RH) / 4;
+  CoM_ref0(2) = robot.CoM()(2);
+  Eigen::Vector3d v_CoM_ref = Eigen::Vector3d::Zero();
+  v_CoM_ref.coeffRef(0) = 0.5 * step_length / period_swing;
+  auto com_ref = std::make_shared<idocp::PeriodicCoMRef2>(CoM_ref0, v_CoM_ref, t0, period_swing,
+                                                          0.0, true);
+  auto com_cost = std::make_shared<idocp::TimeVaryingCoMCost>(robot, com_ref);
+  com_cost->set_q_weight(Eigen::Vector3d::Constant(1.0e04));
+  cost->push_back(com_cost);
+
+  auto constraints           = std::make_shared<idocp::Constraints>();
+  auto joint_position_lower  = std::make_shared<idocp::JointPositionLowerLimit>(robot);
+  auto joint_position_upper  = std::make_shared<idocp::JointPositionUpperLimit>(robot);
+  auto joint_velocity_lower  = std::make_shared<idocp::JointVelocityLowerLimit>(robot);
+  auto joint_velocity_upper  = std::make_shared<idocp::JointVelocityUpperLimit>(robot);
+  auto joint_torques_lower   = std::make_shared<idocp::JointTorquesLowerLimit>(robot);
+  auto joint_torques_upper   = std::make_shared<idocp::JointTorquesUpperLimit>(robot);
+  constraints->push_back(joint_position_lower);
+  constraints->push_back(joint_position_upper);
+  constraints->push_back(joint_velocity_lower);
+  constraints->push_back(joint_velocity_upper);
+  constraints->push_back(joint_torques_lower);
+  constraints->push_back(joint_torques_upper);
+  constraints->setBarrier(1.0e-01);
+
+  const double T = 0.5;
+  const int max_steps = 3;
+  idocp::MPCQuadrupedalTrotting mpc(robot, cost, constraints, T, N,
+                                    max_steps, nthreads);
+  mpc.setGaitPattern(step_length, step_height, period_swing, t0);
+  const Eigen::VectorXd q = q_standing;
+  const Eigen::VectorXd v = Eigen::VectorXd::Zero(robot.dimv());
+  const double t = 0;
+  mpc.init(t, q, v, 5);
+
+  const double control_period = 0.0025; // 400 Hz MPC
+  idocp::ClosedLoopSimulator<idocp::MPCQuadrupedalTrotting> sim(mpc, robot,
+                                                                control_period);
+  sim.setSolverLatency(latency);
+  // Reference: the standing posture moving forward at the average CoM velocity.
+  sim.setReference([&](const double time, Eigen::VectorXd& q_ref,
+                       Eigen::VectorXd& v_ref) {
+    q_ref = q_standing;
+    v_ref.setZero();
+    if (time > t0) {
+      q_ref.coeffRef(0) += v_CoM_ref.coeff(0) * (time-t0);
+      v_ref.coeffRef(0) = v_CoM_ref.coeff(0);
+    }
+  });
+  const double sim_time = 10.0;
+  std::cout << "N = " << N << ", nthreads = " << nthreads
+            << ", num_iteration = " << num_iteration
+            << ", latency = " << latency << "[s]" << std::endl;
+  const auto result = sim.run(t, q, v, sim_time, num_iteration);
+  result.showInfo();
+
+  return 0;
+}
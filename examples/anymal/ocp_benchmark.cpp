@@ -125,6 +125,7 @@ int main () {
 
   idocp::benchmark::convergence(ocp_solver, t, q, v, 10, false);
   idocp::benchmark::CPUTime(ocp_solver, t, q, v, 10000, false);
+  idocp::benchmark::HardwareCounters(ocp_solver, t, q, v, 1000, false);
 
   // robot.printRobotModel();
 
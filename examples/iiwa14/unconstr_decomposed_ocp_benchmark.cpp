@@ -0,0 +1,75 @@
+#include <string>
+#include <memory>
+#include <cstdlib>
+
+#include "Eigen/Core"
+
+#include "idocp/solver/unconstr_ocp_solver.hpp"
+#include "idocp/solver/unconstr_decomposed_ocp_solver.hpp"
+#include "idocp/robot/robot.hpp"
+#include "idocp/cost/cost_function.hpp"
+#include "idocp/cost/configuration_space_cost.hpp"
+#include "idocp/constraints/constraints.hpp"
+#include "idocp/utils/joint_constraints_factory.hpp"
+#include "idocp/utils/ocp_benchmarker.hpp"
+
+
+// Usage: unconstr_decomposed_ocp_benchmark [num_processes] [nthreads] [N]
+int main(int argc, char *argv[]) {
+  const int num_processes = (argc > 1) ? std::atoi(argv[1]) : 2;
+  const int nthreads = (argc > 2) ? std::atoi(argv[2]) : 4;
+  const int N = (argc > 3) ? std::atoi(argv[3]) : 400;
+
+  // Create a robot.
+  const std::string path_to_urdf = "../iiwa_description/urdf/iiwa14.urdf";
+  idocp::Robot robot(path_to_urdf);
+
+  // Create a cost function.
+  robot.setJointEffortLimit(Eigen::VectorXd::Constant(robot.dimu(), 200));
+  auto cost = std::make_shared<idocp::CostFunction>();
+  auto config_cost = std::make_shared<idocp::ConfigurationSpaceCost>(robot);
+  config_cost->set_q_ref(Eigen::VectorXd::Constant(robot.dimv(), -5));
+  config_cost->set_v_ref(Eigen::VectorXd::Constant(robot.dimv(), -9));
+  config_cost->set_q_weight(Eigen::VectorXd::Constant(robot.dimv(), 10));
+  config_cost->set_qf_weight(Eigen::VectorXd::Constant(robot.dimv(), 10));
+  config_cost->set_v_weight(Eigen::VectorXd::Constant(robot.dimv(), 0.1));
+  config_cost->set_vf_weight(Eigen::VectorXd::Constant(robot.dimv(), 0.1));
+  config_cost->set_a_weight(Eigen::VectorXd::Constant(robot.dimv(), 0.01));
+  config_cost->set_u_weight(Eigen::VectorXd::Constant(robot.dimv(), 0.0));
+  cost->push_back(config_cost);
+
+  // Create joint constraints.
+  idocp::JointConstraintsFactory constraints_factory(robot);
+  auto constraints = constraints_factory.create();
+
+  // Create the solver whose horizon is decomposed over the processes. The 
+  // worker processes are forked before the OpenMP threads are created.
+  const double T = 20;
+  const double t = 0;
+  const Eigen::VectorXd q = Eigen::VectorXd::Constant(robot.dimq(), 2);
+  const Eigen::VectorXd v = Eigen::VectorXd::Zero(robot.dimv());
+  idocp::UnconstrDecomposedOCPSolver decomposed_solver(robot, cost, constraints, 
+                                                       T, N, num_processes, 
+                                                       nthreads);
+  decomposed_solver.showInfo();
+
+  // Solves the OCP by the decomposed solver.
+  decomposed_solver.setSolution("q", q);
+  decomposed_solver.setSolution("v", v);
+  const int num_iteration = 10;
+  const bool line_search = false;
+  idocp::benchmark::convergence(decomposed_solver, t, q, v, num_iteration, 
+                                line_search);
+  const int num_iteration_CPU = 100;
+  idocp::benchmark::CPUTime(decomposed_solver, t, q, v, num_iteration_CPU, 
+                            line_search);
+
+  // Solves the same OCP by a single process for comparison.
+  idocp::UnconstrOCPSolver ocp_solver(robot, cost, constraints, T, N, nthreads);
+  ocp_solver.setSolution("q", q);
+  ocp_solver.setSolution("v", v);
+  idocp::benchmark::convergence(ocp_solver, t, q, v, num_iteration, line_search);
+  idocp::benchmark::CPUTime(ocp_solver, t, q, v, num_iteration_CPU, line_search);
+
+  return 0;
+}
@@ -1,5 +1,7 @@
 #include <string>
 #include <memory>
+#include <chrono>
+#include <iostream>
 
 #include "Eigen/Core"
 
@@ -55,5 +57,34 @@ int main() {
   const int num_iteration_CPU = 10000;
   idocp::benchmark::CPUTime(parnmpc_solver, t, q, v, num_iteration_CPU, line_search);
 
+  // Solves the OCP by the asynchronous ParNMPC iteration from the same 
+  // initial guess.
+  idocp::UnconstrParNMPCSolver async_parnmpc_solver(robot, cost, constraints, 
+                                                    T, N, nthreads);
+  async_parnmpc_solver.setSolution("q", q);
+  async_parnmpc_solver.setSolution("v", v);
+  async_parnmpc_solver.initBackwardCorrection(t);
+  const int max_sweeps = 10;
+  const double tol = 1.0e-08;
+  const bool deterministic = false;
+  async_parnmpc_solver.setAsyncIteration(max_sweeps, tol, deterministic);
+  std::cout << "---------- Asynchronous ParNMPC ----------" << std::endl;
+  for (int i=0; i<num_iteration; ++i) {
+    async_parnmpc_solver.updateSolutionAsync(t, q, v);
+  }
+  async_parnmpc_solver.computeKKTResidual(t, q, v);
+  std::cout << "KKT error after " << num_iteration << " updates = " 
+            << async_parnmpc_solver.KKTError() << std::endl;
+  const auto start_clock = std::chrono::system_clock::now();
+  for (int i=0; i<num_iteration_CPU; ++i) {
+    async_parnmpc_solver.updateSolutionAsync(t, q, v);
+  }
+  const auto end_clock = std::chrono::system_clock::now();
+  std::cout << "CPU time per update (" << max_sweeps << " sweeps at most): " 
+            << 1e-03 * std::chrono::duration_cast<std::chrono::microseconds>(
+                  end_clock-start_clock).count() / num_iteration_CPU 
+            << "[ms]" << std::endl;
+  std::cout << "-----------------------------------" << std::endl;
+
   return 0;
 }
\ No newline at end of file
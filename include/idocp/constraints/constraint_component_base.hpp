@@ -79,6 +79,21 @@ public:
   ///
   virtual bool useKinematics() const = 0;
 
+  ///
+  /// @brief Sparsity pattern of the values that this constraint component 
+  /// adds to SplitKKTMatrix::Qff(). Components that add sparser values can 
+  /// override this to speed up the condensing of the contact dynamics.
+  /// @return Sparsity pattern. Default is BlockSparsity::Dense.
+  ///
+  virtual BlockSparsity QffSparsity() const;
+
+  ///
+  /// @brief Sparsity pattern of the values that this constraint component 
+  /// adds to SplitKKTMatrix::Qqf(). 
+  /// @return Sparsity pattern. Default is BlockSparsity::Dense.
+  ///
+  virtual BlockSparsity QqfSparsity() const;
+
   ///
   /// @brief Checks the kinematics level of the constraint component.
   /// @return Kinematics level of the constraint component.
@@ -153,6 +168,21 @@ public:
                                     SplitKKTMatrix& kkt_matrix,
                                     SplitKKTResidual& kkt_residual) const = 0;
 
+  ///
+  /// @brief Condenses the slack and dual variables only into the KKT 
+  /// residual, i.e., computes the condensed KKT residual without the condensed
+  /// Hessians. This function is always called just after evalDerivatives().
+  /// @param[in] robot Robot model.
+  /// @param[in] data Constraint data.
+  /// @param[in] dt Time step.
+  /// @param[in] s Split solution.
+  /// @param[out] kkt_residual Split KKT residual. The condensed residuals are 
+  /// added to this object.
+  ///
+  virtual void condenseSlackAndDual(Robot& robot, ConstraintComponentData& data,
+                                    const double dt, const SplitSolution& s, 
+                                    SplitKKTResidual& kkt_residual) const = 0;
+
   ///
   /// @brief Expands the slack and dual, i.e., computes the directions of the 
   /// slack and dual variables from the directions of the primal variables.
@@ -40,6 +40,16 @@ inline ConstraintComponentBase::ConstraintComponentBase()
 }
 
 
+inline BlockSparsity ConstraintComponentBase::QffSparsity() const {
+  return BlockSparsity::Dense;
+}
+
+
+inline BlockSparsity ConstraintComponentBase::QqfSparsity() const {
+  return BlockSparsity::Dense;
+}
+
+
 inline double ConstraintComponentBase::maxSlackStepSize(
     const ConstraintComponentData& data) const {
   return pdipm::fractionToBoundarySlack(fraction_to_boundary_rule_, data);
@@ -90,6 +90,20 @@ public:
   ///
   bool useKinematics() const;
 
+  ///
+  /// @brief Sparsity pattern of the values that the constraint components 
+  /// add to SplitKKTMatrix::Qff() and ImpulseSplitKKTMatrix::Qff().
+  /// @return Sparsity pattern that covers all the components.
+  ///
+  BlockSparsity QffSparsity() const;
+
+  ///
+  /// @brief Sparsity pattern of the values that the constraint components 
+  /// add to SplitKKTMatrix::Qqf() and ImpulseSplitKKTMatrix::Qqf().
+  /// @return Sparsity pattern that covers all the components.
+  ///
+  BlockSparsity QqfSparsity() const;
+
   ///
   /// @brief Creates ConstraintsData according to robot model and constraint 
   /// components. 
@@ -219,6 +233,35 @@ public:
                             ImpulseSplitKKTMatrix& kkt_matrix, 
                             ImpulseSplitKKTResidual& kkt_residual) const;
 
+  ///
+  /// @brief Linearizes the constraints (i.e., calls linearizeConstraints())
+  /// and condense the slack and dual variables only into the KKT residual, 
+  /// i.e., without computing the condensed Hessians.
+  /// @param[in] robot Robot model.
+  /// @param[in] data Constraints data. 
+  /// @param[in] dt Time step.
+  /// @param[in] s Split solution.
+  /// @param[out] kkt_residual Split KKT residual. The condensed residual are 
+  /// added to this data.
+  ///
+  void condenseSlackAndDual(Robot& robot, ConstraintsData& data,
+                            const double dt, const SplitSolution& s,
+                            SplitKKTResidual& kkt_residual) const;
+
+  ///
+  /// @brief Linearizes the constraints (i.e., calls linearizeConstraints())
+  /// and condense the slack and dual variables only into the KKT residual, 
+  /// i.e., without computing the condensed Hessians.
+  /// @param[in] robot Robot model.
+  /// @param[in] data Constraints data.
+  /// @param[in] s Split solution.
+  /// @param[out] kkt_residual Impulse split KKT residual. The condensed  
+  /// residual are added to this data.
+  ///
+  void condenseSlackAndDual(Robot& robot, ConstraintsData& data,
+                            const ImpulseSplitSolution& s,
+                            ImpulseSplitKKTResidual& kkt_residual) const;
+
   ///
   /// @brief Expands the slack and dual, i.e., computes the directions of the 
   /// slack and dual variables from the directions of the primal variables.
@@ -65,6 +65,34 @@ inline bool Constraints::useKinematics() const {
 }
 
 
+inline BlockSparsity Constraints::QffSparsity() const {
+  BlockSparsity sparsity = BlockSparsity::Zero;
+  sparsity = constraintsimpl::QffSparsity(position_level_constraints_, 
+                                          sparsity);
+  sparsity = constraintsimpl::QffSparsity(velocity_level_constraints_, 
+                                          sparsity);
+  sparsity = constraintsimpl::QffSparsity(acceleration_level_constraints_, 
+                                          sparsity);
+  sparsity = constraintsimpl::QffSparsity(impulse_level_constraints_, 
+                                          sparsity);
+  return sparsity;
+}
+
+
+inline BlockSparsity Constraints::QqfSparsity() const {
+  BlockSparsity sparsity = BlockSparsity::Zero;
+  sparsity = constraintsimpl::QqfSparsity(position_level_constraints_, 
+                                          sparsity);
+  sparsity = constraintsimpl::QqfSparsity(velocity_level_constraints_, 
+                                          sparsity);
+  sparsity = constraintsimpl::QqfSparsity(acceleration_level_constraints_, 
+                                          sparsity);
+  sparsity = constraintsimpl::QqfSparsity(impulse_level_constraints_, 
+                                          sparsity);
+  return sparsity;
+}
+
+
 inline ConstraintsData Constraints::createConstraintsData(
     const Robot& robot, const int time_stage) const {
   ConstraintsData data(time_stage);
@@ -243,6 +271,39 @@ inline void Constraints::condenseSlackAndDual(
 }
 
 
+inline void Constraints::condenseSlackAndDual(
+    Robot& robot, ConstraintsData& data, const double dt, const SplitSolution& s, 
+    SplitKKTResidual& kkt_residual) const {
+  assert(dt > 0);
+  if (data.isPositionLevelValid()) {
+    constraintsimpl::condenseSlackAndDual(
+        position_level_constraints_, robot, data.position_level_data, 
+        dt, s, kkt_residual);
+  }
+  if (data.isVelocityLevelValid()) {
+    constraintsimpl::condenseSlackAndDual(
+        velocity_level_constraints_, robot, data.velocity_level_data, 
+        dt, s, kkt_residual);
+  }
+  if (data.isAccelerationLevelValid()) {
+    constraintsimpl::condenseSlackAndDual(
+        acceleration_level_constraints_, robot, data.acceleration_level_data, 
+        dt, s, kkt_residual);
+  }
+}
+
+
+inline void Constraints::condenseSlackAndDual(
+    Robot& robot, ConstraintsData& data, const ImpulseSplitSolution& s, 
+    ImpulseSplitKKTResidual& kkt_residual) const {
+  if (data.isImpulseLevelValid()) {
+    constraintsimpl::condenseSlackAndDual(
+        impulse_level_constraints_, robot, data.impulse_level_data, 
+        s, kkt_residual);
+  }
+}
+
+
 inline void Constraints::expandSlackAndDual(ConstraintsData& data, 
                                             const SplitSolution& s, 
                                             const SplitDirection& d) const {
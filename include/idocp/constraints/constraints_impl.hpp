@@ -42,6 +42,28 @@ template <typename ConstraintComponentBaseTypePtr>
 bool useKinematics(
    const std::vector<ConstraintComponentBaseTypePtr>& constraints);
 
+///
+/// @brief Joins the sparsity patterns of Qff of the constraints. 
+/// @param[in] constraints Vector of the constraints. 
+/// @param[in] sparsity Sparsity pattern joined with those of the constraints. 
+/// @return Joined sparsity pattern.
+///
+template <typename ConstraintComponentBaseTypePtr>
+BlockSparsity QffSparsity(
+   const std::vector<ConstraintComponentBaseTypePtr>& constraints,
+   const BlockSparsity sparsity);
+
+///
+/// @brief Joins the sparsity patterns of Qqf of the constraints. 
+/// @param[in] constraints Vector of the constraints. 
+/// @param[in] sparsity Sparsity pattern joined with those of the constraints. 
+/// @return Joined sparsity pattern.
+///
+template <typename ConstraintComponentBaseTypePtr>
+BlockSparsity QqfSparsity(
+   const std::vector<ConstraintComponentBaseTypePtr>& constraints,
+   const BlockSparsity sparsity);
+
 ///
 /// @brief Creates constraints data.
 /// @param[in] constraints Vector of the constraints. 
@@ -158,6 +180,37 @@ void condenseSlackAndDual(
     const ImpulseSplitSolution& s, ImpulseSplitKKTMatrix& kkt_matrix, 
     ImpulseSplitKKTResidual& kkt_residual);
 
+///
+/// @brief Linearizes the constraints (i.e., calls linearizeConstraints())
+/// and condense the slack and dual variables only into the KKT residual.
+/// @param[in] constraints Vector of the constraints. 
+/// @param[in] robot Robot model.
+/// @param[in, out] data Vector of the constraints data.
+/// @param[in] dt Time step.
+/// @param[in] s Split solution.
+/// @param[in, out] kkt_residual Split KKT residual. The condensed residuals are 
+/// added to this object.
+///
+void condenseSlackAndDual(
+    const std::vector<ConstraintComponentBasePtr>& constraints, Robot& robot, 
+    std::vector<ConstraintComponentData>& data, const double dt, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual);
+
+///
+/// @brief Linearizes the constraints (i.e., calls linearizeConstraints())
+/// and condense the slack and dual variables only into the KKT residual.
+/// @param[in] constraints Vector of the impulse constraints. 
+/// @param[in] robot Robot model.
+/// @param[in, out] data Vector of the constraints data.
+/// @param[in] s Impulse split solution.
+/// @param[in, out] kkt_residual Impulse split KKT residual. The condensed residuals 
+/// are added to this object.
+///
+void condenseSlackAndDual(
+    const std::vector<ImpulseConstraintComponentBasePtr>& constraints,
+    Robot& robot, std::vector<ConstraintComponentData>& data, 
+    const ImpulseSplitSolution& s, ImpulseSplitKKTResidual& kkt_residual);
+
 ///
 /// @brief Expands the slack and dual, i.e., computes the directions of the 
 /// slack and dual variables from the directions of the primal variables.
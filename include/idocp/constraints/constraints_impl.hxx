@@ -26,6 +26,30 @@ inline bool useKinematics(
 }
 
 
+template <typename ConstraintComponentBaseTypePtr>
+inline BlockSparsity QffSparsity(
+   const std::vector<ConstraintComponentBaseTypePtr>& constraints,
+   const BlockSparsity sparsity) {
+  BlockSparsity joined = sparsity;
+  for (const auto& constraint : constraints) {
+    joined = joinBlockSparsity(joined, constraint->QffSparsity());
+  }
+  return joined;
+}
+
+
+template <typename ConstraintComponentBaseTypePtr>
+inline BlockSparsity QqfSparsity(
+   const std::vector<ConstraintComponentBaseTypePtr>& constraints,
+   const BlockSparsity sparsity) {
+  BlockSparsity joined = sparsity;
+  for (const auto& constraint : constraints) {
+    joined = joinBlockSparsity(joined, constraint->QqfSparsity());
+  }
+  return joined;
+}
+
+
 template <typename ConstraintComponentBaseTypePtr>
 inline void createConstraintsData(
     const std::vector<ConstraintComponentBaseTypePtr>& constraints, 
@@ -149,6 +173,36 @@ inline void condenseSlackAndDual(
 }
 
 
+inline void condenseSlackAndDual(
+    const std::vector<ConstraintComponentBasePtr>& constraints, Robot& robot, 
+    std::vector<ConstraintComponentData>& data, const double dt, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual) {
+  assert(constraints.size() == data.size());
+  for (int i=0; i<constraints.size(); ++i) {
+    assert(data[i].dimc() == constraints[i]->dimc());
+    assert(data[i].checkDimensionalConsistency());
+    constraints[i]->evalConstraint(robot, data[i], s);
+    constraints[i]->evalDerivatives(robot, data[i], dt, s, kkt_residual);
+    constraints[i]->condenseSlackAndDual(robot, data[i], dt, s, kkt_residual);
+  }
+}
+
+
+inline void condenseSlackAndDual(
+    const std::vector<ImpulseConstraintComponentBasePtr>& constraints,
+    Robot& robot, std::vector<ConstraintComponentData>& data, 
+    const ImpulseSplitSolution& s, ImpulseSplitKKTResidual& kkt_residual) {
+  assert(constraints.size() == data.size());
+  for (int i=0; i<constraints.size(); ++i) {
+    assert(data[i].dimc() == constraints[i]->dimc());
+    assert(data[i].checkDimensionalConsistency());
+    constraints[i]->evalConstraint(robot, data[i], s);
+    constraints[i]->evalDerivatives(robot, data[i], s, kkt_residual);
+    constraints[i]->condenseSlackAndDual(robot, data[i], s, kkt_residual);
+  }
+}
+
+
 template <typename ConstraintComponentBaseTypePtr, 
           typename SplitSolutionType, typename SplitDirectionType>
 inline void expandSlackAndDual(
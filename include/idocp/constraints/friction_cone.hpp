@@ -96,6 +96,10 @@ public:
                             SplitKKTMatrix& kkt_matrix,
                             SplitKKTResidual& kkt_residual) const override;
 
+  void condenseSlackAndDual(Robot& robot, ConstraintComponentData& data, 
+                            const double dt, const SplitSolution& s,
+                            SplitKKTResidual& kkt_residual) const override;
+
   void expandSlackAndDual(ConstraintComponentData& data, const SplitSolution& s,
                           const SplitDirection& d) const override; 
 
@@ -70,6 +70,21 @@ public:
   ///
   virtual KinematicsLevel kinematicsLevel() const = 0;
 
+  ///
+  /// @brief Sparsity pattern of the values that this constraint component 
+  /// adds to ImpulseSplitKKTMatrix::Qff(). Components that add sparser values 
+  /// can override this to speed up the condensing of the impulse dynamics.
+  /// @return Sparsity pattern. Default is BlockSparsity::Dense.
+  ///
+  virtual BlockSparsity QffSparsity() const;
+
+  ///
+  /// @brief Sparsity pattern of the values that this constraint component 
+  /// adds to ImpulseSplitKKTMatrix::Qqf(). 
+  /// @return Sparsity pattern. Default is BlockSparsity::Dense.
+  ///
+  virtual BlockSparsity QqfSparsity() const;
+
   ///
   /// @brief Allocates extra data in ConstraintComponentData.
   /// @param[in] data Constraint component data.
@@ -136,6 +151,21 @@ public:
       const ImpulseSplitSolution& s, ImpulseSplitKKTMatrix& kkt_matrix, 
       ImpulseSplitKKTResidual& kkt_residual) const = 0;
 
+  ///
+  /// @brief Condenses the slack and dual variables only into the KKT 
+  /// residual, i.e., computes the condensed KKT residual without the condensed
+  /// Hessians. This function is always called just after evalDerivatives().
+  /// @param[in] robot Robot model.
+  /// @param[in] data Constraints data.
+  /// @param[in] s Impulse split solution.
+  /// @param[out] kkt_residual Impulse split KKT residual. The condensed KKT
+  /// residual are added to this data.
+  ///
+  virtual void condenseSlackAndDual(
+      Robot& robot, ConstraintComponentData& data,
+      const ImpulseSplitSolution& s, 
+      ImpulseSplitKKTResidual& kkt_residual) const = 0;
+
   ///
   /// @brief Expands the slack and dual, i.e., computes the directions of the 
   /// slack and dual variables from the directions of the primal variables.
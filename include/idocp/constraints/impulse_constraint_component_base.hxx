@@ -42,6 +42,16 @@ inline ImpulseConstraintComponentBase::ImpulseConstraintComponentBase()
 }
 
 
+inline BlockSparsity ImpulseConstraintComponentBase::QffSparsity() const {
+  return BlockSparsity::Dense;
+}
+
+
+inline BlockSparsity ImpulseConstraintComponentBase::QqfSparsity() const {
+  return BlockSparsity::Dense;
+}
+
+
 inline double ImpulseConstraintComponentBase::maxSlackStepSize(
     const ConstraintComponentData& data) const {
   return pdipm::fractionToBoundarySlack(fraction_to_boundary_rule_, data);
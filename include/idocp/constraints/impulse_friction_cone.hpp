@@ -94,6 +94,10 @@ public:
                             ImpulseSplitKKTMatrix& kkt_matrix,
                             ImpulseSplitKKTResidual& kkt_residual) const override;
 
+  void condenseSlackAndDual(Robot& robot, ConstraintComponentData& data, 
+                            const ImpulseSplitSolution& s,
+                            ImpulseSplitKKTResidual& kkt_residual) const override;
+
   void expandSlackAndDual(ConstraintComponentData& data, 
                           const ImpulseSplitSolution& s,
                           const ImpulseSplitDirection& d) const override; 
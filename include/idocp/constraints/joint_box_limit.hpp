@@ -0,0 +1,211 @@
+#ifndef IDOCP_JOINT_BOX_LIMIT_HPP_
+#define IDOCP_JOINT_BOX_LIMIT_HPP_
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/ocp/split_solution.hpp"
+#include "idocp/ocp/split_direction.hpp"
+#include "idocp/constraints/constraint_component_base.hpp"
+#include "idocp/constraints/constraint_component_data.hpp"
+#include "idocp/ocp/split_kkt_residual.hpp"
+#include "idocp/ocp/split_kkt_matrix.hpp"
+
+
+namespace idocp {
+
+///
+/// @enum JointVariable
+/// @brief Joint variable limited by JointBoxLimit.
+///
+enum class JointVariable {
+  Position,
+  Velocity,
+  Acceleration,
+  Torques
+};
+
+///
+/// @class JointBoxLimit
+/// @brief Constraint on both the lower and upper limits of a joint variable.
+/// Fuses the lower and upper limit components, e.g., JointPositionLowerLimit
+/// and JointPositionUpperLimit, into one component. The slack and dual
+/// variables of the lower limits are stored in the head and those of the
+/// upper limits in the tail of ConstraintComponentData, so that the updates,
+/// the condensing, and the fraction-to-boundary rule are single loops over
+/// contiguous arrays.
+///
+class JointBoxLimit final : public ConstraintComponentBase {
+public:
+  ///
+  /// @brief Constructor. The limits are taken from the robot model.
+  /// @param[in] robot Robot model.
+  /// @param[in] variable Joint variable. Must be JointVariable::Position,
+  /// JointVariable::Velocity, or JointVariable::Torques.
+  /// @param[in] barrier Barrier parameter. Must be positive. Should be small.
+  /// Default is 1.0e-04.
+  /// @param[in] fraction_to_boundary_rule Parameter of the
+  /// fraction-to-boundary-rule Must be larger than 0 and smaller than 1.
+  /// Should be between 0.9 and 0.995. Default is 0.995.
+  ///
+  JointBoxLimit(const Robot& robot, const JointVariable variable,
+                const double barrier=1.0e-04,
+                const double fraction_to_boundary_rule=0.995);
+
+  ///
+  /// @brief Constructor.
+  /// @param[in] robot Robot model.
+  /// @param[in] variable Joint variable.
+  /// @param[in] xmin Lower limits of the joint variable.
+  /// @param[in] xmax Upper limits of the joint variable. Size must be the
+  /// same as xmin.
+  /// @param[in] barrier Barrier parameter. Must be positive. Should be small.
+  /// Default is 1.0e-04.
+  /// @param[in] fraction_to_boundary_rule Parameter of the
+  /// fraction-to-boundary-rule Must be larger than 0 and smaller than 1.
+  /// Should be between 0.9 and 0.995. Default is 0.995.
+  ///
+  JointBoxLimit(const Robot& robot, const JointVariable variable,
+                const Eigen::VectorXd& xmin, const Eigen::VectorXd& xmax,
+                const double barrier=1.0e-04,
+                const double fraction_to_boundary_rule=0.995);
+
+  ///
+  /// @brief Default constructor.
+  ///
+  JointBoxLimit();
+
+  ///
+  /// @brief Destructor.
+  ///
+  ~JointBoxLimit();
+
+  ///
+  /// @brief Default copy constructor.
+  ///
+  JointBoxLimit(const JointBoxLimit&) = default;
+
+  ///
+  /// @brief Default copy operator.
+  ///
+  JointBoxLimit& operator=(const JointBoxLimit&) = default;
+
+  ///
+  /// @brief Default move constructor.
+  ///
+  JointBoxLimit(JointBoxLimit&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator.
+  ///
+  JointBoxLimit& operator=(JointBoxLimit&&) noexcept = default;
+
+  bool useKinematics() const override;
+
+  BlockSparsity QffSparsity() const override;
+
+  BlockSparsity QqfSparsity() const override;
+
+  KinematicsLevel kinematicsLevel() const override;
+
+  void allocateExtraData(ConstraintComponentData& data) const {}
+
+  bool isFeasible(Robot& robot, ConstraintComponentData& data,
+                  const SplitSolution& s) const override;
+
+  void setSlack(Robot& robot, ConstraintComponentData& data,
+                const SplitSolution& s) const override;
+
+  void evalConstraint(Robot& robot, ConstraintComponentData& data,
+                      const SplitSolution& s) const override;
+
+  void evalDerivatives(Robot& robot, ConstraintComponentData& data,
+                       const double dt, const SplitSolution& s,
+                       SplitKKTResidual& kkt_residual) const override;
+
+  void condenseSlackAndDual(Robot& robot, ConstraintComponentData& data,
+                            const double dt, const SplitSolution& s,
+                            SplitKKTMatrix& kkt_matrix,
+                            SplitKKTResidual& kkt_residual) const override;
+
+  void condenseSlackAndDual(Robot& robot, ConstraintComponentData& data,
+                            const double dt, const SplitSolution& s,
+                            SplitKKTResidual& kkt_residual) const override;
+
+  void expandSlackAndDual(ConstraintComponentData& data, const SplitSolution& s,
+                          const SplitDirection& d) const override;
+
+  ///
+  /// @return Size of the constraint, i.e., twice the number of the limited
+  /// joints.
+  ///
+  int dimc() const override;
+
+  ///
+  /// @return The limited joint variable.
+  ///
+  JointVariable variable() const;
+
+private:
+  JointVariable variable_;
+  int dimx_;
+  Eigen::VectorXd xmin_, xmax_;
+
+  Eigen::VectorBlock<const Eigen::VectorXd> x(const SplitSolution& s) const {
+    switch (variable_) {
+      case JointVariable::Position:
+        return s.q.tail(dimx_);
+      case JointVariable::Velocity:
+        return s.v.tail(dimx_);
+      case JointVariable::Acceleration:
+        return s.a.tail(dimx_);
+      default:
+        return s.u.tail(dimx_);
+    }
+  }
+
+  template <typename VectorType>
+  void addDerivatives(const ConstraintComponentData& data, const double dt,
+                      const Eigen::MatrixBase<VectorType>& lx) const {
+    assert(lx.size() == dimx_);
+    const_cast<Eigen::MatrixBase<VectorType>&>(lx).noalias()
+        += dt * (data.dual.tail(dimx_) - data.dual.head(dimx_));
+  }
+
+  template <typename VectorType1, typename VectorType2>
+  void addCondensedHessianAndResidual(
+      const ConstraintComponentData& data, const double dt,
+      const Eigen::MatrixBase<VectorType1>& Qxx_diag,
+      const Eigen::MatrixBase<VectorType2>& lx) const {
+    assert(Qxx_diag.size() == dimx_);
+    assert(lx.size() == dimx_);
+    const_cast<Eigen::MatrixBase<VectorType1>&>(Qxx_diag).array()
+        += dt * (data.dual.head(dimx_).array() / data.slack.head(dimx_).array()
+                  + data.dual.tail(dimx_).array()
+                      / data.slack.tail(dimx_).array());
+    const_cast<Eigen::MatrixBase<VectorType2>&>(lx).noalias()
+        += dt * (data.cond.tail(dimx_) - data.cond.head(dimx_));
+  }
+
+  template <typename VectorType>
+  void addCondensedResidual(const ConstraintComponentData& data,
+                            const double dt,
+                            const Eigen::MatrixBase<VectorType>& lx) const {
+    assert(lx.size() == dimx_);
+    const_cast<Eigen::MatrixBase<VectorType>&>(lx).noalias()
+        += dt * (data.cond.tail(dimx_) - data.cond.head(dimx_));
+  }
+
+  template <typename VectorType>
+  void computeSlackDirection(ConstraintComponentData& data,
+                             const Eigen::MatrixBase<VectorType>& dx) const {
+    assert(dx.size() == dimx_);
+    data.dslack.head(dimx_) = dx - data.residual.head(dimx_);
+    data.dslack.tail(dimx_) = - dx - data.residual.tail(dimx_);
+  }
+
+};
+
+} // namespace idocp
+
+#endif // IDOCP_JOINT_BOX_LIMIT_HPP_
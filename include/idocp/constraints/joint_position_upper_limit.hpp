@@ -65,6 +65,10 @@ public:
 
   bool useKinematics() const override;
 
+  BlockSparsity QffSparsity() const override;
+
+  BlockSparsity QqfSparsity() const override;
+
   KinematicsLevel kinematicsLevel() const override;
 
   void allocateExtraData(ConstraintComponentData& data) const {}
@@ -87,6 +91,10 @@ public:
                             SplitKKTMatrix& kkt_matrix,
                             SplitKKTResidual& kkt_residual) const override;
 
+  void condenseSlackAndDual(Robot& robot, ConstraintComponentData& data, 
+                            const double dt, const SplitSolution& s,
+                            SplitKKTResidual& kkt_residual) const override;
+
   void expandSlackAndDual(ConstraintComponentData& data, const SplitSolution& s,
                           const SplitDirection& d) const override; 
 
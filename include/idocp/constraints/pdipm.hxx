@@ -2,6 +2,7 @@
 #define IDOCP_CONSTRAINTS_PDIPM_HXX_
 
 #include "idocp/constraints/pdipm.hpp"
+#include "idocp/utils/simd_kernels.hpp"
 
 #include <cmath>
 #include <cassert>
@@ -28,7 +29,9 @@ inline void computeComplementarySlackness(const double barrier,
                                           ConstraintComponentData& data) {
   assert(barrier > 0);
   assert(data.checkDimensionalConsistency());
-  data.cmpl.array() = data.slack.array() * data.dual.array() - barrier;
+  simd::computeComplementarySlackness(data.slack.size(), barrier, 
+                                      data.slack.data(), data.dual.data(), 
+                                      data.cmpl.data());
 }
 
 
@@ -65,8 +68,9 @@ inline double computeComplementarySlackness(const double barrier,
 
 inline void computeCondensingCoeffcient(ConstraintComponentData& data) {
   assert(data.checkDimensionalConsistency());
-  data.cond.array() = (data.dual.array()*data.residual.array()-data.cmpl.array()) 
-                        / data.slack.array();
+  simd::computeCondensingCoeffcient(data.slack.size(), data.slack.data(), 
+                                    data.dual.data(), data.residual.data(), 
+                                    data.cmpl.data(), data.cond.data());
 }
 
 
@@ -126,16 +130,8 @@ inline double fractionToBoundary(const int dim, const double fraction_rate,
   assert(fraction_rate <= 1);
   assert(vec.size() == dim);
   assert(dvec.size() == dim);
-  double min_fraction_to_boundary = 1;
-  for (int i=0; i<dim; ++i) {
-    const double fraction_to_boundary 
-        = - fraction_rate * (vec.coeff(i)/dvec.coeff(i));
-    if (fraction_to_boundary > 0 && fraction_to_boundary < 1) {
-      if (fraction_to_boundary < min_fraction_to_boundary) {
-        min_fraction_to_boundary = fraction_to_boundary;
-      }
-    }
-  }
+  const double min_fraction_to_boundary 
+      = simd::fractionToBoundary(dim, fraction_rate, vec.data(), dvec.data());
   assert(min_fraction_to_boundary > 0);
   assert(min_fraction_to_boundary <= 1);
   return min_fraction_to_boundary;
@@ -158,9 +154,9 @@ inline double fractionToBoundary(const double fraction_rate,
 
 inline void computeDualDirection(ConstraintComponentData& data) {
   assert(data.checkDimensionalConsistency());
-  data.ddual.array() 
-      = - (data.dual.array()*data.dslack.array()+data.cmpl.array())
-          / data.slack.array();
+  simd::computeDualDirection(data.slack.size(), data.slack.data(), 
+                             data.dual.data(), data.dslack.data(), 
+                             data.cmpl.data(), data.ddual.data());
 }
 
 
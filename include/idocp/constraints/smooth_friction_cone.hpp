@@ -0,0 +1,231 @@
+#ifndef IDOCP_SMOOTH_FRICTION_CONE_HPP_
+#define IDOCP_SMOOTH_FRICTION_CONE_HPP_
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/ocp/split_solution.hpp"
+#include "idocp/ocp/split_direction.hpp"
+#include "idocp/constraints/constraint_component_base.hpp"
+#include "idocp/constraints/constraint_component_data.hpp"
+#include "idocp/ocp/split_kkt_residual.hpp"
+#include "idocp/ocp/split_kkt_matrix.hpp"
+
+
+namespace idocp {
+
+///
+/// @class SmoothFrictionCone
+/// @brief Constraint on the second-order friction cone. Unlike FrictionCone,
+/// which inner-approximates the cone by a 5-face pyramid, imposes one smooth
+/// inequality per contact:
+/// \f[ \sqrt{f_x^2 + f_y^2 + \epsilon^2} - \mu f_z \leq 0, \f]
+/// where \f$ f \f$ is the contact force expressed in the world frame and
+/// \f$ \epsilon \f$ is a small smoothing parameter that keeps the constraint
+/// differentiable at the apex of the cone and enforces \f$ f_z > 0 \f$.
+///
+class SmoothFrictionCone final : public ConstraintComponentBase {
+public:
+  ///
+  /// @brief Constructor.
+  /// @param[in] robot Robot model.
+  /// @param[in] mu Friction coefficient. Must be positive.
+  /// @param[in] barrier Barrier parameter. Must be positive. Should be small.
+  /// Default is 1.0e-04.
+  /// @param[in] fraction_to_boundary_rule Parameter of the
+  /// fraction-to-boundary-rule Must be larger than 0 and smaller than 1.
+  /// Should be between 0.9 and 0.995. Default is 0.995.
+  ///
+  SmoothFrictionCone(const Robot& robot, const double mu,
+                     const double barrier=1.0e-04,
+                     const double fraction_to_boundary_rule=0.995);
+
+  ///
+  /// @brief Default constructor.
+  ///
+  SmoothFrictionCone();
+
+  ///
+  /// @brief Destructor.
+  ///
+  ~SmoothFrictionCone();
+
+  ///
+  /// @brief Default copy constructor.
+  ///
+  SmoothFrictionCone(const SmoothFrictionCone&) = default;
+
+  ///
+  /// @brief Default copy operator.
+  ///
+  SmoothFrictionCone& operator=(const SmoothFrictionCone&) = default;
+
+  ///
+  /// @brief Default move constructor.
+  ///
+  SmoothFrictionCone(SmoothFrictionCone&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator.
+  ///
+  SmoothFrictionCone& operator=(SmoothFrictionCone&&) noexcept = default;
+
+  ///
+  /// @brief Sets the friction coefficient.
+  /// @param[in] mu Friction coefficient. Must be positive.
+  ///
+  void setFrictionCoefficient(const double mu);
+
+  ///
+  /// @brief Sets the smoothing parameter.
+  /// @param[in] eps Smoothing parameter. Must be positive. Default is
+  /// 1.0e-03.
+  ///
+  void setSmoothingParameter(const double eps);
+
+  bool useKinematics() const override;
+
+  KinematicsLevel kinematicsLevel() const override;
+
+  void allocateExtraData(ConstraintComponentData& data) const override;
+
+  bool isFeasible(Robot& robot, ConstraintComponentData& data,
+                  const SplitSolution& s) const override;
+
+  void setSlack(Robot& robot, ConstraintComponentData& data,
+                const SplitSolution& s) const override;
+
+  void evalConstraint(Robot& robot, ConstraintComponentData& data,
+                      const SplitSolution& s) const override;
+
+  void evalDerivatives(Robot& robot, ConstraintComponentData& data,
+                       const double dt, const SplitSolution& s,
+                       SplitKKTResidual& kkt_residual) const override;
+
+  void condenseSlackAndDual(Robot& robot, ConstraintComponentData& data,
+                            const double dt, const SplitSolution& s,
+                            SplitKKTMatrix& kkt_matrix,
+                            SplitKKTResidual& kkt_residual) const override;
+
+  void condenseSlackAndDual(Robot& robot, ConstraintComponentData& data, 
+                            const double dt, const SplitSolution& s,
+                            SplitKKTResidual& kkt_residual) const override;
+
+  void expandSlackAndDual(ConstraintComponentData& data, const SplitSolution& s,
+                          const SplitDirection& d) const override;
+
+  int dimc() const override;
+
+  ///
+  /// @brief Transforms the contact force from the local coordinate to the
+  /// world coordinate.
+  /// @param[in] robot Robot model. Kinematics must be updated.
+  /// @param[in] contact_frame_id Index of the contact frame.
+  /// @param[in] f_local Contact force expressed in the local frame.
+  /// @param[out] f_world Contact force expressed in the world frame. Size must
+  /// be 3.
+  ///
+  template <typename VectorType>
+  static void fLocal2World(const Robot& robot, const int contact_frame_id,
+                           const Eigen::Vector3d& f_local,
+                           const Eigen::MatrixBase<VectorType>& f_world) {
+    assert(f_world.size() == 3);
+    const_cast<Eigen::MatrixBase<VectorType>&>(f_world).noalias()
+        = robot.frameRotation(contact_frame_id) * f_local;
+  }
+
+  ///
+  /// @brief Computes the smooth friction cone residual.
+  /// @param[in] mu Friction coefficient. Must be positive.
+  /// @param[in] eps Smoothing parameter. Must be positive.
+  /// @param[in] f Contact force expressed in the world frame. Size must be 3.
+  /// @return The smooth friction cone residual.
+  ///
+  template <typename VectorType>
+  static double frictionConeResidual(const double mu, const double eps,
+                                     const Eigen::MatrixBase<VectorType>& f) {
+    assert(mu > 0);
+    assert(eps > 0);
+    assert(f.size() == 3);
+    return std::sqrt(f.coeff(0)*f.coeff(0) + f.coeff(1)*f.coeff(1) + eps*eps)
+            - mu * f.coeff(2);
+  }
+
+  ///
+  /// @brief Computes the gradient and the Hessian of the smooth friction cone
+  /// residual with respect to the contact force expressed in the world frame.
+  /// @param[in] mu Friction coefficient. Must be positive.
+  /// @param[in] eps Smoothing parameter. Must be positive.
+  /// @param[in] f Contact force expressed in the world frame. Size must be 3.
+  /// @param[out] grad Gradient. Size must be 3.
+  /// @param[out] hess Hessian. Size must be 3 x 3.
+  ///
+  template <typename VectorType1, typename VectorType2, typename MatrixType>
+  static void frictionConeDerivatives(
+      const double mu, const double eps,
+      const Eigen::MatrixBase<VectorType1>& f,
+      const Eigen::MatrixBase<VectorType2>& grad,
+      const Eigen::MatrixBase<MatrixType>& hess) {
+    assert(mu > 0);
+    assert(eps > 0);
+    assert(f.size() == 3);
+    assert(grad.size() == 3);
+    assert(hess.rows() == 3);
+    assert(hess.cols() == 3);
+    const double norm
+        = std::sqrt(f.coeff(0)*f.coeff(0) + f.coeff(1)*f.coeff(1) + eps*eps);
+    const double gx = f.coeff(0) / norm;
+    const double gy = f.coeff(1) / norm;
+    const_cast<Eigen::MatrixBase<VectorType2>&>(grad) << gx, gy, -mu;
+    const_cast<Eigen::MatrixBase<MatrixType>&>(hess)
+        << (1-gx*gx)/norm,   -gx*gy/norm,  0,
+             -gx*gy/norm,  (1-gy*gy)/norm, 0,
+                 0,              0,        0;
+  }
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+  int dimv_, dimc_, max_point_contacts_;
+  std::vector<int> contact_frame_;
+  double mu_, eps_;
+
+  static Eigen::VectorXd& fW(ConstraintComponentData& data,
+                             const int contact_idx) {
+    return data.r[contact_idx];
+  }
+
+  Eigen::VectorXd& dg_dfW(ConstraintComponentData& data,
+                          const int contact_idx) const {
+    return data.r[max_point_contacts_+contact_idx];
+  }
+
+  Eigen::VectorXd& dg_dq(ConstraintComponentData& data,
+                         const int contact_idx) const {
+    return data.r[2*max_point_contacts_+contact_idx];
+  }
+
+  Eigen::VectorXd& dg_df(ConstraintComponentData& data,
+                         const int contact_idx) const {
+    return data.r[3*max_point_contacts_+contact_idx];
+  }
+
+  static Eigen::MatrixXd& dfW_dq(ConstraintComponentData& data,
+                                 const int contact_idx) {
+    return data.J[contact_idx];
+  }
+
+  Eigen::MatrixXd& d2g_dfW2(ConstraintComponentData& data,
+                            const int contact_idx) const {
+    return data.J[max_point_contacts_+contact_idx];
+  }
+
+};
+
+} // namespace idocp
+
+#endif // IDOCP_SMOOTH_FRICTION_CONE_HPP_
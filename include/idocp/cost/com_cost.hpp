@@ -84,6 +84,10 @@ public:
 
   bool useKinematics() const override;
 
+  BlockSparsity QffSparsity() const override;
+
+  BlockSparsity QqfSparsity() const override;
+
   double computeStageCost(Robot& robot, CostFunctionData& data, const double t, 
                           const double dt, 
                           const SplitSolution& s) const override;
@@ -22,7 +22,9 @@ namespace idocp {
 ///
 /// @class CostFunction
 /// @brief Stack of the cost function. Composed by cost function components 
-/// that inherits CostFunctionComponentBase.
+/// that inherits CostFunctionComponentBase. The evaluation functions are 
+/// virtual so that a statically composed cost function, e.g., 
+/// StaticCostFunction, can be used through std::shared_ptr<CostFunction>.
 ///
 class CostFunction {
 public:
@@ -37,7 +39,7 @@ public:
   ///
   /// @brief Destructor. 
   ///
-  ~CostFunction();
+  virtual ~CostFunction();
 
   ///
   /// @brief Default copy constructor. 
@@ -77,7 +79,22 @@ public:
   /// @return true if the cost function component requires kinematics of 
   /// Robot model. false if not.
   ///
-  bool useKinematics() const;
+  virtual bool useKinematics() const;
+
+  ///
+  /// @brief Sparsity pattern of the values that the cost function components
+  /// add to the Hessian w.r.t. the contact forces, i.e., 
+  /// SplitKKTMatrix::Qff() and ImpulseSplitKKTMatrix::Qff().
+  /// @return Sparsity pattern that covers all the components.
+  ///
+  virtual BlockSparsity QffSparsity() const;
+
+  ///
+  /// @brief Sparsity pattern of the values that the cost function components
+  /// add to SplitKKTMatrix::Qqf() and ImpulseSplitKKTMatrix::Qqf().
+  /// @return Sparsity pattern that covers all the components.
+  ///
+  virtual BlockSparsity QqfSparsity() const;
 
   ///
   /// @brief Creates CostFunctionData according to robot model and cost 
@@ -96,8 +113,9 @@ public:
   /// @param[in] s Split solution.
   /// @return Stage cost.
   ///
-  double computeStageCost(Robot& robot, CostFunctionData& data, const double t, 
-                          const double dt, const SplitSolution& s) const;
+  virtual double computeStageCost(Robot& robot, CostFunctionData& data, 
+                                  const double t, const double dt, 
+                                  const SplitSolution& s) const;
 
   ///
   /// @brief Computes the stage cost and its first-order partial derivatives. 
@@ -110,10 +128,10 @@ public:
   /// are added to this object.
   /// @return Stage cost.
   ///
-  double linearizeStageCost(Robot& robot, CostFunctionData& data, 
-                            const double t, const double dt, 
-                            const SplitSolution& s, 
-                            SplitKKTResidual& kkt_residual) const;
+  virtual double linearizeStageCost(Robot& robot, CostFunctionData& data, 
+                                    const double t, const double dt, 
+                                    const SplitSolution& s, 
+                                    SplitKKTResidual& kkt_residual) const;
 
   ///
   /// @brief Computes the stage cost, its first-order partial derivatives, and 
@@ -129,11 +147,11 @@ public:
   /// this object.
   /// @return Stage cost.
   ///
-  double quadratizeStageCost(Robot& robot, CostFunctionData& data, 
-                             const double t, const double dt, 
-                             const SplitSolution& s, 
-                             SplitKKTResidual& kkt_residual,
-                             SplitKKTMatrix& kkt_matrix) const;
+  virtual double quadratizeStageCost(Robot& robot, CostFunctionData& data, 
+                                     const double t, const double dt, 
+                                     const SplitSolution& s, 
+                                     SplitKKTResidual& kkt_residual,
+                                     SplitKKTMatrix& kkt_matrix) const;
 
   ///
   /// @brief Computes the terminal cost. 
@@ -143,8 +161,9 @@ public:
   /// @param[in] s Split solution.
   /// @return Terminal cost.
   ///
-  double computeTerminalCost(Robot& robot, CostFunctionData& data,
-                             const double t, const SplitSolution& s) const;
+  virtual double computeTerminalCost(Robot& robot, CostFunctionData& data,
+                                     const double t, 
+                                     const SplitSolution& s) const;
 
   ///
   /// @brief Computes the terminal cost and its first-order partial derivatives. 
@@ -156,9 +175,9 @@ public:
   /// are added to this object.
   /// @return Stage cost.
   ///
-  double linearizeTerminalCost(Robot& robot, CostFunctionData& data, 
-                               const double t, const SplitSolution& s, 
-                               SplitKKTResidual& kkt_residual) const;
+  virtual double linearizeTerminalCost(Robot& robot, CostFunctionData& data, 
+                                       const double t, const SplitSolution& s, 
+                                       SplitKKTResidual& kkt_residual) const;
 
   ///
   /// @brief Computes the terminal cost, its first-order partial derivatives, 
@@ -173,10 +192,10 @@ public:
   /// this object.
   /// @return Stage cost.
   ///
-  double quadratizeTerminalCost(Robot& robot, CostFunctionData& data, 
-                                const double t, const SplitSolution& s, 
-                                SplitKKTResidual& kkt_residual,
-                                SplitKKTMatrix& kkt_matrix) const;
+  virtual double quadratizeTerminalCost(Robot& robot, CostFunctionData& data, 
+                                        const double t, const SplitSolution& s, 
+                                        SplitKKTResidual& kkt_residual,
+                                        SplitKKTMatrix& kkt_matrix) const;
 
   ///
   /// @brief Computes the impulse cost. 
@@ -186,9 +205,9 @@ public:
   /// @param[in] s Split solution.
   /// @return Stage cost.
   ///
-  double computeImpulseCost(Robot& robot, CostFunctionData& data, 
-                            const double t, 
-                            const ImpulseSplitSolution& s) const;
+  virtual double computeImpulseCost(Robot& robot, CostFunctionData& data, 
+                                    const double t, 
+                                    const ImpulseSplitSolution& s) const;
 
   ///
   /// @brief Computes the impulse cost and its first-order partial derivatives. 
@@ -200,9 +219,10 @@ public:
   /// are added to this object.
   /// @return Stage cost.
   ///
-  double linearizeImpulseCost(Robot& robot, CostFunctionData& data, 
-                               const double t, const ImpulseSplitSolution& s, 
-                               ImpulseSplitKKTResidual& kkt_residual) const;
+  virtual double linearizeImpulseCost(Robot& robot, CostFunctionData& data, 
+                                       const double t, 
+                                       const ImpulseSplitSolution& s, 
+                                       ImpulseSplitKKTResidual& kkt_residual) const;
 
   ///
   /// @brief Computes the impulse cost, its first-order partial derivatives, 
@@ -217,10 +237,11 @@ public:
   /// this object.
   /// @return Stage cost.
   ///
-  double quadratizeImpulseCost(Robot& robot, CostFunctionData& data, 
-                               const double t, const ImpulseSplitSolution& s, 
-                               ImpulseSplitKKTResidual& kkt_residual,
-                               ImpulseSplitKKTMatrix& kkt_matrix) const;
+  virtual double quadratizeImpulseCost(Robot& robot, CostFunctionData& data, 
+                                       const double t, 
+                                       const ImpulseSplitSolution& s, 
+                                       ImpulseSplitKKTResidual& kkt_residual,
+                                       ImpulseSplitKKTMatrix& kkt_matrix) const;
 
 private:
   std::vector<CostFunctionComponentBasePtr> costs_;
@@ -34,6 +34,24 @@ inline bool CostFunction::useKinematics() const {
 }
 
 
+inline BlockSparsity CostFunction::QffSparsity() const {
+  BlockSparsity sparsity = BlockSparsity::Zero;
+  for (const auto& cost : costs_) {
+    sparsity = joinBlockSparsity(sparsity, cost->QffSparsity());
+  }
+  return sparsity;
+}
+
+
+inline BlockSparsity CostFunction::QqfSparsity() const {
+  BlockSparsity sparsity = BlockSparsity::Zero;
+  for (const auto& cost : costs_) {
+    sparsity = joinBlockSparsity(sparsity, cost->QqfSparsity());
+  }
+  return sparsity;
+}
+
+
 inline CostFunctionData CostFunction::createCostFunctionData(
     const Robot& robot) const {
   auto data = CostFunctionData(robot);
@@ -61,6 +61,26 @@ public:
   ///
   virtual bool useKinematics() const = 0;
 
+  ///
+  /// @brief Sparsity pattern of the values that this cost function component 
+  /// adds to SplitKKTMatrix::Qff() and ImpulseSplitKKTMatrix::Qff(). 
+  /// Components that add sparser values can override this to speed up the 
+  /// condensing of the contact and impulse dynamics.
+  /// @return Sparsity pattern. Default is BlockSparsity::Dense.
+  ///
+  virtual BlockSparsity QffSparsity() const { 
+    return BlockSparsity::Dense; 
+  }
+
+  ///
+  /// @brief Sparsity pattern of the values that this cost function component 
+  /// adds to SplitKKTMatrix::Qqf() and ImpulseSplitKKTMatrix::Qqf(). 
+  /// @return Sparsity pattern. Default is BlockSparsity::Dense.
+  ///
+  virtual BlockSparsity QqfSparsity() const { 
+    return BlockSparsity::Dense; 
+  }
+
   ///
   /// @brief Computes the stage cost. 
   /// @param[in] robot Robot model.
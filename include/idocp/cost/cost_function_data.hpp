@@ -5,6 +5,7 @@
 
 #include "idocp/robot/robot.hpp"
 #include "idocp/robot/se3.hpp"
+#include "idocp/cost/time_varying_ref_cache.hpp"
 
 
 namespace idocp {
@@ -144,6 +145,12 @@ public:
   ///
   Eigen::MatrixXd JJ_6d;
 
+  ///
+  /// @brief Cache of the references of the time-varying costs at this time 
+  /// stage.
+  ///
+  TimeVaryingRefCache ref_cache;
+
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW 
 };
 
@@ -18,7 +18,8 @@ inline CostFunctionData::CostFunctionData(const Robot& robot)
     J_6d(Eigen::MatrixXd::Zero(6, robot.dimv())),
     J_3d(Eigen::MatrixXd::Zero(3, robot.dimv())),
     J_66(Eigen::MatrixXd::Zero(6, 6)),
-    JJ_6d(Eigen::MatrixXd::Zero(6, robot.dimv())) {
+    JJ_6d(Eigen::MatrixXd::Zero(6, robot.dimv())),
+    ref_cache() {
   if (robot.hasFloatingBase()) {
     qdiff.resize(robot.dimv());
     qdiff.setZero();
@@ -41,7 +42,8 @@ inline CostFunctionData::CostFunctionData()
     J_6d(),
     J_3d(),
     J_66(),
-    JJ_6d() {
+    JJ_6d(),
+    ref_cache() {
 }
 
 
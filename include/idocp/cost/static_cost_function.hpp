@@ -0,0 +1,162 @@
+#ifndef IDOCP_STATIC_COST_FUNCTION_HPP_
+#define IDOCP_STATIC_COST_FUNCTION_HPP_
+
+#include <tuple>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/cost/cost_function.hpp"
+#include "idocp/cost/cost_function_data.hpp"
+#include "idocp/ocp/split_solution.hpp"
+#include "idocp/ocp/split_kkt_residual.hpp"
+#include "idocp/ocp/split_kkt_matrix.hpp"
+#include "idocp/impulse/impulse_split_solution.hpp"
+#include "idocp/impulse/impulse_split_kkt_residual.hpp"
+#include "idocp/impulse/impulse_split_kkt_matrix.hpp"
+
+
+namespace idocp {
+namespace internal {
+
+template <std::size_t I, std::size_t Size>
+struct StaticCostLoop;
+
+} // namespace internal 
+
+
+///
+/// @class StaticCostFunction
+/// @brief Cost function statically composed by the cost function components.
+/// The components are stored by value and are evaluated without the virtual 
+/// dispatch, i.e., the cost, its derivatives, and its Hessian of each 
+/// component are computed in a single inlined pass over the components. 
+/// Since this class inherits CostFunction, it can be used through 
+/// std::shared_ptr<CostFunction>. The components appended by 
+/// CostFunction::push_back() are also evaluated after the static components.
+/// @tparam Components Types of the cost function components. Must be 
+/// concrete classes (preferably final classes) that inherit 
+/// CostFunctionComponentBase.
+///
+template <typename... Components>
+class StaticCostFunction : public CostFunction {
+public:
+  ///
+  /// @brief Constructs the cost function from the components. 
+  /// @param[in] components Cost function components. Copied into this object.
+  ///
+  StaticCostFunction(const Components&... components);
+
+  ///
+  /// @brief Default constructor. 
+  ///
+  StaticCostFunction();
+
+  ///
+  /// @brief Destructor. 
+  ///
+  ~StaticCostFunction();
+
+  ///
+  /// @brief Default copy constructor. 
+  ///
+  StaticCostFunction(const StaticCostFunction&) = default;
+
+  ///
+  /// @brief Default copy operator. 
+  ///
+  StaticCostFunction& operator=(const StaticCostFunction&) = default;
+
+  ///
+  /// @brief Default move constructor. 
+  ///
+  StaticCostFunction(StaticCostFunction&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator. 
+  ///
+  StaticCostFunction& operator=(StaticCostFunction&&) noexcept = default;
+
+  ///
+  /// @brief Returns the I-th cost function component, e.g., to set the 
+  /// weights and the references.
+  /// @tparam I Index of the component.
+  /// @return Reference to the I-th component.
+  ///
+  template <std::size_t I>
+  typename std::tuple_element<I, std::tuple<Components...>>::type& get();
+
+  ///
+  /// @brief Returns the I-th cost function component.
+  /// @tparam I Index of the component.
+  /// @return Const reference to the I-th component.
+  ///
+  template <std::size_t I>
+  const typename std::tuple_element<I, std::tuple<Components...>>::type& 
+  get() const;
+
+  ///
+  /// @return Number of the static cost function components.
+  ///
+  static constexpr std::size_t size() { return sizeof...(Components); }
+
+  bool useKinematics() const override;
+
+  BlockSparsity QffSparsity() const override;
+
+  BlockSparsity QqfSparsity() const override;
+
+  double computeStageCost(Robot& robot, CostFunctionData& data, 
+                          const double t, const double dt, 
+                          const SplitSolution& s) const override;
+
+  double linearizeStageCost(Robot& robot, CostFunctionData& data, 
+                            const double t, const double dt, 
+                            const SplitSolution& s, 
+                            SplitKKTResidual& kkt_residual) const override;
+
+  double quadratizeStageCost(Robot& robot, CostFunctionData& data, 
+                             const double t, const double dt, 
+                             const SplitSolution& s, 
+                             SplitKKTResidual& kkt_residual,
+                             SplitKKTMatrix& kkt_matrix) const override;
+
+  double computeTerminalCost(Robot& robot, CostFunctionData& data,
+                             const double t, 
+                             const SplitSolution& s) const override;
+
+  double linearizeTerminalCost(Robot& robot, CostFunctionData& data, 
+                               const double t, const SplitSolution& s, 
+                               SplitKKTResidual& kkt_residual) const override;
+
+  double quadratizeTerminalCost(Robot& robot, CostFunctionData& data, 
+                                const double t, const SplitSolution& s, 
+                                SplitKKTResidual& kkt_residual,
+                                SplitKKTMatrix& kkt_matrix) const override;
+
+  double computeImpulseCost(Robot& robot, CostFunctionData& data, 
+                            const double t, 
+                            const ImpulseSplitSolution& s) const override;
+
+  double linearizeImpulseCost(
+      Robot& robot, CostFunctionData& data, const double t, 
+      const ImpulseSplitSolution& s, 
+      ImpulseSplitKKTResidual& kkt_residual) const override;
+
+  double quadratizeImpulseCost(
+      Robot& robot, CostFunctionData& data, const double t, 
+      const ImpulseSplitSolution& s, ImpulseSplitKKTResidual& kkt_residual,
+      ImpulseSplitKKTMatrix& kkt_matrix) const override;
+
+private:
+  using Loop = internal::StaticCostLoop<0, sizeof...(Components)>;
+
+  std::tuple<Components...> components_;
+
+};
+
+} // namespace idocp
+
+#include "idocp/cost/static_cost_function.hxx"
+
+#endif // IDOCP_STATIC_COST_FUNCTION_HPP_
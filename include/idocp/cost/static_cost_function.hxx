@@ -0,0 +1,399 @@
+#ifndef IDOCP_STATIC_COST_FUNCTION_HXX_
+#define IDOCP_STATIC_COST_FUNCTION_HXX_
+
+#include "idocp/cost/static_cost_function.hpp"
+
+#include <cassert>
+
+
+namespace idocp {
+namespace internal {
+
+///
+/// @brief Compile-time loop over the static cost function components. Each 
+/// function evaluates the I-th component and recurses into the (I+1)-th one.
+///
+template <std::size_t I, std::size_t Size>
+struct StaticCostLoop {
+  template <typename Tuple>
+  static bool useKinematics(const Tuple& costs) {
+    return std::get<I>(costs).useKinematics() 
+            || StaticCostLoop<I+1, Size>::useKinematics(costs);
+  }
+
+  template <typename Tuple>
+  static BlockSparsity QffSparsity(const Tuple& costs) {
+    return joinBlockSparsity(std::get<I>(costs).QffSparsity(), 
+                             StaticCostLoop<I+1, Size>::QffSparsity(costs));
+  }
+
+  template <typename Tuple>
+  static BlockSparsity QqfSparsity(const Tuple& costs) {
+    return joinBlockSparsity(std::get<I>(costs).QqfSparsity(), 
+                             StaticCostLoop<I+1, Size>::QqfSparsity(costs));
+  }
+
+  template <typename Tuple>
+  static double computeStageCost(const Tuple& costs, Robot& robot, 
+                                 CostFunctionData& data, const double t, 
+                                 const double dt, const SplitSolution& s) {
+    return std::get<I>(costs).computeStageCost(robot, data, t, dt, s)
+            + StaticCostLoop<I+1, Size>::computeStageCost(costs, robot, data, 
+                                                          t, dt, s);
+  }
+
+  template <typename Tuple>
+  static double linearizeStageCost(const Tuple& costs, Robot& robot, 
+                                   CostFunctionData& data, const double t, 
+                                   const double dt, const SplitSolution& s, 
+                                   SplitKKTResidual& kkt_residual) {
+    const auto& cost = std::get<I>(costs);
+    const double l = cost.computeStageCost(robot, data, t, dt, s);
+    cost.computeStageCostDerivatives(robot, data, t, dt, s, kkt_residual);
+    return l + StaticCostLoop<I+1, Size>::linearizeStageCost(
+                   costs, robot, data, t, dt, s, kkt_residual);
+  }
+
+  template <typename Tuple>
+  static double quadratizeStageCost(const Tuple& costs, Robot& robot, 
+                                    CostFunctionData& data, const double t, 
+                                    const double dt, const SplitSolution& s, 
+                                    SplitKKTResidual& kkt_residual, 
+                                    SplitKKTMatrix& kkt_matrix) {
+    const auto& cost = std::get<I>(costs);
+    const double l = cost.computeStageCost(robot, data, t, dt, s);
+    cost.computeStageCostDerivatives(robot, data, t, dt, s, kkt_residual);
+    cost.computeStageCostHessian(robot, data, t, dt, s, kkt_matrix);
+    return l + StaticCostLoop<I+1, Size>::quadratizeStageCost(
+                   costs, robot, data, t, dt, s, kkt_residual, kkt_matrix);
+  }
+
+  template <typename Tuple>
+  static double computeTerminalCost(const Tuple& costs, Robot& robot, 
+                                    CostFunctionData& data, const double t, 
+                                    const SplitSolution& s) {
+    return std::get<I>(costs).computeTerminalCost(robot, data, t, s)
+            + StaticCostLoop<I+1, Size>::computeTerminalCost(costs, robot, 
+                                                             data, t, s);
+  }
+
+  template <typename Tuple>
+  static double linearizeTerminalCost(const Tuple& costs, Robot& robot, 
+                                      CostFunctionData& data, const double t, 
+                                      const SplitSolution& s, 
+                                      SplitKKTResidual& kkt_residual) {
+    const auto& cost = std::get<I>(costs);
+    const double l = cost.computeTerminalCost(robot, data, t, s);
+    cost.computeTerminalCostDerivatives(robot, data, t, s, kkt_residual);
+    return l + StaticCostLoop<I+1, Size>::linearizeTerminalCost(
+                   costs, robot, data, t, s, kkt_residual);
+  }
+
+  template <typename Tuple>
+  static double quadratizeTerminalCost(const Tuple& costs, Robot& robot, 
+                                       CostFunctionData& data, const double t, 
+                                       const SplitSolution& s, 
+                                       SplitKKTResidual& kkt_residual, 
+                                       SplitKKTMatrix& kkt_matrix) {
+    const auto& cost = std::get<I>(costs);
+    const double l = cost.computeTerminalCost(robot, data, t, s);
+    cost.computeTerminalCostDerivatives(robot, data, t, s, kkt_residual);
+    cost.computeTerminalCostHessian(robot, data, t, s, kkt_matrix);
+    return l + StaticCostLoop<I+1, Size>::quadratizeTerminalCost(
+                   costs, robot, data, t, s, kkt_residual, kkt_matrix);
+  }
+
+  template <typename Tuple>
+  static double computeImpulseCost(const Tuple& costs, Robot& robot, 
+                                   CostFunctionData& data, const double t, 
+                                   const ImpulseSplitSolution& s) {
+    return std::get<I>(costs).computeImpulseCost(robot, data, t, s)
+            + StaticCostLoop<I+1, Size>::computeImpulseCost(costs, robot, 
+                                                            data, t, s);
+  }
+
+  template <typename Tuple>
+  static double linearizeImpulseCost(const Tuple& costs, Robot& robot, 
+                                     CostFunctionData& data, const double t, 
+                                     const ImpulseSplitSolution& s, 
+                                     ImpulseSplitKKTResidual& kkt_residual) {
+    const auto& cost = std::get<I>(costs);
+    const double l = cost.computeImpulseCost(robot, data, t, s);
+    cost.computeImpulseCostDerivatives(robot, data, t, s, kkt_residual);
+    return l + StaticCostLoop<I+1, Size>::linearizeImpulseCost(
+                   costs, robot, data, t, s, kkt_residual);
+  }
+
+  template <typename Tuple>
+  static double quadratizeImpulseCost(const Tuple& costs, Robot& robot, 
+                                      CostFunctionData& data, const double t, 
+                                      const ImpulseSplitSolution& s, 
+                                      ImpulseSplitKKTResidual& kkt_residual, 
+                                      ImpulseSplitKKTMatrix& kkt_matrix) {
+    const auto& cost = std::get<I>(costs);
+    const double l = cost.computeImpulseCost(robot, data, t, s);
+    cost.computeImpulseCostDerivatives(robot, data, t, s, kkt_residual);
+    cost.computeImpulseCostHessian(robot, data, t, s, kkt_matrix);
+    return l + StaticCostLoop<I+1, Size>::quadratizeImpulseCost(
+                   costs, robot, data, t, s, kkt_residual, kkt_matrix);
+  }
+};
+
+
+template <std::size_t Size>
+struct StaticCostLoop<Size, Size> {
+  template <typename Tuple>
+  static bool useKinematics(const Tuple& costs) { 
+    return false; 
+  }
+
+  template <typename Tuple>
+  static BlockSparsity QffSparsity(const Tuple& costs) { 
+    return BlockSparsity::Zero; 
+  }
+
+  template <typename Tuple>
+  static BlockSparsity QqfSparsity(const Tuple& costs) { 
+    return BlockSparsity::Zero; 
+  }
+
+  template <typename Tuple>
+  static double computeStageCost(const Tuple& costs, Robot& robot, 
+                                 CostFunctionData& data, const double t, 
+                                 const double dt, const SplitSolution& s) {
+    return 0;
+  }
+
+  template <typename Tuple>
+  static double linearizeStageCost(const Tuple& costs, Robot& robot, 
+                                   CostFunctionData& data, const double t, 
+                                   const double dt, const SplitSolution& s, 
+                                   SplitKKTResidual& kkt_residual) {
+    return 0;
+  }
+
+  template <typename Tuple>
+  static double quadratizeStageCost(const Tuple& costs, Robot& robot, 
+                                    CostFunctionData& data, const double t, 
+                                    const double dt, const SplitSolution& s, 
+                                    SplitKKTResidual& kkt_residual, 
+                                    SplitKKTMatrix& kkt_matrix) {
+    return 0;
+  }
+
+  template <typename Tuple>
+  static double computeTerminalCost(const Tuple& costs, Robot& robot, 
+                                    CostFunctionData& data, const double t, 
+                                    const SplitSolution& s) {
+    return 0;
+  }
+
+  template <typename Tuple>
+  static double linearizeTerminalCost(const Tuple& costs, Robot& robot, 
+                                      CostFunctionData& data, const double t, 
+                                      const SplitSolution& s, 
+                                      SplitKKTResidual& kkt_residual) {
+    return 0;
+  }
+
+  template <typename Tuple>
+  static double quadratizeTerminalCost(const Tuple& costs, Robot& robot, 
+                                       CostFunctionData& data, const double t, 
+                                       const SplitSolution& s, 
+                                       SplitKKTResidual& kkt_residual, 
+                                       SplitKKTMatrix& kkt_matrix) {
+    return 0;
+  }
+
+  template <typename Tuple>
+  static double computeImpulseCost(const Tuple& costs, Robot& robot, 
+                                   CostFunctionData& data, const double t, 
+                                   const ImpulseSplitSolution& s) {
+    return 0;
+  }
+
+  template <typename Tuple>
+  static double linearizeImpulseCost(const Tuple& costs, Robot& robot, 
+                                     CostFunctionData& data, const double t, 
+                                     const ImpulseSplitSolution& s, 
+                                     ImpulseSplitKKTResidual& kkt_residual) {
+    return 0;
+  }
+
+  template <typename Tuple>
+  static double quadratizeImpulseCost(const Tuple& costs, Robot& robot, 
+                                      CostFunctionData& data, const double t, 
+                                      const ImpulseSplitSolution& s, 
+                                      ImpulseSplitKKTResidual& kkt_residual, 
+                                      ImpulseSplitKKTMatrix& kkt_matrix) {
+    return 0;
+  }
+};
+
+} // namespace internal 
+
+
+template <typename... Components>
+inline StaticCostFunction<Components...>::StaticCostFunction(
+    const Components&... components)
+  : CostFunction(),
+    components_(components...) {
+}
+
+
+template <typename... Components>
+inline StaticCostFunction<Components...>::StaticCostFunction()
+  : CostFunction(),
+    components_() {
+}
+
+
+template <typename... Components>
+inline StaticCostFunction<Components...>::~StaticCostFunction() {
+}
+
+
+template <typename... Components>
+template <std::size_t I>
+inline typename std::tuple_element<I, std::tuple<Components...>>::type& 
+StaticCostFunction<Components...>::get() {
+  return std::get<I>(components_);
+}
+
+
+template <typename... Components>
+template <std::size_t I>
+inline const typename std::tuple_element<I, std::tuple<Components...>>::type& 
+StaticCostFunction<Components...>::get() const {
+  return std::get<I>(components_);
+}
+
+
+template <typename... Components>
+inline bool StaticCostFunction<Components...>::useKinematics() const {
+  return Loop::useKinematics(components_) || CostFunction::useKinematics();
+}
+
+
+template <typename... Components>
+inline BlockSparsity StaticCostFunction<Components...>::QffSparsity() const {
+  return joinBlockSparsity(Loop::QffSparsity(components_), 
+                           CostFunction::QffSparsity());
+}
+
+
+template <typename... Components>
+inline BlockSparsity StaticCostFunction<Components...>::QqfSparsity() const {
+  return joinBlockSparsity(Loop::QqfSparsity(components_), 
+                           CostFunction::QqfSparsity());
+}
+
+
+template <typename... Components>
+inline double StaticCostFunction<Components...>::computeStageCost(
+    Robot& robot, CostFunctionData& data, const double t, const double dt, 
+    const SplitSolution& s) const {
+  assert(dt > 0);
+  double l = Loop::computeStageCost(components_, robot, data, t, dt, s);
+  l += CostFunction::computeStageCost(robot, data, t, dt, s);
+  return l;
+}
+
+
+template <typename... Components>
+inline double StaticCostFunction<Components...>::linearizeStageCost(
+    Robot& robot, CostFunctionData& data, const double t, const double dt, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
+  assert(dt > 0);
+  double l = Loop::linearizeStageCost(
+      components_, robot, data, t, dt, s, kkt_residual);
+  l += CostFunction::linearizeStageCost(robot, data, t, dt, s, kkt_residual);
+  return l;
+}
+
+
+template <typename... Components>
+inline double StaticCostFunction<Components...>::quadratizeStageCost(
+    Robot& robot, CostFunctionData& data, const double t, const double dt, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual,
+    SplitKKTMatrix& kkt_matrix) const {
+  assert(dt > 0);
+  double l = Loop::quadratizeStageCost(
+      components_, robot, data, t, dt, s, kkt_residual, kkt_matrix);
+  l += CostFunction::quadratizeStageCost(
+      robot, data, t, dt, s, kkt_residual, kkt_matrix);
+  return l;
+}
+
+
+template <typename... Components>
+inline double StaticCostFunction<Components...>::computeTerminalCost(
+    Robot& robot, CostFunctionData& data, const double t, 
+    const SplitSolution& s) const {
+  double l = Loop::computeTerminalCost(components_, robot, data, t, s);
+  l += CostFunction::computeTerminalCost(robot, data, t, s);
+  return l;
+}
+
+
+template <typename... Components>
+inline double StaticCostFunction<Components...>::linearizeTerminalCost(
+    Robot& robot, CostFunctionData& data, const double t, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
+  double l = Loop::linearizeTerminalCost(
+      components_, robot, data, t, s, kkt_residual);
+  l += CostFunction::linearizeTerminalCost(robot, data, t, s, kkt_residual);
+  return l;
+}
+
+
+template <typename... Components>
+inline double StaticCostFunction<Components...>::quadratizeTerminalCost(
+    Robot& robot, CostFunctionData& data, const double t, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual, 
+    SplitKKTMatrix& kkt_matrix) const {
+  double l = Loop::quadratizeTerminalCost(
+      components_, robot, data, t, s, kkt_residual, kkt_matrix);
+  l += CostFunction::quadratizeTerminalCost(
+      robot, data, t, s, kkt_residual, kkt_matrix);
+  return l;
+}
+
+
+template <typename... Components>
+inline double StaticCostFunction<Components...>::computeImpulseCost(
+    Robot& robot, CostFunctionData& data, const double t, 
+    const ImpulseSplitSolution& s) const {
+  double l = Loop::computeImpulseCost(components_, robot, data, t, s);
+  l += CostFunction::computeImpulseCost(robot, data, t, s);
+  return l;
+}
+
+
+template <typename... Components>
+inline double StaticCostFunction<Components...>::linearizeImpulseCost(
+    Robot& robot, CostFunctionData& data, const double t, 
+    const ImpulseSplitSolution& s, 
+    ImpulseSplitKKTResidual& kkt_residual) const {
+  double l = Loop::linearizeImpulseCost(
+      components_, robot, data, t, s, kkt_residual);
+  l += CostFunction::linearizeImpulseCost(robot, data, t, s, kkt_residual);
+  return l;
+}
+
+
+template <typename... Components>
+inline double StaticCostFunction<Components...>::quadratizeImpulseCost(
+    Robot& robot, CostFunctionData& data, const double t, 
+    const ImpulseSplitSolution& s, ImpulseSplitKKTResidual& kkt_residual,
+    ImpulseSplitKKTMatrix& kkt_matrix) const {
+  double l = Loop::quadratizeImpulseCost(
+      components_, robot, data, t, s, kkt_residual, kkt_matrix);
+  l += CostFunction::quadratizeImpulseCost(
+      robot, data, t, s, kkt_residual, kkt_matrix);
+  return l;
+}
+
+} // namespace idocp
+
+#endif // IDOCP_STATIC_COST_FUNCTION_HXX_
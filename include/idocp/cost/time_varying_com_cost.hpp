@@ -122,6 +122,14 @@ public:
   ///
   void set_ref(const std::shared_ptr<TimeVaryingCoMRefBase>& ref);
 
+  ///
+  /// @brief Invalidates the references cached in CostFunctionData. Must be 
+  /// called if the reference object is modified after it is set, since the 
+  /// reference is assumed to depend only on the time and is evaluated once 
+  /// per time stage and time.
+  ///
+  void invalidateRefCache();
+
   ///
   /// @brief Sets the weight vector. 
   /// @param[in] q_weight Weight vector on the CoM position error. 
@@ -142,6 +150,10 @@ public:
 
   bool useKinematics() const override;
 
+  BlockSparsity QffSparsity() const override;
+
+  BlockSparsity QqfSparsity() const override;
+
   double computeStageCost(Robot& robot, CostFunctionData& data, const double t, 
                           const double dt, 
                           const SplitSolution& s) const override;
@@ -185,8 +197,13 @@ public:
 
 private:
   std::shared_ptr<TimeVaryingCoMRefBase> ref_;
+  std::size_t ref_id_;
   Eigen::Vector3d q_weight_, qf_weight_, qi_weight_;
 
+  const TimeVaryingRefCache::Entry& getRef(const Robot& robot, 
+                                           CostFunctionData& data, 
+                                           const double t) const;
+
 };
 
 } // namespace idocp
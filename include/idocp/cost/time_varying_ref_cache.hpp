@@ -0,0 +1,160 @@
+#ifndef IDOCP_TIME_VARYING_REF_CACHE_HPP_
+#define IDOCP_TIME_VARYING_REF_CACHE_HPP_
+
+#include <vector>
+#include <cstddef>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/se3.hpp"
+
+
+namespace idocp {
+
+///
+/// @class TimeVaryingRefCache
+/// @brief Cache of the time-varying references of the cost function 
+/// components at a time stage. Since the references depend only on the time 
+/// and the time of a stage does not change over the Newton iterations of an 
+/// MPC update, each time-varying cost evaluates its reference once per 
+/// (stage time, reference) and reads it from this cache afterwards. Stored in 
+/// CostFunctionData so that each time stage owns its cache and the stages can 
+/// be evaluated in parallel.
+///
+class TimeVaryingRefCache {
+public:
+  ///
+  /// @struct Entry
+  /// @brief Cached reference of a cost function component.
+  ///
+  struct Entry {
+    ///
+    /// @brief Constructs the entry for the cost function component.
+    /// @param[in] owner Pointer to the cost function component.
+    ///
+    Entry(const void* owner);
+
+    ///
+    /// @brief Checks if the cached reference is up to date.
+    /// @param[in] ref_id Identifier of the reference of the owner. See 
+    /// TimeVaryingRefCache::generateRefId().
+    /// @param[in] t Time.
+    /// @return true if the cached reference is computed with ref_id at t. 
+    /// false if not.
+    ///
+    bool isUpToDate(const std::size_t ref_id, const double t) const;
+
+    ///
+    /// @brief Marks the cached reference as computed with ref_id at t.
+    /// @param[in] ref_id Identifier of the reference of the owner. 
+    /// @param[in] t Time.
+    ///
+    void setUpToDate(const std::size_t ref_id, const double t);
+
+    ///
+    /// @brief Pointer to the cost function component that owns this entry.
+    ///
+    const void* owner;
+
+    ///
+    /// @brief Identifier of the reference with which this entry is computed.
+    /// Zero means that the entry is not computed yet.
+    ///
+    std::size_t ref_id;
+
+    ///
+    /// @brief Time at which this entry is computed.
+    ///
+    double t;
+
+    ///
+    /// @brief Flag if the reference is active at t.
+    ///
+    bool is_active;
+
+    ///
+    /// @brief Cached reference vector, e.g., the configuration, the position, 
+    /// or the CoM position.
+    ///
+    Eigen::VectorXd ref;
+
+    ///
+    /// @brief Cached reference SE3 placement.
+    ///
+    SE3 SE3_ref;
+
+    ///
+    /// @brief Inverse of the cached reference SE3 placement.
+    ///
+    SE3 SE3_ref_inv;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  ///
+  /// @brief Default constructor. 
+  ///
+  TimeVaryingRefCache();
+
+  ///
+  /// @brief Destructor. 
+  ///
+  ~TimeVaryingRefCache();
+
+  ///
+  /// @brief Default copy constructor. 
+  ///
+  TimeVaryingRefCache(const TimeVaryingRefCache&) = default;
+
+  ///
+  /// @brief Default copy operator. 
+  ///
+  TimeVaryingRefCache& operator=(const TimeVaryingRefCache&) = default;
+
+  ///
+  /// @brief Default move constructor. 
+  ///
+  TimeVaryingRefCache(TimeVaryingRefCache&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator. 
+  ///
+  TimeVaryingRefCache& operator=(TimeVaryingRefCache&&) noexcept = default;
+
+  ///
+  /// @brief Returns the entry of the cost function component. The entry is 
+  /// appended if it does not exist, which happens only at the first 
+  /// evaluation of each stage.
+  /// @param[in] owner Pointer to the cost function component.
+  /// @return Reference to the entry.
+  ///
+  Entry& entry(const void* owner);
+
+  ///
+  /// @brief Invalidates all of the entries.
+  ///
+  void clear();
+
+  ///
+  /// @return Number of the entries.
+  ///
+  int size() const;
+
+  ///
+  /// @brief Generates a unique positive identifier of a reference. The 
+  /// time-varying costs regenerate their identifiers when the references are 
+  /// replaced or modified so that the stale entries are recomputed.
+  /// @return Unique identifier.
+  ///
+  static std::size_t generateRefId();
+
+private:
+  std::vector<Entry, Eigen::aligned_allocator<Entry>> entries_;
+
+};
+
+} // namespace idocp
+
+#include "idocp/cost/time_varying_ref_cache.hxx"
+
+#endif // IDOCP_TIME_VARYING_REF_CACHE_HPP_ 
@@ -0,0 +1,75 @@
+#ifndef IDOCP_TIME_VARYING_REF_CACHE_HXX_
+#define IDOCP_TIME_VARYING_REF_CACHE_HXX_
+
+#include "idocp/cost/time_varying_ref_cache.hpp"
+
+#include <atomic>
+
+
+namespace idocp {
+
+inline TimeVaryingRefCache::Entry::Entry(const void* _owner) 
+  : owner(_owner),
+    ref_id(0),
+    t(0),
+    is_active(false),
+    ref(),
+    SE3_ref(SE3::Identity()),
+    SE3_ref_inv(SE3::Identity()) {
+}
+
+
+inline bool TimeVaryingRefCache::Entry::isUpToDate(const std::size_t _ref_id, 
+                                                   const double _t) const {
+  return (ref_id == _ref_id && t == _t);
+}
+
+
+inline void TimeVaryingRefCache::Entry::setUpToDate(const std::size_t _ref_id, 
+                                                    const double _t) {
+  ref_id = _ref_id;
+  t = _t;
+}
+
+
+inline TimeVaryingRefCache::TimeVaryingRefCache() 
+  : entries_() {
+}
+
+
+inline TimeVaryingRefCache::~TimeVaryingRefCache() {
+}
+
+
+inline TimeVaryingRefCache::Entry& TimeVaryingRefCache::entry(
+    const void* owner) {
+  for (auto& e : entries_) {
+    if (e.owner == owner) {
+      return e;
+    }
+  }
+  entries_.emplace_back(owner);
+  return entries_.back();
+}
+
+
+inline void TimeVaryingRefCache::clear() {
+  for (auto& e : entries_) {
+    e.ref_id = 0;
+  }
+}
+
+
+inline int TimeVaryingRefCache::size() const {
+  return entries_.size();
+}
+
+
+inline std::size_t TimeVaryingRefCache::generateRefId() {
+  static std::atomic<std::size_t> ref_id(0);
+  return ++ref_id;
+}
+
+} // namespace idocp
+
+#endif // IDOCP_TIME_VARYING_REF_CACHE_HXX_ 
@@ -126,6 +126,14 @@ public:
   ///
   void set_ref(const std::shared_ptr<TimeVaryingTaskSpace3DRefBase>& ref);
 
+  ///
+  /// @brief Invalidates the references cached in CostFunctionData. Must be 
+  /// called if the reference object is modified after it is set, since the 
+  /// reference is assumed to depend only on the time and is evaluated once 
+  /// per time stage and time.
+  ///
+  void invalidateRefCache();
+
   ///
   /// @brief Sets the weight vector. 
   /// @param[in] q_3d_weight Weight vector on the position error. 
@@ -146,6 +154,10 @@ public:
 
   bool useKinematics() const override;
 
+  BlockSparsity QffSparsity() const override;
+
+  BlockSparsity QqfSparsity() const override;
+
   double computeStageCost(Robot& robot, CostFunctionData& data, const double t, 
                           const double dt, 
                           const SplitSolution& s) const override;
@@ -190,8 +202,13 @@ public:
 private:
   int frame_id_;
   std::shared_ptr<TimeVaryingTaskSpace3DRefBase> ref_;
+  std::size_t ref_id_;
   Eigen::Vector3d q_3d_weight_, qf_3d_weight_, qi_3d_weight_;
 
+  const TimeVaryingRefCache::Entry& getRef(const Robot& robot, 
+                                           CostFunctionData& data, 
+                                           const double t) const;
+
 };
 
 } // namespace idocp
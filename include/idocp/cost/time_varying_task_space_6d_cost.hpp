@@ -125,6 +125,14 @@ public:
   ///
   void set_ref(const std::shared_ptr<TimeVaryingTaskSpace6DRefBase>& ref);
 
+  ///
+  /// @brief Invalidates the references cached in CostFunctionData. Must be 
+  /// called if the reference object is modified after it is set, since the 
+  /// reference is assumed to depend only on the time and is evaluated once 
+  /// per time stage and time.
+  ///
+  void invalidateRefCache();
+
   ///
   /// @brief Sets the weight vectors. 
   /// @param[in] position_weight Weight vector on the position error. 
@@ -151,6 +159,10 @@ public:
 
   bool useKinematics() const override;
 
+  BlockSparsity QffSparsity() const override;
+
+  BlockSparsity QqfSparsity() const override;
+
   double computeStageCost(Robot& robot, CostFunctionData& data, const double t, 
                           const double dt, 
                           const SplitSolution& s) const override;
@@ -195,8 +207,13 @@ public:
 private:
   int frame_id_;
   std::shared_ptr<TimeVaryingTaskSpace6DRefBase> ref_;
+  std::size_t ref_id_;
   Eigen::VectorXd q_6d_weight_, qf_6d_weight_, qi_6d_weight_;
 
+  const TimeVaryingRefCache::Entry& getRef(const Robot& robot, 
+                                           CostFunctionData& data, 
+                                           const double t) const;
+
 };
 
 } // namespace idocp
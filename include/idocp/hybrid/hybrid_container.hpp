@@ -2,8 +2,12 @@
 #define IDOCP_HYBRID_CONTAINER_HPP_
 
 #include <vector>
+#include <type_traits>
+#include <utility>
 #include <cassert>
 
+#include "Eigen/Core"
+
 #include "idocp/robot/robot.hpp"
 
 
@@ -21,6 +25,30 @@ public:
   EmptyType() {}
   ~EmptyType() {}
 };
+
+
+///
+/// @class has_arena_storage
+/// @brief Checks whether Type can be constructed on an external storage, 
+/// i.e., Type has the constructor Type(const Robot&, double*) and the static 
+/// function Type::storageSize(const Robot&).
+///
+template <typename Type>
+class has_arena_storage {
+private:
+  template <typename T>
+  static auto check(int) 
+      -> decltype(T::storageSize(std::declval<const Robot&>()), 
+                  T(std::declval<const Robot&>(), std::declval<double*>()),
+                  std::true_type());
+
+  template <typename T>
+  static std::false_type check(...);
+
+public:
+  static constexpr bool value = decltype(check<Type>(0))::value;
+};
+
 } // namespace internal
 
 
@@ -41,17 +69,30 @@ template <typename Type, typename ImpulseType=internal::EmptyType,
 class hybrid_container {
 public:
   ///
-  /// @brief Constructor. 
+  /// @brief Constructor. If the data types support the external storage 
+  /// (see internal::has_arena_storage), the data of all the stages are 
+  /// allocated in a contiguous arena in stage order, i.e., data, impulse, aux,
+  /// lift, and switching. Currently only SplitRiccatiFactorization supports 
+  /// the external storage; the other data types own their storage. The aux,
+  /// lift, impulse, and switching data are allocated for N_impulse stages 
+  /// each regardless of the number of the discrete events on the horizon.
   /// @param[in] robot Robot model.
   /// @param[in] N number of the standard data.
   /// @param[in] N_impulse number of the impulse data. Default is 0.
   ///
   hybrid_container(const Robot& robot, const int N, const int N_impulse=0) 
-    : data(N+1, Type(robot)), 
-      aux(N_impulse, Type(robot)), 
-      lift(N_impulse, Type(robot)),
-      impulse(N_impulse, ImpulseType(robot)),
-      switching(N_impulse, SwitchingType(robot)) {
+    : data(), 
+      aux(), 
+      lift(),
+      impulse(),
+      switching(),
+      arena_(Eigen::VectorXd::Zero(arenaSize(robot, N, N_impulse))) {
+    double* storage = arena_.data();
+    construct(robot, N+1, data, storage);
+    construct(robot, N_impulse, impulse, storage);
+    construct(robot, N_impulse, aux, storage);
+    construct(robot, N_impulse, lift, storage);
+    construct(robot, N_impulse, switching, storage);
   }
 
   ///
@@ -62,18 +103,37 @@ public:
       aux(),
       lift(),
       impulse(),
-      switching() {
+      switching(),
+      arena_() {
   }
 
   ///
-  /// @brief Default copy constructor. 
+  /// @brief Copy constructor. The copied data own their storage and the 
+  /// arena is not copied. 
   ///
-  hybrid_container(const hybrid_container&) = default;
+  hybrid_container(const hybrid_container& other)
+    : data(other.data), 
+      aux(other.aux),
+      lift(other.lift),
+      impulse(other.impulse),
+      switching(other.switching),
+      arena_() {
+  }
 
   ///
-  /// @brief Default copy assign operator. 
+  /// @brief Copy assign operator. The values are copied into the current 
+  /// storage if the sizes are the same.
   ///
-  hybrid_container& operator=(const hybrid_container&) = default;
+  hybrid_container& operator=(const hybrid_container& other) {
+    if (this != &other) {
+      data = other.data;
+      aux = other.aux;
+      lift = other.lift;
+      impulse = other.impulse;
+      switching = other.switching;
+    }
+    return *this;
+  }
 
   ///
   /// @brief Default move constructor. 
@@ -107,6 +167,60 @@ public:
   std::vector<Type> data, aux, lift;
   std::vector<ImpulseType> impulse;
   std::vector<SwitchingType> switching;
+
+private:
+  Eigen::VectorXd arena_;
+
+  template <typename T>
+  static int storageSize(const Robot& robot, std::true_type) {
+    return T::storageSize(robot);
+  }
+
+  template <typename T>
+  static int storageSize(const Robot& robot, std::false_type) {
+    return 0;
+  }
+
+  template <typename T>
+  static int storageSize(const Robot& robot) {
+    return storageSize<T>(
+        robot, std::integral_constant<bool, 
+                                      internal::has_arena_storage<T>::value>());
+  }
+
+  static int arenaSize(const Robot& robot, const int N, const int N_impulse) {
+    return (N+1) * storageSize<Type>(robot) 
+            + N_impulse * (2*storageSize<Type>(robot) 
+                            + storageSize<ImpulseType>(robot) 
+                            + storageSize<SwitchingType>(robot));
+  }
+
+  template <typename T>
+  static void construct(const Robot& robot, const int size, 
+                        std::vector<T>& vec, double*& storage, 
+                        std::true_type) {
+    vec.reserve(size);
+    for (int i=0; i<size; ++i) {
+      vec.emplace_back(robot, storage);
+      storage += T::storageSize(robot);
+    }
+  }
+
+  template <typename T>
+  static void construct(const Robot& robot, const int size, 
+                        std::vector<T>& vec, double*& storage, 
+                        std::false_type) {
+    vec.assign(size, T(robot));
+  }
+
+  template <typename T>
+  static void construct(const Robot& robot, const int size, 
+                        std::vector<T>& vec, double*& storage) {
+    construct(robot, size, vec, storage, 
+              std::integral_constant<bool, 
+                                     internal::has_arena_storage<T>::value>());
+  }
+
 };
 
 } // namespace idocp
@@ -57,6 +57,24 @@ public:
   ///
   HybridTimeDiscretization& operator=(HybridTimeDiscretization&&) noexcept = default;
 
+  ///
+  /// @brief Sets the step sizes of the discretization grids, e.g., fine near 
+  /// the initial time and coarse far out. The discrete events are inserted 
+  /// into these grids in the same manner as into the uniform grids. 
+  /// @param[in] dt Step sizes of the N_ideal() grids. Each step size must be
+  /// positive and the sum must be the length of the horizon.
+  ///
+  void setDiscretizationGrid(const std::vector<double>& dt);
+
+  ///
+  /// @brief Sets geometrically growing step sizes of the discretization 
+  /// grids, i.e., the step size of each grid is ratio times that of the 
+  /// previous grid and the sum is the length of the horizon. 
+  /// @param[in] ratio Ratio of the step sizes of the neighbouring grids. 
+  /// Must be positive. 1 yields the uniform grids, which is the default.
+  ///
+  void setGeometricDiscretizationGrid(const double ratio);
+
   ///
   /// @brief Discretizes the finite horizon taking into account the discrete 
   /// events. 
@@ -91,6 +109,14 @@ public:
   ///
   int N_ideal() const;
 
+  ///
+  /// @brief Returns the step size of the discretization grid, which does 
+  /// not take into account the discrete events. 
+  /// @param[in] grid_index Index of the grid of interest. 
+  /// @return Step size of the grid. 
+  ///
+  double dt_grid(const int grid_index) const;
+
   ///
   /// @brief Returns the contact phase of the time stage. 
   /// @param[in] time_stage Time stage of interest. 
@@ -225,7 +251,8 @@ public:
   double dt_lift(const int lift_index) const;
 
   ///
-  /// @brief Returns the ideal time step. 
+  /// @brief Returns the ideal time step, i.e., the average step size of the 
+  /// discretization grids. 
   /// @return The ideal time step.
   ///
   double dt_ideal() const;
@@ -289,20 +316,24 @@ public:
       = std::sqrt(std::numeric_limits<double>::epsilon());
 
 private:
-  double T_, dt_ideal_, max_dt_;
+  double T_, dt_ideal_;
   int N_, N_ideal_, N_impulse_, N_lift_, max_events_;
+  bool is_uniform_grid_;
   std::vector<int> contact_phase_index_from_time_stage_, 
                    impulse_index_after_time_stage_, 
                    lift_index_after_time_stage_, time_stage_before_impulse_, 
                    time_stage_before_lift_;
   std::vector<bool> is_time_stage_before_impulse_, is_time_stage_before_lift_,
                     sto_impulse_, sto_lift_;
-  std::vector<double> t_, t_impulse_, t_lift_, dt_, dt_aux_, dt_lift_;
+  std::vector<double> t_, t_impulse_, t_lift_, dt_, dt_aux_, dt_lift_,
+                      t_grid_, dt_grid_;
   std::vector<DiscreteEventType> event_types_;
 
   void countDiscreteEvents(const ContactSequence& contact_sequence, 
                            const double t);
 
+  int gridIndex(const double time_from_initial) const;
+
   void countTimeSteps(const double t);
 
   void countTimeStages();
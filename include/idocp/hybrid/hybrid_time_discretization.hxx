@@ -3,7 +3,11 @@
 
 #include "idocp/hybrid/hybrid_time_discretization.hpp"
 
+#include <string>
+#include <stdexcept>
+#include <iostream>
 #include <cassert>
+#include <algorithm>
 
 namespace idocp {
 
@@ -12,12 +16,12 @@ inline HybridTimeDiscretization::HybridTimeDiscretization(const double T,
                                                           const int max_events) 
   : T_(T),
     dt_ideal_(T/N), 
-    max_dt_(dt_ideal_-min_dt),
     N_(N),
     N_ideal_(N),
     N_impulse_(0),
     N_lift_(0),
     max_events_(max_events),
+    is_uniform_grid_(true),
     contact_phase_index_from_time_stage_(N+1, 0), 
     impulse_index_after_time_stage_(N+1, -1), 
     lift_index_after_time_stage_(N+1, -1), 
@@ -31,21 +35,26 @@ inline HybridTimeDiscretization::HybridTimeDiscretization(const double T,
     dt_(N+1, static_cast<double>(T/N)),
     dt_aux_(max_events+1, 0),
     dt_lift_(max_events+1, 0),
+    t_grid_(N+1, 0),
+    dt_grid_(N, static_cast<double>(T/N)),
     event_types_(2*max_events+1, DiscreteEventType::None),
     sto_impulse_(max_events), 
     sto_lift_(max_events) {
+  for (int i=0; i<=N; ++i) {
+    t_grid_[i] = i * dt_ideal_;
+  }
 }
 
 
 inline HybridTimeDiscretization::HybridTimeDiscretization()
   : T_(0),
     dt_ideal_(0), 
-    max_dt_(0),
     N_(0),
     N_ideal_(0),
     N_impulse_(0),
     N_lift_(0),
     max_events_(0),
+    is_uniform_grid_(true),
     contact_phase_index_from_time_stage_(), 
     impulse_index_after_time_stage_(), 
     lift_index_after_time_stage_(), 
@@ -59,6 +68,8 @@ inline HybridTimeDiscretization::HybridTimeDiscretization()
     dt_(),
     dt_aux_(),
     dt_lift_(),
+    t_grid_(),
+    dt_grid_(),
     event_types_(),
     sto_impulse_(), 
     sto_lift_() {
@@ -69,6 +80,76 @@ inline HybridTimeDiscretization::~HybridTimeDiscretization() {
 }
 
 
+inline void HybridTimeDiscretization::setDiscretizationGrid(
+    const std::vector<double>& dt) {
+  try {
+    if (static_cast<int>(dt.size()) != N_ideal_) {
+      throw std::invalid_argument(
+          "invalid argument: dt.size() must be " + std::to_string(N_ideal_) + "!");
+    }
+    double T = 0;
+    for (const auto e : dt) {
+      if (e <= min_dt) {
+        throw std::out_of_range("invalid value: dt must be positive!");
+      }
+      T += e;
+    }
+    if (std::abs(T-T_) > N_ideal_*min_dt) {
+      throw std::out_of_range(
+          "invalid value: sum of dt must be " + std::to_string(T_) + "!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  t_grid_[0] = 0;
+  for (int i=0; i<N_ideal_; ++i) {
+    dt_grid_[i] = dt[i];
+    t_grid_[i+1] = t_grid_[i] + dt[i];
+  }
+  // Removes the round-off error so that the horizon ends exactly at T.
+  t_grid_[N_ideal_] = T_;
+  dt_grid_[N_ideal_-1] = T_ - t_grid_[N_ideal_-1];
+  is_uniform_grid_ = false;
+}
+
+
+inline void HybridTimeDiscretization::setGeometricDiscretizationGrid(
+    const double ratio) {
+  try {
+    if (ratio <= 0) {
+      throw std::out_of_range("invalid value: ratio must be positive!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  if (ratio == 1) {
+    for (int i=0; i<N_ideal_; ++i) {
+      dt_grid_[i] = dt_ideal_;
+      t_grid_[i] = i * dt_ideal_;
+    }
+    t_grid_[N_ideal_] = N_ideal_ * dt_ideal_;
+    is_uniform_grid_ = true;
+    return;
+  }
+  std::vector<double> dt(N_ideal_);
+  double scale = 0;
+  double ratio_pow = 1;
+  for (int i=0; i<N_ideal_; ++i) {
+    dt[i] = ratio_pow;
+    scale += ratio_pow;
+    ratio_pow *= ratio;
+  }
+  for (auto& e : dt) {
+    e *= (T_/scale);
+  }
+  setDiscretizationGrid(dt);
+}
+
+
 inline void HybridTimeDiscretization::discretize(
     const ContactSequence& contact_sequence, const double t) {
   countDiscreteEvents(contact_sequence, t);
@@ -105,6 +186,13 @@ inline int HybridTimeDiscretization::N_ideal() const {
 }
 
 
+inline double HybridTimeDiscretization::dt_grid(const int grid_index) const {
+  assert(grid_index >= 0);
+  assert(grid_index < N_ideal());
+  return dt_grid_[grid_index];
+}
+
+
 inline int HybridTimeDiscretization::contactPhase(const int time_stage) const {
   assert(time_stage >= 0);
   assert(time_stage <= N());
@@ -328,16 +416,19 @@ inline void HybridTimeDiscretization::countDiscreteEvents(
   assert(N_impulse_ <= max_events_);
   for (int i=0; i<N_impulse_; ++i) {
     t_impulse_[i] = contact_sequence.impulseTime(i);
-    time_stage_before_impulse_[i] = std::floor((t_impulse_[i]-t)/dt_ideal_);
+    time_stage_before_impulse_[i] = gridIndex(t_impulse_[i]-t);
     sto_impulse_[i] = contact_sequence.isSTOEnabledImpulse(i);
   }
+  // Resets the sentinel in case the number of the events is reduced.
+  time_stage_before_impulse_[N_impulse_] = -1;
   N_lift_ = contact_sequence.numLiftEvents();
   assert(N_lift_ <= max_events_);
   for (int i=0; i<N_lift_; ++i) {
     t_lift_[i] = contact_sequence.liftTime(i);
-    time_stage_before_lift_[i] = std::floor((t_lift_[i]-t)/dt_ideal_);
+    time_stage_before_lift_[i] = gridIndex(t_lift_[i]-t);
     sto_lift_[i] = contact_sequence.isSTOEnabledLift(i);
   }
+  time_stage_before_lift_[N_lift_] = -1;
   N_ = N_ideal_;
   for (int i=0; i<N_impulse_+N_lift_; ++i) {
     event_types_[i] = contact_sequence.eventType(i);
@@ -346,59 +437,72 @@ inline void HybridTimeDiscretization::countDiscreteEvents(
 }
 
 
+inline int HybridTimeDiscretization::gridIndex(
+    const double time_from_initial) const {
+  if (is_uniform_grid_) {
+    return std::floor(time_from_initial/dt_ideal_);
+  }
+  else {
+    return (std::upper_bound(t_grid_.begin(), t_grid_.end(), time_from_initial)
+              - t_grid_.begin() - 1);
+  }
+}
+
+
 inline void HybridTimeDiscretization::countTimeSteps(const double t) {
   int impulse_index = 0;
   int lift_index = 0;
   int num_events_on_grid = 0;
   for (int i=0; i<N_ideal_; ++i) {
     const int stage = i - num_events_on_grid;
+    const double max_dt = dt_grid_[i] - min_dt;
     if (i == time_stage_before_impulse_[impulse_index]) {
-      dt_[stage] = t_impulse_[impulse_index] - i * dt_ideal_ - t;
+      dt_[stage] = t_impulse_[impulse_index] - t_grid_[i] - t;
       assert(dt_[stage] >= -min_dt);
-      assert(dt_[stage] <= dt_ideal_+min_dt);
+      assert(dt_[stage] <= dt_grid_[i]+min_dt);
       if (dt_[stage] <= min_dt) {
         time_stage_before_impulse_[impulse_index] = stage - 1;
-        dt_aux_[impulse_index] = dt_ideal_;
-        t_[stage] = t + (i-1) * dt_ideal_;
+        dt_aux_[impulse_index] = dt_grid_[i];
+        t_[stage] = t + t_grid_[std::max(i-1, 0)];
         ++num_events_on_grid;
         ++impulse_index;
       }
-      else if (dt_[stage] >= max_dt_) {
+      else if (dt_[stage] >= max_dt) {
         time_stage_before_impulse_[impulse_index] = i + 1;
-        t_[stage] = t + i * dt_ideal_;
+        t_[stage] = t + t_grid_[i];
       }
       else {
         time_stage_before_impulse_[impulse_index] = stage;
-        dt_aux_[impulse_index] = dt_ideal_ - dt_[stage];
-        t_[stage] = t + i * dt_ideal_;
+        dt_aux_[impulse_index] = dt_grid_[i] - dt_[stage];
+        t_[stage] = t + t_grid_[i];
         ++impulse_index;
       }
     }
     else if (i == time_stage_before_lift_[lift_index]) {
-      dt_[stage] = t_lift_[lift_index] - i * dt_ideal_ - t;
+      dt_[stage] = t_lift_[lift_index] - t_grid_[i] - t;
       assert(dt_[stage] >= -min_dt);
-      assert(dt_[stage] <= dt_ideal_+min_dt);
+      assert(dt_[stage] <= dt_grid_[i]+min_dt);
       if (dt_[stage] <= min_dt) {
         time_stage_before_lift_[lift_index] = stage - 1;
-        dt_lift_[lift_index] = dt_ideal_;
-        t_[stage] = t + (i-1) * dt_ideal_;
+        dt_lift_[lift_index] = dt_grid_[i];
+        t_[stage] = t + t_grid_[std::max(i-1, 0)];
         ++num_events_on_grid;
         ++lift_index;
       }
-      else if (dt_[stage] >= max_dt_) {
+      else if (dt_[stage] >= max_dt) {
         time_stage_before_lift_[lift_index] = i + 1;
-        t_[stage] = t + i * dt_ideal_;
+        t_[stage] = t + t_grid_[i];
       }
       else {
         time_stage_before_lift_[lift_index] = stage;
-        dt_lift_[lift_index] = dt_ideal_ - dt_[stage];
-        t_[stage] = t + i * dt_ideal_;
+        dt_lift_[lift_index] = dt_grid_[i] - dt_[stage];
+        t_[stage] = t + t_grid_[i];
         ++lift_index;
       }
     }
     else {
-      dt_[stage] = dt_ideal_;
-      t_[stage] = t + i * dt_ideal_;
+      dt_[stage] = dt_grid_[i];
+      t_[stage] = t + t_grid_[i];
     }
   }
   N_ = N_ideal_ - num_events_on_grid;
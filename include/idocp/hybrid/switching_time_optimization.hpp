@@ -0,0 +1,147 @@
+#ifndef IDOCP_SWITCHING_TIME_OPTIMIZATION_HPP_
+#define IDOCP_SWITCHING_TIME_OPTIMIZATION_HPP_
+
+#include "Eigen/Core"
+
+#include "idocp/ocp/ocp.hpp"
+#include "idocp/ocp/solution.hpp"
+#include "idocp/ocp/kkt_matrix.hpp"
+#include "idocp/hybrid/contact_sequence.hpp"
+
+
+namespace idocp {
+
+///
+/// @class SwitchingTimeOptimization
+/// @brief Optimization of the switching times of the discrete events whose
+/// switching time optimization (STO) is enabled in the contact sequence.
+/// The gradient of the Lagrangian with respect to each switching time is the
+/// jump of the Hamiltonian at the event, including the term of the switching
+/// constraint. The switching times are updated by the gradient step scaled by
+/// a constant Hessian and clipped so that the discretization stays tractable.
+/// The step is not coupled with the Riccati recursion.
+///
+class SwitchingTimeOptimization {
+public:
+  ///
+  /// @brief Constructor.
+  /// @param[in] max_num_impulse Maximum number of each discrete events
+  /// (impulse and lift).
+  ///
+  SwitchingTimeOptimization(const int max_num_impulse);
+
+  ///
+  /// @brief Default constructor.
+  ///
+  SwitchingTimeOptimization();
+
+  ///
+  /// @brief Destructor.
+  ///
+  ~SwitchingTimeOptimization();
+
+  ///
+  /// @brief Default copy constructor.
+  ///
+  SwitchingTimeOptimization(const SwitchingTimeOptimization&) = default;
+
+  ///
+  /// @brief Default copy assign operator.
+  ///
+  SwitchingTimeOptimization& operator=(const SwitchingTimeOptimization&)
+      = default;
+
+  ///
+  /// @brief Default move constructor.
+  ///
+  SwitchingTimeOptimization(SwitchingTimeOptimization&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator.
+  ///
+  SwitchingTimeOptimization& operator=(SwitchingTimeOptimization&&) noexcept
+      = default;
+
+  ///
+  /// @brief Sets the parameters of the switching time optimization.
+  /// @param[in] hessian Constant approximation of the Hessian of the 
+  /// Lagrangian with respect to each switching time, which scales the 
+  /// gradient step. Must be positive. Default is 1.0e03.
+  /// @param[in] max_step_size Maximum change of each switching time in a
+  /// single iteration. Must be positive. Default is 0.01.
+  ///
+  void setParameters(const double hessian, const double max_step_size);
+
+  ///
+  /// @brief Computes the gradients of the Lagrangian with respect to the
+  /// switching times. Before calling this function,
+  /// DirectMultipleShooting::computeKKTResidual() or
+  /// DirectMultipleShooting::computeKKTSystem() must be called.
+  /// @param[in] ocp Optimal control problem.
+  /// @param[in] kkt_matrix KKT matrix. The Jacobians of the switching 
+  /// constraints are used.
+  /// @param[in] s Solution.
+  ///
+  void computeKKTResidual(const OCP& ocp, const KKTMatrix& kkt_matrix, 
+                          const Solution& s);
+
+  ///
+  /// @brief Computes the directions of the switching times from the gradients
+  /// computed by SwitchingTimeOptimization::computeKKTResidual().
+  /// @param[in] ocp Optimal control problem.
+  ///
+  void computeDirection(const OCP& ocp);
+
+  ///
+  /// @brief Updates the switching times of the STO-enabled events in the
+  /// contact sequence. The updated switching times keep the order of the
+  /// events and are kept away from each other and from the boundaries of the
+  /// horizon by twice the maximum time step of the discretization grid.
+  /// @param[in] ocp Optimal control problem.
+  /// @param[in] step_size Step size.
+  /// @param[in, out] contact_sequence Contact sequence.
+  ///
+  void integrateSwitchingTimes(const OCP& ocp, const double step_size,
+                               ContactSequence& contact_sequence) const;
+
+  ///
+  /// @brief Returns the squared norm of the gradients with respect to the
+  /// switching times.
+  /// @return The squared norm of the gradients.
+  ///
+  double KKTError() const;
+
+  ///
+  /// @brief Returns the gradients with respect to the impulse times.
+  /// @return Const reference to the gradients.
+  ///
+  const Eigen::VectorXd& impulseTimeGradient() const;
+
+  ///
+  /// @brief Returns the gradients with respect to the lift times.
+  /// @return Const reference to the gradients.
+  ///
+  const Eigen::VectorXd& liftTimeGradient() const;
+
+  ///
+  /// @brief Returns the directions of the impulse times.
+  /// @return Const reference to the directions.
+  ///
+  const Eigen::VectorXd& impulseTimeDirection() const;
+
+  ///
+  /// @brief Returns the directions of the lift times.
+  /// @return Const reference to the directions.
+  ///
+  const Eigen::VectorXd& liftTimeDirection() const;
+
+private:
+  int N_impulse_, N_lift_;
+  double hessian_, max_step_size_;
+  Eigen::VectorXd impulse_grad_, lift_grad_, impulse_dir_, lift_dir_;
+
+};
+
+} // namespace idocp
+
+#endif // IDOCP_SWITCHING_TIME_OPTIMIZATION_HPP_
@@ -90,6 +90,23 @@ public:
                                ImpulseSplitKKTMatrix& kkt_matrix, 
                                ImpulseSplitKKTResidual& kkt_residual);
 
+  ///
+  /// @brief Condenses the inverse dynamics constraint only into the KKT 
+  /// residual, reusing the condensing matrices and the Hessians of the last 
+  /// ImpulseDynamics::condenseImpulseDynamics(), e.g., at 
+  /// IterationLevel::Jacobian and IterationLevel::Residual of the multi-level 
+  /// iteration. 
+  /// @param[in] robot Robot model. 
+  /// @param[in] impulse_status Impulse status of this impulse stage. 
+  /// @param[in] kkt_matrix Split KKT matrix of this impulse stage condensed 
+  /// by the last ImpulseDynamics::condenseImpulseDynamics().
+  /// @param[in, out] kkt_residual Split KKT residual of this impulse stage.
+  ///
+  void condenseImpulseDynamicsResidual(
+      Robot& robot, const ImpulseStatus& impulse_status,
+      const ImpulseSplitKKTMatrix& kkt_matrix, 
+      ImpulseSplitKKTResidual& kkt_residual);
+
   ///
   /// @brief Expands the primal variables, i.e., computes the Newton direction 
   /// of the condensed primal variables (impulse change in the velocity dv and 
@@ -64,28 +64,54 @@ inline void ImpulseDynamics::condenseImpulseDynamics(
       = data_.MJtJinv().bottomRightCorner(dimf, dimf) * data_.dCdv();
   data_.MJtJinv_ImDC().noalias() = data_.MJtJinv() * data_.ImDC();
 
+  const BlockSparsity Qff_sparsity = kkt_matrix.QffSparsity();
+  const bool has_Qqf = (kkt_matrix.QqfSparsity() != BlockSparsity::Zero);
+  assert(Qff_sparsity != BlockSparsity::Zero || kkt_matrix.Qff().isZero());
+  assert(Qff_sparsity != BlockSparsity::Diagonal 
+          || kkt_matrix.Qff().isDiagonal());
+  assert(has_Qqf || kkt_matrix.Qqf().isZero());
   data_.Qdvfqv().topRows(dimv).noalias() 
       = (- kkt_matrix.Qdvdv.diagonal()).asDiagonal() 
           * data_.MJtJinv_dImDCdqv().topRows(dimv);
-  data_.Qdvfqv().bottomRows(dimf).noalias() 
-      = - kkt_matrix.Qff() * data_.MJtJinv_dImDCdqv().bottomRows(dimf);
-  data_.Qdvfqv().bottomLeftCorner(dimf, dimv).noalias() 
-      -= kkt_matrix.Qqf().transpose();
   data_.ldv() = kkt_residual.ldv;
   data_.lf()  = - kkt_residual.lf();
   data_.ldv().noalias() 
       -= kkt_matrix.Qdvdv.diagonal().asDiagonal() 
           * data_.MJtJinv_ImDC().head(dimv);
-  data_.lf().noalias() -= kkt_matrix.Qff() * data_.MJtJinv_ImDC().tail(dimf);
+  switch (Qff_sparsity) {
+    case BlockSparsity::Zero:
+      data_.Qdvfqv().bottomRows(dimf).setZero();
+      break;
+    case BlockSparsity::Diagonal:
+      data_.Qdvfqv().bottomRows(dimf).noalias() 
+          = (- kkt_matrix.Qff().diagonal()).asDiagonal() 
+              * data_.MJtJinv_dImDCdqv().bottomRows(dimf);
+      data_.lf().noalias() 
+          -= kkt_matrix.Qff().diagonal().asDiagonal() 
+              * data_.MJtJinv_ImDC().tail(dimf);
+      break;
+    default:
+      data_.Qdvfqv().bottomRows(dimf).noalias() 
+          = - kkt_matrix.Qff() * data_.MJtJinv_dImDCdqv().bottomRows(dimf);
+      data_.lf().noalias() 
+          -= kkt_matrix.Qff() * data_.MJtJinv_ImDC().tail(dimf);
+      break;
+  }
+  if (has_Qqf) {
+    data_.Qdvfqv().bottomLeftCorner(dimf, dimv).noalias() 
+        -= kkt_matrix.Qqf().transpose();
+  }
 
   kkt_matrix.Qxx.noalias() 
       -= data_.MJtJinv_dImDCdqv().transpose() * data_.Qdvfqv();
-  kkt_matrix.Qxx.topRows(dimv).noalias() 
-      += kkt_matrix.Qqf() * data_.MJtJinv_dImDCdqv().bottomRows(dimf);
   kkt_residual.lx.noalias() 
       -= data_.MJtJinv_dImDCdqv().transpose() * data_.ldvf();
-  kkt_residual.lq().noalias()
-      += kkt_matrix.Qqf() * data_.MJtJinv_ImDC().tail(dimf);
+  if (has_Qqf) {
+    kkt_matrix.Qxx.topRows(dimv).noalias() 
+        += kkt_matrix.Qqf() * data_.MJtJinv_dImDCdqv().bottomRows(dimf);
+    kkt_residual.lq().noalias()
+        += kkt_matrix.Qqf() * data_.MJtJinv_ImDC().tail(dimf);
+  }
 
   kkt_matrix.Fvq() = - data_.MJtJinv_dImDCdqv().topLeftCorner(dimv, dimv);
   kkt_matrix.Fvv() = Eigen::MatrixXd::Identity(dimv, dimv) 
@@ -94,6 +120,43 @@ inline void ImpulseDynamics::condenseImpulseDynamics(
 }
 
 
+inline void ImpulseDynamics::condenseImpulseDynamicsResidual(
+    Robot& robot, const ImpulseStatus& impulse_status, 
+    const ImpulseSplitKKTMatrix& kkt_matrix, 
+    ImpulseSplitKKTResidual& kkt_residual) {
+  const int dimv = robot.dimv();
+  const int dimf = impulse_status.dimf();
+  data_.MJtJinv_ImDC().noalias() = data_.MJtJinv() * data_.ImDC();
+  const BlockSparsity Qff_sparsity = kkt_matrix.QffSparsity();
+  const bool has_Qqf = (kkt_matrix.QqfSparsity() != BlockSparsity::Zero);
+  data_.ldv() = kkt_residual.ldv;
+  data_.lf()  = - kkt_residual.lf();
+  data_.ldv().noalias() 
+      -= kkt_matrix.Qdvdv.diagonal().asDiagonal() 
+          * data_.MJtJinv_ImDC().head(dimv);
+  switch (Qff_sparsity) {
+    case BlockSparsity::Zero:
+      break;
+    case BlockSparsity::Diagonal:
+      data_.lf().noalias() 
+          -= kkt_matrix.Qff().diagonal().asDiagonal() 
+              * data_.MJtJinv_ImDC().tail(dimf);
+      break;
+    default:
+      data_.lf().noalias() 
+          -= kkt_matrix.Qff() * data_.MJtJinv_ImDC().tail(dimf);
+      break;
+  }
+  kkt_residual.lx.noalias() 
+      -= data_.MJtJinv_dImDCdqv().transpose() * data_.ldvf();
+  if (has_Qqf) {
+    kkt_residual.lq().noalias()
+        += kkt_matrix.Qqf() * data_.MJtJinv_ImDC().tail(dimf);
+  }
+  kkt_residual.Fv().noalias() -= data_.MJtJinv_ImDC().head(dimv);
+}
+
+
 inline void ImpulseDynamics::expandPrimal(ImpulseSplitDirection& d) const {
   d.ddvf().noalias()  = - data_.MJtJinv_dImDCdqv() * d.dx;
   d.ddvf().noalias() -= data_.MJtJinv_ImDC();
@@ -5,6 +5,7 @@
 
 #include "idocp/robot/robot.hpp"
 #include "idocp/robot/impulse_status.hpp"
+#include "idocp/ocp/block_sparsity.hpp"
 
 
 namespace idocp {
@@ -196,10 +197,40 @@ public:
   Eigen::MatrixXd Fqq_prev;
 
   ///
-  /// @brief Set the all components zero.
+  /// @brief Set the all components zero. Qff() and Qqf() are cleared only 
+  /// over their current sparsity patterns, which are then reset to 
+  /// BlockSparsity::Dense.
   ///
   void setZero();
 
+  ///
+  /// @brief Sets the sparsity pattern of ImpulseSplitKKTMatrix::Qff(). 
+  /// Call this just after ImpulseSplitKKTMatrix::setZero() with a pattern 
+  /// that covers all the values added to ImpulseSplitKKTMatrix::Qff() 
+  /// afterwards. The condensing skips the entries outside of this pattern. 
+  /// @param[in] sparsity Sparsity pattern. 
+  ///
+  void setQffSparsity(const BlockSparsity sparsity);
+
+  ///
+  /// @brief Sets the sparsity pattern of ImpulseSplitKKTMatrix::Qqf(). 
+  /// Call this just after ImpulseSplitKKTMatrix::setZero() with a pattern 
+  /// that covers all the values added to ImpulseSplitKKTMatrix::Qqf() 
+  /// afterwards. 
+  /// @param[in] sparsity Sparsity pattern. 
+  ///
+  void setQqfSparsity(const BlockSparsity sparsity);
+
+  ///
+  /// @return Sparsity pattern of ImpulseSplitKKTMatrix::Qff(). 
+  ///
+  BlockSparsity QffSparsity() const;
+
+  ///
+  /// @return Sparsity pattern of ImpulseSplitKKTMatrix::Qqf(). 
+  ///
+  BlockSparsity QqfSparsity() const;
+
   ///
   /// @brief Returns the dimension of the stack of impulse forces at the current 
   /// impulse status.
@@ -255,6 +286,7 @@ public:
 
 private:
   Eigen::MatrixXd Qff_full_, Qqf_full_;
+  BlockSparsity Qff_sparsity_, Qqf_sparsity_;
   int dimv_, dimi_;
   bool has_floating_base_;
 
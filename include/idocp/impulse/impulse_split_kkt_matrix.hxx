@@ -15,6 +15,8 @@ inline ImpulseSplitKKTMatrix::ImpulseSplitKKTMatrix(const Robot& robot)
     Fqq_prev(),
     Qff_full_(Eigen::MatrixXd::Zero(robot.max_dimf(), robot.max_dimf())),
     Qqf_full_(Eigen::MatrixXd::Zero(robot.dimv(), robot.max_dimf())),
+    Qff_sparsity_(BlockSparsity::Dense),
+    Qqf_sparsity_(BlockSparsity::Dense),
     dimv_(robot.dimv()), 
     dimi_(0),
     has_floating_base_(robot.hasFloatingBase()) {
@@ -32,6 +34,8 @@ inline ImpulseSplitKKTMatrix::ImpulseSplitKKTMatrix()
     Fqq_prev(),
     Qff_full_(),
     Qqf_full_(),
+    Qff_sparsity_(BlockSparsity::Dense),
+    Qqf_sparsity_(BlockSparsity::Dense),
     dimv_(0), 
     dimi_(0) {
 }
@@ -43,7 +47,13 @@ inline ImpulseSplitKKTMatrix::~ImpulseSplitKKTMatrix() {
 
 inline void ImpulseSplitKKTMatrix::setImpulseStatus(
     const ImpulseStatus& impulse_status) {
-  dimi_ = impulse_status.dimf();
+  const int dim = impulse_status.dimf();
+  if (dim != dimi_) {
+    // The entries of the blocks are moved with the dimension. 
+    Qff_sparsity_ = BlockSparsity::Dense;
+    Qqf_sparsity_ = BlockSparsity::Dense;
+  }
+  dimi_ = dim;
 }
 
 
@@ -161,12 +171,43 @@ inline void ImpulseSplitKKTMatrix::setZero() {
   Fxx.setZero();
   Qxx.setZero();
   Qdvdv.setZero();
-  Qff().setZero();
-  Qqf().setZero();
+  if (Qff_sparsity_ == BlockSparsity::Dense) {
+    Qff().setZero();
+  }
+  else if (Qff_sparsity_ == BlockSparsity::Diagonal) {
+    Qff().diagonal().setZero();
+  }
+  if (Qqf_sparsity_ != BlockSparsity::Zero) {
+    Qqf().setZero();
+  }
+  Qff_sparsity_ = BlockSparsity::Dense;
+  Qqf_sparsity_ = BlockSparsity::Dense;
   Fqq_prev.setZero();
 }
 
 
+inline void ImpulseSplitKKTMatrix::setQffSparsity(
+    const BlockSparsity sparsity) {
+  Qff_sparsity_ = sparsity;
+}
+
+
+inline void ImpulseSplitKKTMatrix::setQqfSparsity(
+    const BlockSparsity sparsity) {
+  Qqf_sparsity_ = sparsity;
+}
+
+
+inline BlockSparsity ImpulseSplitKKTMatrix::QffSparsity() const {
+  return Qff_sparsity_;
+}
+
+
+inline BlockSparsity ImpulseSplitKKTMatrix::QqfSparsity() const {
+  return Qqf_sparsity_;
+}
+
+
 inline int ImpulseSplitKKTMatrix::dimi() const {
   return dimi_;
 }
@@ -218,6 +259,8 @@ inline void ImpulseSplitKKTMatrix::setRandom() {
   Qdvdv = Qdvdvff.topLeftCorner(dimv_, dimv_);
   Qff() = Qdvdvff.bottomRightCorner(dimi_, dimi_);
   Qqf().setRandom();
+  Qff_sparsity_ = BlockSparsity::Dense;
+  Qqf_sparsity_ = BlockSparsity::Dense;
   Fqq_prev.setRandom();
 }
 
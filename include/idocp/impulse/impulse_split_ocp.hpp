@@ -18,6 +18,7 @@
 #include "idocp/impulse/impulse_state_equation.hpp"
 #include "idocp/impulse/impulse_dynamics.hpp"
 #include "idocp/ocp/split_direction.hpp"
+#include "idocp/riccati/iteration_level.hpp"
 
 
 namespace idocp {
@@ -82,6 +83,20 @@ public:
   ///
   void initConstraints(Robot& robot, const ImpulseSplitSolution& s);
 
+  ///
+  /// @brief Initializes the constraints, i.e., copies the slack and dual 
+  /// variables from the constraints data. 
+  /// @param[in] constraints_data Constraints data whose structure is 
+  /// consistent with this impulse stage.
+  ///
+  void initConstraints(const ConstraintsData& constraints_data);
+
+  ///
+  /// @brief Gets the const reference to the constraints data. 
+  /// @return const reference to the constraints data. 
+  ///
+  const ConstraintsData& getConstraintsData() const;
+
   ///
   /// @brief Computes the impulse stage cost and constraint violation.
   /// Used in the line search.
@@ -135,6 +150,32 @@ public:
                         ImpulseSplitKKTMatrix& kkt_matrix, 
                         ImpulseSplitKKTResidual& kkt_residual);
 
+  ///
+  /// @brief Computes the KKT system of this impuse stage of the specified  
+  /// level of the multi-level iteration. IterationLevel::Full is equivalent 
+  /// to ImpulseSplitOCP::computeKKTSystem(). Since the Riccati recursion 
+  /// reuses the factorization of the impulse stage at the other levels, 
+  /// IterationLevel::Jacobian and IterationLevel::Residual evaluate only the 
+  /// KKT residual and condense it with kkt_matrix and the condensing matrices 
+  /// of the last IterationLevel::Full. 
+  /// @param[in] robot Robot model. 
+  /// @param[in] impulse_status Impulse status of this impulse stage. 
+  /// @param[in] t Time of this impulse stage. 
+  /// @param[in] q_prev Configuration at the previous time stage.
+  /// @param[in] s Split solution of this impulse stage.
+  /// @param[in] s_next Split solution of the next time stage.
+  /// @param[in, out] kkt_matrix Split KKT matrix of this impulse stage.
+  /// @param[in, out] kkt_residual Split KKT residual of this impulse stage.
+  /// @param[in] level Level of the iteration. 
+  ///
+  void computeKKTSystem(Robot& robot, const ImpulseStatus& impulse_status, 
+                        const double t, const Eigen::VectorXd& q_prev, 
+                        const ImpulseSplitSolution& s, 
+                        const SplitSolution& s_next, 
+                        ImpulseSplitKKTMatrix& kkt_matrix, 
+                        ImpulseSplitKKTResidual& kkt_residual,
+                        const IterationLevel level);
+
   ///
   /// @brief Expands the condensed primal variables, i.e., computes the Newton 
   /// direction of the condensed primal variables of this impulse stage.
@@ -143,6 +184,41 @@ public:
   /// 
   void expandPrimal(const ImpulseSplitSolution& s, ImpulseSplitDirection& d);
 
+  ///
+  /// @brief Expands the condensed primal variables without the directions of
+  /// the slack and dual variables of the inequality constraints, e.g., for 
+  /// the second-order correction of the line search.
+  /// @param[in] s Split solution of this impulse stage.
+  /// @param[in, out] d Split direction of this impulse stage.
+  /// 
+  void expandPrimalWithoutSlackAndDual(const ImpulseSplitSolution& s, 
+                                       ImpulseSplitDirection& d) const;
+
+  ///
+  /// @brief Multiplies the inverse of the Lie derivative of the last 
+  /// linearization to the residual of the state equation computed by 
+  /// ImpulseSplitOCP::evalOCP(), so that the residual is consistent with the 
+  /// KKT matrix computed by ImpulseSplitOCP::computeKKTSystem().
+  /// @param[in, out] kkt_residual Impulse split KKT residual of this impulse 
+  /// stage.
+  /// 
+  void correctStateEquationResidual(ImpulseSplitKKTResidual& kkt_residual);
+
+  ///
+  /// @brief Condenses the residual of the impulse dynamics computed by 
+  /// ImpulseSplitOCP::evalOCP() by using the Jacobians of the last 
+  /// ImpulseSplitOCP::computeKKTSystem(). 
+  /// @param[in] robot Robot model. 
+  /// @param[in] impulse_status Impulse status of this impulse stage. 
+  /// @param[in] kkt_matrix Impulse split KKT matrix of this impulse stage.
+  /// @param[in, out] kkt_residual Impulse split KKT residual of this impulse 
+  /// stage.
+  /// 
+  void condenseImpulseDynamicsResidual(
+      Robot& robot, const ImpulseStatus& impulse_status, 
+      const ImpulseSplitKKTMatrix& kkt_matrix, 
+      ImpulseSplitKKTResidual& kkt_residual);
+
   ///
   /// @brief Expands the condensed dual variables, i.e., computes the Newton 
   /// direction of the condensed dual variables of this impulse stage.
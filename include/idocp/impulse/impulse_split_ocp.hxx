@@ -48,6 +48,17 @@ inline void ImpulseSplitOCP::initConstraints(Robot& robot,
 }
 
 
+inline void ImpulseSplitOCP::initConstraints(
+    const ConstraintsData& constraints_data) { 
+  constraints_data_.copySlackAndDual(constraints_data);
+}
+
+
+inline const ConstraintsData& ImpulseSplitOCP::getConstraintsData() const {
+  return constraints_data_;
+}
+
+
 inline void ImpulseSplitOCP::evalOCP(Robot& robot, 
                                      const ImpulseStatus& impulse_status, 
                                      const double t, 
@@ -101,6 +112,10 @@ inline void ImpulseSplitOCP::computeKKTSystem(
   kkt_matrix.setImpulseStatus(impulse_status);
   kkt_residual.setImpulseStatus(impulse_status);
   kkt_matrix.setZero();
+  kkt_matrix.setQffSparsity(joinBlockSparsity(cost_->QffSparsity(), 
+                                              constraints_->QffSparsity()));
+  kkt_matrix.setQqfSparsity(joinBlockSparsity(cost_->QqfSparsity(), 
+                                              constraints_->QqfSparsity()));
   kkt_residual.setZero();
   stage_cost_ = cost_->quadratizeImpulseCost(robot, cost_data_, t, s, 
                                              kkt_residual, kkt_matrix);
@@ -116,6 +131,35 @@ inline void ImpulseSplitOCP::computeKKTSystem(
 }
 
 
+inline void ImpulseSplitOCP::computeKKTSystem(
+    Robot& robot, const ImpulseStatus& impulse_status, const double t,  
+    const Eigen::VectorXd& q_prev, const ImpulseSplitSolution& s, 
+    const SplitSolution& s_next, ImpulseSplitKKTMatrix& kkt_matrix, 
+    ImpulseSplitKKTResidual& kkt_residual, const IterationLevel level) {
+  if (level == IterationLevel::Full) {
+    computeKKTSystem(robot, impulse_status, t, q_prev, s, s_next, 
+                     kkt_matrix, kkt_residual);
+    return;
+  }
+  assert(q_prev.size() == robot.dimq());
+  robot.updateKinematics(s.q, s.v+s.dv);
+  kkt_matrix.setImpulseStatus(impulse_status);
+  kkt_residual.setImpulseStatus(impulse_status);
+  kkt_residual.setZero();
+  stage_cost_ = cost_->linearizeImpulseCost(robot, cost_data_, t, s, 
+                                            kkt_residual);
+  constraints_->condenseSlackAndDual(robot, constraints_data_, s, 
+                                     kkt_residual);
+  stage_cost_ += constraints_data_.logBarrier();
+  state_equation_.linearizeStateEquationAlongLieGroup(robot, q_prev, s, s_next, 
+                                                      kkt_residual);
+  impulse_dynamics_.linearizeImpulseDynamics(robot, impulse_status, s, 
+                                             kkt_residual);
+  impulse_dynamics_.condenseImpulseDynamicsResidual(robot, impulse_status,
+                                                    kkt_matrix, kkt_residual);
+}
+
+
 inline void ImpulseSplitOCP::expandPrimal(const ImpulseSplitSolution& s, 
                                           ImpulseSplitDirection& d) {
   d.setImpulseStatusByDimension(s.dimi());
@@ -124,6 +168,28 @@ inline void ImpulseSplitOCP::expandPrimal(const ImpulseSplitSolution& s,
 }
 
 
+inline void ImpulseSplitOCP::expandPrimalWithoutSlackAndDual(
+    const ImpulseSplitSolution& s, ImpulseSplitDirection& d) const {
+  d.setImpulseStatusByDimension(s.dimi());
+  impulse_dynamics_.expandPrimal(d);
+}
+
+
+inline void ImpulseSplitOCP::correctStateEquationResidual(
+    ImpulseSplitKKTResidual& kkt_residual) {
+  state_equation_.correctStateEquationResidual(kkt_residual);
+}
+
+
+inline void ImpulseSplitOCP::condenseImpulseDynamicsResidual(
+    Robot& robot, const ImpulseStatus& impulse_status, 
+    const ImpulseSplitKKTMatrix& kkt_matrix, 
+    ImpulseSplitKKTResidual& kkt_residual) {
+  impulse_dynamics_.condenseImpulseDynamicsResidual(robot, impulse_status, 
+                                                    kkt_matrix, kkt_residual);
+}
+
+
 inline void ImpulseSplitOCP::expandDual(const SplitDirection& d_next, 
                                         ImpulseSplitDirection& d) {
   impulse_dynamics_.expandDual(d_next, d);
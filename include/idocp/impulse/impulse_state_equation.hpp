@@ -111,14 +111,43 @@ public:
       ImpulseSplitKKTMatrix& kkt_matrix, 
       ImpulseSplitKKTResidual& kkt_residual);
 
+  ///
+  /// @brief Linearizes the impulse state equation only into the KKT residual, 
+  /// e.g., at IterationLevel::Jacobian and IterationLevel::Residual of the 
+  /// multi-level iteration. The KKT matrix is not modified and 
+  /// ImpulseSplitKKTResidual::Fq is multiplied by the inverse of the Lie 
+  /// derivative of the last linearization with the KKT matrix. 
+  /// @param[in] robot Robot model. 
+  /// @param[in] q_prev Configuration at the previous time stage. 
+  /// @param[in] s Solution at the current impulse stage. 
+  /// @param[in] s_next Solution at the next time stage. 
+  /// @param[in, out] kkt_residual Impulse split KKT residual at the current 
+  /// impulse stage. 
+  ///
+  template <typename ConfigVectorType>
+  void linearizeStateEquationAlongLieGroup(
+      const Robot& robot, const Eigen::MatrixBase<ConfigVectorType>& q_prev, 
+      const ImpulseSplitSolution& s, const SplitSolution& s_next, 
+      ImpulseSplitKKTResidual& kkt_residual);
+
   ///
   /// @brief Corrects the costate direction using the derivatives of the Lie group. 
   /// @param[in, out] d Split direction. 
   ///
   void correctCostateDirection(ImpulseSplitDirection& d);
 
+  ///
+  /// @brief Multiplies the inverse of the Lie derivative of the last 
+  /// ImpulseStateEquation::linearizeStateEquationAlongLieGroup() to 
+  /// ImpulseSplitKKTResidual::Fq computed by 
+  /// ImpulseStateEquation::computeStateEquationResidual(), e.g., at a trial 
+  /// point of the line search. 
+  /// @param[in, out] kkt_residual Impulse split KKT residual. 
+  ///
+  void correctStateEquationResidual(ImpulseSplitKKTResidual& kkt_residual);
+
 private:
-  Eigen::MatrixXd Fqq_inv_, Fqq_prev_inv_, Fqq_tmp_;  
+  Eigen::MatrixXd Fqq_inv_, Fqq_prev_inv_, Fqq_tmp_, dsubtract_dq_;  
   Eigen::VectorXd Fq_tmp_;
   LieDerivativeInverter lie_der_inverter_;
   bool has_floating_base_;
@@ -11,6 +11,7 @@ inline ImpulseStateEquation::ImpulseStateEquation(const Robot& robot)
   : Fqq_inv_(),
     Fqq_prev_inv_(),
     Fqq_tmp_(),
+    dsubtract_dq_(),
     Fq_tmp_(),
     lie_der_inverter_(),
     has_floating_base_(robot.hasFloatingBase()) {
@@ -21,6 +22,8 @@ inline ImpulseStateEquation::ImpulseStateEquation(const Robot& robot)
     Fqq_prev_inv_.setZero();
     Fqq_tmp_.resize(6, 6);
     Fqq_tmp_.setZero();
+    dsubtract_dq_.resize(robot.dimv(), robot.dimv());
+    dsubtract_dq_.setZero();
     Fq_tmp_.resize(6);
     Fq_tmp_.setZero();
   }
@@ -31,6 +34,7 @@ inline ImpulseStateEquation::ImpulseStateEquation()
   : Fqq_inv_(),
     Fqq_prev_inv_(),
     Fqq_tmp_(),
+    dsubtract_dq_(),
     Fq_tmp_(),
     lie_der_inverter_(),
     has_floating_base_(false) {
@@ -101,6 +105,34 @@ inline void ImpulseStateEquation::linearizeStateEquationAlongLieGroup(
 }
 
 
+template <typename ConfigVectorType>
+inline void ImpulseStateEquation::linearizeStateEquationAlongLieGroup(
+    const Robot& robot, const Eigen::MatrixBase<ConfigVectorType>& q_prev, 
+    const ImpulseSplitSolution& s, const SplitSolution& s_next, 
+    ImpulseSplitKKTResidual& kkt_residual) {
+  assert(q_prev.size() == robot.dimq());
+  computeStateEquationResidual(robot, s, s_next.q, s_next.v, kkt_residual);
+  if (has_floating_base_) {
+    robot.dSubtractConfiguration_dqf(s.q, s_next.q, dsubtract_dq_);
+    kkt_residual.lq().template head<6>().noalias() 
+        += dsubtract_dq_.template topLeftCorner<6, 6>().transpose() 
+              * s_next.lmd.template head<6>();
+    robot.dSubtractConfiguration_dq0(q_prev, s.q, dsubtract_dq_);
+    kkt_residual.lq().template head<6>().noalias() 
+        += dsubtract_dq_.template topLeftCorner<6, 6>().transpose() 
+              * s.lmd.template head<6>();
+    kkt_residual.lq().tail(robot.dimv()-6).noalias() 
+        += s_next.lmd.tail(robot.dimv()-6) - s.lmd.tail(robot.dimv()-6);
+    correctStateEquationResidual(kkt_residual);
+  }
+  else {
+    kkt_residual.lq().noalias() += s_next.lmd - s.lmd;
+  }
+  kkt_residual.lv().noalias() += s_next.gmm - s.gmm;
+  kkt_residual.ldv.noalias() += s_next.gmm;
+}
+
+
 inline void ImpulseStateEquation::correctCostateDirection(
     ImpulseSplitDirection& d) {
   if (has_floating_base_) {
@@ -109,6 +141,15 @@ inline void ImpulseStateEquation::correctCostateDirection(
   }
 }
 
+
+inline void ImpulseStateEquation::correctStateEquationResidual(
+    ImpulseSplitKKTResidual& kkt_residual) {
+  if (has_floating_base_) {
+    Fq_tmp_ = kkt_residual.Fq().template head<6>();
+    kkt_residual.Fq().template head<6>().noalias() = - Fqq_inv_ * Fq_tmp_;
+  }
+}
+
 } // namespace idocp 
 
 #endif // IDOCP_IMPULSE_STATE_EQUATION_HXX_
\ No newline at end of file
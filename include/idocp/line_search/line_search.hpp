@@ -1,6 +1,8 @@
 #ifndef IDOCP_LINE_SEARCH_HPP_
 #define IDOCP_LINE_SEARCH_HPP_
 
+#include <iostream>
+
 #include "Eigen/Core"
 
 #include "idocp/robot/robot.hpp"
@@ -11,7 +13,9 @@
 #include "idocp/ocp/ocp.hpp"
 #include "idocp/ocp/solution.hpp"
 #include "idocp/ocp/direction.hpp"
+#include "idocp/ocp/kkt_matrix.hpp"
 #include "idocp/ocp/kkt_residual.hpp"
+#include "idocp/riccati/riccati_recursion.hpp"
 #include "idocp/line_search/line_search_filter.hpp"
 
 
@@ -86,6 +90,66 @@ public:
                          const Solution& s, const Direction& d,
                          const double max_primal_step_size);
 
+  ///
+  /// @brief Compute primal step size by fliter line search method with the 
+  /// second-order correction. If the full step, i.e., max_primal_step_size, 
+  /// is rejected by the filter, the residuals of the state equations and the 
+  /// switching constraints at the rejected trial point are solved by the 
+  /// Riccati factorization of the last Newton iteration without 
+  /// refactorizing the KKT matrix, and the corrected step is tested before 
+  /// the backtracking. If the corrected step is accepted, the primal 
+  /// direction d is replaced with the corrected one. The directions of the 
+  /// costates and the slack and dual variables are not corrected, and the 
+  /// residuals of the contact dynamics are not included in the correction. 
+  /// Equivalent to the above if the second-order correction is disabled. 
+  /// @param[in, out] ocp optimal control problem.
+  /// @param[in] robots aligned_vector of Robot.
+  /// @param[in] contact_sequence Contact sequence. 
+  /// @param[in] q Initial configuration.
+  /// @param[in] v Initial generalized velocity.
+  /// @param[in] s Solution. 
+  /// @param[in, out] d Direction. 
+  /// @param[in] max_primal_step_size Maximum primal step size. 
+  /// @param[in, out] riccati_recursion Riccati recursion that computed d. 
+  /// @param[in, out] kkt_matrix KKT matrix factorized by riccati_recursion. 
+  /// Not modified.
+  /// @param[in, out] factorization Riccati factorization of 
+  /// riccati_recursion. The vectors are overwritten.
+  ///
+  double computeStepSize(OCP& ocp, aligned_vector<Robot>& robots,
+                         const ContactSequence& contact_sequence, 
+                         const Eigen::VectorXd& q, const Eigen::VectorXd& v, 
+                         const Solution& s, Direction& d,
+                         const double max_primal_step_size, 
+                         RiccatiRecursion& riccati_recursion, 
+                         KKTMatrix& kkt_matrix, 
+                         RiccatiFactorization& factorization);
+
+  ///
+  /// @brief Enables or disables the second-order correction. 
+  /// @param[in] second_order_correction If true, the second-order correction
+  /// is enabled. Default is false.
+  ///
+  void setSecondOrderCorrection(const bool second_order_correction);
+
+  ///
+  /// @return true if the second-order correction is enabled. false if not.
+  ///
+  bool secondOrderCorrection() const;
+
+  ///
+  /// @return true if the second-order correction was computed in the last 
+  /// call of computeStepSize(). false if not.
+  ///
+  bool isSecondOrderCorrectionComputed() const;
+
+  ///
+  /// @brief Returns the direction corrected by the last second-order 
+  /// correction. Only the primal directions are corrected. 
+  /// @return Const reference to the corrected direction.
+  ///
+  const Direction& correctedDirection() const;
+
   ///
   /// @brief Clear the line search filter. 
   ///
@@ -97,15 +161,45 @@ public:
   ///
   bool isFilterEmpty() const;
 
+  ///
+  /// @brief Writes the line search filter to the binary stream. 
+  /// @param[in, out] os Output binary stream.
+  ///
+  void saveFilter(std::ostream& os) const;
+
+  ///
+  /// @brief Reads the line search filter from the binary stream. Throws 
+  /// std::runtime_error if the stream is broken.
+  /// @param[in, out] is Input binary stream.
+  ///
+  void loadFilter(std::istream& is);
+
 private:
   LineSearchFilter filter_;
   int max_num_impulse_, nthreads_;
   double step_size_reduction_rate_, min_step_size_;
+  bool second_order_correction_, is_second_order_correction_computed_;
   Eigen::VectorXd costs_, costs_impulse_, costs_aux_, costs_lift_, violations_, 
                   violations_impulse_, violations_aux_, violations_lift_; 
   Solution s_trial_;
+  Direction d_soc_;
   KKTResidual kkt_residual_;
 
+  bool isTrialAccepted(OCP& ocp, aligned_vector<Robot>& robots,
+                       const ContactSequence& contact_sequence, 
+                       const Eigen::VectorXd& q, const Eigen::VectorXd& v, 
+                       const Solution& s, const Direction& d, 
+                       const double primal_step_size);
+
+  bool correctSecondOrder(OCP& ocp, aligned_vector<Robot>& robots,
+                          const ContactSequence& contact_sequence, 
+                          const Eigen::VectorXd& q, const Eigen::VectorXd& v, 
+                          const Solution& s, Direction& d,
+                          const double primal_step_size, 
+                          RiccatiRecursion& riccati_recursion, 
+                          KKTMatrix& kkt_matrix, 
+                          RiccatiFactorization& factorization);
+
   void computeCostAndViolation(OCP& ocp, aligned_vector<Robot>& robots,
                                const ContactSequence& contact_sequence, 
                                const Eigen::VectorXd& q, 
@@ -131,6 +225,38 @@ private:
     }
   }
 
+  static void correctPrimalDirection(const SplitDirection& d, 
+                                     const double step_size_inv, 
+                                     SplitDirection& d_soc) {
+    assert(d_soc.dimf() == d.dimf());
+    d_soc.dx = d.dx + step_size_inv * d_soc.dx;
+    d_soc.du = d.du + step_size_inv * d_soc.du;
+    d_soc.daf() = d.daf() + step_size_inv * d_soc.daf();
+  }
+
+  static void correctPrimalDirection(const ImpulseSplitDirection& d, 
+                                     const double step_size_inv, 
+                                     ImpulseSplitDirection& d_soc) {
+    assert(d_soc.dimi() == d.dimi());
+    d_soc.dx = d.dx + step_size_inv * d_soc.dx;
+    d_soc.ddvf() = d.ddvf() + step_size_inv * d_soc.ddvf();
+  }
+
+  static void copyPrimalDirection(const SplitDirection& d_soc, 
+                                  SplitDirection& d) {
+    d.dx = d_soc.dx;
+    d.du = d_soc.du;
+    d.setContactStatusByDimension(d_soc.dimf());
+    d.daf() = d_soc.daf();
+  }
+
+  static void copyPrimalDirection(const ImpulseSplitDirection& d_soc, 
+                                  ImpulseSplitDirection& d) {
+    d.dx = d_soc.dx;
+    d.setImpulseStatusByDimension(d_soc.dimi());
+    d.ddvf() = d_soc.ddvf();
+  }
+
   static void computeSolutionTrial(const Robot& robot, 
                                    const ImpulseSplitSolution& s, 
                                    const ImpulseSplitDirection& d, 
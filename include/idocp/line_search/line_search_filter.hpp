@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <utility>
+#include <iostream>
 
 
 namespace idocp {
@@ -74,6 +75,19 @@ public:
   ///
   bool isEmpty() const;
 
+  ///
+  /// @brief Writes the pairs in the filter to the binary stream. 
+  /// @param[in, out] os Output binary stream.
+  ///
+  void save(std::ostream& os) const;
+
+  ///
+  /// @brief Reads the pairs in the filter from the binary stream. Throws 
+  /// std::runtime_error if the stream is broken.
+  /// @param[in, out] is Input binary stream.
+  ///
+  void load(std::istream& is);
+
 private:
   std::vector<std::pair<double, double>> filter_;
   double cost_reduction_rate_, constraints_reduction_rate_;
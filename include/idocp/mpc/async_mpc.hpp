@@ -0,0 +1,176 @@
+#ifndef IDOCP_ASYNC_MPC_HPP_
+#define IDOCP_ASYNC_MPC_HPP_
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/solver/control_policy.hpp"
+#include "idocp/utils/triple_buffer.hpp"
+#include "idocp/utils/real_time_profile.hpp"
+
+
+namespace idocp {
+
+///
+/// @class AsyncMPC
+/// @brief Runs an MPC on a background thread. The latest state is passed by
+/// AsyncMPC::setState() and the latest control policy is obtained by
+/// AsyncMPC::getControlPolicy() without waiting for the solver. The policy is
+/// handed over by a wait-free triple buffer, so the control thread never
+/// blocks on the solver thread. If the MPC throws an exception on the 
+/// background thread, the thread stops and the exception is rethrown in the
+/// caller thread by AsyncMPC::rethrowIfFailed().
+/// @tparam MPCType The type of the MPC, e.g., MPCQuadrupedalTrotting. Must
+/// have updateSolution(t, q, v, num_iteration), getControlPolicy(policy), and
+/// applyRealTimeProfile(profile, t, q, v).
+///
+template <typename MPCType>
+class AsyncMPC {
+public:
+  ///
+  /// @brief Construct the asynchronous MPC.
+  /// @param[in] mpc The MPC. Must be initialized, e.g., by MPCType::init(),
+  /// before calling AsyncMPC::start(). Must outlive this object.
+  /// @param[in] robot Robot model. Used to allocate the control policy.
+  /// @param[in] num_iteration Number of the iterations of the MPC per each
+  /// state. Must be positive. Default is 1.
+  /// @param[in] num_stages Number of the time stages of the trajectory in
+  /// the control policy. Must be positive and not larger than N of the MPC.
+  /// Default is 1.
+  ///
+  AsyncMPC(MPCType& mpc, const Robot& robot, const int num_iteration=1,
+           const int num_stages=1);
+
+  ///
+  /// @brief Destructor. Stops the background thread.
+  ///
+  ~AsyncMPC();
+
+  ///
+  /// @brief Copy is not allowed because this object owns a thread.
+  ///
+  AsyncMPC(const AsyncMPC&) = delete;
+
+  ///
+  /// @brief Copy is not allowed because this object owns a thread.
+  ///
+  AsyncMPC& operator=(const AsyncMPC&) = delete;
+
+  ///
+  /// @brief Move is not allowed because the background thread refers to
+  /// this object.
+  ///
+  AsyncMPC(AsyncMPC&&) = delete;
+
+  ///
+  /// @brief Move is not allowed because the background thread refers to
+  /// this object.
+  ///
+  AsyncMPC& operator=(AsyncMPC&&) = delete;
+
+  ///
+  /// @brief Sets the real-time execution profile. The profile is applied on
+  /// the background thread by MPCType::applyRealTimeProfile() with the first
+  /// state after AsyncMPC::start(), before the first solve. Must be called
+  /// before AsyncMPC::start().
+  /// @param[in] profile Real-time execution profile.
+  ///
+  void setRealTimeProfile(const RealTimeProfile& profile);
+
+  ///
+  /// @brief Starts the background thread. Does nothing if it is already
+  /// running. Discards the exception of the previous run that has not been 
+  /// rethrown by AsyncMPC::rethrowIfFailed().
+  ///
+  void start();
+
+  ///
+  /// @brief Stops the background thread after the current solve. Does
+  /// nothing if it is not running.
+  ///
+  void stop();
+
+  ///
+  /// @return true if the background thread is running. false if not, e.g., 
+  /// it has been stopped or has failed.
+  ///
+  bool isRunning() const;
+
+  ///
+  /// @return true if the background thread has stopped because the MPC threw
+  /// an exception that has not been rethrown yet. false if not.
+  ///
+  bool hasFailed() const;
+
+  ///
+  /// @brief Rethrows the exception thrown by the MPC on the background 
+  /// thread in the caller thread, e.g., in the control loop. Does nothing if 
+  /// the background thread has not failed. The exception is cleared after 
+  /// rethrowing. 
+  ///
+  void rethrowIfFailed();
+
+  ///
+  /// @brief Sets the latest state. The background thread solves the MPC with
+  /// the latest state after the current solve. The states set during the
+  /// solve except for the latest one are discarded.
+  /// @param[in] t Current time.
+  /// @param[in] q Current configuration.
+  /// @param[in] v Current velocity.
+  ///
+  void setState(const double t, const Eigen::VectorXd& q,
+                const Eigen::VectorXd& v);
+
+  ///
+  /// @brief Gets the control policy computed with the latest solve. Never
+  /// waits for the solver and never allocates memory. Must be called only
+  /// from a single control thread.
+  /// @return Const reference to the latest control policy. Valid until the
+  /// next call of AsyncMPC::getControlPolicy() or 
+  /// AsyncMPC::getControlInput(). All zero if the MPC has not been solved yet.
+  ///
+  const ControlPolicy& getControlPolicy();
+
+  ///
+  /// @brief Gets the control input computed with the latest solve. Never
+  /// waits for the solver. Must be called only from a single control thread.
+  /// @return Const reference to the latest control input. Zero if the MPC has
+  /// not been solved yet.
+  ///
+  const Eigen::VectorXd& getControlInput();
+
+  ///
+  /// @return Number of the solves since the construction.
+  ///
+  int numSolves() const;
+
+private:
+  MPCType* mpc_;
+  int num_iteration_;
+  std::atomic<int> num_solves_;
+  double t_;
+  Eigen::VectorXd q_, v_;
+  bool has_new_state_, is_running_, stop_requested_;
+  TripleBuffer<ControlPolicy> policy_;
+  RealTimeProfile profile_;
+  bool has_profile_;
+  std::thread thread_;
+  mutable std::mutex state_mtx_;
+  std::condition_variable state_cv_;
+  std::exception_ptr error_;
+
+  void run();
+
+};
+
+} // namespace idocp
+
+#include "idocp/mpc/async_mpc.hxx"
+
+#endif // IDOCP_ASYNC_MPC_HPP_
\ No newline at end of file
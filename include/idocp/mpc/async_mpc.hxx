@@ -0,0 +1,196 @@
+#ifndef IDOCP_ASYNC_MPC_HXX_
+#define IDOCP_ASYNC_MPC_HXX_
+
+#include "idocp/mpc/async_mpc.hpp"
+
+#include <stdexcept>
+#include <iostream>
+#include <cstdlib>
+
+
+namespace idocp {
+
+template <typename MPCType>
+inline AsyncMPC<MPCType>::AsyncMPC(MPCType& mpc, const Robot& robot, 
+                                   const int num_iteration, 
+                                   const int num_stages)
+  : mpc_(&mpc),
+    num_iteration_(num_iteration),
+    num_solves_(0),
+    t_(0),
+    q_(Eigen::VectorXd::Zero(robot.dimq())),
+    v_(Eigen::VectorXd::Zero(robot.dimv())),
+    has_new_state_(false),
+    is_running_(false),
+    stop_requested_(false),
+    policy_(ControlPolicy(robot, (num_stages > 0 ? num_stages : 1))),
+    profile_(),
+    has_profile_(false),
+    thread_(),
+    state_mtx_(),
+    state_cv_(),
+    error_() {
+  try {
+    if (num_iteration <= 0) {
+      throw std::out_of_range("invalid value: num_iteration must be positive!");
+    }
+    if (num_stages <= 0) {
+      throw std::out_of_range("invalid value: num_stages must be positive!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+
+template <typename MPCType>
+inline AsyncMPC<MPCType>::~AsyncMPC() {
+  stop();
+}
+
+
+template <typename MPCType>
+inline void AsyncMPC<MPCType>::setRealTimeProfile(
+    const RealTimeProfile& profile) {
+  std::lock_guard<std::mutex> lock(state_mtx_);
+  profile_ = profile;
+  has_profile_ = true;
+}
+
+
+template <typename MPCType>
+inline void AsyncMPC<MPCType>::start() {
+  std::lock_guard<std::mutex> lock(state_mtx_);
+  if (is_running_) return;
+  // Joins the thread that has exited by a failure.
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  error_ = nullptr;
+  stop_requested_ = false;
+  is_running_ = true;
+  thread_ = std::thread(&AsyncMPC::run, this);
+}
+
+
+template <typename MPCType>
+inline void AsyncMPC<MPCType>::stop() {
+  {
+    std::lock_guard<std::mutex> lock(state_mtx_);
+    if (!is_running_ && !thread_.joinable()) return;
+    stop_requested_ = true;
+  }
+  state_cv_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  std::lock_guard<std::mutex> lock(state_mtx_);
+  is_running_ = false;
+}
+
+
+template <typename MPCType>
+inline bool AsyncMPC<MPCType>::isRunning() const {
+  std::lock_guard<std::mutex> lock(state_mtx_);
+  return is_running_;
+}
+
+
+template <typename MPCType>
+inline bool AsyncMPC<MPCType>::hasFailed() const {
+  std::lock_guard<std::mutex> lock(state_mtx_);
+  return static_cast<bool>(error_);
+}
+
+
+template <typename MPCType>
+inline void AsyncMPC<MPCType>::rethrowIfFailed() {
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(state_mtx_);
+    error = error_;
+    error_ = nullptr;
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+
+template <typename MPCType>
+inline void AsyncMPC<MPCType>::setState(const double t,
+                                        const Eigen::VectorXd& q,
+                                        const Eigen::VectorXd& v) {
+  {
+    std::lock_guard<std::mutex> lock(state_mtx_);
+    t_ = t;
+    q_ = q;
+    v_ = v;
+    has_new_state_ = true;
+  }
+  state_cv_.notify_one();
+}
+
+
+template <typename MPCType>
+inline const ControlPolicy& AsyncMPC<MPCType>::getControlPolicy() {
+  policy_.update();
+  return policy_.readBuffer();
+}
+
+
+template <typename MPCType>
+inline const Eigen::VectorXd& AsyncMPC<MPCType>::getControlInput() {
+  return getControlPolicy().u;
+}
+
+
+template <typename MPCType>
+inline int AsyncMPC<MPCType>::numSolves() const {
+  return num_solves_.load(std::memory_order_relaxed);
+}
+
+
+template <typename MPCType>
+inline void AsyncMPC<MPCType>::run() {
+  double t;
+  Eigen::VectorXd q(q_.size()), v(v_.size());
+  bool apply_profile = false;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(state_mtx_);
+      state_cv_.wait(lock, [this] { return has_new_state_ || stop_requested_; });
+      if (stop_requested_) return;
+      t = t_;
+      q = q_;
+      v = v_;
+      has_new_state_ = false;
+      apply_profile = has_profile_;
+      has_profile_ = false;
+    }
+    try {
+      if (apply_profile) {
+        // Applied on this thread since the solver runs on this thread.
+        mpc_->applyRealTimeProfile(profile_, t, q, v);
+      }
+      mpc_->updateSolution(t, q, v, num_iteration_);
+      mpc_->getControlPolicy(policy_.writeBuffer());
+    }
+    catch(...) {
+      // An exception escaping the thread would call std::terminate(). The 
+      // last published policy is kept.
+      std::lock_guard<std::mutex> lock(state_mtx_);
+      error_ = std::current_exception();
+      is_running_ = false;
+      return;
+    }
+    policy_.publish();
+    num_solves_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+} // namespace idocp
+
+#endif // IDOCP_ASYNC_MPC_HXX_
\ No newline at end of file
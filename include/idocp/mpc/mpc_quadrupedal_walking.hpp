@@ -3,12 +3,14 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 #include <limits>
 
 #include "Eigen/Core"
 
 #include "idocp/robot/robot.hpp"
 #include "idocp/solver/ocp_solver.hpp"
+#include "idocp/utils/real_time_profile.hpp"
 #include "idocp/cost/cost_function.hpp"
 #include "idocp/constraints/constraints.hpp"
 
@@ -79,6 +81,22 @@ public:
   void setGaitPattern(const double step_length, const double step_height,
                       const double swing_time, const double t0);
 
+  ///
+  /// @brief Sets the step sizes of the discretization grids. See 
+  /// OCPSolver::setDiscretizationGrid() for details. The swing time should be
+  /// larger than the largest step size so that each grid contains at most 
+  /// one discrete event.
+  /// @param[in] dt Step sizes of the N grids. 
+  ///
+  void setDiscretizationGrid(const std::vector<double>& dt);
+
+  ///
+  /// @brief Sets geometrically growing step sizes of the discretization 
+  /// grids. See OCPSolver::setGeometricDiscretizationGrid() for details. 
+  /// @param[in] ratio Ratio of the step sizes of the neighbouring grids. 
+  ///
+  void setGeometricDiscretizationGrid(const double ratio);
+
   ///
   /// @brief Initializes the optimal control problem solover. 
   /// @param[in] t Initial time of the horizon. 
@@ -107,6 +125,14 @@ public:
   ///
   const Eigen::VectorXd& getInitialControlInput() const;
 
+  ///
+  /// @brief Gets the control policy, i.e., the control input and the 
+  /// state-feedback gain at the initial stage and the short trajectory of the 
+  /// solution. 
+  /// @param[out] policy The control policy. 
+  ///
+  void getControlPolicy(ControlPolicy& policy) const;
+
   ///
   /// @brief Computes the KKT residual of the optimal control problem. 
   /// @param[in] t Initial time of the horizon. 
@@ -129,6 +155,34 @@ public:
   ///
   void showInfo() const;
 
+  ///
+  /// @brief Starts recording the inputs of the internal OCPSolver, i.e., 
+  /// every call that modifies the solver including those made by this MPC, 
+  /// to a binary trace. See OCPSolver::startRecording() for details. 
+  /// @param[in] file_name Name of the binary trace.
+  /// @param[in] t Initial time of the horizon.
+  /// @return true if the recording is started successfully. false if not.
+  ///
+  bool startRecording(const std::string& file_name, const double t);
+
+  ///
+  /// @brief Stops recording and closes the trace.
+  ///
+  void stopRecording();
+
+  ///
+  /// @brief Applies the real-time execution profile to the internal 
+  /// OCPSolver. See OCPSolver::applyRealTimeProfile() for details. Must be 
+  /// called from the thread that calls MPCQuadrupedalWalking::updateSolution().
+  /// @param[in] profile Real-time execution profile.
+  /// @param[in] t Initial time of the horizon used in the pre-fault. 
+  /// @param[in] q Initial configuration used in the pre-fault. 
+  /// @param[in] v Initial velocity used in the pre-fault. 
+  /// @return true if all the settings are applied. false if not.
+  ///
+  bool applyRealTimeProfile(const RealTimeProfile& profile, const double t, 
+                            const Eigen::VectorXd& q, const Eigen::VectorXd& v);
+
   static constexpr double min_dt 
       = std::sqrt(std::numeric_limits<double>::epsilon());
 
@@ -0,0 +1,34 @@
+#ifndef IDOCP_BLOCK_SPARSITY_HPP_
+#define IDOCP_BLOCK_SPARSITY_HPP_
+
+
+namespace idocp {
+
+///
+/// @enum BlockSparsity
+/// @brief Sparsity pattern of a block of the KKT matrix. The blocks whose
+/// pattern is known to be zero or diagonal are skipped or treated as diagonal
+/// in the condensing of the KKT system. The patterns are ordered so that
+/// a larger value has more nonzero entries.
+///
+enum class BlockSparsity {
+  Zero = 0,
+  Diagonal = 1,
+  Dense = 2
+};
+
+///
+/// @brief Joins two sparsity patterns, i.e., returns the sparsity pattern of
+/// the sum of the two blocks.
+/// @param[in] lhs A sparsity pattern.
+/// @param[in] rhs A sparsity pattern.
+/// @return The sparsity pattern that covers both lhs and rhs.
+///
+inline BlockSparsity joinBlockSparsity(const BlockSparsity lhs,
+                                       const BlockSparsity rhs) {
+  return (static_cast<int>(lhs) >= static_cast<int>(rhs)) ? lhs : rhs;
+}
+
+} // namespace idocp
+
+#endif // IDOCP_BLOCK_SPARSITY_HPP_
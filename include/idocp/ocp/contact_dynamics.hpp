@@ -96,6 +96,24 @@ public:
                                const double dt, SplitKKTMatrix& kkt_matrix, 
                                SplitKKTResidual& kkt_residual);
 
+  ///
+  /// @brief Condenses the acceleration, contact forces, and Lagrange
+  /// multipliers only into the KKT residual, reusing the condensing matrices 
+  /// and the Hessians of the last ContactDynamics::condenseContactDynamics(), 
+  /// e.g., at IterationLevel::Residual of the multi-level iteration. 
+  /// @param[in] robot Robot model. 
+  /// @param[in] contact_status Contact status of this time stage. 
+  /// @param[in] dt Time step of this time stage. 
+  /// @param[in] kkt_matrix Split KKT matrix of this time stage condensed by 
+  /// the last ContactDynamics::condenseContactDynamics().
+  /// @param[in, out] kkt_residual Split KKT residual of this time stage.
+  ///
+  void condenseContactDynamicsResidual(Robot& robot, 
+                                       const ContactStatus& contact_status, 
+                                       const double dt, 
+                                       const SplitKKTMatrix& kkt_matrix, 
+                                       SplitKKTResidual& kkt_residual);
+
   ///
   /// @brief Expands the primal variables, i.e., computes the Newton direction 
   /// of the condensed primal variables (acceleration a and the contact forces 
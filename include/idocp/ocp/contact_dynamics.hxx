@@ -90,50 +90,87 @@ inline void ContactDynamics::condenseContactDynamics(
   data_.MJtJinv_dIDCdqv().noalias() = data_.MJtJinv() * data_.dIDCdqv();
   data_.MJtJinv_IDC().noalias()     = data_.MJtJinv() * data_.IDC();
 
+  // Qff and Qqf are skipped or treated as diagonal based on their sparsity 
+  // patterns set by the costs and constraints. 
+  const BlockSparsity Qff_sparsity = kkt_matrix.QffSparsity();
+  const bool has_Qqf = (kkt_matrix.QqfSparsity() != BlockSparsity::Zero);
+  assert(Qff_sparsity != BlockSparsity::Zero || kkt_matrix.Qff().isZero());
+  assert(Qff_sparsity != BlockSparsity::Diagonal 
+          || kkt_matrix.Qff().isDiagonal());
+  assert(has_Qqf || kkt_matrix.Qqf().isZero());
   data_.Qafqv().topRows(dimv).noalias() 
       = (- kkt_matrix.Qaa.diagonal()).asDiagonal() 
           * data_.MJtJinv_dIDCdqv().topRows(dimv);
-  data_.Qafqv().bottomRows(dimf).noalias() 
-      = - kkt_matrix.Qff() * data_.MJtJinv_dIDCdqv().bottomRows(dimf);
-  data_.Qafqv().bottomLeftCorner(dimf, dimv).noalias()
-      -= kkt_matrix.Qqf().transpose();
   data_.Qafu_full().topRows(dimv).noalias() 
       = kkt_matrix.Qaa.diagonal().asDiagonal() 
           * data_.MJtJinv().topLeftCorner(dimv, dimv);
-  data_.Qafu_full().bottomRows(dimf).noalias() 
-      = kkt_matrix.Qff() * data_.MJtJinv().bottomLeftCorner(dimf, dimv);
   data_.la() = kkt_residual.la;
   data_.lf() = - kkt_residual.lf();
   data_.la().noalias() 
       -= kkt_matrix.Qaa.diagonal().asDiagonal() 
           * data_.MJtJinv_IDC().head(dimv);
-  data_.lf().noalias() 
-      -= kkt_matrix.Qff() * data_.MJtJinv_IDC().tail(dimf);
+  switch (Qff_sparsity) {
+    case BlockSparsity::Zero:
+      data_.Qafqv().bottomRows(dimf).setZero();
+      data_.Qafu_full().bottomRows(dimf).setZero();
+      break;
+    case BlockSparsity::Diagonal:
+      data_.Qafqv().bottomRows(dimf).noalias() 
+          = (- kkt_matrix.Qff().diagonal()).asDiagonal() 
+              * data_.MJtJinv_dIDCdqv().bottomRows(dimf);
+      data_.Qafu_full().bottomRows(dimf).noalias() 
+          = kkt_matrix.Qff().diagonal().asDiagonal() 
+              * data_.MJtJinv().bottomLeftCorner(dimf, dimv);
+      data_.lf().noalias() 
+          -= kkt_matrix.Qff().diagonal().asDiagonal() 
+              * data_.MJtJinv_IDC().tail(dimf);
+      break;
+    default:
+      data_.Qafqv().bottomRows(dimf).noalias() 
+          = - kkt_matrix.Qff() * data_.MJtJinv_dIDCdqv().bottomRows(dimf);
+      data_.Qafu_full().bottomRows(dimf).noalias() 
+          = kkt_matrix.Qff() * data_.MJtJinv().bottomLeftCorner(dimf, dimv);
+      data_.lf().noalias() 
+          -= kkt_matrix.Qff() * data_.MJtJinv_IDC().tail(dimf);
+      break;
+  }
+  if (has_Qqf) {
+    data_.Qafqv().bottomLeftCorner(dimf, dimv).noalias()
+        -= kkt_matrix.Qqf().transpose();
+  }
 
   kkt_matrix.Qxx.noalias() 
       -= data_.MJtJinv_dIDCdqv().transpose() * data_.Qafqv();
-  kkt_matrix.Qxx.topRows(dimv).noalias() 
-      += kkt_matrix.Qqf() * data_.MJtJinv_dIDCdqv().bottomRows(dimf);
+  if (has_Qqf) {
+    kkt_matrix.Qxx.topRows(dimv).noalias() 
+        += kkt_matrix.Qqf() * data_.MJtJinv_dIDCdqv().bottomRows(dimf);
+  }
   if (has_floating_base_) {
     data_.Qxu_passive.noalias() 
         = - data_.MJtJinv_dIDCdqv().transpose() * data_.Qafu_full().leftCols(dim_passive);
-    data_.Qxu_passive.topRows(dimv).noalias()
-        -= kkt_matrix.Qqf() * data_.MJtJinv().bottomLeftCorner(dimf, dimv).leftCols(dim_passive);
     kkt_matrix.Qxu.noalias() 
         -= data_.MJtJinv_dIDCdqv().transpose() * data_.Qafu_full().rightCols(dimu);
-    kkt_matrix.Qxu.topRows(dimv).noalias()
-        -= kkt_matrix.Qqf() * data_.MJtJinv().bottomLeftCorner(dimf, dimv).rightCols(dimu);
+    if (has_Qqf) {
+      data_.Qxu_passive.topRows(dimv).noalias()
+          -= kkt_matrix.Qqf() * data_.MJtJinv().bottomLeftCorner(dimf, dimv).leftCols(dim_passive);
+      kkt_matrix.Qxu.topRows(dimv).noalias()
+          -= kkt_matrix.Qqf() * data_.MJtJinv().bottomLeftCorner(dimf, dimv).rightCols(dimu);
+    }
   }
   else {
     kkt_matrix.Qxu.noalias() 
         -= data_.MJtJinv_dIDCdqv().transpose() * data_.Qafu_full();
-    kkt_matrix.Qxu.topRows(dimv).noalias()
-        -= kkt_matrix.Qqf() * data_.MJtJinv().bottomLeftCorner(dimf, dimv);
+    if (has_Qqf) {
+      kkt_matrix.Qxu.topRows(dimv).noalias()
+          -= kkt_matrix.Qqf() * data_.MJtJinv().bottomLeftCorner(dimf, dimv);
+    }
   }
   kkt_residual.lx.noalias() 
       -= data_.MJtJinv_dIDCdqv().transpose() * data_.laf();
-  kkt_residual.lq().noalias()
-      += kkt_matrix.Qqf() * data_.MJtJinv_IDC().tail(dimf);
+  if (has_Qqf) {
+    kkt_residual.lq().noalias()
+        += kkt_matrix.Qqf() * data_.MJtJinv_IDC().tail(dimf);
+  }
 
   if (has_floating_base_) {
     data_.Quu_passive_topRight.noalias() 
@@ -161,6 +198,51 @@ inline void ContactDynamics::condenseContactDynamics(
 }
 
 
+inline void ContactDynamics::condenseContactDynamicsResidual(
+    Robot& robot, const ContactStatus& contact_status, const double dt,
+    const SplitKKTMatrix& kkt_matrix, SplitKKTResidual& kkt_residual) {
+  assert(dt > 0);
+  const int dimv = robot.dimv();
+  const int dimu = robot.dimu();
+  const int dim_passive = robot.dim_passive();
+  const int dimf = contact_status.dimf();
+  data_.MJtJinv_IDC().noalias() = data_.MJtJinv() * data_.IDC();
+  const BlockSparsity Qff_sparsity = kkt_matrix.QffSparsity();
+  const bool has_Qqf = (kkt_matrix.QqfSparsity() != BlockSparsity::Zero);
+  data_.la() = kkt_residual.la;
+  data_.lf() = - kkt_residual.lf();
+  data_.la().noalias() 
+      -= kkt_matrix.Qaa.diagonal().asDiagonal() 
+          * data_.MJtJinv_IDC().head(dimv);
+  switch (Qff_sparsity) {
+    case BlockSparsity::Zero:
+      break;
+    case BlockSparsity::Diagonal:
+      data_.lf().noalias() 
+          -= kkt_matrix.Qff().diagonal().asDiagonal() 
+              * data_.MJtJinv_IDC().tail(dimf);
+      break;
+    default:
+      data_.lf().noalias() 
+          -= kkt_matrix.Qff() * data_.MJtJinv_IDC().tail(dimf);
+      break;
+  }
+  kkt_residual.lx.noalias() 
+      -= data_.MJtJinv_dIDCdqv().transpose() * data_.laf();
+  if (has_Qqf) {
+    kkt_residual.lq().noalias()
+        += kkt_matrix.Qqf() * data_.MJtJinv_IDC().tail(dimf);
+  }
+  if (has_floating_base_) {
+    data_.lu_passive.noalias() 
+        += data_.MJtJinv().template topRows<kDimFloatingBase>() * data_.laf();
+  }
+  kkt_residual.lu.noalias() 
+      += data_.MJtJinv().middleRows(dim_passive, dimu) * data_.laf();
+  kkt_residual.Fv().noalias() -= dt * data_.MJtJinv_IDC().head(dimv);
+}
+
+
 inline void ContactDynamics::expandPrimal(SplitDirection& d) const {
   d.daf().noalias() = - data_.MJtJinv_dIDCdqv() * d.dx;
   d.daf().noalias() 
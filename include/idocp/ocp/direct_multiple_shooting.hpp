@@ -14,6 +14,7 @@
 #include "idocp/ocp/kkt_residual.hpp"
 #include "idocp/hybrid/contact_sequence.hpp"
 #include "idocp/hybrid/hybrid_time_discretization.hpp"
+#include "idocp/riccati/iteration_level.hpp"
 
 
 namespace idocp {
@@ -113,6 +114,30 @@ public:
                         const Solution& s, KKTMatrix& kkt_matrix, 
                         KKTResidual& kkt_residual) const;
 
+  ///
+  /// @brief Computes the KKT system of the specified level of the multi-level
+  /// iteration in parallel. IterationLevel::Full is equivalent to 
+  /// DirectMultipleShooting::computeKKTSystem(). At IterationLevel::Jacobian 
+  /// and IterationLevel::Residual, the Hessians (and at 
+  /// IterationLevel::Residual, also the Jacobians) are not evaluated and those
+  /// of the last evaluation are reused. See also SplitOCP::computeKKTSystem(). 
+  /// @param[in, out] ocp Optimal control problem.
+  /// @param[in] robots aligned_vector of Robot.
+  /// @param[in] contact_sequence Contact sequence. 
+  /// @param[in] q Initial configuration.
+  /// @param[in] v Initial generalized velocity.
+  /// @param[in] s Solution. 
+  /// @param[in, out] kkt_matrix KKT matrix. 
+  /// @param[in, out] kkt_residual KKT residual. 
+  /// @param[in] level Level of the iteration. 
+  ///
+  void computeKKTSystem(OCP& ocp, aligned_vector<Robot>& robots,
+                        const ContactSequence& contact_sequence,
+                        const Eigen::VectorXd& q, const Eigen::VectorXd& v, 
+                        const Solution& s, KKTMatrix& kkt_matrix, 
+                        KKTResidual& kkt_residual, 
+                        const IterationLevel level) const;
+
   ///
   /// @brief Returns the l2-norm of the KKT residual of optimal control problem.
   /// @param[in] ocp Optimal control problem.
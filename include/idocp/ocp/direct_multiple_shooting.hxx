@@ -106,6 +106,58 @@ struct ComputeKKTSystem {
   }
 };
 
+
+template <IterationLevel Level>
+struct ComputeKKTSystemAtLevel {
+  template <typename SplitSolutionType>
+  static inline void run(SplitOCP& split_ocp, Robot& robot, 
+                         const ContactStatus& contact_status, const double t, 
+                         const double dt, const Eigen::VectorXd& q_prev, 
+                         const SplitSolution& s, 
+                         const SplitSolutionType& s_next, 
+                         SplitKKTMatrix& kkt_matrix, 
+                         SplitKKTResidual& kkt_residual) {
+    split_ocp.computeKKTSystem(robot, contact_status, t, dt, q_prev, s, s_next,
+                               kkt_matrix, kkt_residual, Level);
+  }
+
+  static inline void run(SplitOCP& split_ocp, Robot& robot, 
+                         const ContactStatus& contact_status, const double t, 
+                         const double dt, const Eigen::VectorXd& q_prev, 
+                         const SplitSolution& s, const SplitSolution& s_next, 
+                         SplitKKTMatrix& kkt_matrix, 
+                         SplitKKTResidual& kkt_residual,
+                         const ImpulseStatus& impulse_status, 
+                         const double dt_next, 
+                         SplitSwitchingConstraintJacobian& sc_jacobian,
+                         SplitSwitchingConstraintResidual& sc_residual) {
+    split_ocp.computeKKTSystem(robot, contact_status, t, dt, q_prev, s, s_next,
+                               kkt_matrix, kkt_residual, impulse_status, 
+                               dt_next, sc_jacobian, sc_residual, Level);
+  }
+
+  static inline void run(TerminalOCP& terminal_ocp, Robot& robot, 
+                         const double t, const Eigen::VectorXd& q_prev, 
+                         const SplitSolution& s, SplitKKTMatrix& kkt_matrix, 
+                         SplitKKTResidual& kkt_residual) {
+    // The Riccati recursion reuses the terminal cost-to-go Hessian at the 
+    // levels other than IterationLevel::Full.
+    terminal_ocp.computeKKTResidual(robot, t, q_prev, s, kkt_matrix, 
+                                    kkt_residual);
+  }
+
+  static inline void run(ImpulseSplitOCP& impulse_split_ocp, Robot& robot, 
+                         const ImpulseStatus& impulse_status, const double t, 
+                         const Eigen::VectorXd& q_prev, 
+                         const ImpulseSplitSolution& s, 
+                         const SplitSolution& s_next, 
+                         ImpulseSplitKKTMatrix& kkt_matrix, 
+                         ImpulseSplitKKTResidual& kkt_residual) {
+    impulse_split_ocp.computeKKTSystem(robot, impulse_status, t, q_prev, s, 
+                                       s_next, kkt_matrix, kkt_residual, Level);
+  }
+};
+
 } // namespace internal
 } // namespace idocp
 
@@ -95,6 +95,23 @@ public:
     return data[i];
   }
 
+  ///
+  /// @brief Sets the step sizes of the discretization grids. See 
+  /// HybridTimeDiscretization::setDiscretizationGrid() for details.
+  ///
+  void setDiscretizationGrid(const std::vector<double>& dt) {
+    time_discretization_.setDiscretizationGrid(dt);
+  }
+
+  ///
+  /// @brief Sets geometrically growing step sizes of the discretization 
+  /// grids. See HybridTimeDiscretization::setGeometricDiscretizationGrid() 
+  /// for details.
+  ///
+  void setGeometricDiscretizationGrid(const double ratio) {
+    time_discretization_.setGeometricDiscretizationGrid(ratio);
+  }
+
   void discretize(const ContactSequence& contact_sequence, const double t) {
     time_discretization_.discretize(contact_sequence, t);
   }
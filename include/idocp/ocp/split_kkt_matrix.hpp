@@ -5,6 +5,7 @@
 
 #include "idocp/robot/robot.hpp"
 #include "idocp/robot/contact_status.hpp"
+#include "idocp/ocp/block_sparsity.hpp"
 
 
 namespace idocp {
@@ -237,10 +238,39 @@ public:
   Eigen::MatrixXd Fqq_prev;
 
   ///
-  /// @brief Set the all components zero.
+  /// @brief Set the all components zero. Qff() and Qqf() are cleared only 
+  /// over their current sparsity patterns, which are then reset to 
+  /// BlockSparsity::Dense.
   ///
   void setZero();
 
+  ///
+  /// @brief Sets the sparsity pattern of SplitKKTMatrix::Qff(). Call this just 
+  /// after SplitKKTMatrix::setZero() with a pattern that covers all the values 
+  /// added to SplitKKTMatrix::Qff() afterwards. The condensing skips the 
+  /// entries outside of this pattern. 
+  /// @param[in] sparsity Sparsity pattern. 
+  ///
+  void setQffSparsity(const BlockSparsity sparsity);
+
+  ///
+  /// @brief Sets the sparsity pattern of SplitKKTMatrix::Qqf(). Call this just 
+  /// after SplitKKTMatrix::setZero() with a pattern that covers all the values 
+  /// added to SplitKKTMatrix::Qqf() afterwards. 
+  /// @param[in] sparsity Sparsity pattern. 
+  ///
+  void setQqfSparsity(const BlockSparsity sparsity);
+
+  ///
+  /// @return Sparsity pattern of SplitKKTMatrix::Qff(). 
+  ///
+  BlockSparsity QffSparsity() const;
+
+  ///
+  /// @return Sparsity pattern of SplitKKTMatrix::Qqf(). 
+  ///
+  BlockSparsity QqfSparsity() const;
+
   ///
   /// @brief Returns the dimension of the stack of contact forces at the current 
   /// contact status.
@@ -296,6 +326,7 @@ public:
 
 private:
   Eigen::MatrixXd Qff_full_, Qqf_full_;
+  BlockSparsity Qff_sparsity_, Qqf_sparsity_;
   bool has_floating_base_;
   int dimv_, dimx_, dimu_, dimf_;
 
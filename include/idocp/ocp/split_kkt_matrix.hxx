@@ -18,6 +18,8 @@ inline SplitKKTMatrix::SplitKKTMatrix(const Robot& robot)
     Fqq_prev(),
     Qff_full_(Eigen::MatrixXd::Zero(robot.max_dimf(), robot.max_dimf())),
     Qqf_full_(Eigen::MatrixXd::Zero(robot.dimv(), robot.max_dimf())),
+    Qff_sparsity_(BlockSparsity::Dense),
+    Qqf_sparsity_(BlockSparsity::Dense),
     has_floating_base_(robot.hasFloatingBase()),
     dimv_(robot.dimv()), 
     dimx_(2*robot.dimv()), 
@@ -40,6 +42,8 @@ inline SplitKKTMatrix::SplitKKTMatrix()
     Fqq_prev(),
     Qff_full_(),
     Qqf_full_(),
+    Qff_sparsity_(BlockSparsity::Dense),
+    Qqf_sparsity_(BlockSparsity::Dense),
     has_floating_base_(false),
     dimv_(0), 
     dimx_(0), 
@@ -54,7 +58,13 @@ inline SplitKKTMatrix::~SplitKKTMatrix() {
 
 inline void SplitKKTMatrix::setContactStatus(
     const ContactStatus& contact_status) {
-  dimf_ = contact_status.dimf();
+  const int dim = contact_status.dimf();
+  if (dim != dimf_) {
+    // The entries of the blocks are moved with the dimension. 
+    Qff_sparsity_ = BlockSparsity::Dense;
+    Qqf_sparsity_ = BlockSparsity::Dense;
+  }
+  dimf_ = dim;
 }
 
 
@@ -185,12 +195,41 @@ inline void SplitKKTMatrix::setZero() {
   Qaa.setZero();
   Qxu.setZero();
   Quu.setZero();
-  Qff().setZero();
-  Qqf().setZero();
+  if (Qff_sparsity_ == BlockSparsity::Dense) {
+    Qff().setZero();
+  }
+  else if (Qff_sparsity_ == BlockSparsity::Diagonal) {
+    Qff().diagonal().setZero();
+  }
+  if (Qqf_sparsity_ != BlockSparsity::Zero) {
+    Qqf().setZero();
+  }
+  Qff_sparsity_ = BlockSparsity::Dense;
+  Qqf_sparsity_ = BlockSparsity::Dense;
   Fqq_prev.setZero();
 }
 
 
+inline void SplitKKTMatrix::setQffSparsity(const BlockSparsity sparsity) {
+  Qff_sparsity_ = sparsity;
+}
+
+
+inline void SplitKKTMatrix::setQqfSparsity(const BlockSparsity sparsity) {
+  Qqf_sparsity_ = sparsity;
+}
+
+
+inline BlockSparsity SplitKKTMatrix::QffSparsity() const {
+  return Qff_sparsity_;
+}
+
+
+inline BlockSparsity SplitKKTMatrix::QqfSparsity() const {
+  return Qqf_sparsity_;
+}
+
+
 inline int SplitKKTMatrix::dimf() const {
   return dimf_;
 }
@@ -258,6 +297,8 @@ inline void SplitKKTMatrix::setRandom() {
   Qaa = Qaaff.topLeftCorner(dimv_, dimv_);
   Qff() = Qaaff.bottomRightCorner(dimf_, dimf_);
   Qqf().setRandom();
+  Qff_sparsity_ = BlockSparsity::Dense;
+  Qqf_sparsity_ = BlockSparsity::Dense;
   Fqq_prev.setRandom();
 }
 
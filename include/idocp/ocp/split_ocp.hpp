@@ -20,6 +20,7 @@
 #include "idocp/ocp/switching_constraint.hpp"
 #include "idocp/ocp/split_switching_constraint_residual.hpp"
 #include "idocp/ocp/split_switching_constraint_jacobian.hpp"
+#include "idocp/riccati/iteration_level.hpp"
 
 
 namespace idocp {
@@ -99,6 +100,14 @@ public:
   ///
   const ConstraintsData& getConstraintsData() const;
 
+  ///
+  /// @brief Initializes the constraints, i.e., copies the slack and dual 
+  /// variables from the constraints data. 
+  /// @param[in] constraints_data Constraints data whose structure is 
+  /// consistent with this time stage.
+  ///
+  void initConstraints(const ConstraintsData& constraints_data);
+
   ///
   /// @brief Computes the stage cost and constraint violation.
   /// Used in the line search.
@@ -235,6 +244,66 @@ public:
                         SplitSwitchingConstraintJacobian& sc_jacobian,
                         SplitSwitchingConstraintResidual& sc_residual);
 
+  ///
+  /// @brief Computes the KKT system of this time stage of the specified level
+  /// of the multi-level iteration. IterationLevel::Full is equivalent to 
+  /// SplitOCP::computeKKTSystem(). IterationLevel::Jacobian evaluates only the
+  /// gradients and the Jacobians, and condenses them with the Hessians stored 
+  /// by the last IterationLevel::Full. IterationLevel::Residual evaluates only 
+  /// the KKT residual and condenses it with kkt_matrix and the condensing 
+  /// matrices of the last IterationLevel::Full or IterationLevel::Jacobian.
+  /// The contact status must be the same as that of the last 
+  /// IterationLevel::Full unless level is IterationLevel::Full.
+  /// @param[in] robot Robot model. 
+  /// @param[in] contact_status Contact status of this time stage. 
+  /// @param[in] t Time of this time stage. 
+  /// @param[in] dt Time step of this time stage. 
+  /// @param[in] q_prev Configuration at the previous time stage.
+  /// @param[in] s Split solution of this time stage.
+  /// @param[in] s_next Split solution of the next time stage.
+  /// @param[in, out] kkt_matrix Split KKT matrix of this time stage.
+  /// @param[in, out] kkt_residual Split KKT residual of this time stage.
+  /// @param[in] level Level of the iteration. 
+  ///
+  template <typename SplitSolutionType>
+  void computeKKTSystem(Robot& robot, const ContactStatus& contact_status, 
+                        const double t, const double dt, 
+                        const Eigen::VectorXd& q_prev, const SplitSolution& s, 
+                        const SplitSolutionType& s_next, 
+                        SplitKKTMatrix& kkt_matrix,
+                        SplitKKTResidual& kkt_residual,
+                        const IterationLevel level);
+
+  ///
+  /// @brief Computes the KKT system of this time stage including the 
+  /// switching constraint of the specified level of the multi-level 
+  /// iteration. See SplitOCP::computeKKTSystem() for the levels.
+  /// @param[in] robot Robot model. 
+  /// @param[in] contact_status Contact status of this time stage. 
+  /// @param[in] t Time of this time stage. 
+  /// @param[in] dt Time step of this time stage. 
+  /// @param[in] q_prev Configuration at the previous time stage.
+  /// @param[in] s Split solution of this time stage.
+  /// @param[in] s_next Split solution of the next time stage.
+  /// @param[in, out] kkt_matrix Split KKT matrix of this time stage.
+  /// @param[in, out] kkt_residual Split KKT residual of this time stage.
+  /// @param[in] impulse_status Impulse status at the switching instant. 
+  /// @param[in] dt_next Time step of the next time stage. 
+  /// @param[in, out] sc_jacobian Jacobian of the switching constraint. 
+  /// @param[in, out] sc_residual Residual of the switching constraint. 
+  /// @param[in] level Level of the iteration. 
+  ///
+  void computeKKTSystem(Robot& robot, const ContactStatus& contact_status, 
+                        const double t, const double dt, 
+                        const Eigen::VectorXd& q_prev, const SplitSolution& s, 
+                        const SplitSolution& s_next, SplitKKTMatrix& kkt_matrix,
+                        SplitKKTResidual& kkt_residual, 
+                        const ImpulseStatus& impulse_status, 
+                        const double dt_next, 
+                        SplitSwitchingConstraintJacobian& sc_jacobian,
+                        SplitSwitchingConstraintResidual& sc_residual,
+                        const IterationLevel level);
+
   ///
   /// @brief Computes the initial state direction using the result of  
   /// SplitOCP::computeKKTSystem().
@@ -258,6 +327,41 @@ public:
   /// 
   void expandPrimal(const SplitSolution& s, SplitDirection& d);
 
+  ///
+  /// @brief Expands the condensed primal variables without the directions of
+  /// the slack and dual variables of the inequality constraints, e.g., for 
+  /// the second-order correction of the line search.
+  /// @param[in] s Split solution of this time stage.
+  /// @param[in, out] d Split direction of this time stage.
+  /// 
+  void expandPrimalWithoutSlackAndDual(const SplitSolution& s, 
+                                       SplitDirection& d) const;
+
+  ///
+  /// @brief Multiplies the inverse of the Lie derivative of the last 
+  /// linearization to the residual of the state equation computed by 
+  /// SplitOCP::evalOCP(), so that the residual is consistent with the KKT 
+  /// matrix computed by SplitOCP::computeKKTSystem().
+  /// @param[in, out] kkt_residual Split KKT residual of this time stage.
+  /// 
+  void correctStateEquationResidual(SplitKKTResidual& kkt_residual);
+
+  ///
+  /// @brief Condenses the residual of the contact dynamics computed by 
+  /// SplitOCP::evalOCP() by using the Jacobians of the last 
+  /// SplitOCP::computeKKTSystem(). 
+  /// @param[in] robot Robot model. 
+  /// @param[in] contact_status Contact status of this time stage. 
+  /// @param[in] dt Time step of this time stage. 
+  /// @param[in] kkt_matrix Split KKT matrix of this time stage.
+  /// @param[in, out] kkt_residual Split KKT residual of this time stage.
+  /// 
+  void condenseContactDynamicsResidual(Robot& robot, 
+                                       const ContactStatus& contact_status, 
+                                       const double dt, 
+                                       const SplitKKTMatrix& kkt_matrix, 
+                                       SplitKKTResidual& kkt_residual);
+
   ///
   /// @brief Expands the condensed dual variables, i.e., computes the Newton 
   /// direction of the condensed dual variables of this stage.
@@ -318,6 +422,44 @@ public:
   /// 
   double stageCost() const;
 
+  ///
+  /// @brief Returns the Hamiltonian of this time stage, i.e., the partial
+  /// derivative of the stage Lagrangian with respect to the time step dt. 
+  /// The terms of the contact dynamics are omitted because they vanish at a 
+  /// feasible solution. Before calling this function, 
+  /// SplitOCP::computeKKTResidual() or SplitOCP::computeKKTSystem() must be 
+  /// called.
+  /// @param[in] dt Time step of this time stage. Must be positive.
+  /// @param[in] s Split solution of this time stage.
+  /// @param[in] s_next Split solution of the next time stage.
+  /// @return Hamiltonian of this time stage.
+  /// 
+  template <typename SplitSolutionType>
+  double hamiltonian(const double dt, const SplitSolution& s, 
+                     const SplitSolutionType& s_next) const;
+
+  ///
+  /// @brief Returns the Hamiltonian of the time stage just before an impulse
+  /// whose previous time stage has the switching constraint. In addition to 
+  /// SplitOCP::hamiltonian(), the partial derivative of the switching 
+  /// constraint of the previous time stage with respect to the time step dt 
+  /// is added. 
+  /// @param[in] dt Time step of this time stage. Must be positive.
+  /// @param[in] s Split solution of this time stage.
+  /// @param[in] s_next Split solution of the impulse stage.
+  /// @param[in] dt_prev Time step of the previous time stage. Must be positive.
+  /// @param[in] s_prev Split solution of the previous time stage.
+  /// @param[in] sc_jacobian_prev Jacobian of the switching constraint of the
+  /// previous time stage.
+  /// @return Hamiltonian of this time stage.
+  /// 
+  template <typename SplitSolutionType>
+  double hamiltonian(
+      const double dt, const SplitSolution& s, 
+      const SplitSolutionType& s_next, const double dt_prev, 
+      const SplitSolution& s_prev, 
+      const SplitSwitchingConstraintJacobian& sc_jacobian_prev) const;
+
   ///
   /// @brief Returns the constraint violation of this time stage for the 
   /// line search. 
@@ -352,6 +494,7 @@ private:
   StateEquation state_equation_;
   ContactDynamics contact_dynamics_;
   double stage_cost_;
+  Eigen::MatrixXd Qxx_, Qxu_, Quu_;
 
 };
 
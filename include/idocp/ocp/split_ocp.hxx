@@ -16,7 +16,10 @@ inline SplitOCP::SplitOCP(const Robot& robot,
     constraints_data_(constraints->createConstraintsData(robot, 0)),
     state_equation_(robot),
     contact_dynamics_(robot),
-    stage_cost_(0) {
+    stage_cost_(0),
+    Qxx_(Eigen::MatrixXd::Zero(2*robot.dimv(), 2*robot.dimv())),
+    Qxu_(Eigen::MatrixXd::Zero(2*robot.dimv(), robot.dimu())),
+    Quu_(Eigen::MatrixXd::Zero(robot.dimu(), robot.dimu())) {
 }
 
 
@@ -27,7 +30,10 @@ inline SplitOCP::SplitOCP()
     constraints_data_(),
     state_equation_(),
     contact_dynamics_(),
-    stage_cost_(0) {
+    stage_cost_(0),
+    Qxx_(),
+    Qxu_(),
+    Quu_() {
 }
 
 
@@ -53,6 +59,16 @@ inline void SplitOCP::initConstraints(const SplitOCP& other) {
 }
 
 
+inline const ConstraintsData& SplitOCP::getConstraintsData() const {
+  return constraints_data_;
+}
+
+
+inline void SplitOCP::initConstraints(const ConstraintsData& constraints_data) { 
+  constraints_data_.copySlackAndDual(constraints_data);
+}
+
+
 inline void SplitOCP::evalOCP(Robot& robot, const ContactStatus& contact_status,
                               const double t, const double dt, 
                               const SplitSolution& s, 
@@ -153,12 +169,19 @@ inline void SplitOCP::computeKKTSystem(Robot& robot,
   kkt_matrix.setContactStatus(contact_status);
   kkt_residual.setContactStatus(contact_status);
   kkt_matrix.setZero();
+  kkt_matrix.setQffSparsity(joinBlockSparsity(cost_->QffSparsity(), 
+                                              constraints_->QffSparsity()));
+  kkt_matrix.setQqfSparsity(joinBlockSparsity(cost_->QqfSparsity(), 
+                                              constraints_->QqfSparsity()));
   kkt_residual.setZero();
   stage_cost_ = cost_->quadratizeStageCost(robot, cost_data_, t, dt, s, 
                                            kkt_residual, kkt_matrix);
   constraints_->condenseSlackAndDual(robot, constraints_data_, dt, s, 
                                      kkt_matrix, kkt_residual);
   stage_cost_ += dt * constraints_data_.logBarrier();
+  Qxx_ = kkt_matrix.Qxx;
+  Qxu_ = kkt_matrix.Qxu;
+  Quu_ = kkt_matrix.Quu;
   state_equation_.linearizeStateEquationAlongLieGroup(robot, dt, q_prev, s, s_next, 
                                                       kkt_matrix, kkt_residual);
   contact_dynamics_.linearizeContactDynamics(robot, contact_status, dt, s,
@@ -187,12 +210,19 @@ inline void SplitOCP::computeKKTSystem(Robot& robot,
   kkt_matrix.setContactStatus(contact_status);
   kkt_residual.setContactStatus(contact_status);
   kkt_matrix.setZero();
+  kkt_matrix.setQffSparsity(joinBlockSparsity(cost_->QffSparsity(), 
+                                              constraints_->QffSparsity()));
+  kkt_matrix.setQqfSparsity(joinBlockSparsity(cost_->QqfSparsity(), 
+                                              constraints_->QqfSparsity()));
   kkt_residual.setZero();
   stage_cost_ = cost_->quadratizeStageCost(robot, cost_data_, t, dt, s, 
                                            kkt_residual, kkt_matrix);
   constraints_->condenseSlackAndDual(robot, constraints_data_, dt, s, 
                                      kkt_matrix, kkt_residual);
   stage_cost_ += dt * constraints_data_.logBarrier();
+  Qxx_ = kkt_matrix.Qxx;
+  Qxu_ = kkt_matrix.Qxu;
+  Quu_ = kkt_matrix.Quu;
   state_equation_.linearizeStateEquationAlongLieGroup(robot, dt, q_prev, s, s_next, 
                                                       kkt_matrix, kkt_residual);
   contact_dynamics_.linearizeContactDynamics(robot, contact_status, dt, s,
@@ -206,6 +236,109 @@ inline void SplitOCP::computeKKTSystem(Robot& robot,
 }
 
 
+template <typename SplitSolutionType>
+inline void SplitOCP::computeKKTSystem(Robot& robot, 
+                                       const ContactStatus& contact_status,  
+                                       const double t, const double dt, 
+                                       const Eigen::VectorXd& q_prev, 
+                                       const SplitSolution& s, 
+                                       const SplitSolutionType& s_next,
+                                       SplitKKTMatrix& kkt_matrix, 
+                                       SplitKKTResidual& kkt_residual,
+                                       const IterationLevel level) {
+  if (level == IterationLevel::Full) {
+    computeKKTSystem(robot, contact_status, t, dt, q_prev, s, s_next, 
+                     kkt_matrix, kkt_residual);
+    return;
+  }
+  assert(dt > 0);
+  assert(q_prev.size() == robot.dimq());
+  robot.updateKinematics(s.q, s.v, s.a);
+  kkt_matrix.setContactStatus(contact_status);
+  kkt_residual.setContactStatus(contact_status);
+  kkt_residual.setZero();
+  stage_cost_ = cost_->linearizeStageCost(robot, cost_data_, t, dt, s, 
+                                          kkt_residual);
+  constraints_->condenseSlackAndDual(robot, constraints_data_, dt, s, 
+                                     kkt_residual);
+  stage_cost_ += dt * constraints_data_.logBarrier();
+  contact_dynamics_.linearizeContactDynamics(robot, contact_status, dt, s,
+                                             kkt_residual);
+  if (level == IterationLevel::Jacobian) {
+    kkt_matrix.Qxx = Qxx_;
+    kkt_matrix.Qxu = Qxu_;
+    kkt_matrix.Quu = Quu_;
+    state_equation_.linearizeStateEquationAlongLieGroup(robot, dt, q_prev, s, 
+                                                        s_next, kkt_matrix, 
+                                                        kkt_residual);
+    contact_dynamics_.condenseContactDynamics(robot, contact_status, dt, 
+                                              kkt_matrix, kkt_residual);
+  }
+  else {
+    state_equation_.linearizeStateEquationAlongLieGroup(robot, dt, q_prev, s, 
+                                                        s_next, kkt_residual);
+    contact_dynamics_.condenseContactDynamicsResidual(robot, contact_status, dt, 
+                                                      kkt_matrix, kkt_residual);
+  }
+}
+
+
+inline void SplitOCP::computeKKTSystem(Robot& robot, 
+                                       const ContactStatus& contact_status, 
+                                       const double t, const double dt, 
+                                       const Eigen::VectorXd& q_prev, 
+                                       const SplitSolution& s, 
+                                       const SplitSolution& s_next, 
+                                       SplitKKTMatrix& kkt_matrix, 
+                                       SplitKKTResidual& kkt_residual, 
+                                       const ImpulseStatus& impulse_status,
+                                       const double dt_next, 
+                                       SplitSwitchingConstraintJacobian& sc_jacobian,
+                                       SplitSwitchingConstraintResidual& sc_residual,
+                                       const IterationLevel level) {
+  if (level == IterationLevel::Full) {
+    computeKKTSystem(robot, contact_status, t, dt, q_prev, s, s_next, 
+                     kkt_matrix, kkt_residual, impulse_status, dt_next, 
+                     sc_jacobian, sc_residual);
+    return;
+  }
+  assert(dt > 0);
+  assert(dt_next > 0);
+  assert(q_prev.size() == robot.dimq());
+  robot.updateKinematics(s.q, s.v, s.a);
+  kkt_matrix.setContactStatus(contact_status);
+  kkt_residual.setContactStatus(contact_status);
+  kkt_residual.setZero();
+  stage_cost_ = cost_->linearizeStageCost(robot, cost_data_, t, dt, s, 
+                                          kkt_residual);
+  constraints_->condenseSlackAndDual(robot, constraints_data_, dt, s, 
+                                     kkt_residual);
+  stage_cost_ += dt * constraints_data_.logBarrier();
+  contact_dynamics_.linearizeContactDynamics(robot, contact_status, dt, s,
+                                             kkt_residual);
+  switchingconstraint::linearizeSwitchingConstraint(robot, impulse_status, dt, 
+                                                    dt_next, s, kkt_residual, 
+                                                    sc_jacobian, sc_residual);
+  if (level == IterationLevel::Jacobian) {
+    kkt_matrix.Qxx = Qxx_;
+    kkt_matrix.Qxu = Qxu_;
+    kkt_matrix.Quu = Quu_;
+    state_equation_.linearizeStateEquationAlongLieGroup(robot, dt, q_prev, s, 
+                                                        s_next, kkt_matrix, 
+                                                        kkt_residual);
+    contact_dynamics_.condenseContactDynamics(robot, contact_status, dt, 
+                                              kkt_matrix, kkt_residual);
+  }
+  else {
+    state_equation_.linearizeStateEquationAlongLieGroup(robot, dt, q_prev, s, 
+                                                        s_next, kkt_residual);
+    contact_dynamics_.condenseContactDynamicsResidual(robot, contact_status, dt, 
+                                                      kkt_matrix, kkt_residual);
+  }
+  contact_dynamics_.condenseSwitchingConstraint(sc_jacobian, sc_residual);
+}
+
+
 inline void SplitOCP::computeInitialStateDirection(const Robot& robot, 
                                                    const Eigen::VectorXd& q0, 
                                                    const Eigen::VectorXd& v0, 
@@ -222,6 +355,27 @@ inline void SplitOCP::expandPrimal(const SplitSolution& s, SplitDirection& d) {
 }
 
 
+inline void SplitOCP::expandPrimalWithoutSlackAndDual(const SplitSolution& s, 
+                                                      SplitDirection& d) const {
+  d.setContactStatusByDimension(s.dimf());
+  contact_dynamics_.expandPrimal(d);
+}
+
+
+inline void SplitOCP::correctStateEquationResidual(
+    SplitKKTResidual& kkt_residual) {
+  state_equation_.correctStateEquationResidual(kkt_residual);
+}
+
+
+inline void SplitOCP::condenseContactDynamicsResidual(
+    Robot& robot, const ContactStatus& contact_status, const double dt, 
+    const SplitKKTMatrix& kkt_matrix, SplitKKTResidual& kkt_residual) {
+  contact_dynamics_.condenseContactDynamicsResidual(robot, contact_status, dt, 
+                                                    kkt_matrix, kkt_residual);
+}
+
+
 template <typename SplitDirectionType>
 inline void SplitOCP::expandDual(const double dt, 
                                  const SplitDirectionType& d_next, 
@@ -276,6 +430,36 @@ inline double SplitOCP::stageCost() const {
 } 
 
 
+template <typename SplitSolutionType>
+inline double SplitOCP::hamiltonian(const double dt, const SplitSolution& s, 
+                                    const SplitSolutionType& s_next) const {
+  assert(dt > 0);
+  double h = stage_cost_ / dt;
+  h += s_next.lmd.dot(s.v);
+  h += s_next.gmm.dot(s.a);
+  return h;
+}
+
+
+template <typename SplitSolutionType>
+inline double SplitOCP::hamiltonian(
+    const double dt, const SplitSolution& s, const SplitSolutionType& s_next, 
+    const double dt_prev, const SplitSolution& s_prev, 
+    const SplitSwitchingConstraintJacobian& sc_jacobian_prev) const {
+  assert(dt > 0);
+  assert(dt_prev > 0);
+  assert(s_prev.dimi() == sc_jacobian_prev.dimi());
+  double h = hamiltonian(dt, s, s_next);
+  // The switching constraint of the previous stage depends on dt through 
+  // dq = (dt_prev+dt) * v_prev + (dt_prev*dt) * a_prev, and Phia is the 
+  // Jacobian with respect to dq scaled by dt_prev*dt.
+  h += s_prev.xi_stack().dot(sc_jacobian_prev.Phia() 
+                                * (s_prev.v + dt_prev * s_prev.a)) 
+        / (dt_prev * dt);
+  return h;
+}
+
+
 inline double SplitOCP::constraintViolation(const SplitKKTResidual& kkt_residual, 
                                             const double dt) const {
   double vio = 0;
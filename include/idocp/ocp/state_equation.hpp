@@ -107,12 +107,41 @@ public:
       const SplitSolutionType& s_next, SplitKKTMatrix& kkt_matrix, 
       SplitKKTResidual& kkt_residual);
 
+  ///
+  /// @brief Linearizes the state equation only into the KKT residual, e.g., 
+  /// at IterationLevel::Jacobian and IterationLevel::Residual of the 
+  /// multi-level iteration. The KKT matrix is not modified and 
+  /// SplitKKTResidual::Fq is multiplied by the inverse of the Lie derivative 
+  /// of the last linearization with the KKT matrix. 
+  /// @param[in] robot Robot model. 
+  /// @param[in] dt Time step. 
+  /// @param[in] q_prev Configuration at the previous time stage. 
+  /// @param[in] s Solution at the current stage. 
+  /// @param[in] s_next Solution at the next time stage. 
+  /// @param[in, out] kkt_residual Split KKT residual at the current time stage. 
+  ///
+  template <typename ConfigVectorType, typename SplitSolutionType>
+  void linearizeStateEquationAlongLieGroup(
+      const Robot& robot, const double dt, 
+      const Eigen::MatrixBase<ConfigVectorType>& q_prev, const SplitSolution& s, 
+      const SplitSolutionType& s_next, SplitKKTResidual& kkt_residual);
+
   ///
   /// @brief Corrects the costate direction using the derivatives of the Lie group. 
   /// @param[in, out] d Split direction. 
   ///
   void correctCostateDirection(SplitDirection& d);
 
+  ///
+  /// @brief Multiplies the inverse of the Lie derivative of the last 
+  /// StateEquation::linearizeStateEquationAlongLieGroup() to 
+  /// SplitKKTResidual::Fq computed by 
+  /// StateEquation::computeStateEquationResidual(), e.g., at a trial point of
+  /// the line search. 
+  /// @param[in, out] kkt_residual Split KKT residual at the current time stage. 
+  ///
+  void correctStateEquationResidual(SplitKKTResidual& kkt_residual);
+
   ///
   /// @brief Computes the initial state direction using the result of  
   /// StateEquation::linearizeStateEquationAlongLieGroup().
@@ -129,7 +158,7 @@ public:
       const SplitSolution& s0, SplitDirection& d0) const;
 
 private:
-  Eigen::MatrixXd Fqq_inv_, Fqq_prev_inv_, Fqq_tmp_;  
+  Eigen::MatrixXd Fqq_inv_, Fqq_prev_inv_, Fqq_tmp_, dsubtract_dq_;  
   Eigen::VectorXd Fq_tmp_;
   LieDerivativeInverter lie_der_inverter_;
   bool has_floating_base_;
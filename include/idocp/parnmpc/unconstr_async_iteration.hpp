@@ -0,0 +1,188 @@
+#ifndef IDOCP_UNCONSTR_ASYNC_ITERATION_HPP_
+#define IDOCP_UNCONSTR_ASYNC_ITERATION_HPP_
+
+#include <vector>
+#include <memory>
+#include <atomic>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/utils/aligned_vector.hpp"
+#include "idocp/utils/triple_buffer.hpp"
+#include "idocp/ocp/split_solution.hpp"
+#include "idocp/ocp/solution.hpp"
+#include "idocp/ocp/direction.hpp"
+#include "idocp/ocp/kkt_matrix.hpp"
+#include "idocp/ocp/kkt_residual.hpp"
+#include "idocp/unconstr/unconstr_parnmpc.hpp"
+#include "idocp/parnmpc/unconstr_split_backward_correction.hpp"
+
+
+namespace idocp {
+
+///
+/// @class UnconstrAsyncIteration
+/// @brief Asynchronous (barrier-free) ParNMPC iteration for optimal control
+/// problems of unconstrained rigid-body systems. The stages are split into
+/// contiguous blocks, one for each thread. Each thread repeats sweeps over
+/// its block, in which each stage is linearized and coarse updated by the
+/// latest solution of its neighbours, until the norm of the direction over
+/// the horizon falls below the tolerance or the maximum number of sweeps is
+/// reached. The states, the costates, and the auxiliary matrices at the
+/// boundaries of the blocks are exchanged by the lock-free triple buffers.
+/// Without the backward correction, the iteration converges linearly.
+///
+class UnconstrAsyncIteration {
+public:
+  ///
+  /// @brief Construct an asynchronous iteration.
+  /// @param[in] robot Robot model.
+  /// @param[in] T Length of the horizon. Must be positive.
+  /// @param[in] N Number of discretization of the horizon.
+  /// @param[in] nthreads Number of the threads used in solving the optimal
+  /// control problem. Must be positive.
+  ///
+  UnconstrAsyncIteration(const Robot& robot, const double T, const int N,
+                         const int nthreads);
+
+  ///
+  /// @brief Default constructor.
+  ///
+  UnconstrAsyncIteration();
+
+  ///
+  /// @brief Destructor.
+  ///
+  ~UnconstrAsyncIteration();
+
+  ///
+  /// @brief Copy constructor. The buffers are not shared with the copy.
+  ///
+  UnconstrAsyncIteration(const UnconstrAsyncIteration& other);
+
+  ///
+  /// @brief Copy operator. The buffers are not shared with the copy.
+  ///
+  UnconstrAsyncIteration& operator=(const UnconstrAsyncIteration& other);
+
+  ///
+  /// @brief Default move constructor.
+  ///
+  UnconstrAsyncIteration(UnconstrAsyncIteration&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator.
+  ///
+  UnconstrAsyncIteration& operator=(UnconstrAsyncIteration&&) noexcept = default;
+
+  ///
+  /// @brief Sets the parameters of the iteration.
+  /// @param[in] max_sweeps Maximum number of the sweeps of each thread. Must
+  /// be positive. Default is 10.
+  /// @param[in] tol Tolerance of the l2-norm of the direction over the
+  /// horizon. Must be non-negative. Default is 1.0e-08.
+  /// @param[in] deterministic If true, the threads synchronize after every
+  /// sweep and use the neighbour solution of the previous sweep, so that
+  /// the result does not depend on the timing of the threads. Default is
+  /// false.
+  ///
+  void setParameters(const int max_sweeps, const double tol,
+                     const bool deterministic);
+
+  ///
+  /// @brief Initializes the auxiliary matrices by the terminal cost Hessian
+  /// computed by the current solution.
+  /// @param[in] robots aligned_vector of Robot.
+  /// @param[in] parnmpc Optimal control problem.
+  /// @param[in] t Initial time of the horizon.
+  /// @param[in] s Solution.
+  /// @param[in, out] kkt_matrix KKT matrix.
+  /// @param[in, out] kkt_residual KKT residual.
+  ///
+  void initAuxMat(aligned_vector<Robot>& robots, UnconstrParNMPC& parnmpc,
+                  const double t, const Solution& s,
+                  KKTMatrix& kkt_matrix, KKTResidual& kkt_residual);
+
+  ///
+  /// @brief Iterates the sweeps over the blocks of the stages in parallel
+  /// and updates the solution. The step sizes are determined by the
+  /// fraction-to-boundary rule of each stage.
+  /// @param[in] robots aligned_vector of Robot.
+  /// @param[in, out] parnmpc Optimal control problem.
+  /// @param[in] t Initial time of the horizon.
+  /// @param[in] q Initial configuration.
+  /// @param[in] v Initial generalized velocity.
+  /// @param[in, out] kkt_matrix KKT matrix.
+  /// @param[in, out] kkt_residual KKT residual.
+  /// @param[in, out] s Solution.
+  /// @param[in, out] d Direction.
+  /// @return true if the tolerance is satisfied. false if not.
+  ///
+  bool iterate(aligned_vector<Robot>& robots, UnconstrParNMPC& parnmpc,
+               const double t, const Eigen::VectorXd& q,
+               const Eigen::VectorXd& v, KKTMatrix& kkt_matrix,
+               KKTResidual& kkt_residual, Solution& s, Direction& d);
+
+  ///
+  /// @return The maximum number of the sweeps of the threads in the last
+  /// UnconstrAsyncIteration::iterate().
+  ///
+  int numSweeps() const;
+
+  ///
+  /// @return The l2-norm of the direction over the horizon in the last
+  /// sweeps of the threads in UnconstrAsyncIteration::iterate().
+  ///
+  double directionNorm() const;
+
+private:
+  ///
+  /// @brief Solution at the boundary of the blocks. The forward buffer of a
+  /// stage holds q and v for the next stage, and the backward buffer holds
+  /// lmd, gmm, and the auxiliary matrix for the previous stage.
+  ///
+  struct BoundaryData {
+    Eigen::VectorXd q, v, lmd, gmm;
+    Eigen::MatrixXd aux_mat;
+  };
+
+  using Buffer = TripleBuffer<BoundaryData>;
+
+  int N_, nthreads_, num_blocks_, max_sweeps_, dimq_, dimv_;
+  double T_, dt_, tol_;
+  bool deterministic_;
+  std::vector<UnconstrSplitBackwardCorrection> corrector_;
+  Solution s_new_;
+  std::vector<Eigen::MatrixXd> aux_mat_;
+  // Solution of the neighbouring stages of the blocks read from the buffers.
+  std::vector<SplitSolution> s_prev_, s_next_;
+  std::vector<Eigen::MatrixXd> aux_mat_next_;
+  std::vector<std::unique_ptr<Buffer>> forward_buffer_, backward_buffer_;
+  std::unique_ptr<std::atomic<double>[]> squared_norm_;
+  std::vector<int> num_sweeps_;
+
+  void allocateBuffers();
+
+  int stageBegin(const int block) const;
+
+  void readBoundary(const int block);
+
+  double sweep(Robot& robot, UnconstrParNMPC& parnmpc, const double t,
+               const Eigen::VectorXd& q, const Eigen::VectorXd& v,
+               KKTMatrix& kkt_matrix, KKTResidual& kkt_residual, Solution& s,
+               Direction& d, const int block, const bool reverse);
+
+  double updateStage(Robot& robot, UnconstrParNMPC& parnmpc, const double t,
+                     const Eigen::VectorXd& q_prev,
+                     const Eigen::VectorXd& v_prev,
+                     const SplitSolution& s_next,
+                     const Eigen::MatrixXd& aux_mat_next,
+                     KKTMatrix& kkt_matrix, KKTResidual& kkt_residual,
+                     Solution& s, Direction& d, const int stage);
+
+};
+
+} // namespace idocp
+
+#endif // IDOCP_UNCONSTR_ASYNC_ITERATION_HPP_
@@ -5,6 +5,7 @@
 
 #include "Eigen/Core"
 #include "Eigen/LU"
+#include "Eigen/Cholesky"
 
 #include "idocp/robot/robot.hpp"
 
@@ -13,7 +14,12 @@ namespace idocp {
 
 ///
 /// @class UnconstrKKTMatrixInverter 
-/// @brief Schur complement for SplitKKTMatrix for UnconstrParNMPC.
+/// @brief Schur complement for SplitKKTMatrix for UnconstrParNMPC. The 
+/// split KKT matrix is 
+/// \f[ \begin{bmatrix} O & F \\ F^{\rm T} & H \end{bmatrix}, \f]
+/// where \f$ F \f$ is the Jacobian of the state equation with respect to 
+/// \f$ (a, q, v) \f$, whose blocks are only identities and identities 
+/// scaled by dt. 
 ///
 class UnconstrKKTMatrixInverter {
 public:
@@ -65,9 +71,81 @@ public:
   void invert(const double dt, const Eigen::MatrixBase<MatrixType1>& H,
               const Eigen::MatrixBase<MatrixType2>& KKT_mat_inv);
 
+  ///
+  /// @brief Factorizes the split KKT matrix of the time stage without forming
+  /// its inverse. Only the Cholesky factorizations of H and of the Schur 
+  /// complement S and the two blocks of the inverse needed in the serial 
+  /// parts of the backward correction are computed. The inverse is then 
+  /// applied by UnconstrKKTMatrixInverter::solve(), 
+  /// UnconstrKKTMatrixInverter::backwardCorrection(), and 
+  /// UnconstrKKTMatrixInverter::forwardCorrection().
+  /// @param[in] dt Time step of this time stage.
+  /// @param[in] H Hessian of the KKT matrix. Only the lower triangular part 
+  /// is used.
+  ///
+  template <typename MatrixType>
+  void factorize(const double dt, const Eigen::MatrixBase<MatrixType>& H);
+
+  ///
+  /// @brief Applies the inverse of the split KKT matrix to a vector. 
+  /// UnconstrKKTMatrixInverter::factorize() must be called before calling 
+  /// this function.
+  /// @param[in] kkt_res Vector of size 5 * dimv.
+  /// @param[out] d Inverse of the split KKT matrix times kkt_res. Size must be
+  /// 5 * dimv.
+  ///
+  template <typename VectorType1, typename VectorType2>
+  void solve(const Eigen::MatrixBase<VectorType1>& kkt_res,
+             const Eigen::MatrixBase<VectorType2>& d);
+
+  ///
+  /// @brief Computes the rows of (a, q, v) of the inverse of the split KKT 
+  /// matrix times [0; 0; x]. UnconstrKKTMatrixInverter::factorize() must be 
+  /// called before calling this function.
+  /// @param[in] x Vector of size 2 * dimv. 
+  /// @param[in] dx UnconstrKKTMatrixInverter::couplingMat() times x, i.e., 
+  /// the rows of the costates. Size must be 2 * dimv.
+  /// @param[out] d Rows of (a, q, v). Size must be 3 * dimv.
+  ///
+  template <typename VectorType1, typename VectorType2, typename VectorType3>
+  void backwardCorrection(const Eigen::MatrixBase<VectorType1>& x,
+                          const Eigen::MatrixBase<VectorType2>& dx,
+                          const Eigen::MatrixBase<VectorType3>& d);
+
+  ///
+  /// @brief Computes the rows of (lmd, gmm, a) of the inverse of the split 
+  /// KKT matrix times [x; 0]. UnconstrKKTMatrixInverter::factorize() must be 
+  /// called before calling this function.
+  /// @param[in] x Vector of size 2 * dimv. 
+  /// @param[out] d Rows of (lmd, gmm, a). Size must be 3 * dimv.
+  ///
+  template <typename VectorType1, typename VectorType2>
+  void forwardCorrection(const Eigen::MatrixBase<VectorType1>& x,
+                         const Eigen::MatrixBase<VectorType2>& d);
+
+  ///
+  /// @brief Returns the top-left block of the inverse of the split KKT 
+  /// matrix, i.e., the negative inverse of the Schur complement. 
+  /// UnconstrKKTMatrixInverter::factorize() must be called before calling 
+  /// this function.
+  /// @return const reference to the block of size 2 * dimv x 2 * dimv. 
+  ///
+  const Eigen::MatrixXd& auxMat() const;
+
+  ///
+  /// @brief Returns the block of the inverse of the split KKT matrix whose 
+  /// rows correspond to the costates and columns to the state (q, v). Its 
+  /// transpose is the block whose rows correspond to the state and columns 
+  /// to the costates. UnconstrKKTMatrixInverter::factorize() must be called 
+  /// before calling this function.
+  /// @return const reference to the block of size 2 * dimv x 2 * dimv. 
+  ///
+  const Eigen::MatrixXd& couplingMat() const;
+
 private:
   Eigen::LLT<Eigen::MatrixXd> llt_H_, llt_S_;
-  Eigen::MatrixXd FHinv_, S_;
+  Eigen::MatrixXd FHinv_, S_, W_, aux_mat_, coupling_mat_;
+  Eigen::VectorXd u_, lmd_;
   int dimv_, dimx_, dimH_, dimkkt_;
 
 };
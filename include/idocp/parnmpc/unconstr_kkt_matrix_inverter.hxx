@@ -13,6 +13,11 @@ inline UnconstrKKTMatrixInverter::UnconstrKKTMatrixInverter(const Robot& robot)
     llt_S_(2*robot.dimv()),
     FHinv_(Eigen::MatrixXd::Zero(2*robot.dimv(), 3*robot.dimv())),
     S_(Eigen::MatrixXd::Zero(2*robot.dimv(), 2*robot.dimv())),
+    W_(Eigen::MatrixXd::Zero(3*robot.dimv(), 2*robot.dimv())),
+    aux_mat_(Eigen::MatrixXd::Zero(2*robot.dimv(), 2*robot.dimv())),
+    coupling_mat_(Eigen::MatrixXd::Zero(2*robot.dimv(), 2*robot.dimv())),
+    u_(Eigen::VectorXd::Zero(3*robot.dimv())),
+    lmd_(Eigen::VectorXd::Zero(2*robot.dimv())),
     dimv_(robot.dimv()), 
     dimx_(2*robot.dimv()), 
     dimH_(3*robot.dimv()), 
@@ -25,6 +30,11 @@ inline UnconstrKKTMatrixInverter::UnconstrKKTMatrixInverter()
     llt_S_(),
     FHinv_(),
     S_(),
+    W_(),
+    aux_mat_(),
+    coupling_mat_(),
+    u_(),
+    lmd_(),
     dimv_(0), 
     dimx_(0), 
     dimH_(0), 
@@ -78,6 +88,101 @@ inline void UnconstrKKTMatrixInverter::invert(
           * S_ * KKT_mat_inv.topRightCorner(dimx_, dimH_);
 }
 
+
+template <typename MatrixType>
+inline void UnconstrKKTMatrixInverter::factorize(
+    const double dt, const Eigen::MatrixBase<MatrixType>& H) {
+  assert(dt > 0);
+  assert(H.rows() == dimH_);
+  assert(H.cols() == dimH_);
+  llt_H_.compute(H);
+  assert(llt_H_.info() == Eigen::Success);
+  // W = L^{-1} F^T, where H = L L^T. F^T only has the identity blocks and the
+  // identity blocks scaled by dt.
+  W_.setZero();
+  W_.block(      0, dimv_, dimv_, dimv_).diagonal().fill(dt);
+  W_.block(  dimv_,     0, dimv_, dimv_).diagonal().fill(-1);
+  W_.block(2*dimv_,     0, dimv_, dimv_).diagonal().fill(dt);
+  W_.block(2*dimv_, dimv_, dimv_, dimv_).diagonal().fill(-1);
+  llt_H_.matrixL().solveInPlace(W_);
+  // Schur complement S = F H^{-1} F^T = W^T W. Only the lower triangular 
+  // part is computed because it is all the factorization uses.
+  S_.setZero();
+  S_.template selfadjointView<Eigen::Lower>().rankUpdate(W_.transpose());
+  llt_S_.compute(S_);
+  assert(llt_S_.info() == Eigen::Success);
+  aux_mat_ = - llt_S_.solve(Eigen::MatrixXd::Identity(dimx_, dimx_));
+  // S^{-1} F H^{-1} restricted to the columns of the state (q, v). Because L 
+  // is lower triangular, L^{-1} restricted to these columns only involves the 
+  // bottom-right block of L. S_ is no longer needed and is used as the 
+  // workspace.
+  S_ = W_.bottomRows(dimx_).transpose();
+  llt_H_.matrixLLT().bottomRightCorner(dimx_, dimx_)
+      .template triangularView<Eigen::Lower>()
+      .template solveInPlace<Eigen::OnTheRight>(S_);
+  coupling_mat_.noalias() = - aux_mat_ * S_;
+}
+
+
+template <typename VectorType1, typename VectorType2>
+inline void UnconstrKKTMatrixInverter::solve(
+    const Eigen::MatrixBase<VectorType1>& kkt_res,
+    const Eigen::MatrixBase<VectorType2>& d) {
+  assert(kkt_res.size() == dimkkt_);
+  assert(d.size() == dimkkt_);
+  u_ = kkt_res.tail(dimH_);
+  llt_H_.matrixL().solveInPlace(u_);
+  lmd_.noalias() = W_.transpose() * u_;
+  lmd_.noalias() -= kkt_res.head(dimx_);
+  llt_S_.solveInPlace(lmd_);
+  u_.noalias() -= W_ * lmd_;
+  llt_H_.matrixU().solveInPlace(u_);
+  const_cast<Eigen::MatrixBase<VectorType2>&> (d).head(dimx_) = lmd_;
+  const_cast<Eigen::MatrixBase<VectorType2>&> (d).tail(dimH_) = u_;
+}
+
+
+template <typename VectorType1, typename VectorType2, typename VectorType3>
+inline void UnconstrKKTMatrixInverter::backwardCorrection(
+    const Eigen::MatrixBase<VectorType1>& x, 
+    const Eigen::MatrixBase<VectorType2>& dx,
+    const Eigen::MatrixBase<VectorType3>& d) {
+  assert(x.size() == dimx_);
+  assert(dx.size() == dimx_);
+  assert(d.size() == dimH_);
+  u_.head(dimv_).setZero();
+  u_.tail(dimx_) = x;
+  llt_H_.matrixLLT().bottomRightCorner(dimx_, dimx_)
+      .template triangularView<Eigen::Lower>().solveInPlace(u_.tail(dimx_));
+  u_.noalias() -= W_ * dx;
+  llt_H_.matrixU().solveInPlace(u_);
+  const_cast<Eigen::MatrixBase<VectorType3>&> (d) = u_;
+}
+
+
+template <typename VectorType1, typename VectorType2>
+inline void UnconstrKKTMatrixInverter::forwardCorrection(
+    const Eigen::MatrixBase<VectorType1>& x, 
+    const Eigen::MatrixBase<VectorType2>& d) {
+  assert(x.size() == dimx_);
+  assert(d.size() == dimH_);
+  lmd_.noalias() = aux_mat_ * x;
+  u_.noalias() = - W_ * lmd_;
+  llt_H_.matrixU().solveInPlace(u_);
+  const_cast<Eigen::MatrixBase<VectorType2>&> (d).head(dimx_) = lmd_;
+  const_cast<Eigen::MatrixBase<VectorType2>&> (d).tail(dimv_) = u_.head(dimv_);
+}
+
+
+inline const Eigen::MatrixXd& UnconstrKKTMatrixInverter::auxMat() const {
+  return aux_mat_;
+}
+
+
+inline const Eigen::MatrixXd& UnconstrKKTMatrixInverter::couplingMat() const {
+  return coupling_mat_;
+}
+
 } // namespace idocp 
 
 #endif // IDOCP_UNCONSTR_KKT_MATRIX_INVERTER_HXX_ 
\ No newline at end of file
@@ -93,7 +93,7 @@ public:
   /// @brief Auxiliary matrix of this time stage. 
   /// @return const reference to the auxiliary matrix of this time stage. 
   ///
-  const Eigen::Block<const Eigen::MatrixXd> auxMat() const;
+  const Eigen::MatrixXd& auxMat() const;
 
   ///
   /// @brief Performs the serial part of the backward correction. 
@@ -141,7 +141,7 @@ public:
 private:
   int dimv_, dimx_, dimkkt_;
   UnconstrKKTMatrixInverter kkt_mat_inverter_;
-  Eigen::MatrixXd H_, kkt_mat_inv_;
+  Eigen::MatrixXd H_;
   Eigen::VectorXd kkt_res_, d_, x_res_, dx_;
 
 };
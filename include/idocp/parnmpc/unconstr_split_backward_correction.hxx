@@ -14,7 +14,6 @@ inline UnconstrSplitBackwardCorrection::UnconstrSplitBackwardCorrection(
     dimkkt_(5*robot.dimv()),
     kkt_mat_inverter_(robot),
     H_(Eigen::MatrixXd::Zero(3*robot.dimv(), 3*robot.dimv())),
-    kkt_mat_inv_(Eigen::MatrixXd::Zero(5*robot.dimv(), 5*robot.dimv())),
     kkt_res_(Eigen::VectorXd::Zero(5*robot.dimv())),
     d_(Eigen::VectorXd::Zero(5*robot.dimv())),
     x_res_(Eigen::VectorXd::Zero(2*robot.dimv())),
@@ -28,7 +27,6 @@ inline UnconstrSplitBackwardCorrection::UnconstrSplitBackwardCorrection()
     dimkkt_(),
     kkt_mat_inverter_(),
     H_(),
-    kkt_mat_inv_(),
     kkt_res_(),
     d_(),
     x_res_(),
@@ -51,11 +49,11 @@ inline void UnconstrSplitBackwardCorrection::coarseUpdate(
   H_.bottomLeftCorner(dimx_, dimv_)  = kkt_matrix.Qxu; // This is actually Qxa
   H_.bottomRightCorner(dimx_, dimx_) = kkt_matrix.Qxx.transpose();
   H_.bottomRightCorner(dimx_, dimx_).noalias() += aux_mat_next;
-  kkt_mat_inverter_.invert(dt, H_, kkt_mat_inv_);
+  kkt_mat_inverter_.factorize(dt, H_);
   kkt_res_.head(dimx_)           = kkt_residual.Fx;
   kkt_res_.segment(dimx_, dimv_) = kkt_residual.la;
   kkt_res_.tail(dimx_)           = kkt_residual.lx;
-  d_.noalias() = kkt_mat_inv_ * kkt_res_;
+  kkt_mat_inverter_.solve(kkt_res_, d_);
 
   s_new.lmd = s.lmd - d_.head(dimv_);
   s_new.gmm = s.gmm - d_.segment(dimv_, dimv_);
@@ -72,11 +70,11 @@ inline void UnconstrSplitBackwardCorrection::coarseUpdate(
   H_.topLeftCorner(dimv_, dimv_)     = kkt_matrix.Qaa;
   H_.bottomLeftCorner(dimx_, dimv_)  = kkt_matrix.Qxu; // This is actually Qxa
   H_.bottomRightCorner(dimx_, dimx_) = kkt_matrix.Qxx.transpose();
-  kkt_mat_inverter_.invert(dt, H_, kkt_mat_inv_);
+  kkt_mat_inverter_.factorize(dt, H_);
   kkt_res_.head(dimx_)           = kkt_residual.Fx;
   kkt_res_.segment(dimx_, dimv_) = kkt_residual.la;
   kkt_res_.tail(dimx_)           = kkt_residual.lx;
-  d_.noalias() = kkt_mat_inv_ * kkt_res_;
+  kkt_mat_inverter_.solve(kkt_res_, d_);
 
   s_new.lmd = s.lmd - d_.head(dimv_);
   s_new.gmm = s.gmm - d_.segment(dimv_, dimv_);
@@ -86,9 +84,9 @@ inline void UnconstrSplitBackwardCorrection::coarseUpdate(
 }
 
 
-inline const Eigen::Block<const Eigen::MatrixXd> 
+inline const Eigen::MatrixXd& 
 UnconstrSplitBackwardCorrection::auxMat() const {
-  return kkt_mat_inv_.topLeftCorner(dimx_, dimx_);
+  return kkt_mat_inverter_.auxMat();
 }
 
 
@@ -97,7 +95,7 @@ inline void UnconstrSplitBackwardCorrection::backwardCorrectionSerial(
     SplitSolution& s_new) {
   x_res_.head(dimv_) = s_new_next.lmd - s_next.lmd;
   x_res_.tail(dimv_) = s_new_next.gmm - s_next.gmm;
-  dx_.noalias() = kkt_mat_inv_.block(0, dimkkt_-dimx_, dimx_, dimx_) * x_res_;
+  dx_.noalias() = kkt_mat_inverter_.couplingMat() * x_res_;
   s_new.lmd.noalias() -= dx_.head(dimv_);
   s_new.gmm.noalias() -= dx_.tail(dimv_);
 }
@@ -105,8 +103,7 @@ inline void UnconstrSplitBackwardCorrection::backwardCorrectionSerial(
 
 inline void UnconstrSplitBackwardCorrection::backwardCorrectionParallel(
     SplitSolution& s_new) {
-  d_.tail(dimkkt_-dimx_).noalias()
-      = kkt_mat_inv_.block(dimx_, dimkkt_-dimx_, dimkkt_-dimx_, dimx_) * x_res_;
+  kkt_mat_inverter_.backwardCorrection(x_res_, dx_, d_.tail(dimkkt_-dimx_));
   s_new.a.noalias() -= d_.segment(2*dimv_, dimv_);
   s_new.q.noalias() -= d_.segment(3*dimv_, dimv_);
   s_new.v.noalias() -= d_.tail(dimv_);
@@ -118,7 +115,7 @@ inline void UnconstrSplitBackwardCorrection::forwardCorrectionSerial(
     SplitSolution& s_new) {
   x_res_.head(dimv_) = s_new_prev.q - s_prev.q;
   x_res_.tail(dimv_) = s_new_prev.v - s_prev.v;
-  dx_.noalias() = kkt_mat_inv_.block(dimkkt_-dimx_, 0, dimx_, dimx_) * x_res_;
+  dx_.noalias() = kkt_mat_inverter_.couplingMat().transpose() * x_res_;
   s_new.q.noalias() -= dx_.head(dimv_);
   s_new.v.noalias() -= dx_.tail(dimv_);
 }
@@ -126,8 +123,7 @@ inline void UnconstrSplitBackwardCorrection::forwardCorrectionSerial(
 
 inline void UnconstrSplitBackwardCorrection::forwardCorrectionParallel(
     SplitSolution& s_new) {
-  d_.head(dimkkt_-dimx_).noalias()
-      = kkt_mat_inv_.topLeftCorner(dimkkt_-dimx_, dimx_) * x_res_;
+  kkt_mat_inverter_.forwardCorrection(x_res_, d_.head(dimkkt_-dimx_));
   s_new.lmd.noalias() -= d_.head(dimv_);
   s_new.gmm.noalias() -= d_.segment(dimv_, dimv_);
   s_new.a.noalias()   -= d_.segment(2*dimv_, dimv_);
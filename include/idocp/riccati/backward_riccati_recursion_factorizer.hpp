@@ -22,6 +22,8 @@ class BackwardRiccatiRecursionFactorizer {
 public:
   using MatrixXdRowMajor 
       = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using MatrixXfRowMajor 
+      = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
 
   ///
   /// @brief Constructs a factorizer.
@@ -111,10 +113,99 @@ public:
       const ImpulseSplitKKTResidual& kkt_residual, 
       SplitRiccatiFactorization& riccati);
 
+  ///
+  /// @brief Factorizes the blocks of the split KKT matrix with respect to the
+  /// control input, i.e., Qxu and Quu, without factorizing Qxx. Used when the 
+  /// Riccati factorization matrix of this time stage is reused.
+  /// @param[in] riccati_next Riccati factorization of the next time stage.
+  /// @param[in, out] kkt_matrix Split KKT matrix of this time stage.
+  ///
+  void factorizeInputKKTMatrix(const SplitRiccatiFactorization& riccati_next, 
+                               SplitKKTMatrix& kkt_matrix);
+
+  ///
+  /// @brief Factorizes the split KKT residual of a time stage for the backward
+  /// Riccati recursion that reuses the Riccati factorization matrices.
+  /// @param[in] riccati_next Riccati factorization of the next time stage.
+  /// @param[in] kkt_matrix Split KKT matrix of this time stage.
+  /// @param[in, out] kkt_residual Split KKT residual of this time stage.
+  ///
+  void factorizeKKTResidual(const SplitRiccatiFactorization& riccati_next, 
+                            const SplitKKTMatrix& kkt_matrix,
+                            SplitKKTResidual& kkt_residual);
+
+  ///
+  /// @brief Factorizes the Riccati factorization vector. 
+  /// BackwardRiccatiRecursionFactorizer::factorizeKKTResidual() must be 
+  /// called before calling this function.
+  /// @param[in] kkt_matrix Split KKT matrix of this time stage.
+  /// @param[in] kkt_residual Split KKT residual of this time stage.
+  /// @param[in] lqr_policy The state feedback control policy of the LQR 
+  /// subproblem.
+  /// @param[out] riccati The Riccati factorization of this time stage.
+  ///
+  void factorizeRiccatiVector(const SplitKKTMatrix& kkt_matrix, 
+                              const SplitKKTResidual& kkt_residual, 
+                              const LQRPolicy& lqr_policy, 
+                              SplitRiccatiFactorization& riccati);
+
+  ///
+  /// @brief Factorizes the Riccati factorization vector of an impulse stage.
+  /// @param[in] riccati_next Riccati factorization of the next time stage.
+  /// @param[in] kkt_matrix Split KKT matrix of this impulse stage. 
+  /// @param[in] kkt_residual Split KKT residual of this impulse stage.
+  /// @param[out] riccati The Riccati factorization of this impulse stage.
+  ///
+  void factorizeRiccatiVector(const SplitRiccatiFactorization& riccati_next, 
+                              const ImpulseSplitKKTMatrix& kkt_matrix, 
+                              const ImpulseSplitKKTResidual& kkt_residual, 
+                              SplitRiccatiFactorization& riccati);
+
+  ///
+  /// @brief Enables or disables the mixed-precision factorization. If 
+  /// enabled, the products of the Riccati factorization matrix and the 
+  /// Jacobians of the state equation, which dominate the cost of the 
+  /// backward recursion, are computed in single precision and accumulated 
+  /// to the split KKT matrix in double precision. The KKT residual and the 
+  /// Riccati factorization vector are always computed in double precision, 
+  /// so the error only perturbs the Hessian and the Newton-type iteration 
+  /// still converges to the solution of the double-precision problem. A 
+  /// stage whose single-precision products are not finite is factorized in 
+  /// double precision. Default is false.
+  /// @param[in] mixed_precision If true, the mixed-precision factorization 
+  /// is enabled. 
+  ///
+  void setMixedPrecision(const bool mixed_precision);
+
+  ///
+  /// @return true if the mixed-precision factorization is enabled. false if 
+  /// not.
+  ///
+  bool isMixedPrecision() const;
+
 private:
   int dimv_, dimu_;
   MatrixXdRowMajor AtP_, BtP_;
   Eigen::MatrixXd GK_;
+  Eigen::VectorXd sPFx_;
+  bool mixed_precision_;
+  MatrixXfRowMajor AtPf_, BtPf_;
+  Eigen::MatrixXf Pf_, Fxxf_, Fvuf_, Qxxf_, Qxuf_, Quuf_;
+
+  void factorizeF(const SplitRiccatiFactorization& riccati_next, 
+                  const Eigen::MatrixXd& Fxx, Eigen::MatrixXd& Qxx);
+
+  void factorizeHG(const SplitRiccatiFactorization& riccati_next, 
+                   const Eigen::MatrixXd& Fvu, Eigen::MatrixXd& Qxu, 
+                   Eigen::MatrixXd& Quu);
+
+  bool factorizeKKTMatrixInSinglePrecision(
+      const SplitRiccatiFactorization& riccati_next, SplitKKTMatrix& kkt_matrix,
+      const bool factorize_Qxx);
+
+  bool factorizeKKTMatrixInSinglePrecision(
+      const SplitRiccatiFactorization& riccati_next, 
+      ImpulseSplitKKTMatrix& kkt_matrix);
 
 };
 
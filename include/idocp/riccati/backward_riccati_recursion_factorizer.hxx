@@ -2,6 +2,9 @@
 #define IDOCP_BACKWARD_RICCATI_RECURSION_FACTORIZER_HXX_
 
 #include "idocp/riccati/backward_riccati_recursion_factorizer.hpp"
+#include "idocp/utils/simd_kernels.hpp"
+
+#include <cassert>
 
 namespace idocp {
 
@@ -11,7 +14,17 @@ inline BackwardRiccatiRecursionFactorizer::BackwardRiccatiRecursionFactorizer(
     dimu_(robot.dimu()),
     AtP_(MatrixXdRowMajor::Zero(2*robot.dimv(), 2*robot.dimv())),
     BtP_(MatrixXdRowMajor::Zero(robot.dimu(), 2*robot.dimv())),
-    GK_(Eigen::MatrixXd::Zero(robot.dimu(), 2*robot.dimv())) {
+    GK_(Eigen::MatrixXd::Zero(robot.dimu(), 2*robot.dimv())),
+    sPFx_(Eigen::VectorXd::Zero(2*robot.dimv())),
+    mixed_precision_(false),
+    AtPf_(),
+    BtPf_(),
+    Pf_(),
+    Fxxf_(),
+    Fvuf_(),
+    Qxxf_(),
+    Qxuf_(),
+    Quuf_() {
 }
 
 
@@ -20,7 +33,17 @@ inline BackwardRiccatiRecursionFactorizer::BackwardRiccatiRecursionFactorizer()
     dimu_(0),
     AtP_(),
     BtP_(),
-    GK_() {
+    GK_(),
+    sPFx_(),
+    mixed_precision_(false),
+    AtPf_(),
+    BtPf_(),
+    Pf_(),
+    Fxxf_(),
+    Fvuf_(),
+    Qxxf_(),
+    Qxuf_(),
+    Quuf_() {
 }
 
 
@@ -32,14 +55,17 @@ inline BackwardRiccatiRecursionFactorizer::
 inline void BackwardRiccatiRecursionFactorizer::factorizeKKTMatrix(
     const SplitRiccatiFactorization& riccati_next, 
     SplitKKTMatrix& kkt_matrix, SplitKKTResidual& kkt_residual) {
-  AtP_.noalias() = kkt_matrix.Fxx.transpose() * riccati_next.P;
-  BtP_.noalias() = kkt_matrix.Fvu.transpose() * riccati_next.P.bottomRows(dimv_);
-  // Factorize F
-  kkt_matrix.Qxx.noalias() += AtP_ * kkt_matrix.Fxx;
-  // Factorize H
-  kkt_matrix.Qxu.noalias() += AtP_.rightCols(dimv_) * kkt_matrix.Fvu;
-  // Factorize G
-  kkt_matrix.Quu.noalias() += BtP_.rightCols(dimv_) * kkt_matrix.Fvu;
+  if (mixed_precision_) {
+    if (!factorizeKKTMatrixInSinglePrecision(riccati_next, kkt_matrix, true)) {
+      factorizeF(riccati_next, kkt_matrix.Fxx, kkt_matrix.Qxx);
+      factorizeHG(riccati_next, kkt_matrix.Fvu, kkt_matrix.Qxu, kkt_matrix.Quu);
+    }
+    // The vector term is computed without the single-precision products.
+    factorizeKKTResidual(riccati_next, kkt_matrix, kkt_residual);
+    return;
+  }
+  factorizeF(riccati_next, kkt_matrix.Fxx, kkt_matrix.Qxx);
+  factorizeHG(riccati_next, kkt_matrix.Fvu, kkt_matrix.Qxu, kkt_matrix.Quu);
   // Factorize vector term
   kkt_residual.lu.noalias() += BtP_ * kkt_residual.Fx;
   kkt_residual.lu.noalias() -= kkt_matrix.Fvu.transpose() * riccati_next.sv();
@@ -49,9 +75,11 @@ inline void BackwardRiccatiRecursionFactorizer::factorizeKKTMatrix(
 inline void BackwardRiccatiRecursionFactorizer::factorizeKKTMatrix(
     const SplitRiccatiFactorization& riccati_next, 
     ImpulseSplitKKTMatrix& kkt_matrix) {
-  AtP_.noalias() = kkt_matrix.Fxx.transpose() * riccati_next.P;
-  // Factorize F
-  kkt_matrix.Qxx.noalias() += AtP_ * kkt_matrix.Fxx;
+  if (mixed_precision_ 
+      && factorizeKKTMatrixInSinglePrecision(riccati_next, kkt_matrix)) {
+    return;
+  }
+  factorizeF(riccati_next, kkt_matrix.Fxx, kkt_matrix.Qxx);
 }
 
 
@@ -64,8 +92,13 @@ inline void BackwardRiccatiRecursionFactorizer::factorizeRiccatiFactorization(
   // Riccati factorization matrix with preserving the symmetry
   riccati.P = 0.5 * (kkt_matrix.Qxx + kkt_matrix.Qxx.transpose());
   // Riccati factorization vector
-  riccati.s.noalias()  = kkt_matrix.Fxx.transpose() * riccati_next.s;
-  riccati.s.noalias() -= AtP_ * kkt_residual.Fx;
+  if (mixed_precision_) {
+    riccati.s.noalias()  = kkt_matrix.Fxx.transpose() * sPFx_;
+  }
+  else {
+    riccati.s.noalias()  = kkt_matrix.Fxx.transpose() * riccati_next.s;
+    riccati.s.noalias() -= AtP_ * kkt_residual.Fx;
+  }
   riccati.s.noalias() -= kkt_residual.lx;
   riccati.s.noalias() -= kkt_matrix.Qxu * lqr_policy.k;
 }
@@ -79,11 +112,180 @@ inline void BackwardRiccatiRecursionFactorizer::factorizeRiccatiFactorization(
   // Riccati factorization matrix with preserving the symmetry
   riccati.P = 0.5 * (kkt_matrix.Qxx + kkt_matrix.Qxx.transpose());
   // Riccati factorization vector
+  if (mixed_precision_) {
+    factorizeRiccatiVector(riccati_next, kkt_matrix, kkt_residual, riccati);
+    return;
+  }
   riccati.s.noalias()  = kkt_matrix.Fxx.transpose() * riccati_next.s;
   riccati.s.noalias() -= AtP_ * kkt_residual.Fx;
   riccati.s.noalias() -= kkt_residual.lx;
 }
 
+
+inline void BackwardRiccatiRecursionFactorizer::factorizeInputKKTMatrix(
+    const SplitRiccatiFactorization& riccati_next, 
+    SplitKKTMatrix& kkt_matrix) {
+  if (mixed_precision_ 
+      && factorizeKKTMatrixInSinglePrecision(riccati_next, kkt_matrix, false)) {
+    return;
+  }
+  // AtP_.rightCols(dimv_) = Fxx^T * P.rightCols(dimv_), i.e., the bottom 
+  // rows of the column-major AtP_^T. 
+  simd::gemmTN(dimv_, 2*dimv_, 2*dimv_, 1.0, 
+               riccati_next.P.data()+dimv_*riccati_next.P.outerStride(), 
+               riccati_next.P.outerStride(), 
+               kkt_matrix.Fxx.data(), kkt_matrix.Fxx.outerStride(), 
+               0.0, AtP_.data()+dimv_, AtP_.outerStride());
+  factorizeHG(riccati_next, kkt_matrix.Fvu, kkt_matrix.Qxu, kkt_matrix.Quu);
+}
+
+
+inline void BackwardRiccatiRecursionFactorizer::factorizeKKTResidual(
+    const SplitRiccatiFactorization& riccati_next, 
+    const SplitKKTMatrix& kkt_matrix, SplitKKTResidual& kkt_residual) {
+  sPFx_ = riccati_next.s;
+  sPFx_.noalias() -= riccati_next.P * kkt_residual.Fx;
+  // Factorize vector term
+  kkt_residual.lu.noalias() -= kkt_matrix.Fvu.transpose() * sPFx_.tail(dimv_);
+}
+
+
+inline void BackwardRiccatiRecursionFactorizer::factorizeRiccatiVector(
+    const SplitKKTMatrix& kkt_matrix, const SplitKKTResidual& kkt_residual, 
+    const LQRPolicy& lqr_policy, SplitRiccatiFactorization& riccati) {
+  // Since the gain is K = - Quu^{-1} Qxu^T, Qxu k equals K^T lu. 
+  riccati.s.noalias()  = kkt_matrix.Fxx.transpose() * sPFx_;
+  riccati.s.noalias() -= kkt_residual.lx;
+  riccati.s.noalias() -= lqr_policy.K.transpose() * kkt_residual.lu;
+}
+
+
+inline void BackwardRiccatiRecursionFactorizer::factorizeRiccatiVector(
+    const SplitRiccatiFactorization& riccati_next, 
+    const ImpulseSplitKKTMatrix& kkt_matrix, 
+    const ImpulseSplitKKTResidual& kkt_residual, 
+    SplitRiccatiFactorization& riccati) {
+  sPFx_ = riccati_next.s;
+  sPFx_.noalias() -= riccati_next.P * kkt_residual.Fx;
+  riccati.s.noalias()  = kkt_matrix.Fxx.transpose() * sPFx_;
+  riccati.s.noalias() -= kkt_residual.lx;
+}
+
+
+inline void BackwardRiccatiRecursionFactorizer::factorizeF(
+    const SplitRiccatiFactorization& riccati_next, const Eigen::MatrixXd& Fxx,
+    Eigen::MatrixXd& Qxx) {
+  assert(Fxx.rows() == 2*dimv_);
+  assert(Fxx.cols() == 2*dimv_);
+  assert(Qxx.rows() == 2*dimv_);
+  assert(Qxx.cols() == 2*dimv_);
+  // The row-major AtP_ is stored as the column-major AtP_^T = P^T * Fxx. 
+  simd::gemmTN(2*dimv_, 2*dimv_, 2*dimv_, 1.0, 
+               riccati_next.P.data(), riccati_next.P.outerStride(), 
+               Fxx.data(), Fxx.outerStride(), 
+               0.0, AtP_.data(), AtP_.outerStride());
+  // Qxx += AtP_ * Fxx 
+  simd::gemmTN(2*dimv_, 2*dimv_, 2*dimv_, 1.0, 
+               AtP_.data(), AtP_.outerStride(), Fxx.data(), Fxx.outerStride(), 
+               1.0, Qxx.data(), Qxx.outerStride());
+}
+
+
+inline void BackwardRiccatiRecursionFactorizer::factorizeHG(
+    const SplitRiccatiFactorization& riccati_next, const Eigen::MatrixXd& Fvu,
+    Eigen::MatrixXd& Qxu, Eigen::MatrixXd& Quu) {
+  assert(Fvu.rows() == dimv_);
+  assert(Fvu.cols() == dimu_);
+  assert(Qxu.rows() == 2*dimv_);
+  assert(Qxu.cols() == dimu_);
+  assert(Quu.rows() == dimu_);
+  assert(Quu.cols() == dimu_);
+  // The row-major BtP_ is stored as the column-major 
+  // BtP_^T = P.bottomRows(dimv_)^T * Fvu. 
+  simd::gemmTN(2*dimv_, dimu_, dimv_, 1.0, 
+               riccati_next.P.data()+dimv_, riccati_next.P.outerStride(), 
+               Fvu.data(), Fvu.outerStride(), 
+               0.0, BtP_.data(), BtP_.outerStride());
+  // Qxu += AtP_.rightCols(dimv_) * Fvu 
+  simd::gemmTN(2*dimv_, dimu_, dimv_, 1.0, 
+               AtP_.data()+dimv_, AtP_.outerStride(), 
+               Fvu.data(), Fvu.outerStride(), 
+               1.0, Qxu.data(), Qxu.outerStride());
+  // Quu += BtP_.rightCols(dimv_) * Fvu 
+  simd::gemmTN(dimu_, dimu_, dimv_, 1.0, 
+               BtP_.data()+dimv_, BtP_.outerStride(), 
+               Fvu.data(), Fvu.outerStride(), 
+               1.0, Quu.data(), Quu.outerStride());
+}
+
+
+inline void BackwardRiccatiRecursionFactorizer::setMixedPrecision(
+    const bool mixed_precision) {
+  mixed_precision_ = mixed_precision;
+  if (mixed_precision_) {
+    AtPf_.resize(2*dimv_, 2*dimv_);
+    BtPf_.resize(dimu_, 2*dimv_);
+    Pf_.resize(2*dimv_, 2*dimv_);
+    Fxxf_.resize(2*dimv_, 2*dimv_);
+    Fvuf_.resize(dimv_, dimu_);
+    Qxxf_.resize(2*dimv_, 2*dimv_);
+    Qxuf_.resize(2*dimv_, dimu_);
+    Quuf_.resize(dimu_, dimu_);
+  }
+}
+
+
+inline bool BackwardRiccatiRecursionFactorizer::isMixedPrecision() const {
+  return mixed_precision_;
+}
+
+
+inline bool 
+BackwardRiccatiRecursionFactorizer::factorizeKKTMatrixInSinglePrecision(
+    const SplitRiccatiFactorization& riccati_next, SplitKKTMatrix& kkt_matrix,
+    const bool factorize_Qxx) {
+  Pf_ = riccati_next.P.cast<float>();
+  Fxxf_ = kkt_matrix.Fxx.cast<float>();
+  Fvuf_ = kkt_matrix.Fvu.cast<float>();
+  if (factorize_Qxx) {
+    AtPf_.noalias() = Fxxf_.transpose() * Pf_;
+    Qxxf_.noalias() = AtPf_ * Fxxf_;
+  }
+  else {
+    AtPf_.rightCols(dimv_).noalias() = Fxxf_.transpose() * Pf_.rightCols(dimv_);
+  }
+  BtPf_.noalias() = Fvuf_.transpose() * Pf_.bottomRows(dimv_);
+  Qxuf_.noalias() = AtPf_.rightCols(dimv_) * Fvuf_;
+  Quuf_.noalias() = BtPf_.rightCols(dimv_) * Fvuf_;
+  // Falls back to double precision, e.g., if the products overflow.
+  if (!Qxuf_.allFinite() || !Quuf_.allFinite() 
+      || (factorize_Qxx && !Qxxf_.allFinite())) {
+    return false;
+  }
+  if (factorize_Qxx) {
+    kkt_matrix.Qxx.noalias() += Qxxf_.cast<double>();
+  }
+  kkt_matrix.Qxu.noalias() += Qxuf_.cast<double>();
+  kkt_matrix.Quu.noalias() += Quuf_.cast<double>();
+  return true;
+}
+
+
+inline bool 
+BackwardRiccatiRecursionFactorizer::factorizeKKTMatrixInSinglePrecision(
+    const SplitRiccatiFactorization& riccati_next, 
+    ImpulseSplitKKTMatrix& kkt_matrix) {
+  Pf_ = riccati_next.P.cast<float>();
+  Fxxf_ = kkt_matrix.Fxx.cast<float>();
+  AtPf_.noalias() = Fxxf_.transpose() * Pf_;
+  Qxxf_.noalias() = AtPf_ * Fxxf_;
+  if (!Qxxf_.allFinite()) {
+    return false;
+  }
+  kkt_matrix.Qxx.noalias() += Qxxf_.cast<double>();
+  return true;
+}
+
 } // namespace idocp
 
 #endif // IDOCP_BACKWARD_RICCATI_RECURSION_FACTORIZER_HXX_ 
\ No newline at end of file
@@ -0,0 +1,27 @@
+#ifndef IDOCP_ITERATION_LEVEL_HPP_
+#define IDOCP_ITERATION_LEVEL_HPP_
+
+
+namespace idocp {
+
+///
+/// @enum IterationLevel
+/// @brief Level of the multi-level iteration, i.e., how much of the KKT 
+/// system and the Riccati factorization is recomputed in the current 
+/// iteration. Full evaluates the whole KKT system and recomputes the Riccati 
+/// factorization matrices P, the state feedback gains K, and the vectors s 
+/// and k. Jacobian reuses the Hessians of the KKT system and P, evaluates the 
+/// gradients and the Jacobians, and recomputes K, s, and k. Residual reuses 
+/// the Hessians and the Jacobians of the KKT system, P, K, and the Cholesky 
+/// factorizations of the condensed Hessians with respect to the control 
+/// input, evaluates only the KKT residual, and recomputes only s and k.
+///
+enum class IterationLevel {
+  Full,
+  Jacobian,
+  Residual
+};
+
+} // namespace idocp
+
+#endif // IDOCP_ITERATION_LEVEL_HPP_
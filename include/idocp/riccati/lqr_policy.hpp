@@ -2,6 +2,7 @@
 #define IDOCP_LQR_POLICY_HPP_
 
 #include "Eigen/Core"
+#include "Eigen/Cholesky"
 
 #include "idocp/robot/robot.hpp"
 
@@ -25,6 +26,8 @@ public:
   LQRPolicy(const Robot& robot)
     : K(MatrixXdRowMajor::Zero(robot.dimu(), 2*robot.dimv())),
       k(Eigen::VectorXd::Zero(robot.dimu())),
+      G(Eigen::MatrixXd::Zero(robot.dimu(), robot.dimu())),
+      G_llt(robot.dimu()),
       dimv_(robot.dimv()),
       dimu_(robot.dimu()) {
   }
@@ -35,6 +38,8 @@ public:
   LQRPolicy() 
     : K(),
       k(),
+      G(),
+      G_llt(),
       dimv_(0),
       dimu_(0) {
   }
@@ -76,6 +81,22 @@ public:
   ///
   Eigen::VectorXd k;
 
+  ///
+  /// @brief Condensed Hessian with respect to the control input including 
+  /// the regularization, i.e., the matrix factorized in G_llt. Stored so that
+  /// G_llt can be restored exactly, e.g., from the snapshot of OCPSolver. 
+  /// Size is Robot::dimu() x Robot::dimu().
+  ///
+  Eigen::MatrixXd G;
+
+  ///
+  /// @brief Cholesky factorization of the condensed Hessian with respect to 
+  /// the control input from which K and k are computed. Stored so that k can 
+  /// be updated without refactorizing the Hessian, e.g., by RiccatiFactorizer
+  /// with IterationLevel::Residual. Size is Robot::dimu() x Robot::dimu().
+  ///
+  Eigen::LLT<Eigen::MatrixXd> G_llt;
+
   ///
   /// @brief State feedback gain matrix w.r.t. the configuration q. Size is 
   /// Robot::dimu() x Robot::dimv().
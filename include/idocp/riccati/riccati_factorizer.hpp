@@ -1,8 +1,11 @@
 #ifndef IDOCP_RICCATI_FACTORIZER_HPP_ 
 #define IDOCP_RICCATI_FACTORIZER_HPP_
 
+#include <iostream>
+
 #include "Eigen/Core"
 #include "Eigen/LU"
+#include "Eigen/Cholesky"
 
 #include "idocp/robot/robot.hpp"
 #include "idocp/ocp/split_kkt_matrix.hpp"
@@ -17,6 +20,7 @@
 #include "idocp/riccati/lqr_policy.hpp"
 #include "idocp/riccati/backward_riccati_recursion_factorizer.hpp"
 #include "idocp/riccati/split_constrained_riccati_factorization.hpp"
+#include "idocp/riccati/iteration_level.hpp"
 
 #include <limits>
 #include <cmath>
@@ -113,6 +117,69 @@ public:
                                 ImpulseSplitKKTResidual& kkt_residual, 
                                 SplitRiccatiFactorization& riccati);
 
+  ///
+  /// @brief Performs the backward Riccati recursion of the specified level of
+  /// the multi-level iteration. 
+  /// @param[in] riccati_next Riccati factorization of the next stage. 
+  /// @param[in, out] kkt_matrix Split KKT matrix of this stage. 
+  /// @param[in, out] kkt_residual Split KKT residual of this stage. 
+  /// @param[in, out] riccati Riccati factorization of this stage. riccati.P 
+  /// must be computed in a previous iteration unless level is 
+  /// IterationLevel::Full.
+  /// @param[in, out] lqr_policy LQR policy of this stage. lqr_policy.K and
+  /// lqr_policy.G_llt must be computed in a previous iteration if level is 
+  /// IterationLevel::Residual.
+  /// @param[in] level Level of the iteration. 
+  ///
+  void backwardRiccatiRecursion(const SplitRiccatiFactorization& riccati_next, 
+                                SplitKKTMatrix& kkt_matrix, 
+                                SplitKKTResidual& kkt_residual,  
+                                SplitRiccatiFactorization& riccati,
+                                LQRPolicy& lqr_policy, 
+                                const IterationLevel level);
+
+  ///
+  /// @brief Performs the backward Riccati recursion with the switching 
+  /// constraint of the specified level of the multi-level iteration. Only 
+  /// IterationLevel::Residual reuses the factorization, i.e., 
+  /// lqr_policy.K, lqr_policy.G_llt, and c_riccati computed in a previous 
+  /// iteration. The other levels perform the full recursion of this stage.
+  /// @param[in] riccati_next Riccati factorization of the next stage. 
+  /// @param[in, out] kkt_matrix Split KKT matrix of this stage. 
+  /// @param[in, out] kkt_residual Split KKT residual of this stage. 
+  /// @param[in] sc_jacobian Jacobian of the switching constraint. 
+  /// @param[in] sc_residual Residual of the switching constraint. 
+  /// @param[in, out] riccati Riccati factorization of this stage. 
+  /// @param[in, out] c_riccati Riccati factorization for the switching 
+  /// constraint. 
+  /// @param[in, out] lqr_policy LQR policy of this stage. 
+  /// @param[in] level Level of the iteration. 
+  ///
+  void backwardRiccatiRecursion(
+      const SplitRiccatiFactorization& riccati_next, 
+      SplitKKTMatrix& kkt_matrix, SplitKKTResidual& kkt_residual, 
+      const SplitSwitchingConstraintJacobian& sc_jacobian, 
+      const SplitSwitchingConstraintResidual& sc_residual, 
+      SplitRiccatiFactorization& riccati, 
+      SplitConstrainedRiccatiFactorization& c_riccati, LQRPolicy& lqr_policy,
+      const IterationLevel level);
+
+  ///
+  /// @brief Performs the backward Riccati recursion of the specified level of
+  /// the multi-level iteration. The Riccati factorization matrix is reused
+  /// unless level is IterationLevel::Full. 
+  /// @param[in] riccati_next Riccati factorization of the next stage. 
+  /// @param[in, out] kkt_matrix Split KKT matrix of this impulse stage. 
+  /// @param[in, out] kkt_residual Split KKT residual of this impulse stage. 
+  /// @param[in, out] riccati Riccati factorization of this impulse stage. 
+  /// @param[in] level Level of the iteration. 
+  ///
+  void backwardRiccatiRecursion(const SplitRiccatiFactorization& riccati_next, 
+                                ImpulseSplitKKTMatrix& kkt_matrix, 
+                                ImpulseSplitKKTResidual& kkt_residual, 
+                                SplitRiccatiFactorization& riccati,
+                                const IterationLevel level);
+
   ///
   /// @brief Performs the forward Riccati recursion and computes the state 
   /// direction. 
@@ -160,14 +227,90 @@ public:
       const SplitConstrainedRiccatiFactorization& c_riccati,
       SplitDirection& d);
 
+  ///
+  /// @brief Sets the parameters of the adaptive Levenberg-Marquardt 
+  /// regularization. If the Cholesky factorization of Quu or of the Schur 
+  /// complement of the switching constraint fails, a multiple of the identity
+  /// is added to the matrix and the factorization is retried, increasing the
+  /// multiple by regularization_factor until the factorization succeeds or the
+  /// multiple reaches max_regularization. The multiple required by a stage is 
+  /// used as the initial guess of the next failing stage and decreases by 
+  /// regularization_factor for every stage that succeeds without it. If the
+  /// factorization still fails with max_regularization, 
+  /// RiccatiFactorizer::hasFailed() becomes true.
+  /// @param[in] min_regularization Initial regularization. Must be positive.
+  /// Default is 1.0e-08.
+  /// @param[in] max_regularization Maximum regularization. Must be larger than
+  /// min_regularization. Default is 1.0e+08.
+  /// @param[in] regularization_factor Factor of the increase and the decrease
+  /// of the regularization. Must be larger than 1. Default is 10.
+  ///
+  void setRegularizationParameters(const double min_regularization, 
+                                   const double max_regularization,
+                                   const double regularization_factor);
+
+  ///
+  /// @brief Returns the largest regularization added to the KKT matrices 
+  /// since the last call of RiccatiFactorizer::resetRegularization(). 
+  /// @return The largest regularization. Zero if no factorization has failed.
+  ///
+  double regularization() const;
+
+  ///
+  /// @brief Resets the regularization returned by 
+  /// RiccatiFactorizer::regularization(). 
+  ///
+  void resetRegularization();
+
+  ///
+  /// @brief Checks if a factorization has failed since the last call of 
+  /// RiccatiFactorizer::resetFailure(), i.e., if a Hessian was not positive 
+  /// definite even with the maximum regularization. The LQR policy of the 
+  /// failed stage and of the preceding stages is then invalid.
+  /// @return true if a factorization has failed. false if not.
+  ///
+  bool hasFailed() const;
+
+  ///
+  /// @brief Resets the flag returned by RiccatiFactorizer::hasFailed(). 
+  ///
+  void resetFailure();
+
+  ///
+  /// @brief Enables or disables the mixed-precision factorization of the 
+  /// backward Riccati recursion. See 
+  /// BackwardRiccatiRecursionFactorizer::setMixedPrecision() for details.
+  /// @param[in] mixed_precision If true, the mixed-precision factorization 
+  /// is enabled. 
+  ///
+  void setMixedPrecision(const bool mixed_precision);
+
+  ///
+  /// @brief Writes the regularization adapted over the iterations to the 
+  /// binary stream.
+  /// @param[in, out] os Output binary stream.
+  ///
+  void saveRegularization(std::ostream& os) const;
+
+  ///
+  /// @brief Reads the regularization adapted over the iterations from the 
+  /// binary stream. Throws std::runtime_error if the stream is broken.
+  /// @param[in, out] is Input binary stream.
+  ///
+  void loadRegularization(std::istream& is);
+
 private:
   bool has_floating_base_;
   int dimv_, dimu_;
   static constexpr int kDimFloatingBase = 6;
-  Eigen::LLT<Eigen::MatrixXd> llt_, llt_s_;
-  LQRPolicy lqr_policy_;
+  double reg_, reg_min_, reg_max_, reg_factor_, max_reg_;
+  bool has_failed_;
   BackwardRiccatiRecursionFactorizer backward_recursion_;
 
+  template <typename MatrixType>
+  void computeRegularizedCholesky(Eigen::LLT<Eigen::MatrixXd>& llt, 
+                                  const Eigen::MatrixBase<MatrixType>& H);
+
 };
 
 } // namespace idocp
@@ -4,6 +4,11 @@
 #include "idocp/riccati/riccati_factorizer.hpp"
 
 #include <cassert>
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+
+#include "idocp/utils/binary_io.hpp"
 
 namespace idocp {
 
@@ -11,8 +16,12 @@ inline RiccatiFactorizer::RiccatiFactorizer(const Robot& robot)
   : has_floating_base_(robot.hasFloatingBase()),
     dimv_(robot.dimv()),
     dimu_(robot.dimu()),
-    llt_(robot.dimu()),
-    llt_s_(),
+    reg_(0),
+    reg_min_(1.0e-08),
+    reg_max_(1.0e+08),
+    reg_factor_(10),
+    max_reg_(0),
+    has_failed_(false),
     backward_recursion_(robot) {
 }
 
@@ -21,8 +30,12 @@ inline RiccatiFactorizer::RiccatiFactorizer()
   : has_floating_base_(false),
     dimv_(0),
     dimu_(0),
-    llt_(),
-    llt_s_(),
+    reg_(0),
+    reg_min_(1.0e-08),
+    reg_max_(1.0e+08),
+    reg_factor_(10),
+    max_reg_(0),
+    has_failed_(false),
     backward_recursion_() {
 }
 
@@ -37,10 +50,10 @@ inline void RiccatiFactorizer::backwardRiccatiRecursion(
     SplitRiccatiFactorization& riccati, LQRPolicy& lqr_policy) {
   backward_recursion_.factorizeKKTMatrix(riccati_next, kkt_matrix, 
                                          kkt_residual);
-  llt_.compute(kkt_matrix.Quu);
-  assert(llt_.info() == Eigen::Success);
-  lqr_policy.K.noalias() = - llt_.solve(kkt_matrix.Qxu.transpose());
-  lqr_policy.k.noalias() = - llt_.solve(kkt_residual.lu);
+  computeRegularizedCholesky(lqr_policy.G_llt, kkt_matrix.Quu);
+  lqr_policy.G = kkt_matrix.Quu;
+  lqr_policy.K.noalias() = - lqr_policy.G_llt.solve(kkt_matrix.Qxu.transpose());
+  lqr_policy.k.noalias() = - lqr_policy.G_llt.solve(kkt_residual.lu);
   assert(!lqr_policy.K.hasNaN());
   assert(!lqr_policy.k.hasNaN());
   backward_recursion_.factorizeRiccatiFactorization(riccati_next, kkt_matrix, 
@@ -58,23 +71,24 @@ inline void RiccatiFactorizer::backwardRiccatiRecursion(
     SplitConstrainedRiccatiFactorization& c_riccati, LQRPolicy& lqr_policy) {
   backward_recursion_.factorizeKKTMatrix(riccati_next, kkt_matrix, kkt_residual);
   // Schur complement
-  llt_.compute(kkt_matrix.Quu);
-  assert(llt_.info() == Eigen::Success);
+  computeRegularizedCholesky(lqr_policy.G_llt, kkt_matrix.Quu);
+  lqr_policy.G = kkt_matrix.Quu;
   c_riccati.setImpulseStatus(sc_jacobian.dimi());
-  c_riccati.Ginv.noalias() = llt_.solve(Eigen::MatrixXd::Identity(dimu_, dimu_));
-  c_riccati.DGinv().transpose().noalias() = llt_.solve(sc_jacobian.Phiu().transpose());
+  c_riccati.Ginv.noalias() 
+      = lqr_policy.G_llt.solve(Eigen::MatrixXd::Identity(dimu_, dimu_));
+  c_riccati.DGinv().transpose().noalias() 
+      = lqr_policy.G_llt.solve(sc_jacobian.Phiu().transpose());
   c_riccati.S().noalias() = c_riccati.DGinv() * sc_jacobian.Phiu().transpose();
-  llt_s_.compute(c_riccati.S());
-  assert(llt_s_.info() == Eigen::Success);
-  c_riccati.SinvDGinv().noalias() = llt_s_.solve(c_riccati.DGinv());
+  computeRegularizedCholesky(c_riccati.S_llt, c_riccati.S());
+  c_riccati.SinvDGinv().noalias() = c_riccati.S_llt.solve(c_riccati.DGinv());
   c_riccati.Ginv.noalias() -= c_riccati.SinvDGinv().transpose() * c_riccati.DGinv();
   lqr_policy.K.noalias()  = - c_riccati.Ginv * kkt_matrix.Qxu.transpose();
   lqr_policy.K.noalias() -= c_riccati.SinvDGinv().transpose() * sc_jacobian.Phix();
   lqr_policy.k.noalias()  = - c_riccati.Ginv * kkt_residual.lu;
   lqr_policy.k.noalias() -= c_riccati.SinvDGinv().transpose() * sc_residual.P();
-  c_riccati.M().noalias()  = llt_s_.solve(sc_jacobian.Phix());
+  c_riccati.M().noalias()  = c_riccati.S_llt.solve(sc_jacobian.Phix());
   c_riccati.M().noalias() -= c_riccati.SinvDGinv() * kkt_matrix.Qxu.transpose();
-  c_riccati.m().noalias()  = llt_s_.solve(sc_residual.P());
+  c_riccati.m().noalias()  = c_riccati.S_llt.solve(sc_residual.P());
   c_riccati.m().noalias() -= c_riccati.SinvDGinv() * kkt_residual.lu;
   assert(!lqr_policy.K.hasNaN());
   assert(!lqr_policy.k.hasNaN());
@@ -101,6 +115,85 @@ inline void RiccatiFactorizer::backwardRiccatiRecursion(
 }
 
 
+inline void RiccatiFactorizer::backwardRiccatiRecursion(
+    const SplitRiccatiFactorization& riccati_next,  
+    SplitKKTMatrix& kkt_matrix, SplitKKTResidual& kkt_residual, 
+    SplitRiccatiFactorization& riccati, LQRPolicy& lqr_policy,
+    const IterationLevel level) {
+  switch (level) {
+    case IterationLevel::Full:
+      backwardRiccatiRecursion(riccati_next, kkt_matrix, kkt_residual, 
+                               riccati, lqr_policy);
+      break;
+    case IterationLevel::Jacobian:
+      backward_recursion_.factorizeInputKKTMatrix(riccati_next, kkt_matrix);
+      backward_recursion_.factorizeKKTResidual(riccati_next, kkt_matrix, 
+                                               kkt_residual);
+      computeRegularizedCholesky(lqr_policy.G_llt, kkt_matrix.Quu);
+      lqr_policy.G = kkt_matrix.Quu;
+      lqr_policy.K.noalias() 
+          = - lqr_policy.G_llt.solve(kkt_matrix.Qxu.transpose());
+      lqr_policy.k.noalias() = - lqr_policy.G_llt.solve(kkt_residual.lu);
+      assert(!lqr_policy.K.hasNaN());
+      assert(!lqr_policy.k.hasNaN());
+      backward_recursion_.factorizeRiccatiVector(kkt_matrix, kkt_residual, 
+                                                 lqr_policy, riccati);
+      break;
+    default:
+      backward_recursion_.factorizeKKTResidual(riccati_next, kkt_matrix, 
+                                               kkt_residual);
+      lqr_policy.k.noalias() = - lqr_policy.G_llt.solve(kkt_residual.lu);
+      assert(!lqr_policy.k.hasNaN());
+      backward_recursion_.factorizeRiccatiVector(kkt_matrix, kkt_residual, 
+                                                 lqr_policy, riccati);
+      break;
+  }
+}
+
+
+inline void RiccatiFactorizer::backwardRiccatiRecursion(
+    const SplitRiccatiFactorization& riccati_next, 
+    SplitKKTMatrix& kkt_matrix, SplitKKTResidual& kkt_residual, 
+    const SplitSwitchingConstraintJacobian& sc_jacobian,
+    const SplitSwitchingConstraintResidual& sc_residual, 
+    SplitRiccatiFactorization& riccati,
+    SplitConstrainedRiccatiFactorization& c_riccati, LQRPolicy& lqr_policy,
+    const IterationLevel level) {
+  if (level != IterationLevel::Residual) {
+    backwardRiccatiRecursion(riccati_next, kkt_matrix, kkt_residual, 
+                             sc_jacobian, sc_residual, riccati, c_riccati, 
+                             lqr_policy);
+    return;
+  }
+  assert(c_riccati.dimi() == sc_residual.dimi());
+  backward_recursion_.factorizeKKTResidual(riccati_next, kkt_matrix, 
+                                           kkt_residual);
+  lqr_policy.k.noalias()  = - c_riccati.Ginv * kkt_residual.lu;
+  lqr_policy.k.noalias() -= c_riccati.SinvDGinv().transpose() * sc_residual.P();
+  c_riccati.m().noalias()  = c_riccati.S_llt.solve(sc_residual.P());
+  c_riccati.m().noalias() -= c_riccati.SinvDGinv() * kkt_residual.lu;
+  assert(!lqr_policy.k.hasNaN());
+  assert(!c_riccati.m().hasNaN());
+  backward_recursion_.factorizeRiccatiVector(kkt_matrix, kkt_residual, 
+                                             lqr_policy, riccati);
+  riccati.s.noalias() -= c_riccati.M().transpose() * sc_residual.P();
+}
+
+
+inline void RiccatiFactorizer::backwardRiccatiRecursion(
+    const SplitRiccatiFactorization& riccati_next, 
+    ImpulseSplitKKTMatrix& kkt_matrix, ImpulseSplitKKTResidual& kkt_residual, 
+    SplitRiccatiFactorization& riccati, const IterationLevel level) {
+  if (level == IterationLevel::Full) {
+    backwardRiccatiRecursion(riccati_next, kkt_matrix, kkt_residual, riccati);
+  }
+  else {
+    backward_recursion_.factorizeRiccatiVector(riccati_next, kkt_matrix, 
+                                               kkt_residual, riccati);
+  }
+}
+
+
 template <typename SplitDirectionType>
 inline void RiccatiFactorizer::forwardRiccatiRecursion(
     const SplitKKTMatrix& kkt_matrix, const SplitKKTResidual& kkt_residual, 
@@ -137,6 +230,103 @@ inline void RiccatiFactorizer::computeLagrangeMultiplierDirection(
   d.dxi().noalias() += c_riccati.m();
 }
 
+
+inline void RiccatiFactorizer::setRegularizationParameters(
+    const double min_regularization, const double max_regularization,
+    const double regularization_factor) {
+  try {
+    if (min_regularization <= 0) {
+      throw std::out_of_range(
+          "invalid value: min_regularization must be positive!");
+    }
+    if (max_regularization <= min_regularization) {
+      throw std::out_of_range(
+          "invalid value: max_regularization must be larger than min_regularization!");
+    }
+    if (regularization_factor <= 1) {
+      throw std::out_of_range(
+          "invalid value: regularization_factor must be larger than 1!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  reg_min_ = min_regularization;
+  reg_max_ = max_regularization;
+  reg_factor_ = regularization_factor;
+  reg_ = 0;
+}
+
+
+inline double RiccatiFactorizer::regularization() const {
+  return max_reg_;
+}
+
+
+inline void RiccatiFactorizer::resetRegularization() {
+  max_reg_ = 0;
+}
+
+
+inline bool RiccatiFactorizer::hasFailed() const {
+  return has_failed_;
+}
+
+
+inline void RiccatiFactorizer::resetFailure() {
+  has_failed_ = false;
+}
+
+
+inline void RiccatiFactorizer::setMixedPrecision(const bool mixed_precision) {
+  backward_recursion_.setMixedPrecision(mixed_precision);
+}
+
+
+inline void RiccatiFactorizer::saveRegularization(std::ostream& os) const {
+  binaryio::write(os, reg_);
+  binaryio::write(os, max_reg_);
+}
+
+
+inline void RiccatiFactorizer::loadRegularization(std::istream& is) {
+  binaryio::read(is, reg_);
+  binaryio::read(is, max_reg_);
+}
+
+
+template <typename MatrixType>
+inline void RiccatiFactorizer::computeRegularizedCholesky(
+    Eigen::LLT<Eigen::MatrixXd>& llt, const Eigen::MatrixBase<MatrixType>& H) {
+  assert(H.rows() == H.cols());
+  llt.compute(H);
+  if (llt.info() == Eigen::Success) {
+    reg_ /= reg_factor_;
+    if (reg_ < reg_min_) {
+      reg_ = 0;
+    }
+    return;
+  }
+  double reg = std::max(reg_, reg_min_);
+  double reg_added = 0;
+  while (true) {
+    const_cast<Eigen::MatrixBase<MatrixType>&>(H).diagonal().array() 
+        += (reg - reg_added);
+    reg_added = reg;
+    llt.compute(H);
+    if (llt.info() == Eigen::Success || reg >= reg_max_) {
+      break;
+    }
+    reg = std::min(reg_factor_*reg, reg_max_);
+  }
+  if (llt.info() != Eigen::Success) {
+    has_failed_ = true;
+  }
+  reg_ = reg;
+  max_reg_ = std::max(max_reg_, reg);
+}
+
 } // namespace idocp
 
 #endif // IDOCP_RICCATI_FACTORIZER_HXX_ 
\ No newline at end of file
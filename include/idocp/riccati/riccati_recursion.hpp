@@ -1,6 +1,9 @@
 #ifndef IDOCP_RICCATI_RECURSION_HPP_
 #define IDOCP_RICCATI_RECURSION_HPP_
 
+#include <vector>
+#include <iostream>
+
 #include "Eigen/Core"
 
 #include "idocp/robot/robot.hpp"
@@ -10,6 +13,7 @@
 #include "idocp/riccati/split_constrained_riccati_factorization.hpp"
 #include "idocp/riccati/lqr_policy.hpp"
 #include "idocp/riccati/riccati_factorizer.hpp"
+#include "idocp/riccati/iteration_level.hpp"
 #include "idocp/ocp/ocp.hpp"
 #include "idocp/ocp/solution.hpp"
 #include "idocp/ocp/direction.hpp"
@@ -84,10 +88,27 @@ public:
   /// @param[in, out] kkt_matrix KKT matrix. 
   /// @param[in, out] kkt_residual KKT residual. 
   /// @param[in, out] factorization Riccati factorization. 
+  /// @param[in] level Level of the multi-level iteration. If it is not 
+  /// IterationLevel::Full, the factorization of the previous recursion is 
+  /// reused. Falls back to IterationLevel::Full if the previous recursion 
+  /// has a different hybrid structure of the horizon. Default is 
+  /// IterationLevel::Full.
+  /// @return true if the factorization succeeds. false if the Hessian of a 
+  /// stage is not positive definite even with the maximum regularization. 
+  /// Then the LQR policies are invalid and must not be used to update the 
+  /// solution, and the next recursion performs IterationLevel::Full.
+  ///
+  bool backwardRiccatiRecursion(
+      const OCP& ocp, KKTMatrix& kkt_matrix, KKTResidual& kkt_residual, 
+      RiccatiFactorization& factorization, 
+      const IterationLevel level=IterationLevel::Full);
+
+  ///
+  /// @brief Returns the level of the multi-level iteration actually 
+  /// performed in the last backward Riccati recursion. 
+  /// @return The level of the last backward Riccati recursion.
   ///
-  void backwardRiccatiRecursion(const OCP& ocp, KKTMatrix& kkt_matrix, 
-                                KKTResidual& kkt_residual, 
-                                RiccatiFactorization& factorization);
+  IterationLevel iterationLevel() const;
 
   ///
   /// @brief Performs the forward Riccati recursion.
@@ -100,6 +121,31 @@ public:
                                const KKTResidual& kkt_residual, 
                                Direction& d) const;
 
+  ///
+  /// @brief Solves the KKT system with another KKT residual by the Riccati 
+  /// factorization of the last backward Riccati recursion, i.e., performs 
+  /// the backward Riccati recursion of IterationLevel::Residual and the 
+  /// forward Riccati recursion without refactorizing the KKT matrix, e.g., 
+  /// for the second-order correction of the line search. The level of the 
+  /// last backward Riccati recursion is kept, while the feedforward terms of 
+  /// the LQR policies are overwritten.
+  /// @param[in] ocp Optimal control problem. Must have the same hybrid 
+  /// structure as that of the last backward Riccati recursion.
+  /// @param[in] kkt_matrix KKT matrix of the last backward Riccati recursion. 
+  /// Not modified.
+  /// @param[in, out] kkt_residual KKT residual. 
+  /// @param[in, out] factorization Riccati factorization of the last backward 
+  /// Riccati recursion. The matrices are reused and the vectors are 
+  /// overwritten.
+  /// @param[in, out] d Direction. d[0].dx is assumed to be computed. 
+  /// @return true if the KKT system is solved. false if the factorization 
+  /// failed. 
+  ///
+  bool solveWithFactorization(const OCP& ocp, KKTMatrix& kkt_matrix, 
+                              KKTResidual& kkt_residual, 
+                              RiccatiFactorization& factorization, 
+                              Direction& d);
+
   ///
   /// @brief Compute the Newton direction in parallel from the Riccati 
   /// factorization factorized by 
@@ -135,11 +181,83 @@ public:
   void getStateFeedbackGain(const int time_stage, Eigen::MatrixXd& Kq, 
                             Eigen::MatrixXd& Kv) const;
 
+  ///
+  /// @brief Sets the parameters of the adaptive regularization applied when 
+  /// the factorization of a stage fails. See 
+  /// RiccatiFactorizer::setRegularizationParameters() for details.
+  /// @param[in] min_regularization Initial regularization. Must be positive.
+  /// @param[in] max_regularization Maximum regularization. Must be larger than
+  /// min_regularization.
+  /// @param[in] regularization_factor Factor of the increase and the decrease
+  /// of the regularization. Must be larger than 1.
+  ///
+  void setRegularizationParameters(const double min_regularization, 
+                                   const double max_regularization,
+                                   const double regularization_factor);
+
+  ///
+  /// @brief Returns the largest regularization added to the KKT matrices in 
+  /// the last backward Riccati recursion. 
+  /// @return The largest regularization. Zero if no factorization has failed.
+  ///
+  double regularization() const;
+
+  ///
+  /// @brief Enables or disables the mixed-precision factorization of the 
+  /// backward Riccati recursion. See 
+  /// BackwardRiccatiRecursionFactorizer::setMixedPrecision() for details.
+  /// @param[in] mixed_precision If true, the mixed-precision factorization 
+  /// is enabled. 
+  ///
+  void setMixedPrecision(const bool mixed_precision);
+
+  ///
+  /// @brief Checks whether the Riccati factorization of the last backward 
+  /// Riccati recursion can be reused at IterationLevel::Jacobian and 
+  /// IterationLevel::Residual, i.e., whether the factorization has been 
+  /// computed and the structure of the stages has not changed since then.
+  /// @param[in] ocp Optimal control problem.
+  /// @param[in] kkt_residual KKT residual. 
+  /// @return true if the factorization can be reused. false if not.
+  ///
+  bool isFactorizationReusable(const OCP& ocp, 
+                               const KKTResidual& kkt_residual) const;
+
+  ///
+  /// @brief Writes the state of the factorization that is kept over the 
+  /// iterations to the binary stream: the adapted regularization and, if the 
+  /// factorization has been computed, the structure of the stages, the 
+  /// Riccati factorization, the LQR policies, and the factorizations of the
+  /// switching constraints. 
+  /// @param[in, out] os Output binary stream.
+  /// @param[in] factorization Riccati factorization.
+  ///
+  void saveFactorization(std::ostream& os, 
+                         const RiccatiFactorization& factorization) const;
+
+  ///
+  /// @brief Reads the state of the factorization written by 
+  /// saveFactorization(). The Cholesky factorizations are recomputed from the 
+  /// stored matrices. Throws std::runtime_error if the stream is broken or 
+  /// inconsistent with this solver.
+  /// @param[in, out] is Input binary stream.
+  /// @param[in, out] factorization Riccati factorization.
+  ///
+  void loadFactorization(std::istream& is, 
+                         RiccatiFactorization& factorization);
+
 private:
   int nthreads_, N_, N_all_;
   RiccatiFactorizer factorizer_;
   hybrid_container<LQRPolicy> lqr_policy_;
   Eigen::VectorXd max_primal_step_sizes_, max_dual_step_sizes_;
+  IterationLevel level_;
+  bool has_factorization_;
+  std::vector<int> stage_structure_, switching_dims_;
+
+  void storeStructure(const OCP& ocp, const KKTResidual& kkt_residual);
+
+  static int stageStructure(const OCP& ocp, const int time_stage);
 
 };
 
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "Eigen/Core"
+#include "Eigen/Cholesky"
 
 #include "idocp/robot/robot.hpp"
 #include "idocp/robot/impulse_status.hpp"
@@ -91,6 +92,12 @@ public:
 
   Eigen::MatrixXd KtDtM;
 
+  ///
+  /// @brief Cholesky factorization of the Schur complement S. Stored so that
+  /// m can be updated without refactorizing S. 
+  ///
+  Eigen::LLT<Eigen::MatrixXd> S_llt;
+
   bool isApprox(const SplitConstrainedRiccatiFactorization& other) const;
 
   bool hasNaN() const;
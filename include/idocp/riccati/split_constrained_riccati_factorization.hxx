@@ -12,6 +12,7 @@ SplitConstrainedRiccatiFactorization(const Robot& robot)
   : Ginv(Eigen::MatrixXd::Zero(robot.dimu(), robot.dimu())),
     DtM(Eigen::MatrixXd::Zero(robot.dimu(), robot.dimu())),
     KtDtM(Eigen::MatrixXd::Zero(2*robot.dimv(), 2*robot.dimv())),
+    S_llt(robot.max_dimf()),
     DGinv_full_(Eigen::MatrixXd::Zero(robot.max_dimf(), robot.dimu())),
     S_full_(Eigen::MatrixXd::Zero(robot.max_dimf(), robot.max_dimf())),
     Sinv_full_(Eigen::MatrixXd::Zero(robot.max_dimf(), robot.max_dimf())),
@@ -30,6 +31,7 @@ SplitConstrainedRiccatiFactorization()
   : Ginv(),
     DtM(),
     KtDtM(),
+    S_llt(),
     DGinv_full_(),
     S_full_(),
     Sinv_full_(),
@@ -1,6 +1,10 @@
 #ifndef IDOCP_SPLIT_RICCATI_FACTORIZATION_HPP_
 #define IDOCP_SPLIT_RICCATI_FACTORIZATION_HPP_
 
+#include <new>
+#include <utility>
+#include <cassert>
+
 #include "Eigen/Core"
 
 #include "idocp/robot/robot.hpp"
@@ -15,22 +19,47 @@ namespace idocp {
 class SplitRiccatiFactorization {
 public:
   ///
-  /// @brief Constructs Riccati factorization matrix and vector.
+  /// @brief Constructs Riccati factorization matrix and vector. This object 
+  /// owns the storage of SplitRiccatiFactorization::P and 
+  /// SplitRiccatiFactorization::s.
   /// @param[in] robot Robot model. 
   ///
   SplitRiccatiFactorization(const Robot& robot)
-    : P(Eigen::MatrixXd::Zero(2*robot.dimv(), 2*robot.dimv())),
-      s(Eigen::VectorXd::Zero(2*robot.dimv())),
+    : P(nullptr, 0, 0),
+      s(nullptr, 0),
+      storage_(Eigen::VectorXd::Zero(storageSize(robot))),
+      dimv_(robot.dimv()),
+      dimx_(2*robot.dimv()) {
+    setStorage(storage_.data());
+  }
+
+  ///
+  /// @brief Constructs Riccati factorization matrix and vector on an external
+  /// storage, e.g., a contiguous arena allocated by hybrid_container. The 
+  /// storage must outlive this object.
+  /// @param[in] robot Robot model. 
+  /// @param[in] storage Pointer to the external storage. The size must be at 
+  /// least SplitRiccatiFactorization::storageSize().
+  ///
+  SplitRiccatiFactorization(const Robot& robot, double* storage)
+    : P(nullptr, 0, 0),
+      s(nullptr, 0),
+      storage_(),
       dimv_(robot.dimv()),
       dimx_(2*robot.dimv()) {
+    assert(storage != nullptr);
+    setStorage(storage);
+    P.setZero();
+    s.setZero();
   }
 
   ///
   /// @brief Default constructor. 
   ///
   SplitRiccatiFactorization()
-    : P(),
-      s(),
+    : P(nullptr, 0, 0),
+      s(nullptr, 0),
+      storage_(),
       dimv_(0),
       dimx_(0) {
   }
@@ -42,84 +71,145 @@ public:
   }
 
   ///
-  /// @brief Default copy constructor. 
+  /// @brief Copy constructor. The copied object always owns its storage. 
   ///
-  SplitRiccatiFactorization(const SplitRiccatiFactorization&) = default;
+  SplitRiccatiFactorization(const SplitRiccatiFactorization& other)
+    : P(nullptr, 0, 0),
+      s(nullptr, 0),
+      storage_(other.dimx_*other.dimx_+other.dimx_),
+      dimv_(other.dimv_),
+      dimx_(other.dimx_) {
+    setStorage(storage_.data());
+    P = other.P;
+    s = other.s;
+  }
 
   ///
-  /// @brief Default copy operator. 
+  /// @brief Copy assign operator. If the dimensions are the same, the values 
+  /// are copied into the current storage, i.e., the external storage is kept.
   ///
-  SplitRiccatiFactorization& operator=(
-      const SplitRiccatiFactorization&) = default;
+  SplitRiccatiFactorization& operator=(const SplitRiccatiFactorization& other) {
+    if (this != &other) {
+      if (dimx_ != other.dimx_) {
+        dimv_ = other.dimv_;
+        dimx_ = other.dimx_;
+        storage_.resize(dimx_*dimx_+dimx_);
+        setStorage(storage_.data());
+      }
+      P = other.P;
+      s = other.s;
+    }
+    return *this;
+  }
 
   ///
-  /// @brief Default move constructor. 
+  /// @brief Move constructor. If other is constructed on an external storage, 
+  /// this object refers to the same storage.
   ///
-  SplitRiccatiFactorization(
-      SplitRiccatiFactorization&&) noexcept = default;
+  SplitRiccatiFactorization(SplitRiccatiFactorization&& other) noexcept
+    : P(nullptr, 0, 0),
+      s(nullptr, 0),
+      storage_(std::move(other.storage_)),
+      dimv_(other.dimv_),
+      dimx_(other.dimx_) {
+    if (storage_.size() > 0) {
+      setStorage(storage_.data());
+    }
+    else {
+      setStorage(other.P.data());
+    }
+    other.dimv_ = 0;
+    other.dimx_ = 0;
+    other.setStorage(nullptr);
+  }
 
   ///
-  /// @brief Default move assign operator. 
+  /// @brief Move assign operator. If the dimensions are the same and this 
+  /// object is constructed on an external storage, the values are copied into 
+  /// the external storage.
   ///
-  SplitRiccatiFactorization& operator=(
-      SplitRiccatiFactorization&&) noexcept = default;
+  SplitRiccatiFactorization& operator=(SplitRiccatiFactorization&& other) {
+    if (this != &other) {
+      if (dimx_ == other.dimx_ || other.storage_.size() == 0) {
+        *this = static_cast<const SplitRiccatiFactorization&>(other);
+      }
+      else {
+        storage_ = std::move(other.storage_);
+        dimv_ = other.dimv_;
+        dimx_ = other.dimx_;
+        setStorage(storage_.data());
+      }
+    }
+    return *this;
+  }
 
   ///
   /// @brief Riccati factorization matrix. Size is 
   /// 2 * Robot::dimv() x 2 * Robot::dimv().
   ///
-  Eigen::MatrixXd P;
+  Eigen::Map<Eigen::MatrixXd> P;
 
   ///
   /// @brief Riccati factorization vector. Size is 2 * Robot::dimv().
   ///
-  Eigen::VectorXd s;
+  Eigen::Map<Eigen::VectorXd> s;
 
-  Eigen::Block<Eigen::MatrixXd> Pqq() {
+  ///
+  /// @brief Returns the size of the storage required for 
+  /// SplitRiccatiFactorization::P and SplitRiccatiFactorization::s.
+  /// @param[in] robot Robot model. 
+  /// @return Size of the storage.
+  ///
+  static int storageSize(const Robot& robot) {
+    const int dimx = 2 * robot.dimv();
+    return dimx * dimx + dimx;
+  }
+
+  Eigen::Block<Eigen::Map<Eigen::MatrixXd>> Pqq() {
     return P.topLeftCorner(dimv_, dimv_); 
   }
 
-  const Eigen::Block<const Eigen::MatrixXd> Pqq() const {
+  const Eigen::Block<const Eigen::Map<Eigen::MatrixXd>> Pqq() const {
     return P.topLeftCorner(dimv_, dimv_); 
   }
 
-  Eigen::Block<Eigen::MatrixXd> Pqv() {
+  Eigen::Block<Eigen::Map<Eigen::MatrixXd>> Pqv() {
     return P.topRightCorner(dimv_, dimv_); 
   }
 
-  const Eigen::Block<const Eigen::MatrixXd> Pqv() const {
+  const Eigen::Block<const Eigen::Map<Eigen::MatrixXd>> Pqv() const {
     return P.topRightCorner(dimv_, dimv_); 
   }
 
-  Eigen::Block<Eigen::MatrixXd> Pvq() {
+  Eigen::Block<Eigen::Map<Eigen::MatrixXd>> Pvq() {
     return P.bottomLeftCorner(dimv_, dimv_); 
   }
 
-  const Eigen::Block<const Eigen::MatrixXd> Pvq() const {
+  const Eigen::Block<const Eigen::Map<Eigen::MatrixXd>> Pvq() const {
     return P.bottomLeftCorner(dimv_, dimv_); 
   }
 
-  Eigen::Block<Eigen::MatrixXd> Pvv() {
+  Eigen::Block<Eigen::Map<Eigen::MatrixXd>> Pvv() {
     return P.bottomRightCorner(dimv_, dimv_); 
   }
 
-  const Eigen::Block<const Eigen::MatrixXd> Pvv() const {
+  const Eigen::Block<const Eigen::Map<Eigen::MatrixXd>> Pvv() const {
     return P.bottomRightCorner(dimv_, dimv_); 
   }
 
-  Eigen::VectorBlock<Eigen::VectorXd> sq() {
+  Eigen::VectorBlock<Eigen::Map<Eigen::VectorXd>> sq() {
     return s.head(dimv_);
   }
 
-  const Eigen::VectorBlock<const Eigen::VectorXd> sq() const {
+  const Eigen::VectorBlock<const Eigen::Map<Eigen::VectorXd>> sq() const {
     return s.head(dimv_);
   }
 
-  Eigen::VectorBlock<Eigen::VectorXd> sv() {
+  Eigen::VectorBlock<Eigen::Map<Eigen::VectorXd>> sv() {
     return s.tail(dimv_);
   }
 
-  const Eigen::VectorBlock<const Eigen::VectorXd> sv() const {
+  const Eigen::VectorBlock<const Eigen::Map<Eigen::VectorXd>> sv() const {
     return s.tail(dimv_);
   }
 
@@ -145,8 +235,14 @@ public:
   }
 
 private:
+  Eigen::VectorXd storage_;
   int dimv_, dimx_;
 
+  void setStorage(double* storage) {
+    new (&P) Eigen::Map<Eigen::MatrixXd>(storage, dimx_, dimx_);
+    new (&s) Eigen::Map<Eigen::VectorXd>(storage+dimx_*dimx_, dimx_);
+  }
+
 };
 
 } // namespace idocp 
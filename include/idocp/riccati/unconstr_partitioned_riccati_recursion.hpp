@@ -0,0 +1,153 @@
+#ifndef IDOCP_UNCONSTR_PARTITIONED_RICCATI_RECURSION_HPP_
+#define IDOCP_UNCONSTR_PARTITIONED_RICCATI_RECURSION_HPP_
+
+#include <vector>
+
+#include "Eigen/Core"
+#include "Eigen/Cholesky"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/ocp/direction.hpp"
+#include "idocp/ocp/kkt_matrix.hpp"
+#include "idocp/ocp/kkt_residual.hpp"
+#include "idocp/riccati/unconstr_riccati_factorizer.hpp"
+#include "idocp/riccati/unconstr_riccati_recursion.hpp"
+#include "idocp/riccati/unconstr_segment_coupling.hpp"
+#include "idocp/riccati/lqr_policy.hpp"
+
+
+namespace idocp {
+
+///
+/// @class UnconstrPartitionedRiccatiRecursion
+/// @brief Riccati recursion over a segment of the horizon, i.e., the time
+/// stages from stage_begin to stage_end - 1, for optimal control problems of
+/// unconstrained rigid-body systems. The backward recursion starts from the
+/// zero Riccati factorization unless the segment includes the terminal stage,
+/// and computes the sensitivities of the solution with respect to the
+/// Riccati factorization vector sigma at the first stage of the next segment
+/// as UnconstrSegmentCoupling. After sigma and the state direction at the
+/// first stage of each segment are obtained by UnconstrReducedBoundarySystem,
+/// the forward recursion recovers the same direction as
+/// UnconstrRiccatiRecursion. The Riccati factorization matrices differ from
+/// those of the whole horizon unless the segment includes the terminal
+/// stage, while the directions and the costate directions coincide. The KKT
+/// matrix, the KKT residual, the Riccati factorization, and the direction are
+/// indexed locally, i.e., the index 0 corresponds to stage_begin.
+///
+class UnconstrPartitionedRiccatiRecursion {
+public:
+  ///
+  /// @brief Construct a Riccati recursion solver over a segment.
+  /// @param[in] robot Robot model.
+  /// @param[in] T Length of the horizon. Must be positive.
+  /// @param[in] N Number of discretization of the horizon.
+  /// @param[in] stage_begin First time stage of the segment.
+  /// @param[in] stage_end Time stage next to the last time stage of the
+  /// segment. Must be larger than stage_begin and not larger than N. If N,
+  /// the segment includes the terminal stage.
+  ///
+  UnconstrPartitionedRiccatiRecursion(const Robot& robot, const double T,
+                                      const int N, const int stage_begin,
+                                      const int stage_end);
+
+  ///
+  /// @brief Default constructor.
+  ///
+  UnconstrPartitionedRiccatiRecursion();
+
+  ///
+  /// @brief Destructor.
+  ///
+  ~UnconstrPartitionedRiccatiRecursion();
+
+  ///
+  /// @brief Default copy constructor.
+  ///
+  UnconstrPartitionedRiccatiRecursion(
+      const UnconstrPartitionedRiccatiRecursion&) = default;
+
+  ///
+  /// @brief Default copy operator.
+  ///
+  UnconstrPartitionedRiccatiRecursion& operator=(
+      const UnconstrPartitionedRiccatiRecursion&) = default;
+
+  ///
+  /// @brief Default move constructor.
+  ///
+  UnconstrPartitionedRiccatiRecursion(
+      UnconstrPartitionedRiccatiRecursion&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator.
+  ///
+  UnconstrPartitionedRiccatiRecursion& operator=(
+      UnconstrPartitionedRiccatiRecursion&&) noexcept = default;
+
+  ///
+  /// @brief Performs the backward Riccati recursion over the segment with
+  /// sigma = 0 and computes the coupling with the neighbouring segments.
+  /// @param[in, out] kkt_matrix KKT matrix of the segment. The size must be
+  /// at least the number of the stages of the segment plus 1.
+  /// @param[in, out] kkt_residual KKT residual of the segment.
+  /// @param[in, out] factorization Riccati factorization of the segment.
+  /// @param[out] coupling Coupling of the segment. Phi, Gamma, and c are not
+  /// computed if the segment includes the terminal stage.
+  ///
+  void backwardRiccatiRecursion(KKTMatrix& kkt_matrix, KKTResidual& kkt_residual,
+                                UnconstrRiccatiFactorization& factorization,
+                                UnconstrSegmentCoupling& coupling);
+
+  ///
+  /// @brief Corrects the Riccati factorization vectors and the LQR policies
+  /// by sigma, performs the forward Riccati recursion over the segment, and
+  /// computes the direction. d[0].dx must be set beforehand.
+  /// @param[in] kkt_residual KKT residual of the segment.
+  /// @param[in] sigma Riccati factorization vector at the first stage of the
+  /// next segment. Ignored if the segment includes the terminal stage.
+  /// @param[in, out] factorization Riccati factorization of the segment.
+  /// @param[in, out] d Direction of the segment.
+  ///
+  void forwardRiccatiRecursion(const KKTResidual& kkt_residual,
+                               const Eigen::VectorXd& sigma,
+                               UnconstrRiccatiFactorization& factorization,
+                               Direction& d);
+
+  ///
+  /// @return First time stage of the segment.
+  ///
+  int stageBegin() const;
+
+  ///
+  /// @return Time stage next to the last time stage of the segment.
+  ///
+  int stageEnd() const;
+
+  ///
+  /// @return Number of the time stages of the segment.
+  ///
+  int numStages() const;
+
+  ///
+  /// @return true if the segment includes the terminal stage. false if not.
+  ///
+  bool hasTerminalStage() const;
+
+private:
+  int N_, stage_begin_, stage_end_, num_stages_, dimv_;
+  double T_, dt_;
+  UnconstrRiccatiFactorizer factorizer_;
+  std::vector<LQRPolicy> lqr_policy_;
+  Eigen::LLT<Eigen::MatrixXd> llt_;
+  // Sensitivities of the Riccati factorization vectors and the feedforward
+  // terms of the LQR policies with respect to sigma.
+  std::vector<Eigen::MatrixXd> Psi_, kappa_;
+  Eigen::MatrixXd K_Phi_, K_Gamma_;
+  Eigen::VectorXd a_;
+
+};
+
+} // namespace idocp
+
+#endif // IDOCP_UNCONSTR_PARTITIONED_RICCATI_RECURSION_HPP_
@@ -0,0 +1,108 @@
+#ifndef IDOCP_UNCONSTR_REDUCED_BOUNDARY_SYSTEM_HPP_
+#define IDOCP_UNCONSTR_REDUCED_BOUNDARY_SYSTEM_HPP_
+
+#include <vector>
+
+#include "Eigen/Core"
+#include "Eigen/LU"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/riccati/unconstr_segment_coupling.hpp"
+
+
+namespace idocp {
+
+///
+/// @class UnconstrReducedBoundarySystem
+/// @brief Reduced system of the state directions at the first stages of the
+/// segments and the Riccati factorization vectors sigma at the ends of the
+/// segments, which couples the segments of the horizon solved by
+/// UnconstrPartitionedRiccatiRecursion. The system is block-tridiagonal and
+/// is solved by a backward and a forward sweep over the segments, whose
+/// cost grows linearly in the number of the segments and does not depend on
+/// the number of the time stages.
+///
+class UnconstrReducedBoundarySystem {
+public:
+  ///
+  /// @brief Construct a reduced system.
+  /// @param[in] robot Robot model.
+  /// @param[in] num_segments Number of the segments. Must be positive.
+  ///
+  UnconstrReducedBoundarySystem(const Robot& robot, const int num_segments);
+
+  ///
+  /// @brief Default constructor.
+  ///
+  UnconstrReducedBoundarySystem();
+
+  ///
+  /// @brief Destructor.
+  ///
+  ~UnconstrReducedBoundarySystem();
+
+  ///
+  /// @brief Default copy constructor.
+  ///
+  UnconstrReducedBoundarySystem(const UnconstrReducedBoundarySystem&) = default;
+
+  ///
+  /// @brief Default copy operator.
+  ///
+  UnconstrReducedBoundarySystem& operator=(
+      const UnconstrReducedBoundarySystem&) = default;
+
+  ///
+  /// @brief Default move constructor.
+  ///
+  UnconstrReducedBoundarySystem(
+      UnconstrReducedBoundarySystem&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator.
+  ///
+  UnconstrReducedBoundarySystem& operator=(
+      UnconstrReducedBoundarySystem&&) noexcept = default;
+
+  ///
+  /// @brief Solves the reduced system.
+  /// @param[in] coupling Couplings of the segments ordered in time. The last
+  /// one must be that of the segment including the terminal stage.
+  /// @param[in] dx0 State direction at the initial time stage.
+  ///
+  void solve(const std::vector<UnconstrSegmentCoupling>& coupling,
+             const Eigen::VectorXd& dx0);
+
+  ///
+  /// @param[in] segment Index of the segment.
+  /// @return State direction at the first stage of the segment.
+  ///
+  const Eigen::VectorXd& dxBegin(const int segment) const;
+
+  ///
+  /// @param[in] segment Index of the segment.
+  /// @return Riccati factorization vector at the first stage of the next
+  /// segment. Zero for the last segment.
+  ///
+  const Eigen::VectorXd& sigma(const int segment) const;
+
+  ///
+  /// @return Number of the segments.
+  ///
+  int numSegments() const;
+
+private:
+  int num_segments_, dimx_;
+  // Riccati factorization at the first stage of each segment, including the
+  // effect of all the subsequent segments.
+  std::vector<Eigen::MatrixXd> P_;
+  std::vector<Eigen::VectorXd> s_, dx_, sigma_;
+  std::vector<Eigen::PartialPivLU<Eigen::MatrixXd>> lu_;
+  Eigen::MatrixXd M_;
+  Eigen::VectorXd b_;
+
+};
+
+} // namespace idocp
+
+#endif // IDOCP_UNCONSTR_REDUCED_BOUNDARY_SYSTEM_HPP_
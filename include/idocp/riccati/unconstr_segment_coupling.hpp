@@ -0,0 +1,242 @@
+#ifndef IDOCP_UNCONSTR_SEGMENT_COUPLING_HPP_
+#define IDOCP_UNCONSTR_SEGMENT_COUPLING_HPP_
+
+#include <new>
+#include <utility>
+#include <cassert>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+
+
+namespace idocp {
+
+///
+/// @class UnconstrSegmentCoupling
+/// @brief Coupling of a segment of the horizon with its neighbouring segments
+/// computed by UnconstrPartitionedRiccatiRecursion. Let x_a be the state at
+/// the first stage of the segment, x_b the state at the first stage of the
+/// next segment, and sigma the Riccati factorization vector at x_b, i.e.,
+/// the minus of the costate direction at x_b. Then, the costate direction at
+/// x_a is given by P x_a - s - Psi sigma and the state direction at x_b by
+/// Phi x_a + Gamma sigma + c.
+///
+class UnconstrSegmentCoupling {
+public:
+  ///
+  /// @brief Constructs the coupling. This object owns the storage.
+  /// @param[in] robot Robot model.
+  ///
+  UnconstrSegmentCoupling(const Robot& robot)
+    : P(nullptr, 0, 0),
+      Psi(nullptr, 0, 0),
+      Phi(nullptr, 0, 0),
+      Gamma(nullptr, 0, 0),
+      s(nullptr, 0),
+      c(nullptr, 0),
+      storage_(Eigen::VectorXd::Zero(storageSize(robot))),
+      dimx_(2*robot.dimv()) {
+    setStorage(storage_.data());
+  }
+
+  ///
+  /// @brief Constructs the coupling on an external storage, e.g., a shared
+  /// memory among the processes. The storage must outlive this object.
+  /// @param[in] robot Robot model.
+  /// @param[in] storage Pointer to the external storage. The size must be at
+  /// least UnconstrSegmentCoupling::storageSize().
+  ///
+  UnconstrSegmentCoupling(const Robot& robot, double* storage)
+    : P(nullptr, 0, 0),
+      Psi(nullptr, 0, 0),
+      Phi(nullptr, 0, 0),
+      Gamma(nullptr, 0, 0),
+      s(nullptr, 0),
+      c(nullptr, 0),
+      storage_(),
+      dimx_(2*robot.dimv()) {
+    assert(storage != nullptr);
+    setStorage(storage);
+  }
+
+  ///
+  /// @brief Default constructor.
+  ///
+  UnconstrSegmentCoupling()
+    : P(nullptr, 0, 0),
+      Psi(nullptr, 0, 0),
+      Phi(nullptr, 0, 0),
+      Gamma(nullptr, 0, 0),
+      s(nullptr, 0),
+      c(nullptr, 0),
+      storage_(),
+      dimx_(0) {
+  }
+
+  ///
+  /// @brief Destructor.
+  ///
+  ~UnconstrSegmentCoupling() {
+  }
+
+  ///
+  /// @brief Copy constructor. The copied object always owns its storage.
+  ///
+  UnconstrSegmentCoupling(const UnconstrSegmentCoupling& other)
+    : P(nullptr, 0, 0),
+      Psi(nullptr, 0, 0),
+      Phi(nullptr, 0, 0),
+      Gamma(nullptr, 0, 0),
+      s(nullptr, 0),
+      c(nullptr, 0),
+      storage_(4*other.dimx_*other.dimx_+2*other.dimx_),
+      dimx_(other.dimx_) {
+    setStorage(storage_.data());
+    copyValues(other);
+  }
+
+  ///
+  /// @brief Copy operator. Copies the values into the current storage if the
+  /// dimensions are the same.
+  ///
+  UnconstrSegmentCoupling& operator=(const UnconstrSegmentCoupling& other) {
+    if (this != &other) {
+      if (dimx_ != other.dimx_) {
+        dimx_ = other.dimx_;
+        storage_.resize(4*dimx_*dimx_+2*dimx_);
+        setStorage(storage_.data());
+      }
+      copyValues(other);
+    }
+    return *this;
+  }
+
+  ///
+  /// @brief Move constructor. The object constructed on an external storage
+  /// keeps referring to the external storage.
+  ///
+  UnconstrSegmentCoupling(UnconstrSegmentCoupling&& other) noexcept
+    : P(nullptr, 0, 0),
+      Psi(nullptr, 0, 0),
+      Phi(nullptr, 0, 0),
+      Gamma(nullptr, 0, 0),
+      s(nullptr, 0),
+      c(nullptr, 0),
+      storage_(std::move(other.storage_)),
+      dimx_(other.dimx_) {
+    if (storage_.size() > 0) {
+      setStorage(storage_.data());
+    }
+    else {
+      setStorage(other.P.data());
+    }
+    other.dimx_ = 0;
+    other.setStorage(nullptr);
+  }
+
+  ///
+  /// @brief Move assign operator. Copies the values if this object is
+  /// constructed on an external storage.
+  ///
+  UnconstrSegmentCoupling& operator=(UnconstrSegmentCoupling&& other) {
+    if (this != &other) {
+      if (dimx_ == other.dimx_ || other.storage_.size() == 0) {
+        *this = static_cast<const UnconstrSegmentCoupling&>(other);
+      }
+      else {
+        storage_ = std::move(other.storage_);
+        dimx_ = other.dimx_;
+        setStorage(storage_.data());
+      }
+    }
+    return *this;
+  }
+
+  ///
+  /// @brief Riccati factorization matrix at the first stage of the segment.
+  ///
+  Eigen::Map<Eigen::MatrixXd> P;
+
+  ///
+  /// @brief Sensitivity of the Riccati factorization vector at the first
+  /// stage of the segment with respect to sigma.
+  ///
+  Eigen::Map<Eigen::MatrixXd> Psi;
+
+  ///
+  /// @brief Closed-loop state transition matrix over the segment.
+  ///
+  Eigen::Map<Eigen::MatrixXd> Phi;
+
+  ///
+  /// @brief Sensitivity of the state direction at the end of the segment
+  /// with respect to sigma.
+  ///
+  Eigen::Map<Eigen::MatrixXd> Gamma;
+
+  ///
+  /// @brief Riccati factorization vector at the first stage of the segment
+  /// with sigma = 0.
+  ///
+  Eigen::Map<Eigen::VectorXd> s;
+
+  ///
+  /// @brief State direction at the end of the segment with x_a = 0 and
+  /// sigma = 0.
+  ///
+  Eigen::Map<Eigen::VectorXd> c;
+
+  ///
+  /// @brief Returns the size of the storage.
+  /// @param[in] robot Robot model.
+  /// @return Size of the storage.
+  ///
+  static int storageSize(const Robot& robot) {
+    const int dimx = 2 * robot.dimv();
+    return 4 * dimx * dimx + 2 * dimx;
+  }
+
+  ///
+  /// @brief Checks the equivalence of two UnconstrSegmentCoupling.
+  /// @param[in] other Other object.
+  /// @return true if this and other is same. false otherwise.
+  ///
+  bool isApprox(const UnconstrSegmentCoupling& other) const {
+    if (!P.isApprox(other.P)) return false;
+    if (!Psi.isApprox(other.Psi)) return false;
+    if (!Phi.isApprox(other.Phi)) return false;
+    if (!Gamma.isApprox(other.Gamma)) return false;
+    if (!s.isApprox(other.s)) return false;
+    if (!c.isApprox(other.c)) return false;
+    return true;
+  }
+
+private:
+  Eigen::VectorXd storage_;
+  int dimx_;
+
+  void setStorage(double* storage) {
+    const int dimxx = dimx_ * dimx_;
+    new (&P) Eigen::Map<Eigen::MatrixXd>(storage, dimx_, dimx_);
+    new (&Psi) Eigen::Map<Eigen::MatrixXd>(storage+dimxx, dimx_, dimx_);
+    new (&Phi) Eigen::Map<Eigen::MatrixXd>(storage+2*dimxx, dimx_, dimx_);
+    new (&Gamma) Eigen::Map<Eigen::MatrixXd>(storage+3*dimxx, dimx_, dimx_);
+    new (&s) Eigen::Map<Eigen::VectorXd>(storage+4*dimxx, dimx_);
+    new (&c) Eigen::Map<Eigen::VectorXd>(storage+4*dimxx+dimx_, dimx_);
+  }
+
+  void copyValues(const UnconstrSegmentCoupling& other) {
+    P = other.P;
+    Psi = other.Psi;
+    Phi = other.Phi;
+    Gamma = other.Gamma;
+    s = other.s;
+    c = other.c;
+  }
+
+};
+
+} // namespace idocp
+
+#endif // IDOCP_UNCONSTR_SEGMENT_COUPLING_HPP_
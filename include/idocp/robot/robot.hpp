@@ -426,6 +426,24 @@ public:
             const Eigen::MatrixBase<TangentVectorType2>& a, 
             const Eigen::MatrixBase<TangentVectorType3>& tau);
 
+  ///
+  /// @brief Computes forward dynamics, i.e., generalized acceleration 
+  /// corresponding for given configuration, velocity, generalized torques, and
+  /// contact forces. If the robot has contacts, update contact forces via 
+  /// setContactForces() before calling this function.
+  /// @param[in] q Configuration. Size must be Robot::dimq().
+  /// @param[in] v Generalized velocity. Size must be Robot::dimv().
+  /// @param[in] tau Generalized torques for fully actuated system. Size must 
+  /// be Robot::dimv().
+  /// @param[out] a Generalized acceleration. Size must be Robot::dimv().
+  ///
+  template <typename ConfigVectorType, typename TangentVectorType1, 
+            typename TangentVectorType2, typename TangentVectorType3>
+  void forwardDynamics(const Eigen::MatrixBase<ConfigVectorType>& q, 
+                       const Eigen::MatrixBase<TangentVectorType1>& v, 
+                       const Eigen::MatrixBase<TangentVectorType2>& tau, 
+                       const Eigen::MatrixBase<TangentVectorType3>& a);
+
   ///
   /// @brief Computes the partial dervatives of the function of inverse dynamics 
   /// with respect to the configuration, velocity, and acceleration. If the 
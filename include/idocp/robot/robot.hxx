@@ -408,6 +408,28 @@ inline void Robot::RNEA(const Eigen::MatrixBase<ConfigVectorType>& q,
 }
 
 
+template <typename ConfigVectorType, typename TangentVectorType1, 
+          typename TangentVectorType2, typename TangentVectorType3>
+inline void Robot::forwardDynamics(
+    const Eigen::MatrixBase<ConfigVectorType>& q, 
+    const Eigen::MatrixBase<TangentVectorType1>& v, 
+    const Eigen::MatrixBase<TangentVectorType2>& tau, 
+    const Eigen::MatrixBase<TangentVectorType3>& a) {
+  assert(q.size() == dimq_);
+  assert(v.size() == dimv_);
+  assert(tau.size() == dimv_);
+  assert(a.size() == dimv_);
+  if (point_contacts_.empty()) {
+    const_cast<Eigen::MatrixBase<TangentVectorType3>&>(a)
+        = pinocchio::aba(model_, data_, q, v, tau);
+  }
+  else {
+    const_cast<Eigen::MatrixBase<TangentVectorType3>&>(a)
+        = pinocchio::aba(model_, data_, q, v, tau, fjoint_);
+  }
+}
+
+
 template <typename ConfigVectorType, typename TangentVectorType1, 
           typename TangentVectorType2, typename MatrixType1, 
           typename MatrixType2, typename MatrixType3>
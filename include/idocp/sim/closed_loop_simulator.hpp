@@ -0,0 +1,199 @@
+#ifndef IDOCP_CLOSED_LOOP_SIMULATOR_HPP_
+#define IDOCP_CLOSED_LOOP_SIMULATOR_HPP_
+
+#include <vector>
+#include <deque>
+#include <utility>
+#include <functional>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/sim/compliant_contact_simulator.hpp"
+
+
+namespace idocp {
+
+///
+/// @class ClosedLoopSimulationResult
+/// @brief Result of ClosedLoopSimulator::run().
+///
+struct ClosedLoopSimulationResult {
+  ///
+  /// @brief Number of the control ticks, i.e., the MPC updates.
+  ///
+  int num_ticks = 0;
+
+  ///
+  /// @brief Simulated time [s].
+  ///
+  double simulated_time = 0;
+
+  ///
+  /// @brief Wall-clock time of the whole run including the simulation [s].
+  ///
+  double wall_time = 0;
+
+  ///
+  /// @brief Simulated time divided by the wall-clock time. Larger than 1 if
+  /// the run is faster than real time.
+  ///
+  double real_time_factor = 0;
+
+  ///
+  /// @brief Mean, maximum, and 99th percentile of the measured wall-clock time
+  /// of the MPC update per tick [s].
+  ///
+  double mean_latency = 0, max_latency = 0, p99_latency = 0;
+
+  ///
+  /// @brief Root mean square of the configuration and velocity errors from
+  /// the reference over the ticks. Zero if no reference is set.
+  ///
+  double configuration_error_rms = 0, velocity_error_rms = 0;
+
+  ///
+  /// @brief true if the state became non-finite and the run was aborted.
+  ///
+  bool diverged = false;
+
+  ///
+  /// @brief Measured wall-clock time of the MPC update of each tick [s].
+  ///
+  std::vector<double> latency;
+
+  ///
+  /// @brief Displays the result onto a ostream.
+  ///
+  void showInfo() const;
+
+};
+
+
+///
+/// @class ClosedLoopSimulator
+/// @brief Headless closed-loop simulation of an MPC with
+/// CompliantContactSimulator. At each control tick, the MPC is updated with
+/// the simulated state and its initial control input is applied to the
+/// simulator after the solver latency. Runs as fast as the solver and the
+/// simulator allow, so the MPC can be benchmarked without a GUI.
+/// @tparam MPCType The type of the MPC, e.g., MPCQuadrupedalTrotting. Must
+/// have updateSolution(t, q, v, num_iteration) and getInitialControlInput().
+///
+template <typename MPCType>
+class ClosedLoopSimulator {
+public:
+  ///
+  /// @brief Reference of the closed-loop simulation. Given the time, sets
+  /// the reference configuration and velocity.
+  ///
+  using Reference = std::function<void(const double, Eigen::VectorXd&,
+                                       Eigen::VectorXd&)>;
+
+  ///
+  /// @brief Constructs the closed-loop simulator.
+  /// @param[in] mpc The MPC. Must be initialized, e.g., by MPCType::init(),
+  /// before calling ClosedLoopSimulator::run(). Must outlive this object.
+  /// @param[in] robot Robot model.
+  /// @param[in] control_period Period of the MPC updates. Must be positive.
+  /// @param[in] sim_time_step Time step of the simulation. Must be positive.
+  /// Default is 5.0e-04.
+  ///
+  ClosedLoopSimulator(MPCType& mpc, const Robot& robot,
+                      const double control_period,
+                      const double sim_time_step=5.0e-04);
+
+  ///
+  /// @brief Destructor.
+  ///
+  ~ClosedLoopSimulator();
+
+  ///
+  /// @brief Default copy constructor.
+  ///
+  ClosedLoopSimulator(const ClosedLoopSimulator&) = default;
+
+  ///
+  /// @brief Default copy operator.
+  ///
+  ClosedLoopSimulator& operator=(const ClosedLoopSimulator&) = default;
+
+  ///
+  /// @brief Default move constructor.
+  ///
+  ClosedLoopSimulator(ClosedLoopSimulator&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator.
+  ///
+  ClosedLoopSimulator& operator=(ClosedLoopSimulator&&) noexcept = default;
+
+  ///
+  /// @brief Sets the parameters of the ground model. See
+  /// CompliantContactSimulator::setGroundModel() for details.
+  ///
+  void setGroundModel(const double stiffness, const double damping,
+                      const double tangential_damping, const double mu);
+
+  ///
+  /// @brief Sets the solver latency, i.e., the delay from the state
+  /// measurement to the application of the control input.
+  /// @param[in] latency Fixed latency [s]. Must be non-negative. Default is 0.
+  /// @param[in] add_measured_latency If true, the measured wall-clock time of
+  /// each MPC update is added to the fixed latency. Default is false.
+  ///
+  void setSolverLatency(const double latency,
+                        const bool add_measured_latency=false);
+
+  ///
+  /// @brief Sets the reference to evaluate the tracking performance.
+  /// @param[in] reference Reference.
+  ///
+  void setReference(const Reference& reference);
+
+  ///
+  /// @brief Runs the closed-loop simulation.
+  /// @param[in] t0 Initial time.
+  /// @param[in] q0 Initial configuration. Size must be Robot::dimq().
+  /// @param[in] v0 Initial velocity. Size must be Robot::dimv().
+  /// @param[in] sim_time Simulated time. Must be positive.
+  /// @param[in] num_iteration Number of the iterations of the MPC per each
+  /// tick. Must be positive.
+  /// @return Result of the simulation.
+  ///
+  ClosedLoopSimulationResult run(const double t0, const Eigen::VectorXd& q0,
+                                 const Eigen::VectorXd& v0,
+                                 const double sim_time,
+                                 const int num_iteration);
+
+  ///
+  /// @brief Returns the configuration at the end of the last run.
+  /// @return const reference to the configuration.
+  ///
+  const Eigen::VectorXd& q() const;
+
+  ///
+  /// @brief Returns the velocity at the end of the last run.
+  /// @return const reference to the velocity.
+  ///
+  const Eigen::VectorXd& v() const;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+  MPCType* mpc_;
+  Robot robot_;
+  CompliantContactSimulator sim_;
+  Reference reference_;
+  double control_period_, latency_;
+  bool add_measured_latency_;
+  Eigen::VectorXd q_, v_, u_, q_ref_, v_ref_, dq_;
+  std::deque<std::pair<double, Eigen::VectorXd>> pending_u_;
+
+};
+
+} // namespace idocp
+
+#include "idocp/sim/closed_loop_simulator.hxx"
+
+#endif // IDOCP_CLOSED_LOOP_SIMULATOR_HPP_
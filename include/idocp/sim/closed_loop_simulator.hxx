@@ -0,0 +1,209 @@
+#ifndef IDOCP_CLOSED_LOOP_SIMULATOR_HXX_
+#define IDOCP_CLOSED_LOOP_SIMULATOR_HXX_
+
+#include "idocp/sim/closed_loop_simulator.hpp"
+
+#include <stdexcept>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <cassert>
+
+
+namespace idocp {
+
+inline void ClosedLoopSimulationResult::showInfo() const {
+  std::cout << "---------- Closed-loop simulation ----------" << std::endl;
+  std::cout << "number of ticks: " << num_ticks << std::endl;
+  std::cout << "simulated time: " << simulated_time << "[s]" << std::endl;
+  std::cout << "wall time: " << wall_time << "[s]" << std::endl;
+  std::cout << "real time factor: " << real_time_factor << std::endl;
+  std::cout << "latency (mean / max / p99): " << 1e03 * mean_latency << " / "
+            << 1e03 * max_latency << " / " << 1e03 * p99_latency << "[ms]"
+            << std::endl;
+  std::cout << "configuration error (RMS): " << configuration_error_rms
+            << std::endl;
+  std::cout << "velocity error (RMS): " << velocity_error_rms << std::endl;
+  std::cout << "diverged: " << std::boolalpha << diverged << std::endl;
+  std::cout << "--------------------------------------------" << std::endl;
+  std::cout << std::endl;
+}
+
+
+template <typename MPCType>
+inline ClosedLoopSimulator<MPCType>::ClosedLoopSimulator(
+    MPCType& mpc, const Robot& robot, const double control_period,
+    const double sim_time_step)
+  : mpc_(&mpc),
+    robot_(robot),
+    sim_(robot, sim_time_step),
+    reference_(),
+    control_period_(control_period),
+    latency_(0),
+    add_measured_latency_(false),
+    q_(Eigen::VectorXd::Zero(robot.dimq())),
+    v_(Eigen::VectorXd::Zero(robot.dimv())),
+    u_(Eigen::VectorXd::Zero(robot.dimu())),
+    q_ref_(Eigen::VectorXd::Zero(robot.dimq())),
+    v_ref_(Eigen::VectorXd::Zero(robot.dimv())),
+    dq_(Eigen::VectorXd::Zero(robot.dimv())),
+    pending_u_() {
+  try {
+    if (control_period <= 0) {
+      throw std::out_of_range(
+          "invalid value: control_period must be positive!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+
+template <typename MPCType>
+inline ClosedLoopSimulator<MPCType>::~ClosedLoopSimulator() {
+}
+
+
+template <typename MPCType>
+inline void ClosedLoopSimulator<MPCType>::setGroundModel(
+    const double stiffness, const double damping,
+    const double tangential_damping, const double mu) {
+  sim_.setGroundModel(stiffness, damping, tangential_damping, mu);
+}
+
+
+template <typename MPCType>
+inline void ClosedLoopSimulator<MPCType>::setSolverLatency(
+    const double latency, const bool add_measured_latency) {
+  try {
+    if (latency < 0) {
+      throw std::out_of_range("invalid value: latency must be non-negative!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  latency_ = latency;
+  add_measured_latency_ = add_measured_latency;
+}
+
+
+template <typename MPCType>
+inline void ClosedLoopSimulator<MPCType>::setReference(
+    const Reference& reference) {
+  reference_ = reference;
+}
+
+
+template <typename MPCType>
+inline ClosedLoopSimulationResult ClosedLoopSimulator<MPCType>::run(
+    const double t0, const Eigen::VectorXd& q0, const Eigen::VectorXd& v0,
+    const double sim_time, const int num_iteration) {
+  try {
+    if (sim_time <= 0) {
+      throw std::out_of_range("invalid value: sim_time must be positive!");
+    }
+    if (num_iteration <= 0) {
+      throw std::out_of_range("invalid value: num_iteration must be positive!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  assert(q0.size() == robot_.dimq());
+  assert(v0.size() == robot_.dimv());
+  q_ = q0;
+  v_ = v0;
+  u_ = mpc_->getInitialControlInput();
+  pending_u_.clear();
+  const int num_ticks = std::floor(sim_time/control_period_+1.0e-08);
+  ClosedLoopSimulationResult result;
+  result.latency.reserve(num_ticks);
+  double config_error = 0;
+  double velocity_error = 0;
+  const auto start_clock = std::chrono::steady_clock::now();
+  for (int k=0; k<num_ticks; ++k) {
+    const double t = t0 + k * control_period_;
+    const double t_next = t + control_period_;
+    // The wall-clock time is the delay seen by the control loop, which also
+    // holds for the multi-threaded solvers.
+    const auto start_update = std::chrono::steady_clock::now();
+    mpc_->updateSolution(t, q_, v_, num_iteration);
+    const auto end_update = std::chrono::steady_clock::now();
+    const double latency
+        = 1.0e-06 * std::chrono::duration_cast<std::chrono::microseconds>(
+            end_update-start_update).count();
+    result.latency.push_back(latency);
+    const double delay = latency_ + (add_measured_latency_ ? latency : 0);
+    pending_u_.emplace_back(t+delay, mpc_->getInitialControlInput());
+    // Holds the previous input until the new one arrives.
+    double t_sim = t;
+    while (!pending_u_.empty() && pending_u_.front().first < t_next) {
+      const double t_arrival = pending_u_.front().first;
+      if (t_arrival > t_sim) {
+        sim_.integrate(t_arrival-t_sim, u_, q_, v_);
+        t_sim = t_arrival;
+      }
+      u_ = pending_u_.front().second;
+      pending_u_.pop_front();
+    }
+    sim_.integrate(t_next-t_sim, u_, q_, v_);
+    ++result.num_ticks;
+    if (!q_.allFinite() || !v_.allFinite()) {
+      result.diverged = true;
+      break;
+    }
+    if (reference_) {
+      reference_(t_next, q_ref_, v_ref_);
+      robot_.subtractConfiguration(q_, q_ref_, dq_);
+      config_error += dq_.squaredNorm();
+      velocity_error += (v_-v_ref_).squaredNorm();
+    }
+  }
+  const auto end_clock = std::chrono::steady_clock::now();
+  result.simulated_time = result.num_ticks * control_period_;
+  result.wall_time
+      = 1.0e-06 * std::chrono::duration_cast<std::chrono::microseconds>(
+          end_clock-start_clock).count();
+  if (result.wall_time > 0) {
+    result.real_time_factor = result.simulated_time / result.wall_time;
+  }
+  if (result.num_ticks > 0) {
+    std::vector<double> sorted_latency(result.latency);
+    std::sort(sorted_latency.begin(), sorted_latency.end());
+    double sum = 0;
+    for (const auto e : sorted_latency) { sum += e; }
+    result.mean_latency = sum / result.num_ticks;
+    result.max_latency = sorted_latency.back();
+    const int p99 = std::ceil(0.99*result.num_ticks) - 1;
+    result.p99_latency = sorted_latency[std::max(p99, 0)];
+    if (reference_) {
+      result.configuration_error_rms
+          = std::sqrt(config_error/result.num_ticks);
+      result.velocity_error_rms = std::sqrt(velocity_error/result.num_ticks);
+    }
+  }
+  return result;
+}
+
+
+template <typename MPCType>
+inline const Eigen::VectorXd& ClosedLoopSimulator<MPCType>::q() const {
+  return q_;
+}
+
+
+template <typename MPCType>
+inline const Eigen::VectorXd& ClosedLoopSimulator<MPCType>::v() const {
+  return v_;
+}
+
+} // namespace idocp
+
+#endif // IDOCP_CLOSED_LOOP_SIMULATOR_HXX_
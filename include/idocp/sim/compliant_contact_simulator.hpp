@@ -0,0 +1,144 @@
+#ifndef IDOCP_COMPLIANT_CONTACT_SIMULATOR_HPP_
+#define IDOCP_COMPLIANT_CONTACT_SIMULATOR_HPP_
+
+#include <vector>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/robot/contact_status.hpp"
+
+
+namespace idocp {
+
+///
+/// @class CompliantContactSimulator
+/// @brief Headless simulator of the rigid-body dynamics of the robot in
+/// contact with a flat ground at z = 0. Each contact frame of the robot
+/// penetrating the ground is pushed back by a spring-damper in the normal
+/// direction and a viscous friction in the tangential directions, which is
+/// saturated at the friction cone. The dynamics is integrated by the
+/// semi-implicit Euler method.
+///
+class CompliantContactSimulator {
+public:
+  ///
+  /// @brief Constructs the simulator.
+  /// @param[in] robot Robot model.
+  /// @param[in] time_step Time step of the simulation. Must be positive.
+  /// Default is 5.0e-04.
+  ///
+  CompliantContactSimulator(const Robot& robot,
+                            const double time_step=5.0e-04);
+
+  ///
+  /// @brief Default constructor.
+  ///
+  CompliantContactSimulator();
+
+  ///
+  /// @brief Destructor.
+  ///
+  ~CompliantContactSimulator();
+
+  ///
+  /// @brief Default copy constructor.
+  ///
+  CompliantContactSimulator(const CompliantContactSimulator&) = default;
+
+  ///
+  /// @brief Default copy operator.
+  ///
+  CompliantContactSimulator& operator=(const CompliantContactSimulator&)
+      = default;
+
+  ///
+  /// @brief Default move constructor.
+  ///
+  CompliantContactSimulator(CompliantContactSimulator&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator.
+  ///
+  CompliantContactSimulator& operator=(CompliantContactSimulator&&) noexcept
+      = default;
+
+  ///
+  /// @brief Sets the parameters of the ground model.
+  /// @param[in] stiffness Stiffness of the ground in the normal direction.
+  /// Must be positive. Default is 5.0e04.
+  /// @param[in] damping Damping of the ground in the normal direction. Must
+  /// be non-negative. Default is 1.0e03.
+  /// @param[in] tangential_damping Coefficient of the viscous friction. Must
+  /// be non-negative. Default is 1.0e03.
+  /// @param[in] mu Friction coefficient. Must be positive. Default is 0.7.
+  ///
+  void setGroundModel(const double stiffness, const double damping,
+                      const double tangential_damping, const double mu);
+
+  ///
+  /// @brief Simulates the robot over the given duration with the constant
+  /// control input.
+  /// @param[in] duration Duration of the simulation. Must be non-negative.
+  /// If it is not a multiple of the time step, the last step is shortened.
+  /// @param[in] u Control input, i.e., the torques of the actuated joints.
+  /// Size must be Robot::dimu().
+  /// @param[in, out] q Configuration. Size must be Robot::dimq().
+  /// @param[in, out] v Generalized velocity. Size must be Robot::dimv().
+  ///
+  void integrate(const double duration, const Eigen::VectorXd& u,
+                 Eigen::VectorXd& q, Eigen::VectorXd& v);
+
+  ///
+  /// @brief Simulates the robot over one time step with the constant control
+  /// input.
+  /// @param[in] time_step Time step. Must be positive.
+  /// @param[in] u Control input, i.e., the torques of the actuated joints.
+  /// Size must be Robot::dimu().
+  /// @param[in, out] q Configuration. Size must be Robot::dimq().
+  /// @param[in, out] v Generalized velocity. Size must be Robot::dimv().
+  ///
+  void step(const double time_step, const Eigen::VectorXd& u,
+            Eigen::VectorXd& q, Eigen::VectorXd& v);
+
+  ///
+  /// @brief Returns the contact forces expressed in the world frame computed
+  /// in the last step.
+  /// @return const reference to the contact forces. Size is
+  /// Robot::maxPointContacts().
+  ///
+  const std::vector<Eigen::Vector3d>& contactForces() const;
+
+  ///
+  /// @brief Returns the contact status, i.e., the contacts penetrating the
+  /// ground, in the last step.
+  /// @return const reference to the contact status.
+  ///
+  const ContactStatus& contactStatus() const;
+
+  ///
+  /// @brief Returns the time step of the simulation.
+  /// @return Time step of the simulation.
+  ///
+  double timeStep() const;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+  Robot robot_;
+  ContactStatus contact_status_;
+  std::vector<int> contact_frames_;
+  std::vector<Eigen::Vector3d> f_world_, f_local_;
+  Eigen::MatrixXd J_;
+  Eigen::VectorXd tau_, a_;
+  Eigen::Vector3d v_frame_;
+  double time_step_, stiffness_, damping_, tangential_damping_, mu_;
+
+  void computeContactForces(const Eigen::VectorXd& q,
+                            const Eigen::VectorXd& v);
+
+};
+
+} // namespace idocp
+
+#endif // IDOCP_COMPLIANT_CONTACT_SIMULATOR_HPP_
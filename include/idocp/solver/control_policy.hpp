@@ -0,0 +1,151 @@
+#ifndef IDOCP_CONTROL_POLICY_HPP_
+#define IDOCP_CONTROL_POLICY_HPP_
+
+#include <vector>
+#include <cassert>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+
+
+namespace idocp {
+
+///
+/// @class ControlPolicy
+/// @brief The control policy published by the solver to the control loop, 
+/// i.e., the control input and the state feedback gain at the initial stage, 
+/// and the short trajectory of the solution from the initial stage. All of 
+/// the members are allocated in the constructor so that the policy can be 
+/// copied without dynamic memory allocation.
+///
+class ControlPolicy {
+public:
+  ///
+  /// @brief Constructs the control policy.
+  /// @param[in] robot Robot model. 
+  /// @param[in] num_stages Number of the time stages of the trajectory. 
+  /// Must be positive. Default is 1.
+  ///
+  ControlPolicy(const Robot& robot, const int num_stages=1)
+    : t(0),
+      u(Eigen::VectorXd::Zero(robot.dimu())),
+      Kq(Eigen::MatrixXd::Zero(robot.dimu(), robot.dimv())),
+      Kv(Eigen::MatrixXd::Zero(robot.dimu(), robot.dimv())),
+      t_traj(Eigen::VectorXd::Zero(num_stages)),
+      q_traj(num_stages, Eigen::VectorXd::Zero(robot.dimq())),
+      v_traj(num_stages, Eigen::VectorXd::Zero(robot.dimv())),
+      u_traj(num_stages, Eigen::VectorXd::Zero(robot.dimu())),
+      Kq_traj(num_stages, Eigen::MatrixXd::Zero(robot.dimu(), robot.dimv())),
+      Kv_traj(num_stages, Eigen::MatrixXd::Zero(robot.dimu(), robot.dimv())) {
+    assert(num_stages > 0);
+  }
+
+  ///
+  /// @brief Default constructor. 
+  ///
+  ControlPolicy() 
+    : t(0),
+      u(),
+      Kq(),
+      Kv(),
+      t_traj(),
+      q_traj(),
+      v_traj(),
+      u_traj(),
+      Kq_traj(),
+      Kv_traj() {
+  }
+
+  ///
+  /// @brief Destructor. 
+  ///
+  ~ControlPolicy() {
+  }
+
+  ///
+  /// @brief Default copy constructor. 
+  ///
+  ControlPolicy(const ControlPolicy&) = default;
+
+  ///
+  /// @brief Default copy operator. 
+  ///
+  ControlPolicy& operator=(const ControlPolicy&) = default;
+
+  ///
+  /// @brief Default move constructor. 
+  ///
+  ControlPolicy(ControlPolicy&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator. 
+  ///
+  ControlPolicy& operator=(ControlPolicy&&) noexcept = default;
+
+  ///
+  /// @brief Initial time of the horizon at which the policy is computed.
+  ///
+  double t;
+
+  ///
+  /// @brief Control input at the initial stage. Size is Robot::dimu().
+  ///
+  Eigen::VectorXd u;
+
+  ///
+  /// @brief State feedback gain w.r.t. the configuration at the initial 
+  /// stage. Size is Robot::dimu() x Robot::dimv().
+  ///
+  Eigen::MatrixXd Kq;
+
+  ///
+  /// @brief State feedback gain w.r.t. the velocity at the initial stage. 
+  /// Size is Robot::dimu() x Robot::dimv().
+  ///
+  Eigen::MatrixXd Kv;
+
+  ///
+  /// @brief Time of each stage of the trajectory. 
+  ///
+  Eigen::VectorXd t_traj;
+
+  ///
+  /// @brief Configuration trajectory. Size of each element is Robot::dimq().
+  ///
+  std::vector<Eigen::VectorXd> q_traj;
+
+  ///
+  /// @brief Velocity trajectory. Size of each element is Robot::dimv().
+  ///
+  std::vector<Eigen::VectorXd> v_traj;
+
+  ///
+  /// @brief Control input trajectory. Size of each element is Robot::dimu().
+  ///
+  std::vector<Eigen::VectorXd> u_traj;
+
+  ///
+  /// @brief Trajectory of the state feedback gain w.r.t. the configuration. 
+  /// Size of each element is Robot::dimu() x Robot::dimv().
+  ///
+  std::vector<Eigen::MatrixXd> Kq_traj;
+
+  ///
+  /// @brief Trajectory of the state feedback gain w.r.t. the velocity. 
+  /// Size of each element is Robot::dimu() x Robot::dimv().
+  ///
+  std::vector<Eigen::MatrixXd> Kv_traj;
+
+  ///
+  /// @return Number of the time stages of the trajectory.
+  ///
+  int numStages() const {
+    return t_traj.size();
+  }
+
+};
+
+} // namespace idocp 
+
+#endif // IDOCP_CONTROL_POLICY_HPP_ 
@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <memory>
+#include <string>
+#include <iostream>
 
 #include "Eigen/Core"
 
@@ -11,6 +13,7 @@
 #include "idocp/cost/cost_function.hpp"
 #include "idocp/constraints/constraints.hpp"
 #include "idocp/hybrid/contact_sequence.hpp"
+#include "idocp/hybrid/switching_time_optimization.hpp"
 #include "idocp/ocp/ocp.hpp"
 #include "idocp/ocp/solution.hpp"
 #include "idocp/ocp/direction.hpp"
@@ -19,10 +22,30 @@
 #include "idocp/ocp/direct_multiple_shooting.hpp"
 #include "idocp/riccati/riccati_recursion.hpp"
 #include "idocp/line_search/line_search.hpp"
+#include "idocp/solver/control_policy.hpp"
+#include "idocp/utils/real_time_profile.hpp"
+#include "idocp/utils/perf_counters.hpp"
+#include "idocp/utils/warm_start_library.hpp"
 
 
 namespace idocp {
 
+///
+/// @enum OCPSolverPhase
+/// @brief Phases of OCPSolver::updateSolution() whose hardware performance 
+/// counters are collected by OCPSolver::startPerfCounters().
+///
+enum class OCPSolverPhase {
+  Discretization,
+  KKTSystem,
+  SwitchingTimeOptimization,
+  BackwardRiccatiRecursion,
+  ForwardRiccatiRecursion,
+  Direction,
+  LineSearch,
+  Integration
+};
+
 ///
 /// @class OCPSolver
 /// @brief Optimal control problem solver by Riccati recursion. 
@@ -75,6 +98,35 @@ public:
   ///
   OCPSolver& operator=(OCPSolver&&) noexcept = default;
 
+  ///
+  /// @brief Sets the step sizes of the discretization grids, e.g., fine near 
+  /// the initial time and coarse far out. The impulse and lift stages are 
+  /// inserted into these grids as into the uniform grids. 
+  /// @param[in] dt Step sizes of the N grids. Each step size must be positive
+  /// and the sum must be T.
+  ///
+  void setDiscretizationGrid(const std::vector<double>& dt);
+
+  ///
+  /// @brief Sets geometrically growing step sizes of the discretization 
+  /// grids, i.e., the step size of each grid is ratio times that of the 
+  /// previous grid and the sum is T. 
+  /// @param[in] ratio Ratio of the step sizes of the neighbouring grids. 
+  /// Must be positive. 1 yields the uniform grids, which is the default.
+  ///
+  void setGeometricDiscretizationGrid(const double ratio);
+
+  ///
+  /// @brief Sets the parameters of the switching time optimization of the 
+  /// discrete events whose switching time optimization is enabled. 
+  /// @param[in] hessian Constant approximation of the Hessian of the 
+  /// Lagrangian with respect to each switching time, which scales the 
+  /// gradient step. Must be positive. Default is 1.0e03.
+  /// @param[in] max_step_size Maximum change of each switching time in a 
+  /// single iteration. Must be positive. Default is 0.01.
+  ///
+  void setSTOParameters(const double hessian, const double max_step_size);
+
   ///
   /// @brief Initializes the priaml-dual interior point method for inequality 
   /// constraints. 
@@ -89,8 +141,12 @@ public:
   /// @param[in] v Initial velocity. Size must be Robot::dimv().
   /// @param[in] line_search If true, filter line search is enabled. If false
   /// filter line search is disabled. Default is false.
+  /// @return true if the solution is updated. false if the Riccati 
+  /// factorization failed because the Hessian of a stage was not positive 
+  /// definite even with the maximum regularization. Then the solution is not 
+  /// updated and the caller should stop the iteration.
   ///
-  void updateSolution(const double t, const Eigen::VectorXd& q, 
+  bool updateSolution(const double t, const Eigen::VectorXd& q, 
                       const Eigen::VectorXd& v, const bool line_search=false);
 
   ///
@@ -109,6 +165,8 @@ public:
   /// option == "WORLD", the contact forces expressed in the world frame is 
   /// returned. if option is set to other values, these expressed in the local
   /// frame are returned.
+  /// If name == "t", the times of the time stages are returned, which is 
+  /// useful with non-uniform discretization grids.
   /// @return Solution vector.
   ///
   std::vector<Eigen::VectorXd> getSolution(const std::string& name,
@@ -126,6 +184,16 @@ public:
   void getStateFeedbackGain(const int stage, Eigen::MatrixXd& Kq, 
                             Eigen::MatrixXd& Kv) const;
 
+  ///
+  /// @brief Gets the control policy, i.e., the control input and the 
+  /// state-feedback gain at the initial stage and the short trajectory of the 
+  /// solution. OCPSolver::updateSolution() must be called. Does not allocate 
+  /// memory if the policy is constructed with the same robot model.
+  /// @param[out] policy The control policy. ControlPolicy::numStages() must 
+  /// not be larger than N.
+  ///
+  void getControlPolicy(ControlPolicy& policy) const;
+
   ///
   /// @brief Sets the solution over the horizon. 
   /// @param[in] name Name of the variable. 
@@ -184,6 +252,20 @@ public:
   ///
   void clearLineSearchFilter();
 
+  ///
+  /// @brief Enables or disables the second-order correction of the filter 
+  /// line search. If the full step is rejected by the filter, the residuals 
+  /// of the state equations and the switching constraints at the rejected 
+  /// trial point are solved by the Riccati factorization of the current 
+  /// iteration, and the corrected step is tested before the backtracking. 
+  /// Reduces the backtracking, e.g., when the floating base rotates fast. 
+  /// Effective only if the line search is enabled in 
+  /// OCPSolver::updateSolution(). Default is false.
+  /// @param[in] second_order_correction If true, the second-order correction
+  /// is enabled. 
+  ///
+  void setSecondOrderCorrection(const bool second_order_correction);
+
   ///
   /// @brief Computes the KKT residual of the optimal control problem. 
   /// @param[in] t Initial time of the horizon. 
@@ -194,7 +276,8 @@ public:
                           const Eigen::VectorXd& v);
 
   ///
-  /// @brief Returns the l2-norm of the KKT residuals.
+  /// @brief Returns the l2-norm of the KKT residuals including the gradients
+  /// with respect to the STO-enabled switching times.
   /// OCPsolver::computeKKTResidual() must be called.  
   /// @return The l2-norm of the KKT residual.
   ///
@@ -208,6 +291,54 @@ public:
   ///
   double cost() const;
 
+  ///
+  /// @brief Returns the largest regularization added to the KKT matrices in 
+  /// the Riccati recursion of the last OCPsolver::updateSolution(). Nonzero 
+  /// if the Hessian of a stage was not positive definite. 
+  /// @return The largest regularization.
+  ///
+  double regularization() const;
+
+  ///
+  /// @brief Enables or disables the mixed-precision factorization of the 
+  /// backward Riccati recursion, which computes the dense products of the 
+  /// Riccati factorization matrix and the Jacobians of the state equation in 
+  /// single precision. The KKT residual and the Riccati factorization vector 
+  /// are computed in double precision, so the iterations converge to the 
+  /// same solution. Pays off for robots with many degrees of freedom, e.g., 
+  /// dimv >= 18. Default is false.
+  /// @param[in] mixed_precision If true, the mixed-precision factorization 
+  /// is enabled. 
+  ///
+  void setMixedPrecisionRiccati(const bool mixed_precision);
+
+  ///
+  /// @brief Sets the intervals of the multi-level iteration. Each 
+  /// OCPSolver::updateSolution() evaluates the whole KKT system and performs 
+  /// the full Riccati recursion every full_update_interval iterations, 
+  /// reuses the Hessians and the Riccati factorization matrices and 
+  /// recomputes the Jacobians and the feedback gains every 
+  /// jacobian_update_interval iterations, and otherwise evaluates only the 
+  /// KKT residual and recomputes only the feedforward terms. The full 
+  /// iteration is also performed whenever the contact sequence or the hybrid 
+  /// structure of the horizon changes. Default is (1, 1), i.e., the full 
+  /// iteration at every iteration.
+  /// @param[in] full_update_interval Interval of the full Riccati recursion. 
+  /// Must be positive.
+  /// @param[in] jacobian_update_interval Interval of the update of the 
+  /// feedback gains. Must be positive and not larger than 
+  /// full_update_interval.
+  ///
+  void setMultiLevelIteration(const int full_update_interval, 
+                              const int jacobian_update_interval);
+
+  ///
+  /// @brief Returns the level of the multi-level iteration performed in the 
+  /// last OCPsolver::updateSolution(). 
+  /// @return The level of the last iteration.
+  ///
+  IterationLevel iterationLevel() const;
+
   ///
   /// @return true if the current solution is feasible subject to the 
   /// inequality constraints. Return false if it is not feasible.
@@ -235,6 +366,163 @@ public:
   ///
   void showInfo() const;
 
+  ///
+  /// @brief Saves the snapshot of the solver, i.e., the dimensions of the
+  /// robot model, the contact sequence, the solution, the slack and dual
+  /// variables of the inequality constraints, and the states of the 
+  /// multi-level iteration, the Riccati recursion, and the line search filter,
+  /// to a binary file. The KKT matrices are not saved. The solver is not 
+  /// modified.
+  /// @param[in] file_name Name of the binary file.
+  /// @param[in] t Initial time of the horizon.
+  /// @return true if the snapshot is saved successfully. false if not.
+  ///
+  bool saveSnapshot(const std::string& file_name, const double t) const;
+
+  ///
+  /// @brief Loads the snapshot of the solver saved by
+  /// OCPSolver::saveSnapshot(). The solver must be constructed by the same
+  /// robot model, N, and max_num_impulse as the saved solver. After loading,
+  /// OCPSolver::initConstraints() must not be called to keep the loaded slack
+  /// and dual variables. The next OCPSolver::updateSolution() evaluates the 
+  /// KKT system fully since the KKT matrices are not saved.
+  /// @param[in] file_name Name of the binary file.
+  /// @return true if the snapshot is loaded successfully. false if not, e.g.,
+  /// the file does not exist or the dimensions are inconsistent. In this case,
+  /// the solver is not modified.
+  ///
+  bool loadSnapshot(const std::string& file_name);
+
+  ///
+  /// @brief Writes the snapshot of the solver to a binary stream. See 
+  /// OCPSolver::saveSnapshot() for details. 
+  /// @param[in, out] os Output binary stream.
+  /// @param[in] t Initial time of the horizon.
+  /// @return true if the snapshot is written successfully. false if not.
+  ///
+  bool saveSnapshot(std::ostream& os, const double t) const;
+
+  ///
+  /// @brief Reads the snapshot of the solver from a binary stream. See 
+  /// OCPSolver::loadSnapshot() for details. 
+  /// @param[in, out] is Input binary stream.
+  /// @return true if the snapshot is read successfully. false if not. In this 
+  /// case, the solver is not modified.
+  ///
+  bool loadSnapshot(std::istream& is);
+
+  ///
+  /// @brief Adds the current solution and the slack and dual variables of 
+  /// the inequality constraints to the warm-start library as an entry. The 
+  /// time stages, the lift stages, and the auxiliary stages of the impulses 
+  /// are added as the points in the order of time. The solution should be 
+  /// converged beforehand.
+  /// @param[in, out] builder Warm-start library. Must be constructed by the 
+  /// same robot model as the solver.
+  /// @param[in] key Key of the entry.
+  /// @param[in] t Initial time of the horizon.
+  ///
+  void addWarmStartEntry(WarmStartLibraryBuilder& builder, 
+                         const WarmStartKey& key, const double t);
+
+  ///
+  /// @brief Warm-starts the solver from the nearest entry of the warm-start 
+  /// library. The entry is interpolated onto the time stages, the lift 
+  /// stages, and the auxiliary stages of the current discretization over the 
+  /// current contact sequence, so that the entry can be saved with a 
+  /// different N or a different contact sequence. The impulse stages take 
+  /// the configuration and the velocity of the auxiliary stages. The slack 
+  /// and dual variables are initialized by OCPSolver::initConstraints() and 
+  /// then overwritten by the entry where the dimensions are consistent. 
+  /// After loading, OCPSolver::initConstraints() must not be called to keep 
+  /// the loaded slack and dual variables.
+  /// @param[in] library Warm-start library. 
+  /// @param[in] key Key to be looked up. See WarmStartLibrary::findNearest().
+  /// @param[in] t Initial time of the horizon.
+  /// @param[in] phase_weight Weight on the distance of the phases. Default 
+  /// is 1.
+  /// @return true if the solver is warm-started. false if not, e.g., the 
+  /// library is inconsistent with the robot model or has no entry of the 
+  /// gait. In this case, the solver is not modified.
+  ///
+  bool loadWarmStart(const WarmStartLibrary& library, const WarmStartKey& key,
+                     const double t, const double phase_weight=1);
+
+  ///
+  /// @brief Starts recording the solver inputs to a binary trace. The trace 
+  /// begins with the snapshot of the solver and is followed by every call 
+  /// that modifies the solver, e.g., OCPSolver::updateSolution(), 
+  /// OCPSolver::pushBackContactStatus(), and OCPSolver::setContactPoints(), 
+  /// with its arguments. The trace can be re-executed by OCPSolverReplayer. 
+  /// As after OCPSolver::loadSnapshot(), the next OCPSolver::updateSolution()
+  /// evaluates the KKT system fully so that the replay follows the recorded 
+  /// iterations. If the solver is already recording, the previous trace is 
+  /// closed.
+  /// @param[in] file_name Name of the binary trace.
+  /// @param[in] t Initial time of the horizon.
+  /// @return true if the recording is started successfully. false if not.
+  ///
+  bool startRecording(const std::string& file_name, const double t);
+
+  ///
+  /// @brief Stops recording and closes the trace.
+  ///
+  void stopRecording();
+
+  ///
+  /// @return true if the solver is recording. false if not.
+  ///
+  bool isRecording() const;
+
+  ///
+  /// @brief Applies the real-time execution profile. The process settings 
+  /// (memory locking) are applied first, and then the thread settings 
+  /// (CPU affinity, SCHED_FIFO priority, and stack prefault) are applied to 
+  /// the calling thread and to the OpenMP worker threads of this solver. 
+  /// Finally, the memory touched by OCPSolver::updateSolution() is 
+  /// pre-faulted by solving once with the given state, after which the 
+  /// solver is restored. Must be called from the thread that calls 
+  /// OCPSolver::updateSolution(), since the OpenMP worker threads belong to 
+  /// that thread. Not recorded in the trace. 
+  /// @param[in] profile Real-time execution profile.
+  /// @param[in] t Initial time of the horizon used in the pre-fault. 
+  /// @param[in] q Initial configuration used in the pre-fault. Size must be 
+  /// Robot::dimq().
+  /// @param[in] v Initial velocity used in the pre-fault. Size must be 
+  /// Robot::dimv().
+  /// @return true if all the settings are applied. false if not, e.g., due 
+  /// to the lack of the privileges. The settings that succeeded remain 
+  /// applied.
+  ///
+  bool applyRealTimeProfile(const RealTimeProfile& profile, const double t, 
+                            const Eigen::VectorXd& q, const Eigen::VectorXd& v);
+
+  ///
+  /// @brief Starts collecting the hardware performance counters, i.e., 
+  /// cycles, instructions, L1 data cache misses, last level cache misses, 
+  /// and branch misses, of each phase of OCPSolver::updateSolution(). The 
+  /// counts are aggregated per OCPSolverPhase over the calls and over the 
+  /// OpenMP threads. Must be called from the thread that calls 
+  /// OCPSolver::updateSolution(). The previous counts are discarded.
+  /// @return true if the counters are available. false if not, e.g., 
+  /// perf_event_open() is not permitted. In this case, nothing is collected.
+  ///
+  bool startPerfCounters();
+
+  ///
+  /// @brief Stops collecting the hardware performance counters. The 
+  /// collected counts are discarded.
+  ///
+  void stopPerfCounters();
+
+  ///
+  /// @return Shared ptr to the counters collected since 
+  /// OCPSolver::startPerfCounters(). The phases are indexed by 
+  /// OCPSolverPhase. nullptr if the counters are not started or not 
+  /// available. Shared with the copies of this solver.
+  ///
+  std::shared_ptr<const PerfCounters> getPerfCounters() const;
+
 private:
   aligned_vector<Robot> robots_;
   ContactSequence contact_sequence_;
@@ -247,9 +535,24 @@ private:
   Solution s_;
   Direction d_;
   RiccatiFactorization riccati_factorization_;
+  SwitchingTimeOptimization sto_;
+  int full_update_interval_, jacobian_update_interval_, iteration_count_;
+  bool is_kkt_system_reusable_;
+  std::shared_ptr<std::ostream> trace_;
+  std::shared_ptr<PerfCounters> perf_counters_;
 
   void discretizeSolution();
 
+  static void discretizeSolution(const ContactSequence& contact_sequence,
+                                 const HybridTimeDiscretization& discretization,
+                                 Solution& s);
+
+  IterationLevel nextIterationLevel();
+
+  void beginPhase(const OCPSolverPhase phase);
+
+  void endPhase(const OCPSolverPhase phase);
+
 };
 
 } // namespace idocp 
@@ -0,0 +1,154 @@
+#ifndef IDOCP_OCP_SOLVER_TRACE_HPP_
+#define IDOCP_OCP_SOLVER_TRACE_HPP_
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <fstream>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/robot/contact_status.hpp"
+#include "idocp/solver/ocp_solver.hpp"
+
+
+namespace idocp {
+
+///
+/// @enum OCPSolverTraceEvent
+/// @brief Calls of OCPSolver recorded in the binary trace by
+/// OCPSolver::startRecording().
+///
+enum class OCPSolverTraceEvent : char {
+  Snapshot,
+  UpdateSolution,
+  ComputeKKTResidual,
+  InitConstraints,
+  SetSolution,
+  SetContactStatusUniformly,
+  PushBackContactStatus,
+  SetContactPoints,
+  PopBackContactStatus,
+  PopFrontContactStatus,
+  ClearLineSearchFilter,
+  SetDiscretizationGrid,
+  SetGeometricDiscretizationGrid,
+  SetSTOParameters,
+  SetMultiLevelIteration,
+  SetMixedPrecisionRiccati,
+  SetSecondOrderCorrection
+};
+
+///
+/// @brief Writes the header of the binary trace, i.e., the identifier and 
+/// the version of the format. Used by OCPSolver::startRecording().
+/// @param[in, out] os Output binary stream.
+///
+void writeOCPSolverTraceHeader(std::ostream& os);
+
+///
+/// @class OCPSolverReplayer
+/// @brief Re-executes the binary trace recorded by
+/// OCPSolver::startRecording() on a solver, e.g., to profile a slow update
+/// of the MPC offline. The solver must be constructed by the same robot
+/// model, cost function, constraints, T, N, and max_num_impulse as the
+/// recorded solver. Since the trace contains the snapshot of the solver at
+/// the beginning of the recording and every call that modifies the solver,
+/// the replay is deterministic up to the floating point non-associativity of
+/// the parallel computations.
+///
+class OCPSolverReplayer {
+public:
+  ///
+  /// @brief Opens the binary trace.
+  /// @param[in] robot Robot model.
+  /// @param[in] file_name Name of the binary trace.
+  ///
+  OCPSolverReplayer(const Robot& robot, const std::string& file_name);
+
+  ///
+  /// @brief Default constructor.
+  ///
+  OCPSolverReplayer();
+
+  ///
+  /// @brief Destructor.
+  ///
+  ~OCPSolverReplayer();
+
+  ///
+  /// @brief Prohibits copy constructor.
+  ///
+  OCPSolverReplayer(const OCPSolverReplayer&) = delete;
+
+  ///
+  /// @brief Prohibits copy operator.
+  ///
+  OCPSolverReplayer& operator=(const OCPSolverReplayer&) = delete;
+
+  ///
+  /// @brief Default move constructor.
+  ///
+  OCPSolverReplayer(OCPSolverReplayer&&) = default;
+
+  ///
+  /// @brief Default move assign operator.
+  ///
+  OCPSolverReplayer& operator=(OCPSolverReplayer&&) = default;
+
+  ///
+  /// @brief Reads the header of the trace and loads the recorded snapshot
+  /// into the solver. Must be called before OCPSolverReplayer::replayNext().
+  /// @param[in, out] ocp_solver The solver.
+  /// @return true if the trace is valid and the snapshot is loaded. false if
+  /// not.
+  ///
+  bool init(OCPSolver& ocp_solver);
+
+  ///
+  /// @brief Re-executes the next recorded call on the solver.
+  /// @param[in, out] ocp_solver The solver.
+  /// @return true if a call is re-executed. false if the trace ends or is
+  /// broken.
+  ///
+  bool replayNext(OCPSolver& ocp_solver);
+
+  ///
+  /// @return The type of the last re-executed call.
+  ///
+  OCPSolverTraceEvent lastEvent() const;
+
+  ///
+  /// @return The initial time of the horizon passed to the last re-executed
+  /// call that takes it, e.g., OCPSolver::updateSolution().
+  ///
+  double lastTime() const;
+
+  ///
+  /// @return The number of the re-executed calls.
+  ///
+  int numReplayedEvents() const;
+
+  ///
+  /// @return The number of the re-executed OCPSolver::updateSolution().
+  ///
+  int numReplayedUpdates() const;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+  std::ifstream ifs_;
+  ContactStatus contact_status_;
+  Eigen::VectorXd q_, v_, vec_;
+  std::vector<Eigen::Vector3d> contact_points_;
+  std::string name_;
+  OCPSolverTraceEvent last_event_;
+  double last_t_;
+  int num_events_, num_updates_;
+
+};
+
+} // namespace idocp
+
+#endif // IDOCP_OCP_SOLVER_TRACE_HPP_
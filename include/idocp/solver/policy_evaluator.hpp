@@ -0,0 +1,111 @@
+#ifndef IDOCP_POLICY_EVALUATOR_HPP_
+#define IDOCP_POLICY_EVALUATOR_HPP_
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/solver/control_policy.hpp"
+
+
+namespace idocp {
+
+///
+/// @class PolicyEvaluator
+/// @brief Evaluates the control input at an arbitrary time and state between 
+/// the updates of the MPC from the control policy published by the solver. 
+/// The nominal control input and state are linearly interpolated over the 
+/// time grid of the policy, and the state feedback gains are held over each 
+/// time interval, i.e., 
+/// \f[ u(t, q, v) = \bar{u}(t) + K_q (q \ominus \bar{q}(t)) 
+///     + K_v (v - \bar{v}(t)). \f]
+/// The time beyond the last stage of the policy holds the last stage. 
+/// Never allocates memory after construction.
+///
+class PolicyEvaluator {
+public:
+  ///
+  /// @brief Constructs the policy evaluator.
+  /// @param[in] robot Robot model. 
+  /// @param[in] num_stages Number of the time stages of the policy. Must be 
+  /// positive. Default is 1.
+  ///
+  PolicyEvaluator(const Robot& robot, const int num_stages=1);
+
+  ///
+  /// @brief Default constructor. 
+  ///
+  PolicyEvaluator();
+
+  ///
+  /// @brief Destructor. 
+  ///
+  ~PolicyEvaluator();
+
+  ///
+  /// @brief Default copy constructor. 
+  ///
+  PolicyEvaluator(const PolicyEvaluator&) = default;
+
+  ///
+  /// @brief Default copy assign operator. 
+  ///
+  PolicyEvaluator& operator=(const PolicyEvaluator&) = default;
+
+  ///
+  /// @brief Default move constructor. 
+  ///
+  PolicyEvaluator(PolicyEvaluator&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator. 
+  ///
+  PolicyEvaluator& operator=(PolicyEvaluator&&) noexcept = default;
+
+  ///
+  /// @brief Sets the control policy. 
+  /// @param[in] policy The control policy. The dimensions and the number of 
+  /// the time stages must be consistent with this evaluator.
+  ///
+  void setPolicy(const ControlPolicy& policy);
+
+  ///
+  /// @return Const reference to the control policy set by 
+  /// PolicyEvaluator::setPolicy().
+  ///
+  const ControlPolicy& policy() const;
+
+  ///
+  /// @brief Computes the control input. 
+  /// @param[in] t Time. 
+  /// @param[in] q Configuration. Size must be Robot::dimq().
+  /// @param[in] v Velocity. Size must be Robot::dimv().
+  /// @param[out] u Control input. Size must be Robot::dimu().
+  ///
+  void computeControlInput(const double t, const Eigen::VectorXd& q, 
+                           const Eigen::VectorXd& v, Eigen::VectorXd& u);
+
+  ///
+  /// @brief Computes the control input. 
+  /// @param[in] t Time. 
+  /// @param[in] q Configuration. Size must be Robot::dimq().
+  /// @param[in] v Velocity. Size must be Robot::dimv().
+  /// @return Const reference to the control input. Valid until the next call
+  /// of PolicyEvaluator::computeControlInput().
+  ///
+  const Eigen::VectorXd& computeControlInput(const double t, 
+                                             const Eigen::VectorXd& q, 
+                                             const Eigen::VectorXd& v);
+
+private:
+  Robot robot_;
+  ControlPolicy policy_;
+  Eigen::VectorXd q_ref_, qdiff_, dq_, dv_, u_;
+  int stage_;
+
+  void findStage(const double t);
+
+};
+
+} // namespace idocp 
+
+#endif // IDOCP_POLICY_EVALUATOR_HPP_ 
@@ -0,0 +1,210 @@
+#ifndef IDOCP_UNCONSTR_DECOMPOSED_OCP_SOLVER_HPP_
+#define IDOCP_UNCONSTR_DECOMPOSED_OCP_SOLVER_HPP_
+
+#include <vector>
+#include <memory>
+#include <string>
+
+#include <sys/types.h>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/cost/cost_function.hpp"
+#include "idocp/constraints/constraints.hpp"
+
+
+namespace idocp {
+
+///
+/// @class UnconstrDecomposedOCPSolver
+/// @brief Optimal control problem solver of unconstrained rigid-body systems
+/// by Riccati recursion with the horizon decomposed over multiple processes.
+/// The time stages are split into contiguous segments, one for each process.
+/// Each process is pinned to the CPUs of a NUMA node and allocates the data of
+/// its segment after pinning, so that the data is local to the node. The
+/// processes compute the KKT systems and the partitioned Riccati recursions
+/// of their segments in parallel by UnconstrPartitionedRiccatiRecursion, and
+/// exchange only the states and the costates at the boundaries of the
+/// segments and the couplings of the segments through a shared memory. The
+/// coupling is solved by UnconstrReducedBoundarySystem, whose size is
+/// independent of the number of the time stages. The resultant direction is
+/// the same as that of UnconstrOCPSolver. Intended for offline problems
+/// whose horizon is so long that a single process is saturated. The worker
+/// processes are forked in the constructor and run only the segments, so the
+/// cost function and the constraints must not share any state with the
+/// calling process after the construction. The worker processes do not use
+/// OpenMP since the OpenMP runtime is not fork-safe. Line search is not
+/// supported.
+///
+class UnconstrDecomposedOCPSolver {
+public:
+  ///
+  /// @brief Construct the solver and forks the worker processes.
+  /// @param[in] robot Robot model. Must be a fixed-base robot.
+  /// @param[in] cost Shared ptr to the cost function.
+  /// @param[in] constraints Shared ptr to the constraints.
+  /// @param[in] T Length of the horizon. Must be positive.
+  /// @param[in] N Number of discretization of the horizon. Must be larger
+  /// than or equal to num_processes.
+  /// @param[in] num_processes Number of the processes including the calling
+  /// process. Must be positive.
+  /// @param[in] nthreads Number of the threads in each process. Must be
+  /// positive. Default is 1.
+  /// @param[in] pin_to_numa_nodes If true, the processes, including the
+  /// calling process, are pinned to the CPUs of the NUMA nodes in a
+  /// round-robin manner. Default is true.
+  ///
+  UnconstrDecomposedOCPSolver(const Robot& robot,
+                              const std::shared_ptr<CostFunction>& cost,
+                              const std::shared_ptr<Constraints>& constraints,
+                              const double T, const int N,
+                              const int num_processes, const int nthreads=1,
+                              const bool pin_to_numa_nodes=true);
+
+  ///
+  /// @brief Destructor. Terminates the worker processes.
+  ///
+  ~UnconstrDecomposedOCPSolver();
+
+  ///
+  /// @brief Deleted copy constructor since the solver owns the processes.
+  ///
+  UnconstrDecomposedOCPSolver(const UnconstrDecomposedOCPSolver&) = delete;
+
+  ///
+  /// @brief Deleted copy operator.
+  ///
+  UnconstrDecomposedOCPSolver& operator=(
+      const UnconstrDecomposedOCPSolver&) = delete;
+
+  ///
+  /// @brief Deleted move constructor.
+  ///
+  UnconstrDecomposedOCPSolver(UnconstrDecomposedOCPSolver&&) noexcept = delete;
+
+  ///
+  /// @brief Deleted move assign operator.
+  ///
+  UnconstrDecomposedOCPSolver& operator=(
+      UnconstrDecomposedOCPSolver&&) noexcept = delete;
+
+  ///
+  /// @brief Updates the solution by computing the primal-dual Newon direction.
+  /// @param[in] t Initial time of the horizon.
+  /// @param[in] q Initial configuration. Size must be Robot::dimq().
+  /// @param[in] v Initial velocity. Size must be Robot::dimv().
+  /// @param[in] line_search Not supported. Must be false. Default is false.
+  ///
+  void updateSolution(const double t, const Eigen::VectorXd& q,
+                      const Eigen::VectorXd& v, const bool line_search=false);
+
+  ///
+  /// @brief Get the solution vector over the horizon.
+  /// @param[in] name Name of the variable. q, v, a, or u.
+  /// @return Solution vector.
+  ///
+  std::vector<Eigen::VectorXd> getSolution(const std::string& name) const;
+
+  ///
+  /// @brief Sets the solution over the horizon.
+  /// @param[in] name Name of the variable. q, v, a, or u.
+  /// @param[in] value Value of the specified variable.
+  ///
+  void setSolution(const std::string& name, const Eigen::VectorXd& value);
+
+  ///
+  /// @brief Computes the KKT residual of the optimal control problem.
+  /// @param[in] t Initial time of the horizon.
+  /// @param[in] q Initial configuration. Size must be Robot::dimq().
+  /// @param[in] v Initial velocity. Size must be Robot::dimv().
+  ///
+  void computeKKTResidual(const double t, const Eigen::VectorXd& q,
+                          const Eigen::VectorXd& v);
+
+  ///
+  /// @brief Returns the l2-norm of the KKT residuals.
+  /// UnconstrDecomposedOCPSolver::computeKKTResidual() must be called before
+  /// calling this function.
+  /// @return The l2-norm of the KKT residual.
+  ///
+  double KKTError() const;
+
+  ///
+  /// @brief Returns the total cost over the horizon computed in the last
+  /// UnconstrDecomposedOCPSolver::updateSolution() or
+  /// UnconstrDecomposedOCPSolver::computeKKTResidual().
+  /// @return The total cost over the horizon.
+  ///
+  double cost() const;
+
+  ///
+  /// @return Number of the processes including the calling process.
+  ///
+  int numProcesses() const;
+
+  ///
+  /// @param[in] process Index of the process. 0 is the calling process.
+  /// @return First time stage of the segment of the process.
+  ///
+  int stageBegin(const int process) const;
+
+  ///
+  /// @param[in] process Index of the process. 0 is the calling process.
+  /// @return CPUs to which the process is pinned. Empty if not pinned.
+  ///
+  const std::vector<int>& cpuAffinity(const int process) const;
+
+  ///
+  /// @brief Displays the segments and the CPUs of the processes onto a
+  /// ostream.
+  ///
+  void showInfo() const;
+
+private:
+  struct Segment;
+
+  Robot robot_;
+  std::shared_ptr<CostFunction> cost_;
+  std::shared_ptr<Constraints> constraints_;
+  int N_, num_processes_, nthreads_, dimq_, dimv_, dimu_;
+  double T_, dt_;
+  std::vector<int> stage_begin_;
+  std::vector<std::vector<int>> cpus_;
+  std::vector<pid_t> workers_;
+  void* shared_memory_;
+  size_t shared_memory_size_, offset_command_, offset_scalars_,
+         offset_boundary_, offset_coupling_, offset_board_;
+  std::unique_ptr<Segment> segment_;
+
+  void runWorker(const int process);
+
+  void pinCallingThread(const int process) const;
+
+  void execute(const int command);
+
+  void updateSegment();
+
+  void computeSegmentKKTResidual();
+
+  void setSegmentSolution();
+
+  void initSegment();
+
+  void publishBoundary();
+
+  void readBoundary();
+
+  void writeBoard();
+
+  void waitBarrier();
+
+  double* sharedData(const size_t offset) const;
+
+  int boardStride() const;
+
+};
+
+} // namespace idocp
+
+#endif // IDOCP_UNCONSTR_DECOMPOSED_OCP_SOLVER_HPP_
@@ -16,6 +16,7 @@
 #include "idocp/ocp/kkt_matrix.hpp"
 #include "idocp/ocp/kkt_residual.hpp"
 #include "idocp/parnmpc/unconstr_backward_correction.hpp"
+#include "idocp/parnmpc/unconstr_async_iteration.hpp"
 #include "idocp/line_search/unconstr_line_search.hpp"
 
 
@@ -97,6 +98,44 @@ public:
   void updateSolution(const double t, const Eigen::VectorXd& q, 
                       const Eigen::VectorXd& v, const bool line_search=false);
 
+  ///
+  /// @brief Sets the parameters of the asynchronous iteration used by 
+  /// UnconstrParNMPCSolver::updateSolutionAsync(). See 
+  /// UnconstrAsyncIteration for details.
+  /// @param[in] max_sweeps Maximum number of the sweeps of each thread. Must
+  /// be positive. Default is 10.
+  /// @param[in] tol Tolerance of the l2-norm of the direction over the
+  /// horizon. Must be non-negative. Default is 1.0e-08.
+  /// @param[in] deterministic If true, the threads synchronize after every 
+  /// sweep so that the result is reproducible. Default is false.
+  ///
+  void setAsyncIteration(const int max_sweeps, const double tol, 
+                         const bool deterministic=false);
+
+  ///
+  /// @brief Updates the solution by the asynchronous ParNMPC iteration. 
+  /// Instead of the coarse update, the backward correction, and the update 
+  /// of the solution separated by the barriers, each thread repeats the 
+  /// coarse update of its block of the stages with the latest solution of 
+  /// the neighbouring blocks. The step sizes are determined for each stage 
+  /// and the line search is not performed. 
+  /// UnconstrParNMPCSolver::initBackwardCorrection() must be called before 
+  /// the first call.
+  /// @param[in] t Initial time of the horizon. 
+  /// @param[in] q Initial configuration. Size must be Robot::dimq().
+  /// @param[in] v Initial velocity. Size must be Robot::dimv().
+  /// @return true if the tolerance set by 
+  /// UnconstrParNMPCSolver::setAsyncIteration() is satisfied. false if not.
+  ///
+  bool updateSolutionAsync(const double t, const Eigen::VectorXd& q, 
+                           const Eigen::VectorXd& v);
+
+  ///
+  /// @return The number of the sweeps in the last 
+  /// UnconstrParNMPCSolver::updateSolutionAsync().
+  ///
+  int numAsyncSweeps() const;
+
   ///
   /// @brief Get the split solution of a time stage. For example, the control 
   /// input torques at the initial stage can be obtained by ocp.getSolution(0).u.
@@ -171,6 +210,7 @@ private:
   aligned_vector<Robot> robots_;
   UnconstrParNMPC parnmpc_;
   UnconstrBackwardCorrection backward_correction_;
+  UnconstrAsyncIteration async_iteration_;
   UnconstrLineSearch line_search_;
   KKTMatrix kkt_matrix_;
   KKTResidual kkt_residual_;
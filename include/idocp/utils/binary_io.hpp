@@ -0,0 +1,151 @@
+#ifndef IDOCP_UTILS_BINARY_IO_HPP_
+#define IDOCP_UTILS_BINARY_IO_HPP_
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/contact_status.hpp"
+#include "idocp/constraints/constraint_component_data.hpp"
+#include "idocp/constraints/constraints_data.hpp"
+
+
+namespace idocp {
+namespace binaryio {
+
+///
+/// @brief Writes a trivially copyable value to the binary stream.
+/// @param[in, out] os Output binary stream.
+/// @param[in] value Value to be written.
+///
+template <typename T>
+void write(std::ostream& os, const T& value);
+
+///
+/// @brief Reads a trivially copyable value from the binary stream.
+/// Throws std::runtime_error if the stream ends.
+/// @param[in, out] is Input binary stream.
+/// @param[out] value Value to be read.
+///
+template <typename T>
+void read(std::istream& is, T& value);
+
+///
+/// @brief Writes the size and the coefficients of a vector to the binary
+/// stream.
+/// @param[in, out] os Output binary stream.
+/// @param[in] vec Vector to be written.
+///
+template <typename VectorType>
+void writeVector(std::ostream& os, const Eigen::MatrixBase<VectorType>& vec);
+
+///
+/// @brief Reads a vector from the binary stream. The size stored in the
+/// stream must be equal to the size of vec. Otherwise, throws
+/// std::runtime_error.
+/// @param[in, out] is Input binary stream.
+/// @param[out] vec Vector to be read. The size is not changed.
+///
+template <typename VectorType>
+void readVector(std::istream& is, const Eigen::MatrixBase<VectorType>& vec);
+
+///
+/// @brief Writes the numbers of the rows and columns and the coefficients of
+/// a matrix to the binary stream.
+/// @param[in, out] os Output binary stream.
+/// @param[in] mat Matrix to be written.
+///
+template <typename MatrixType>
+void writeMatrix(std::ostream& os, const Eigen::MatrixBase<MatrixType>& mat);
+
+///
+/// @brief Reads a matrix from the binary stream. The numbers of the rows and
+/// columns stored in the stream must be equal to those of mat. Otherwise,
+/// throws std::runtime_error.
+/// @param[in, out] is Input binary stream.
+/// @param[out] mat Matrix to be read. The size is not changed.
+///
+template <typename MatrixType>
+void readMatrix(std::istream& is, const Eigen::MatrixBase<MatrixType>& mat);
+
+///
+/// @brief Reads a vector of any size from the binary stream.
+/// @param[in, out] is Input binary stream.
+/// @param[out] vec Vector to be read. Resized to the size stored in the
+/// stream.
+///
+void readDynamicVector(std::istream& is, Eigen::VectorXd& vec);
+
+///
+/// @brief Writes the length and the characters of a string to the binary
+/// stream.
+/// @param[in, out] os Output binary stream.
+/// @param[in] str String to be written.
+///
+void writeString(std::ostream& os, const std::string& str);
+
+///
+/// @brief Reads a string from the binary stream.
+/// @param[in, out] is Input binary stream.
+/// @param[out] str String to be read.
+///
+void readString(std::istream& is, std::string& str);
+
+///
+/// @brief Writes a std::vector of Eigen::Vector3d to the binary stream.
+/// @param[in, out] os Output binary stream.
+/// @param[in] vec std::vector to be written.
+///
+void writeVector3dArray(std::ostream& os,
+                        const std::vector<Eigen::Vector3d>& vec);
+
+///
+/// @brief Reads a std::vector of Eigen::Vector3d from the binary stream.
+/// The size stored in the stream must be equal to the size of vec.
+/// @param[in, out] is Input binary stream.
+/// @param[out] vec std::vector to be read. The size is not changed.
+///
+void readVector3dArray(std::istream& is, std::vector<Eigen::Vector3d>& vec);
+
+///
+/// @brief Writes the activities and the contact points of the contact
+/// status to the binary stream.
+/// @param[in, out] os Output binary stream.
+/// @param[in] contact_status Contact status.
+///
+void writeContactStatus(std::ostream& os, const ContactStatus& contact_status);
+
+///
+/// @brief Reads the activities and the contact points of the contact
+/// status from the binary stream.
+/// @param[in, out] is Input binary stream.
+/// @param[in, out] contact_status Contact status. The maximum number of the
+/// point contacts must be consistent with the stream.
+///
+void readContactStatus(std::istream& is, ContactStatus& contact_status);
+
+///
+/// @brief Writes the slack and dual variables of the constraints data to the
+/// binary stream.
+/// @param[in, out] os Output binary stream.
+/// @param[in] data Constraints data.
+///
+void writeSlackAndDual(std::ostream& os, const ConstraintsData& data);
+
+///
+/// @brief Reads the slack and dual variables of the constraints data from the
+/// binary stream. The structure of the constraints data must be consistent
+/// with the stream.
+/// @param[in, out] is Input binary stream.
+/// @param[in, out] data Constraints data.
+///
+void readSlackAndDual(std::istream& is, ConstraintsData& data);
+
+} // namespace binaryio
+} // namespace idocp
+
+#include "idocp/utils/binary_io.hxx"
+
+#endif // IDOCP_UTILS_BINARY_IO_HPP_
\ No newline at end of file
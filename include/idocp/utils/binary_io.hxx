@@ -0,0 +1,246 @@
+#ifndef IDOCP_UTILS_BINARY_IO_HXX_
+#define IDOCP_UTILS_BINARY_IO_HXX_
+
+#include "idocp/utils/binary_io.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+
+namespace idocp {
+namespace binaryio {
+
+template <typename T>
+inline void write(std::ostream& os, const T& value) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "T must be trivially copyable!");
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+
+template <typename T>
+inline void read(std::istream& is, T& value) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "T must be trivially copyable!");
+  is.read(reinterpret_cast<char*>(&value), sizeof(T));
+  if (!is) {
+    throw std::runtime_error("unexpected end of the binary stream!");
+  }
+}
+
+
+template <typename VectorType>
+inline void writeVector(std::ostream& os,
+                        const Eigen::MatrixBase<VectorType>& vec) {
+  const int size = vec.size();
+  write(os, size);
+  for (int i=0; i<size; ++i) {
+    write(os, static_cast<double>(vec.coeff(i)));
+  }
+}
+
+
+template <typename VectorType>
+inline void readVector(std::istream& is,
+                       const Eigen::MatrixBase<VectorType>& vec) {
+  int size;
+  read(is, size);
+  if (size != vec.size()) {
+    throw std::runtime_error(
+        "inconsistent vector size: expected " + std::to_string(vec.size())
+        + " but " + std::to_string(size) + " is stored!");
+  }
+  double value;
+  for (int i=0; i<size; ++i) {
+    read(is, value);
+    const_cast<Eigen::MatrixBase<VectorType>&>(vec).coeffRef(i) = value;
+  }
+}
+
+
+template <typename MatrixType>
+inline void writeMatrix(std::ostream& os,
+                        const Eigen::MatrixBase<MatrixType>& mat) {
+  const int rows = mat.rows();
+  const int cols = mat.cols();
+  write(os, rows);
+  write(os, cols);
+  for (int j=0; j<cols; ++j) {
+    for (int i=0; i<rows; ++i) {
+      write(os, static_cast<double>(mat.coeff(i, j)));
+    }
+  }
+}
+
+
+template <typename MatrixType>
+inline void readMatrix(std::istream& is,
+                       const Eigen::MatrixBase<MatrixType>& mat) {
+  int rows, cols;
+  read(is, rows);
+  read(is, cols);
+  if (rows != mat.rows() || cols != mat.cols()) {
+    throw std::runtime_error(
+        "inconsistent matrix size: expected " + std::to_string(mat.rows())
+        + " x " + std::to_string(mat.cols()) + " but " + std::to_string(rows)
+        + " x " + std::to_string(cols) + " is stored!");
+  }
+  double value;
+  for (int j=0; j<cols; ++j) {
+    for (int i=0; i<rows; ++i) {
+      read(is, value);
+      const_cast<Eigen::MatrixBase<MatrixType>&>(mat).coeffRef(i, j) = value;
+    }
+  }
+}
+
+
+inline void readDynamicVector(std::istream& is, Eigen::VectorXd& vec) {
+  int size;
+  read(is, size);
+  if (size < 0) {
+    throw std::runtime_error("invalid vector size " + std::to_string(size)
+                             + " is stored!");
+  }
+  vec.resize(size);
+  for (int i=0; i<size; ++i) {
+    read(is, vec.coeffRef(i));
+  }
+}
+
+
+inline void writeString(std::ostream& os, const std::string& str) {
+  const int size = str.size();
+  write(os, size);
+  os.write(str.data(), size);
+}
+
+
+inline void readString(std::istream& is, std::string& str) {
+  int size;
+  read(is, size);
+  if (size < 0) {
+    throw std::runtime_error("invalid string length " + std::to_string(size)
+                             + " is stored!");
+  }
+  str.resize(size);
+  is.read(&str[0], size);
+  if (!is) {
+    throw std::runtime_error("unexpected end of the binary stream!");
+  }
+}
+
+
+inline void writeVector3dArray(std::ostream& os,
+                               const std::vector<Eigen::Vector3d>& vec) {
+  const int size = vec.size();
+  write(os, size);
+  for (const auto& e : vec) {
+    writeVector(os, e);
+  }
+}
+
+
+inline void readVector3dArray(std::istream& is,
+                              std::vector<Eigen::Vector3d>& vec) {
+  int size;
+  read(is, size);
+  if (size != static_cast<int>(vec.size())) {
+    throw std::runtime_error(
+        "inconsistent array size: expected " + std::to_string(vec.size())
+        + " but " + std::to_string(size) + " is stored!");
+  }
+  for (auto& e : vec) {
+    readVector(is, e);
+  }
+}
+
+
+inline void writeContactStatus(std::ostream& os,
+                               const ContactStatus& contact_status) {
+  const int max_point_contacts = contact_status.maxPointContacts();
+  write(os, max_point_contacts);
+  for (int i=0; i<max_point_contacts; ++i) {
+    const char is_contact_active = contact_status.isContactActive(i) ? 1 : 0;
+    write(os, is_contact_active);
+  }
+  writeVector3dArray(os, contact_status.contactPoints());
+}
+
+
+inline void readContactStatus(std::istream& is,
+                              ContactStatus& contact_status) {
+  int max_point_contacts;
+  read(is, max_point_contacts);
+  if (max_point_contacts != contact_status.maxPointContacts()) {
+    throw std::runtime_error(
+        "inconsistent number of the point contacts: expected "
+        + std::to_string(contact_status.maxPointContacts()) + " but "
+        + std::to_string(max_point_contacts) + " is stored!");
+  }
+  std::vector<bool> is_contact_active(max_point_contacts, false);
+  for (int i=0; i<max_point_contacts; ++i) {
+    char active;
+    read(is, active);
+    is_contact_active[i] = (active != 0);
+  }
+  contact_status.setActivity(is_contact_active);
+  std::vector<Eigen::Vector3d> contact_points(max_point_contacts,
+                                              Eigen::Vector3d::Zero());
+  readVector3dArray(is, contact_points);
+  contact_status.setContactPoints(contact_points);
+}
+
+
+namespace internal {
+
+inline void writeSlackAndDual(
+    std::ostream& os, const std::vector<ConstraintComponentData>& data) {
+  const int size = data.size();
+  write(os, size);
+  for (const auto& e : data) {
+    writeVector(os, e.slack);
+    writeVector(os, e.dual);
+  }
+}
+
+
+inline void readSlackAndDual(std::istream& is,
+                             std::vector<ConstraintComponentData>& data) {
+  int size;
+  read(is, size);
+  if (size != static_cast<int>(data.size())) {
+    throw std::runtime_error(
+        "inconsistent number of the constraint components: expected "
+        + std::to_string(data.size()) + " but " + std::to_string(size)
+        + " is stored!");
+  }
+  for (auto& e : data) {
+    readVector(is, e.slack);
+    readVector(is, e.dual);
+  }
+}
+
+} // namespace internal
+
+
+inline void writeSlackAndDual(std::ostream& os, const ConstraintsData& data) {
+  internal::writeSlackAndDual(os, data.position_level_data);
+  internal::writeSlackAndDual(os, data.velocity_level_data);
+  internal::writeSlackAndDual(os, data.acceleration_level_data);
+  internal::writeSlackAndDual(os, data.impulse_level_data);
+}
+
+
+inline void readSlackAndDual(std::istream& is, ConstraintsData& data) {
+  internal::readSlackAndDual(is, data.position_level_data);
+  internal::readSlackAndDual(is, data.velocity_level_data);
+  internal::readSlackAndDual(is, data.acceleration_level_data);
+  internal::readSlackAndDual(is, data.impulse_level_data);
+}
+
+} // namespace binaryio
+} // namespace idocp
+
+#endif // IDOCP_UTILS_BINARY_IO_HXX_
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include "Eigen/Core"
 
+#include "idocp/robot/robot.hpp"
 #include "idocp/utils/logger.hpp"
 
 
@@ -28,6 +29,36 @@ void Convergence(OCPSolverType& ocp_solver, Logger& logger,
                  const Eigen::VectorXd& v, const int num_iteration=10, 
                  const bool line_search=false);
 
+///
+/// @brief Measures the distribution of the CPU time of each update, e.g., to
+/// compare the jitter before and after OCPSolver::applyRealTimeProfile().
+/// Shows the mean, standard deviation, percentiles, and maximum.
+///
+template <typename OCPSolverType>
+void LatencyDistribution(OCPSolverType& ocp_solver, const double t, 
+                         const Eigen::VectorXd& q, const Eigen::VectorXd& v, 
+                         const int num_iteration=10000, 
+                         const bool line_search=false);
+
+///
+/// @brief Collects the hardware performance counters of each phase of the 
+/// update by OCPSolver::startPerfCounters() and shows them. Shows that the 
+/// counters are not available if perf_event_open() is not permitted.
+/// @param[in] csv_file_name If not empty, the counts are also written to 
+/// this file as CSV. 
+///
+template <typename OCPSolverType>
+void HardwareCounters(OCPSolverType& ocp_solver, const double t, 
+                      const Eigen::VectorXd& q, const Eigen::VectorXd& v, 
+                      const int num_iteration=1000, 
+                      const bool line_search=false, 
+                      const std::string& csv_file_name="");
+
+template <typename OCPSolverType>
+void ReplayCPUTime(OCPSolverType& ocp_solver, const Robot& robot, 
+                   const std::string& trace_file_name, 
+                   const int num_slowest_updates=10);
+
 } // namespace benchmark
 } // namespace idocp 
 
@@ -4,7 +4,14 @@
 #include "idocp/utils/ocp_benchmarker.hxx"
 
 #include <iostream>
+#include <fstream>
 #include <chrono>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+
+#include "idocp/solver/ocp_solver_trace.hpp"
 
 
 namespace idocp {
@@ -72,6 +79,135 @@ inline void Convergence(OCPSolverType& ocp_solver, Logger& logger,
   std::cout << std::endl;
 }
 
+template <typename OCPSolverType>
+inline void LatencyDistribution(OCPSolverType& ocp_solver, const double t, 
+                                const Eigen::VectorXd& q, 
+                                const Eigen::VectorXd& v, 
+                                const int num_iteration, 
+                                const bool line_search) {
+  if (num_iteration <= 0) return;
+  // CPU time of each update [us]
+  std::vector<double> latency(num_iteration);
+  std::chrono::steady_clock::time_point start_clock, end_clock;
+  for (int i=0; i<num_iteration; ++i) {
+    start_clock = std::chrono::steady_clock::now();
+    ocp_solver.updateSolution(t, q, v, line_search);
+    end_clock = std::chrono::steady_clock::now();
+    latency[i] = 1e-03 * std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    end_clock-start_clock).count();
+  }
+  double mean = 0;
+  for (const auto e : latency) { mean += e; }
+  mean /= num_iteration;
+  double variance = 0;
+  for (const auto e : latency) { variance += (e-mean) * (e-mean); }
+  variance /= num_iteration;
+  std::sort(latency.begin(), latency.end());
+  auto percentile = [&latency](const double p) {
+    const int index = std::ceil(p*latency.size()) - 1;
+    return latency[std::max(index, 0)];
+  };
+  std::cout << "---------- OCP benchmark : Latency distribution ----------" 
+            << std::endl;
+  std::cout << "number of updates: " << num_iteration << std::endl;
+  std::cout << "mean: " << mean << "[us]" << std::endl;
+  std::cout << "standard deviation: " << std::sqrt(variance) << "[us]" 
+            << std::endl;
+  std::cout << "min: " << latency.front() << "[us]" << std::endl;
+  std::cout << "p50 / p90 / p99 / p99.9: " << percentile(0.5) << " / " 
+            << percentile(0.9) << " / " << percentile(0.99) << " / " 
+            << percentile(0.999) << "[us]" << std::endl;
+  std::cout << "max: " << latency.back() << "[us]" << std::endl;
+  std::cout << "jitter (max - min): " << latency.back() - latency.front() 
+            << "[us]" << std::endl;
+  std::cout << "-----------------------------------" << std::endl;
+  std::cout << std::endl;
+}
+
+
+template <typename OCPSolverType>
+inline void HardwareCounters(OCPSolverType& ocp_solver, const double t, 
+                             const Eigen::VectorXd& q, 
+                             const Eigen::VectorXd& v, 
+                             const int num_iteration, const bool line_search, 
+                             const std::string& csv_file_name) {
+  std::cout << "---------- OCP benchmark : Hardware counters ----------" 
+            << std::endl;
+  if (!ocp_solver.startPerfCounters()) {
+    std::cout << "hardware performance counters are not available" 
+              << std::endl;
+    std::cout << "-----------------------------------" << std::endl;
+    std::cout << std::endl;
+    return;
+  }
+  for (int i=0; i<num_iteration; ++i) {
+    ocp_solver.updateSolution(t, q, v, line_search);
+  }
+  const auto perf_counters = ocp_solver.getPerfCounters();
+  std::cout << "number of updates: " << num_iteration << std::endl;
+  perf_counters->showInfo();
+  if (!csv_file_name.empty()) {
+    std::ofstream csv(csv_file_name);
+    perf_counters->writeCSV(csv);
+  }
+  ocp_solver.stopPerfCounters();
+}
+
+
+template <typename OCPSolverType>
+inline void ReplayCPUTime(OCPSolverType& ocp_solver, const Robot& robot, 
+                          const std::string& trace_file_name, 
+                          const int num_slowest_updates) {
+  std::cout << "---------- OCP benchmark : Replay ----------" << std::endl;
+  OCPSolverReplayer replayer(robot, trace_file_name);
+  if (!replayer.init(ocp_solver)) {
+    std::cout << "failed to initialize the replay of " << trace_file_name 
+              << std::endl;
+    return;
+  }
+  // CPU time [ms], index of the update, and initial time of the horizon
+  std::vector<std::pair<double, std::pair<int, double>>> cpu_time;
+  double total_cpu_time = 0;
+  std::chrono::system_clock::time_point start_clock, end_clock;
+  while (true) {
+    start_clock = std::chrono::system_clock::now();
+    if (!replayer.replayNext(ocp_solver)) break;
+    end_clock = std::chrono::system_clock::now();
+    if (replayer.lastEvent() == OCPSolverTraceEvent::UpdateSolution) {
+      const double ms 
+          = 1e-03 * std::chrono::duration_cast<std::chrono::microseconds>(
+                end_clock-start_clock).count();
+      cpu_time.push_back(std::make_pair(
+          ms, std::make_pair(replayer.numReplayedUpdates()-1, 
+                             replayer.lastTime())));
+      total_cpu_time += ms;
+    }
+  }
+  std::cout << "number of replayed calls: " << replayer.numReplayedEvents() 
+            << std::endl;
+  std::cout << "number of replayed updates: " << cpu_time.size() << std::endl;
+  if (!cpu_time.empty()) {
+    std::cout << "total CPU time of updates: " << total_cpu_time << "[ms]" 
+              << std::endl;
+    std::cout << "CPU time per update: " << total_cpu_time / cpu_time.size() 
+              << "[ms]" << std::endl;
+    std::sort(cpu_time.begin(), cpu_time.end(), 
+              [](const std::pair<double, std::pair<int, double>>& a, 
+                 const std::pair<double, std::pair<int, double>>& b) { 
+                return a.first > b.first; });
+    const int num_slowest = std::min(num_slowest_updates, 
+                                     static_cast<int>(cpu_time.size()));
+    std::cout << "slowest updates:" << std::endl;
+    for (int i=0; i<num_slowest; ++i) {
+      std::cout << "  update " << cpu_time[i].second.first << " (t = " 
+                << cpu_time[i].second.second << "): " << cpu_time[i].first 
+                << "[ms]" << std::endl;
+    }
+  }
+  std::cout << "-----------------------------------" << std::endl;
+  std::cout << std::endl;
+}
+
 } // namespace benchmark
 } // namespace idocp 
 
@@ -0,0 +1,190 @@
+#ifndef IDOCP_PERF_COUNTERS_HPP_
+#define IDOCP_PERF_COUNTERS_HPP_
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+
+namespace idocp {
+
+///
+/// @enum PerfCounterEvent
+/// @brief Hardware events counted by PerfCounters.
+///
+enum class PerfCounterEvent {
+  Cycles,
+  Instructions,
+  L1DMisses,
+  LLCMisses,
+  BranchMisses
+};
+
+///
+/// @class PerfCounters
+/// @brief Hardware performance counters aggregated per phase of a solver,
+/// collected by perf_event_open() on Linux. The counters are opened for the
+/// calling thread and the OpenMP worker threads, and the counts of all the
+/// threads are summed up. Only the user-space events are counted so that
+/// the counters are available under the default perf_event_paranoid. If the
+/// counters are not available, e.g., in a virtual machine, in a container,
+/// or on other operating systems, nothing is counted and the counts are
+/// zero.
+///
+class PerfCounters {
+public:
+  ///
+  /// @brief Constructs the counters. The counters are not opened.
+  /// @param[in] phase_names Names of the phases.
+  ///
+  PerfCounters(const std::vector<std::string>& phase_names);
+
+  ///
+  /// @brief Default constructor.
+  ///
+  PerfCounters();
+
+  ///
+  /// @brief Destructor. Closes the counters.
+  ///
+  ~PerfCounters();
+
+  ///
+  /// @brief Deleted copy constructor since the counters own the file
+  /// descriptors.
+  ///
+  PerfCounters(const PerfCounters&) = delete;
+
+  ///
+  /// @brief Deleted copy operator.
+  ///
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  ///
+  /// @brief Deleted move constructor.
+  ///
+  PerfCounters(PerfCounters&&) noexcept = delete;
+
+  ///
+  /// @brief Deleted move assign operator.
+  ///
+  PerfCounters& operator=(PerfCounters&&) noexcept = delete;
+
+  ///
+  /// @brief Opens the counters of the calling thread and the OpenMP worker
+  /// threads. Must be called from the thread that runs the solver, since the
+  /// OpenMP worker threads belong to that thread. The previously opened
+  /// counters are closed.
+  /// @param[in] nthreads Number of the OpenMP threads of the solver.
+  /// @return true if the counters of at least one event are opened. false if
+  /// not.
+  ///
+  bool open(const int nthreads);
+
+  ///
+  /// @brief Closes the counters. The aggregated counts and the availability
+  /// of the events are kept.
+  ///
+  void close();
+
+  ///
+  /// @return true if the counters are opened. false if not.
+  ///
+  bool isAvailable() const;
+
+  ///
+  /// @param[in] event Hardware event.
+  /// @return true if the event is counted. false if not, e.g., the event is
+  /// not supported by the CPU.
+  ///
+  bool isAvailable(const PerfCounterEvent event) const;
+
+  ///
+  /// @brief Starts counting a phase.
+  /// @param[in] phase Index of the phase.
+  ///
+  void begin(const int phase) {
+    if (!fds_.empty()) { readCounters(start_); }
+  }
+
+  ///
+  /// @brief Stops counting a phase and adds the counts since
+  /// PerfCounters::begin() to the phase.
+  /// @param[in] phase Index of the phase.
+  ///
+  void end(const int phase) {
+    if (!fds_.empty()) { accumulate(phase); }
+  }
+
+  ///
+  /// @brief Sets all the aggregated counts to zero.
+  ///
+  void reset();
+
+  ///
+  /// @return Number of the phases.
+  ///
+  int numPhases() const;
+
+  ///
+  /// @param[in] phase Index of the phase.
+  /// @return Name of the phase.
+  ///
+  const std::string& phaseName(const int phase) const;
+
+  ///
+  /// @param[in] phase Index of the phase.
+  /// @return Number of the calls of PerfCounters::end() of the phase.
+  ///
+  long long numSamples(const int phase) const;
+
+  ///
+  /// @param[in] phase Index of the phase.
+  /// @param[in] event Hardware event.
+  /// @return Aggregated count of the event in the phase. Scaled if the
+  /// counters are multiplexed by the kernel.
+  ///
+  double count(const int phase, const PerfCounterEvent event) const;
+
+  ///
+  /// @brief Displays the counts per phase, the instructions per cycle, and
+  /// the misses per thousand instructions onto a ostream.
+  ///
+  void showInfo() const;
+
+  ///
+  /// @brief Writes the counts per phase as CSV, i.e., a header line followed
+  /// by a line for each phase.
+  /// @param[in, out] os Output stream.
+  ///
+  void writeCSV(std::ostream& os) const;
+
+  ///
+  /// @return Name of the event.
+  ///
+  static const char* eventName(const PerfCounterEvent event);
+
+  ///
+  /// @brief Number of the events.
+  ///
+  static constexpr int kNumEvents = 5;
+
+private:
+  std::vector<std::string> phase_names_;
+  // File descriptors of the group leader and the members of each thread.
+  std::vector<std::vector<int>> fds_;
+  std::vector<bool> is_event_available_;
+  // Counter values of each thread: time enabled, time running, and events.
+  std::vector<std::vector<unsigned long long>> start_, stop_;
+  std::vector<std::vector<double>> counts_;
+  std::vector<long long> num_samples_;
+
+  void readCounters(std::vector<std::vector<unsigned long long>>& values) const;
+
+  void accumulate(const int phase);
+
+};
+
+} // namespace idocp
+
+#endif // IDOCP_PERF_COUNTERS_HPP_
@@ -0,0 +1,130 @@
+#ifndef IDOCP_REAL_TIME_PROFILE_HPP_
+#define IDOCP_REAL_TIME_PROFILE_HPP_
+
+#include <vector>
+
+
+namespace idocp {
+
+///
+/// @class RealTimeProfile
+/// @brief Settings of the real-time execution of the solvers on Linux, e.g.,
+/// with the PREEMPT_RT patch: memory locking, CPU affinity of the threads,
+/// and SCHED_FIFO priority. Applied by OCPSolver::applyRealTimeProfile().
+/// Nothing is enabled by default.
+///
+class RealTimeProfile {
+public:
+  ///
+  /// @brief Default constructor. Nothing is enabled.
+  ///
+  RealTimeProfile();
+
+  ///
+  /// @brief Destructor.
+  ///
+  ~RealTimeProfile();
+
+  ///
+  /// @brief Default copy constructor.
+  ///
+  RealTimeProfile(const RealTimeProfile&) = default;
+
+  ///
+  /// @brief Default copy operator.
+  ///
+  RealTimeProfile& operator=(const RealTimeProfile&) = default;
+
+  ///
+  /// @brief Default move constructor.
+  ///
+  RealTimeProfile(RealTimeProfile&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator.
+  ///
+  RealTimeProfile& operator=(RealTimeProfile&&) noexcept = default;
+
+  ///
+  /// @brief Enables or disables the memory locking. If enabled, all the
+  /// current and future pages of the process are locked by mlockall() and
+  /// malloc() is configured not to return the freed memory to the OS, so
+  /// that the solver never page-faults once its memory is touched. Usually
+  /// requires CAP_IPC_LOCK or a large enough RLIMIT_MEMLOCK.
+  /// @param[in] lock_memory If true, the memory is locked. Default is false.
+  ///
+  void setMemoryLocking(const bool lock_memory);
+
+  ///
+  /// @brief Sets the CPUs to which the threads are pinned. The thread of
+  /// the OpenMP thread number i is pinned to cpus[i % cpus.size()].
+  /// @param[in] cpus Indices of the CPUs. If empty, the threads are not
+  /// pinned. Default is empty.
+  ///
+  void setCPUAffinity(const std::vector<int>& cpus);
+
+  ///
+  /// @brief Sets the priority of the SCHED_FIFO policy of the threads.
+  /// Usually requires CAP_SYS_NICE or a large enough RLIMIT_RTPRIO.
+  /// @param[in] priority Priority in [1, 99]. If 0, the scheduling policy
+  /// is not changed. Default is 0.
+  ///
+  void setSchedulingPriority(const int priority);
+
+  ///
+  /// @brief Sets the size of the stack of each thread that is touched in
+  /// advance.
+  /// @param[in] size Size of the stack in bytes. Must be non-negative.
+  /// Default is 256 KiB.
+  ///
+  void setStackPrefaultSize(const int size);
+
+  ///
+  /// @return true if the memory locking is enabled. false if not.
+  ///
+  bool memoryLocking() const;
+
+  ///
+  /// @return The CPUs to which the threads are pinned.
+  ///
+  const std::vector<int>& cpuAffinity() const;
+
+  ///
+  /// @return The priority of the SCHED_FIFO policy. 0 if disabled.
+  ///
+  int schedulingPriority() const;
+
+  ///
+  /// @return The size of the stack touched in advance in bytes.
+  ///
+  int stackPrefaultSize() const;
+
+  ///
+  /// @brief Applies the settings of the process, i.e., the memory locking.
+  /// @return true if succeeded. false if not.
+  ///
+  bool applyToProcess() const;
+
+  ///
+  /// @brief Applies the settings of the calling thread, i.e., the CPU
+  /// affinity and the scheduling priority, and touches its stack.
+  /// @param[in] thread_num The thread number, e.g., omp_get_thread_num().
+  /// @return true if succeeded. false if not.
+  ///
+  bool applyToThread(const int thread_num) const;
+
+  ///
+  /// @brief Displays the settings onto a ostream.
+  ///
+  void showInfo() const;
+
+private:
+  bool lock_memory_;
+  std::vector<int> cpus_;
+  int priority_, stack_prefault_size_;
+
+};
+
+} // namespace idocp
+
+#endif // IDOCP_REAL_TIME_PROFILE_HPP_
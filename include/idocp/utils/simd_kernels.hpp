@@ -0,0 +1,166 @@
+#ifndef IDOCP_SIMD_KERNELS_HPP_
+#define IDOCP_SIMD_KERNELS_HPP_
+
+
+namespace idocp {
+namespace simd {
+
+///
+/// @enum InstructionSet
+/// @brief Instruction sets for which the hot numerical kernels are compiled.
+/// The kernels of AVX2 and AVX-512 are built into the library if the
+/// compiler supports them, independently of the compile options of the
+/// rest of the library, and selected at load time by the features of the
+/// CPU.
+///
+enum class InstructionSet {
+  Generic,
+  AVX2,
+  AVX512
+};
+
+///
+/// @brief Checks if the kernels of the instruction set are built into the
+/// library and supported by the CPU.
+/// @param[in] instruction_set Instruction set.
+/// @return true if the kernels can be used. false if not.
+///
+bool isSupported(const InstructionSet instruction_set);
+
+///
+/// @return The fastest instruction set that is supported.
+///
+InstructionSet detectInstructionSet();
+
+///
+/// @return The instruction set of the kernels in use. By default,
+/// detectInstructionSet() is selected when the library is loaded. The
+/// environment variable IDOCP_SIMD (generic, avx2, or avx512) overrides the
+/// default if the specified instruction set is supported.
+///
+InstructionSet instructionSet();
+
+///
+/// @brief Switches the kernels, e.g., to compare the instruction sets. Must
+/// not be called while the solvers are running.
+/// @param[in] instruction_set Instruction set.
+/// @return true if the kernels are switched. false if the instruction set is
+/// not supported.
+///
+bool setInstructionSet(const InstructionSet instruction_set);
+
+///
+/// @param[in] instruction_set Instruction set.
+/// @return The name of the instruction set.
+///
+const char* instructionSetName(const InstructionSet instruction_set);
+
+///
+/// @brief Computes cmpl = slack * dual - barrier elementwise.
+/// @param[in] dim Dimension of the vectors.
+/// @param[in] barrier Barrier parameter.
+/// @param[in] slack Slack variable.
+/// @param[in] dual Dual variable.
+/// @param[out] cmpl Residual in the complementary slackness.
+///
+void computeComplementarySlackness(const int dim, const double barrier,
+                                   const double* slack, const double* dual,
+                                   double* cmpl);
+
+///
+/// @brief Computes cond = (dual * residual - cmpl) / slack elementwise.
+/// @param[in] dim Dimension of the vectors.
+/// @param[in] slack Slack variable.
+/// @param[in] dual Dual variable.
+/// @param[in] residual Residual in the primal constraint.
+/// @param[in] cmpl Residual in the complementary slackness.
+/// @param[out] cond Condensing coefficient.
+///
+void computeCondensingCoeffcient(const int dim, const double* slack,
+                                 const double* dual, const double* residual,
+                                 const double* cmpl, double* cond);
+
+///
+/// @brief Computes ddual = - (dual * dslack + cmpl) / slack elementwise.
+/// @param[in] dim Dimension of the vectors.
+/// @param[in] slack Slack variable.
+/// @param[in] dual Dual variable.
+/// @param[in] dslack Direction of the slack variable.
+/// @param[in] cmpl Residual in the complementary slackness.
+/// @param[out] ddual Direction of the dual variable.
+///
+void computeDualDirection(const int dim, const double* slack,
+                          const double* dual, const double* dslack,
+                          const double* cmpl, double* ddual);
+
+///
+/// @brief Applies the fraction-to-boundary rule.
+/// @param[in] dim Dimension of the vectors.
+/// @param[in] fraction_rate Must be larger than 0 and smaller than 1.
+/// @param[in] vec A vector. All the components must be positive.
+/// @param[in] dvec The direction of the vector.
+/// @return The maximum step size in (0, 1].
+///
+double fractionToBoundary(const int dim, const double fraction_rate,
+                          const double* vec, const double* dvec);
+
+///
+/// @brief Computes C = alpha * A^T * B + beta * C, where all the matrices are
+/// column-major. If beta is zero, C is not read.
+/// @param[in] m Number of the columns of A and the rows of C.
+/// @param[in] n Number of the columns of B and C.
+/// @param[in] k Number of the rows of A and B.
+/// @param[in] alpha Scale of the product.
+/// @param[in] A Pointer to the k x m matrix.
+/// @param[in] lda Outer stride of A.
+/// @param[in] B Pointer to the k x n matrix.
+/// @param[in] ldb Outer stride of B.
+/// @param[in] beta Scale of C.
+/// @param[in, out] C Pointer to the m x n matrix.
+/// @param[in] ldc Outer stride of C.
+///
+void gemmTN(const int m, const int n, const int k, const double alpha,
+            const double* A, const int lda, const double* B, const int ldb,
+            const double beta, double* C, const int ldc);
+
+
+namespace internal {
+
+///
+/// @class KernelTable
+/// @brief Kernels compiled for an instruction set.
+///
+struct KernelTable {
+  InstructionSet instruction_set;
+  void (*computeComplementarySlackness)(const int, const double,
+                                        const double*, const double*,
+                                        double*);
+  void (*computeCondensingCoeffcient)(const int, const double*,
+                                      const double*, const double*,
+                                      const double*, double*);
+  void (*computeDualDirection)(const int, const double*, const double*,
+                               const double*, const double*, double*);
+  double (*fractionToBoundary)(const int, const double, const double*,
+                               const double*);
+  void (*gemmTN)(const int, const int, const int, const double,
+                 const double*, const int, const double*, const int,
+                 const double, double*, const int);
+};
+
+extern const KernelTable generic_kernel_table;
+extern const KernelTable avx2_kernel_table;
+extern const KernelTable avx512_kernel_table;
+
+///
+/// @brief Kernels in use. Selected when the library is loaded.
+///
+extern const KernelTable* active_kernel_table;
+
+} // namespace internal
+
+} // namespace simd
+} // namespace idocp
+
+#include "idocp/utils/simd_kernels.hxx"
+
+#endif // IDOCP_SIMD_KERNELS_HPP_
@@ -0,0 +1,69 @@
+#ifndef IDOCP_SIMD_KERNELS_HXX_
+#define IDOCP_SIMD_KERNELS_HXX_
+
+#include "idocp/utils/simd_kernels.hpp"
+
+#include <cassert>
+
+
+namespace idocp {
+namespace simd {
+
+inline void computeComplementarySlackness(const int dim, const double barrier,
+                                          const double* slack,
+                                          const double* dual, double* cmpl) {
+  assert(dim >= 0);
+  internal::active_kernel_table->computeComplementarySlackness(dim, barrier,
+                                                               slack, dual,
+                                                               cmpl);
+}
+
+
+inline void computeCondensingCoeffcient(const int dim, const double* slack,
+                                        const double* dual,
+                                        const double* residual,
+                                        const double* cmpl, double* cond) {
+  assert(dim >= 0);
+  internal::active_kernel_table->computeCondensingCoeffcient(dim, slack, dual,
+                                                             residual, cmpl,
+                                                             cond);
+}
+
+
+inline void computeDualDirection(const int dim, const double* slack,
+                                 const double* dual, const double* dslack,
+                                 const double* cmpl, double* ddual) {
+  assert(dim >= 0);
+  internal::active_kernel_table->computeDualDirection(dim, slack, dual,
+                                                      dslack, cmpl, ddual);
+}
+
+
+inline double fractionToBoundary(const int dim, const double fraction_rate,
+                                 const double* vec, const double* dvec) {
+  assert(dim >= 0);
+  assert(fraction_rate > 0);
+  assert(fraction_rate <= 1);
+  return internal::active_kernel_table->fractionToBoundary(dim, fraction_rate,
+                                                           vec, dvec);
+}
+
+
+inline void gemmTN(const int m, const int n, const int k, const double alpha,
+                   const double* A, const int lda, const double* B,
+                   const int ldb, const double beta, double* C,
+                   const int ldc) {
+  assert(m >= 0);
+  assert(n >= 0);
+  assert(k >= 0);
+  assert(lda >= k);
+  assert(ldb >= k);
+  assert(ldc >= m);
+  internal::active_kernel_table->gemmTN(m, n, k, alpha, A, lda, B, ldb, beta,
+                                        C, ldc);
+}
+
+} // namespace simd
+} // namespace idocp
+
+#endif // IDOCP_SIMD_KERNELS_HXX_
@@ -0,0 +1,109 @@
+#ifndef IDOCP_UTILS_TRIPLE_BUFFER_HPP_
+#define IDOCP_UTILS_TRIPLE_BUFFER_HPP_
+
+#include <atomic>
+
+
+namespace idocp {
+
+///
+/// @class TripleBuffer
+/// @brief Wait-free single-producer single-consumer triple buffer. The 
+/// producer fills TripleBuffer::writeBuffer() and calls 
+/// TripleBuffer::publish(). The consumer calls TripleBuffer::update() and 
+/// reads TripleBuffer::readBuffer(). Neither side ever blocks nor allocates 
+/// memory, i.e., the producer and the consumer only exchange the indices of 
+/// the three preallocated buffers.
+/// @tparam T Type of the buffer. Must be copy constructible.
+///
+template <typename T>
+class TripleBuffer {
+public:
+  ///
+  /// @brief Constructs the triple buffer. All of the three buffers are 
+  /// initialized by the copy of value.
+  /// @param[in] value Initial value of the buffers.
+  ///
+  TripleBuffer(const T& value);
+
+  ///
+  /// @brief Default constructor. 
+  ///
+  TripleBuffer();
+
+  ///
+  /// @brief Destructor. 
+  ///
+  ~TripleBuffer();
+
+  ///
+  /// @brief Copy is not allowed because the buffer is shared by two threads.
+  ///
+  TripleBuffer(const TripleBuffer&) = delete;
+
+  ///
+  /// @brief Copy is not allowed because the buffer is shared by two threads.
+  ///
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  ///
+  /// @brief Move is not allowed because the buffer is shared by two threads.
+  ///
+  TripleBuffer(TripleBuffer&&) = delete;
+
+  ///
+  /// @brief Move is not allowed because the buffer is shared by two threads.
+  ///
+  TripleBuffer& operator=(TripleBuffer&&) = delete;
+
+  ///
+  /// @brief Returns the buffer owned by the producer. Must be called only 
+  /// from the producer thread.
+  /// @return Reference to the buffer to be written.
+  ///
+  T& writeBuffer();
+
+  ///
+  /// @brief Publishes the buffer written by the producer. After this call, 
+  /// TripleBuffer::writeBuffer() refers to another buffer whose contents are 
+  /// unspecified. Must be called only from the producer thread.
+  ///
+  void publish();
+
+  ///
+  /// @brief Takes the latest published buffer if exists. Must be called only 
+  /// from the consumer thread.
+  /// @return true if a new buffer has been published since the last call. 
+  /// false if not. In this case, TripleBuffer::readBuffer() is not changed.
+  ///
+  bool update();
+
+  ///
+  /// @brief Returns the buffer owned by the consumer. Must be called only 
+  /// from the consumer thread.
+  /// @return Const reference to the latest buffer taken by 
+  /// TripleBuffer::update().
+  ///
+  const T& readBuffer() const;
+
+  ///
+  /// @return true if a buffer has been published and has not been taken by 
+  /// the consumer yet. false if not.
+  ///
+  bool hasNewData() const;
+
+private:
+  static constexpr int kIndexMask = 3;
+  static constexpr int kDirtyBit = 4;
+
+  T buffers_[3];
+  int write_index_, read_index_;
+  std::atomic<int> middle_;
+
+};
+
+} // namespace idocp 
+
+#include "idocp/utils/triple_buffer.hxx"
+
+#endif // IDOCP_UTILS_TRIPLE_BUFFER_HPP_ 
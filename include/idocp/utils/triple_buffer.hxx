@@ -0,0 +1,77 @@
+#ifndef IDOCP_UTILS_TRIPLE_BUFFER_HXX_
+#define IDOCP_UTILS_TRIPLE_BUFFER_HXX_
+
+#include "idocp/utils/triple_buffer.hpp"
+
+
+namespace idocp {
+
+template <typename T>
+constexpr int TripleBuffer<T>::kIndexMask;
+
+template <typename T>
+constexpr int TripleBuffer<T>::kDirtyBit;
+
+
+template <typename T>
+inline TripleBuffer<T>::TripleBuffer(const T& value)
+  : buffers_{value, value, value},
+    write_index_(0),
+    read_index_(2),
+    middle_(1) {
+}
+
+
+template <typename T>
+inline TripleBuffer<T>::TripleBuffer()
+  : buffers_(),
+    write_index_(0),
+    read_index_(2),
+    middle_(1) {
+}
+
+
+template <typename T>
+inline TripleBuffer<T>::~TripleBuffer() {
+}
+
+
+template <typename T>
+inline T& TripleBuffer<T>::writeBuffer() {
+  return buffers_[write_index_];
+}
+
+
+template <typename T>
+inline void TripleBuffer<T>::publish() {
+  const int prev = middle_.exchange(write_index_ | kDirtyBit, 
+                                    std::memory_order_acq_rel);
+  write_index_ = prev & kIndexMask;
+}
+
+
+template <typename T>
+inline bool TripleBuffer<T>::update() {
+  if (!hasNewData()) {
+    return false;
+  }
+  const int prev = middle_.exchange(read_index_, std::memory_order_acq_rel);
+  read_index_ = prev & kIndexMask;
+  return true;
+}
+
+
+template <typename T>
+inline const T& TripleBuffer<T>::readBuffer() const {
+  return buffers_[read_index_];
+}
+
+
+template <typename T>
+inline bool TripleBuffer<T>::hasNewData() const {
+  return (middle_.load(std::memory_order_relaxed) & kDirtyBit);
+}
+
+} // namespace idocp 
+
+#endif // IDOCP_UTILS_TRIPLE_BUFFER_HXX_ 
@@ -0,0 +1,297 @@
+#ifndef IDOCP_WARM_START_LIBRARY_HPP_
+#define IDOCP_WARM_START_LIBRARY_HPP_
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/ocp/split_solution.hpp"
+#include "idocp/constraints/constraints_data.hpp"
+
+
+namespace idocp {
+
+///
+/// @class WarmStartKey
+/// @brief Key of an entry of the warm-start library.
+///
+struct WarmStartKey {
+  ///
+  /// @brief Identifier of the gait, e.g., standing, trotting, or walking.
+  /// Entries are looked up only among the same gait.
+  ///
+  int gait;
+
+  ///
+  /// @brief Phase of the gait at the initial time of the horizon. Normalized
+  /// to [0, 1) and treated as cyclic.
+  ///
+  double phase;
+
+  ///
+  /// @brief Command of the gait, e.g., the velocity command. The size must be
+  /// equal to WarmStartLibrary::dimCommand().
+  ///
+  Eigen::VectorXd command;
+};
+
+///
+/// @class WarmStartLibraryBuilder
+/// @brief Collects the converged solutions and the slack and dual variables
+/// of the inequality constraints for the warm-start library and saves them
+/// to a binary file that is read by WarmStartLibrary. Each entry is a
+/// trajectory of points, each of which stores a SplitSolution and its
+/// ConstraintsData at a time relative to the initial time of the horizon.
+///
+class WarmStartLibraryBuilder {
+public:
+  ///
+  /// @brief Constructs an empty library.
+  /// @param[in] robot Robot model.
+  /// @param[in] dim_command Size of WarmStartKey::command. Must be
+  /// non-negative.
+  ///
+  WarmStartLibraryBuilder(const Robot& robot, const int dim_command);
+
+  ///
+  /// @brief Default constructor.
+  ///
+  WarmStartLibraryBuilder();
+
+  ///
+  /// @brief Destructor.
+  ///
+  ~WarmStartLibraryBuilder();
+
+  ///
+  /// @brief Default copy constructor.
+  ///
+  WarmStartLibraryBuilder(const WarmStartLibraryBuilder&) = default;
+
+  ///
+  /// @brief Default copy operator.
+  ///
+  WarmStartLibraryBuilder& operator=(const WarmStartLibraryBuilder&) = default;
+
+  ///
+  /// @brief Default move constructor.
+  ///
+  WarmStartLibraryBuilder(WarmStartLibraryBuilder&&) noexcept = default;
+
+  ///
+  /// @brief Default move assign operator.
+  ///
+  WarmStartLibraryBuilder& operator=(WarmStartLibraryBuilder&&) noexcept = default;
+
+  ///
+  /// @brief Adds an empty entry. The subsequent points are added to this
+  /// entry.
+  /// @param[in] key Key of the entry.
+  ///
+  void addEntry(const WarmStartKey& key);
+
+  ///
+  /// @brief Adds a point to the last entry. The time must not be smaller
+  /// than that of the previous point.
+  /// @param[in] t Time relative to the initial time of the horizon.
+  /// @param[in] s Split solution.
+  /// @param[in] data Constraints data whose slack and dual variables are
+  /// stored.
+  ///
+  void addPoint(const double t, const SplitSolution& s,
+                const ConstraintsData& data);
+
+  ///
+  /// @brief Adds a point without the slack and dual variables to the last
+  /// entry, e.g., the terminal stage.
+  /// @param[in] t Time relative to the initial time of the horizon.
+  /// @param[in] s Split solution.
+  ///
+  void addPoint(const double t, const SplitSolution& s);
+
+  ///
+  /// @brief Saves the library to a binary file.
+  /// @param[in] file_name Name of the binary file.
+  /// @return true if the library is saved successfully. false if not.
+  ///
+  bool save(const std::string& file_name) const;
+
+  ///
+  /// @return Number of the entries.
+  ///
+  int numEntries() const;
+
+private:
+  int dimq_, dimv_, dimu_, max_point_contacts_, dim_command_;
+  std::vector<WarmStartKey> keys_;
+  // Points of each entry, each of which is the time, the dimensions of the
+  // levels of the constraints data, the activities of the contacts, the
+  // solution, and the slack and dual variables.
+  std::vector<std::vector<std::vector<double>>> points_;
+
+};
+
+///
+/// @class WarmStartLibrary
+/// @brief Read-only warm-start library saved by WarmStartLibraryBuilder. The
+/// file is memory-mapped and the points are read in place, so that only the
+/// pages of the looked-up entries are loaded into RAM and a large library
+/// can be shared by the processes on the same machine. The file must be
+/// saved on a machine of the same endianness.
+///
+class WarmStartLibrary {
+public:
+  ///
+  /// @brief Opens and maps a library.
+  /// @param[in] file_name Name of the binary file saved by
+  /// WarmStartLibraryBuilder::save().
+  ///
+  WarmStartLibrary(const std::string& file_name);
+
+  ///
+  /// @brief Default constructor. No library is opened.
+  ///
+  WarmStartLibrary();
+
+  ///
+  /// @brief Destructor. Unmaps the library.
+  ///
+  ~WarmStartLibrary();
+
+  ///
+  /// @brief Deleted copy constructor since the library owns the mapping.
+  ///
+  WarmStartLibrary(const WarmStartLibrary&) = delete;
+
+  ///
+  /// @brief Deleted copy operator.
+  ///
+  WarmStartLibrary& operator=(const WarmStartLibrary&) = delete;
+
+  ///
+  /// @brief Move constructor. The mapping is transferred.
+  ///
+  WarmStartLibrary(WarmStartLibrary&& other) noexcept;
+
+  ///
+  /// @brief Move assign operator. The mapping is transferred.
+  ///
+  WarmStartLibrary& operator=(WarmStartLibrary&& other) noexcept;
+
+  ///
+  /// @brief Opens and maps a library. The previously opened library is
+  /// closed.
+  /// @param[in] file_name Name of the binary file saved by
+  /// WarmStartLibraryBuilder::save().
+  /// @return true if the library is opened successfully. false if not, e.g.,
+  /// the file does not exist or is broken.
+  ///
+  bool open(const std::string& file_name);
+
+  ///
+  /// @brief Unmaps the library.
+  ///
+  void close();
+
+  ///
+  /// @return true if a library is opened. false if not.
+  ///
+  bool isOpen() const;
+
+  ///
+  /// @brief Checks whether the library is saved with the same dimensions as
+  /// the robot model.
+  /// @param[in] robot Robot model.
+  /// @return true if the dimensions are consistent. false if not.
+  ///
+  bool isConsistent(const Robot& robot) const;
+
+  ///
+  /// @return Number of the entries.
+  ///
+  int numEntries() const;
+
+  ///
+  /// @return Size of WarmStartKey::command.
+  ///
+  int dimCommand() const;
+
+  ///
+  /// @param[in] entry Index of the entry.
+  /// @return Key of the entry.
+  ///
+  WarmStartKey key(const int entry) const;
+
+  ///
+  /// @param[in] entry Index of the entry.
+  /// @return Number of the points of the entry.
+  ///
+  int numPoints(const int entry) const;
+
+  ///
+  /// @param[in] entry Index of the entry.
+  /// @return Time of the last point of the entry.
+  ///
+  double horizonLength(const int entry) const;
+
+  ///
+  /// @brief Finds the nearest entry of the same gait. The distance is the
+  /// cyclic distance of the phases weighted by phase_weight plus the
+  /// Euclidean distance of the commands.
+  /// @param[in] key Key. The size of the command must be
+  /// WarmStartLibrary::dimCommand().
+  /// @param[in] phase_weight Weight on the distance of the phases. Must be
+  /// non-negative. Default is 1.
+  /// @return Index of the nearest entry. -1 if no entry of the gait exists.
+  ///
+  int findNearest(const WarmStartKey& key, const double phase_weight=1) const;
+
+  ///
+  /// @brief Interpolates the points of an entry at a time. The configuration
+  /// is interpolated on the configuration manifold, and the other variables
+  /// are interpolated linearly, so that the interpolated slack and dual
+  /// variables are positive. The times outside of the entry are clamped. The
+  /// contact forces of the contacts active at only one of the two points are
+  /// taken from that point. Call SplitSolution::set_f_stack() afterwards.
+  /// @param[in] robot Robot model.
+  /// @param[in] entry Index of the entry.
+  /// @param[in] t Time relative to the initial time of the horizon.
+  /// @param[out] s Split solution. q, v, a, u, f, lmd, and gmm are
+  /// interpolated.
+  ///
+  void interpolate(const Robot& robot, const int entry, const double t,
+                   SplitSolution& s) const;
+
+  ///
+  /// @brief Interpolates the slack and dual variables of the inequality
+  /// constraints of an entry at a time. Each of the position, velocity,
+  /// acceleration, and impulse levels is interpolated only if its dimension
+  /// is equal to that of data, and otherwise is not modified.
+  /// @param[in] entry Index of the entry.
+  /// @param[in] t Time relative to the initial time of the horizon.
+  /// @param[in, out] data Constraints data.
+  ///
+  void interpolate(const int entry, const double t,
+                   ConstraintsData& data) const;
+
+private:
+  void* mapping_;
+  std::size_t mapping_size_;
+  int dimq_, dimv_, dimu_, max_point_contacts_, dim_command_, num_entries_;
+  const double* index_;
+
+  const double* point(const int entry, const int k) const;
+
+  int pointSize(const int entry, const int k) const;
+
+  void findInterval(const int entry, const double t, int& k0, int& k1,
+                    double& ratio) const;
+
+};
+
+} // namespace idocp
+
+#endif // IDOCP_WARM_START_LIBRARY_HPP_
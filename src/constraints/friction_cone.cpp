@@ -232,6 +232,26 @@ void FrictionCone::condenseSlackAndDual(
 }
 
 
+void FrictionCone::condenseSlackAndDual(
+    Robot& robot, ConstraintComponentData& data, const double dt, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
+  assert(dt > 0);
+  data.cond.setZero();
+  int dimf_stack = 0;
+  for (int i=0; i<robot.maxPointContacts(); ++i) {
+    if (s.isContactActive(i)) {
+      const int idx = 5*i;
+      computeCondensingCoeffcient<5>(data, idx);
+      const Vector5d& condi = data.cond.template segment<5>(idx);
+      kkt_residual.lq().noalias() += dt * dg_dq(data, i).transpose() * condi;
+      kkt_residual.lf().template segment<3>(dimf_stack).noalias()
+          += dt * dg_df(data, i).transpose() * condi;
+      dimf_stack += 3;
+    }
+  }
+}
+
+
 void FrictionCone::expandSlackAndDual(ConstraintComponentData& data, 
                                       const SplitSolution& s, 
                                       const SplitDirection& d) const {
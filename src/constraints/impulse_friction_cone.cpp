@@ -228,6 +228,25 @@ void ImpulseFrictionCone::condenseSlackAndDual(
 }
 
 
+void ImpulseFrictionCone::condenseSlackAndDual(
+    Robot& robot, ConstraintComponentData& data, const ImpulseSplitSolution& s, 
+    ImpulseSplitKKTResidual& kkt_residual) const {
+  data.cond.setZero();
+  int dimf_stack = 0;
+  for (int i=0; i<robot.maxPointContacts(); ++i) {
+    if (s.isImpulseActive(i)) {
+      const int idx = 5*i;
+      computeCondensingCoeffcient<5>(data, idx);
+      const Vector5d& condi = data.cond.template segment<5>(idx);
+      kkt_residual.lq().noalias() += dg_dq(data, i).transpose() * condi;
+      kkt_residual.lf().template segment<3>(dimf_stack).noalias()
+          += dg_df(data, i).transpose() * condi;
+      dimf_stack += 3;
+    }
+  }
+}
+
+
 void ImpulseFrictionCone::expandSlackAndDual(
     ConstraintComponentData& data, const ImpulseSplitSolution& s, 
     const ImpulseSplitDirection& d) const {
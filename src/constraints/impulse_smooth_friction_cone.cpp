@@ -0,0 +1,281 @@
+#include "idocp/constraints/impulse_smooth_friction_cone.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+
+namespace idocp {
+
+ImpulseSmoothFrictionCone::ImpulseSmoothFrictionCone(
+    const Robot& robot, const double mu, const double barrier, 
+    const double fraction_to_boundary_rule)
+  : ImpulseConstraintComponentBase(barrier, fraction_to_boundary_rule),
+    dimv_(robot.dimv()),
+    dimc_(robot.maxPointContacts()),
+    max_point_contacts_(robot.maxPointContacts()),
+    contact_frame_(robot.contactFrames()),
+    mu_(mu),
+    eps_(1.0e-03) {
+  try {
+    if (robot.maxPointContacts() == 0) {
+      throw std::out_of_range(
+          "Invalid argument: robot.maxPointContacts() must be positive!");
+    }
+    if (mu <= 0) {
+      throw std::out_of_range(
+          "Invalid argument: mu must be positive!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+
+ImpulseSmoothFrictionCone::ImpulseSmoothFrictionCone()
+  : ImpulseConstraintComponentBase(),
+    dimv_(0),
+    dimc_(0),
+    max_point_contacts_(0),
+    contact_frame_(),
+    mu_(0),
+    eps_(0) {
+}
+
+
+ImpulseSmoothFrictionCone::~ImpulseSmoothFrictionCone() {
+}
+
+
+void ImpulseSmoothFrictionCone::setFrictionCoefficient(const double mu) {
+  try {
+    if (mu <= 0) {
+      throw std::out_of_range("Invalid argument: mu must be positive!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  mu_ = mu;
+}
+
+
+void ImpulseSmoothFrictionCone::setSmoothingParameter(const double eps) {
+  try {
+    if (eps <= 0) {
+      throw std::out_of_range("Invalid argument: eps must be positive!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  eps_ = eps;
+}
+
+
+KinematicsLevel ImpulseSmoothFrictionCone::kinematicsLevel() const {
+  return KinematicsLevel::AccelerationLevel;
+}
+
+
+void ImpulseSmoothFrictionCone::allocateExtraData(
+    ConstraintComponentData& data) const {
+  data.r.clear();
+  for (int i=0; i<max_point_contacts_; ++i) {
+    data.r.push_back(Eigen::VectorXd::Zero(3)); // fWi
+  }
+  for (int i=0; i<max_point_contacts_; ++i) {
+    data.r.push_back(Eigen::VectorXd::Zero(3)); // dgi_dfW
+  }
+  for (int i=0; i<max_point_contacts_; ++i) {
+    data.r.push_back(Eigen::VectorXd::Zero(dimv_)); // dgi_dq
+  }
+  for (int i=0; i<max_point_contacts_; ++i) {
+    data.r.push_back(Eigen::VectorXd::Zero(3)); // dgi_df
+  }
+  data.J.clear();
+  for (int i=0; i<max_point_contacts_; ++i) {
+    data.J.push_back(Eigen::MatrixXd::Zero(6, dimv_)); // dfWi_dq
+  }
+  for (int i=0; i<max_point_contacts_; ++i) {
+    data.J.push_back(Eigen::MatrixXd::Zero(3, 3)); // d2gi_dfW2
+  }
+}
+
+
+bool ImpulseSmoothFrictionCone::isFeasible(
+    Robot& robot, ConstraintComponentData& data, 
+    const ImpulseSplitSolution& s) const {
+  robot.updateFrameKinematics(s.q);
+  for (int i=0; i<robot.maxPointContacts(); ++i) {
+    if (s.isImpulseActive(i)) {
+      Eigen::VectorXd& fWi = fW(data, i);
+      fLocal2World(robot, contact_frame_[i], s.f[i], fWi);
+      if (frictionConeResidual(mu_, eps_, fWi) > 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+
+void ImpulseSmoothFrictionCone::setSlack(
+    Robot& robot, ConstraintComponentData& data, 
+    const ImpulseSplitSolution& s) const {
+  robot.updateFrameKinematics(s.q);
+  for (int i=0; i<robot.maxPointContacts(); ++i) {
+    Eigen::VectorXd& fWi = fW(data, i);
+    fLocal2World(robot, contact_frame_[i], s.f[i], fWi);
+    data.residual.coeffRef(i) = frictionConeResidual(mu_, eps_, fWi);
+    data.slack.coeffRef(i) = - data.residual.coeff(i);
+  }
+}
+
+
+void ImpulseSmoothFrictionCone::evalConstraint(
+    Robot& robot, ConstraintComponentData& data, 
+    const ImpulseSplitSolution& s) const {
+  data.residual.setZero();
+  data.cmpl.setZero();
+  data.log_barrier = 0;
+  for (int i=0; i<robot.maxPointContacts(); ++i) {
+    if (s.isImpulseActive(i)) {
+      // Impulse force expressed in the world frame.
+      Eigen::VectorXd& fWi = fW(data, i);
+      fLocal2World(robot, contact_frame_[i], s.f[i], fWi);
+      data.residual.coeffRef(i) 
+          = frictionConeResidual(mu_, eps_, fWi) + data.slack.coeff(i);
+      data.cmpl.coeffRef(i) 
+          = computeComplementarySlackness(data.slack.coeff(i), 
+                                          data.dual.coeff(i));
+      data.log_barrier += logBarrier(data.slack.template segment<1>(i));
+    }
+  }
+}
+
+
+void ImpulseSmoothFrictionCone::evalDerivatives(
+    Robot& robot, ConstraintComponentData& data, const ImpulseSplitSolution& s, 
+    ImpulseSplitKKTResidual& kkt_residual) const {
+  int dimf_stack = 0;
+  for (int i=0; i<robot.maxPointContacts(); ++i) {
+    if (s.isImpulseActive(i)) {
+      // Impulse force expressed in the world frame.
+      const Eigen::VectorXd& fWi = fW(data, i);
+      // Jacobian of the impulse force expressed in the world frame fWi 
+      // with respect to the configuration q.
+      Eigen::MatrixXd& dfWi_dq = dfW_dq(data, i);
+      dfWi_dq.setZero();
+      robot.getFrameJacobian(contact_frame_[i], dfWi_dq);
+      for (int j=0; j<dimv_; ++j) {
+        dfWi_dq.template topRows<3>().col(j)
+            = dfWi_dq.template bottomRows<3>().col(j).cross(fWi.template head<3>());
+      }
+      Eigen::VectorXd& dgi_dfW = dg_dfW(data, i);
+      frictionConeDerivatives(mu_, eps_, fWi, dgi_dfW, d2g_dfW2(data, i));
+      // Gradient of the frition cone constraint with respect to the 
+      // configuration, i.e., s.q.
+      Eigen::VectorXd& dgi_dq = dg_dq(data, i);
+      dgi_dq.noalias() = dfWi_dq.template topRows<3>().transpose() * dgi_dfW;
+      kkt_residual.lq().noalias() += data.dual.coeff(i) * dgi_dq;
+      // Gradient of the frition cone constraint with respect to the impulse
+      // force expressed in the local frame, i.e., s.f[i].
+      Eigen::VectorXd& dgi_df = dg_df(data, i);
+      dgi_df.noalias() 
+          = robot.frameRotation(contact_frame_[i]).transpose() * dgi_dfW;
+      kkt_residual.lf().template segment<3>(dimf_stack).noalias()
+          += data.dual.coeff(i) * dgi_df;
+      dimf_stack += 3;
+    }
+  }
+}
+
+
+void ImpulseSmoothFrictionCone::condenseSlackAndDual(
+    Robot& robot, ConstraintComponentData& data, 
+    const ImpulseSplitSolution& s, ImpulseSplitKKTMatrix& kkt_matrix, 
+    ImpulseSplitKKTResidual& kkt_residual) const {
+  data.cond.setZero();
+  int dimf_stack = 0;
+  for (int i=0; i<robot.maxPointContacts(); ++i) {
+    if (s.isImpulseActive(i)) {
+      data.cond.coeffRef(i) 
+          = computeCondensingCoeffcient(data.slack.coeff(i), data.dual.coeff(i),
+                                        data.residual.coeff(i), 
+                                        data.cmpl.coeff(i));
+      const Eigen::VectorXd& dgi_dq = dg_dq(data, i);
+      const Eigen::VectorXd& dgi_df = dg_df(data, i);
+      kkt_residual.lq().noalias() += data.cond.coeff(i) * dgi_dq;
+      kkt_residual.lf().template segment<3>(dimf_stack).noalias()
+          += data.cond.coeff(i) * dgi_df;
+      const double ri = data.dual.coeff(i) / data.slack.coeff(i);
+      kkt_matrix.Qqq().noalias() += ri * dgi_dq * dgi_dq.transpose();
+      kkt_matrix.Qqf().template middleCols<3>(dimf_stack).noalias()
+          += ri * dgi_dq * dgi_df.transpose();
+      kkt_matrix.Qff().template block<3, 3>(dimf_stack, dimf_stack).noalias()
+          += ri * dgi_df * dgi_df.transpose();
+      // Curvature of the cone, which is positive semidefinite.
+      const Eigen::Matrix3d& Ri = robot.frameRotation(contact_frame_[i]);
+      kkt_matrix.Qff().template block<3, 3>(dimf_stack, dimf_stack).noalias()
+          += data.dual.coeff(i) 
+              * Ri.transpose() * d2g_dfW2(data, i) * Ri;
+      dimf_stack += 3;
+    }
+  }
+}
+
+
+void ImpulseSmoothFrictionCone::condenseSlackAndDual(
+    Robot& robot, ConstraintComponentData& data, 
+    const ImpulseSplitSolution& s, 
+    ImpulseSplitKKTResidual& kkt_residual) const {
+  data.cond.setZero();
+  int dimf_stack = 0;
+  for (int i=0; i<robot.maxPointContacts(); ++i) {
+    if (s.isImpulseActive(i)) {
+      data.cond.coeffRef(i) 
+          = computeCondensingCoeffcient(data.slack.coeff(i), data.dual.coeff(i),
+                                        data.residual.coeff(i), 
+                                        data.cmpl.coeff(i));
+      kkt_residual.lq().noalias() += data.cond.coeff(i) * dg_dq(data, i);
+      kkt_residual.lf().template segment<3>(dimf_stack).noalias()
+          += data.cond.coeff(i) * dg_df(data, i);
+      dimf_stack += 3;
+    }
+  }
+}
+
+
+void ImpulseSmoothFrictionCone::expandSlackAndDual(
+    ConstraintComponentData& data, const ImpulseSplitSolution& s, 
+    const ImpulseSplitDirection& d) const {
+  // Because data.slack(i) and data.dual(i) are always positive,  
+  // positive data.dslack and data.ddual do not affect the step size 
+  // determined by the fraction-to-boundary-rule.
+  data.dslack.fill(1.0);
+  data.ddual.fill(1.0);
+  int dimf_stack = 0;
+  for (int i=0; i<max_point_contacts_; ++i) {
+    if (s.isImpulseActive(i)) {
+      data.dslack.coeffRef(i) 
+          = - dg_dq(data, i).dot(d.dq()) 
+            - dg_df(data, i).dot(d.df().template segment<3>(dimf_stack)) 
+            - data.residual.coeff(i);
+      data.ddual.coeffRef(i) 
+          = computeDualDirection(data.slack.coeff(i), data.dual.coeff(i),
+                                 data.dslack.coeff(i), data.cmpl.coeff(i));
+      dimf_stack += 3;
+    }
+  }
+}
+
+
+int ImpulseSmoothFrictionCone::dimc() const {
+  return dimc_;
+}
+
+} // namespace idocp
@@ -28,6 +28,16 @@ bool JointAccelerationLowerLimit::useKinematics() const {
 }
 
 
+BlockSparsity JointAccelerationLowerLimit::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity JointAccelerationLowerLimit::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 KinematicsLevel JointAccelerationLowerLimit::kinematicsLevel() const {
   return KinematicsLevel::AccelerationLevel;
 }
@@ -79,6 +89,14 @@ void JointAccelerationLowerLimit::condenseSlackAndDual(
 }
 
 
+void JointAccelerationLowerLimit::condenseSlackAndDual(
+    Robot& robot, ConstraintComponentData& data, const double dt, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
+  computeCondensingCoeffcient(data);
+  kkt_residual.la.tail(dimc_).noalias() -= dt * data.cond;
+}
+
+
 void JointAccelerationLowerLimit::expandSlackAndDual(
     ConstraintComponentData& data, const SplitSolution& s, 
     const SplitDirection& d) const {
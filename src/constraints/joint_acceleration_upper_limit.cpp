@@ -28,6 +28,16 @@ bool JointAccelerationUpperLimit::useKinematics() const {
 }
 
 
+BlockSparsity JointAccelerationUpperLimit::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity JointAccelerationUpperLimit::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 KinematicsLevel JointAccelerationUpperLimit::kinematicsLevel() const {
   return KinematicsLevel::AccelerationLevel;
 }
@@ -79,6 +89,14 @@ void JointAccelerationUpperLimit::condenseSlackAndDual(
 }
 
 
+void JointAccelerationUpperLimit::condenseSlackAndDual(
+    Robot& robot, ConstraintComponentData& data, const double dt, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
+  computeCondensingCoeffcient(data);
+  kkt_residual.la.tail(dimc_).noalias() += dt * data.cond;
+}
+
+
 void JointAccelerationUpperLimit::expandSlackAndDual(
     ConstraintComponentData& data, const SplitSolution& s, 
     const SplitDirection& d) const {
@@ -0,0 +1,248 @@
+#include "idocp/constraints/joint_box_limit.hpp"
+
+#include <stdexcept>
+#include <iostream>
+#include <cstdlib>
+
+
+namespace idocp {
+
+JointBoxLimit::JointBoxLimit(const Robot& robot, const JointVariable variable,
+                             const double barrier,
+                             const double fraction_to_boundary_rule)
+  : ConstraintComponentBase(barrier, fraction_to_boundary_rule),
+    variable_(variable),
+    dimx_(0),
+    xmin_(),
+    xmax_() {
+  try {
+    switch (variable) {
+      case JointVariable::Position:
+        xmin_ = robot.lowerJointPositionLimit();
+        xmax_ = robot.upperJointPositionLimit();
+        break;
+      case JointVariable::Velocity:
+        xmin_ = - robot.jointVelocityLimit();
+        xmax_ = robot.jointVelocityLimit();
+        break;
+      case JointVariable::Torques:
+        xmin_ = - robot.jointEffortLimit();
+        xmax_ = robot.jointEffortLimit();
+        break;
+      default:
+        throw std::invalid_argument(
+            "invalid argument: limits of the joint acceleration must be given!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  dimx_ = xmin_.size();
+}
+
+
+JointBoxLimit::JointBoxLimit(const Robot& robot, const JointVariable variable,
+                             const Eigen::VectorXd& xmin,
+                             const Eigen::VectorXd& xmax, const double barrier,
+                             const double fraction_to_boundary_rule)
+  : ConstraintComponentBase(barrier, fraction_to_boundary_rule),
+    variable_(variable),
+    dimx_(xmin.size()),
+    xmin_(xmin),
+    xmax_(xmax) {
+  try {
+    if (xmax.size() != xmin.size()) {
+      throw std::invalid_argument(
+          "invalid argument: xmin.size() must be the same as xmax.size()!");
+    }
+    if (xmin.size() > robot.dimv()) {
+      throw std::invalid_argument(
+          "invalid argument: xmin.size() must not be larger than robot.dimv()!");
+    }
+    if ((xmin.array() > xmax.array()).any()) {
+      throw std::invalid_argument(
+          "invalid argument: xmin must not be larger than xmax!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+
+JointBoxLimit::JointBoxLimit()
+  : ConstraintComponentBase(),
+    variable_(JointVariable::Position),
+    dimx_(0),
+    xmin_(),
+    xmax_() {
+}
+
+
+JointBoxLimit::~JointBoxLimit() {
+}
+
+
+bool JointBoxLimit::useKinematics() const {
+  return false;
+}
+
+
+BlockSparsity JointBoxLimit::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity JointBoxLimit::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+KinematicsLevel JointBoxLimit::kinematicsLevel() const {
+  switch (variable_) {
+    case JointVariable::Position:
+      return KinematicsLevel::PositionLevel;
+    case JointVariable::Velocity:
+      return KinematicsLevel::VelocityLevel;
+    default:
+      return KinematicsLevel::AccelerationLevel;
+  }
+}
+
+
+bool JointBoxLimit::isFeasible(Robot& robot, ConstraintComponentData& data,
+                               const SplitSolution& s) const {
+  const auto xs = x(s);
+  for (int i=0; i<dimx_; ++i) {
+    if (xs.coeff(i) < xmin_.coeff(i) || xs.coeff(i) > xmax_.coeff(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+void JointBoxLimit::setSlack(Robot& robot, ConstraintComponentData& data,
+                             const SplitSolution& s) const {
+  data.slack.head(dimx_) = x(s) - xmin_;
+  data.slack.tail(dimx_) = xmax_ - x(s);
+}
+
+
+void JointBoxLimit::evalConstraint(Robot& robot, ConstraintComponentData& data,
+                                   const SplitSolution& s) const {
+  data.residual.head(dimx_) = xmin_ - x(s) + data.slack.head(dimx_);
+  data.residual.tail(dimx_) = x(s) - xmax_ + data.slack.tail(dimx_);
+  computeComplementarySlackness(data);
+  data.log_barrier = logBarrier(data.slack);
+}
+
+
+void JointBoxLimit::evalDerivatives(Robot& robot, ConstraintComponentData& data,
+                                    const double dt, const SplitSolution& s,
+                                    SplitKKTResidual& kkt_residual) const {
+  switch (variable_) {
+    case JointVariable::Position:
+      addDerivatives(data, dt, kkt_residual.lq().tail(dimx_));
+      break;
+    case JointVariable::Velocity:
+      addDerivatives(data, dt, kkt_residual.lv().tail(dimx_));
+      break;
+    case JointVariable::Acceleration:
+      addDerivatives(data, dt, kkt_residual.la.tail(dimx_));
+      break;
+    default:
+      addDerivatives(data, dt, kkt_residual.lu.tail(dimx_));
+      break;
+  }
+}
+
+
+void JointBoxLimit::condenseSlackAndDual(Robot& robot,
+                                         ConstraintComponentData& data,
+                                         const double dt,
+                                         const SplitSolution& s,
+                                         SplitKKTMatrix& kkt_matrix,
+                                         SplitKKTResidual& kkt_residual) const {
+  computeCondensingCoeffcient(data);
+  switch (variable_) {
+    case JointVariable::Position:
+      addCondensedHessianAndResidual(
+          data, dt, kkt_matrix.Qqq().diagonal().tail(dimx_),
+          kkt_residual.lq().tail(dimx_));
+      break;
+    case JointVariable::Velocity:
+      addCondensedHessianAndResidual(
+          data, dt, kkt_matrix.Qvv().diagonal().tail(dimx_),
+          kkt_residual.lv().tail(dimx_));
+      break;
+    case JointVariable::Acceleration:
+      addCondensedHessianAndResidual(
+          data, dt, kkt_matrix.Qaa.diagonal().tail(dimx_),
+          kkt_residual.la.tail(dimx_));
+      break;
+    default:
+      addCondensedHessianAndResidual(
+          data, dt, kkt_matrix.Quu.diagonal().tail(dimx_),
+          kkt_residual.lu.tail(dimx_));
+      break;
+  }
+}
+
+
+void JointBoxLimit::condenseSlackAndDual(Robot& robot,
+                                         ConstraintComponentData& data,
+                                         const double dt,
+                                         const SplitSolution& s,
+                                         SplitKKTResidual& kkt_residual) const {
+  computeCondensingCoeffcient(data);
+  switch (variable_) {
+    case JointVariable::Position:
+      addCondensedResidual(data, dt, kkt_residual.lq().tail(dimx_));
+      break;
+    case JointVariable::Velocity:
+      addCondensedResidual(data, dt, kkt_residual.lv().tail(dimx_));
+      break;
+    case JointVariable::Acceleration:
+      addCondensedResidual(data, dt, kkt_residual.la.tail(dimx_));
+      break;
+    default:
+      addCondensedResidual(data, dt, kkt_residual.lu.tail(dimx_));
+      break;
+  }
+}
+
+
+void JointBoxLimit::expandSlackAndDual(ConstraintComponentData& data,
+                                       const SplitSolution& s,
+                                       const SplitDirection& d) const {
+  switch (variable_) {
+    case JointVariable::Position:
+      computeSlackDirection(data, d.dq().tail(dimx_));
+      break;
+    case JointVariable::Velocity:
+      computeSlackDirection(data, d.dv().tail(dimx_));
+      break;
+    case JointVariable::Acceleration:
+      computeSlackDirection(data, d.da().tail(dimx_));
+      break;
+    default:
+      computeSlackDirection(data, d.du.tail(dimx_));
+      break;
+  }
+  computeDualDirection(data);
+}
+
+
+int JointBoxLimit::dimc() const {
+  return 2*dimx_;
+}
+
+
+JointVariable JointBoxLimit::variable() const {
+  return variable_;
+}
+
+} // namespace idocp
@@ -28,6 +28,16 @@ bool JointPositionLowerLimit::useKinematics() const {
 }
 
 
+BlockSparsity JointPositionLowerLimit::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity JointPositionLowerLimit::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 KinematicsLevel JointPositionLowerLimit::kinematicsLevel() const {
   return KinematicsLevel::PositionLevel;
 }
@@ -79,6 +89,14 @@ void JointPositionLowerLimit::condenseSlackAndDual(
 }
 
 
+void JointPositionLowerLimit::condenseSlackAndDual(
+    Robot& robot, ConstraintComponentData& data, const double dt, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
+  computeCondensingCoeffcient(data);
+  kkt_residual.lq().tail(dimc_).noalias() -= dt * data.cond;
+}
+
+
 void JointPositionLowerLimit::expandSlackAndDual(
     ConstraintComponentData& data, const SplitSolution& s, 
     const SplitDirection& d) const {
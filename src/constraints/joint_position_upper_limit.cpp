@@ -27,6 +27,16 @@ bool JointPositionUpperLimit::useKinematics() const {
   return false;
 }
 
+
+BlockSparsity JointPositionUpperLimit::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity JointPositionUpperLimit::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
 KinematicsLevel JointPositionUpperLimit::kinematicsLevel() const {
   return KinematicsLevel::PositionLevel;
 }
@@ -78,6 +88,14 @@ void JointPositionUpperLimit::condenseSlackAndDual(
 }
 
 
+void JointPositionUpperLimit::condenseSlackAndDual(
+    Robot& robot, ConstraintComponentData& data, const double dt, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
+  computeCondensingCoeffcient(data);
+  kkt_residual.lq().tail(dimc_).noalias() += dt * data.cond;
+}
+
+
 void JointPositionUpperLimit::expandSlackAndDual(
     ConstraintComponentData& data, const SplitSolution& s, 
     const SplitDirection& d) const {
@@ -28,6 +28,16 @@ bool JointTorquesLowerLimit::useKinematics() const {
 }
 
 
+BlockSparsity JointTorquesLowerLimit::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity JointTorquesLowerLimit::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 KinematicsLevel JointTorquesLowerLimit::kinematicsLevel() const {
   return KinematicsLevel::AccelerationLevel;
 }
@@ -79,6 +89,14 @@ void JointTorquesLowerLimit::condenseSlackAndDual(
 }
 
 
+void JointTorquesLowerLimit::condenseSlackAndDual(
+    Robot& robot, ConstraintComponentData& data, const double dt, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
+  computeCondensingCoeffcient(data);
+  kkt_residual.lu.noalias() -= dt * data.cond;
+}
+
+
 void JointTorquesLowerLimit::expandSlackAndDual(
     ConstraintComponentData& data, const SplitSolution& s, 
     const SplitDirection& d) const {
@@ -28,6 +28,16 @@ bool JointTorquesUpperLimit::useKinematics() const {
 }
 
 
+BlockSparsity JointTorquesUpperLimit::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity JointTorquesUpperLimit::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 KinematicsLevel JointTorquesUpperLimit::kinematicsLevel() const {
   return KinematicsLevel::AccelerationLevel;
 }
@@ -79,6 +89,14 @@ void JointTorquesUpperLimit::condenseSlackAndDual(
 }
 
 
+void JointTorquesUpperLimit::condenseSlackAndDual(
+    Robot& robot, ConstraintComponentData& data, const double dt, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
+  computeCondensingCoeffcient(data);
+  kkt_residual.lu.noalias() += dt * data.cond;
+}
+
+
 void JointTorquesUpperLimit::expandSlackAndDual(
     ConstraintComponentData& data, const SplitSolution& s, 
     const SplitDirection& d) const {
@@ -28,6 +28,16 @@ bool JointVelocityLowerLimit::useKinematics() const {
 }
 
 
+BlockSparsity JointVelocityLowerLimit::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity JointVelocityLowerLimit::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 KinematicsLevel JointVelocityLowerLimit::kinematicsLevel() const {
   return KinematicsLevel::VelocityLevel;
 }
@@ -79,6 +89,14 @@ void JointVelocityLowerLimit::condenseSlackAndDual(
 }
 
 
+void JointVelocityLowerLimit::condenseSlackAndDual(
+    Robot& robot, ConstraintComponentData& data, const double dt, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
+  computeCondensingCoeffcient(data);
+  kkt_residual.lv().tail(dimc_).noalias() -= dt * data.cond;
+}
+
+
 void JointVelocityLowerLimit::expandSlackAndDual(
     ConstraintComponentData& data, const SplitSolution& s, 
     const SplitDirection& d) const {
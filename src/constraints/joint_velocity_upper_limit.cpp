@@ -28,6 +28,16 @@ bool JointVelocityUpperLimit::useKinematics() const {
 }
 
 
+BlockSparsity JointVelocityUpperLimit::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity JointVelocityUpperLimit::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 KinematicsLevel JointVelocityUpperLimit::kinematicsLevel() const {
   return KinematicsLevel::VelocityLevel;
 }
@@ -78,6 +88,14 @@ void JointVelocityUpperLimit::condenseSlackAndDual(
 }
 
 
+void JointVelocityUpperLimit::condenseSlackAndDual(
+    Robot& robot, ConstraintComponentData& data, const double dt, 
+    const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
+  computeCondensingCoeffcient(data);
+  kkt_residual.lv().tail(dimc_).noalias() += dt * data.cond;
+}
+
+
 void JointVelocityUpperLimit::expandSlackAndDual(
     ConstraintComponentData& data, const SplitSolution& s, 
     const SplitDirection& d) const {
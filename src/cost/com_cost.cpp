@@ -50,6 +50,16 @@ bool CoMCost::useKinematics() const {
 }
 
 
+BlockSparsity CoMCost::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity CoMCost::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 double CoMCost::computeStageCost(Robot& robot, CostFunctionData& data, 
                                  const double t, const double dt, 
                                  const SplitSolution& s) const {
@@ -238,6 +238,16 @@ bool ConfigurationSpaceCost::useKinematics() const {
 }
 
 
+BlockSparsity ConfigurationSpaceCost::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity ConfigurationSpaceCost::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 double ConfigurationSpaceCost::computeStageCost(
     Robot& robot, CostFunctionData& data, const double t, const double dt, 
     const SplitSolution& s) const {
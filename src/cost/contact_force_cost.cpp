@@ -103,6 +103,16 @@ bool ContactForceCost::useKinematics() const {
 }
 
 
+BlockSparsity ContactForceCost::QffSparsity() const {
+  return BlockSparsity::Diagonal;
+}
+
+
+BlockSparsity ContactForceCost::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 double ContactForceCost::computeStageCost(Robot& robot, CostFunctionData& data, 
                                           const double t, const double dt, 
                                           const SplitSolution& s) const {
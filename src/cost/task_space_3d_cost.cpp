@@ -52,6 +52,16 @@ bool TaskSpace3DCost::useKinematics() const {
 }
 
 
+BlockSparsity TaskSpace3DCost::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity TaskSpace3DCost::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 double TaskSpace3DCost::computeStageCost(Robot& robot, CostFunctionData& data, 
                                          const double t, const double dt, 
                                          const SplitSolution& s) const {
@@ -62,6 +62,16 @@ bool TaskSpace6DCost::useKinematics() const {
 }
 
 
+BlockSparsity TaskSpace6DCost::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity TaskSpace6DCost::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 double TaskSpace6DCost::computeStageCost(Robot& robot, CostFunctionData& data, 
                                          const double t, const double dt, 
                                          const SplitSolution& s) const {
@@ -8,6 +8,7 @@ TimeVaryingCoMCost::TimeVaryingCoMCost(
     const std::shared_ptr<TimeVaryingCoMRefBase>& ref) 
   : CostFunctionComponentBase(),
     ref_(ref),
+    ref_id_(TimeVaryingRefCache::generateRefId()),
     q_weight_(Eigen::Vector3d::Zero()),
     qf_weight_(Eigen::Vector3d::Zero()),
     qi_weight_(Eigen::Vector3d::Zero()) {
@@ -17,6 +18,7 @@ TimeVaryingCoMCost::TimeVaryingCoMCost(
 TimeVaryingCoMCost::TimeVaryingCoMCost()
   : CostFunctionComponentBase(),
     ref_(),
+    ref_id_(TimeVaryingRefCache::generateRefId()),
     q_weight_(),
     qf_weight_(),
     qi_weight_() {
@@ -30,6 +32,12 @@ TimeVaryingCoMCost::~TimeVaryingCoMCost() {
 void TimeVaryingCoMCost::set_ref(
     const std::shared_ptr<TimeVaryingCoMRefBase>& ref) {
   ref_ = ref;
+  ref_id_ = TimeVaryingRefCache::generateRefId();
+}
+
+
+void TimeVaryingCoMCost::invalidateRefCache() {
+  ref_id_ = TimeVaryingRefCache::generateRefId();
 }
 
 
@@ -53,14 +61,24 @@ bool TimeVaryingCoMCost::useKinematics() const {
 }
 
 
+BlockSparsity TimeVaryingCoMCost::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity TimeVaryingCoMCost::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 double TimeVaryingCoMCost::computeStageCost(Robot& robot, 
                                             CostFunctionData& data, 
                                             const double t, const double dt, 
                                             const SplitSolution& s) const {
-  if (ref_->isActive(t)) {
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     double l = 0;
-    ref_->update_CoM_ref(t, data.q_3d_ref);
-    data.diff_3d = robot.CoM() - data.q_3d_ref;
+    data.diff_3d = robot.CoM() - ref.ref;
     l += (q_weight_.array()*data.diff_3d.array()*data.diff_3d.array()).sum();
     return 0.5 * dt * l;
   }
@@ -73,7 +91,7 @@ double TimeVaryingCoMCost::computeStageCost(Robot& robot,
 void TimeVaryingCoMCost::computeStageCostDerivatives(
     Robot& robot, CostFunctionData& data, const double t, const double dt, 
     const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     data.J_3d.setZero();
     robot.getCoMJacobian(data.J_3d);
     kkt_residual.lq().noalias() 
@@ -85,7 +103,7 @@ void TimeVaryingCoMCost::computeStageCostDerivatives(
 void TimeVaryingCoMCost::computeStageCostHessian(
     Robot& robot, CostFunctionData& data, const double t, const double dt, 
     const SplitSolution& s, SplitKKTMatrix& kkt_matrix) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     kkt_matrix.Qqq().noalias()
         += dt * data.J_3d.transpose() * q_weight_.asDiagonal() * data.J_3d;
   }
@@ -95,10 +113,10 @@ void TimeVaryingCoMCost::computeStageCostHessian(
 double TimeVaryingCoMCost::computeTerminalCost(
     Robot& robot, CostFunctionData& data, const double t, 
     const SplitSolution& s) const {
-  if (ref_->isActive(t)) {
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     double l = 0;
-    ref_->update_CoM_ref(t, data.q_3d_ref);
-    data.diff_3d = robot.CoM() - data.q_3d_ref;
+    data.diff_3d = robot.CoM() - ref.ref;
     l += (qf_weight_.array()*data.diff_3d.array()*data.diff_3d.array()).sum();
     return 0.5 * l;
   }
@@ -111,7 +129,7 @@ double TimeVaryingCoMCost::computeTerminalCost(
 void TimeVaryingCoMCost::computeTerminalCostDerivatives(
     Robot& robot, CostFunctionData& data, const double t, 
     const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     data.J_3d.setZero();
     robot.getCoMJacobian(data.J_3d);
     kkt_residual.lq().noalias() 
@@ -123,7 +141,7 @@ void TimeVaryingCoMCost::computeTerminalCostDerivatives(
 void TimeVaryingCoMCost::computeTerminalCostHessian(
     Robot& robot, CostFunctionData& data, const double t, 
     const SplitSolution& s, SplitKKTMatrix& kkt_matrix) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     kkt_matrix.Qqq().noalias()
         += data.J_3d.transpose() * qf_weight_.asDiagonal() * data.J_3d;
   }
@@ -133,10 +151,10 @@ void TimeVaryingCoMCost::computeTerminalCostHessian(
 double TimeVaryingCoMCost::computeImpulseCost(
     Robot& robot, CostFunctionData& data, const double t, 
     const ImpulseSplitSolution& s) const {
-  if (ref_->isActive(t)) {
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     double l = 0;
-    ref_->update_CoM_ref(t, data.q_3d_ref);
-    data.diff_3d = robot.CoM() - data.q_3d_ref;
+    data.diff_3d = robot.CoM() - ref.ref;
     l += (qi_weight_.array()*data.diff_3d.array()*data.diff_3d.array()).sum();
     return 0.5 * l;
   }
@@ -150,7 +168,7 @@ void TimeVaryingCoMCost::computeImpulseCostDerivatives(
     Robot& robot, CostFunctionData& data, const double t, 
     const ImpulseSplitSolution& s, 
     ImpulseSplitKKTResidual& kkt_residual) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     data.J_3d.setZero();
     robot.getCoMJacobian(data.J_3d);
     kkt_residual.lq().noalias() 
@@ -162,10 +180,25 @@ void TimeVaryingCoMCost::computeImpulseCostDerivatives(
 void TimeVaryingCoMCost::computeImpulseCostHessian(
     Robot& robot, CostFunctionData& data, const double t, 
     const ImpulseSplitSolution& s, ImpulseSplitKKTMatrix& kkt_matrix) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     kkt_matrix.Qqq().noalias()
         += data.J_3d.transpose() * qi_weight_.asDiagonal() * data.J_3d;
   }
 }
 
+
+const TimeVaryingRefCache::Entry& TimeVaryingCoMCost::getRef(
+    const Robot& robot, CostFunctionData& data, const double t) const {
+  auto& ref = data.ref_cache.entry(this);
+  if (!ref.isUpToDate(ref_id_, t)) {
+    ref.is_active = ref_->isActive(t);
+    if (ref.is_active) {
+      ref.ref.resize(3);
+      ref_->update_CoM_ref(t, ref.ref);
+    }
+    ref.setUpToDate(ref_id_, t);
+  }
+  return ref;
+}
+
 } // namespace idocp
\ No newline at end of file
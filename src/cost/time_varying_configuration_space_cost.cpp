@@ -12,6 +12,7 @@ TimeVaryingConfigurationSpaceCost::TimeVaryingConfigurationSpaceCost(
   : dimq_(robot.dimq()),
     dimv_(robot.dimv()),
     ref_(ref),
+    ref_id_(TimeVaryingRefCache::generateRefId()),
     q_weight_(Eigen::VectorXd::Zero(robot.dimv())),
     qf_weight_(Eigen::VectorXd::Zero(robot.dimv())),
     qi_weight_(Eigen::VectorXd::Zero(robot.dimv())) {
@@ -22,6 +23,7 @@ TimeVaryingConfigurationSpaceCost::TimeVaryingConfigurationSpaceCost()
   : dimq_(0),
     dimv_(0),
     ref_(),
+    ref_id_(TimeVaryingRefCache::generateRefId()),
     q_weight_(),
     qf_weight_(),
     qi_weight_() {
@@ -35,6 +37,12 @@ TimeVaryingConfigurationSpaceCost::~TimeVaryingConfigurationSpaceCost() {
 void TimeVaryingConfigurationSpaceCost::set_ref(
     const std::shared_ptr<TimeVaryingConfigurationRefBase>& ref) {
   ref_ = ref;
+  ref_id_ = TimeVaryingRefCache::generateRefId();
+}
+
+
+void TimeVaryingConfigurationSpaceCost::invalidateRefCache() {
+  ref_id_ = TimeVaryingRefCache::generateRefId();
 }
 
 
@@ -91,13 +99,23 @@ bool TimeVaryingConfigurationSpaceCost::useKinematics() const {
 }
 
 
+BlockSparsity TimeVaryingConfigurationSpaceCost::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity TimeVaryingConfigurationSpaceCost::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 double TimeVaryingConfigurationSpaceCost::computeStageCost(
     Robot& robot, CostFunctionData& data, const double t, const double dt, 
     const SplitSolution& s) const {
-  if (ref_->isActive(t)) {
-    ref_->update_q_ref(robot, t, data.q_ref);
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     double l = 0;
-    robot.subtractConfiguration(s.q, data.q_ref, data.qdiff);
+    robot.subtractConfiguration(s.q, ref.ref, data.qdiff);
     l += (q_weight_.array()*data.qdiff.array()*data.qdiff.array()).sum();
     return 0.5 * dt * l;
   }
@@ -110,10 +128,10 @@ double TimeVaryingConfigurationSpaceCost::computeStageCost(
 void TimeVaryingConfigurationSpaceCost::computeStageCostDerivatives(
     Robot& robot, CostFunctionData& data, const double t, const double dt, 
     const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
-  if (ref_->isActive(t)) {
-    ref_->update_q_ref(robot, t, data.q_ref);
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     if (robot.hasFloatingBase()) {
-      robot.dSubtractConfiguration_dqf(s.q, data.q_ref, data.J_qdiff);
+      robot.dSubtractConfiguration_dqf(s.q, ref.ref, data.J_qdiff);
       kkt_residual.lq().noalias()
           += dt * data.J_qdiff.transpose() * q_weight_.asDiagonal() * data.qdiff;
     }
@@ -127,7 +145,7 @@ void TimeVaryingConfigurationSpaceCost::computeStageCostDerivatives(
 void TimeVaryingConfigurationSpaceCost::computeStageCostHessian(
     Robot& robot, CostFunctionData& data, const double t, const double dt, 
     const SplitSolution& s, SplitKKTMatrix& kkt_matrix) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     if (robot.hasFloatingBase()) {
       kkt_matrix.Qqq().noalias()
           += dt * data.J_qdiff.transpose() * q_weight_.asDiagonal() * data.J_qdiff;
@@ -142,10 +160,10 @@ void TimeVaryingConfigurationSpaceCost::computeStageCostHessian(
 double TimeVaryingConfigurationSpaceCost::computeTerminalCost(
     Robot& robot, CostFunctionData& data, const double t, 
     const SplitSolution& s) const {
-  if (ref_->isActive(t)) {
-    ref_->update_q_ref(robot, t, data.q_ref);
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     double l = 0;
-    robot.subtractConfiguration(s.q, data.q_ref, data.qdiff);
+    robot.subtractConfiguration(s.q, ref.ref, data.qdiff);
     l += (qf_weight_.array()*data.qdiff.array()*data.qdiff.array()).sum();
     return 0.5 * l;
   }
@@ -158,9 +176,10 @@ double TimeVaryingConfigurationSpaceCost::computeTerminalCost(
 void TimeVaryingConfigurationSpaceCost::computeTerminalCostDerivatives(
     Robot& robot, CostFunctionData& data, const double t, 
     const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
-  if (ref_->isActive(t)) {
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     if (robot.hasFloatingBase()) {
-      robot.dSubtractConfiguration_dqf(s.q, data.q_ref, data.J_qdiff);
+      robot.dSubtractConfiguration_dqf(s.q, ref.ref, data.J_qdiff);
       kkt_residual.lq().noalias()
           += data.J_qdiff.transpose() * qf_weight_.asDiagonal() * data.qdiff;
     }
@@ -174,7 +193,7 @@ void TimeVaryingConfigurationSpaceCost::computeTerminalCostDerivatives(
 void TimeVaryingConfigurationSpaceCost::computeTerminalCostHessian(
     Robot& robot, CostFunctionData& data, const double t, 
     const SplitSolution& s, SplitKKTMatrix& kkt_matrix) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     if (robot.hasFloatingBase()) {
       kkt_matrix.Qqq().noalias()
           += data.J_qdiff.transpose() * qf_weight_.asDiagonal() * data.J_qdiff;
@@ -189,10 +208,10 @@ void TimeVaryingConfigurationSpaceCost::computeTerminalCostHessian(
 double TimeVaryingConfigurationSpaceCost::computeImpulseCost(
     Robot& robot, CostFunctionData& data, const double t, 
     const ImpulseSplitSolution& s) const {
-  if (ref_->isActive(t)) {
-    ref_->update_q_ref(robot, t, data.q_ref);
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     double l = 0;
-    robot.subtractConfiguration(s.q, data.q_ref, data.qdiff);
+    robot.subtractConfiguration(s.q, ref.ref, data.qdiff);
     l += (qi_weight_.array()*data.qdiff.array()*data.qdiff.array()).sum();
     return 0.5 * l;
   }
@@ -206,9 +225,10 @@ void TimeVaryingConfigurationSpaceCost::computeImpulseCostDerivatives(
     Robot& robot, CostFunctionData& data, const double t, 
     const ImpulseSplitSolution& s, 
     ImpulseSplitKKTResidual& kkt_residual) const {
-  if (ref_->isActive(t)) {
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     if (robot.hasFloatingBase()) {
-      robot.dSubtractConfiguration_dqf(s.q, data.q_ref, data.J_qdiff);
+      robot.dSubtractConfiguration_dqf(s.q, ref.ref, data.J_qdiff);
       kkt_residual.lq().noalias()
           += data.J_qdiff.transpose() * qi_weight_.asDiagonal() * data.qdiff;
     }
@@ -222,7 +242,7 @@ void TimeVaryingConfigurationSpaceCost::computeImpulseCostDerivatives(
 void TimeVaryingConfigurationSpaceCost::computeImpulseCostHessian(
     Robot& robot, CostFunctionData& data, const double t, 
     const ImpulseSplitSolution& s, ImpulseSplitKKTMatrix& kkt_matrix) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     if (robot.hasFloatingBase()) {
       kkt_matrix.Qqq().noalias()
           += data.J_qdiff.transpose() * qi_weight_.asDiagonal() * data.J_qdiff;
@@ -233,4 +253,21 @@ void TimeVaryingConfigurationSpaceCost::computeImpulseCostHessian(
   }
 }
 
+
+const TimeVaryingRefCache::Entry& TimeVaryingConfigurationSpaceCost::getRef(
+    const Robot& robot, CostFunctionData& data, const double t) const {
+  auto& ref = data.ref_cache.entry(this);
+  if (!ref.isUpToDate(ref_id_, t)) {
+    ref.is_active = ref_->isActive(t);
+    if (ref.is_active) {
+      if (ref.ref.size() != robot.dimq()) {
+        ref.ref.resize(robot.dimq());
+      }
+      ref_->update_q_ref(robot, t, ref.ref);
+    }
+    ref.setUpToDate(ref_id_, t);
+  }
+  return ref;
+}
+
 } // namespace idocp
\ No newline at end of file
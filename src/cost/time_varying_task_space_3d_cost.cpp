@@ -9,6 +9,7 @@ TimeVaryingTaskSpace3DCost::TimeVaryingTaskSpace3DCost(
   : CostFunctionComponentBase(),
     frame_id_(frame_id),
     ref_(ref),
+    ref_id_(TimeVaryingRefCache::generateRefId()),
     q_3d_weight_(Eigen::Vector3d::Zero()),
     qf_3d_weight_(Eigen::Vector3d::Zero()),
     qi_3d_weight_(Eigen::Vector3d::Zero()) {
@@ -19,6 +20,7 @@ TimeVaryingTaskSpace3DCost::TimeVaryingTaskSpace3DCost()
   : CostFunctionComponentBase(),
     frame_id_(),
     ref_(),
+    ref_id_(TimeVaryingRefCache::generateRefId()),
     q_3d_weight_(),
     qf_3d_weight_(),
     qi_3d_weight_() {
@@ -32,6 +34,12 @@ TimeVaryingTaskSpace3DCost::~TimeVaryingTaskSpace3DCost() {
 void TimeVaryingTaskSpace3DCost::set_ref(
     const std::shared_ptr<TimeVaryingTaskSpace3DRefBase>& ref) {
   ref_ = ref;
+  ref_id_ = TimeVaryingRefCache::generateRefId();
+}
+
+
+void TimeVaryingTaskSpace3DCost::invalidateRefCache() {
+  ref_id_ = TimeVaryingRefCache::generateRefId();
 }
 
 
@@ -58,13 +66,23 @@ bool TimeVaryingTaskSpace3DCost::useKinematics() const {
 }
 
 
+BlockSparsity TimeVaryingTaskSpace3DCost::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity TimeVaryingTaskSpace3DCost::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 double TimeVaryingTaskSpace3DCost::computeStageCost(
     Robot& robot, CostFunctionData& data, const double t, const double dt, 
     const SplitSolution& s) const {
-  if (ref_->isActive(t)) {
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     double l = 0;
-    ref_->update_q_3d_ref(t, data.q_3d_ref);
-    data.diff_3d = robot.framePosition(frame_id_) - data.q_3d_ref;
+    data.diff_3d = robot.framePosition(frame_id_) - ref.ref;
     l += (q_3d_weight_.array()*data.diff_3d.array()*data.diff_3d.array()).sum();
     return 0.5 * dt * l;
   }
@@ -77,7 +95,7 @@ double TimeVaryingTaskSpace3DCost::computeStageCost(
 void TimeVaryingTaskSpace3DCost::computeStageCostDerivatives(
     Robot& robot, CostFunctionData& data, const double t, const double dt, 
     const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     data.J_6d.setZero();
     robot.getFrameJacobian(frame_id_, data.J_6d);
     data.J_3d.noalias() 
@@ -91,7 +109,7 @@ void TimeVaryingTaskSpace3DCost::computeStageCostDerivatives(
 void TimeVaryingTaskSpace3DCost::computeStageCostHessian(
     Robot& robot, CostFunctionData& data, const double t, const double dt, 
     const SplitSolution& s, SplitKKTMatrix& kkt_matrix) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     kkt_matrix.Qqq().noalias()
         += dt * data.J_3d.transpose() * q_3d_weight_.asDiagonal() * data.J_3d;
   }
@@ -101,10 +119,10 @@ void TimeVaryingTaskSpace3DCost::computeStageCostHessian(
 double TimeVaryingTaskSpace3DCost::computeTerminalCost(
     Robot& robot, CostFunctionData& data, const double t, 
     const SplitSolution& s) const {
-  if (ref_->isActive(t)) {
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     double l = 0;
-    ref_->update_q_3d_ref(t, data.q_3d_ref);
-    data.diff_3d = robot.framePosition(frame_id_) - data.q_3d_ref;
+    data.diff_3d = robot.framePosition(frame_id_) - ref.ref;
     l += (qf_3d_weight_.array()*data.diff_3d.array()*data.diff_3d.array()).sum();
     return 0.5 * l;
   }
@@ -117,7 +135,7 @@ double TimeVaryingTaskSpace3DCost::computeTerminalCost(
 void TimeVaryingTaskSpace3DCost::computeTerminalCostDerivatives(
     Robot& robot, CostFunctionData& data, const double t, 
     const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     data.J_6d.setZero();
     robot.getFrameJacobian(frame_id_, data.J_6d);
     data.J_3d.noalias() 
@@ -131,7 +149,7 @@ void TimeVaryingTaskSpace3DCost::computeTerminalCostDerivatives(
 void TimeVaryingTaskSpace3DCost::computeTerminalCostHessian(
     Robot& robot, CostFunctionData& data, const double t, 
     const SplitSolution& s, SplitKKTMatrix& kkt_matrix) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     kkt_matrix.Qqq().noalias()
         += data.J_3d.transpose() * qf_3d_weight_.asDiagonal() * data.J_3d;
   }
@@ -141,10 +159,10 @@ void TimeVaryingTaskSpace3DCost::computeTerminalCostHessian(
 double TimeVaryingTaskSpace3DCost::computeImpulseCost(
     Robot& robot, CostFunctionData& data, const double t, 
     const ImpulseSplitSolution& s) const {
-  if (ref_->isActive(t)) {
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     double l = 0;
-    ref_->update_q_3d_ref(t, data.q_3d_ref);
-    data.diff_3d = robot.framePosition(frame_id_) - data.q_3d_ref;
+    data.diff_3d = robot.framePosition(frame_id_) - ref.ref;
     l += (qi_3d_weight_.array()*data.diff_3d.array()*data.diff_3d.array()).sum();
     return 0.5 * l;
   }
@@ -158,7 +176,7 @@ void TimeVaryingTaskSpace3DCost::computeImpulseCostDerivatives(
     Robot& robot, CostFunctionData& data, const double t, 
     const ImpulseSplitSolution& s, 
     ImpulseSplitKKTResidual& kkt_residual) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     data.J_6d.setZero();
     robot.getFrameJacobian(frame_id_, data.J_6d);
     data.J_3d.noalias() 
@@ -172,10 +190,25 @@ void TimeVaryingTaskSpace3DCost::computeImpulseCostDerivatives(
 void TimeVaryingTaskSpace3DCost::computeImpulseCostHessian(
     Robot& robot, CostFunctionData& data, const double t, 
     const ImpulseSplitSolution& s, ImpulseSplitKKTMatrix& kkt_matrix) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     kkt_matrix.Qqq().noalias()
         += data.J_3d.transpose() * qi_3d_weight_.asDiagonal() * data.J_3d;
   }
 }
 
+
+const TimeVaryingRefCache::Entry& TimeVaryingTaskSpace3DCost::getRef(
+    const Robot& robot, CostFunctionData& data, const double t) const {
+  auto& ref = data.ref_cache.entry(this);
+  if (!ref.isUpToDate(ref_id_, t)) {
+    ref.is_active = ref_->isActive(t);
+    if (ref.is_active) {
+      ref.ref.resize(3);
+      ref_->update_q_3d_ref(t, ref.ref);
+    }
+    ref.setUpToDate(ref_id_, t);
+  }
+  return ref;
+}
+
 } // namespace idocp
\ No newline at end of file
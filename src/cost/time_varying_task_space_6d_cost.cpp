@@ -9,6 +9,7 @@ TimeVaryingTaskSpace6DCost::TimeVaryingTaskSpace6DCost(
   : CostFunctionComponentBase(),
     frame_id_(frame_id),
     ref_(ref),
+    ref_id_(TimeVaryingRefCache::generateRefId()),
     q_6d_weight_(Eigen::VectorXd::Zero(6)), 
     qf_6d_weight_(Eigen::VectorXd::Zero(6)), 
     qi_6d_weight_(Eigen::VectorXd::Zero(6)) {
@@ -19,6 +20,7 @@ TimeVaryingTaskSpace6DCost::TimeVaryingTaskSpace6DCost()
   : CostFunctionComponentBase(),
     frame_id_(0),
     ref_(),
+    ref_id_(TimeVaryingRefCache::generateRefId()),
     q_6d_weight_(Eigen::VectorXd::Zero(6)), 
     qf_6d_weight_(Eigen::VectorXd::Zero(6)), 
     qi_6d_weight_(Eigen::VectorXd::Zero(6)) {
@@ -32,6 +34,12 @@ TimeVaryingTaskSpace6DCost::~TimeVaryingTaskSpace6DCost() {
 void TimeVaryingTaskSpace6DCost::set_ref(
     const std::shared_ptr<TimeVaryingTaskSpace6DRefBase>& ref) {
   ref_ = ref;
+  ref_id_ = TimeVaryingRefCache::generateRefId();
+}
+
+
+void TimeVaryingTaskSpace6DCost::invalidateRefCache() {
+  ref_id_ = TimeVaryingRefCache::generateRefId();
 }
 
 
@@ -64,14 +72,23 @@ bool TimeVaryingTaskSpace6DCost::useKinematics() const {
 }
 
 
+BlockSparsity TimeVaryingTaskSpace6DCost::QffSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
+BlockSparsity TimeVaryingTaskSpace6DCost::QqfSparsity() const {
+  return BlockSparsity::Zero;
+}
+
+
 double TimeVaryingTaskSpace6DCost::computeStageCost(
     Robot& robot, CostFunctionData& data, const double t, const double dt, 
     const SplitSolution& s) const {
-  if (ref_->isActive(t)) {
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     double l = 0;
-    ref_->update_SE3_ref(t, data.SE3_ref);
-    data.SE3_ref_inv = data.SE3_ref.inverse();
-    data.diff_SE3 = data.SE3_ref_inv * robot.framePlacement(frame_id_);
+    data.diff_SE3 = ref.SE3_ref_inv * robot.framePlacement(frame_id_);
     data.diff_6d = pinocchio::log6(data.diff_SE3).toVector();
     l += (q_6d_weight_.array()*data.diff_6d.array()*data.diff_6d.array()).sum();
     return 0.5 * dt * l;
@@ -85,7 +102,7 @@ double TimeVaryingTaskSpace6DCost::computeStageCost(
 void TimeVaryingTaskSpace6DCost::computeStageCostDerivatives(
     Robot& robot, CostFunctionData& data, const double t, const double dt, 
     const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     data.J_66.setZero();
     pinocchio::Jlog6(data.diff_SE3, data.J_66);
     data.J_6d.setZero();
@@ -101,7 +118,7 @@ void TimeVaryingTaskSpace6DCost::computeStageCostDerivatives(
 void TimeVaryingTaskSpace6DCost::computeStageCostHessian(
     Robot& robot, CostFunctionData& data, const double t, const double dt, 
     const SplitSolution& s, SplitKKTMatrix& kkt_matrix) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     kkt_matrix.Qqq().noalias()
         += dt * data.JJ_6d.transpose() * q_6d_weight_.asDiagonal() * data.JJ_6d;
   }
@@ -111,11 +128,10 @@ void TimeVaryingTaskSpace6DCost::computeStageCostHessian(
 double TimeVaryingTaskSpace6DCost::computeTerminalCost(
     Robot& robot, CostFunctionData& data, const double t, 
     const SplitSolution& s) const {
-  if (ref_->isActive(t)) {
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     double l = 0;
-    ref_->update_SE3_ref(t, data.SE3_ref);
-    data.SE3_ref_inv = data.SE3_ref.inverse();
-    data.diff_SE3 = data.SE3_ref_inv * robot.framePlacement(frame_id_);
+    data.diff_SE3 = ref.SE3_ref_inv * robot.framePlacement(frame_id_);
     data.diff_6d = pinocchio::log6(data.diff_SE3).toVector();
     l += (qf_6d_weight_.array()*data.diff_6d.array()*data.diff_6d.array()).sum();
     return 0.5 * l;
@@ -129,7 +145,7 @@ double TimeVaryingTaskSpace6DCost::computeTerminalCost(
 void TimeVaryingTaskSpace6DCost::computeTerminalCostDerivatives(
     Robot& robot, CostFunctionData& data, const double t, 
     const SplitSolution& s, SplitKKTResidual& kkt_residual) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     data.J_66.setZero();
     pinocchio::Jlog6(data.diff_SE3, data.J_66);
     data.J_6d.setZero();
@@ -144,7 +160,7 @@ void TimeVaryingTaskSpace6DCost::computeTerminalCostDerivatives(
 void TimeVaryingTaskSpace6DCost::computeTerminalCostHessian(
     Robot& robot, CostFunctionData& data, const double t, 
     const SplitSolution& s, SplitKKTMatrix& kkt_matrix) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     kkt_matrix.Qqq().noalias()
         += data.JJ_6d.transpose() * qf_6d_weight_.asDiagonal() * data.JJ_6d;
   }
@@ -154,11 +170,10 @@ void TimeVaryingTaskSpace6DCost::computeTerminalCostHessian(
 double TimeVaryingTaskSpace6DCost::computeImpulseCost(
     Robot& robot, CostFunctionData& data, const double t, 
     const ImpulseSplitSolution& s) const {
-  if (ref_->isActive(t)) {
+  const auto& ref = getRef(robot, data, t);
+  if (ref.is_active) {
     double l = 0;
-    ref_->update_SE3_ref(t, data.SE3_ref);
-    data.SE3_ref_inv = data.SE3_ref.inverse();
-    data.diff_SE3 = data.SE3_ref_inv * robot.framePlacement(frame_id_);
+    data.diff_SE3 = ref.SE3_ref_inv * robot.framePlacement(frame_id_);
     data.diff_6d = pinocchio::log6(data.diff_SE3).toVector();
     l += (qi_6d_weight_.array()*data.diff_6d.array()*data.diff_6d.array()).sum();
     return 0.5 * l;
@@ -173,7 +188,7 @@ void TimeVaryingTaskSpace6DCost::computeImpulseCostDerivatives(
     Robot& robot, CostFunctionData& data, const double t, 
     const ImpulseSplitSolution& s, 
     ImpulseSplitKKTResidual& kkt_residual) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     data.J_66.setZero();
     pinocchio::Jlog6(data.diff_SE3, data.J_66);
     data.J_6d.setZero();
@@ -188,10 +203,25 @@ void TimeVaryingTaskSpace6DCost::computeImpulseCostDerivatives(
 void TimeVaryingTaskSpace6DCost::computeImpulseCostHessian(
     Robot& robot, CostFunctionData& data, const double t, 
     const ImpulseSplitSolution& s, ImpulseSplitKKTMatrix& kkt_matrix) const {
-  if (ref_->isActive(t)) {
+  if (getRef(robot, data, t).is_active) {
     kkt_matrix.Qqq().noalias()
         += data.JJ_6d.transpose() * qi_6d_weight_.asDiagonal() * data.JJ_6d;
   }
 }
 
+
+const TimeVaryingRefCache::Entry& TimeVaryingTaskSpace6DCost::getRef(
+    const Robot& robot, CostFunctionData& data, const double t) const {
+  auto& ref = data.ref_cache.entry(this);
+  if (!ref.isUpToDate(ref_id_, t)) {
+    ref.is_active = ref_->isActive(t);
+    if (ref.is_active) {
+      ref_->update_SE3_ref(t, ref.SE3_ref);
+      ref.SE3_ref_inv = ref.SE3_ref.inverse();
+    }
+    ref.setUpToDate(ref_id_, t);
+  }
+  return ref;
+}
+
 } // namespace idocp
\ No newline at end of file
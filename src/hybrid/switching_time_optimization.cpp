@@ -0,0 +1,212 @@
+#include "idocp/hybrid/switching_time_optimization.hpp"
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cassert>
+
+
+namespace idocp {
+
+SwitchingTimeOptimization::SwitchingTimeOptimization(const int max_num_impulse)
+  : N_impulse_(0),
+    N_lift_(0),
+    hessian_(1.0e03),
+    max_step_size_(0.01),
+    impulse_grad_(Eigen::VectorXd::Zero(max_num_impulse)),
+    lift_grad_(Eigen::VectorXd::Zero(max_num_impulse)),
+    impulse_dir_(Eigen::VectorXd::Zero(max_num_impulse)),
+    lift_dir_(Eigen::VectorXd::Zero(max_num_impulse)) {
+  try {
+    if (max_num_impulse < 0) {
+      throw std::out_of_range(
+          "Invalid argument: max_num_impulse must be non-negative!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+
+SwitchingTimeOptimization::SwitchingTimeOptimization()
+  : N_impulse_(0),
+    N_lift_(0),
+    hessian_(1.0e03),
+    max_step_size_(0.01),
+    impulse_grad_(),
+    lift_grad_(),
+    impulse_dir_(),
+    lift_dir_() {
+}
+
+
+SwitchingTimeOptimization::~SwitchingTimeOptimization() {
+}
+
+
+void SwitchingTimeOptimization::setParameters(const double hessian,
+                                              const double max_step_size) {
+  try {
+    if (hessian <= 0) {
+      throw std::out_of_range("Invalid argument: hessian must be positive!");
+    }
+    if (max_step_size <= 0) {
+      throw std::out_of_range(
+          "Invalid argument: max_step_size must be positive!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  hessian_ = hessian;
+  max_step_size_ = max_step_size;
+}
+
+
+void SwitchingTimeOptimization::computeKKTResidual(const OCP& ocp,
+                                                   const KKTMatrix& kkt_matrix,
+                                                   const Solution& s) {
+  N_impulse_ = ocp.discrete().N_impulse();
+  N_lift_ = ocp.discrete().N_lift();
+  assert(N_impulse_ <= impulse_grad_.size());
+  assert(N_lift_ <= lift_grad_.size());
+  impulse_grad_.setZero();
+  lift_grad_.setZero();
+  for (int i=0; i<N_impulse_; ++i) {
+    if (ocp.discrete().isSTOEnabledImpulse(i)) {
+      const int stage = ocp.discrete().timeStageBeforeImpulse(i);
+      // The time step before the impulse increases and that after the
+      // impulse decreases with the impulse time. The switching constraint 
+      // is imposed on the time stage before the time stage before the impulse.
+      if (stage > 0) {
+        impulse_grad_.coeffRef(i)
+            = ocp[stage].hamiltonian(ocp.discrete().dt(stage), s[stage],
+                                     s.impulse[i], ocp.discrete().dt(stage-1),
+                                     s[stage-1], kkt_matrix.switching[i]);
+      }
+      else {
+        impulse_grad_.coeffRef(i)
+            = ocp[stage].hamiltonian(ocp.discrete().dt(stage), s[stage],
+                                     s.impulse[i]);
+      }
+      impulse_grad_.coeffRef(i) 
+          -= ocp.aux[i].hamiltonian(ocp.discrete().dt_aux(i), s.aux[i],
+                                    s[stage+1]);
+    }
+  }
+  for (int i=0; i<N_lift_; ++i) {
+    if (ocp.discrete().isSTOEnabledLift(i)) {
+      const int stage = ocp.discrete().timeStageBeforeLift(i);
+      lift_grad_.coeffRef(i)
+          = ocp[stage].hamiltonian(ocp.discrete().dt(stage), s[stage],
+                                   s.lift[i])
+            - ocp.lift[i].hamiltonian(ocp.discrete().dt_lift(i), s.lift[i],
+                                      s[stage+1]);
+    }
+  }
+}
+
+
+void SwitchingTimeOptimization::computeDirection(const OCP& ocp) {
+  assert(N_impulse_ == ocp.discrete().N_impulse());
+  assert(N_lift_ == ocp.discrete().N_lift());
+  impulse_dir_.head(N_impulse_)
+      = (- impulse_grad_.head(N_impulse_) / hessian_).array()
+          .max(-max_step_size_).min(max_step_size_);
+  lift_dir_.head(N_lift_)
+      = (- lift_grad_.head(N_lift_) / hessian_).array()
+          .max(-max_step_size_).min(max_step_size_);
+}
+
+
+void SwitchingTimeOptimization::integrateSwitchingTimes(
+    const OCP& ocp, const double step_size,
+    ContactSequence& contact_sequence) const {
+  assert(step_size > 0);
+  assert(step_size <= 1);
+  const int N_events = N_impulse_ + N_lift_;
+  if (N_events <= 0) return;
+  double max_dt = 0;
+  for (int i=0; i<ocp.discrete().N_ideal(); ++i) {
+    max_dt = std::max(max_dt, ocp.discrete().dt_grid(i));
+  }
+  const double margin = 2 * max_dt;
+  // Event times of the current iteration in chronological order.
+  auto eventTime = [&](const int event_index, const int impulse_index,
+                       const int lift_index) -> double {
+    if (event_index >= N_events) {
+      return ocp.discrete().t(ocp.discrete().N());
+    }
+    else if (ocp.discrete().eventType(event_index)
+                == DiscreteEventType::Impulse) {
+      return ocp.discrete().t_impulse(impulse_index);
+    }
+    else {
+      return ocp.discrete().t_lift(lift_index);
+    }
+  };
+  double t_prev = ocp.discrete().t(0);
+  int impulse_index = 0;
+  int lift_index = 0;
+  for (int event_index=0; event_index<N_events; ++event_index) {
+    const bool is_impulse = (ocp.discrete().eventType(event_index)
+                              == DiscreteEventType::Impulse);
+    const double ts = eventTime(event_index, impulse_index, lift_index);
+    const double t_next
+        = eventTime(event_index+1, impulse_index+(is_impulse ? 1 : 0),
+                    lift_index+(is_impulse ? 0 : 1));
+    double ts_updated = ts;
+    if (is_impulse && ocp.discrete().isSTOEnabledImpulse(impulse_index)) {
+      ts_updated += step_size * impulse_dir_.coeff(impulse_index);
+    }
+    else if (!is_impulse && ocp.discrete().isSTOEnabledLift(lift_index)) {
+      ts_updated += step_size * lift_dir_.coeff(lift_index);
+    }
+    if (ts_updated != ts) {
+      // Never moves the event into the margin if it is already outside.
+      const double lb = std::min(ts, t_prev+margin);
+      const double ub = std::max(ts, t_next-margin);
+      ts_updated = std::max(lb, std::min(ub, ts_updated));
+      if (is_impulse) {
+        contact_sequence.updateImpulseTime(impulse_index, ts_updated);
+      }
+      else {
+        contact_sequence.updateLiftTime(lift_index, ts_updated);
+      }
+    }
+    t_prev = ts_updated;
+    if (is_impulse) ++impulse_index;
+    else ++lift_index;
+  }
+}
+
+
+double SwitchingTimeOptimization::KKTError() const {
+  return impulse_grad_.head(N_impulse_).squaredNorm()
+          + lift_grad_.head(N_lift_).squaredNorm();
+}
+
+
+const Eigen::VectorXd& SwitchingTimeOptimization::impulseTimeGradient() const {
+  return impulse_grad_;
+}
+
+
+const Eigen::VectorXd& SwitchingTimeOptimization::liftTimeGradient() const {
+  return lift_grad_;
+}
+
+
+const Eigen::VectorXd& SwitchingTimeOptimization::impulseTimeDirection() const {
+  return impulse_dir_;
+}
+
+
+const Eigen::VectorXd& SwitchingTimeOptimization::liftTimeDirection() const {
+  return lift_dir_;
+}
+
+} // namespace idocp
@@ -15,6 +15,8 @@ LineSearch::LineSearch(const Robot& robot, const int N,
     nthreads_(nthreads),
     step_size_reduction_rate_(step_size_reduction_rate), 
     min_step_size_(min_step_size),
+    second_order_correction_(false),
+    is_second_order_correction_computed_(false),
     costs_(Eigen::VectorXd::Zero(N+1)), 
     costs_impulse_(Eigen::VectorXd::Zero(max_num_impulse)), 
     costs_aux_(Eigen::VectorXd::Zero(max_num_impulse)), 
@@ -24,6 +26,7 @@ LineSearch::LineSearch(const Robot& robot, const int N,
     violations_aux_(Eigen::VectorXd::Zero(max_num_impulse)), 
     violations_lift_(Eigen::VectorXd::Zero(max_num_impulse)),
     s_trial_(robot, N, max_num_impulse), 
+    d_soc_(robot, N, max_num_impulse), 
     kkt_residual_(robot, N, max_num_impulse) {
 }
 
@@ -34,6 +37,8 @@ LineSearch::LineSearch()
     nthreads_(0),
     step_size_reduction_rate_(0), 
     min_step_size_(0),
+    second_order_correction_(false),
+    is_second_order_correction_computed_(false),
     costs_(), 
     costs_impulse_(), 
     costs_aux_(), 
@@ -43,6 +48,7 @@ LineSearch::LineSearch()
     violations_aux_(), 
     violations_lift_(),
     s_trial_(), 
+    d_soc_(), 
     kkt_residual_() {
 }
 
@@ -59,19 +65,15 @@ double LineSearch::computeStepSize(OCP& ocp, aligned_vector<Robot>& robots,
                                    const double max_primal_step_size) {
   assert(max_primal_step_size > 0);
   assert(max_primal_step_size <= 1);
+  is_second_order_correction_computed_ = false;
   if (filter_.isEmpty()) {
     computeCostAndViolation(ocp, robots, contact_sequence, q, v, s);
     filter_.augment(totalCosts(), totalViolations());
   }
   double primal_step_size = max_primal_step_size;
   while (primal_step_size > min_step_size_) {
-    computeSolutionTrial(ocp, robots, s, d, primal_step_size);
-    computeCostAndViolation(ocp, robots, contact_sequence, q, v, s_trial_,
-                            primal_step_size);
-    const double total_costs = totalCosts();
-    const double total_violations = totalViolations();
-    if (filter_.isAccepted(total_costs, total_violations)) {
-      filter_.augment(total_costs, total_violations);
+    if (isTrialAccepted(ocp, robots, contact_sequence, q, v, s, d, 
+                        primal_step_size)) {
       break;
     }
     primal_step_size *= step_size_reduction_rate_;
@@ -85,6 +87,70 @@ double LineSearch::computeStepSize(OCP& ocp, aligned_vector<Robot>& robots,
 }
 
 
+double LineSearch::computeStepSize(OCP& ocp, aligned_vector<Robot>& robots,
+                                   const ContactSequence& contact_sequence, 
+                                   const Eigen::VectorXd& q, 
+                                   const Eigen::VectorXd& v, 
+                                   const Solution& s, Direction& d, 
+                                   const double max_primal_step_size, 
+                                   RiccatiRecursion& riccati_recursion, 
+                                   KKTMatrix& kkt_matrix, 
+                                   RiccatiFactorization& factorization) {
+  is_second_order_correction_computed_ = false;
+  if (!second_order_correction_) {
+    return computeStepSize(ocp, robots, contact_sequence, q, v, s, d, 
+                           max_primal_step_size);
+  }
+  assert(max_primal_step_size > 0);
+  assert(max_primal_step_size <= 1);
+  if (filter_.isEmpty()) {
+    computeCostAndViolation(ocp, robots, contact_sequence, q, v, s);
+    filter_.augment(totalCosts(), totalViolations());
+  }
+  double primal_step_size = max_primal_step_size;
+  while (primal_step_size > min_step_size_) {
+    if (isTrialAccepted(ocp, robots, contact_sequence, q, v, s, d, 
+                        primal_step_size)) {
+      break;
+    }
+    // The second-order correction is tried only for the first trial step.
+    if (primal_step_size == max_primal_step_size 
+        && correctSecondOrder(ocp, robots, contact_sequence, q, v, s, d, 
+                              primal_step_size, riccati_recursion, 
+                              kkt_matrix, factorization)) {
+      break;
+    }
+    primal_step_size *= step_size_reduction_rate_;
+  }
+  if (primal_step_size > min_step_size_) {
+    return primal_step_size;
+  }
+  else {
+    return min_step_size_;
+  }
+}
+
+
+void LineSearch::setSecondOrderCorrection(const bool second_order_correction) {
+  second_order_correction_ = second_order_correction;
+}
+
+
+bool LineSearch::secondOrderCorrection() const {
+  return second_order_correction_;
+}
+
+
+bool LineSearch::isSecondOrderCorrectionComputed() const {
+  return is_second_order_correction_computed_;
+}
+
+
+const Direction& LineSearch::correctedDirection() const {
+  return d_soc_;
+}
+
+
 void LineSearch::clearFilter() {
   filter_.clear();
 }
@@ -95,6 +161,171 @@ bool LineSearch::isFilterEmpty() const {
 }
 
 
+void LineSearch::saveFilter(std::ostream& os) const {
+  filter_.save(os);
+}
+
+
+void LineSearch::loadFilter(std::istream& is) {
+  filter_.load(is);
+}
+
+
+bool LineSearch::isTrialAccepted(OCP& ocp, aligned_vector<Robot>& robots,
+                                 const ContactSequence& contact_sequence, 
+                                 const Eigen::VectorXd& q, 
+                                 const Eigen::VectorXd& v, 
+                                 const Solution& s, const Direction& d, 
+                                 const double primal_step_size) {
+  computeSolutionTrial(ocp, robots, s, d, primal_step_size);
+  computeCostAndViolation(ocp, robots, contact_sequence, q, v, s_trial_,
+                          primal_step_size);
+  const double total_costs = totalCosts();
+  const double total_violations = totalViolations();
+  if (filter_.isAccepted(total_costs, total_violations)) {
+    filter_.augment(total_costs, total_violations);
+    return true;
+  }
+  return false;
+}
+
+
+bool LineSearch::correctSecondOrder(OCP& ocp, aligned_vector<Robot>& robots,
+                                    const ContactSequence& contact_sequence, 
+                                    const Eigen::VectorXd& q, 
+                                    const Eigen::VectorXd& v, 
+                                    const Solution& s, Direction& d, 
+                                    const double primal_step_size, 
+                                    RiccatiRecursion& riccati_recursion, 
+                                    KKTMatrix& kkt_matrix, 
+                                    RiccatiFactorization& factorization) {
+  assert(primal_step_size > 0);
+  const int N = ocp.discrete().N();
+  const int N_impulse = ocp.discrete().N_impulse();
+  const int N_lift = ocp.discrete().N_lift();
+  const int N_all = N + 1 + 2*N_impulse + N_lift;
+  // After computeCostAndViolation() at the rejected trial point, kkt_residual_
+  // consists only of the residuals of the state equations and the switching 
+  // constraints, which are transformed in the same way as the linearization.
+  // The residuals of the contact and impulse dynamics at the trial point are 
+  // then condensed with the Jacobians of the linearization.
+  #pragma omp parallel for num_threads(nthreads_)
+  for (int i=0; i<N_all; ++i) {
+    if (i < N) {
+      ocp[i].correctStateEquationResidual(kkt_residual_[i]);
+      ocp[i].condenseContactDynamicsResidual(
+          robots[omp_get_thread_num()], 
+          contact_sequence.contactStatus(ocp.discrete().contactPhase(i)), 
+          ocp.discrete().dt(i), kkt_matrix[i], kkt_residual_[i]);
+    }
+    else if (i == N) {
+      kkt_residual_[N].lx.setZero();
+    }
+    else if (i < N+1+N_impulse) {
+      const int impulse_index = i - (N+1);
+      ocp.impulse[impulse_index].correctStateEquationResidual(
+          kkt_residual_.impulse[impulse_index]);
+      ocp.impulse[impulse_index].condenseImpulseDynamicsResidual(
+          robots[omp_get_thread_num()], 
+          contact_sequence.impulseStatus(impulse_index), 
+          kkt_matrix.impulse[impulse_index], 
+          kkt_residual_.impulse[impulse_index]);
+    }
+    else if (i < N+1+2*N_impulse) {
+      const int impulse_index  = i - (N+1+N_impulse);
+      ocp.aux[impulse_index].correctStateEquationResidual(
+          kkt_residual_.aux[impulse_index]);
+      ocp.aux[impulse_index].condenseContactDynamicsResidual(
+          robots[omp_get_thread_num()], 
+          contact_sequence.contactStatus(
+              ocp.discrete().contactPhaseAfterImpulse(impulse_index)), 
+          ocp.discrete().dt_aux(impulse_index), kkt_matrix.aux[impulse_index], 
+          kkt_residual_.aux[impulse_index]);
+    }
+    else {
+      const int lift_index = i - (N+1+2*N_impulse);
+      ocp.lift[lift_index].correctStateEquationResidual(
+          kkt_residual_.lift[lift_index]);
+      ocp.lift[lift_index].condenseContactDynamicsResidual(
+          robots[omp_get_thread_num()], 
+          contact_sequence.contactStatus(
+              ocp.discrete().contactPhaseAfterLift(lift_index)), 
+          ocp.discrete().dt_lift(lift_index), kkt_matrix.lift[lift_index], 
+          kkt_residual_.lift[lift_index]);
+    }
+  }
+  d_soc_[0].dx.setZero();
+  if (!riccati_recursion.solveWithFactorization(ocp, kkt_matrix, kkt_residual_, 
+                                                factorization, d_soc_)) {
+    return false;
+  }
+  // The corrected direction is d + d_soc / primal_step_size so that the 
+  // corrected trial point is s + primal_step_size * d + d_soc. The condensed 
+  // variables of d_soc are expanded before the sum because they involve the 
+  // residuals of the contact and impulse dynamics at the trial point.
+  const double step_size_inv = 1.0 / primal_step_size;
+  #pragma omp parallel for num_threads(nthreads_)
+  for (int i=0; i<N_all; ++i) {
+    if (i < N) {
+      ocp[i].expandPrimalWithoutSlackAndDual(s[i], d_soc_[i]);
+      correctPrimalDirection(d[i], step_size_inv, d_soc_[i]);
+    }
+    else if (i == N) {
+      d_soc_[N].dx = d[N].dx + step_size_inv * d_soc_[N].dx;
+    }
+    else if (i < N+1+N_impulse) {
+      const int impulse_index = i - (N+1);
+      ocp.impulse[impulse_index].expandPrimalWithoutSlackAndDual(
+          s.impulse[impulse_index], d_soc_.impulse[impulse_index]);
+      correctPrimalDirection(d.impulse[impulse_index], step_size_inv, 
+                             d_soc_.impulse[impulse_index]);
+    }
+    else if (i < N+1+2*N_impulse) {
+      const int impulse_index  = i - (N+1+N_impulse);
+      ocp.aux[impulse_index].expandPrimalWithoutSlackAndDual(
+          s.aux[impulse_index], d_soc_.aux[impulse_index]);
+      correctPrimalDirection(d.aux[impulse_index], step_size_inv, 
+                             d_soc_.aux[impulse_index]);
+    }
+    else {
+      const int lift_index = i - (N+1+2*N_impulse);
+      ocp.lift[lift_index].expandPrimalWithoutSlackAndDual(
+          s.lift[lift_index], d_soc_.lift[lift_index]);
+      correctPrimalDirection(d.lift[lift_index], step_size_inv, 
+                             d_soc_.lift[lift_index]);
+    }
+  }
+  is_second_order_correction_computed_ = true;
+  if (!isTrialAccepted(ocp, robots, contact_sequence, q, v, s, d_soc_, 
+                       primal_step_size)) {
+    return false;
+  }
+  #pragma omp parallel for num_threads(nthreads_)
+  for (int i=0; i<N_all; ++i) {
+    if (i < N) {
+      copyPrimalDirection(d_soc_[i], d[i]);
+    }
+    else if (i == N) {
+      d[N].dx = d_soc_[N].dx;
+    }
+    else if (i < N+1+N_impulse) {
+      const int impulse_index = i - (N+1);
+      copyPrimalDirection(d_soc_.impulse[impulse_index], 
+                          d.impulse[impulse_index]);
+    }
+    else if (i < N+1+2*N_impulse) {
+      const int impulse_index  = i - (N+1+N_impulse);
+      copyPrimalDirection(d_soc_.aux[impulse_index], d.aux[impulse_index]);
+    }
+    else {
+      const int lift_index = i - (N+1+2*N_impulse);
+      copyPrimalDirection(d_soc_.lift[lift_index], d.lift[lift_index]);
+    }
+  }
+  return true;
+}
+
+
 void LineSearch::computeCostAndViolation(
     OCP& ocp, aligned_vector<Robot>& robots, 
     const ContactSequence& contact_sequence, const Eigen::VectorXd& q, 
@@ -134,7 +365,7 @@ void LineSearch::computeCostAndViolation(
         violations_.coeffRef(i) = ocp[i].constraintViolation(kkt_residual_[i], 
                                                              ocp.discrete().dt(i));
       }
-      if (ocp.discrete().isTimeStageBeforeImpulse(i+1)) {
+      else if (ocp.discrete().isTimeStageBeforeImpulse(i+1)) {
         const int impulse_index  
             = ocp.discrete().impulseIndexAfterTimeStage(i+1);
         ocp[i].evalOCP(robots[omp_get_thread_num()], 
@@ -231,10 +462,18 @@ void LineSearch::computeSolutionTrial(const OCP& ocp,
   const int N_all = N + 1 + 2*N_impulse + N_lift;
   #pragma omp parallel for num_threads(nthreads_)
   for (int i=0; i<N_all; ++i) {
-    if (i <= N) {
+    if (i < N) {
       computeSolutionTrial(robots[omp_get_thread_num()], s[i], d[i], step_size, 
                            s_trial_[i]);
     }
+    else if (i == N) {
+      // Only the state of the terminal stage is used and the direction of the
+      // terminal stage does not have the contact forces.
+      robots[omp_get_thread_num()].integrateConfiguration(s[N].q, d[N].dq(), 
+                                                          step_size, 
+                                                          s_trial_[N].q);
+      s_trial_[N].v = s[N].v + step_size * d[N].dv();
+    }
     else if (i < N+1+N_impulse) {
       const int impulse_index = i - (N+1);
       computeSolutionTrial(robots[omp_get_thread_num()], 
@@ -3,6 +3,9 @@
 #include <cassert>
 #include <stdexcept>
 #include <iostream>
+#include <string>
+
+#include "idocp/utils/binary_io.hpp"
 
 
 namespace idocp {
@@ -79,4 +82,28 @@ bool LineSearchFilter::isEmpty() const {
   }
 }
 
+void LineSearchFilter::save(std::ostream& os) const {
+  binaryio::write(os, static_cast<int>(filter_.size()));
+  for (const auto& pair : filter_) {
+    binaryio::write(os, pair.first);
+    binaryio::write(os, pair.second);
+  }
+}
+
+
+void LineSearchFilter::load(std::istream& is) {
+  int size;
+  binaryio::read(is, size);
+  if (size < 0) {
+    throw std::runtime_error("invalid size of the line search filter " 
+                             + std::to_string(size) + " is stored!");
+  }
+  std::vector<std::pair<double, double>> filter(size);
+  for (auto& pair : filter) {
+    binaryio::read(is, pair.first);
+    binaryio::read(is, pair.second);
+  }
+  filter_.swap(filter);
+}
+
 } // namespace idocp
\ No newline at end of file
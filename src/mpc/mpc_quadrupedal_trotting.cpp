@@ -72,6 +72,17 @@ void MPCQuadrupedalTrotting::setGaitPattern(const double step_length,
 }
 
 
+void MPCQuadrupedalTrotting::setDiscretizationGrid(
+    const std::vector<double>& dt) {
+  ocp_solver_.setDiscretizationGrid(dt);
+}
+
+
+void MPCQuadrupedalTrotting::setGeometricDiscretizationGrid(const double ratio) {
+  ocp_solver_.setGeometricDiscretizationGrid(ratio);
+}
+
+
 void MPCQuadrupedalTrotting::init(const double t, const Eigen::VectorXd& q, 
                                   const Eigen::VectorXd& v, 
                                   const int num_iteration) {
@@ -110,7 +121,9 @@ void MPCQuadrupedalTrotting::init(const double t, const Eigen::VectorXd& q,
   ocp_solver_.setSolution("f", f_init);
   ocp_solver_.initConstraints(t);
   for (int i=0; i<num_iteration; ++i) {
-    ocp_solver_.updateSolution(t, q, v);
+    if (!ocp_solver_.updateSolution(t, q, v)) {
+      break;
+    }
   }
   ts_last_ = t0_;
 }
@@ -136,7 +149,9 @@ void MPCQuadrupedalTrotting::updateSolution(const double t,
   }
 
   for (int i=0; i<num_iteration; ++i) {
-    ocp_solver_.updateSolution(t, q, v);
+    if (!ocp_solver_.updateSolution(t, q, v)) {
+      break;
+    }
   }
 }
 
@@ -146,6 +161,11 @@ const Eigen::VectorXd& MPCQuadrupedalTrotting::getInitialControlInput() const {
 }
 
 
+void MPCQuadrupedalTrotting::getControlPolicy(ControlPolicy& policy) const {
+  ocp_solver_.getControlPolicy(policy);
+}
+
+
 double MPCQuadrupedalTrotting::KKTError(const double t, 
                                         const Eigen::VectorXd& q, 
                                         const Eigen::VectorXd& v) {
@@ -270,4 +290,23 @@ void MPCQuadrupedalTrotting::showInfo() const {
   ocp_solver_.showInfo();
 }
 
+
+bool MPCQuadrupedalTrotting::startRecording(const std::string& file_name, 
+                                            const double t) {
+  return ocp_solver_.startRecording(file_name, t);
+}
+
+
+void MPCQuadrupedalTrotting::stopRecording() {
+  ocp_solver_.stopRecording();
+}
+
+
+bool MPCQuadrupedalTrotting::applyRealTimeProfile(const RealTimeProfile& profile, 
+                                                  const double t, 
+                                                  const Eigen::VectorXd& q, 
+                                                  const Eigen::VectorXd& v) {
+  return ocp_solver_.applyRealTimeProfile(profile, t, q, v);
+}
+
 } // namespace idocp 
\ No newline at end of file
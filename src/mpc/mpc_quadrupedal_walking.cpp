@@ -76,6 +76,17 @@ void MPCQuadrupedalWalking::setGaitPattern(const double step_length,
 }
 
 
+void MPCQuadrupedalWalking::setDiscretizationGrid(
+    const std::vector<double>& dt) {
+  ocp_solver_.setDiscretizationGrid(dt);
+}
+
+
+void MPCQuadrupedalWalking::setGeometricDiscretizationGrid(const double ratio) {
+  ocp_solver_.setGeometricDiscretizationGrid(ratio);
+}
+
+
 void MPCQuadrupedalWalking::init(const double t, const Eigen::VectorXd& q, 
                                  const Eigen::VectorXd& v, 
                                  const int num_iteration) {
@@ -120,7 +131,9 @@ void MPCQuadrupedalWalking::init(const double t, const Eigen::VectorXd& q,
   ocp_solver_.setSolution("f", f_init);
   ocp_solver_.initConstraints(t);
   for (int i=0; i<num_iteration; ++i) {
-    ocp_solver_.updateSolution(t, q, v);
+    if (!ocp_solver_.updateSolution(t, q, v)) {
+      break;
+    }
   }
   ts_last_ = t0_;
 }
@@ -146,7 +159,9 @@ void MPCQuadrupedalWalking::updateSolution(const double t,
   }
 
   for (int i=0; i<num_iteration; ++i) {
-    ocp_solver_.updateSolution(t, q, v);
+    if (!ocp_solver_.updateSolution(t, q, v)) {
+      break;
+    }
   }
 }
 
@@ -156,6 +171,11 @@ const Eigen::VectorXd& MPCQuadrupedalWalking::getInitialControlInput() const {
 }
 
 
+void MPCQuadrupedalWalking::getControlPolicy(ControlPolicy& policy) const {
+  ocp_solver_.getControlPolicy(policy);
+}
+
+
 double MPCQuadrupedalWalking::KKTError(const double t, const Eigen::VectorXd& q, 
                                        const Eigen::VectorXd& v) {
   ocp_solver_.computeKKTResidual(t, q, v);
@@ -298,4 +318,23 @@ void MPCQuadrupedalWalking::showInfo() const {
   ocp_solver_.showInfo();
 }
 
+
+bool MPCQuadrupedalWalking::startRecording(const std::string& file_name, 
+                                           const double t) {
+  return ocp_solver_.startRecording(file_name, t);
+}
+
+
+void MPCQuadrupedalWalking::stopRecording() {
+  ocp_solver_.stopRecording();
+}
+
+
+bool MPCQuadrupedalWalking::applyRealTimeProfile(const RealTimeProfile& profile, 
+                                                 const double t, 
+                                                 const Eigen::VectorXd& q, 
+                                                 const Eigen::VectorXd& v) {
+  return ocp_solver_.applyRealTimeProfile(profile, t, q, v);
+}
+
 } // namespace idocp 
\ No newline at end of file
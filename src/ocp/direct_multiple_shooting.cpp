@@ -93,6 +93,28 @@ void DirectMultipleShooting::computeKKTSystem(
 }
 
 
+void DirectMultipleShooting::computeKKTSystem(
+    OCP& ocp, aligned_vector<Robot>& robots, 
+    const ContactSequence& contact_sequence, const Eigen::VectorXd& q, 
+    const Eigen::VectorXd& v, const Solution& s, KKTMatrix& kkt_matrix, 
+    KKTResidual& kkt_residual, const IterationLevel level) const {
+  switch (level) {
+    case IterationLevel::Jacobian:
+      runParallel<internal::ComputeKKTSystemAtLevel<IterationLevel::Jacobian>>(
+          ocp, robots, contact_sequence, q, v, s, kkt_matrix, kkt_residual);
+      break;
+    case IterationLevel::Residual:
+      runParallel<internal::ComputeKKTSystemAtLevel<IterationLevel::Residual>>(
+          ocp, robots, contact_sequence, q, v, s, kkt_matrix, kkt_residual);
+      break;
+    default:
+      runParallel<internal::ComputeKKTSystem>(ocp, robots, contact_sequence, 
+                                              q, v, s, kkt_matrix, kkt_residual);
+      break;
+  }
+}
+
+
 double DirectMultipleShooting::KKTError(const OCP& ocp, 
                                         const KKTResidual& kkt_residual) {
   const int N = ocp.discrete().N();
@@ -0,0 +1,401 @@
+#include "idocp/parnmpc/unconstr_async_iteration.hpp"
+
+#include <omp.h>
+#include <stdexcept>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+
+namespace idocp {
+
+UnconstrAsyncIteration::UnconstrAsyncIteration(const Robot& robot,
+                                               const double T, const int N,
+                                               const int nthreads)
+  : N_(N),
+    nthreads_(nthreads),
+    num_blocks_(std::min(N, nthreads)),
+    max_sweeps_(10),
+    dimq_(robot.dimq()),
+    dimv_(robot.dimv()),
+    T_(T),
+    dt_(T/N),
+    tol_(1.0e-08),
+    deterministic_(false),
+    corrector_(N, UnconstrSplitBackwardCorrection(robot)),
+    s_new_(robot, N),
+    aux_mat_(N, Eigen::MatrixXd::Zero(2*robot.dimv(), 2*robot.dimv())),
+    s_prev_(std::min(N, nthreads), SplitSolution(robot)),
+    s_next_(std::min(N, nthreads), SplitSolution(robot)),
+    aux_mat_next_(std::min(N, nthreads),
+                  Eigen::MatrixXd::Zero(2*robot.dimv(), 2*robot.dimv())),
+    forward_buffer_(),
+    backward_buffer_(),
+    squared_norm_(),
+    num_sweeps_(std::min(N, nthreads), 0) {
+  try {
+    if (T <= 0) {
+      throw std::out_of_range("invalid value: T must be positive!");
+    }
+    if (N <= 0) {
+      throw std::out_of_range("invalid value: N must be positive!");
+    }
+    if (nthreads <= 0) {
+      throw std::out_of_range("invalid value: nthreads must be positive!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  allocateBuffers();
+}
+
+
+UnconstrAsyncIteration::UnconstrAsyncIteration()
+  : N_(0),
+    nthreads_(0),
+    num_blocks_(0),
+    max_sweeps_(10),
+    dimq_(0),
+    dimv_(0),
+    T_(0),
+    dt_(0),
+    tol_(1.0e-08),
+    deterministic_(false),
+    corrector_(),
+    s_new_(),
+    aux_mat_(),
+    s_prev_(),
+    s_next_(),
+    aux_mat_next_(),
+    forward_buffer_(),
+    backward_buffer_(),
+    squared_norm_(),
+    num_sweeps_() {
+}
+
+
+UnconstrAsyncIteration::~UnconstrAsyncIteration() {
+}
+
+
+UnconstrAsyncIteration::UnconstrAsyncIteration(
+    const UnconstrAsyncIteration& other)
+  : N_(other.N_),
+    nthreads_(other.nthreads_),
+    num_blocks_(other.num_blocks_),
+    max_sweeps_(other.max_sweeps_),
+    dimq_(other.dimq_),
+    dimv_(other.dimv_),
+    T_(other.T_),
+    dt_(other.dt_),
+    tol_(other.tol_),
+    deterministic_(other.deterministic_),
+    corrector_(other.corrector_),
+    s_new_(other.s_new_),
+    aux_mat_(other.aux_mat_),
+    s_prev_(other.s_prev_),
+    s_next_(other.s_next_),
+    aux_mat_next_(other.aux_mat_next_),
+    forward_buffer_(),
+    backward_buffer_(),
+    squared_norm_(),
+    num_sweeps_(other.num_sweeps_) {
+  allocateBuffers();
+}
+
+
+UnconstrAsyncIteration& UnconstrAsyncIteration::operator=(
+    const UnconstrAsyncIteration& other) {
+  if (this != &other) {
+    const bool reallocate = (N_ != other.N_ || dimq_ != other.dimq_
+                             || dimv_ != other.dimv_
+                             || num_blocks_ != other.num_blocks_);
+    N_ = other.N_;
+    nthreads_ = other.nthreads_;
+    num_blocks_ = other.num_blocks_;
+    max_sweeps_ = other.max_sweeps_;
+    dimq_ = other.dimq_;
+    dimv_ = other.dimv_;
+    T_ = other.T_;
+    dt_ = other.dt_;
+    tol_ = other.tol_;
+    deterministic_ = other.deterministic_;
+    corrector_ = other.corrector_;
+    s_new_ = other.s_new_;
+    aux_mat_ = other.aux_mat_;
+    s_prev_ = other.s_prev_;
+    s_next_ = other.s_next_;
+    aux_mat_next_ = other.aux_mat_next_;
+    num_sweeps_ = other.num_sweeps_;
+    if (reallocate || forward_buffer_.empty()) {
+      allocateBuffers();
+    }
+  }
+  return *this;
+}
+
+
+void UnconstrAsyncIteration::setParameters(const int max_sweeps,
+                                           const double tol,
+                                           const bool deterministic) {
+  try {
+    if (max_sweeps <= 0) {
+      throw std::out_of_range("invalid value: max_sweeps must be positive!");
+    }
+    if (tol < 0) {
+      throw std::out_of_range("invalid value: tol must be non-negative!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  max_sweeps_ = max_sweeps;
+  tol_ = tol;
+  deterministic_ = deterministic;
+}
+
+
+void UnconstrAsyncIteration::initAuxMat(aligned_vector<Robot>& robots,
+                                        UnconstrParNMPC& parnmpc,
+                                        const double t, const Solution& s,
+                                        KKTMatrix& kkt_matrix,
+                                        KKTResidual& kkt_residual) {
+  parnmpc.terminal.computeTerminalCostHessian(robots[0], t+T_, s[N_-1],
+                                              kkt_matrix[0], kkt_residual[0]);
+  #pragma omp parallel for num_threads(nthreads_)
+  for (int i=0; i<N_; ++i) {
+    aux_mat_[i] = kkt_matrix[0].Qxx;
+  }
+  kkt_matrix[0].setZero();
+  kkt_residual[0].setZero();
+}
+
+
+bool UnconstrAsyncIteration::iterate(aligned_vector<Robot>& robots,
+                                     UnconstrParNMPC& parnmpc,
+                                     const double t, const Eigen::VectorXd& q,
+                                     const Eigen::VectorXd& v,
+                                     KKTMatrix& kkt_matrix,
+                                     KKTResidual& kkt_residual, Solution& s,
+                                     Direction& d) {
+  // Discards the boundary data remaining from the previous iteration, since
+  // the solution may have been modified after it, and starts from s.
+  for (auto& e : forward_buffer_)  { e->update(); }
+  for (auto& e : backward_buffer_) { e->update(); }
+  for (int block=0; block<num_blocks_; ++block) {
+    const int stage_begin = stageBegin(block);
+    const int stage_end = stageBegin(block+1);
+    if (stage_begin > 0) {
+      s_prev_[block].q = s[stage_begin-1].q;
+      s_prev_[block].v = s[stage_begin-1].v;
+    }
+    if (stage_end < N_) {
+      s_next_[block].lmd = s[stage_end].lmd;
+      s_next_[block].gmm = s[stage_end].gmm;
+      aux_mat_next_[block] = aux_mat_[stage_end];
+    }
+    squared_norm_[block].store(std::numeric_limits<double>::infinity(),
+                               std::memory_order_relaxed);
+    num_sweeps_[block] = 0;
+  }
+  const double squared_tol = tol_ * tol_;
+  auto isConverged = [&]() {
+    double squared_norm = 0;
+    for (int block=0; block<num_blocks_; ++block) {
+      squared_norm += squared_norm_[block].load(std::memory_order_relaxed);
+    }
+    return (squared_norm <= squared_tol);
+  };
+  #pragma omp parallel num_threads(num_blocks_)
+  {
+    const int thread_num = omp_get_thread_num();
+    const int num_threads = omp_get_num_threads();
+    Robot& robot = robots[thread_num];
+    if (deterministic_) {
+      for (int k=0; k<max_sweeps_; ++k) {
+        for (int block=thread_num; block<num_blocks_; block+=num_threads) {
+          readBoundary(block);
+        }
+        #pragma omp barrier
+        for (int block=thread_num; block<num_blocks_; block+=num_threads) {
+          squared_norm_[block].store(
+              sweep(robot, parnmpc, t, q, v, kkt_matrix, kkt_residual, s, d,
+                    block, (k%2 == 1)),
+              std::memory_order_relaxed);
+          ++num_sweeps_[block];
+        }
+        #pragma omp barrier
+        if (isConverged()) break;
+      }
+    }
+    else {
+      for (int k=0; k<max_sweeps_; ++k) {
+        for (int block=thread_num; block<num_blocks_; block+=num_threads) {
+          readBoundary(block);
+          squared_norm_[block].store(
+              sweep(robot, parnmpc, t, q, v, kkt_matrix, kkt_residual, s, d,
+                    block, (k%2 == 1)),
+              std::memory_order_relaxed);
+          ++num_sweeps_[block];
+        }
+        if (isConverged()) break;
+      }
+    }
+  }
+  return isConverged();
+}
+
+
+int UnconstrAsyncIteration::numSweeps() const {
+  int num_sweeps = 0;
+  for (const auto e : num_sweeps_) {
+    num_sweeps = std::max(num_sweeps, e);
+  }
+  return num_sweeps;
+}
+
+
+double UnconstrAsyncIteration::directionNorm() const {
+  double squared_norm = 0;
+  for (int block=0; block<num_blocks_; ++block) {
+    squared_norm += squared_norm_[block].load(std::memory_order_relaxed);
+  }
+  return std::sqrt(squared_norm);
+}
+
+
+void UnconstrAsyncIteration::allocateBuffers() {
+  BoundaryData data;
+  data.q = Eigen::VectorXd::Zero(dimq_);
+  data.v = Eigen::VectorXd::Zero(dimv_);
+  data.lmd = Eigen::VectorXd::Zero(dimv_);
+  data.gmm = Eigen::VectorXd::Zero(dimv_);
+  data.aux_mat = Eigen::MatrixXd::Zero(2*dimv_, 2*dimv_);
+  forward_buffer_.clear();
+  backward_buffer_.clear();
+  for (int i=0; i<N_; ++i) {
+    forward_buffer_.emplace_back(new Buffer(data));
+    backward_buffer_.emplace_back(new Buffer(data));
+  }
+  squared_norm_.reset(new std::atomic<double>[num_blocks_]);
+  for (int block=0; block<num_blocks_; ++block) {
+    squared_norm_[block].store(0, std::memory_order_relaxed);
+  }
+}
+
+
+int UnconstrAsyncIteration::stageBegin(const int block) const {
+  return (block * N_) / num_blocks_;
+}
+
+
+void UnconstrAsyncIteration::readBoundary(const int block) {
+  const int stage_begin = stageBegin(block);
+  const int stage_end = stageBegin(block+1);
+  if (stage_begin > 0 && forward_buffer_[stage_begin-1]->update()) {
+    const BoundaryData& data = forward_buffer_[stage_begin-1]->readBuffer();
+    s_prev_[block].q = data.q;
+    s_prev_[block].v = data.v;
+  }
+  if (stage_end < N_ && backward_buffer_[stage_end]->update()) {
+    const BoundaryData& data = backward_buffer_[stage_end]->readBuffer();
+    s_next_[block].lmd = data.lmd;
+    s_next_[block].gmm = data.gmm;
+    aux_mat_next_[block] = data.aux_mat;
+  }
+}
+
+
+double UnconstrAsyncIteration::sweep(Robot& robot, UnconstrParNMPC& parnmpc,
+                                     const double t, const Eigen::VectorXd& q,
+                                     const Eigen::VectorXd& v,
+                                     KKTMatrix& kkt_matrix,
+                                     KKTResidual& kkt_residual, Solution& s,
+                                     Direction& d, const int block,
+                                     const bool reverse) {
+  const int stage_begin = stageBegin(block);
+  const int stage_end = stageBegin(block+1);
+  double squared_norm = 0;
+  for (int k=0; k<stage_end-stage_begin; ++k) {
+    // Alternates the direction of the sweeps so that both the states and the
+    // costates propagate through the block.
+    const int i = reverse ? (stage_end-1-k) : (stage_begin+k);
+    const Eigen::VectorXd& q_prev
+        = (i == 0) ? q : ((i == stage_begin) ? s_prev_[block].q : s[i-1].q);
+    const Eigen::VectorXd& v_prev
+        = (i == 0) ? v : ((i == stage_begin) ? s_prev_[block].v : s[i-1].v);
+    const bool is_block_end = (i == stage_end-1);
+    const SplitSolution& s_next = is_block_end ? s_next_[block] : s[i+1];
+    const Eigen::MatrixXd& aux_mat_next
+        = is_block_end ? aux_mat_next_[block] : aux_mat_[i+1];
+    squared_norm += updateStage(robot, parnmpc, t, q_prev, v_prev, s_next,
+                                aux_mat_next, kkt_matrix, kkt_residual, s, d,
+                                i);
+    if (is_block_end && stage_end < N_) {
+      BoundaryData& data = forward_buffer_[i]->writeBuffer();
+      data.q = s[i].q;
+      data.v = s[i].v;
+      forward_buffer_[i]->publish();
+    }
+    if (i == stage_begin && stage_begin > 0) {
+      BoundaryData& data = backward_buffer_[i]->writeBuffer();
+      data.lmd = s[i].lmd;
+      data.gmm = s[i].gmm;
+      data.aux_mat = aux_mat_[i];
+      backward_buffer_[i]->publish();
+    }
+  }
+  return squared_norm;
+}
+
+
+double UnconstrAsyncIteration::updateStage(Robot& robot,
+                                           UnconstrParNMPC& parnmpc,
+                                           const double t,
+                                           const Eigen::VectorXd& q_prev,
+                                           const Eigen::VectorXd& v_prev,
+                                           const SplitSolution& s_next,
+                                           const Eigen::MatrixXd& aux_mat_next,
+                                           KKTMatrix& kkt_matrix,
+                                           KKTResidual& kkt_residual,
+                                           Solution& s, Direction& d,
+                                           const int i) {
+  if (i < N_-1) {
+    parnmpc[i].computeKKTSystem(robot, t+(i+1)*dt_, dt_, q_prev, v_prev,
+                                s[i], s_next, kkt_matrix[i], kkt_residual[i]);
+    corrector_[i].coarseUpdate(aux_mat_next, dt_, kkt_matrix[i],
+                               kkt_residual[i], s[i], s_new_[i]);
+  }
+  else {
+    parnmpc.terminal.computeKKTSystem(robot, t+T_, dt_, q_prev, v_prev, s[i],
+                                      kkt_matrix[i], kkt_residual[i]);
+    corrector_[i].coarseUpdate(dt_, kkt_matrix[i], kkt_residual[i], s[i],
+                               s_new_[i]);
+  }
+  aux_mat_[i] = - corrector_[i].auxMat();
+  UnconstrSplitBackwardCorrection::computeDirection(s[i], s_new_[i], d[i]);
+  if (i < N_-1) {
+    parnmpc[i].expandPrimalAndDual(dt_, s[i], kkt_matrix[i], kkt_residual[i],
+                                   d[i]);
+    const double primal_step_size = parnmpc[i].maxPrimalStepSize();
+    const double dual_step_size = parnmpc[i].maxDualStepSize();
+    parnmpc[i].updatePrimal(robot, primal_step_size, d[i], s[i]);
+    parnmpc[i].updateDual(dual_step_size);
+  }
+  else {
+    parnmpc.terminal.expandPrimalAndDual(dt_, s[i], kkt_matrix[i],
+                                         kkt_residual[i], d[i]);
+    const double primal_step_size = parnmpc.terminal.maxPrimalStepSize();
+    const double dual_step_size = parnmpc.terminal.maxDualStepSize();
+    parnmpc.terminal.updatePrimal(robot, primal_step_size, d[i], s[i]);
+    parnmpc.terminal.updateDual(dual_step_size);
+  }
+  return (d[i].dlmdgmm.squaredNorm() + d[i].da().squaredNorm()
+          + d[i].dq().squaredNorm() + d[i].dv().squaredNorm());
+}
+
+} // namespace idocp
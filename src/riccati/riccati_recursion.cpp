@@ -3,6 +3,9 @@
 #include <omp.h>
 #include <stdexcept>
 #include <cassert>
+#include <string>
+
+#include "idocp/utils/binary_io.hpp"
 
 namespace idocp {
 
@@ -15,7 +18,11 @@ RiccatiRecursion::RiccatiRecursion(const Robot& robot, const int N,
     factorizer_(robot),
     lqr_policy_(robot, N, max_num_impulse),
     max_primal_step_sizes_(Eigen::VectorXd::Zero(N+1+3*max_num_impulse)), 
-    max_dual_step_sizes_(Eigen::VectorXd::Zero(N+1+3*max_num_impulse)) {
+    max_dual_step_sizes_(Eigen::VectorXd::Zero(N+1+3*max_num_impulse)),
+    level_(IterationLevel::Full),
+    has_factorization_(false),
+    stage_structure_(),
+    switching_dims_() {
   try {
     if (N <= 0) {
       throw std::out_of_range("invalid value: N must be positive!");
@@ -40,7 +47,11 @@ RiccatiRecursion::RiccatiRecursion()
     N_all_(0),
     factorizer_(),
     max_primal_step_sizes_(), 
-    max_dual_step_sizes_() {
+    max_dual_step_sizes_(),
+    level_(IterationLevel::Full),
+    has_factorization_(false),
+    stage_structure_(),
+    switching_dims_() {
 }
 
 
@@ -48,11 +59,19 @@ RiccatiRecursion::~RiccatiRecursion() {
 }
 
 
-void RiccatiRecursion::backwardRiccatiRecursion(
+bool RiccatiRecursion::backwardRiccatiRecursion(
     const OCP& ocp, KKTMatrix& kkt_matrix, KKTResidual& kkt_residual, 
-    RiccatiFactorization& factorization) {
+    RiccatiFactorization& factorization, const IterationLevel level) {
   const int N = ocp.discrete().N();
-  factorization[N].P = kkt_matrix[N].Qxx;
+  level_ = isFactorizationReusable(ocp, kkt_residual) ? level 
+                                                      : IterationLevel::Full;
+  if (level_ != IterationLevel::Residual) {
+    factorizer_.resetRegularization();
+  }
+  factorizer_.resetFailure();
+  if (level_ == IterationLevel::Full) {
+    factorization[N].P = kkt_matrix[N].Qxx;
+  }
   factorization[N].s = - kkt_residual[N].lx;
   for (int i=N-1; i>=0; --i) {
     if (ocp.discrete().isTimeStageBeforeImpulse(i)) {
@@ -62,14 +81,17 @@ void RiccatiRecursion::backwardRiccatiRecursion(
                                            kkt_matrix.aux[impulse_index], 
                                            kkt_residual.aux[impulse_index], 
                                            factorization.aux[impulse_index], 
-                                           lqr_policy_.aux[impulse_index]);
+                                           lqr_policy_.aux[impulse_index], 
+                                           level_);
       factorizer_.backwardRiccatiRecursion(factorization.aux[impulse_index], 
                                            kkt_matrix.impulse[impulse_index], 
                                            kkt_residual.impulse[impulse_index], 
-                                           factorization.impulse[impulse_index]);
+                                           factorization.impulse[impulse_index], 
+                                           level_);
       factorizer_.backwardRiccatiRecursion(factorization.impulse[impulse_index], 
                                            kkt_matrix[i], kkt_residual[i], 
-                                           factorization[i], lqr_policy_[i]);
+                                           factorization[i], lqr_policy_[i], 
+                                           level_);
       if (i-1 >= 0) {
         factorizer_.backwardRiccatiRecursion(factorization[i], kkt_matrix[i-1], 
                                              kkt_residual[i-1],
@@ -77,7 +99,8 @@ void RiccatiRecursion::backwardRiccatiRecursion(
                                              kkt_residual.switching[impulse_index], 
                                              factorization[i-1], 
                                              factorization.switching[impulse_index], 
-                                             lqr_policy_[i-1]);
+                                             lqr_policy_[i-1], 
+                                             level_);
       }
 
     }
@@ -88,17 +111,33 @@ void RiccatiRecursion::backwardRiccatiRecursion(
                                             kkt_matrix.lift[lift_index], 
                                             kkt_residual.lift[lift_index], 
                                             factorization.lift[lift_index], 
-                                            lqr_policy_.lift[lift_index]);
+                                            lqr_policy_.lift[lift_index], 
+                                            level_);
       factorizer_.backwardRiccatiRecursion(factorization.lift[lift_index], 
                                            kkt_matrix[i], kkt_residual[i], 
-                                           factorization[i], lqr_policy_[i]);
+                                           factorization[i], lqr_policy_[i], 
+                                           level_);
     }
     else if (!ocp.discrete().isTimeStageBeforeImpulse(i+1)) {
       factorizer_.backwardRiccatiRecursion(factorization[i+1], 
                                             kkt_matrix[i], kkt_residual[i], 
-                                            factorization[i], lqr_policy_[i]);
+                                            factorization[i], lqr_policy_[i], 
+                                            level_);
     }
   }
+  if (factorizer_.hasFailed()) {
+    has_factorization_ = false;
+    return false;
+  }
+  if (level_ == IterationLevel::Full) {
+    storeStructure(ocp, kkt_residual);
+  }
+  return true;
+}
+
+
+IterationLevel RiccatiRecursion::iterationLevel() const {
+  return level_;
 }
 
 
@@ -144,6 +183,21 @@ void RiccatiRecursion::forwardRiccatiRecursion(
 }
 
 
+bool RiccatiRecursion::solveWithFactorization(
+    const OCP& ocp, KKTMatrix& kkt_matrix, KKTResidual& kkt_residual, 
+    RiccatiFactorization& factorization, Direction& d) {
+  assert(isFactorizationReusable(ocp, kkt_residual));
+  const IterationLevel level = level_;
+  if (!backwardRiccatiRecursion(ocp, kkt_matrix, kkt_residual, factorization, 
+                                IterationLevel::Residual)) {
+    return false;
+  }
+  level_ = level;
+  forwardRiccatiRecursion(ocp, kkt_matrix, kkt_residual, d);
+  return true;
+}
+
+
 void RiccatiRecursion::computeDirection(
     OCP& ocp, const RiccatiFactorization& factorization, 
     const Solution& s, Direction& d) {
@@ -226,4 +280,203 @@ void RiccatiRecursion::getStateFeedbackGain(const int time_stage,
   Kv = lqr_policy_[time_stage].Kv();
 }
 
+
+void RiccatiRecursion::setRegularizationParameters(
+    const double min_regularization, const double max_regularization, 
+    const double regularization_factor) {
+  factorizer_.setRegularizationParameters(min_regularization, 
+                                          max_regularization,
+                                          regularization_factor);
+}
+
+
+double RiccatiRecursion::regularization() const {
+  return factorizer_.regularization();
+}
+
+
+void RiccatiRecursion::setMixedPrecision(const bool mixed_precision) {
+  factorizer_.setMixedPrecision(mixed_precision);
+}
+
+
+bool RiccatiRecursion::isFactorizationReusable(
+    const OCP& ocp, const KKTResidual& kkt_residual) const {
+  if (!has_factorization_) {
+    return false;
+  }
+  const int N = ocp.discrete().N();
+  if (N != static_cast<int>(stage_structure_.size())) {
+    return false;
+  }
+  for (int i=0; i<N; ++i) {
+    if (stage_structure_[i] != stageStructure(ocp, i)) {
+      return false;
+    }
+  }
+  for (int i=0; i<ocp.discrete().N_impulse(); ++i) {
+    if (switching_dims_[i] != kkt_residual.switching[i].dimi()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+void RiccatiRecursion::saveFactorization(
+    std::ostream& os, const RiccatiFactorization& factorization) const {
+  factorizer_.saveRegularization(os);
+  binaryio::write(os, static_cast<char>(has_factorization_));
+  if (!has_factorization_) {
+    return;
+  }
+  auto writeRiccati = [&os](const SplitRiccatiFactorization& riccati) {
+    binaryio::writeMatrix(os, riccati.P);
+    binaryio::writeVector(os, riccati.s);
+  };
+  // G is stored instead of its Cholesky factor, which cannot be set directly.
+  auto writeLQRPolicy = [&os](const LQRPolicy& lqr_policy) {
+    binaryio::writeMatrix(os, lqr_policy.K);
+    binaryio::writeVector(os, lqr_policy.k);
+    binaryio::writeMatrix(os, lqr_policy.G);
+  };
+  const int N = stage_structure_.size();
+  binaryio::write(os, N);
+  for (int i=0; i<N; ++i) {
+    binaryio::write(os, stage_structure_[i]);
+  }
+  for (int i=0; i<N; ++i) {
+    writeRiccati(factorization[i]);
+    writeLQRPolicy(lqr_policy_[i]);
+    const int structure = stage_structure_[i];
+    if (structure%2 == 1) {
+      const int impulse_index = (structure-1) / 2;
+      binaryio::write(os, switching_dims_[impulse_index]);
+      writeRiccati(factorization.aux[impulse_index]);
+      writeRiccati(factorization.impulse[impulse_index]);
+      writeLQRPolicy(lqr_policy_.aux[impulse_index]);
+      if (i-1 >= 0) {
+        const SplitConstrainedRiccatiFactorization& c_riccati 
+            = factorization.switching[impulse_index];
+        binaryio::writeMatrix(os, c_riccati.Ginv);
+        binaryio::writeMatrix(os, c_riccati.DGinv());
+        binaryio::writeMatrix(os, c_riccati.S());
+        binaryio::writeMatrix(os, c_riccati.SinvDGinv());
+        binaryio::writeMatrix(os, c_riccati.M());
+        binaryio::writeVector(os, c_riccati.m());
+      }
+    }
+    else if (structure > 0) {
+      const int lift_index = (structure-2) / 2;
+      writeRiccati(factorization.lift[lift_index]);
+      writeLQRPolicy(lqr_policy_.lift[lift_index]);
+    }
+  }
+  writeRiccati(factorization[N]);
+}
+
+
+void RiccatiRecursion::loadFactorization(std::istream& is, 
+                                         RiccatiFactorization& factorization) {
+  has_factorization_ = false;
+  factorizer_.loadRegularization(is);
+  char has_factorization;
+  binaryio::read(is, has_factorization);
+  if (has_factorization == 0) {
+    return;
+  }
+  auto readRiccati = [&is](SplitRiccatiFactorization& riccati) {
+    binaryio::readMatrix(is, riccati.P);
+    binaryio::readVector(is, riccati.s);
+  };
+  auto readLQRPolicy = [&is](LQRPolicy& lqr_policy) {
+    binaryio::readMatrix(is, lqr_policy.K);
+    binaryio::readVector(is, lqr_policy.k);
+    binaryio::readMatrix(is, lqr_policy.G);
+    lqr_policy.G_llt.compute(lqr_policy.G);
+  };
+  int N;
+  binaryio::read(is, N);
+  if (N <= 0 || N > N_) {
+    throw std::runtime_error("invalid number of the time stages " 
+                             + std::to_string(N) + " is stored!");
+  }
+  stage_structure_.resize(N);
+  for (int i=0; i<N; ++i) {
+    binaryio::read(is, stage_structure_[i]);
+  }
+  const int max_num_impulse = lqr_policy_.aux.size();
+  for (int i=0; i<N; ++i) {
+    readRiccati(factorization[i]);
+    readLQRPolicy(lqr_policy_[i]);
+    const int structure = stage_structure_[i];
+    if (structure < 0 || structure > 2*max_num_impulse) {
+      throw std::runtime_error("invalid structure of the time stage " 
+                               + std::to_string(i) + " is stored!");
+    }
+    if (structure%2 == 1) {
+      const int impulse_index = (structure-1) / 2;
+      if (static_cast<int>(switching_dims_.size()) <= impulse_index) {
+        switching_dims_.resize(impulse_index+1);
+      }
+      binaryio::read(is, switching_dims_[impulse_index]);
+      readRiccati(factorization.aux[impulse_index]);
+      readRiccati(factorization.impulse[impulse_index]);
+      readLQRPolicy(lqr_policy_.aux[impulse_index]);
+      if (i-1 >= 0) {
+        SplitConstrainedRiccatiFactorization& c_riccati 
+            = factorization.switching[impulse_index];
+        c_riccati.setImpulseStatus(switching_dims_[impulse_index]);
+        binaryio::readMatrix(is, c_riccati.Ginv);
+        binaryio::readMatrix(is, c_riccati.DGinv());
+        binaryio::readMatrix(is, c_riccati.S());
+        binaryio::readMatrix(is, c_riccati.SinvDGinv());
+        binaryio::readMatrix(is, c_riccati.M());
+        binaryio::readVector(is, c_riccati.m());
+        c_riccati.S_llt.compute(c_riccati.S());
+      }
+    }
+    else if (structure > 0) {
+      const int lift_index = (structure-2) / 2;
+      readRiccati(factorization.lift[lift_index]);
+      readLQRPolicy(lqr_policy_.lift[lift_index]);
+    }
+  }
+  readRiccati(factorization[N]);
+  has_factorization_ = true;
+}
+
+
+void RiccatiRecursion::storeStructure(const OCP& ocp, 
+                                      const KKTResidual& kkt_residual) {
+  const int N = ocp.discrete().N();
+  stage_structure_.resize(N);
+  for (int i=0; i<N; ++i) {
+    stage_structure_[i] = stageStructure(ocp, i);
+  }
+  const int N_impulse = ocp.discrete().N_impulse();
+  if (static_cast<int>(switching_dims_.size()) < N_impulse) {
+    switching_dims_.resize(N_impulse);
+  }
+  for (int i=0; i<N_impulse; ++i) {
+    switching_dims_[i] = kkt_residual.switching[i].dimi();
+  }
+  has_factorization_ = true;
+}
+
+
+int RiccatiRecursion::stageStructure(const OCP& ocp, const int time_stage) {
+  // 0 for a stage without events, 2*index+1 for a stage before the impulse, 
+  // and 2*index+2 for a stage before the lift.
+  if (ocp.discrete().isTimeStageBeforeImpulse(time_stage)) {
+    return 2*ocp.discrete().impulseIndexAfterTimeStage(time_stage) + 1;
+  }
+  else if (ocp.discrete().isTimeStageBeforeLift(time_stage)) {
+    return 2*ocp.discrete().liftIndexAfterTimeStage(time_stage) + 2;
+  }
+  else {
+    return 0;
+  }
+}
+
 } // namespace idocp
\ No newline at end of file
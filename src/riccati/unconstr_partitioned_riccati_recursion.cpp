@@ -0,0 +1,170 @@
+#include "idocp/riccati/unconstr_partitioned_riccati_recursion.hpp"
+
+#include <stdexcept>
+#include <cassert>
+
+namespace idocp {
+
+UnconstrPartitionedRiccatiRecursion::UnconstrPartitionedRiccatiRecursion(
+    const Robot& robot, const double T, const int N, const int stage_begin,
+    const int stage_end)
+  : N_(N),
+    stage_begin_(stage_begin),
+    stage_end_(stage_end),
+    num_stages_(stage_end-stage_begin),
+    dimv_(robot.dimv()),
+    T_(T),
+    dt_(T/N),
+    factorizer_(robot),
+    lqr_policy_(stage_end-stage_begin, LQRPolicy(robot)),
+    llt_(robot.dimv()),
+    Psi_(stage_end-stage_begin+1,
+         Eigen::MatrixXd::Zero(2*robot.dimv(), 2*robot.dimv())),
+    kappa_(stage_end-stage_begin,
+           Eigen::MatrixXd::Zero(robot.dimv(), 2*robot.dimv())),
+    K_Phi_(Eigen::MatrixXd::Zero(robot.dimv(), 2*robot.dimv())),
+    K_Gamma_(Eigen::MatrixXd::Zero(robot.dimv(), 2*robot.dimv())),
+    a_(Eigen::VectorXd::Zero(robot.dimv())) {
+  try {
+    if (T <= 0) {
+      throw std::out_of_range("invalid value: T must be positive!");
+    }
+    if (N <= 0) {
+      throw std::out_of_range("invalid value: N must be positive!");
+    }
+    if (stage_begin < 0) {
+      throw std::out_of_range("invalid value: stage_begin must be non-negative!");
+    }
+    if (stage_end <= stage_begin) {
+      throw std::out_of_range(
+          "invalid value: stage_end must be larger than stage_begin!");
+    }
+    if (stage_end > N) {
+      throw std::out_of_range("invalid value: stage_end must not exceed N!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+
+UnconstrPartitionedRiccatiRecursion::UnconstrPartitionedRiccatiRecursion()
+  : N_(0),
+    stage_begin_(0),
+    stage_end_(0),
+    num_stages_(0),
+    dimv_(0),
+    T_(0),
+    dt_(0),
+    factorizer_(),
+    lqr_policy_(),
+    llt_(),
+    Psi_(),
+    kappa_(),
+    K_Phi_(),
+    K_Gamma_(),
+    a_() {
+}
+
+
+UnconstrPartitionedRiccatiRecursion::~UnconstrPartitionedRiccatiRecursion() {
+}
+
+
+void UnconstrPartitionedRiccatiRecursion::backwardRiccatiRecursion(
+    KKTMatrix& kkt_matrix, KKTResidual& kkt_residual,
+    UnconstrRiccatiFactorization& factorization,
+    UnconstrSegmentCoupling& coupling) {
+  assert(factorization.size() > num_stages_);
+  const int L = num_stages_;
+  if (hasTerminalStage()) {
+    factorization[L].P = kkt_matrix[L].Qxx;
+    factorization[L].s = - kkt_residual[L].lx;
+  }
+  else {
+    factorization[L].P.setZero();
+    factorization[L].s.setZero();
+    Psi_[L].setIdentity();
+  }
+  for (int i=L-1; i>=0; --i) {
+    factorizer_.backwardRiccatiRecursion(factorization[i+1], dt_, kkt_matrix[i],
+                                         kkt_residual[i], factorization[i],
+                                         lqr_policy_[i]);
+    if (!hasTerminalStage()) {
+      // kkt_matrix[i].Qaa is the factorized one, i.e., Qaa + dt^2 Pvv.
+      llt_.compute(kkt_matrix[i].Qaa);
+      kappa_[i].noalias() = dt_ * llt_.solve(Psi_[i+1].bottomRows(dimv_));
+      // Psi_i = (A + B K_i)^T Psi_{i+1}
+      Psi_[i] = Psi_[i+1];
+      Psi_[i].bottomRows(dimv_).noalias() += dt_ * Psi_[i+1].topRows(dimv_);
+      Psi_[i].noalias() += dt_ * lqr_policy_[i].K.transpose()
+                                * Psi_[i+1].bottomRows(dimv_);
+    }
+  }
+  coupling.P = factorization[0].P;
+  coupling.s = factorization[0].s;
+  if (hasTerminalStage()) {
+    coupling.Psi.setZero();
+    return;
+  }
+  coupling.Psi = Psi_[0];
+  // Closed-loop rollout over the segment with x_a = 0 and sigma = 0.
+  coupling.Phi.setIdentity();
+  coupling.Gamma.setZero();
+  coupling.c.setZero();
+  for (int i=0; i<L; ++i) {
+    const auto& K = lqr_policy_[i].K;
+    a_.noalias() = K * coupling.c + lqr_policy_[i].k;
+    coupling.c.head(dimv_).noalias() += dt_ * coupling.c.tail(dimv_);
+    coupling.c.noalias() += kkt_residual[i].Fx;
+    coupling.c.tail(dimv_).noalias() += dt_ * a_;
+    K_Phi_.noalias() = K * coupling.Phi;
+    coupling.Phi.topRows(dimv_).noalias()
+        += dt_ * coupling.Phi.bottomRows(dimv_);
+    coupling.Phi.bottomRows(dimv_).noalias() += dt_ * K_Phi_;
+    K_Gamma_.noalias() = K * coupling.Gamma;
+    K_Gamma_.noalias() += kappa_[i];
+    coupling.Gamma.topRows(dimv_).noalias()
+        += dt_ * coupling.Gamma.bottomRows(dimv_);
+    coupling.Gamma.bottomRows(dimv_).noalias() += dt_ * K_Gamma_;
+  }
+}
+
+
+void UnconstrPartitionedRiccatiRecursion::forwardRiccatiRecursion(
+    const KKTResidual& kkt_residual, const Eigen::VectorXd& sigma,
+    UnconstrRiccatiFactorization& factorization, Direction& d) {
+  assert(sigma.size() == 2*dimv_);
+  for (int i=0; i<num_stages_; ++i) {
+    if (!hasTerminalStage()) {
+      factorization[i].s.noalias() += Psi_[i] * sigma;
+      lqr_policy_[i].k.noalias() += kappa_[i] * sigma;
+    }
+    factorizer_.forwardRiccatiRecursion(kkt_residual[i], dt_, lqr_policy_[i],
+                                        d[i], d[i+1]);
+  }
+}
+
+
+int UnconstrPartitionedRiccatiRecursion::stageBegin() const {
+  return stage_begin_;
+}
+
+
+int UnconstrPartitionedRiccatiRecursion::stageEnd() const {
+  return stage_end_;
+}
+
+
+int UnconstrPartitionedRiccatiRecursion::numStages() const {
+  return num_stages_;
+}
+
+
+bool UnconstrPartitionedRiccatiRecursion::hasTerminalStage() const {
+  return (stage_end_ == N_);
+}
+
+} // namespace idocp
@@ -0,0 +1,106 @@
+#include "idocp/riccati/unconstr_reduced_boundary_system.hpp"
+
+#include <stdexcept>
+#include <cassert>
+
+namespace idocp {
+
+UnconstrReducedBoundarySystem::UnconstrReducedBoundarySystem(
+    const Robot& robot, const int num_segments)
+  : num_segments_(num_segments),
+    dimx_(2*robot.dimv()),
+    P_(num_segments, Eigen::MatrixXd::Zero(2*robot.dimv(), 2*robot.dimv())),
+    s_(num_segments, Eigen::VectorXd::Zero(2*robot.dimv())),
+    dx_(num_segments, Eigen::VectorXd::Zero(2*robot.dimv())),
+    sigma_(num_segments, Eigen::VectorXd::Zero(2*robot.dimv())),
+    lu_(num_segments, Eigen::PartialPivLU<Eigen::MatrixXd>(2*robot.dimv())),
+    M_(Eigen::MatrixXd::Zero(2*robot.dimv(), 2*robot.dimv())),
+    b_(Eigen::VectorXd::Zero(2*robot.dimv())) {
+  try {
+    if (num_segments <= 0) {
+      throw std::out_of_range("invalid value: num_segments must be positive!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+
+UnconstrReducedBoundarySystem::UnconstrReducedBoundarySystem()
+  : num_segments_(0),
+    dimx_(0),
+    P_(),
+    s_(),
+    dx_(),
+    sigma_(),
+    lu_(),
+    M_(),
+    b_() {
+}
+
+
+UnconstrReducedBoundarySystem::~UnconstrReducedBoundarySystem() {
+}
+
+
+void UnconstrReducedBoundarySystem::solve(
+    const std::vector<UnconstrSegmentCoupling>& coupling,
+    const Eigen::VectorXd& dx0) {
+  assert(coupling.size() == num_segments_);
+  assert(dx0.size() == dimx_);
+  const int J = num_segments_;
+  P_[J-1] = coupling[J-1].P;
+  s_[J-1] = coupling[J-1].s;
+  // Backward sweep: eliminates the state at the end of each segment by
+  // x_b = (I + Gamma P_b)^{-1} (Phi x_a + Gamma s_b + c).
+  for (int j=J-1; j>=1; --j) {
+    const UnconstrSegmentCoupling& cp = coupling[j-1];
+    M_.setIdentity();
+    M_.noalias() += cp.Gamma * P_[j];
+    lu_[j-1].compute(M_);
+    P_[j-1] = cp.P;
+    P_[j-1].noalias() += cp.Psi * P_[j] * lu_[j-1].solve(cp.Phi);
+    b_ = cp.c;
+    b_.noalias() += cp.Gamma * s_[j];
+    s_[j-1] = cp.s;
+    s_[j-1].noalias() += cp.Psi * s_[j];
+    s_[j-1].noalias() -= cp.Psi * P_[j] * lu_[j-1].solve(b_);
+  }
+  // Forward sweep
+  dx_[0] = dx0;
+  for (int j=1; j<J; ++j) {
+    const UnconstrSegmentCoupling& cp = coupling[j-1];
+    b_ = cp.c;
+    b_.noalias() += cp.Phi * dx_[j-1];
+    b_.noalias() += cp.Gamma * s_[j];
+    dx_[j] = lu_[j-1].solve(b_);
+    sigma_[j-1] = s_[j];
+    sigma_[j-1].noalias() -= P_[j] * dx_[j];
+  }
+  sigma_[J-1].setZero();
+}
+
+
+const Eigen::VectorXd& UnconstrReducedBoundarySystem::dxBegin(
+    const int segment) const {
+  assert(segment >= 0);
+  assert(segment < num_segments_);
+  return dx_[segment];
+}
+
+
+const Eigen::VectorXd& UnconstrReducedBoundarySystem::sigma(
+    const int segment) const {
+  assert(segment >= 0);
+  assert(segment < num_segments_);
+  return sigma_[segment];
+}
+
+
+int UnconstrReducedBoundarySystem::numSegments() const {
+  return num_segments_;
+}
+
+} // namespace idocp
@@ -0,0 +1,174 @@
+#include "idocp/sim/compliant_contact_simulator.hpp"
+
+#include <iostream>
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+
+
+namespace idocp {
+
+CompliantContactSimulator::CompliantContactSimulator(const Robot& robot,
+                                                     const double time_step)
+  : robot_(robot),
+    contact_status_(robot.createContactStatus()),
+    contact_frames_(robot.contactFrames()),
+    f_world_(robot.maxPointContacts(), Eigen::Vector3d::Zero()),
+    f_local_(robot.maxPointContacts(), Eigen::Vector3d::Zero()),
+    J_(Eigen::MatrixXd::Zero(6, robot.dimv())),
+    tau_(Eigen::VectorXd::Zero(robot.dimv())),
+    a_(Eigen::VectorXd::Zero(robot.dimv())),
+    v_frame_(Eigen::Vector3d::Zero()),
+    time_step_(time_step),
+    stiffness_(5.0e04),
+    damping_(1.0e03),
+    tangential_damping_(1.0e03),
+    mu_(0.7) {
+  try {
+    if (time_step <= 0) {
+      throw std::out_of_range("invalid value: time_step must be positive!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+
+CompliantContactSimulator::CompliantContactSimulator()
+  : robot_(),
+    contact_status_(),
+    contact_frames_(),
+    f_world_(),
+    f_local_(),
+    J_(),
+    tau_(),
+    a_(),
+    v_frame_(Eigen::Vector3d::Zero()),
+    time_step_(0),
+    stiffness_(0),
+    damping_(0),
+    tangential_damping_(0),
+    mu_(0) {
+}
+
+
+CompliantContactSimulator::~CompliantContactSimulator() {
+}
+
+
+void CompliantContactSimulator::setGroundModel(const double stiffness,
+                                               const double damping,
+                                               const double tangential_damping,
+                                               const double mu) {
+  try {
+    if (stiffness <= 0) {
+      throw std::out_of_range("invalid value: stiffness must be positive!");
+    }
+    if (damping < 0) {
+      throw std::out_of_range("invalid value: damping must be non-negative!");
+    }
+    if (tangential_damping < 0) {
+      throw std::out_of_range(
+          "invalid value: tangential_damping must be non-negative!");
+    }
+    if (mu <= 0) {
+      throw std::out_of_range("invalid value: mu must be positive!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  stiffness_ = stiffness;
+  damping_ = damping;
+  tangential_damping_ = tangential_damping;
+  mu_ = mu;
+}
+
+
+void CompliantContactSimulator::integrate(const double duration,
+                                          const Eigen::VectorXd& u,
+                                          Eigen::VectorXd& q,
+                                          Eigen::VectorXd& v) {
+  assert(duration >= 0);
+  double t = 0;
+  // Avoids a tiny last step due to the round-off error.
+  const double eps = 1.0e-08 * time_step_;
+  while (t < duration-eps) {
+    const double dt = std::min(time_step_, duration-t);
+    step(dt, u, q, v);
+    t += dt;
+  }
+}
+
+
+void CompliantContactSimulator::step(const double time_step,
+                                     const Eigen::VectorXd& u,
+                                     Eigen::VectorXd& q, Eigen::VectorXd& v) {
+  assert(time_step > 0);
+  assert(u.size() == robot_.dimu());
+  assert(q.size() == robot_.dimq());
+  assert(v.size() == robot_.dimv());
+  computeContactForces(q, v);
+  tau_.head(robot_.dim_passive()).setZero();
+  tau_.tail(robot_.dimu()) = u;
+  robot_.forwardDynamics(q, v, tau_, a_);
+  v.noalias() += time_step * a_;
+  robot_.integrateConfiguration(v, time_step, q);
+  robot_.normalizeConfiguration(q);
+}
+
+
+const std::vector<Eigen::Vector3d>&
+CompliantContactSimulator::contactForces() const {
+  return f_world_;
+}
+
+
+const ContactStatus& CompliantContactSimulator::contactStatus() const {
+  return contact_status_;
+}
+
+
+double CompliantContactSimulator::timeStep() const {
+  return time_step_;
+}
+
+
+void CompliantContactSimulator::computeContactForces(const Eigen::VectorXd& q,
+                                                     const Eigen::VectorXd& v) {
+  if (contact_frames_.empty()) return;
+  robot_.updateKinematics(q);
+  for (int i=0; i<contact_frames_.size(); ++i) {
+    const double z = robot_.framePosition(contact_frames_[i]).coeff(2);
+    if (z >= 0) {
+      contact_status_.deactivateContact(i);
+      f_world_[i].setZero();
+      f_local_[i].setZero();
+      continue;
+    }
+    contact_status_.activateContact(i);
+    const Eigen::Matrix3d& R = robot_.frameRotation(contact_frames_[i]);
+    J_.setZero();
+    robot_.getFrameJacobian(contact_frames_[i], J_);
+    v_frame_.noalias() = R * (J_.topRows(3) * v);
+    // Spring-damper in the normal direction, which never pulls the robot.
+    const double fz = std::max(0.0, - stiffness_*z - damping_*v_frame_.coeff(2));
+    // Viscous friction saturated at the friction cone.
+    Eigen::Vector3d& f = f_world_[i];
+    f.coeffRef(0) = - tangential_damping_ * v_frame_.coeff(0);
+    f.coeffRef(1) = - tangential_damping_ * v_frame_.coeff(1);
+    f.coeffRef(2) = fz;
+    const double ft = f.head<2>().norm();
+    if (ft > mu_*fz) {
+      f.head<2>() *= (mu_*fz/ft);
+    }
+    f_local_[i].noalias() = R.transpose() * f;
+  }
+  robot_.setContactForces(contact_status_, f_local_);
+}
+
+} // namespace idocp
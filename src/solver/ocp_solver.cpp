@@ -2,10 +2,28 @@
 
 #include <stdexcept>
 #include <cassert>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <omp.h>
+
+#include "idocp/solver/ocp_solver_trace.hpp"
+#include "idocp/utils/binary_io.hpp"
 
 
 namespace idocp {
 
+namespace {
+constexpr char kSnapshotMagic[8] = {'I', 'D', 'O', 'C', 'P', 'S', 'N', 'P'};
+constexpr int kSnapshotVersion = 3;
+
+void writeTraceEvent(std::ostream& os, const OCPSolverTraceEvent event) {
+  binaryio::write(os, static_cast<char>(event));
+}
+} // namespace
+
+
 OCPSolver::OCPSolver(const Robot& robot, 
                      const std::shared_ptr<CostFunction>& cost, 
                      const std::shared_ptr<Constraints>& constraints, 
@@ -21,7 +39,12 @@ OCPSolver::OCPSolver(const Robot& robot,
     kkt_matrix_(robot, N, max_num_impulse),
     kkt_residual_(robot, N, max_num_impulse),
     s_(robot, N, max_num_impulse),
-    d_(robot, N, max_num_impulse) {
+    d_(robot, N, max_num_impulse),
+    sto_(max_num_impulse),
+    full_update_interval_(1),
+    jacobian_update_interval_(1),
+    iteration_count_(0),
+    is_kkt_system_reusable_(false) {
   try {
     if (T <= 0) {
       throw std::out_of_range("invalid value: T must be positive!");
@@ -47,7 +70,12 @@ OCPSolver::OCPSolver(const Robot& robot,
 }
 
 
-OCPSolver::OCPSolver() {
+OCPSolver::OCPSolver()
+  : sto_(),
+    full_update_interval_(1),
+    jacobian_update_interval_(1),
+    iteration_count_(0),
+    is_kkt_system_reusable_(false) {
 }
 
 
@@ -55,36 +83,114 @@ OCPSolver::~OCPSolver() {
 }
 
 
+void OCPSolver::setDiscretizationGrid(const std::vector<double>& dt) {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::SetDiscretizationGrid);
+    binaryio::writeVector(*trace_, 
+                          Eigen::Map<const Eigen::VectorXd>(dt.data(), dt.size()));
+  }
+  ocp_.setDiscretizationGrid(dt);
+}
+
+
+void OCPSolver::setGeometricDiscretizationGrid(const double ratio) {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::SetGeometricDiscretizationGrid);
+    binaryio::write(*trace_, ratio);
+  }
+  ocp_.setGeometricDiscretizationGrid(ratio);
+}
+
+
+void OCPSolver::setSTOParameters(const double hessian, 
+                                 const double max_step_size) {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::SetSTOParameters);
+    binaryio::write(*trace_, hessian);
+    binaryio::write(*trace_, max_step_size);
+  }
+  sto_.setParameters(hessian, max_step_size);
+}
+
+
 void OCPSolver::initConstraints(const double t) {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::InitConstraints);
+    binaryio::write(*trace_, t);
+  }
   ocp_.discretize(contact_sequence_, t);
   discretizeSolution();
   dms_.initConstraints(ocp_, robots_, contact_sequence_, s_);
 }
 
 
-void OCPSolver::updateSolution(const double t, const Eigen::VectorXd& q, 
+bool OCPSolver::updateSolution(const double t, const Eigen::VectorXd& q, 
                                const Eigen::VectorXd& v, 
                                const bool line_search) {
   assert(q.size() == robots_[0].dimq());
   assert(v.size() == robots_[0].dimv());
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::UpdateSolution);
+    binaryio::write(*trace_, t);
+    binaryio::writeVector(*trace_, q);
+    binaryio::writeVector(*trace_, v);
+    binaryio::write(*trace_, static_cast<char>(line_search));
+  }
+  beginPhase(OCPSolverPhase::Discretization);
   ocp_.discretize(contact_sequence_, t);
   discretizeSolution();
+  endPhase(OCPSolverPhase::Discretization);
+  // The Hessians and the Jacobians of the last iteration are reused only if 
+  // the contact sequence and the structure of the stages have not changed.
+  IterationLevel level = nextIterationLevel();
+  if (!is_kkt_system_reusable_ 
+      || !riccati_recursion_.isFactorizationReusable(ocp_, kkt_residual_)) {
+    level = IterationLevel::Full;
+  }
+  beginPhase(OCPSolverPhase::KKTSystem);
   dms_.computeKKTSystem(ocp_, robots_, contact_sequence_, q, v, s_, 
-                        kkt_matrix_, kkt_residual_);
-  riccati_recursion_.backwardRiccatiRecursion(ocp_, kkt_matrix_, kkt_residual_, 
-                                              riccati_factorization_);
+                        kkt_matrix_, kkt_residual_, level);
+  is_kkt_system_reusable_ = true;
+  endPhase(OCPSolverPhase::KKTSystem);
+  beginPhase(OCPSolverPhase::SwitchingTimeOptimization);
+  sto_.computeKKTResidual(ocp_, kkt_matrix_, s_);
+  sto_.computeDirection(ocp_);
+  endPhase(OCPSolverPhase::SwitchingTimeOptimization);
+  beginPhase(OCPSolverPhase::BackwardRiccatiRecursion);
+  const bool is_factorized 
+      = riccati_recursion_.backwardRiccatiRecursion(ocp_, kkt_matrix_, 
+                                                    kkt_residual_, 
+                                                    riccati_factorization_, 
+                                                    level);
+  endPhase(OCPSolverPhase::BackwardRiccatiRecursion);
+  if (!is_factorized) {
+    return false;
+  }
+  beginPhase(OCPSolverPhase::ForwardRiccatiRecursion);
   dms_.computeInitialStateDirection(ocp_, robots_, q, v, s_, d_);
   riccati_recursion_.forwardRiccatiRecursion(ocp_, kkt_matrix_, kkt_residual_, d_);
+  endPhase(OCPSolverPhase::ForwardRiccatiRecursion);
+  beginPhase(OCPSolverPhase::Direction);
   riccati_recursion_.computeDirection(ocp_, riccati_factorization_, s_, d_);
   double primal_step_size = riccati_recursion_.maxPrimalStepSize();
   const double dual_step_size = riccati_recursion_.maxDualStepSize();
+  endPhase(OCPSolverPhase::Direction);
   if (line_search) {
+    beginPhase(OCPSolverPhase::LineSearch);
     const double max_primal_step_size = primal_step_size;
     primal_step_size = line_search_.computeStepSize(ocp_, robots_, 
                                                     contact_sequence_, q, v, 
-                                                    s_, d_, max_primal_step_size);
+                                                    s_, d_, max_primal_step_size,
+                                                    riccati_recursion_, 
+                                                    kkt_matrix_, 
+                                                    riccati_factorization_);
+    endPhase(OCPSolverPhase::LineSearch);
   }
+  beginPhase(OCPSolverPhase::Integration);
   dms_.integrateSolution(ocp_, robots_, primal_step_size, dual_step_size, d_, s_);
+  sto_.integrateSwitchingTimes(ocp_, primal_step_size, contact_sequence_);
+  endPhase(OCPSolverPhase::Integration);
+  return true;
 } 
 
 
@@ -98,6 +204,13 @@ const SplitSolution& OCPSolver::getSolution(const int stage) const {
 std::vector<Eigen::VectorXd> OCPSolver::getSolution(
     const std::string& name, const std::string& option) const {
   std::vector<Eigen::VectorXd> sol;
+  if (name == "t") {
+    Eigen::VectorXd t(1);
+    for (int i=0; i<=ocp_.discrete().N(); ++i) {
+      t.coeffRef(0) = ocp_.discrete().t(i);
+      sol.push_back(t);
+    }
+  }
   if (name == "q") {
     for (int i=0; i<=ocp_.discrete().N(); ++i) {
       sol.push_back(s_[i].q);
@@ -168,16 +281,38 @@ void OCPSolver::getStateFeedbackGain(const int time_stage, Eigen::MatrixXd& Kq,
                                      Eigen::MatrixXd& Kv) const {
   assert(time_stage >= 0);
   assert(time_stage < ocp_.discrete().N());
-  assert(Kq.rows() == robots_[0].dimv());
+  assert(Kq.rows() == robots_[0].dimu());
   assert(Kq.cols() == robots_[0].dimv());
-  assert(Kv.rows() == robots_[0].dimv());
+  assert(Kv.rows() == robots_[0].dimu());
   assert(Kv.cols() == robots_[0].dimv());
   riccati_recursion_.getStateFeedbackGain(time_stage, Kq, Kv);
 }
 
 
+void OCPSolver::getControlPolicy(ControlPolicy& policy) const {
+  assert(policy.numStages() <= ocp_.discrete().N());
+  assert(policy.u.size() == robots_[0].dimu());
+  policy.t = ocp_.discrete().t(0);
+  policy.u = s_[0].u;
+  riccati_recursion_.getStateFeedbackGain(0, policy.Kq, policy.Kv);
+  for (int i=0; i<policy.numStages(); ++i) {
+    policy.t_traj.coeffRef(i) = ocp_.discrete().t(i);
+    policy.q_traj[i] = s_[i].q;
+    policy.v_traj[i] = s_[i].v;
+    policy.u_traj[i] = s_[i].u;
+    riccati_recursion_.getStateFeedbackGain(i, policy.Kq_traj[i], 
+                                            policy.Kv_traj[i]);
+  }
+}
+
+
 void OCPSolver::setSolution(const std::string& name, 
                             const Eigen::VectorXd& value) {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::SetSolution);
+    binaryio::writeString(*trace_, name);
+    binaryio::writeVector(*trace_, value);
+  }
   try {
     if (name == "q") {
       for (auto& e : s_.data)    { e.q = value; }
@@ -234,25 +369,46 @@ void OCPSolver::setSolution(const std::string& name,
 
 
 void OCPSolver::setContactStatusUniformly(const ContactStatus& contact_status) {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::SetContactStatusUniformly);
+    binaryio::writeContactStatus(*trace_, contact_status);
+  }
   contact_sequence_.setContactStatusUniformly(contact_status);
+  is_kkt_system_reusable_ = false;
 }
 
 
 void OCPSolver::pushBackContactStatus(const ContactStatus& contact_status, 
                                       const double switching_time) {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::PushBackContactStatus);
+    binaryio::writeContactStatus(*trace_, contact_status);
+    binaryio::write(*trace_, switching_time);
+  }
   contact_sequence_.push_back(contact_status, switching_time, false);
+  is_kkt_system_reusable_ = false;
 }
 
 
 void OCPSolver::setContactPoints(
     const int contact_phase, 
     const std::vector<Eigen::Vector3d>& contact_points) {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::SetContactPoints);
+    binaryio::write(*trace_, contact_phase);
+    binaryio::writeVector3dArray(*trace_, contact_points);
+  }
   contact_sequence_.setContactPoints(contact_phase, contact_points);
 }
 
 
 void OCPSolver::popBackContactStatus(const double t,
                                      const bool extrapolate_solution) {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::PopBackContactStatus);
+    binaryio::write(*trace_, t);
+    binaryio::write(*trace_, static_cast<char>(extrapolate_solution));
+  }
   const int num_discrete_events = contact_sequence_.numDiscreteEvents();
   if (extrapolate_solution && (num_discrete_events>0)) {
     ocp_.discretize(contact_sequence_, t);
@@ -272,11 +428,17 @@ void OCPSolver::popBackContactStatus(const double t,
     }
   }
   contact_sequence_.pop_back();
+  is_kkt_system_reusable_ = false;
 }
 
 
 void OCPSolver::popFrontContactStatus(const double t, 
                                       const bool extrapolate_solution) {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::PopFrontContactStatus);
+    binaryio::write(*trace_, t);
+    binaryio::write(*trace_, static_cast<char>(extrapolate_solution));
+  }
   const int num_discrete_events = contact_sequence_.numDiscreteEvents();
   if (extrapolate_solution && (num_discrete_events>0)) {
     ocp_.discretize(contact_sequence_, t);
@@ -293,16 +455,30 @@ void OCPSolver::popFrontContactStatus(const double t,
     }
   }
   contact_sequence_.pop_front();
+  is_kkt_system_reusable_ = false;
 }
 
 
 void OCPSolver::clearLineSearchFilter() {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::ClearLineSearchFilter);
+  }
   line_search_.clearFilter();
 }
 
 
+void OCPSolver::setSecondOrderCorrection(const bool second_order_correction) {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::SetSecondOrderCorrection);
+    binaryio::write(*trace_, static_cast<char>(second_order_correction));
+  }
+  line_search_.setSecondOrderCorrection(second_order_correction);
+}
+
+
 double OCPSolver::KKTError() {
-  return dms_.KKTError(ocp_, kkt_residual_);
+  const double kkt_error = dms_.KKTError(ocp_, kkt_residual_);
+  return std::sqrt(kkt_error*kkt_error + sto_.KKTError());
 }
 
 
@@ -311,12 +487,69 @@ double OCPSolver::cost() const {
 }
 
 
+double OCPSolver::regularization() const {
+  return riccati_recursion_.regularization();
+}
+
+
+void OCPSolver::setMixedPrecisionRiccati(const bool mixed_precision) {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::SetMixedPrecisionRiccati);
+    binaryio::write(*trace_, static_cast<char>(mixed_precision));
+  }
+  riccati_recursion_.setMixedPrecision(mixed_precision);
+}
+
+
+void OCPSolver::setMultiLevelIteration(const int full_update_interval, 
+                                       const int jacobian_update_interval) {
+  try {
+    if (full_update_interval <= 0) {
+      throw std::out_of_range(
+          "invalid value: full_update_interval must be positive!");
+    }
+    if (jacobian_update_interval <= 0) {
+      throw std::out_of_range(
+          "invalid value: jacobian_update_interval must be positive!");
+    }
+    if (jacobian_update_interval > full_update_interval) {
+      throw std::out_of_range(
+          "invalid value: jacobian_update_interval must not be larger than full_update_interval!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::SetMultiLevelIteration);
+    binaryio::write(*trace_, full_update_interval);
+    binaryio::write(*trace_, jacobian_update_interval);
+  }
+  full_update_interval_ = full_update_interval;
+  jacobian_update_interval_ = jacobian_update_interval;
+  iteration_count_ = 0;
+}
+
+
+IterationLevel OCPSolver::iterationLevel() const {
+  return riccati_recursion_.iterationLevel();
+}
+
+
 void OCPSolver::computeKKTResidual(const double t, const Eigen::VectorXd& q, 
                                    const Eigen::VectorXd& v) {
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::ComputeKKTResidual);
+    binaryio::write(*trace_, t);
+    binaryio::writeVector(*trace_, q);
+    binaryio::writeVector(*trace_, v);
+  }
   ocp_.discretize(contact_sequence_, t);
   discretizeSolution();
   dms_.computeKKTResidual(ocp_, robots_, contact_sequence_, q, v, s_, 
                           kkt_matrix_, kkt_residual_);
+  sto_.computeKKTResidual(ocp_, kkt_matrix_, s_);
 }
 
 
@@ -373,34 +606,546 @@ void OCPSolver::showInfo() const {
 }
 
 
-void OCPSolver::discretizeSolution() {
-  for (int i=0; i<=ocp_.discrete().N(); ++i) {
-    s_[i].setContactStatus(
-        contact_sequence_.contactStatus(ocp_.discrete().contactPhase(i)));
+bool OCPSolver::saveSnapshot(const std::string& file_name, 
+                             const double t) const {
+  std::ofstream ofs(file_name, std::ios::out | std::ios::binary);
+  if (!ofs) {
+    std::cerr << "cannot open " << file_name << '\n';
+    return false;
+  }
+  if (!saveSnapshot(ofs, t)) {
+    std::cerr << "failed to write " << file_name << '\n';
+    return false;
+  }
+  return true;
+}
+
+
+bool OCPSolver::saveSnapshot(std::ostream& ofs, const double t) const {
+  // Discretizes copies so that saving does not modify the solver.
+  HybridTimeDiscretization discretization = ocp_.discrete();
+  discretization.discretize(contact_sequence_, t);
+  Solution s_discretized = s_;
+  discretizeSolution(contact_sequence_, discretization, s_discretized);
+  ofs.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+  binaryio::write(ofs, kSnapshotVersion);
+  // robot model and sizes of the containers
+  binaryio::write(ofs, robots_[0].dimq());
+  binaryio::write(ofs, robots_[0].dimv());
+  binaryio::write(ofs, robots_[0].dimu());
+  binaryio::write(ofs, robots_[0].maxPointContacts());
+  binaryio::write(ofs, static_cast<int>(s_.data.size()));
+  binaryio::write(ofs, static_cast<int>(s_.impulse.size()));
+  binaryio::write(ofs, t);
+  // contact sequence
+  const int num_events = contact_sequence_.numDiscreteEvents();
+  binaryio::write(ofs, num_events);
+  binaryio::writeContactStatus(ofs, contact_sequence_.contactStatus(0));
+  int impulse_index = 0;
+  int lift_index = 0;
+  for (int event_index=0; event_index<num_events; ++event_index) {
+    char is_impulse, sto;
+    double event_time;
+    if (contact_sequence_.eventType(event_index) == DiscreteEventType::Impulse) {
+      is_impulse = 1;
+      sto = contact_sequence_.isSTOEnabledImpulse(impulse_index) ? 1 : 0;
+      event_time = contact_sequence_.impulseTime(impulse_index);
+      ++impulse_index;
+    }
+    else {
+      is_impulse = 0;
+      sto = contact_sequence_.isSTOEnabledLift(lift_index) ? 1 : 0;
+      event_time = contact_sequence_.liftTime(lift_index);
+      ++lift_index;
+    }
+    binaryio::write(ofs, is_impulse);
+    binaryio::write(ofs, sto);
+    binaryio::write(ofs, event_time);
+    binaryio::writeContactStatus(ofs, 
+                                 contact_sequence_.contactStatus(event_index+1));
+  }
+  // solution
+  const int N = discretization.N();
+  const int N_impulse = discretization.N_impulse();
+  const int N_lift = discretization.N_lift();
+  binaryio::write(ofs, N);
+  binaryio::write(ofs, N_impulse);
+  binaryio::write(ofs, N_lift);
+  auto writeSplitSolution = [&ofs](const SplitSolution& s) {
+    binaryio::writeVector(ofs, s.q);
+    binaryio::writeVector(ofs, s.v);
+    binaryio::writeVector(ofs, s.a);
+    binaryio::writeVector(ofs, s.u);
+    binaryio::writeVector3dArray(ofs, s.f);
+    binaryio::writeVector(ofs, s.lmd);
+    binaryio::writeVector(ofs, s.gmm);
+    binaryio::writeVector(ofs, s.beta);
+    binaryio::writeVector3dArray(ofs, s.mu);
+    binaryio::writeVector(ofs, s.nu_passive);
+    binaryio::writeVector(ofs, s.xi_stack());
+  };
+  for (int i=0; i<=N; ++i) {
+    writeSplitSolution(s_discretized[i]);
+  }
+  for (int i=0; i<N_impulse; ++i) {
+    const ImpulseSplitSolution& s = s_discretized.impulse[i];
+    binaryio::writeVector(ofs, s.q);
+    binaryio::writeVector(ofs, s.v);
+    binaryio::writeVector(ofs, s.dv);
+    binaryio::writeVector3dArray(ofs, s.f);
+    binaryio::writeVector(ofs, s.lmd);
+    binaryio::writeVector(ofs, s.gmm);
+    binaryio::writeVector(ofs, s.beta);
+    binaryio::writeVector3dArray(ofs, s.mu);
+    writeSplitSolution(s_discretized.aux[i]);
+  }
+  for (int i=0; i<N_lift; ++i) {
+    writeSplitSolution(s_discretized.lift[i]);
+  }
+  // slack and dual variables of the inequality constraints
+  for (int i=0; i<N; ++i) {
+    binaryio::writeSlackAndDual(ofs, ocp_[i].getConstraintsData());
+  }
+  for (int i=0; i<N_impulse; ++i) {
+    binaryio::writeSlackAndDual(ofs, ocp_.impulse[i].getConstraintsData());
+    binaryio::writeSlackAndDual(ofs, ocp_.aux[i].getConstraintsData());
+  }
+  for (int i=0; i<N_lift; ++i) {
+    binaryio::writeSlackAndDual(ofs, ocp_.lift[i].getConstraintsData());
+  }
+  // state of the multi-level iteration
+  binaryio::write(ofs, full_update_interval_);
+  binaryio::write(ofs, jacobian_update_interval_);
+  binaryio::write(ofs, iteration_count_);
+  // state of the Riccati recursion and the line search kept over the 
+  // iterations
+  riccati_recursion_.saveFactorization(ofs, riccati_factorization_);
+  line_search_.saveFilter(ofs);
+  return static_cast<bool>(ofs);
+}
+
+
+bool OCPSolver::loadSnapshot(const std::string& file_name) {
+  std::ifstream ifs(file_name, std::ios::in | std::ios::binary);
+  if (!ifs) {
+    std::cerr << "cannot open " << file_name << '\n';
+    return false;
+  }
+  return loadSnapshot(ifs);
+}
+
+
+bool OCPSolver::loadSnapshot(std::istream& ifs) {
+  // Reads into a copy so that this solver is not modified if loading fails.
+  OCPSolver solver(*this);
+  double t;
+  try {
+    char magic[sizeof(kSnapshotMagic)];
+    ifs.read(magic, sizeof(kSnapshotMagic));
+    if (!ifs || std::memcmp(magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+      throw std::runtime_error("the stream is not a snapshot of OCPSolver!");
+    }
+    int version;
+    binaryio::read(ifs, version);
+    // Version 1 does not contain the state of the multi-level iteration and
+    // versions 1 and 2 do not contain the states of the Riccati recursion and
+    // the line search.
+    if (version < 1 || version > kSnapshotVersion) {
+      throw std::runtime_error("unsupported snapshot version " 
+                               + std::to_string(version) + "!");
+    }
+    int dimq, dimv, dimu, max_point_contacts, data_size, impulse_size;
+    binaryio::read(ifs, dimq);
+    binaryio::read(ifs, dimv);
+    binaryio::read(ifs, dimu);
+    binaryio::read(ifs, max_point_contacts);
+    binaryio::read(ifs, data_size);
+    binaryio::read(ifs, impulse_size);
+    if (dimq != robots_[0].dimq() || dimv != robots_[0].dimv() 
+        || dimu != robots_[0].dimu() 
+        || max_point_contacts != robots_[0].maxPointContacts()) {
+      throw std::runtime_error("robot model is inconsistent with the snapshot!");
+    }
+    if (data_size != static_cast<int>(s_.data.size()) 
+        || impulse_size != static_cast<int>(s_.impulse.size())) {
+      throw std::runtime_error("N or max_num_impulse is inconsistent with the snapshot!");
+    }
+    binaryio::read(ifs, t);
+    // contact sequence
+    int num_events;
+    binaryio::read(ifs, num_events);
+    ContactStatus contact_status = robots_[0].createContactStatus();
+    binaryio::readContactStatus(ifs, contact_status);
+    solver.contact_sequence_.setContactStatusUniformly(contact_status);
+    for (int event_index=0; event_index<num_events; ++event_index) {
+      char is_impulse, sto;
+      double event_time;
+      binaryio::read(ifs, is_impulse);
+      binaryio::read(ifs, sto);
+      binaryio::read(ifs, event_time);
+      binaryio::readContactStatus(ifs, contact_status);
+      solver.contact_sequence_.push_back(contact_status, event_time, (sto != 0));
+      if ((is_impulse != 0) != (solver.contact_sequence_.eventType(event_index) 
+                                  == DiscreteEventType::Impulse)) {
+        throw std::runtime_error("inconsistent discrete event type!");
+      }
+      solver.contact_sequence_.setContactPoints(event_index+1, 
+                                                contact_status.contactPoints());
+    }
+    // solution
+    solver.ocp_.discretize(solver.contact_sequence_, t);
+    solver.discretizeSolution();
+    const int N = solver.ocp_.discrete().N();
+    const int N_impulse = solver.ocp_.discrete().N_impulse();
+    const int N_lift = solver.ocp_.discrete().N_lift();
+    int N_saved, N_impulse_saved, N_lift_saved;
+    binaryio::read(ifs, N_saved);
+    binaryio::read(ifs, N_impulse_saved);
+    binaryio::read(ifs, N_lift_saved);
+    if (N != N_saved || N_impulse != N_impulse_saved || N_lift != N_lift_saved) {
+      throw std::runtime_error("time discretization is inconsistent with the snapshot!");
+    }
+    auto readSplitSolution = [&ifs](SplitSolution& s) {
+      binaryio::readVector(ifs, s.q);
+      binaryio::readVector(ifs, s.v);
+      binaryio::readVector(ifs, s.a);
+      binaryio::readVector(ifs, s.u);
+      binaryio::readVector3dArray(ifs, s.f);
+      binaryio::readVector(ifs, s.lmd);
+      binaryio::readVector(ifs, s.gmm);
+      binaryio::readVector(ifs, s.beta);
+      binaryio::readVector3dArray(ifs, s.mu);
+      binaryio::readVector(ifs, s.nu_passive);
+      binaryio::readVector(ifs, s.xi_stack());
+      s.set_f_stack();
+      s.set_mu_stack();
+    };
+    for (int i=0; i<=N; ++i) {
+      readSplitSolution(solver.s_[i]);
+    }
+    for (int i=0; i<N_impulse; ++i) {
+      ImpulseSplitSolution& s = solver.s_.impulse[i];
+      binaryio::readVector(ifs, s.q);
+      binaryio::readVector(ifs, s.v);
+      binaryio::readVector(ifs, s.dv);
+      binaryio::readVector3dArray(ifs, s.f);
+      binaryio::readVector(ifs, s.lmd);
+      binaryio::readVector(ifs, s.gmm);
+      binaryio::readVector(ifs, s.beta);
+      binaryio::readVector3dArray(ifs, s.mu);
+      s.set_f_stack();
+      s.set_mu_stack();
+      readSplitSolution(solver.s_.aux[i]);
+    }
+    for (int i=0; i<N_lift; ++i) {
+      readSplitSolution(solver.s_.lift[i]);
+    }
+    // slack and dual variables of the inequality constraints
+    solver.dms_.initConstraints(solver.ocp_, solver.robots_, 
+                                solver.contact_sequence_, solver.s_);
+    for (int i=0; i<N; ++i) {
+      ConstraintsData data = solver.ocp_[i].getConstraintsData();
+      binaryio::readSlackAndDual(ifs, data);
+      solver.ocp_[i].initConstraints(data);
+    }
+    for (int i=0; i<N_impulse; ++i) {
+      ConstraintsData impulse_data = solver.ocp_.impulse[i].getConstraintsData();
+      binaryio::readSlackAndDual(ifs, impulse_data);
+      solver.ocp_.impulse[i].initConstraints(impulse_data);
+      ConstraintsData aux_data = solver.ocp_.aux[i].getConstraintsData();
+      binaryio::readSlackAndDual(ifs, aux_data);
+      solver.ocp_.aux[i].initConstraints(aux_data);
+    }
+    for (int i=0; i<N_lift; ++i) {
+      ConstraintsData data = solver.ocp_.lift[i].getConstraintsData();
+      binaryio::readSlackAndDual(ifs, data);
+      solver.ocp_.lift[i].initConstraints(data);
+    }
+    // state of the multi-level iteration
+    if (version >= 2) {
+      binaryio::read(ifs, solver.full_update_interval_);
+      binaryio::read(ifs, solver.jacobian_update_interval_);
+      binaryio::read(ifs, solver.iteration_count_);
+    }
+    if (version >= 3) {
+      solver.riccati_recursion_.loadFactorization(ifs, 
+                                                  solver.riccati_factorization_);
+      solver.line_search_.loadFilter(ifs);
+    }
+    else {
+      // The recordings of these versions start with an empty filter.
+      solver.line_search_.clearFilter();
+    }
+    // The snapshot does not contain the KKT matrices, so the next iteration
+    // evaluates the KKT system fully. 
+    solver.is_kkt_system_reusable_ = false;
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return false;
+  }
+  *this = std::move(solver);
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::Snapshot);
+    saveSnapshot(*trace_, t);
+  }
+  return true;
+}
+
+
+void OCPSolver::addWarmStartEntry(WarmStartLibraryBuilder& builder, 
+                                  const WarmStartKey& key, const double t) {
+  ocp_.discretize(contact_sequence_, t);
+  discretizeSolution();
+  const int N = ocp_.discrete().N();
+  const int N_impulse = ocp_.discrete().N_impulse();
+  const int N_lift = ocp_.discrete().N_lift();
+  // The auxiliary and lift stages are inserted after the time stage at the 
+  // same time so that the points are in the order of time.
+  struct Point {
+    double t;
+    const SplitSolution* s;
+    const ConstraintsData* data;
+  };
+  std::vector<Point> points;
+  for (int i=0; i<N; ++i) {
+    points.push_back({ocp_.discrete().t(i)-t, &s_[i], 
+                      &ocp_[i].getConstraintsData()});
+  }
+  points.push_back({ocp_.discrete().t(N)-t, &s_[N], nullptr});
+  for (int i=0; i<N_impulse; ++i) {
+    points.push_back({ocp_.discrete().t_impulse(i)-t, &s_.aux[i], 
+                      &ocp_.aux[i].getConstraintsData()});
+  }
+  for (int i=0; i<N_lift; ++i) {
+    points.push_back({ocp_.discrete().t_lift(i)-t, &s_.lift[i], 
+                      &ocp_.lift[i].getConstraintsData()});
+  }
+  std::stable_sort(points.begin(), points.end(), 
+                   [](const Point& a, const Point& b) { return a.t < b.t; });
+  builder.addEntry(key);
+  for (const auto& e : points) {
+    if (e.data != nullptr) {
+      builder.addPoint(e.t, *e.s, *e.data);
+    }
+    else {
+      builder.addPoint(e.t, *e.s);
+    }
+  }
+}
+
+
+bool OCPSolver::loadWarmStart(const WarmStartLibrary& library, 
+                              const WarmStartKey& key, const double t,
+                              const double phase_weight) {
+  if (!library.isConsistent(robots_[0])) {
+    std::cerr << "warm-start library is inconsistent with the robot model!\n";
+    return false;
+  }
+  if (key.command.size() != library.dimCommand()) {
+    std::cerr << "size of the command is inconsistent with the warm-start library!\n";
+    return false;
+  }
+  const int entry = library.findNearest(key, phase_weight);
+  if (entry < 0) {
+    std::cerr << "warm-start library has no entry of gait " << key.gait << '\n';
+    return false;
+  }
+  ocp_.discretize(contact_sequence_, t);
+  discretizeSolution();
+  const int N = ocp_.discrete().N();
+  const int N_impulse = ocp_.discrete().N_impulse();
+  const int N_lift = ocp_.discrete().N_lift();
+  for (int i=0; i<=N; ++i) {
+    library.interpolate(robots_[0], entry, ocp_.discrete().t(i)-t, s_[i]);
     s_[i].set_f_stack();
-    s_[i].setImpulseStatus();
   }
-  for (int i=0; i<ocp_.discrete().N_lift(); ++i) {
-    s_.lift[i].setContactStatus(
-        contact_sequence_.contactStatus(
-            ocp_.discrete().contactPhaseAfterLift(i)));
-    s_.lift[i].set_f_stack();
-    s_.lift[i].setImpulseStatus();
-  }
-  for (int i=0; i<ocp_.discrete().N_impulse(); ++i) {
-    s_.impulse[i].setImpulseStatus(contact_sequence_.impulseStatus(i));
-    s_.impulse[i].set_f_stack();
-    s_.aux[i].setContactStatus(
-        contact_sequence_.contactStatus(
-            ocp_.discrete().contactPhaseAfterImpulse(i)));
+  for (int i=0; i<N_impulse; ++i) {
+    const double t_impulse = ocp_.discrete().t_impulse(i) - t;
+    library.interpolate(robots_[0], entry, t_impulse, s_.aux[i]);
     s_.aux[i].set_f_stack();
+    s_.impulse[i].q = s_.aux[i].q;
+    s_.impulse[i].v = s_.aux[i].v;
+  }
+  for (int i=0; i<N_lift; ++i) {
+    library.interpolate(robots_[0], entry, ocp_.discrete().t_lift(i)-t, 
+                        s_.lift[i]);
+    s_.lift[i].set_f_stack();
+  }
+  // slack and dual variables of the inequality constraints
+  dms_.initConstraints(ocp_, robots_, contact_sequence_, s_);
+  for (int i=0; i<N; ++i) {
+    ConstraintsData data = ocp_[i].getConstraintsData();
+    library.interpolate(entry, ocp_.discrete().t(i)-t, data);
+    ocp_[i].initConstraints(data);
+  }
+  for (int i=0; i<N_impulse; ++i) {
+    ConstraintsData data = ocp_.aux[i].getConstraintsData();
+    library.interpolate(entry, ocp_.discrete().t_impulse(i)-t, data);
+    ocp_.aux[i].initConstraints(data);
+  }
+  for (int i=0; i<N_lift; ++i) {
+    ConstraintsData data = ocp_.lift[i].getConstraintsData();
+    library.interpolate(entry, ocp_.discrete().t_lift(i)-t, data);
+    ocp_.lift[i].initConstraints(data);
+  }
+  // The KKT matrices of the previous solution must not be reused.
+  is_kkt_system_reusable_ = false;
+  if (trace_) {
+    writeTraceEvent(*trace_, OCPSolverTraceEvent::Snapshot);
+    saveSnapshot(*trace_, t);
+  }
+  return true;
+}
+
+
+bool OCPSolver::startRecording(const std::string& file_name, const double t) {
+  stopRecording();
+  auto trace = std::make_shared<std::ofstream>(
+      file_name, std::ios::out | std::ios::binary);
+  if (!(*trace)) {
+    std::cerr << "cannot open " << file_name << '\n';
+    return false;
+  }
+  // The trace starts with a snapshot, which does not contain the KKT matrices
+  // and after loading which the KKT system is evaluated fully. The same is 
+  // done here so that the replay follows the recorded iterations.
+  is_kkt_system_reusable_ = false;
+  writeOCPSolverTraceHeader(*trace);
+  if (!saveSnapshot(*trace, t)) {
+    std::cerr << "failed to write " << file_name << '\n';
+    return false;
+  }
+  trace_ = trace;
+  return true;
+}
+
+
+void OCPSolver::stopRecording() {
+  if (trace_) {
+    trace_->flush();
+    trace_.reset();
+  }
+}
+
+
+bool OCPSolver::isRecording() const {
+  return static_cast<bool>(trace_);
+}
+
+
+bool OCPSolver::applyRealTimeProfile(const RealTimeProfile& profile, 
+                                     const double t, const Eigen::VectorXd& q, 
+                                     const Eigen::VectorXd& v) {
+  assert(q.size() == robots_[0].dimq());
+  assert(v.size() == robots_[0].dimv());
+  const bool process_success = profile.applyToProcess();
+  const int nthreads = robots_.size();
+  int num_failures = 0;
+  #pragma omp parallel num_threads(nthreads) reduction(+:num_failures)
+  {
+    if (!profile.applyToThread(omp_get_thread_num())) {
+      ++num_failures;
+    }
+  }
+  // Pre-faults the memory by an update and restores the solver. The copy 
+  // assignment reuses the memory of this solver.
+  const OCPSolver solver(*this);
+  trace_.reset();
+  perf_counters_.reset();
+  updateSolution(t, q, v, true);
+  *this = solver;
+  return (process_success && num_failures == 0);
+}
+
+
+bool OCPSolver::startPerfCounters() {
+  perf_counters_ = std::make_shared<PerfCounters>(
+      std::vector<std::string>({"discretization", "KKT system", 
+                                "switching time optimization", 
+                                "backward Riccati recursion", 
+                                "forward Riccati recursion", "direction", 
+                                "line search", "integration"}));
+  if (!perf_counters_->open(robots_.size())) {
+    perf_counters_.reset();
+    return false;
+  }
+  return true;
+}
+
+
+void OCPSolver::stopPerfCounters() {
+  perf_counters_.reset();
+}
+
+
+std::shared_ptr<const PerfCounters> OCPSolver::getPerfCounters() const {
+  return perf_counters_;
+}
+
+
+IterationLevel OCPSolver::nextIterationLevel() {
+  IterationLevel level = IterationLevel::Residual;
+  if (iteration_count_%full_update_interval_ == 0) {
+    level = IterationLevel::Full;
+  }
+  else if (iteration_count_%jacobian_update_interval_ == 0) {
+    level = IterationLevel::Jacobian;
+  }
+  iteration_count_ = (iteration_count_+1) % full_update_interval_;
+  return level;
+}
+
+
+void OCPSolver::discretizeSolution() {
+  discretizeSolution(contact_sequence_, ocp_.discrete(), s_);
+}
+
+
+void OCPSolver::discretizeSolution(
+    const ContactSequence& contact_sequence, 
+    const HybridTimeDiscretization& discretization, Solution& s) {
+  for (int i=0; i<=discretization.N(); ++i) {
+    s[i].setContactStatus(
+        contact_sequence.contactStatus(discretization.contactPhase(i)));
+    s[i].set_f_stack();
+    s[i].setImpulseStatus();
+  }
+  for (int i=0; i<discretization.N_lift(); ++i) {
+    s.lift[i].setContactStatus(
+        contact_sequence.contactStatus(
+            discretization.contactPhaseAfterLift(i)));
+    s.lift[i].set_f_stack();
+    s.lift[i].setImpulseStatus();
+  }
+  for (int i=0; i<discretization.N_impulse(); ++i) {
+    s.impulse[i].setImpulseStatus(contact_sequence.impulseStatus(i));
+    s.impulse[i].set_f_stack();
+    s.aux[i].setContactStatus(
+        contact_sequence.contactStatus(
+            discretization.contactPhaseAfterImpulse(i)));
+    s.aux[i].set_f_stack();
     const int time_stage_before_impulse 
-        = ocp_.discrete().timeStageBeforeImpulse(i);
+        = discretization.timeStageBeforeImpulse(i);
     if (time_stage_before_impulse-1 >= 0) {
-      s_[time_stage_before_impulse-1].setImpulseStatus(
-          contact_sequence_.impulseStatus(i));
+      s[time_stage_before_impulse-1].setImpulseStatus(
+          contact_sequence.impulseStatus(i));
     }
   }
 }
 
+
+void OCPSolver::beginPhase(const OCPSolverPhase phase) {
+  if (perf_counters_) {
+    perf_counters_->begin(static_cast<int>(phase));
+  }
+}
+
+
+void OCPSolver::endPhase(const OCPSolverPhase phase) {
+  if (perf_counters_) {
+    perf_counters_->end(static_cast<int>(phase));
+  }
+}
+
 } // namespace idocp
\ No newline at end of file
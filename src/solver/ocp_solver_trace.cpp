@@ -0,0 +1,248 @@
+#include "idocp/solver/ocp_solver_trace.hpp"
+
+#include <stdexcept>
+#include <cstring>
+
+#include "idocp/utils/binary_io.hpp"
+
+
+namespace idocp {
+
+namespace {
+constexpr char kTraceMagic[8] = {'I', 'D', 'O', 'C', 'P', 'T', 'R', 'C'};
+constexpr int kTraceVersion = 1;
+} // namespace
+
+
+void writeOCPSolverTraceHeader(std::ostream& os) {
+  os.write(kTraceMagic, sizeof(kTraceMagic));
+  binaryio::write(os, kTraceVersion);
+}
+
+
+OCPSolverReplayer::OCPSolverReplayer(const Robot& robot,
+                                     const std::string& file_name)
+  : ifs_(file_name, std::ios::in | std::ios::binary),
+    contact_status_(robot.createContactStatus()),
+    q_(Eigen::VectorXd::Zero(robot.dimq())),
+    v_(Eigen::VectorXd::Zero(robot.dimv())),
+    vec_(),
+    contact_points_(robot.maxPointContacts(), Eigen::Vector3d::Zero()),
+    name_(),
+    last_event_(OCPSolverTraceEvent::Snapshot),
+    last_t_(0),
+    num_events_(0),
+    num_updates_(0) {
+  try {
+    if (!ifs_) {
+      throw std::runtime_error("cannot open " + file_name);
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+
+OCPSolverReplayer::OCPSolverReplayer()
+  : ifs_(),
+    contact_status_(),
+    q_(),
+    v_(),
+    vec_(),
+    contact_points_(),
+    name_(),
+    last_event_(OCPSolverTraceEvent::Snapshot),
+    last_t_(0),
+    num_events_(0),
+    num_updates_(0) {
+}
+
+
+OCPSolverReplayer::~OCPSolverReplayer() {
+}
+
+
+bool OCPSolverReplayer::init(OCPSolver& ocp_solver) {
+  try {
+    char magic[sizeof(kTraceMagic)];
+    ifs_.read(magic, sizeof(kTraceMagic));
+    if (!ifs_ || std::memcmp(magic, kTraceMagic, sizeof(kTraceMagic)) != 0) {
+      throw std::runtime_error("the file is not a trace of OCPSolver!");
+    }
+    int version;
+    binaryio::read(ifs_, version);
+    if (version != kTraceVersion) {
+      throw std::runtime_error("unsupported trace version "
+                               + std::to_string(version) + "!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return false;
+  }
+  last_event_ = OCPSolverTraceEvent::Snapshot;
+  num_events_ = 0;
+  num_updates_ = 0;
+  return ocp_solver.loadSnapshot(ifs_);
+}
+
+
+bool OCPSolverReplayer::replayNext(OCPSolver& ocp_solver) {
+  char event_type;
+  ifs_.read(&event_type, sizeof(char));
+  if (!ifs_) {
+    // end of the trace
+    return false;
+  }
+  const auto event = static_cast<OCPSolverTraceEvent>(event_type);
+  try {
+    switch (event) {
+      case OCPSolverTraceEvent::Snapshot: {
+        if (!ocp_solver.loadSnapshot(ifs_)) {
+          throw std::runtime_error("failed to load the snapshot!");
+        }
+        break;
+      }
+      case OCPSolverTraceEvent::UpdateSolution: {
+        char line_search;
+        binaryio::read(ifs_, last_t_);
+        binaryio::readVector(ifs_, q_);
+        binaryio::readVector(ifs_, v_);
+        binaryio::read(ifs_, line_search);
+        ocp_solver.updateSolution(last_t_, q_, v_, (line_search != 0));
+        ++num_updates_;
+        break;
+      }
+      case OCPSolverTraceEvent::ComputeKKTResidual: {
+        binaryio::read(ifs_, last_t_);
+        binaryio::readVector(ifs_, q_);
+        binaryio::readVector(ifs_, v_);
+        ocp_solver.computeKKTResidual(last_t_, q_, v_);
+        break;
+      }
+      case OCPSolverTraceEvent::InitConstraints: {
+        binaryio::read(ifs_, last_t_);
+        ocp_solver.initConstraints(last_t_);
+        break;
+      }
+      case OCPSolverTraceEvent::SetSolution: {
+        binaryio::readString(ifs_, name_);
+        binaryio::readDynamicVector(ifs_, vec_);
+        ocp_solver.setSolution(name_, vec_);
+        break;
+      }
+      case OCPSolverTraceEvent::SetContactStatusUniformly: {
+        binaryio::readContactStatus(ifs_, contact_status_);
+        ocp_solver.setContactStatusUniformly(contact_status_);
+        break;
+      }
+      case OCPSolverTraceEvent::PushBackContactStatus: {
+        double switching_time;
+        binaryio::readContactStatus(ifs_, contact_status_);
+        binaryio::read(ifs_, switching_time);
+        ocp_solver.pushBackContactStatus(contact_status_, switching_time);
+        break;
+      }
+      case OCPSolverTraceEvent::SetContactPoints: {
+        int contact_phase;
+        binaryio::read(ifs_, contact_phase);
+        binaryio::readVector3dArray(ifs_, contact_points_);
+        ocp_solver.setContactPoints(contact_phase, contact_points_);
+        break;
+      }
+      case OCPSolverTraceEvent::PopBackContactStatus: {
+        char extrapolate_solution;
+        binaryio::read(ifs_, last_t_);
+        binaryio::read(ifs_, extrapolate_solution);
+        ocp_solver.popBackContactStatus(last_t_, (extrapolate_solution != 0));
+        break;
+      }
+      case OCPSolverTraceEvent::PopFrontContactStatus: {
+        char extrapolate_solution;
+        binaryio::read(ifs_, last_t_);
+        binaryio::read(ifs_, extrapolate_solution);
+        ocp_solver.popFrontContactStatus(last_t_, (extrapolate_solution != 0));
+        break;
+      }
+      case OCPSolverTraceEvent::ClearLineSearchFilter: {
+        ocp_solver.clearLineSearchFilter();
+        break;
+      }
+      case OCPSolverTraceEvent::SetDiscretizationGrid: {
+        binaryio::readDynamicVector(ifs_, vec_);
+        ocp_solver.setDiscretizationGrid(
+            std::vector<double>(vec_.data(), vec_.data()+vec_.size()));
+        break;
+      }
+      case OCPSolverTraceEvent::SetGeometricDiscretizationGrid: {
+        double ratio;
+        binaryio::read(ifs_, ratio);
+        ocp_solver.setGeometricDiscretizationGrid(ratio);
+        break;
+      }
+      case OCPSolverTraceEvent::SetSTOParameters: {
+        double hessian, max_step_size;
+        binaryio::read(ifs_, hessian);
+        binaryio::read(ifs_, max_step_size);
+        ocp_solver.setSTOParameters(hessian, max_step_size);
+        break;
+      }
+      case OCPSolverTraceEvent::SetMultiLevelIteration: {
+        int full_update_interval, jacobian_update_interval;
+        binaryio::read(ifs_, full_update_interval);
+        binaryio::read(ifs_, jacobian_update_interval);
+        ocp_solver.setMultiLevelIteration(full_update_interval,
+                                          jacobian_update_interval);
+        break;
+      }
+      case OCPSolverTraceEvent::SetMixedPrecisionRiccati: {
+        char mixed_precision;
+        binaryio::read(ifs_, mixed_precision);
+        ocp_solver.setMixedPrecisionRiccati(mixed_precision != 0);
+        break;
+      }
+      case OCPSolverTraceEvent::SetSecondOrderCorrection: {
+        char second_order_correction;
+        binaryio::read(ifs_, second_order_correction);
+        ocp_solver.setSecondOrderCorrection(second_order_correction != 0);
+        break;
+      }
+      default: {
+        throw std::runtime_error("unknown event "
+                                 + std::to_string(static_cast<int>(event_type))
+                                 + " in the trace!");
+      }
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return false;
+  }
+  last_event_ = event;
+  ++num_events_;
+  return true;
+}
+
+
+OCPSolverTraceEvent OCPSolverReplayer::lastEvent() const {
+  return last_event_;
+}
+
+
+double OCPSolverReplayer::lastTime() const {
+  return last_t_;
+}
+
+
+int OCPSolverReplayer::numReplayedEvents() const {
+  return num_events_;
+}
+
+
+int OCPSolverReplayer::numReplayedUpdates() const {
+  return num_updates_;
+}
+
+} // namespace idocp
@@ -0,0 +1,114 @@
+#include "idocp/solver/policy_evaluator.hpp"
+
+#include <stdexcept>
+#include <iostream>
+#include <cassert>
+
+
+namespace idocp {
+
+PolicyEvaluator::PolicyEvaluator(const Robot& robot, const int num_stages)
+  : robot_(robot),
+    policy_(robot, (num_stages > 0 ? num_stages : 1)),
+    q_ref_(Eigen::VectorXd::Zero(robot.dimq())),
+    qdiff_(Eigen::VectorXd::Zero(robot.dimv())),
+    dq_(Eigen::VectorXd::Zero(robot.dimv())),
+    dv_(Eigen::VectorXd::Zero(robot.dimv())),
+    u_(Eigen::VectorXd::Zero(robot.dimu())),
+    stage_(0) {
+  try {
+    if (num_stages <= 0) {
+      throw std::out_of_range("invalid value: num_stages must be positive!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+
+PolicyEvaluator::PolicyEvaluator()
+  : robot_(),
+    policy_(),
+    q_ref_(),
+    qdiff_(),
+    dq_(),
+    dv_(),
+    u_(),
+    stage_(0) {
+}
+
+
+PolicyEvaluator::~PolicyEvaluator() {
+}
+
+
+void PolicyEvaluator::setPolicy(const ControlPolicy& policy) {
+  assert(policy.numStages() == policy_.numStages());
+  policy_ = policy;
+  stage_ = 0;
+}
+
+
+const ControlPolicy& PolicyEvaluator::policy() const {
+  return policy_;
+}
+
+
+void PolicyEvaluator::computeControlInput(const double t, 
+                                          const Eigen::VectorXd& q, 
+                                          const Eigen::VectorXd& v, 
+                                          Eigen::VectorXd& u) {
+  assert(q.size() == robot_.dimq());
+  assert(v.size() == robot_.dimv());
+  assert(u.size() == robot_.dimu());
+  findStage(t);
+  const int i = stage_;
+  double alpha = 0;
+  if (i+1 < policy_.numStages()) {
+    const double dt = policy_.t_traj.coeff(i+1) - policy_.t_traj.coeff(i);
+    if (dt > 0) {
+      alpha = (t - policy_.t_traj.coeff(i)) / dt;
+      if (alpha < 0) alpha = 0;
+      if (alpha > 1) alpha = 1;
+    }
+  }
+  if (alpha > 0) {
+    robot_.subtractConfiguration(policy_.q_traj[i+1], policy_.q_traj[i], 
+                                 qdiff_);
+    robot_.integrateConfiguration(policy_.q_traj[i], qdiff_, alpha, q_ref_);
+    robot_.subtractConfiguration(q, q_ref_, dq_);
+    dv_ = v - (1-alpha) * policy_.v_traj[i] - alpha * policy_.v_traj[i+1];
+    u = (1-alpha) * policy_.u_traj[i] + alpha * policy_.u_traj[i+1];
+  }
+  else {
+    robot_.subtractConfiguration(q, policy_.q_traj[i], dq_);
+    dv_ = v - policy_.v_traj[i];
+    u = policy_.u_traj[i];
+  }
+  u.noalias() += policy_.Kq_traj[i] * dq_;
+  u.noalias() += policy_.Kv_traj[i] * dv_;
+}
+
+
+const Eigen::VectorXd& PolicyEvaluator::computeControlInput(
+    const double t, const Eigen::VectorXd& q, const Eigen::VectorXd& v) {
+  computeControlInput(t, q, v, u_);
+  return u_;
+}
+
+
+void PolicyEvaluator::findStage(const double t) {
+  // The time is usually monotonically increasing between the updates of the 
+  // policy, so the search starts from the last stage.
+  if (t < policy_.t_traj.coeff(stage_)) {
+    stage_ = 0;
+  }
+  while (stage_+1 < policy_.numStages() 
+          && t >= policy_.t_traj.coeff(stage_+1)) {
+    ++stage_;
+  }
+}
+
+} // namespace idocp 
@@ -0,0 +1,814 @@
+#include "idocp/solver/unconstr_decomposed_ocp_solver.hpp"
+
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <thread>
+#include <algorithm>
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+# include <sys/prctl.h>
+#endif
+
+#include "idocp/utils/aligned_vector.hpp"
+#include "idocp/unconstr/unconstr_ocp.hpp"
+#include "idocp/ocp/solution.hpp"
+#include "idocp/ocp/direction.hpp"
+#include "idocp/ocp/kkt_matrix.hpp"
+#include "idocp/ocp/kkt_residual.hpp"
+#include "idocp/riccati/unconstr_riccati_factorizer.hpp"
+#include "idocp/riccati/unconstr_riccati_recursion.hpp"
+#include "idocp/riccati/unconstr_partitioned_riccati_recursion.hpp"
+#include "idocp/riccati/unconstr_reduced_boundary_system.hpp"
+#include "idocp/riccati/unconstr_segment_coupling.hpp"
+
+
+namespace idocp {
+
+namespace {
+
+enum Command : int {
+  kUpdateSolution,
+  kComputeKKTResidual,
+  kSetSolution,
+  kTerminate
+};
+
+enum SolutionName : int {
+  kq,
+  kv,
+  ka,
+  ku
+};
+
+// Scalars of each segment in the shared memory.
+enum SegmentScalar : int {
+  kPrimalStepSize,
+  kDualStepSize,
+  kKKTError,
+  kCost,
+  kNumSegmentScalars
+};
+
+struct SharedHeader {
+  pthread_barrier_t barrier;
+  int command;
+  int name;
+  double t;
+};
+
+
+size_t cacheAlignedSize(const size_t size) {
+  return (size + 63) / 64 * 64;
+}
+
+
+// Parses a list such as "0-3,8,10-11" of sysfs.
+std::vector<int> parseList(const std::string& list) {
+  std::vector<int> values;
+  std::stringstream ss(list);
+  std::string range;
+  try {
+    while (std::getline(ss, range, ',')) {
+      if (range.empty()) continue;
+      const auto dash = range.find('-');
+      const int first = std::stoi(range.substr(0, dash));
+      const int last = (dash == std::string::npos)
+                        ? first : std::stoi(range.substr(dash+1));
+      for (int i=first; i<=last; ++i) {
+        values.push_back(i);
+      }
+    }
+  }
+  catch(const std::exception& e) {
+    values.clear();
+  }
+  return values;
+}
+
+
+// Returns the CPUs of each online NUMA node. Empty if the topology is not
+// available.
+std::vector<std::vector<int>> numaNodeCPUs() {
+  std::vector<std::vector<int>> nodes;
+#ifdef __linux__
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string line;
+  if (!online || !std::getline(online, line)) {
+    return nodes;
+  }
+  for (const int node : parseList(line)) {
+    std::ifstream cpulist("/sys/devices/system/node/node"
+                          + std::to_string(node) + "/cpulist");
+    std::string cpus;
+    if (cpulist && std::getline(cpulist, cpus)) {
+      const auto node_cpus = parseList(cpus);
+      if (!node_cpus.empty()) {
+        nodes.push_back(node_cpus);
+      }
+    }
+  }
+#endif
+  return nodes;
+}
+
+
+// Calls f(i, thread_num) for i in [begin, end) by nthreads threads. The
+// threads are created per call since the OpenMP runtime cannot be used in the
+// forked processes.
+template <typename Function>
+void parallelFor(const int nthreads, const int begin, const int end,
+                 const Function& f) {
+  std::vector<std::thread> threads;
+  for (int thread_num=1; thread_num<nthreads; ++thread_num) {
+    threads.emplace_back([&f, thread_num, nthreads, begin, end]() {
+      for (int i=begin+thread_num; i<end; i+=nthreads) {
+        f(i, thread_num);
+      }
+    });
+  }
+  for (int i=begin; i<end; i+=nthreads) {
+    f(i, 0);
+  }
+  for (auto& e : threads) {
+    e.join();
+  }
+}
+
+
+SharedHeader* sharedHeader(void* shared_memory) {
+  return static_cast<SharedHeader*>(shared_memory);
+}
+
+} // namespace
+
+
+struct UnconstrDecomposedOCPSolver::Segment {
+  Segment(const Robot& robot, const std::shared_ptr<CostFunction>& cost,
+          const std::shared_ptr<Constraints>& constraints, const double T,
+          const int N, const int stage_begin, const int stage_end,
+          const int nthreads, const int process, const int num_processes,
+          double* coupling_storage)
+    : robots(nthreads, robot),
+      ocp(robot, cost, constraints, stage_end-stage_begin),
+      kkt_matrix(robot, stage_end-stage_begin),
+      kkt_residual(robot, stage_end-stage_begin),
+      s(robot, stage_end-stage_begin),
+      d(robot, stage_end-stage_begin),
+      factorization(stage_end-stage_begin+1, SplitRiccatiFactorization(robot)),
+      riccati_recursion(robot, T, N, stage_begin, stage_end),
+      reduced_system(robot, num_processes),
+      coupling(),
+      dx0(Eigen::VectorXd::Zero(2*robot.dimv())),
+      primal_step_size(Eigen::VectorXd::Zero(stage_end-stage_begin)),
+      dual_step_size(Eigen::VectorXd::Zero(stage_end-stage_begin)),
+      kkt_error(Eigen::VectorXd::Zero(stage_end-stage_begin+1)),
+      stage_begin(stage_begin),
+      num_stages(stage_end-stage_begin),
+      process(process),
+      has_terminal_stage(stage_end == N) {
+    // Reserved so that the couplings keep referring to the shared memory.
+    coupling.reserve(num_processes);
+    const int storage_size = UnconstrSegmentCoupling::storageSize(robot);
+    for (int i=0; i<num_processes; ++i) {
+      coupling.emplace_back(robot, coupling_storage+i*storage_size);
+    }
+  }
+
+  aligned_vector<Robot> robots;
+  UnconstrOCP ocp;
+  KKTMatrix kkt_matrix;
+  KKTResidual kkt_residual;
+  Solution s;
+  Direction d;
+  UnconstrRiccatiFactorization factorization;
+  UnconstrPartitionedRiccatiRecursion riccati_recursion;
+  UnconstrReducedBoundarySystem reduced_system;
+  std::vector<UnconstrSegmentCoupling> coupling;
+  Eigen::VectorXd dx0, primal_step_size, dual_step_size, kkt_error;
+  int stage_begin, num_stages, process;
+  bool has_terminal_stage;
+};
+
+
+UnconstrDecomposedOCPSolver::UnconstrDecomposedOCPSolver(
+    const Robot& robot, const std::shared_ptr<CostFunction>& cost,
+    const std::shared_ptr<Constraints>& constraints, const double T,
+    const int N, const int num_processes, const int nthreads,
+    const bool pin_to_numa_nodes)
+  : robot_(robot),
+    cost_(cost),
+    constraints_(constraints),
+    N_(N),
+    num_processes_(num_processes),
+    nthreads_(nthreads),
+    dimq_(robot.dimq()),
+    dimv_(robot.dimv()),
+    dimu_(robot.dimu()),
+    T_(T),
+    dt_(T/N),
+    stage_begin_(),
+    cpus_(),
+    workers_(),
+    shared_memory_(nullptr),
+    shared_memory_size_(0),
+    offset_command_(0),
+    offset_scalars_(0),
+    offset_boundary_(0),
+    offset_coupling_(0),
+    offset_board_(0),
+    segment_() {
+  try {
+    if (T <= 0) {
+      throw std::out_of_range("invalid value: T must be positive!");
+    }
+    if (N <= 0) {
+      throw std::out_of_range("invalid value: N must be positive!");
+    }
+    if (num_processes <= 0) {
+      throw std::out_of_range("invalid value: num_processes must be positive!");
+    }
+    if (N < num_processes) {
+      throw std::out_of_range(
+          "invalid value: N must be larger than or equal to num_processes!");
+    }
+    if (nthreads <= 0) {
+      throw std::out_of_range("invalid value: nthreads must be positive!");
+    }
+    if (robot.hasFloatingBase()) {
+      throw std::invalid_argument(
+          "invalid argument: robot must be a fixed-base robot!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  // Balanced partition of the time stages.
+  stage_begin_.resize(num_processes+1);
+  for (int i=0; i<=num_processes; ++i) {
+    stage_begin_[i] = (i * N) / num_processes;
+  }
+  // The processes are assigned to the NUMA nodes in a round-robin manner and
+  // the processes on the same node share its CPUs evenly.
+  cpus_.assign(num_processes, std::vector<int>());
+  if (pin_to_numa_nodes) {
+    const auto nodes = numaNodeCPUs();
+    const int num_nodes = nodes.size();
+    for (int i=0; i<num_processes && num_nodes>0; ++i) {
+      const auto& node_cpus = nodes[i%num_nodes];
+      const int num_node_processes = (num_processes - i%num_nodes
+                                        + num_nodes - 1) / num_nodes;
+      const int rank = i / num_nodes;
+      const int num_cpus = node_cpus.size();
+      const int first = (rank * num_cpus) / num_node_processes;
+      const int last = ((rank+1) * num_cpus) / num_node_processes;
+      if (last > first) {
+        cpus_[i].assign(node_cpus.begin()+first, node_cpus.begin()+last);
+      }
+      else {
+        cpus_[i] = node_cpus;
+      }
+    }
+  }
+  // Layout of the shared memory.
+  offset_command_ = cacheAlignedSize(sizeof(SharedHeader));
+  offset_scalars_ = offset_command_ + cacheAlignedSize(
+      (dimq_+dimv_+std::max(dimq_, dimv_))*sizeof(double));
+  offset_boundary_ = offset_scalars_ + cacheAlignedSize(
+      kNumSegmentScalars*num_processes*sizeof(double));
+  offset_coupling_ = offset_boundary_ + cacheAlignedSize(
+      num_processes*(dimq_+3*dimv_)*sizeof(double));
+  offset_board_ = offset_coupling_ + cacheAlignedSize(
+      num_processes*UnconstrSegmentCoupling::storageSize(robot)*sizeof(double));
+  shared_memory_size_ = offset_board_ + cacheAlignedSize(
+      (N+1)*boardStride()*sizeof(double));
+  void* shared_memory = mmap(nullptr, shared_memory_size_,
+                             PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+                             -1, 0);
+  if (shared_memory == MAP_FAILED) {
+    std::cerr << "mmap() failed: " << std::strerror(errno) << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  shared_memory_ = shared_memory;
+  pthread_barrierattr_t attr;
+  pthread_barrierattr_init(&attr);
+  pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+  pthread_barrier_init(&sharedHeader(shared_memory_)->barrier, &attr,
+                       num_processes);
+  pthread_barrierattr_destroy(&attr);
+  // Flushes the buffers so that they are not duplicated into the workers.
+  std::cout.flush();
+  std::cerr.flush();
+  for (int i=1; i<num_processes; ++i) {
+    const pid_t pid = fork();
+    if (pid < 0) {
+      std::cerr << "fork() failed: " << std::strerror(errno) << '\n';
+      std::exit(EXIT_FAILURE);
+    }
+    if (pid == 0) {
+      runWorker(i);
+    }
+    workers_.push_back(pid);
+  }
+  pinCallingThread(0);
+  segment_.reset(new Segment(robot, cost, constraints, T, N, stage_begin_[0],
+                             stage_begin_[1], nthreads, 0, num_processes,
+                             sharedData(offset_coupling_)));
+  initSegment();
+}
+
+
+UnconstrDecomposedOCPSolver::~UnconstrDecomposedOCPSolver() {
+  if (shared_memory_ == nullptr) {
+    return;
+  }
+  if (!workers_.empty()) {
+    sharedHeader(shared_memory_)->command = kTerminate;
+    waitBarrier();
+    for (const auto pid : workers_) {
+      waitpid(pid, nullptr, 0);
+    }
+  }
+  pthread_barrier_destroy(&sharedHeader(shared_memory_)->barrier);
+  munmap(shared_memory_, shared_memory_size_);
+}
+
+
+void UnconstrDecomposedOCPSolver::runWorker(const int process) {
+#ifdef __linux__
+  // Terminates the worker if the calling process dies.
+  prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+  workers_.clear();
+  pinCallingThread(process);
+  // Allocates the segment after pinning so that the data of the segment is
+  // local to the NUMA node.
+  segment_.reset(new Segment(robot_, cost_, constraints_, T_, N_,
+                             stage_begin_[process], stage_begin_[process+1],
+                             nthreads_, process, num_processes_,
+                             sharedData(offset_coupling_)));
+  initSegment();
+  while (true) {
+    waitBarrier();
+    const int command = sharedHeader(shared_memory_)->command;
+    if (command == kTerminate) {
+      break;
+    }
+    execute(command);
+  }
+  _exit(EXIT_SUCCESS);
+}
+
+
+void UnconstrDecomposedOCPSolver::pinCallingThread(const int process) const {
+  if (cpus_[process].empty()) {
+    return;
+  }
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (const auto cpu : cpus_[process]) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set_t), &cpu_set) != 0) {
+    std::cerr << "sched_setaffinity() failed for process " << process << ": "
+              << std::strerror(errno) << '\n';
+  }
+#endif
+}
+
+
+void UnconstrDecomposedOCPSolver::updateSolution(const double t,
+                                                 const Eigen::VectorXd& q,
+                                                 const Eigen::VectorXd& v,
+                                                 const bool line_search) {
+  assert(q.size() == dimq_);
+  assert(v.size() == dimv_);
+  try {
+    if (line_search) {
+      throw std::invalid_argument(
+          "invalid argument: line search is not supported!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  sharedHeader(shared_memory_)->t = t;
+  Eigen::Map<Eigen::VectorXd>(sharedData(offset_command_), dimq_) = q;
+  Eigen::Map<Eigen::VectorXd>(sharedData(offset_command_)+dimq_, dimv_) = v;
+  sharedHeader(shared_memory_)->command = kUpdateSolution;
+  waitBarrier();
+  execute(kUpdateSolution);
+}
+
+
+std::vector<Eigen::VectorXd> UnconstrDecomposedOCPSolver::getSolution(
+    const std::string& name) const {
+  std::vector<Eigen::VectorXd> sol;
+  const double* board = sharedData(offset_board_);
+  const int stride = boardStride();
+  if (name == "q") {
+    for (int i=0; i<=N_; ++i) {
+      sol.push_back(Eigen::Map<const Eigen::VectorXd>(board+i*stride, dimq_));
+    }
+  }
+  if (name == "v") {
+    for (int i=0; i<=N_; ++i) {
+      sol.push_back(Eigen::Map<const Eigen::VectorXd>(board+i*stride+dimq_,
+                                                      dimv_));
+    }
+  }
+  if (name == "a") {
+    for (int i=0; i<N_; ++i) {
+      sol.push_back(Eigen::Map<const Eigen::VectorXd>(
+          board+i*stride+dimq_+dimv_, dimv_));
+    }
+  }
+  if (name == "u") {
+    for (int i=0; i<N_; ++i) {
+      sol.push_back(Eigen::Map<const Eigen::VectorXd>(
+          board+i*stride+dimq_+2*dimv_, dimu_));
+    }
+  }
+  return sol;
+}
+
+
+void UnconstrDecomposedOCPSolver::setSolution(const std::string& name,
+                                              const Eigen::VectorXd& value) {
+  int solution_name = kq;
+  try {
+    if (name == "q") {
+      solution_name = kq;
+    }
+    else if (name == "v") {
+      solution_name = kv;
+    }
+    else if (name == "a") {
+      solution_name = ka;
+    }
+    else if (name == "u") {
+      solution_name = ku;
+    }
+    else {
+      throw std::invalid_argument("invalid arugment: name must be q, v, a, or u!");
+    }
+    const int dim = (solution_name == kq) ? dimq_
+                      : ((solution_name == ku) ? dimu_ : dimv_);
+    if (value.size() != dim) {
+      throw std::invalid_argument(
+          "invalid argument: the size of value must be consistent with name!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  sharedHeader(shared_memory_)->name = solution_name;
+  Eigen::Map<Eigen::VectorXd>(sharedData(offset_command_)+dimq_+dimv_,
+                              value.size()) = value;
+  sharedHeader(shared_memory_)->command = kSetSolution;
+  waitBarrier();
+  execute(kSetSolution);
+}
+
+
+void UnconstrDecomposedOCPSolver::computeKKTResidual(const double t,
+                                                     const Eigen::VectorXd& q,
+                                                     const Eigen::VectorXd& v) {
+  assert(q.size() == dimq_);
+  assert(v.size() == dimv_);
+  sharedHeader(shared_memory_)->t = t;
+  Eigen::Map<Eigen::VectorXd>(sharedData(offset_command_), dimq_) = q;
+  Eigen::Map<Eigen::VectorXd>(sharedData(offset_command_)+dimq_, dimv_) = v;
+  sharedHeader(shared_memory_)->command = kComputeKKTResidual;
+  waitBarrier();
+  execute(kComputeKKTResidual);
+}
+
+
+double UnconstrDecomposedOCPSolver::KKTError() const {
+  const double* scalars = sharedData(offset_scalars_);
+  double kkt_error = 0;
+  for (int i=0; i<num_processes_; ++i) {
+    kkt_error += scalars[kNumSegmentScalars*i+kKKTError];
+  }
+  return std::sqrt(kkt_error);
+}
+
+
+double UnconstrDecomposedOCPSolver::cost() const {
+  const double* scalars = sharedData(offset_scalars_);
+  double total_cost = 0;
+  for (int i=0; i<num_processes_; ++i) {
+    total_cost += scalars[kNumSegmentScalars*i+kCost];
+  }
+  return total_cost;
+}
+
+
+int UnconstrDecomposedOCPSolver::numProcesses() const {
+  return num_processes_;
+}
+
+
+int UnconstrDecomposedOCPSolver::stageBegin(const int process) const {
+  assert(process >= 0);
+  assert(process < num_processes_);
+  return stage_begin_[process];
+}
+
+
+const std::vector<int>& UnconstrDecomposedOCPSolver::cpuAffinity(
+    const int process) const {
+  assert(process >= 0);
+  assert(process < num_processes_);
+  return cpus_[process];
+}
+
+
+void UnconstrDecomposedOCPSolver::showInfo() const {
+  std::cout << "---------- Horizon decomposition ----------" << std::endl;
+  std::cout << "number of processes: " << num_processes_ << std::endl;
+  std::cout << "number of threads per process: " << nthreads_ << std::endl;
+  for (int i=0; i<num_processes_; ++i) {
+    std::cout << "process " << i << " (pid "
+              << ((i == 0) ? getpid() : workers_[i-1]) << "): stages ["
+              << stage_begin_[i] << ", " << stage_begin_[i+1] << "), CPUs: ";
+    if (cpus_[i].empty()) {
+      std::cout << "not pinned";
+    }
+    for (const auto cpu : cpus_[i]) {
+      std::cout << cpu << " ";
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "shared memory: " << shared_memory_size_ << "[bytes]"
+            << std::endl;
+  std::cout << "-------------------------------------------" << std::endl;
+  std::cout << std::endl;
+}
+
+
+void UnconstrDecomposedOCPSolver::execute(const int command) {
+  switch (command) {
+    case kUpdateSolution:
+      updateSegment();
+      break;
+    case kComputeKKTResidual:
+      computeSegmentKKTResidual();
+      break;
+    case kSetSolution:
+      setSegmentSolution();
+      break;
+    default:
+      break;
+  }
+}
+
+
+void UnconstrDecomposedOCPSolver::updateSegment() {
+  Segment& seg = *segment_;
+  const int L = seg.num_stages;
+  const double t = sharedHeader(shared_memory_)->t;
+  double* scalars = sharedData(offset_scalars_)
+                      + kNumSegmentScalars*seg.process;
+  if (!seg.has_terminal_stage) {
+    readBoundary();
+  }
+  parallelFor(nthreads_, 0, L+1, [&](const int i, const int thread_num) {
+    if (i < L) {
+      seg.ocp[i].computeKKTSystem(seg.robots[thread_num],
+                                  t+(seg.stage_begin+i)*dt_, dt_, seg.s[i],
+                                  seg.s[i+1], seg.kkt_matrix[i],
+                                  seg.kkt_residual[i]);
+    }
+    else if (seg.has_terminal_stage) {
+      seg.ocp.terminal.computeKKTSystem(seg.robots[thread_num], t+T_,
+                                        seg.s[L-1].q, seg.s[L],
+                                        seg.kkt_matrix[L], seg.kkt_residual[L]);
+    }
+  });
+  seg.riccati_recursion.backwardRiccatiRecursion(seg.kkt_matrix,
+                                                 seg.kkt_residual,
+                                                 seg.factorization,
+                                                 seg.coupling[seg.process]);
+  double segment_cost = 0;
+  for (int i=0; i<L; ++i) {
+    segment_cost += seg.ocp[i].stageCost();
+  }
+  if (seg.has_terminal_stage) {
+    segment_cost += seg.ocp.terminal.terminalCost();
+  }
+  scalars[kCost] = segment_cost;
+  waitBarrier();
+  // Every process solves the reduced system redundantly, which is cheaper
+  // than broadcasting its solution.
+  const double* command = sharedData(offset_command_);
+  const double* boundary = sharedData(offset_boundary_);
+  seg.dx0.head(dimv_) = Eigen::Map<const Eigen::VectorXd>(command, dimq_)
+                          - Eigen::Map<const Eigen::VectorXd>(boundary, dimq_);
+  seg.dx0.tail(dimv_)
+      = Eigen::Map<const Eigen::VectorXd>(command+dimq_, dimv_)
+          - Eigen::Map<const Eigen::VectorXd>(boundary+dimq_, dimv_);
+  seg.reduced_system.solve(seg.coupling, seg.dx0);
+  seg.d[0].dx = seg.reduced_system.dxBegin(seg.process);
+  seg.riccati_recursion.forwardRiccatiRecursion(
+      seg.kkt_residual, seg.reduced_system.sigma(seg.process),
+      seg.factorization, seg.d);
+  parallelFor(nthreads_, 0, L+1, [&](const int i, const int thread_num) {
+    if (i < L) {
+      UnconstrRiccatiFactorizer::computeCostateDirection(seg.factorization[i],
+                                                         seg.d[i]);
+      seg.ocp[i].expandPrimalAndDual(dt_, seg.s[i], seg.kkt_matrix[i],
+                                     seg.kkt_residual[i], seg.d[i]);
+      seg.primal_step_size.coeffRef(i) = seg.ocp[i].maxPrimalStepSize();
+      seg.dual_step_size.coeffRef(i) = seg.ocp[i].maxDualStepSize();
+    }
+    else if (seg.has_terminal_stage) {
+      UnconstrRiccatiFactorizer::computeCostateDirection(seg.factorization[L],
+                                                         seg.d[L]);
+    }
+  });
+  scalars[kPrimalStepSize] = seg.primal_step_size.minCoeff();
+  scalars[kDualStepSize] = seg.dual_step_size.minCoeff();
+  waitBarrier();
+  const double* all_scalars = sharedData(offset_scalars_);
+  double primal_step_size = 1;
+  double dual_step_size = 1;
+  for (int i=0; i<num_processes_; ++i) {
+    primal_step_size = std::min(
+        primal_step_size, all_scalars[kNumSegmentScalars*i+kPrimalStepSize]);
+    dual_step_size = std::min(
+        dual_step_size, all_scalars[kNumSegmentScalars*i+kDualStepSize]);
+  }
+  parallelFor(nthreads_, 0, L+1, [&](const int i, const int thread_num) {
+    if (i < L) {
+      seg.ocp[i].updatePrimal(seg.robots[thread_num], primal_step_size,
+                              seg.d[i], seg.s[i]);
+      seg.ocp[i].updateDual(dual_step_size);
+    }
+    else if (seg.has_terminal_stage) {
+      seg.ocp.terminal.updatePrimal(seg.robots[thread_num], primal_step_size,
+                                    seg.d[L], seg.s[L]);
+      seg.ocp.terminal.updateDual(dual_step_size);
+    }
+  });
+  publishBoundary();
+  writeBoard();
+  waitBarrier();
+}
+
+
+void UnconstrDecomposedOCPSolver::computeSegmentKKTResidual() {
+  Segment& seg = *segment_;
+  const int L = seg.num_stages;
+  const double t = sharedHeader(shared_memory_)->t;
+  double* scalars = sharedData(offset_scalars_)
+                      + kNumSegmentScalars*seg.process;
+  if (!seg.has_terminal_stage) {
+    readBoundary();
+  }
+  seg.kkt_error.setZero();
+  parallelFor(nthreads_, 0, L+1, [&](const int i, const int thread_num) {
+    if (i < L) {
+      seg.ocp[i].computeKKTResidual(seg.robots[thread_num],
+                                    t+(seg.stage_begin+i)*dt_, dt_, seg.s[i],
+                                    seg.s[i+1], seg.kkt_matrix[i],
+                                    seg.kkt_residual[i]);
+      seg.kkt_error.coeffRef(i) = seg.ocp[i].KKTError(seg.kkt_residual[i], dt_);
+    }
+    else if (seg.has_terminal_stage) {
+      seg.ocp.terminal.computeKKTResidual(seg.robots[thread_num], t+T_,
+                                          seg.s[L-1].q, seg.s[L],
+                                          seg.kkt_matrix[L],
+                                          seg.kkt_residual[L]);
+      seg.kkt_error.coeffRef(L)
+          = seg.ocp.terminal.KKTError(seg.kkt_residual[L]);
+    }
+  });
+  double segment_cost = 0;
+  for (int i=0; i<L; ++i) {
+    segment_cost += seg.ocp[i].stageCost();
+  }
+  if (seg.has_terminal_stage) {
+    segment_cost += seg.ocp.terminal.terminalCost();
+  }
+  scalars[kKKTError] = seg.kkt_error.sum();
+  scalars[kCost] = segment_cost;
+  waitBarrier();
+}
+
+
+void UnconstrDecomposedOCPSolver::setSegmentSolution() {
+  Segment& seg = *segment_;
+  const int L = seg.num_stages;
+  const int name = sharedHeader(shared_memory_)->name;
+  const double* value = sharedData(offset_command_) + dimq_ + dimv_;
+  for (int i=0; i<=L; ++i) {
+    switch (name) {
+      case kq:
+        seg.s[i].q = Eigen::Map<const Eigen::VectorXd>(value, dimq_);
+        break;
+      case kv:
+        seg.s[i].v = Eigen::Map<const Eigen::VectorXd>(value, dimv_);
+        break;
+      case ka:
+        seg.s[i].a = Eigen::Map<const Eigen::VectorXd>(value, dimv_);
+        break;
+      default:
+        seg.s[i].u = Eigen::Map<const Eigen::VectorXd>(value, dimu_);
+        break;
+    }
+  }
+  initSegment();
+}
+
+
+void UnconstrDecomposedOCPSolver::initSegment() {
+  Segment& seg = *segment_;
+  const int L = seg.num_stages;
+  parallelFor(nthreads_, 0, L+1, [&](const int i, const int thread_num) {
+    if (i < L) {
+      seg.ocp[i].initConstraints(seg.robots[thread_num], seg.stage_begin+i,
+                                 seg.s[i]);
+    }
+    else if (seg.has_terminal_stage) {
+      seg.ocp.terminal.initConstraints(seg.robots[thread_num], N_, seg.s[L]);
+    }
+  });
+  publishBoundary();
+  writeBoard();
+  waitBarrier();
+}
+
+
+void UnconstrDecomposedOCPSolver::publishBoundary() {
+  const Segment& seg = *segment_;
+  double* boundary = sharedData(offset_boundary_)
+                      + seg.process*(dimq_+3*dimv_);
+  Eigen::Map<Eigen::VectorXd>(boundary, dimq_) = seg.s[0].q;
+  Eigen::Map<Eigen::VectorXd>(boundary+dimq_, dimv_) = seg.s[0].v;
+  Eigen::Map<Eigen::VectorXd>(boundary+dimq_+dimv_, dimv_) = seg.s[0].lmd;
+  Eigen::Map<Eigen::VectorXd>(boundary+dimq_+2*dimv_, dimv_) = seg.s[0].gmm;
+}
+
+
+void UnconstrDecomposedOCPSolver::readBoundary() {
+  Segment& seg = *segment_;
+  const double* boundary = sharedData(offset_boundary_)
+                            + (seg.process+1)*(dimq_+3*dimv_);
+  const int L = seg.num_stages;
+  seg.s[L].q = Eigen::Map<const Eigen::VectorXd>(boundary, dimq_);
+  seg.s[L].v = Eigen::Map<const Eigen::VectorXd>(boundary+dimq_, dimv_);
+  seg.s[L].lmd = Eigen::Map<const Eigen::VectorXd>(boundary+dimq_+dimv_, dimv_);
+  seg.s[L].gmm = Eigen::Map<const Eigen::VectorXd>(boundary+dimq_+2*dimv_,
+                                                   dimv_);
+}
+
+
+void UnconstrDecomposedOCPSolver::writeBoard() {
+  const Segment& seg = *segment_;
+  double* board = sharedData(offset_board_);
+  const int stride = boardStride();
+  const int num_stages = seg.has_terminal_stage ? seg.num_stages+1
+                                                : seg.num_stages;
+  for (int i=0; i<num_stages; ++i) {
+    double* stage = board + (seg.stage_begin+i)*stride;
+    Eigen::Map<Eigen::VectorXd>(stage, dimq_) = seg.s[i].q;
+    Eigen::Map<Eigen::VectorXd>(stage+dimq_, dimv_) = seg.s[i].v;
+    Eigen::Map<Eigen::VectorXd>(stage+dimq_+dimv_, dimv_) = seg.s[i].a;
+    Eigen::Map<Eigen::VectorXd>(stage+dimq_+2*dimv_, dimu_) = seg.s[i].u;
+  }
+}
+
+
+void UnconstrDecomposedOCPSolver::waitBarrier() {
+  pthread_barrier_wait(&sharedHeader(shared_memory_)->barrier);
+}
+
+
+double* UnconstrDecomposedOCPSolver::sharedData(const size_t offset) const {
+  return reinterpret_cast<double*>(static_cast<char*>(shared_memory_)+offset);
+}
+
+
+int UnconstrDecomposedOCPSolver::boardStride() const {
+  return dimq_ + 2 * dimv_ + dimu_;
+}
+
+} // namespace idocp
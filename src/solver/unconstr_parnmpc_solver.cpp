@@ -14,6 +14,7 @@ UnconstrParNMPCSolver::UnconstrParNMPCSolver(
   : robots_(nthreads, robot),
     parnmpc_(robot, cost, constraints, N),
     backward_correction_(robot, T, N, nthreads),
+    async_iteration_(robot, T, N, nthreads),
     line_search_(robot, T, N, nthreads),
     kkt_matrix_(robot, N),
     kkt_residual_(robot, N),
@@ -68,6 +69,8 @@ void UnconstrParNMPCSolver::initConstraints() {
 void UnconstrParNMPCSolver::initBackwardCorrection(const double t) {
   backward_correction_.initAuxMat(robots_, parnmpc_, t, s_, 
                                   kkt_matrix_, kkt_residual_);
+  async_iteration_.initAuxMat(robots_, parnmpc_, t, s_, 
+                              kkt_matrix_, kkt_residual_);
 }
 
 
@@ -104,6 +107,28 @@ void UnconstrParNMPCSolver::updateSolution(const double t,
 } 
 
 
+void UnconstrParNMPCSolver::setAsyncIteration(const int max_sweeps, 
+                                              const double tol, 
+                                              const bool deterministic) {
+  async_iteration_.setParameters(max_sweeps, tol, deterministic);
+}
+
+
+bool UnconstrParNMPCSolver::updateSolutionAsync(const double t, 
+                                                const Eigen::VectorXd& q, 
+                                                const Eigen::VectorXd& v) {
+  assert(q.size() == robots_[0].dimq());
+  assert(v.size() == robots_[0].dimv());
+  return async_iteration_.iterate(robots_, parnmpc_, t, q, v, kkt_matrix_, 
+                                  kkt_residual_, s_, d_);
+}
+
+
+int UnconstrParNMPCSolver::numAsyncSweeps() const {
+  return async_iteration_.numSweeps();
+}
+
+
 const SplitSolution& UnconstrParNMPCSolver::getSolution(const int stage) const {
   assert(stage >= 0);
   assert(stage <= N_);
@@ -1,11 +1,6 @@
 #include "idocp/utils/joint_constraints_factory.hpp"
 
-#include "idocp/constraints/joint_position_lower_limit.hpp"
-#include "idocp/constraints/joint_position_upper_limit.hpp"
-#include "idocp/constraints/joint_velocity_lower_limit.hpp"
-#include "idocp/constraints/joint_velocity_upper_limit.hpp"
-#include "idocp/constraints/joint_torques_lower_limit.hpp"
-#include "idocp/constraints/joint_torques_upper_limit.hpp"
+#include "idocp/constraints/joint_box_limit.hpp"
 
 
 namespace idocp {
@@ -21,18 +16,15 @@ JointConstraintsFactory::~JointConstraintsFactory() {
 
 std::shared_ptr<idocp::Constraints> JointConstraintsFactory::create() const {
   auto constraints = std::make_shared<idocp::Constraints>();
-  auto joint_position_lower = std::make_shared<idocp::JointPositionLowerLimit>(robot_);
-  auto joint_position_upper = std::make_shared<idocp::JointPositionUpperLimit>(robot_);
-  auto joint_velocity_lower = std::make_shared<idocp::JointVelocityLowerLimit>(robot_);
-  auto joint_velocity_upper = std::make_shared<idocp::JointVelocityUpperLimit>(robot_);
-  auto joint_torques_lower = std::make_shared<idocp::JointTorquesLowerLimit>(robot_);
-  auto joint_torques_upper = std::make_shared<idocp::JointTorquesUpperLimit>(robot_);
-  constraints->push_back(joint_position_lower);
-  constraints->push_back(joint_position_upper);
-  constraints->push_back(joint_velocity_lower);
-  constraints->push_back(joint_velocity_upper);
-  constraints->push_back(joint_torques_lower);
-  constraints->push_back(joint_torques_upper);
+  auto joint_position = std::make_shared<idocp::JointBoxLimit>(
+      robot_, idocp::JointVariable::Position);
+  auto joint_velocity = std::make_shared<idocp::JointBoxLimit>(
+      robot_, idocp::JointVariable::Velocity);
+  auto joint_torques = std::make_shared<idocp::JointBoxLimit>(
+      robot_, idocp::JointVariable::Torques);
+  constraints->push_back(joint_position);
+  constraints->push_back(joint_velocity);
+  constraints->push_back(joint_torques);
   return constraints;
 }
 
@@ -0,0 +1,355 @@
+#include "idocp/utils/perf_counters.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <cerrno>
+#include <iomanip>
+#include <algorithm>
+#include <initializer_list>
+#include <omp.h>
+
+#ifdef __linux__
+# include <linux/perf_event.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+
+namespace idocp {
+
+namespace {
+
+#ifdef __linux__
+void eventTypeAndConfig(const PerfCounterEvent event, unsigned int& type,
+                        unsigned long long& config) {
+  switch (event) {
+    case PerfCounterEvent::Cycles:
+      type = PERF_TYPE_HARDWARE;
+      config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case PerfCounterEvent::Instructions:
+      type = PERF_TYPE_HARDWARE;
+      config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case PerfCounterEvent::L1DMisses:
+      type = PERF_TYPE_HW_CACHE;
+      config = PERF_COUNT_HW_CACHE_L1D
+                | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      break;
+    case PerfCounterEvent::LLCMisses:
+      type = PERF_TYPE_HARDWARE;
+      config = PERF_COUNT_HW_CACHE_MISSES;
+      break;
+    default:
+      type = PERF_TYPE_HARDWARE;
+      config = PERF_COUNT_HW_BRANCH_MISSES;
+      break;
+  }
+}
+
+
+// Opens the counter of the event for the calling thread. Returns the file
+// descriptor, or -1 if the event is not available.
+int openCounter(const PerfCounterEvent event, const int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(perf_event_attr));
+  attr.size = sizeof(perf_event_attr);
+  eventTypeAndConfig(event, attr.type, attr.config);
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+                      | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1,
+                                  group_fd, 0));
+}
+
+
+// Opens the available events of is_event_available as a group for the
+// calling thread.
+std::vector<int> openGroup(const std::vector<bool>& is_event_available) {
+  std::vector<int> fds;
+  for (int i=0; i<PerfCounters::kNumEvents; ++i) {
+    if (!is_event_available[i]) continue;
+    const int group_fd = fds.empty() ? -1 : fds.front();
+    const int fd = openCounter(static_cast<PerfCounterEvent>(i), group_fd);
+    if (fd < 0) {
+      for (const auto e : fds) { ::close(e); }
+      return std::vector<int>();
+    }
+    fds.push_back(fd);
+  }
+  return fds;
+}
+#endif
+
+} // namespace
+
+
+PerfCounters::PerfCounters(const std::vector<std::string>& phase_names)
+  : phase_names_(phase_names),
+    fds_(),
+    is_event_available_(kNumEvents, false),
+    start_(),
+    stop_(),
+    counts_(phase_names.size(), std::vector<double>(kNumEvents, 0)),
+    num_samples_(phase_names.size(), 0) {
+}
+
+
+PerfCounters::PerfCounters()
+  : phase_names_(),
+    fds_(),
+    is_event_available_(kNumEvents, false),
+    start_(),
+    stop_(),
+    counts_(),
+    num_samples_() {
+}
+
+
+PerfCounters::~PerfCounters() {
+  close();
+}
+
+
+bool PerfCounters::open(const int nthreads) {
+  assert(nthreads > 0);
+  close();
+  is_event_available_.assign(kNumEvents, false);
+#ifdef __linux__
+  // Finds the available events on the calling thread.
+  std::vector<int> fds;
+  for (int i=0; i<kNumEvents; ++i) {
+    const int group_fd = fds.empty() ? -1 : fds.front();
+    const int fd = openCounter(static_cast<PerfCounterEvent>(i), group_fd);
+    if (fd >= 0) {
+      fds.push_back(fd);
+      is_event_available_[i] = true;
+    }
+    else if (fds.empty() && (errno == EACCES || errno == EPERM)) {
+      std::cerr << "perf_event_open() failed: " << std::strerror(errno)
+                << " (see /proc/sys/kernel/perf_event_paranoid)" << '\n';
+      return false;
+    }
+  }
+  if (fds.empty()) {
+    std::cerr << "hardware performance counters are not available" << '\n';
+    return false;
+  }
+  fds_.assign(nthreads, std::vector<int>());
+  fds_[0] = fds;
+  #pragma omp parallel num_threads(nthreads)
+  {
+    const int thread_num = omp_get_thread_num();
+    if (thread_num > 0 && thread_num < nthreads) {
+      fds_[thread_num] = openGroup(is_event_available_);
+    }
+  }
+  start_.assign(nthreads, std::vector<unsigned long long>(kNumEvents+2, 0));
+  stop_.assign(nthreads, std::vector<unsigned long long>(kNumEvents+2, 0));
+  return true;
+#else
+  std::cerr << "hardware performance counters are only supported on Linux!"
+            << '\n';
+  return false;
+#endif
+}
+
+
+void PerfCounters::close() {
+#ifdef __linux__
+  for (const auto& fds : fds_) {
+    for (const auto fd : fds) { ::close(fd); }
+  }
+#endif
+  fds_.clear();
+}
+
+
+bool PerfCounters::isAvailable() const {
+  return !fds_.empty();
+}
+
+
+bool PerfCounters::isAvailable(const PerfCounterEvent event) const {
+  return is_event_available_[static_cast<int>(event)];
+}
+
+
+void PerfCounters::reset() {
+  for (auto& e : counts_) {
+    std::fill(e.begin(), e.end(), 0);
+  }
+  std::fill(num_samples_.begin(), num_samples_.end(), 0);
+}
+
+
+int PerfCounters::numPhases() const {
+  return phase_names_.size();
+}
+
+
+const std::string& PerfCounters::phaseName(const int phase) const {
+  assert(phase >= 0);
+  assert(phase < numPhases());
+  return phase_names_[phase];
+}
+
+
+long long PerfCounters::numSamples(const int phase) const {
+  assert(phase >= 0);
+  assert(phase < numPhases());
+  return num_samples_[phase];
+}
+
+
+double PerfCounters::count(const int phase,
+                           const PerfCounterEvent event) const {
+  assert(phase >= 0);
+  assert(phase < numPhases());
+  return counts_[phase][static_cast<int>(event)];
+}
+
+
+void PerfCounters::readCounters(
+    std::vector<std::vector<unsigned long long>>& values) const {
+#ifdef __linux__
+  // nr, time enabled, time running, and the values of the group.
+  unsigned long long buffer[kNumEvents+3];
+  for (int i=0; i<static_cast<int>(fds_.size()); ++i) {
+    if (fds_[i].empty()) continue;
+    const ssize_t size = ::read(fds_[i].front(), buffer, sizeof(buffer));
+    if (size < static_cast<ssize_t>(3*sizeof(unsigned long long))) continue;
+    values[i][0] = buffer[1];
+    values[i][1] = buffer[2];
+    int index = 3;
+    for (int j=0; j<kNumEvents; ++j) {
+      if (is_event_available_[j]) {
+        values[i][j+2] = buffer[index];
+        ++index;
+      }
+    }
+  }
+#endif
+}
+
+
+void PerfCounters::accumulate(const int phase) {
+  assert(phase >= 0);
+  assert(phase < numPhases());
+  readCounters(stop_);
+  for (int i=0; i<static_cast<int>(fds_.size()); ++i) {
+    if (fds_[i].empty()) continue;
+    const double time_enabled = stop_[i][0] - start_[i][0];
+    const double time_running = stop_[i][1] - start_[i][1];
+    // Scales the counts if the group is multiplexed with other groups.
+    const double scale = (time_running > 0 && time_running < time_enabled)
+                          ? time_enabled / time_running : 1.0;
+    for (int j=0; j<kNumEvents; ++j) {
+      counts_[phase][j] += scale * (stop_[i][j+2] - start_[i][j+2]);
+    }
+  }
+  ++num_samples_[phase];
+}
+
+
+void PerfCounters::showInfo() const {
+  std::cout << "---------- Hardware performance counters ----------"
+            << std::endl;
+  if (std::none_of(is_event_available_.begin(), is_event_available_.end(),
+                   [](const bool e) { return e; })) {
+    std::cout << "not available" << std::endl;
+  }
+  const auto cycles = static_cast<int>(PerfCounterEvent::Cycles);
+  const auto instructions = static_cast<int>(PerfCounterEvent::Instructions);
+  std::cout << std::left << std::setw(28) << "phase";
+  for (int j=0; j<kNumEvents; ++j) {
+    std::cout << std::right << std::setw(14)
+              << eventName(static_cast<PerfCounterEvent>(j));
+  }
+  std::cout << std::right << std::setw(8) << "IPC" << std::endl;
+  for (int i=0; i<numPhases(); ++i) {
+    std::cout << std::left << std::setw(28) << phase_names_[i];
+    const double samples = (num_samples_[i] > 0) ? num_samples_[i] : 1;
+    for (int j=0; j<kNumEvents; ++j) {
+      if (is_event_available_[j]) {
+        std::cout << std::right << std::setw(14) << std::fixed
+                  << std::setprecision(0) << counts_[i][j] / samples;
+      }
+      else {
+        std::cout << std::right << std::setw(14) << "n/a";
+      }
+    }
+    if (is_event_available_[cycles] && is_event_available_[instructions]
+        && counts_[i][cycles] > 0) {
+      std::cout << std::right << std::setw(8) << std::setprecision(2)
+                << counts_[i][instructions] / counts_[i][cycles];
+    }
+    else {
+      std::cout << std::right << std::setw(8) << "n/a";
+    }
+    std::cout << std::endl;
+  }
+  std::cout.unsetf(std::ios::floatfield);
+  std::cout << std::setprecision(6) << std::left;
+  std::cout << "(counts per call summed over the threads; misses per kilo "
+            << "instructions below)" << std::endl;
+  if (is_event_available_[instructions]) {
+    for (int i=0; i<numPhases(); ++i) {
+      if (counts_[i][instructions] <= 0) continue;
+      std::cout << phase_names_[i] << ":";
+      for (const auto event : {PerfCounterEvent::L1DMisses,
+                               PerfCounterEvent::LLCMisses,
+                               PerfCounterEvent::BranchMisses}) {
+        const int j = static_cast<int>(event);
+        if (is_event_available_[j]) {
+          std::cout << " " << eventName(event) << " "
+                    << 1000.0 * counts_[i][j] / counts_[i][instructions];
+        }
+      }
+      std::cout << std::endl;
+    }
+  }
+  std::cout << "-----------------------------------" << std::endl;
+  std::cout << std::endl;
+}
+
+
+void PerfCounters::writeCSV(std::ostream& os) const {
+  os << "phase,samples";
+  for (int j=0; j<kNumEvents; ++j) {
+    os << "," << eventName(static_cast<PerfCounterEvent>(j));
+  }
+  os << '\n';
+  for (int i=0; i<numPhases(); ++i) {
+    os << phase_names_[i] << "," << num_samples_[i];
+    for (int j=0; j<kNumEvents; ++j) {
+      os << ",";
+      if (is_event_available_[j]) {
+        os << std::fixed << std::setprecision(0) << counts_[i][j];
+      }
+    }
+    os << '\n';
+  }
+  os.unsetf(std::ios::floatfield);
+  os << std::setprecision(6);
+}
+
+
+const char* PerfCounters::eventName(const PerfCounterEvent event) {
+  switch (event) {
+    case PerfCounterEvent::Cycles:
+      return "cycles";
+    case PerfCounterEvent::Instructions:
+      return "instructions";
+    case PerfCounterEvent::L1DMisses:
+      return "L1d-misses";
+    case PerfCounterEvent::LLCMisses:
+      return "LLC-misses";
+    default:
+      return "branch-misses";
+  }
+}
+
+} // namespace idocp
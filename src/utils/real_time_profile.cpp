@@ -0,0 +1,206 @@
+#include "idocp/utils/real_time_profile.hpp"
+
+#include <stdexcept>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+# include <pthread.h>
+# include <sched.h>
+# include <sys/mman.h>
+# include <malloc.h>
+# include <alloca.h>
+# include <unistd.h>
+#endif
+
+
+namespace idocp {
+
+namespace {
+
+#ifdef __linux__
+// Not inlined so that the stack is released on return.
+__attribute__((noinline)) void prefaultStack(const int size) {
+  volatile unsigned char* stack
+      = static_cast<volatile unsigned char*>(alloca(size));
+  const int page_size = sysconf(_SC_PAGESIZE);
+  for (int i=0; i<size; i+=page_size) {
+    stack[i] = 0;
+  }
+}
+#endif
+
+} // namespace
+
+
+RealTimeProfile::RealTimeProfile()
+  : lock_memory_(false),
+    cpus_(),
+    priority_(0),
+    stack_prefault_size_(256*1024) {
+}
+
+
+RealTimeProfile::~RealTimeProfile() {
+}
+
+
+void RealTimeProfile::setMemoryLocking(const bool lock_memory) {
+  lock_memory_ = lock_memory;
+}
+
+
+void RealTimeProfile::setCPUAffinity(const std::vector<int>& cpus) {
+  try {
+    for (const auto cpu : cpus) {
+      if (cpu < 0) {
+        throw std::out_of_range("invalid value: cpus must be non-negative!");
+      }
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  cpus_ = cpus;
+}
+
+
+void RealTimeProfile::setSchedulingPriority(const int priority) {
+  try {
+    if (priority < 0 || priority > 99) {
+      throw std::out_of_range("invalid value: priority must be in [0, 99]!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  priority_ = priority;
+}
+
+
+void RealTimeProfile::setStackPrefaultSize(const int size) {
+  try {
+    if (size < 0) {
+      throw std::out_of_range("invalid value: size must be non-negative!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  stack_prefault_size_ = size;
+}
+
+
+bool RealTimeProfile::memoryLocking() const {
+  return lock_memory_;
+}
+
+
+const std::vector<int>& RealTimeProfile::cpuAffinity() const {
+  return cpus_;
+}
+
+
+int RealTimeProfile::schedulingPriority() const {
+  return priority_;
+}
+
+
+int RealTimeProfile::stackPrefaultSize() const {
+  return stack_prefault_size_;
+}
+
+
+bool RealTimeProfile::applyToProcess() const {
+  if (!lock_memory_) {
+    return true;
+  }
+#ifdef __linux__
+  // Keeps the freed memory in the heap so that it is reused without page
+  // faults.
+  mallopt(M_TRIM_THRESHOLD, -1);
+  mallopt(M_MMAP_MAX, 0);
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+    std::cerr << "mlockall() failed: " << std::strerror(errno) << '\n';
+    return false;
+  }
+  return true;
+#else
+  std::cerr << "memory locking is only supported on Linux!" << '\n';
+  return false;
+#endif
+}
+
+
+bool RealTimeProfile::applyToThread(const int thread_num) const {
+  if (cpus_.empty() && priority_ == 0 && stack_prefault_size_ == 0) {
+    return true;
+  }
+#ifdef __linux__
+  bool success = true;
+  if (!cpus_.empty()) {
+    const int cpu = cpus_[thread_num % cpus_.size()];
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    const int err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                                           &cpu_set);
+    if (err != 0) {
+      std::cerr << "pthread_setaffinity_np() failed for CPU " << cpu << ": "
+                << std::strerror(err) << '\n';
+      success = false;
+    }
+  }
+  if (priority_ > 0) {
+    sched_param param;
+    param.sched_priority = priority_;
+    const int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (err != 0) {
+      std::cerr << "pthread_setschedparam() failed: " << std::strerror(err)
+                << '\n';
+      success = false;
+    }
+  }
+  if (stack_prefault_size_ > 0) {
+    prefaultStack(stack_prefault_size_);
+  }
+  return success;
+#else
+  std::cerr << "CPU affinity and scheduling priority are only supported on Linux!"
+            << '\n';
+  return false;
+#endif
+}
+
+
+void RealTimeProfile::showInfo() const {
+  std::cout << "---------- Real-time profile ----------" << std::endl;
+  std::cout << "memory locking: " << std::boolalpha << lock_memory_
+            << std::endl;
+  std::cout << "CPU affinity: ";
+  if (cpus_.empty()) {
+    std::cout << "none";
+  }
+  for (const auto cpu : cpus_) {
+    std::cout << cpu << " ";
+  }
+  std::cout << std::endl;
+  std::cout << "SCHED_FIFO priority: ";
+  if (priority_ > 0) {
+    std::cout << priority_ << std::endl;
+  }
+  else {
+    std::cout << "none" << std::endl;
+  }
+  std::cout << "stack prefault size: " << stack_prefault_size_ << "[bytes]"
+            << std::endl;
+  std::cout << "---------------------------------------" << std::endl;
+  std::cout << std::endl;
+}
+
+} // namespace idocp
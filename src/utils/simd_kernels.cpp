@@ -0,0 +1,132 @@
+#include "idocp/utils/simd_kernels.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+
+namespace idocp {
+namespace simd {
+
+namespace {
+
+bool isSupportedByCPU(const InstructionSet instruction_set) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  // Required since this is called by the static initialization.
+  __builtin_cpu_init();
+  switch (instruction_set) {
+    case InstructionSet::AVX2:
+      return (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"));
+    case InstructionSet::AVX512:
+      return __builtin_cpu_supports("avx512f");
+    default:
+      return true;
+  }
+#else
+  return (instruction_set == InstructionSet::Generic);
+#endif
+}
+
+
+const internal::KernelTable& kernelTable(
+    const InstructionSet instruction_set) {
+  switch (instruction_set) {
+#ifdef IDOCP_WITH_AVX512_KERNELS
+    case InstructionSet::AVX512:
+      return internal::avx512_kernel_table;
+#endif
+#ifdef IDOCP_WITH_AVX2_KERNELS
+    case InstructionSet::AVX2:
+      return internal::avx2_kernel_table;
+#endif
+    default:
+      return internal::generic_kernel_table;
+  }
+}
+
+
+const internal::KernelTable* selectKernelTable() {
+  const char* env = std::getenv("IDOCP_SIMD");
+  if (env != nullptr) {
+    for (const auto instruction_set : {InstructionSet::Generic,
+                                       InstructionSet::AVX2,
+                                       InstructionSet::AVX512}) {
+      if (std::strcmp(env, instructionSetName(instruction_set)) == 0
+          && isSupported(instruction_set)) {
+        return &kernelTable(instruction_set);
+      }
+    }
+  }
+  return &kernelTable(detectInstructionSet());
+}
+
+} // namespace
+
+
+namespace internal {
+
+const KernelTable* active_kernel_table = selectKernelTable();
+
+} // namespace internal
+
+
+bool isSupported(const InstructionSet instruction_set) {
+  switch (instruction_set) {
+    case InstructionSet::Generic:
+      return true;
+    case InstructionSet::AVX2:
+#ifdef IDOCP_WITH_AVX2_KERNELS
+      return isSupportedByCPU(InstructionSet::AVX2);
+#else
+      return false;
+#endif
+    case InstructionSet::AVX512:
+#ifdef IDOCP_WITH_AVX512_KERNELS
+      return isSupportedByCPU(InstructionSet::AVX512);
+#else
+      return false;
+#endif
+    default:
+      return false;
+  }
+}
+
+
+InstructionSet detectInstructionSet() {
+  if (isSupported(InstructionSet::AVX512)) {
+    return InstructionSet::AVX512;
+  }
+  if (isSupported(InstructionSet::AVX2)) {
+    return InstructionSet::AVX2;
+  }
+  return InstructionSet::Generic;
+}
+
+
+InstructionSet instructionSet() {
+  return internal::active_kernel_table->instruction_set;
+}
+
+
+bool setInstructionSet(const InstructionSet instruction_set) {
+  if (!isSupported(instruction_set)) {
+    return false;
+  }
+  internal::active_kernel_table = &kernelTable(instruction_set);
+  return true;
+}
+
+
+const char* instructionSetName(const InstructionSet instruction_set) {
+  switch (instruction_set) {
+    case InstructionSet::AVX2:
+      return "avx2";
+    case InstructionSet::AVX512:
+      return "avx512";
+    default:
+      return "generic";
+  }
+}
+
+} // namespace simd
+} // namespace idocp
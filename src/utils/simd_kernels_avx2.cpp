@@ -0,0 +1,264 @@
+// Compiled with -mavx2 -mfma. Only referenced by the dispatcher if the CPU
+// supports AVX2 and FMA. Everything in this file must have internal linkage
+// except the kernel table, and must not instantiate templates of Eigen or
+// std, since such code would be shared with the translation units compiled
+// for the generic instruction set.
+#ifdef IDOCP_WITH_AVX2_KERNELS
+
+#if !defined(__AVX2__) || !defined(__FMA__)
+# error "simd_kernels_avx2.cpp must be compiled with -mavx2 -mfma"
+#endif
+
+#include "idocp/utils/simd_kernels.hpp"
+
+#include <immintrin.h>
+
+
+namespace idocp {
+namespace simd {
+
+namespace {
+
+// Rows and columns of the micro kernel of gemmTN.
+constexpr int kMR = 8;
+constexpr int kNR = 4;
+// Rows and depth of the packed panel of A^T. kMC must be a multiple of kMR.
+constexpr int kMC = 32;
+constexpr int kKC = 128;
+
+
+inline int minInt(const int a, const int b) {
+  return (a < b) ? a : b;
+}
+
+
+void computeComplementarySlacknessAVX2(const int dim, const double barrier,
+                                       const double* slack, const double* dual,
+                                       double* cmpl) {
+  const __m256d barrier_v = _mm256_set1_pd(barrier);
+  int i = 0;
+  for (; i+4<=dim; i+=4) {
+    const __m256d s = _mm256_loadu_pd(slack+i);
+    const __m256d d = _mm256_loadu_pd(dual+i);
+    _mm256_storeu_pd(cmpl+i, _mm256_sub_pd(_mm256_mul_pd(s, d), barrier_v));
+  }
+  for (; i<dim; ++i) {
+    cmpl[i] = slack[i] * dual[i] - barrier;
+  }
+}
+
+
+void computeCondensingCoeffcientAVX2(const int dim, const double* slack,
+                                     const double* dual,
+                                     const double* residual,
+                                     const double* cmpl, double* cond) {
+  int i = 0;
+  for (; i+4<=dim; i+=4) {
+    const __m256d s = _mm256_loadu_pd(slack+i);
+    const __m256d d = _mm256_loadu_pd(dual+i);
+    const __m256d r = _mm256_loadu_pd(residual+i);
+    const __m256d c = _mm256_loadu_pd(cmpl+i);
+    _mm256_storeu_pd(cond+i,
+                     _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(d, r), c), s));
+  }
+  for (; i<dim; ++i) {
+    cond[i] = (dual[i] * residual[i] - cmpl[i]) / slack[i];
+  }
+}
+
+
+void computeDualDirectionAVX2(const int dim, const double* slack,
+                              const double* dual, const double* dslack,
+                              const double* cmpl, double* ddual) {
+  const __m256d zero = _mm256_setzero_pd();
+  int i = 0;
+  for (; i+4<=dim; i+=4) {
+    const __m256d s = _mm256_loadu_pd(slack+i);
+    const __m256d d = _mm256_loadu_pd(dual+i);
+    const __m256d ds = _mm256_loadu_pd(dslack+i);
+    const __m256d c = _mm256_loadu_pd(cmpl+i);
+    const __m256d num = _mm256_sub_pd(zero,
+                                      _mm256_add_pd(_mm256_mul_pd(d, ds), c));
+    _mm256_storeu_pd(ddual+i, _mm256_div_pd(num, s));
+  }
+  for (; i<dim; ++i) {
+    ddual[i] = - (dual[i] * dslack[i] + cmpl[i]) / slack[i];
+  }
+}
+
+
+double fractionToBoundaryAVX2(const int dim, const double fraction_rate,
+                              const double* vec, const double* dvec) {
+  const __m256d rate = _mm256_set1_pd(-fraction_rate);
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d one = _mm256_set1_pd(1.0);
+  __m256d min_v = one;
+  int i = 0;
+  for (; i+4<=dim; i+=4) {
+    const __m256d fraction_to_boundary
+        = _mm256_mul_pd(rate, _mm256_div_pd(_mm256_loadu_pd(vec+i),
+                                            _mm256_loadu_pd(dvec+i)));
+    const __m256d in_range
+        = _mm256_and_pd(_mm256_cmp_pd(fraction_to_boundary, zero, _CMP_GT_OQ),
+                        _mm256_cmp_pd(fraction_to_boundary, one, _CMP_LT_OQ));
+    min_v = _mm256_min_pd(min_v,
+                          _mm256_blendv_pd(one, fraction_to_boundary, in_range));
+  }
+  alignas(32) double min_array[4];
+  _mm256_store_pd(min_array, min_v);
+  double min_fraction_to_boundary = min_array[0];
+  for (int j=1; j<4; ++j) {
+    if (min_array[j] < min_fraction_to_boundary) {
+      min_fraction_to_boundary = min_array[j];
+    }
+  }
+  for (; i<dim; ++i) {
+    const double fraction_to_boundary = - fraction_rate * (vec[i]/dvec[i]);
+    if (fraction_to_boundary > 0 && fraction_to_boundary < 1) {
+      if (fraction_to_boundary < min_fraction_to_boundary) {
+        min_fraction_to_boundary = fraction_to_boundary;
+      }
+    }
+  }
+  return min_fraction_to_boundary;
+}
+
+
+// Packs A(0:kc, 0:mc)^T into the column-major mc_pad x kc panel At, whose
+// rows from mc to mc_pad are zero.
+inline void packTransposed(const int mc, const int mc_pad, const int kc,
+                           const double* A, const int lda, double* At) {
+  for (int i=0; i<mc; ++i) {
+    const double* a = A + i*lda;
+    for (int l=0; l<kc; ++l) {
+      At[l*mc_pad+i] = a[l];
+    }
+  }
+  for (int l=0; l<kc; ++l) {
+    for (int i=mc; i<mc_pad; ++i) {
+      At[l*mc_pad+i] = 0;
+    }
+  }
+}
+
+
+inline void storeColumn(const int rows, const double alpha, const double beta,
+                        __m256d c0, __m256d c1, double* c) {
+  const __m256d alpha_v = _mm256_set1_pd(alpha);
+  c0 = _mm256_mul_pd(alpha_v, c0);
+  c1 = _mm256_mul_pd(alpha_v, c1);
+  if (rows == kMR) {
+    if (beta != 0) {
+      const __m256d beta_v = _mm256_set1_pd(beta);
+      c0 = _mm256_fmadd_pd(beta_v, _mm256_loadu_pd(c), c0);
+      c1 = _mm256_fmadd_pd(beta_v, _mm256_loadu_pd(c+4), c1);
+    }
+    _mm256_storeu_pd(c, c0);
+    _mm256_storeu_pd(c+4, c1);
+  }
+  else {
+    alignas(32) double column[kMR];
+    _mm256_store_pd(column, c0);
+    _mm256_store_pd(column+4, c1);
+    for (int i=0; i<rows; ++i) {
+      c[i] = (beta == 0) ? column[i] : (column[i] + beta * c[i]);
+    }
+  }
+}
+
+
+// C(0:rows, 0:NC) = alpha * At(0:kMR, 0:kc) * B(0:kc, 0:NC) + beta * C.
+template <int NC>
+inline void microKernel(const int rows, const int kc, const double* At,
+                        const int ldat, const double* B, const int ldb,
+                        const double alpha, const double beta, double* C,
+                        const int ldc) {
+  __m256d c0[NC], c1[NC];
+  for (int j=0; j<NC; ++j) {
+    c0[j] = _mm256_setzero_pd();
+    c1[j] = _mm256_setzero_pd();
+  }
+  for (int l=0; l<kc; ++l) {
+    const __m256d a0 = _mm256_load_pd(At+l*ldat);
+    const __m256d a1 = _mm256_load_pd(At+l*ldat+4);
+    for (int j=0; j<NC; ++j) {
+      const __m256d b = _mm256_broadcast_sd(B+j*ldb+l);
+      c0[j] = _mm256_fmadd_pd(a0, b, c0[j]);
+      c1[j] = _mm256_fmadd_pd(a1, b, c1[j]);
+    }
+  }
+  for (int j=0; j<NC; ++j) {
+    storeColumn(rows, alpha, beta, c0[j], c1[j], C+j*ldc);
+  }
+}
+
+
+void gemmTNAVX2(const int m, const int n, const int k, const double alpha,
+                const double* A, const int lda, const double* B, const int ldb,
+                const double beta, double* C, const int ldc) {
+  if (k == 0) {
+    for (int j=0; j<n; ++j) {
+      for (int i=0; i<m; ++i) {
+        C[j*ldc+i] = (beta == 0) ? 0 : beta * C[j*ldc+i];
+      }
+    }
+    return;
+  }
+  alignas(32) double At[kMC*kKC];
+  for (int i0=0; i0<m; i0+=kMC) {
+    const int mc = minInt(kMC, m-i0);
+    const int mc_pad = ((mc+kMR-1)/kMR) * kMR;
+    for (int l0=0; l0<k; l0+=kKC) {
+      const int kc = minInt(kKC, k-l0);
+      const double beta_panel = (l0 == 0) ? beta : 1.0;
+      packTransposed(mc, mc_pad, kc, A+i0*lda+l0, lda, At);
+      for (int j0=0; j0<n; j0+=kNR) {
+        const int nc = minInt(kNR, n-j0);
+        const double* Bj = B + j0*ldb + l0;
+        double* Cj = C + j0*ldc + i0;
+        for (int i=0; i<mc; i+=kMR) {
+          const int rows = minInt(kMR, mc-i);
+          switch (nc) {
+            case 4:
+              microKernel<4>(rows, kc, At+i, mc_pad, Bj, ldb, alpha,
+                             beta_panel, Cj+i, ldc);
+              break;
+            case 3:
+              microKernel<3>(rows, kc, At+i, mc_pad, Bj, ldb, alpha,
+                             beta_panel, Cj+i, ldc);
+              break;
+            case 2:
+              microKernel<2>(rows, kc, At+i, mc_pad, Bj, ldb, alpha,
+                             beta_panel, Cj+i, ldc);
+              break;
+            default:
+              microKernel<1>(rows, kc, At+i, mc_pad, Bj, ldb, alpha,
+                             beta_panel, Cj+i, ldc);
+              break;
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+
+namespace internal {
+
+const KernelTable avx2_kernel_table = {
+  InstructionSet::AVX2,
+  computeComplementarySlacknessAVX2,
+  computeCondensingCoeffcientAVX2,
+  computeDualDirectionAVX2,
+  fractionToBoundaryAVX2,
+  gemmTNAVX2
+};
+
+} // namespace internal
+
+} // namespace simd
+} // namespace idocp
+
+#endif // IDOCP_WITH_AVX2_KERNELS
@@ -0,0 +1,241 @@
+// Compiled with -mavx512f. Only referenced by the dispatcher if the CPU
+// supports AVX-512F. Everything in this file must have internal linkage
+// except the kernel table, and must not instantiate templates of Eigen or
+// std, since such code would be shared with the translation units compiled
+// for the generic instruction set.
+#ifdef IDOCP_WITH_AVX512_KERNELS
+
+#if !defined(__AVX512F__)
+# error "simd_kernels_avx512.cpp must be compiled with -mavx512f"
+#endif
+
+#include "idocp/utils/simd_kernels.hpp"
+
+#include <immintrin.h>
+
+
+namespace idocp {
+namespace simd {
+
+namespace {
+
+// Rows and columns of the micro kernel of gemmTN.
+constexpr int kMR = 16;
+constexpr int kNR = 4;
+// Rows and depth of the packed panel of A^T. kMC must be a multiple of kMR.
+constexpr int kMC = 32;
+constexpr int kKC = 128;
+
+
+inline int minInt(const int a, const int b) {
+  return (a < b) ? a : b;
+}
+
+
+inline __mmask8 tailMask(const int size) {
+  return static_cast<__mmask8>((1u << size) - 1u);
+}
+
+
+void computeComplementarySlacknessAVX512(const int dim, const double barrier,
+                                         const double* slack,
+                                         const double* dual, double* cmpl) {
+  const __m512d barrier_v = _mm512_set1_pd(barrier);
+  for (int i=0; i<dim; i+=8) {
+    const __mmask8 mask = tailMask(minInt(8, dim-i));
+    const __m512d s = _mm512_maskz_loadu_pd(mask, slack+i);
+    const __m512d d = _mm512_maskz_loadu_pd(mask, dual+i);
+    _mm512_mask_storeu_pd(cmpl+i, mask,
+                          _mm512_sub_pd(_mm512_mul_pd(s, d), barrier_v));
+  }
+}
+
+
+void computeCondensingCoeffcientAVX512(const int dim, const double* slack,
+                                       const double* dual,
+                                       const double* residual,
+                                       const double* cmpl, double* cond) {
+  for (int i=0; i<dim; i+=8) {
+    const __mmask8 mask = tailMask(minInt(8, dim-i));
+    const __m512d s = _mm512_maskz_loadu_pd(mask, slack+i);
+    const __m512d d = _mm512_maskz_loadu_pd(mask, dual+i);
+    const __m512d r = _mm512_maskz_loadu_pd(mask, residual+i);
+    const __m512d c = _mm512_maskz_loadu_pd(mask, cmpl+i);
+    _mm512_mask_storeu_pd(cond+i, mask,
+                          _mm512_maskz_div_pd(mask, _mm512_sub_pd(
+                              _mm512_mul_pd(d, r), c), s));
+  }
+}
+
+
+void computeDualDirectionAVX512(const int dim, const double* slack,
+                                const double* dual, const double* dslack,
+                                const double* cmpl, double* ddual) {
+  const __m512d zero = _mm512_setzero_pd();
+  for (int i=0; i<dim; i+=8) {
+    const __mmask8 mask = tailMask(minInt(8, dim-i));
+    const __m512d s = _mm512_maskz_loadu_pd(mask, slack+i);
+    const __m512d d = _mm512_maskz_loadu_pd(mask, dual+i);
+    const __m512d ds = _mm512_maskz_loadu_pd(mask, dslack+i);
+    const __m512d c = _mm512_maskz_loadu_pd(mask, cmpl+i);
+    const __m512d num = _mm512_sub_pd(zero,
+                                      _mm512_add_pd(_mm512_mul_pd(d, ds), c));
+    _mm512_mask_storeu_pd(ddual+i, mask, _mm512_maskz_div_pd(mask, num, s));
+  }
+}
+
+
+double fractionToBoundaryAVX512(const int dim, const double fraction_rate,
+                                const double* vec, const double* dvec) {
+  const __m512d rate = _mm512_set1_pd(-fraction_rate);
+  const __m512d zero = _mm512_setzero_pd();
+  const __m512d one = _mm512_set1_pd(1.0);
+  __m512d min_v = one;
+  for (int i=0; i<dim; i+=8) {
+    const __mmask8 mask = tailMask(minInt(8, dim-i));
+    const __m512d fraction_to_boundary
+        = _mm512_mul_pd(rate,
+                        _mm512_maskz_div_pd(mask,
+                                            _mm512_maskz_loadu_pd(mask, vec+i),
+                                            _mm512_maskz_loadu_pd(mask, dvec+i)));
+    const __mmask8 in_range
+        = _mm512_mask_cmp_pd_mask(
+              _mm512_mask_cmp_pd_mask(mask, fraction_to_boundary, zero,
+                                      _CMP_GT_OQ),
+              fraction_to_boundary, one, _CMP_LT_OQ);
+    min_v = _mm512_mask_min_pd(min_v, in_range, min_v, fraction_to_boundary);
+  }
+  return _mm512_reduce_min_pd(min_v);
+}
+
+
+// Packs A(0:kc, 0:mc)^T into the column-major mc_pad x kc panel At, whose
+// rows from mc to mc_pad are zero.
+inline void packTransposed(const int mc, const int mc_pad, const int kc,
+                           const double* A, const int lda, double* At) {
+  for (int i=0; i<mc; ++i) {
+    const double* a = A + i*lda;
+    for (int l=0; l<kc; ++l) {
+      At[l*mc_pad+i] = a[l];
+    }
+  }
+  for (int l=0; l<kc; ++l) {
+    for (int i=mc; i<mc_pad; ++i) {
+      At[l*mc_pad+i] = 0;
+    }
+  }
+}
+
+
+inline void storeColumn(const int rows, const double alpha, const double beta,
+                        __m512d c0, __m512d c1, double* c) {
+  const __mmask8 mask0 = tailMask(minInt(8, rows));
+  const __mmask8 mask1 = (rows > 8) ? tailMask(rows-8) : 0;
+  const __m512d alpha_v = _mm512_set1_pd(alpha);
+  c0 = _mm512_mul_pd(alpha_v, c0);
+  c1 = _mm512_mul_pd(alpha_v, c1);
+  if (beta != 0) {
+    const __m512d beta_v = _mm512_set1_pd(beta);
+    c0 = _mm512_fmadd_pd(beta_v, _mm512_maskz_loadu_pd(mask0, c), c0);
+    c1 = _mm512_fmadd_pd(beta_v, _mm512_maskz_loadu_pd(mask1, c+8), c1);
+  }
+  _mm512_mask_storeu_pd(c, mask0, c0);
+  _mm512_mask_storeu_pd(c+8, mask1, c1);
+}
+
+
+// C(0:rows, 0:NC) = alpha * At(0:kMR, 0:kc) * B(0:kc, 0:NC) + beta * C.
+template <int NC>
+inline void microKernel(const int rows, const int kc, const double* At,
+                        const int ldat, const double* B, const int ldb,
+                        const double alpha, const double beta, double* C,
+                        const int ldc) {
+  __m512d c0[NC], c1[NC];
+  for (int j=0; j<NC; ++j) {
+    c0[j] = _mm512_setzero_pd();
+    c1[j] = _mm512_setzero_pd();
+  }
+  for (int l=0; l<kc; ++l) {
+    const __m512d a0 = _mm512_load_pd(At+l*ldat);
+    const __m512d a1 = _mm512_load_pd(At+l*ldat+8);
+    for (int j=0; j<NC; ++j) {
+      const __m512d b = _mm512_set1_pd(B[j*ldb+l]);
+      c0[j] = _mm512_fmadd_pd(a0, b, c0[j]);
+      c1[j] = _mm512_fmadd_pd(a1, b, c1[j]);
+    }
+  }
+  for (int j=0; j<NC; ++j) {
+    storeColumn(rows, alpha, beta, c0[j], c1[j], C+j*ldc);
+  }
+}
+
+
+void gemmTNAVX512(const int m, const int n, const int k, const double alpha,
+                  const double* A, const int lda, const double* B,
+                  const int ldb, const double beta, double* C, const int ldc) {
+  if (k == 0) {
+    for (int j=0; j<n; ++j) {
+      for (int i=0; i<m; ++i) {
+        C[j*ldc+i] = (beta == 0) ? 0 : beta * C[j*ldc+i];
+      }
+    }
+    return;
+  }
+  alignas(64) double At[kMC*kKC];
+  for (int i0=0; i0<m; i0+=kMC) {
+    const int mc = minInt(kMC, m-i0);
+    const int mc_pad = ((mc+kMR-1)/kMR) * kMR;
+    for (int l0=0; l0<k; l0+=kKC) {
+      const int kc = minInt(kKC, k-l0);
+      const double beta_panel = (l0 == 0) ? beta : 1.0;
+      packTransposed(mc, mc_pad, kc, A+i0*lda+l0, lda, At);
+      for (int j0=0; j0<n; j0+=kNR) {
+        const int nc = minInt(kNR, n-j0);
+        const double* Bj = B + j0*ldb + l0;
+        double* Cj = C + j0*ldc + i0;
+        for (int i=0; i<mc; i+=kMR) {
+          const int rows = minInt(kMR, mc-i);
+          switch (nc) {
+            case 4:
+              microKernel<4>(rows, kc, At+i, mc_pad, Bj, ldb, alpha,
+                             beta_panel, Cj+i, ldc);
+              break;
+            case 3:
+              microKernel<3>(rows, kc, At+i, mc_pad, Bj, ldb, alpha,
+                             beta_panel, Cj+i, ldc);
+              break;
+            case 2:
+              microKernel<2>(rows, kc, At+i, mc_pad, Bj, ldb, alpha,
+                             beta_panel, Cj+i, ldc);
+              break;
+            default:
+              microKernel<1>(rows, kc, At+i, mc_pad, Bj, ldb, alpha,
+                             beta_panel, Cj+i, ldc);
+              break;
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+
+namespace internal {
+
+const KernelTable avx512_kernel_table = {
+  InstructionSet::AVX512,
+  computeComplementarySlacknessAVX512,
+  computeCondensingCoeffcientAVX512,
+  computeDualDirectionAVX512,
+  fractionToBoundaryAVX512,
+  gemmTNAVX512
+};
+
+} // namespace internal
+
+} // namespace simd
+} // namespace idocp
+
+#endif // IDOCP_WITH_AVX512_KERNELS
@@ -0,0 +1,95 @@
+#include "idocp/utils/simd_kernels.hpp"
+
+#include "Eigen/Core"
+
+
+namespace idocp {
+namespace simd {
+
+namespace {
+
+using ArrayMap = Eigen::Map<Eigen::ArrayXd>;
+using ConstArrayMap = Eigen::Map<const Eigen::ArrayXd>;
+using MatrixMap = Eigen::Map<Eigen::MatrixXd, 0, Eigen::OuterStride<>>;
+using ConstMatrixMap
+    = Eigen::Map<const Eigen::MatrixXd, 0, Eigen::OuterStride<>>;
+
+
+void computeComplementarySlacknessGeneric(const int dim, const double barrier,
+                                          const double* slack,
+                                          const double* dual, double* cmpl) {
+  ArrayMap(cmpl, dim)
+      = ConstArrayMap(slack, dim) * ConstArrayMap(dual, dim) - barrier;
+}
+
+
+void computeCondensingCoeffcientGeneric(const int dim, const double* slack,
+                                        const double* dual,
+                                        const double* residual,
+                                        const double* cmpl, double* cond) {
+  ArrayMap(cond, dim)
+      = (ConstArrayMap(dual, dim) * ConstArrayMap(residual, dim)
+          - ConstArrayMap(cmpl, dim)) / ConstArrayMap(slack, dim);
+}
+
+
+void computeDualDirectionGeneric(const int dim, const double* slack,
+                                 const double* dual, const double* dslack,
+                                 const double* cmpl, double* ddual) {
+  ArrayMap(ddual, dim)
+      = - (ConstArrayMap(dual, dim) * ConstArrayMap(dslack, dim)
+            + ConstArrayMap(cmpl, dim)) / ConstArrayMap(slack, dim);
+}
+
+
+double fractionToBoundaryGeneric(const int dim, const double fraction_rate,
+                                 const double* vec, const double* dvec) {
+  double min_fraction_to_boundary = 1;
+  for (int i=0; i<dim; ++i) {
+    const double fraction_to_boundary = - fraction_rate * (vec[i]/dvec[i]);
+    if (fraction_to_boundary > 0 && fraction_to_boundary < 1) {
+      if (fraction_to_boundary < min_fraction_to_boundary) {
+        min_fraction_to_boundary = fraction_to_boundary;
+      }
+    }
+  }
+  return min_fraction_to_boundary;
+}
+
+
+void gemmTNGeneric(const int m, const int n, const int k, const double alpha,
+                   const double* A, const int lda, const double* B,
+                   const int ldb, const double beta, double* C,
+                   const int ldc) {
+  const ConstMatrixMap A_map(A, k, m, Eigen::OuterStride<>(lda));
+  const ConstMatrixMap B_map(B, k, n, Eigen::OuterStride<>(ldb));
+  MatrixMap C_map(C, m, n, Eigen::OuterStride<>(ldc));
+  if (beta == 0) {
+    C_map.noalias() = alpha * A_map.transpose() * B_map;
+  }
+  else {
+    if (beta != 1) {
+      C_map *= beta;
+    }
+    C_map.noalias() += alpha * A_map.transpose() * B_map;
+  }
+}
+
+} // namespace
+
+
+namespace internal {
+
+const KernelTable generic_kernel_table = {
+  InstructionSet::Generic,
+  computeComplementarySlacknessGeneric,
+  computeCondensingCoeffcientGeneric,
+  computeDualDirectionGeneric,
+  fractionToBoundaryGeneric,
+  gemmTNGeneric
+};
+
+} // namespace internal
+
+} // namespace simd
+} // namespace idocp
@@ -0,0 +1,599 @@
+#include "idocp/utils/warm_start_library.hpp"
+
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace idocp {
+
+namespace {
+// The file consists of the magic followed by an array of doubles, i.e., the
+// header, the index of the entries, and the points. The integers are stored
+// as doubles so that the points can be read in place.
+constexpr char kLibraryMagic[8] = {'I', 'D', 'O', 'C', 'P', 'W', 'S', 'L'};
+constexpr int kLibraryVersion = 1;
+constexpr int kHeaderSize = 7;
+// Offsets in a point: time, dimensions of the four levels of the constraints
+// data, and then the activities of the contacts.
+constexpr int kPointTime = 0;
+constexpr int kPointLevelDims = 1;
+constexpr int kPointContacts = 5;
+
+int levelDim(const std::vector<ConstraintComponentData>& data) {
+  int dim = 0;
+  for (const auto& e : data) {
+    dim += e.slack.size();
+  }
+  return dim;
+}
+
+int levelDims(const double* point) {
+  return (point[kPointLevelDims] + point[kPointLevelDims+1]
+          + point[kPointLevelDims+2] + point[kPointLevelDims+3]);
+}
+
+void appendLevel(const std::vector<ConstraintComponentData>& data,
+                 std::vector<double>& point) {
+  for (const auto& e : data) {
+    point.insert(point.end(), e.slack.data(), e.slack.data()+e.slack.size());
+    point.insert(point.end(), e.dual.data(), e.dual.data()+e.dual.size());
+  }
+}
+
+template <typename VectorType>
+void appendVector(const Eigen::MatrixBase<VectorType>& vec,
+                  std::vector<double>& point) {
+  for (int i=0; i<vec.size(); ++i) {
+    point.push_back(vec.coeff(i));
+  }
+}
+
+void writeDoubles(std::ostream& os, const double* data, const std::size_t size) {
+  os.write(reinterpret_cast<const char*>(data), size*sizeof(double));
+}
+
+void writeDouble(std::ostream& os, const double value) {
+  writeDoubles(os, &value, 1);
+}
+} // namespace
+
+
+WarmStartLibraryBuilder::WarmStartLibraryBuilder(const Robot& robot,
+                                                 const int dim_command)
+  : dimq_(robot.dimq()),
+    dimv_(robot.dimv()),
+    dimu_(robot.dimu()),
+    max_point_contacts_(robot.maxPointContacts()),
+    dim_command_(dim_command),
+    keys_(),
+    points_() {
+  try {
+    if (dim_command < 0) {
+      throw std::out_of_range("invalid value: dim_command must be non-negative!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+
+WarmStartLibraryBuilder::WarmStartLibraryBuilder()
+  : dimq_(0),
+    dimv_(0),
+    dimu_(0),
+    max_point_contacts_(0),
+    dim_command_(0),
+    keys_(),
+    points_() {
+}
+
+
+WarmStartLibraryBuilder::~WarmStartLibraryBuilder() {
+}
+
+
+void WarmStartLibraryBuilder::addEntry(const WarmStartKey& key) {
+  try {
+    if (key.command.size() != dim_command_) {
+      throw std::invalid_argument(
+          "invalid argument: size of the command must be "
+          + std::to_string(dim_command_) + "!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  keys_.push_back(key);
+  points_.emplace_back();
+}
+
+
+void WarmStartLibraryBuilder::addPoint(const double t, const SplitSolution& s,
+                                       const ConstraintsData& data) {
+  assert(!points_.empty());
+  assert(points_.back().empty() || t >= points_.back().back()[kPointTime]);
+  assert(s.q.size() == dimq_);
+  assert(s.v.size() == dimv_);
+  assert(s.u.size() == dimu_);
+  assert(s.f.size() == max_point_contacts_);
+  std::vector<double> point;
+  point.push_back(t);
+  point.push_back(levelDim(data.position_level_data));
+  point.push_back(levelDim(data.velocity_level_data));
+  point.push_back(levelDim(data.acceleration_level_data));
+  point.push_back(levelDim(data.impulse_level_data));
+  for (int i=0; i<max_point_contacts_; ++i) {
+    point.push_back(s.isContactActive(i) ? 1 : 0);
+  }
+  appendVector(s.q, point);
+  appendVector(s.v, point);
+  appendVector(s.a, point);
+  appendVector(s.u, point);
+  for (const auto& f : s.f) {
+    appendVector(f, point);
+  }
+  appendVector(s.lmd, point);
+  appendVector(s.gmm, point);
+  appendLevel(data.position_level_data, point);
+  appendLevel(data.velocity_level_data, point);
+  appendLevel(data.acceleration_level_data, point);
+  appendLevel(data.impulse_level_data, point);
+  points_.back().push_back(std::move(point));
+}
+
+
+void WarmStartLibraryBuilder::addPoint(const double t, const SplitSolution& s) {
+  addPoint(t, s, ConstraintsData());
+}
+
+
+bool WarmStartLibraryBuilder::save(const std::string& file_name) const {
+  std::ofstream ofs(file_name, std::ios::out | std::ios::binary);
+  if (!ofs) {
+    std::cerr << "cannot open " << file_name << '\n';
+    return false;
+  }
+  const int num_entries = keys_.size();
+  const std::size_t index_stride = dim_command_ + 4;
+  // Offsets in doubles from the end of the magic.
+  std::size_t offset = kHeaderSize + num_entries * index_stride;
+  std::vector<std::size_t> table_offset(num_entries);
+  for (int j=0; j<num_entries; ++j) {
+    table_offset[j] = offset;
+    offset += 2 * points_[j].size();
+    for (const auto& point : points_[j]) {
+      offset += point.size();
+    }
+  }
+  ofs.write(kLibraryMagic, sizeof(kLibraryMagic));
+  writeDouble(ofs, kLibraryVersion);
+  writeDouble(ofs, dimq_);
+  writeDouble(ofs, dimv_);
+  writeDouble(ofs, dimu_);
+  writeDouble(ofs, max_point_contacts_);
+  writeDouble(ofs, dim_command_);
+  writeDouble(ofs, num_entries);
+  for (int j=0; j<num_entries; ++j) {
+    writeDouble(ofs, keys_[j].gait);
+    writeDouble(ofs, keys_[j].phase);
+    writeDoubles(ofs, keys_[j].command.data(), dim_command_);
+    writeDouble(ofs, points_[j].size());
+    writeDouble(ofs, table_offset[j]);
+  }
+  for (int j=0; j<num_entries; ++j) {
+    // Table of the offsets and the sizes of the points.
+    std::size_t point_offset = table_offset[j] + 2 * points_[j].size();
+    for (const auto& point : points_[j]) {
+      writeDouble(ofs, point_offset);
+      writeDouble(ofs, point.size());
+      point_offset += point.size();
+    }
+    for (const auto& point : points_[j]) {
+      writeDoubles(ofs, point.data(), point.size());
+    }
+  }
+  return static_cast<bool>(ofs);
+}
+
+
+int WarmStartLibraryBuilder::numEntries() const {
+  return keys_.size();
+}
+
+
+WarmStartLibrary::WarmStartLibrary(const std::string& file_name)
+  : WarmStartLibrary() {
+  try {
+    if (!open(file_name)) {
+      throw std::runtime_error("cannot open the warm-start library "
+                               + file_name + "!");
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+
+WarmStartLibrary::WarmStartLibrary()
+  : mapping_(nullptr),
+    mapping_size_(0),
+    dimq_(0),
+    dimv_(0),
+    dimu_(0),
+    max_point_contacts_(0),
+    dim_command_(0),
+    num_entries_(0),
+    index_(nullptr) {
+}
+
+
+WarmStartLibrary::~WarmStartLibrary() {
+  close();
+}
+
+
+WarmStartLibrary::WarmStartLibrary(WarmStartLibrary&& other) noexcept
+  : WarmStartLibrary() {
+  *this = std::move(other);
+}
+
+
+WarmStartLibrary& WarmStartLibrary::operator=(
+    WarmStartLibrary&& other) noexcept {
+  if (this != &other) {
+    close();
+    mapping_ = other.mapping_;
+    mapping_size_ = other.mapping_size_;
+    dimq_ = other.dimq_;
+    dimv_ = other.dimv_;
+    dimu_ = other.dimu_;
+    max_point_contacts_ = other.max_point_contacts_;
+    dim_command_ = other.dim_command_;
+    num_entries_ = other.num_entries_;
+    index_ = other.index_;
+    other.mapping_ = nullptr;
+    other.mapping_size_ = 0;
+    other.num_entries_ = 0;
+    other.index_ = nullptr;
+  }
+  return *this;
+}
+
+
+bool WarmStartLibrary::open(const std::string& file_name) {
+  close();
+  const int fd = ::open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::cerr << "cannot open " << file_name << '\n';
+    return false;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+    std::cerr << "cannot stat " << file_name << '\n';
+    ::close(fd);
+    return false;
+  }
+  const std::size_t size = st.st_size;
+  void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping keeps the file referenced after the descriptor is closed.
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    std::cerr << "cannot map " << file_name << '\n';
+    return false;
+  }
+  // The entries are looked up randomly, so the read-ahead is not useful.
+  ::madvise(mapping, size, MADV_RANDOM);
+  mapping_ = mapping;
+  mapping_size_ = size;
+  try {
+    const std::size_t num_doubles
+        = (size - sizeof(kLibraryMagic)) / sizeof(double);
+    if (size < sizeof(kLibraryMagic) + kHeaderSize*sizeof(double)
+        || std::memcmp(mapping, kLibraryMagic, sizeof(kLibraryMagic)) != 0) {
+      throw std::runtime_error("the file is not a warm-start library!");
+    }
+    const double* header = reinterpret_cast<const double*>(
+        static_cast<const char*>(mapping) + sizeof(kLibraryMagic));
+    if (static_cast<int>(header[0]) != kLibraryVersion) {
+      throw std::runtime_error("unsupported warm-start library version "
+                               + std::to_string(static_cast<int>(header[0]))
+                               + "!");
+    }
+    dimq_ = header[1];
+    dimv_ = header[2];
+    dimu_ = header[3];
+    max_point_contacts_ = header[4];
+    dim_command_ = header[5];
+    num_entries_ = header[6];
+    index_ = header + kHeaderSize;
+    const std::size_t index_stride = dim_command_ + 4;
+    if (num_entries_ < 0 || dim_command_ < 0
+        || kHeaderSize + num_entries_*index_stride > num_doubles) {
+      throw std::runtime_error("the index of the warm-start library is broken!");
+    }
+    // Checks only the index and the tables of the points so that the points
+    // themselves are not loaded.
+    const std::size_t min_point_size
+        = kPointContacts + max_point_contacts_ + dimq_ + 4*dimv_ + dimu_
+            + 3*max_point_contacts_;
+    for (int j=0; j<num_entries_; ++j) {
+      const double* entry_index = index_ + j*index_stride;
+      const double num_points = entry_index[dim_command_+2];
+      const double table_offset = entry_index[dim_command_+3];
+      if (num_points < 0 || table_offset < 0
+          || table_offset + 2*num_points > num_doubles) {
+        throw std::runtime_error("the index of the warm-start library is broken!");
+      }
+      const double* table = header + static_cast<std::size_t>(table_offset);
+      for (int k=0; k<static_cast<int>(num_points); ++k) {
+        if (table[2*k] < 0 || table[2*k+1] < min_point_size
+            || table[2*k] + table[2*k+1] > num_doubles) {
+          throw std::runtime_error("the points of the warm-start library are broken!");
+        }
+      }
+    }
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    close();
+    return false;
+  }
+  return true;
+}
+
+
+void WarmStartLibrary::close() {
+  if (mapping_ != nullptr) {
+    ::munmap(mapping_, mapping_size_);
+  }
+  mapping_ = nullptr;
+  mapping_size_ = 0;
+  num_entries_ = 0;
+  index_ = nullptr;
+}
+
+
+bool WarmStartLibrary::isOpen() const {
+  return (mapping_ != nullptr);
+}
+
+
+bool WarmStartLibrary::isConsistent(const Robot& robot) const {
+  return (isOpen() && dimq_ == robot.dimq() && dimv_ == robot.dimv()
+          && dimu_ == robot.dimu()
+          && max_point_contacts_ == robot.maxPointContacts());
+}
+
+
+int WarmStartLibrary::numEntries() const {
+  return num_entries_;
+}
+
+
+int WarmStartLibrary::dimCommand() const {
+  return dim_command_;
+}
+
+
+WarmStartKey WarmStartLibrary::key(const int entry) const {
+  assert(entry >= 0);
+  assert(entry < num_entries_);
+  const double* entry_index = index_ + entry*(dim_command_+4);
+  WarmStartKey key;
+  key.gait = entry_index[0];
+  key.phase = entry_index[1];
+  key.command = Eigen::Map<const Eigen::VectorXd>(entry_index+2, dim_command_);
+  return key;
+}
+
+
+int WarmStartLibrary::numPoints(const int entry) const {
+  assert(entry >= 0);
+  assert(entry < num_entries_);
+  return index_[entry*(dim_command_+4)+dim_command_+2];
+}
+
+
+double WarmStartLibrary::horizonLength(const int entry) const {
+  const int num_points = numPoints(entry);
+  if (num_points == 0) {
+    return 0;
+  }
+  return point(entry, num_points-1)[kPointTime];
+}
+
+
+int WarmStartLibrary::findNearest(const WarmStartKey& key,
+                                  const double phase_weight) const {
+  assert(key.command.size() == dim_command_);
+  assert(phase_weight >= 0);
+  int nearest = -1;
+  double min_distance = std::numeric_limits<double>::infinity();
+  for (int j=0; j<num_entries_; ++j) {
+    const double* entry_index = index_ + j*(dim_command_+4);
+    if (static_cast<int>(entry_index[0]) != key.gait
+        || entry_index[dim_command_+2] < 1) {
+      continue;
+    }
+    double phase_distance = std::abs(entry_index[1] - key.phase);
+    phase_distance -= std::floor(phase_distance);
+    phase_distance = std::min(phase_distance, 1.0-phase_distance);
+    const double distance
+        = phase_weight * phase_distance
+            + (Eigen::Map<const Eigen::VectorXd>(entry_index+2, dim_command_)
+                - key.command).norm();
+    if (distance < min_distance) {
+      nearest = j;
+      min_distance = distance;
+    }
+  }
+  return nearest;
+}
+
+
+void WarmStartLibrary::interpolate(const Robot& robot, const int entry,
+                                   const double t, SplitSolution& s) const {
+  assert(isConsistent(robot));
+  int k0, k1;
+  double ratio;
+  findInterval(entry, t, k0, k1, ratio);
+  const double* p0 = point(entry, k0);
+  const double* p1 = point(entry, k1);
+  const int mc = max_point_contacts_;
+  int offset = kPointContacts + mc;
+  auto lerp = [&](const int size) -> Eigen::VectorXd {
+    return ((1-ratio) * Eigen::Map<const Eigen::VectorXd>(p0+offset, size)
+              + ratio * Eigen::Map<const Eigen::VectorXd>(p1+offset, size));
+  };
+  const Eigen::Map<const Eigen::VectorXd> q0(p0+offset, dimq_);
+  const Eigen::Map<const Eigen::VectorXd> q1(p1+offset, dimq_);
+  Eigen::VectorXd qdiff = Eigen::VectorXd::Zero(dimv_);
+  robot.subtractConfiguration(q1, q0, qdiff);
+  robot.integrateConfiguration(q0, qdiff, ratio, s.q);
+  offset += dimq_;
+  s.v = lerp(dimv_);
+  offset += dimv_;
+  s.a = lerp(dimv_);
+  offset += dimv_;
+  s.u = lerp(dimu_);
+  offset += dimu_;
+  for (int i=0; i<mc; ++i) {
+    const bool is_active0 = (p0[kPointContacts+i] != 0);
+    const bool is_active1 = (p1[kPointContacts+i] != 0);
+    if (is_active0 && !is_active1) {
+      s.f[i] = Eigen::Map<const Eigen::Vector3d>(p0+offset);
+    }
+    else if (!is_active0 && is_active1) {
+      s.f[i] = Eigen::Map<const Eigen::Vector3d>(p1+offset);
+    }
+    else {
+      s.f[i] = lerp(3);
+    }
+    offset += 3;
+  }
+  s.lmd = lerp(dimv_);
+  offset += dimv_;
+  s.gmm = lerp(dimv_);
+}
+
+
+void WarmStartLibrary::interpolate(const int entry, const double t,
+                                   ConstraintsData& data) const {
+  int k0, k1;
+  double ratio;
+  findInterval(entry, t, k0, k1, ratio);
+  const double* p0 = point(entry, k0);
+  const double* p1 = point(entry, k1);
+  const int base = kPointContacts + dimq_ + 4*dimv_ + dimu_
+                    + 4*max_point_contacts_;
+  // Does not modify data if the sizes of the points are broken.
+  if (pointSize(entry, k0) != base + 2*levelDims(p0)
+      || pointSize(entry, k1) != base + 2*levelDims(p1)) {
+    return;
+  }
+  int offset0 = base;
+  int offset1 = base;
+  auto interpolateLevel = [&](const int level,
+                              std::vector<ConstraintComponentData>& level_data) {
+    const int dim0 = p0[kPointLevelDims+level];
+    const int dim1 = p1[kPointLevelDims+level];
+    const int dim = levelDim(level_data);
+    // Uses the point whose dimension is consistent if only one of them is.
+    const double w0 = (dim0 != dim) ? 0 : ((dim1 != dim) ? 1 : 1-ratio);
+    if (dim0 == dim || dim1 == dim) {
+      const double* slack0 = p0 + offset0;
+      const double* slack1 = p1 + offset1;
+      for (auto& e : level_data) {
+        const int dimc = e.slack.size();
+        if (dim0 == dim && dim1 == dim) {
+          e.slack = w0 * Eigen::Map<const Eigen::VectorXd>(slack0, dimc)
+                      + (1-w0) * Eigen::Map<const Eigen::VectorXd>(slack1, dimc);
+          e.dual = w0 * Eigen::Map<const Eigen::VectorXd>(slack0+dimc, dimc)
+                      + (1-w0) * Eigen::Map<const Eigen::VectorXd>(slack1+dimc, dimc);
+        }
+        else {
+          const double* slack = (dim0 == dim) ? slack0 : slack1;
+          e.slack = Eigen::Map<const Eigen::VectorXd>(slack, dimc);
+          e.dual = Eigen::Map<const Eigen::VectorXd>(slack+dimc, dimc);
+        }
+        slack0 += 2*dimc;
+        slack1 += 2*dimc;
+      }
+    }
+    offset0 += 2*dim0;
+    offset1 += 2*dim1;
+  };
+  interpolateLevel(0, data.position_level_data);
+  interpolateLevel(1, data.velocity_level_data);
+  interpolateLevel(2, data.acceleration_level_data);
+  interpolateLevel(3, data.impulse_level_data);
+}
+
+
+const double* WarmStartLibrary::point(const int entry, const int k) const {
+  assert(entry >= 0);
+  assert(entry < num_entries_);
+  assert(k >= 0);
+  assert(k < numPoints(entry));
+  const double* header = index_ - kHeaderSize;
+  const std::size_t table_offset = index_[entry*(dim_command_+4)+dim_command_+3];
+  const std::size_t point_offset = header[table_offset+2*k];
+  return header + point_offset;
+}
+
+
+int WarmStartLibrary::pointSize(const int entry, const int k) const {
+  const double* header = index_ - kHeaderSize;
+  const std::size_t table_offset = index_[entry*(dim_command_+4)+dim_command_+3];
+  return header[table_offset+2*k+1];
+}
+
+
+void WarmStartLibrary::findInterval(const int entry, const double t, int& k0,
+                                    int& k1, double& ratio) const {
+  const int num_points = numPoints(entry);
+  assert(num_points > 0);
+  if (t <= point(entry, 0)[kPointTime]) {
+    k0 = 0; k1 = 0; ratio = 0;
+    return;
+  }
+  if (t >= point(entry, num_points-1)[kPointTime]) {
+    k0 = num_points-1; k1 = num_points-1; ratio = 0;
+    return;
+  }
+  // Binary search of the last point whose time is not larger than t, which
+  // touches only O(log n) pages of the entry.
+  int lo = 0, hi = num_points-1;
+  while (hi - lo > 1) {
+    const int mid = (lo + hi) / 2;
+    if (point(entry, mid)[kPointTime] <= t) {
+      lo = mid;
+    }
+    else {
+      hi = mid;
+    }
+  }
+  k0 = lo;
+  k1 = hi;
+  const double t0 = point(entry, k0)[kPointTime];
+  const double t1 = point(entry, k1)[kPointTime];
+  ratio = (t1 > t0) ? (t - t0) / (t1 - t0) : 0;
+}
+
+} // namespace idocp
@@ -41,6 +41,7 @@ protected:
   void timeStage0(Robot& robot, const ContactStatus& contact_status) const;
   void timeStage1(Robot& robot, const ContactStatus& contact_status) const;
   void timeStage2(Robot& robot, const ContactStatus& contact_status) const;
+  void condenseResidual(Robot& robot, const ContactStatus& contact_status) const;
 
   double barrier, dt, mu;
 };
@@ -193,6 +194,45 @@ void ConstraintsTest::timeStage2(Robot& robot,
 }
 
 
+void ConstraintsTest::condenseResidual(Robot& robot, 
+                                       const ContactStatus& contact_status) const {
+  const int time_stage = 2;
+  auto constraints = createConstraints(robot);
+  auto data = constraints->createConstraintsData(robot, time_stage);
+  const SplitSolution s = SplitSolution::Random(robot, contact_status);
+  constraints->setSlackAndDual(robot, data, s);
+  auto data_ref = data;
+  SplitKKTMatrix kkt_matrix_ref(robot);
+  SplitKKTResidual kkt_residual_ref(robot);
+  kkt_matrix_ref.setContactStatus(contact_status);
+  kkt_residual_ref.setContactStatus(contact_status);
+  constraints->condenseSlackAndDual(robot, data_ref, dt, s, kkt_matrix_ref, 
+                                    kkt_residual_ref);
+  // The residual-only condensing must give the same KKT residual.
+  SplitKKTResidual kkt_residual(robot);
+  kkt_residual.setContactStatus(contact_status);
+  constraints->condenseSlackAndDual(robot, data, dt, s, kkt_residual);
+  EXPECT_TRUE(kkt_residual.isApprox(kkt_residual_ref));
+  EXPECT_DOUBLE_EQ(data.KKTError(), data_ref.KKTError());
+  EXPECT_DOUBLE_EQ(data.logBarrier(), data_ref.logBarrier());
+}
+
+
+TEST_F(ConstraintsTest, sparsity) {
+  auto robot = testhelper::CreateFloatingBaseRobot(dt);
+  auto constraints = std::make_shared<Constraints>();
+  EXPECT_EQ(constraints->QffSparsity(), BlockSparsity::Zero);
+  EXPECT_EQ(constraints->QqfSparsity(), BlockSparsity::Zero);
+  constraints->push_back(std::make_shared<JointPositionLowerLimit>(robot));
+  constraints->push_back(std::make_shared<JointTorquesUpperLimit>(robot));
+  EXPECT_EQ(constraints->QffSparsity(), BlockSparsity::Zero);
+  EXPECT_EQ(constraints->QqfSparsity(), BlockSparsity::Zero);
+  constraints->push_back(std::make_shared<FrictionCone>(robot, mu));
+  EXPECT_EQ(constraints->QffSparsity(), BlockSparsity::Dense);
+  EXPECT_EQ(constraints->QqfSparsity(), BlockSparsity::Dense);
+}
+
+
 TEST_F(ConstraintsTest, fixedBase) {
   auto robot = testhelper::CreateFixedBaseRobot(dt);
   auto contact_status = robot.createContactStatus();
@@ -203,6 +243,7 @@ TEST_F(ConstraintsTest, fixedBase) {
   timeStage0(robot, contact_status);
   timeStage1(robot, contact_status);
   timeStage2(robot, contact_status);
+  condenseResidual(robot, contact_status);
 }
 
 
@@ -216,6 +257,7 @@ TEST_F(ConstraintsTest, floatingBase) {
   timeStage0(robot, contact_status);
   timeStage1(robot, contact_status);
   timeStage2(robot, contact_status);
+  condenseResidual(robot, contact_status);
 }
 
 } // namespace idocp
@@ -0,0 +1,163 @@
+#include <memory>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/ocp/split_solution.hpp"
+#include "idocp/ocp/split_direction.hpp"
+#include "idocp/ocp/split_kkt_matrix.hpp"
+#include "idocp/ocp/split_kkt_residual.hpp"
+#include "idocp/constraints/joint_box_limit.hpp"
+#include "idocp/constraints/joint_position_lower_limit.hpp"
+#include "idocp/constraints/joint_position_upper_limit.hpp"
+#include "idocp/constraints/joint_velocity_lower_limit.hpp"
+#include "idocp/constraints/joint_velocity_upper_limit.hpp"
+#include "idocp/constraints/joint_acceleration_lower_limit.hpp"
+#include "idocp/constraints/joint_acceleration_upper_limit.hpp"
+#include "idocp/constraints/joint_torques_lower_limit.hpp"
+#include "idocp/constraints/joint_torques_upper_limit.hpp"
+
+#include "robot_factory.hpp"
+
+namespace idocp {
+
+class JointBoxLimitTest : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    srand((unsigned int) time(0));
+    barrier = 1.0e-04;
+    dt = std::abs(Eigen::VectorXd::Random(1)[0]);
+  }
+
+  virtual void TearDown() {
+  }
+
+  template <typename LowerLimit, typename UpperLimit>
+  void testConsistency(Robot& robot, const JointBoxLimit& constr,
+                       const LowerLimit& lower,
+                       const UpperLimit& upper) const;
+  void test(Robot& robot) const;
+
+  double barrier, dt;
+};
+
+
+template <typename LowerLimit, typename UpperLimit>
+void JointBoxLimitTest::testConsistency(Robot& robot,
+                                        const JointBoxLimit& constr,
+                                        const LowerLimit& lower,
+                                        const UpperLimit& upper) const {
+  const int dimx = lower.dimc();
+  EXPECT_EQ(constr.dimc(), lower.dimc()+upper.dimc());
+  EXPECT_FALSE(constr.useKinematics());
+  EXPECT_TRUE(constr.kinematicsLevel() == lower.kinematicsLevel());
+  ConstraintComponentData data(constr.dimc(), constr.barrierParameter());
+  ConstraintComponentData data_lower(dimx, lower.barrierParameter());
+  ConstraintComponentData data_upper(dimx, upper.barrierParameter());
+  const auto s = SplitSolution::Random(robot);
+  EXPECT_EQ(constr.isFeasible(robot, data, s),
+            lower.isFeasible(robot, data_lower, s)
+              && upper.isFeasible(robot, data_upper, s));
+  constr.setSlack(robot, data, s);
+  lower.setSlack(robot, data_lower, s);
+  upper.setSlack(robot, data_upper, s);
+  EXPECT_TRUE(data.slack.head(dimx).isApprox(data_lower.slack));
+  EXPECT_TRUE(data.slack.tail(dimx).isApprox(data_upper.slack));
+  data.slack.setRandom();
+  data.dual.setRandom();
+  data.slack = data.slack.array().abs() + 1.0e-02;
+  data.dual = data.dual.array().abs() + 1.0e-02;
+  data_lower.slack = data.slack.head(dimx);
+  data_upper.slack = data.slack.tail(dimx);
+  data_lower.dual = data.dual.head(dimx);
+  data_upper.dual = data.dual.tail(dimx);
+  constr.evalConstraint(robot, data, s);
+  lower.evalConstraint(robot, data_lower, s);
+  upper.evalConstraint(robot, data_upper, s);
+  EXPECT_TRUE(data.residual.head(dimx).isApprox(data_lower.residual));
+  EXPECT_TRUE(data.residual.tail(dimx).isApprox(data_upper.residual));
+  EXPECT_TRUE(data.cmpl.head(dimx).isApprox(data_lower.cmpl));
+  EXPECT_TRUE(data.cmpl.tail(dimx).isApprox(data_upper.cmpl));
+  EXPECT_NEAR(data.log_barrier,
+              data_lower.log_barrier+data_upper.log_barrier, 1.0e-10);
+  auto kkt_res = SplitKKTResidual::Random(robot);
+  auto kkt_res_ref = kkt_res;
+  constr.evalDerivatives(robot, data, dt, s, kkt_res);
+  lower.evalDerivatives(robot, data_lower, dt, s, kkt_res_ref);
+  upper.evalDerivatives(robot, data_upper, dt, s, kkt_res_ref);
+  EXPECT_TRUE(kkt_res.isApprox(kkt_res_ref));
+  auto kkt_mat = SplitKKTMatrix::Random(robot);
+  auto kkt_mat_ref = kkt_mat;
+  constr.condenseSlackAndDual(robot, data, dt, s, kkt_mat, kkt_res);
+  lower.condenseSlackAndDual(robot, data_lower, dt, s, kkt_mat_ref,
+                             kkt_res_ref);
+  upper.condenseSlackAndDual(robot, data_upper, dt, s, kkt_mat_ref,
+                             kkt_res_ref);
+  EXPECT_TRUE(kkt_res.isApprox(kkt_res_ref));
+  EXPECT_TRUE(kkt_mat.isApprox(kkt_mat_ref));
+  const auto d = SplitDirection::Random(robot);
+  constr.expandSlackAndDual(data, s, d);
+  lower.expandSlackAndDual(data_lower, s, d);
+  upper.expandSlackAndDual(data_upper, s, d);
+  EXPECT_TRUE(data.dslack.head(dimx).isApprox(data_lower.dslack));
+  EXPECT_TRUE(data.dslack.tail(dimx).isApprox(data_upper.dslack));
+  EXPECT_TRUE(data.ddual.head(dimx).isApprox(data_lower.ddual));
+  EXPECT_TRUE(data.ddual.tail(dimx).isApprox(data_upper.ddual));
+  EXPECT_DOUBLE_EQ(constr.maxSlackStepSize(data),
+                   std::min(lower.maxSlackStepSize(data_lower),
+                            upper.maxSlackStepSize(data_upper)));
+  EXPECT_DOUBLE_EQ(constr.maxDualStepSize(data),
+                   std::min(lower.maxDualStepSize(data_lower),
+                            upper.maxDualStepSize(data_upper)));
+}
+
+
+void JointBoxLimitTest::test(Robot& robot) const {
+  testConsistency(robot, JointBoxLimit(robot, JointVariable::Position),
+                  JointPositionLowerLimit(robot),
+                  JointPositionUpperLimit(robot));
+  testConsistency(robot, JointBoxLimit(robot, JointVariable::Velocity),
+                  JointVelocityLowerLimit(robot),
+                  JointVelocityUpperLimit(robot));
+  testConsistency(robot, JointBoxLimit(robot, JointVariable::Torques),
+                  JointTorquesLowerLimit(robot),
+                  JointTorquesUpperLimit(robot));
+  const int dimx = robot.dimv() - robot.dim_passive();
+  const Eigen::VectorXd amin = - Eigen::VectorXd::Random(dimx).array().abs();
+  const Eigen::VectorXd amax = Eigen::VectorXd::Random(dimx).array().abs();
+  testConsistency(robot,
+                  JointBoxLimit(robot, JointVariable::Acceleration, amin, amax),
+                  JointAccelerationLowerLimit(robot, amin),
+                  JointAccelerationUpperLimit(robot, amax));
+  const JointBoxLimit constr(robot, JointVariable::Velocity);
+  EXPECT_TRUE(constr.variable() == JointVariable::Velocity);
+  ConstraintComponentData data(constr.dimc(), constr.barrierParameter());
+  SplitSolution s(robot);
+  EXPECT_TRUE(constr.isFeasible(robot, data, s));
+  s.v = 2*robot.jointVelocityLimit();
+  EXPECT_FALSE(constr.isFeasible(robot, data, s));
+  s.v = - 2*robot.jointVelocityLimit();
+  EXPECT_FALSE(constr.isFeasible(robot, data, s));
+}
+
+
+TEST_F(JointBoxLimitTest, fixedBase) {
+  auto robot = testhelper::CreateFixedBaseRobot(dt);
+  test(robot);
+}
+
+
+TEST_F(JointBoxLimitTest, floatingBase) {
+  auto robot = testhelper::CreateFloatingBaseRobot(dt);
+  test(robot);
+}
+
+} // namespace idocp
+
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -3,6 +3,7 @@
 
 #include "idocp/constraints/pdipm.hpp"
 #include "idocp/constraints/constraint_component_data.hpp"
+#include "idocp/utils/simd_kernels.hpp"
 
 namespace idocp {
 
@@ -102,6 +103,44 @@ TEST_F(PDIPMTest, logBarrier) {
   EXPECT_DOUBLE_EQ(cost_ref, cost);
 }
 
+
+TEST_F(PDIPMTest, instructionSets) {
+  const auto default_instruction_set = simd::instructionSet();
+  data.residual.setRandom();
+  const double fraction_rate = 0.995;
+  for (const auto instruction_set : {simd::InstructionSet::Generic, 
+                                     simd::InstructionSet::AVX2, 
+                                     simd::InstructionSet::AVX512}) {
+    if (!simd::setInstructionSet(instruction_set)) {
+      EXPECT_FALSE(simd::isSupported(instruction_set));
+      continue;
+    }
+    EXPECT_EQ(simd::instructionSet(), instruction_set);
+    Eigen::VectorXd cmpl_ref = Eigen::VectorXd::Zero(dim);
+    Eigen::VectorXd cond_ref = Eigen::VectorXd::Zero(dim);
+    Eigen::VectorXd ddual_ref = Eigen::VectorXd::Zero(dim);
+    double step_size_ref = 1;
+    for (int i=0; i<dim; ++i) {
+      cmpl_ref(i) = data.slack(i) * data.dual(i) - barrier;
+      cond_ref(i) = (data.dual(i) * data.residual(i) - cmpl_ref(i)) / data.slack(i);
+      ddual_ref(i) = - (data.dual(i) * data.dslack(i) + cmpl_ref(i)) / data.slack(i);
+      const double step_size = - fraction_rate * (data.slack(i) / data.dslack(i));
+      if (step_size > 0 && step_size < step_size_ref) {
+        step_size_ref = step_size;
+      }
+    }
+    pdipm::computeComplementarySlackness(barrier, data);
+    pdipm::computeCondensingCoeffcient(data);
+    pdipm::computeDualDirection(data);
+    EXPECT_TRUE(cmpl_ref.isApprox(data.cmpl));
+    EXPECT_TRUE(cond_ref.isApprox(data.cond));
+    EXPECT_TRUE(ddual_ref.isApprox(data.ddual));
+    EXPECT_DOUBLE_EQ(pdipm::fractionToBoundarySlack(fraction_rate, data), 
+                     step_size_ref);
+  }
+  EXPECT_TRUE(simd::setInstructionSet(default_instruction_set));
+}
+
 } // namespace idocp
 
 
@@ -0,0 +1,363 @@
+#include <memory>
+
+#include <gtest/gtest.h>
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/robot/contact_status.hpp"
+#include "idocp/ocp/split_solution.hpp"
+#include "idocp/ocp/split_direction.hpp"
+#include "idocp/ocp/split_kkt_matrix.hpp"
+#include "idocp/ocp/split_kkt_residual.hpp"
+#include "idocp/constraints/pdipm.hpp"
+#include "idocp/constraints/smooth_friction_cone.hpp"
+
+#include "robot_factory.hpp"
+
+namespace idocp {
+
+class SmoothFrictionConeTest : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    srand((unsigned int) time(0));
+    barrier = 1.0e-04;
+    dt = std::abs(Eigen::VectorXd::Random(1)[0]);
+    mu = 0.7;
+    eps = 1.0e-03;
+  }
+
+  virtual void TearDown() {
+  }
+
+  void testKinematics(Robot& robot, const ContactStatus& contact_status) const;
+  void testIsFeasible(Robot& robot, const ContactStatus& contact_status) const;
+  void testSetSlack(Robot& robot, const ContactStatus& contact_status) const;
+  void test_evalConstraint(Robot& robot, const ContactStatus& contact_status) const;
+  void test_evalDerivatives(Robot& robot, const ContactStatus& contact_status) const;
+  void testCondenseSlackAndDual(Robot& robot,
+                                const ContactStatus& contact_status) const;
+  void testExpandSlackAndDual(Robot& robot, const ContactStatus& contact_status) const;
+  void test(Robot& robot, const ContactStatus& contact_status) const;
+
+  static void computeDerivatives(Robot& robot, const int frame,
+                                 const double mu, const double eps,
+                                 const Eigen::Vector3d& f_local,
+                                 Eigen::VectorXd& dg_dq, Eigen::Vector3d& dg_df,
+                                 Eigen::Matrix3d& d2g_df2);
+
+  double barrier, dt, mu, eps;
+};
+
+
+void SmoothFrictionConeTest::computeDerivatives(
+    Robot& robot, const int frame, const double mu, const double eps,
+    const Eigen::Vector3d& f_local, Eigen::VectorXd& dg_dq,
+    Eigen::Vector3d& dg_df, Eigen::Matrix3d& d2g_df2) {
+  Eigen::Vector3d f_world = Eigen::Vector3d::Zero();
+  SmoothFrictionCone::fLocal2World(robot, frame, f_local, f_world);
+  Eigen::MatrixXd J = Eigen::MatrixXd::Zero(6, robot.dimv());
+  robot.getFrameJacobian(frame, J);
+  Eigen::MatrixXd dfW_dq = Eigen::MatrixXd::Zero(3, robot.dimv());
+  for (int j=0; j<robot.dimv(); ++j) {
+    dfW_dq.col(j) = J.template bottomRows<3>().col(j).cross(f_world);
+  }
+  const double norm = std::sqrt(f_world(0)*f_world(0)
+                                + f_world(1)*f_world(1) + eps*eps);
+  const Eigen::Vector3d dg_dfW(f_world(0)/norm, f_world(1)/norm, -mu);
+  Eigen::Matrix3d d2g_dfW2 = Eigen::Matrix3d::Zero();
+  d2g_dfW2.topLeftCorner<2, 2>()
+      = (Eigen::Matrix2d::Identity()
+          - dg_dfW.head<2>() * dg_dfW.head<2>().transpose()) / norm;
+  const Eigen::Matrix3d R = robot.frameRotation(frame);
+  dg_dq = dfW_dq.transpose() * dg_dfW;
+  dg_df = R.transpose() * dg_dfW;
+  d2g_df2 = R.transpose() * d2g_dfW2 * R;
+}
+
+
+void SmoothFrictionConeTest::testKinematics(
+    Robot& robot, const ContactStatus& contact_status) const {
+  SmoothFrictionCone constr(robot, mu);
+  EXPECT_TRUE(constr.useKinematics());
+  EXPECT_TRUE(constr.kinematicsLevel() == KinematicsLevel::AccelerationLevel);
+  EXPECT_EQ(constr.dimc(), contact_status.maxPointContacts());
+}
+
+
+void SmoothFrictionConeTest::testIsFeasible(
+    Robot& robot, const ContactStatus& contact_status) const {
+  SmoothFrictionCone constr(robot, mu);
+  ConstraintComponentData data(constr.dimc(), constr.barrierParameter());
+  constr.allocateExtraData(data);
+  const auto s = SplitSolution::Random(robot, contact_status);
+  robot.updateFrameKinematics(s.q);
+  bool feasible = true;
+  for (int i=0; i<contact_status.maxPointContacts(); ++i) {
+    if (contact_status.isContactActive(i)) {
+      Eigen::Vector3d f_world = Eigen::Vector3d::Zero();
+      SmoothFrictionCone::fLocal2World(robot, robot.contactFrames()[i],
+                                       s.f[i], f_world);
+      if (SmoothFrictionCone::frictionConeResidual(mu, eps, f_world) > 0) {
+        feasible = false;
+      }
+    }
+  }
+  EXPECT_EQ(constr.isFeasible(robot, data, s), feasible);
+}
+
+
+void SmoothFrictionConeTest::testSetSlack(
+    Robot& robot, const ContactStatus& contact_status) const {
+  SmoothFrictionCone constr(robot, mu);
+  ConstraintComponentData data(constr.dimc(), constr.barrierParameter());
+  constr.allocateExtraData(data);
+  auto data_ref = data;
+  const auto s = SplitSolution::Random(robot, contact_status);
+  robot.updateFrameKinematics(s.q);
+  constr.setSlack(robot, data, s);
+  for (int i=0; i<contact_status.maxPointContacts(); ++i) {
+    Eigen::Vector3d f_world = Eigen::Vector3d::Zero();
+    SmoothFrictionCone::fLocal2World(robot, robot.contactFrames()[i],
+                                     s.f[i], f_world);
+    data_ref.residual(i)
+        = SmoothFrictionCone::frictionConeResidual(mu, eps, f_world);
+    data_ref.slack(i) = - data_ref.residual(i);
+  }
+  EXPECT_TRUE(data.slack.isApprox(data_ref.slack));
+  EXPECT_TRUE(data.residual.isApprox(data_ref.residual));
+}
+
+
+void SmoothFrictionConeTest::test_evalConstraint(
+    Robot& robot, const ContactStatus& contact_status) const {
+  SmoothFrictionCone constr(robot, mu);
+  const auto s = SplitSolution::Random(robot, contact_status);
+  robot.updateKinematics(s.q);
+  ConstraintComponentData data(constr.dimc(), constr.barrierParameter());
+  constr.allocateExtraData(data);
+  data.slack.setRandom();
+  data.dual.setRandom();
+  data.slack = data.slack.array().abs();
+  data.dual = data.dual.array().abs();
+  data.residual.setRandom();
+  data.cmpl.setRandom();
+  auto data_ref = data;
+  constr.evalConstraint(robot, data, s);
+  data_ref.residual.setZero();
+  data_ref.cmpl.setZero();
+  data_ref.log_barrier = 0;
+  for (int i=0; i<contact_status.maxPointContacts(); ++i) {
+    if (contact_status.isContactActive(i)) {
+      Eigen::Vector3d f_world = Eigen::Vector3d::Zero();
+      SmoothFrictionCone::fLocal2World(robot, robot.contactFrames()[i],
+                                       s.f[i], f_world);
+      data_ref.residual(i)
+          = SmoothFrictionCone::frictionConeResidual(mu, eps, f_world)
+              + data_ref.slack(i);
+      data_ref.cmpl(i) = data_ref.slack(i) * data_ref.dual(i) - barrier;
+      data_ref.log_barrier
+          += pdipm::logBarrier(barrier, data_ref.slack.segment(i, 1));
+    }
+  }
+  EXPECT_TRUE(data.residual.isApprox(data_ref.residual));
+  EXPECT_TRUE(data.cmpl.isApprox(data_ref.cmpl));
+  EXPECT_NEAR(data.log_barrier, data_ref.log_barrier, 1.0e-10);
+}
+
+
+void SmoothFrictionConeTest::test_evalDerivatives(
+    Robot& robot, const ContactStatus& contact_status) const {
+  SmoothFrictionCone constr(robot, mu);
+  ConstraintComponentData data(constr.dimc(), constr.barrierParameter());
+  constr.allocateExtraData(data);
+  const auto s = SplitSolution::Random(robot, contact_status);
+  robot.updateKinematics(s.q);
+  data.slack.setRandom();
+  data.dual.setRandom();
+  data.slack = data.slack.array().abs();
+  data.dual = data.dual.array().abs();
+  constr.evalConstraint(robot, data, s);
+  auto kkt_res = SplitKKTResidual::Random(robot, contact_status);
+  auto kkt_res_ref = kkt_res;
+  constr.evalDerivatives(robot, data, dt, s, kkt_res);
+  int dimf_stack = 0;
+  for (int i=0; i<contact_status.maxPointContacts(); ++i) {
+    if (contact_status.isContactActive(i)) {
+      Eigen::VectorXd dg_dq(robot.dimv());
+      Eigen::Vector3d dg_df;
+      Eigen::Matrix3d d2g_df2;
+      computeDerivatives(robot, robot.contactFrames()[i], mu, eps, s.f[i],
+                         dg_dq, dg_df, d2g_df2);
+      kkt_res_ref.lq() += dt * data.dual(i) * dg_dq;
+      kkt_res_ref.lf().segment(dimf_stack, 3) += dt * data.dual(i) * dg_df;
+      dimf_stack += 3;
+    }
+  }
+  EXPECT_TRUE(kkt_res.isApprox(kkt_res_ref));
+}
+
+
+void SmoothFrictionConeTest::testCondenseSlackAndDual(
+    Robot& robot, const ContactStatus& contact_status) const {
+  SmoothFrictionCone constr(robot, mu);
+  ConstraintComponentData data(constr.dimc(), constr.barrierParameter());
+  constr.allocateExtraData(data);
+  const auto s = SplitSolution::Random(robot, contact_status);
+  robot.updateKinematics(s.q);
+  data.slack.setRandom();
+  data.dual.setRandom();
+  data.slack = data.slack.array().abs();
+  data.dual = data.dual.array().abs();
+  auto kkt_mat = SplitKKTMatrix::Random(robot, contact_status);
+  auto kkt_res = SplitKKTResidual::Random(robot, contact_status);
+  constr.evalConstraint(robot, data, s);
+  constr.evalDerivatives(robot, data, dt, s, kkt_res);
+  auto kkt_mat_ref = kkt_mat;
+  auto kkt_res_ref = kkt_res;
+  constr.condenseSlackAndDual(robot, data, dt, s, kkt_mat, kkt_res);
+  int dimf_stack = 0;
+  for (int i=0; i<contact_status.maxPointContacts(); ++i) {
+    if (contact_status.isContactActive(i)) {
+      Eigen::VectorXd dg_dq(robot.dimv());
+      Eigen::Vector3d dg_df;
+      Eigen::Matrix3d d2g_df2;
+      computeDerivatives(robot, robot.contactFrames()[i], mu, eps, s.f[i],
+                         dg_dq, dg_df, d2g_df2);
+      const double cond
+          = (data.dual(i)*data.residual(i)-data.cmpl(i)) / data.slack(i);
+      kkt_res_ref.lq() += dt * cond * dg_dq;
+      kkt_res_ref.lf().segment(dimf_stack, 3) += dt * cond * dg_df;
+      const double r = data.dual(i) / data.slack(i);
+      kkt_mat_ref.Qqq() += dt * r * dg_dq * dg_dq.transpose();
+      kkt_mat_ref.Qqf().middleCols(dimf_stack, 3)
+          += dt * r * dg_dq * dg_df.transpose();
+      kkt_mat_ref.Qff().block(dimf_stack, dimf_stack, 3, 3)
+          += dt * r * dg_df * dg_df.transpose() + dt * data.dual(i) * d2g_df2;
+      dimf_stack += 3;
+    }
+  }
+  EXPECT_TRUE(kkt_res.isApprox(kkt_res_ref));
+  EXPECT_TRUE(kkt_mat.isApprox(kkt_mat_ref));
+  EXPECT_TRUE(constr.QffSparsity() == BlockSparsity::Dense);
+  EXPECT_TRUE(constr.QqfSparsity() == BlockSparsity::Dense);
+}
+
+
+void SmoothFrictionConeTest::testExpandSlackAndDual(
+    Robot& robot, const ContactStatus& contact_status) const {
+  SmoothFrictionCone constr(robot, mu);
+  ConstraintComponentData data(constr.dimc(), constr.barrierParameter());
+  constr.allocateExtraData(data);
+  const auto s = SplitSolution::Random(robot, contact_status);
+  robot.updateKinematics(s.q);
+  data.slack.setRandom();
+  data.dual.setRandom();
+  data.slack = data.slack.array().abs();
+  data.dual = data.dual.array().abs();
+  auto kkt_mat = SplitKKTMatrix::Random(robot, contact_status);
+  auto kkt_res = SplitKKTResidual::Random(robot, contact_status);
+  constr.evalConstraint(robot, data, s);
+  constr.evalDerivatives(robot, data, dt, s, kkt_res);
+  constr.condenseSlackAndDual(robot, data, dt, s, kkt_mat, kkt_res);
+  auto data_ref = data;
+  const auto d = SplitDirection::Random(robot, contact_status);
+  constr.expandSlackAndDual(data, s, d);
+  data_ref.dslack.fill(1.0);
+  data_ref.ddual.fill(1.0);
+  int dimf_stack = 0;
+  for (int i=0; i<contact_status.maxPointContacts(); ++i) {
+    if (contact_status.isContactActive(i)) {
+      Eigen::VectorXd dg_dq(robot.dimv());
+      Eigen::Vector3d dg_df;
+      Eigen::Matrix3d d2g_df2;
+      computeDerivatives(robot, robot.contactFrames()[i], mu, eps, s.f[i],
+                         dg_dq, dg_df, d2g_df2);
+      data_ref.dslack(i) = - dg_dq.dot(d.dq())
+                           - dg_df.dot(d.df().segment(dimf_stack, 3))
+                           - data_ref.residual(i);
+      data_ref.ddual(i)
+          = - (data_ref.dual(i)*data_ref.dslack(i)+data_ref.cmpl(i))
+              / data_ref.slack(i);
+      dimf_stack += 3;
+    }
+  }
+  EXPECT_TRUE(data.dslack.isApprox(data_ref.dslack));
+  EXPECT_TRUE(data.ddual.isApprox(data_ref.ddual));
+}
+
+
+void SmoothFrictionConeTest::test(Robot& robot,
+                                  const ContactStatus& contact_status) const {
+  testKinematics(robot, contact_status);
+  testIsFeasible(robot, contact_status);
+  testSetSlack(robot, contact_status);
+  test_evalConstraint(robot, contact_status);
+  test_evalDerivatives(robot, contact_status);
+  testCondenseSlackAndDual(robot, contact_status);
+  testExpandSlackAndDual(robot, contact_status);
+}
+
+
+TEST_F(SmoothFrictionConeTest, frictionConeResidual) {
+  const Eigen::Vector3d f = Eigen::Vector3d::Random();
+  const double res_ref
+      = std::sqrt(f(0)*f(0)+f(1)*f(1)+eps*eps) - mu * f(2);
+  EXPECT_DOUBLE_EQ(SmoothFrictionCone::frictionConeResidual(mu, eps, f),
+                   res_ref);
+  // The smoothed cone is strictly inside the exact cone, so fz > 0 holds.
+  const Eigen::Vector3d f_apex(0, 0, 0);
+  EXPECT_TRUE(SmoothFrictionCone::frictionConeResidual(mu, eps, f_apex) > 0);
+}
+
+
+TEST_F(SmoothFrictionConeTest, frictionConeDerivatives) {
+  const Eigen::Vector3d f = Eigen::Vector3d::Random();
+  Eigen::Vector3d grad;
+  Eigen::Matrix3d hess;
+  SmoothFrictionCone::frictionConeDerivatives(mu, eps, f, grad, hess);
+  const double h = 1.0e-06;
+  Eigen::Vector3d grad_ref;
+  Eigen::Matrix3d hess_ref;
+  for (int i=0; i<3; ++i) {
+    Eigen::Vector3d fp = f, fm = f;
+    fp(i) += h;
+    fm(i) -= h;
+    grad_ref(i) = (SmoothFrictionCone::frictionConeResidual(mu, eps, fp)
+                    - SmoothFrictionCone::frictionConeResidual(mu, eps, fm))
+                  / (2*h);
+    Eigen::Vector3d gp, gm;
+    Eigen::Matrix3d Hp, Hm;
+    SmoothFrictionCone::frictionConeDerivatives(mu, eps, fp, gp, Hp);
+    SmoothFrictionCone::frictionConeDerivatives(mu, eps, fm, gm, Hm);
+    hess_ref.col(i) = (gp - gm) / (2*h);
+  }
+  EXPECT_TRUE(grad.isApprox(grad_ref, 1.0e-06));
+  EXPECT_TRUE(hess.isApprox(hess_ref, 1.0e-04));
+  EXPECT_TRUE(hess.isApprox(hess.transpose()));
+}
+
+
+TEST_F(SmoothFrictionConeTest, fixedBase) {
+  auto robot = testhelper::CreateFixedBaseRobot(dt);
+  auto contact_status = robot.createContactStatus();
+  test(robot, contact_status);
+  contact_status.activateContact(0);
+  test(robot, contact_status);
+}
+
+
+TEST_F(SmoothFrictionConeTest, floatingBase) {
+  auto robot = testhelper::CreateFloatingBaseRobot(dt);
+  auto contact_status = robot.createContactStatus();
+  test(robot, contact_status);
+  contact_status.setRandom();
+  test(robot, contact_status);
+}
+
+} // namespace idocp
+
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -48,6 +48,8 @@ void ContactForceCostTest::testStageCost(Robot& robot) const {
   auto cost = std::make_shared<ContactForceCost>(robot);
   CostFunctionData data(robot);
   EXPECT_FALSE(cost->useKinematics());
+  EXPECT_EQ(cost->QffSparsity(), BlockSparsity::Diagonal);
+  EXPECT_EQ(cost->QqfSparsity(), BlockSparsity::Zero);
   cost->set_f_weight(f_weight);
   cost->set_f_ref(f_ref);
   cost->set_fi_weight(fi_weight);
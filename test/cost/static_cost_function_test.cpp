@@ -0,0 +1,167 @@
+#include <memory>
+
+#include <gtest/gtest.h>
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/cost/cost_function.hpp"
+#include "idocp/cost/static_cost_function.hpp"
+#include "idocp/cost/configuration_space_cost.hpp"
+#include "idocp/cost/task_space_3d_cost.hpp"
+#include "idocp/cost/cost_function_data.hpp"
+#include "idocp/ocp/split_solution.hpp"
+#include "idocp/ocp/split_kkt_residual.hpp"
+#include "idocp/ocp/split_kkt_matrix.hpp"
+#include "idocp/impulse/impulse_split_solution.hpp"
+#include "idocp/impulse/impulse_split_kkt_residual.hpp"
+#include "idocp/impulse/impulse_split_kkt_matrix.hpp"
+
+#include "robot_factory.hpp"
+
+
+namespace idocp {
+
+class StaticCostFunctionTest : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    srand((unsigned int) time(0));
+    std::random_device rnd;
+    t = std::abs(Eigen::VectorXd::Random(1)[0]);
+    dt = std::abs(Eigen::VectorXd::Random(1)[0]);
+  }
+
+  virtual void TearDown() {
+  }
+
+  static ConfigurationSpaceCost createConfigurationSpaceCost(const Robot& robot);
+  static TaskSpace3DCost createTaskSpace3DCost(const Robot& robot, 
+                                               const int frame_id);
+
+  void test(Robot& robot, const int frame_id) const;
+
+  double dt, t;
+};
+
+
+ConfigurationSpaceCost StaticCostFunctionTest::createConfigurationSpaceCost(
+    const Robot& robot) {
+  ConfigurationSpaceCost cost(robot);
+  cost.set_q_weight(Eigen::VectorXd::Random(robot.dimv()).array().abs());
+  cost.set_v_weight(Eigen::VectorXd::Random(robot.dimv()).array().abs());
+  cost.set_a_weight(Eigen::VectorXd::Random(robot.dimv()).array().abs());
+  cost.set_u_weight(Eigen::VectorXd::Random(robot.dimu()).array().abs());
+  cost.set_qf_weight(Eigen::VectorXd::Random(robot.dimv()).array().abs());
+  cost.set_vf_weight(Eigen::VectorXd::Random(robot.dimv()).array().abs());
+  cost.set_qi_weight(Eigen::VectorXd::Random(robot.dimv()).array().abs());
+  cost.set_vi_weight(Eigen::VectorXd::Random(robot.dimv()).array().abs());
+  cost.set_dvi_weight(Eigen::VectorXd::Random(robot.dimv()).array().abs());
+  cost.set_q_ref(robot.generateFeasibleConfiguration());
+  cost.set_v_ref(Eigen::VectorXd::Random(robot.dimv()));
+  cost.set_u_ref(Eigen::VectorXd::Random(robot.dimu()));
+  return cost;
+}
+
+
+TaskSpace3DCost StaticCostFunctionTest::createTaskSpace3DCost(
+    const Robot& robot, const int frame_id) {
+  TaskSpace3DCost cost(robot, frame_id);
+  cost.set_q_weight(Eigen::Vector3d::Random().array().abs());
+  cost.set_qf_weight(Eigen::Vector3d::Random().array().abs());
+  cost.set_qi_weight(Eigen::Vector3d::Random().array().abs());
+  cost.set_q_3d_ref(Eigen::Vector3d::Random());
+  return cost;
+}
+
+
+void StaticCostFunctionTest::test(Robot& robot, const int frame_id) const {
+  const auto config_cost = createConfigurationSpaceCost(robot);
+  const auto task_cost = createTaskSpace3DCost(robot, frame_id);
+  auto dynamic_cost = std::make_shared<CostFunction>();
+  dynamic_cost->push_back(std::make_shared<ConfigurationSpaceCost>(config_cost));
+  dynamic_cost->push_back(std::make_shared<TaskSpace3DCost>(task_cost));
+  std::shared_ptr<CostFunction> static_cost 
+      = std::make_shared<StaticCostFunction<ConfigurationSpaceCost, 
+                                            TaskSpace3DCost>>(config_cost, 
+                                                              task_cost);
+  EXPECT_EQ(static_cost->useKinematics(), dynamic_cost->useKinematics());
+  EXPECT_EQ(static_cost->QffSparsity(), dynamic_cost->QffSparsity());
+  EXPECT_EQ(static_cost->QqfSparsity(), dynamic_cost->QqfSparsity());
+  EXPECT_EQ(static_cost->QffSparsity(), BlockSparsity::Zero);
+  CostFunctionData data(robot), data_ref(robot);
+  const SplitSolution s = SplitSolution::Random(robot);
+  robot.updateKinematics(s.q, s.v, s.a);
+  SplitKKTResidual kkt_res(robot);
+  SplitKKTMatrix kkt_mat(robot);
+  kkt_res.lx.setRandom();
+  kkt_res.la.setRandom();
+  kkt_res.lu.setRandom();
+  kkt_mat.Qxx.setRandom();
+  kkt_mat.Qaa.setRandom();
+  kkt_mat.Quu.setRandom();
+  auto kkt_res_ref = kkt_res;
+  auto kkt_mat_ref = kkt_mat;
+  EXPECT_DOUBLE_EQ(static_cost->computeStageCost(robot, data, t, dt, s),
+                   dynamic_cost->computeStageCost(robot, data_ref, t, dt, s));
+  EXPECT_DOUBLE_EQ(
+      static_cost->quadratizeStageCost(robot, data, t, dt, s, kkt_res, kkt_mat),
+      dynamic_cost->quadratizeStageCost(robot, data_ref, t, dt, s, 
+                                        kkt_res_ref, kkt_mat_ref));
+  EXPECT_TRUE(kkt_res.isApprox(kkt_res_ref));
+  EXPECT_TRUE(kkt_mat.isApprox(kkt_mat_ref));
+  EXPECT_DOUBLE_EQ(static_cost->computeTerminalCost(robot, data, t, s),
+                   dynamic_cost->computeTerminalCost(robot, data_ref, t, s));
+  EXPECT_DOUBLE_EQ(
+      static_cost->quadratizeTerminalCost(robot, data, t, s, kkt_res, kkt_mat),
+      dynamic_cost->quadratizeTerminalCost(robot, data_ref, t, s, 
+                                           kkt_res_ref, kkt_mat_ref));
+  EXPECT_TRUE(kkt_res.isApprox(kkt_res_ref));
+  EXPECT_TRUE(kkt_mat.isApprox(kkt_mat_ref));
+  const ImpulseSplitSolution s_impulse = ImpulseSplitSolution::Random(robot);
+  robot.updateKinematics(s_impulse.q, s_impulse.v);
+  ImpulseSplitKKTResidual impulse_kkt_res(robot);
+  ImpulseSplitKKTMatrix impulse_kkt_mat(robot);
+  impulse_kkt_res.lx.setRandom();
+  impulse_kkt_res.ldv.setRandom();
+  impulse_kkt_mat.Qxx.setRandom();
+  impulse_kkt_mat.Qdvdv.setRandom();
+  auto impulse_kkt_res_ref = impulse_kkt_res;
+  auto impulse_kkt_mat_ref = impulse_kkt_mat;
+  EXPECT_DOUBLE_EQ(static_cost->computeImpulseCost(robot, data, t, s_impulse),
+                   dynamic_cost->computeImpulseCost(robot, data_ref, t, 
+                                                    s_impulse));
+  EXPECT_DOUBLE_EQ(
+      static_cost->quadratizeImpulseCost(robot, data, t, s_impulse, 
+                                         impulse_kkt_res, impulse_kkt_mat),
+      dynamic_cost->quadratizeImpulseCost(robot, data_ref, t, s_impulse, 
+                                          impulse_kkt_res_ref, 
+                                          impulse_kkt_mat_ref));
+  EXPECT_TRUE(impulse_kkt_res.isApprox(impulse_kkt_res_ref));
+  EXPECT_TRUE(impulse_kkt_mat.isApprox(impulse_kkt_mat_ref));
+  // The components appended by push_back() are also evaluated.
+  static_cost->push_back(std::make_shared<ConfigurationSpaceCost>(config_cost));
+  dynamic_cost->push_back(std::make_shared<ConfigurationSpaceCost>(config_cost));
+  EXPECT_DOUBLE_EQ(static_cost->computeStageCost(robot, data, t, dt, s),
+                   dynamic_cost->computeStageCost(robot, data_ref, t, dt, s));
+}
+
+
+TEST_F(StaticCostFunctionTest, fixedBase) {
+  auto robot = testhelper::CreateFixedBaseRobot(dt);
+  const int frame_id = robot.contactFrames()[0];
+  test(robot, frame_id);
+}
+
+
+TEST_F(StaticCostFunctionTest, floatingBase) {
+  auto robot = testhelper::CreateFloatingBaseRobot(dt);
+  const int frame_id = robot.contactFrames()[0];
+  test(robot, frame_id);
+}
+
+} // namespace idocp
+
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -61,6 +61,30 @@ private:
 };
 
 
+class CountingConfigurationRef final : public TimeVaryingConfigurationRefBase {
+public:
+  CountingConfigurationRef(const Eigen::VectorXd& q_ref)
+    : q_ref_(q_ref),
+      num_update_q_ref(0),
+      num_is_active(0) {
+  }
+
+  void update_q_ref(const Robot& robot, const double t, 
+                    Eigen::VectorXd& q_ref) const override {
+    q_ref = q_ref_;
+    ++num_update_q_ref;
+  }
+
+  bool isActive(const double t) const override {
+    ++num_is_active;
+    return true;
+  }
+
+  Eigen::VectorXd q_ref_;
+  mutable int num_update_q_ref, num_is_active;
+};
+
+
 class TimeVaryingConfigurationSpaceCostTest : public ::testing::Test {
 protected:
   virtual void SetUp() {
@@ -78,6 +102,7 @@ protected:
   void testStageCost(Robot& robot) const;
   void testTerminalCost(Robot& robot) const;
   void testImpulseCost(Robot& robot) const;
+  void testRefCache(Robot& robot) const;
 
   double dt, t, t0, tf;
 };
@@ -266,11 +291,46 @@ void TimeVaryingConfigurationSpaceCostTest::testImpulseCost(Robot& robot) const
 }
 
 
+void TimeVaryingConfigurationSpaceCostTest::testRefCache(Robot& robot) const {
+  const Eigen::VectorXd q_ref = robot.generateFeasibleConfiguration();
+  auto ref = std::make_shared<CountingConfigurationRef>(q_ref);
+  auto cost = std::make_shared<TimeVaryingConfigurationSpaceCost>(robot, ref);
+  cost->set_q_weight(Eigen::VectorXd::Random(robot.dimv()).array().abs());
+  CostFunctionData data(robot);
+  SplitKKTMatrix kkt_mat(robot);
+  SplitKKTResidual kkt_res(robot);
+  const SplitSolution s = SplitSolution::Random(robot);
+  const double l = cost->computeStageCost(robot, data, t, dt, s);
+  for (int i=0; i<3; ++i) {
+    EXPECT_DOUBLE_EQ(cost->computeStageCost(robot, data, t, dt, s), l);
+    cost->computeStageCostDerivatives(robot, data, t, dt, s, kkt_res);
+    cost->computeStageCostHessian(robot, data, t, dt, s, kkt_mat);
+  }
+  EXPECT_EQ(ref->num_is_active, 1);
+  EXPECT_EQ(ref->num_update_q_ref, 1);
+  EXPECT_EQ(data.ref_cache.size(), 1);
+  cost->computeStageCost(robot, data, t+dt, dt, s);
+  EXPECT_EQ(ref->num_is_active, 2);
+  EXPECT_EQ(ref->num_update_q_ref, 2);
+  ref->q_ref_ = robot.generateFeasibleConfiguration();
+  cost->invalidateRefCache();
+  cost->computeStageCost(robot, data, t+dt, dt, s);
+  EXPECT_EQ(ref->num_is_active, 3);
+  EXPECT_EQ(ref->num_update_q_ref, 3);
+  EXPECT_TRUE(data.ref_cache.entry(cost.get()).ref.isApprox(ref->q_ref_));
+  CostFunctionData other_data(robot);
+  cost->computeStageCost(robot, other_data, t+dt, dt, s);
+  EXPECT_EQ(ref->num_is_active, 4);
+  EXPECT_EQ(data.ref_cache.size(), 1);
+}
+
+
 TEST_F(TimeVaryingConfigurationSpaceCostTest, fixedBase) {
   auto robot = testhelper::CreateFixedBaseRobot(dt);
   testStageCost(robot);
   testTerminalCost(robot);
   testImpulseCost(robot);
+  testRefCache(robot);
 }
 
 
@@ -279,6 +339,7 @@ TEST_F(TimeVaryingConfigurationSpaceCostTest, floatingBase) {
   testStageCost(robot);
   testTerminalCost(robot);
   testImpulseCost(robot);
+  testRefCache(robot);
 }
 
 } // namespace idocp
@@ -34,6 +34,7 @@ protected:
   void test_constructor(const Robot& robot) const;
   void test_discretizeOCP(const Robot& robot) const;
   void test_discretizeOCPOnGrid(const Robot& robot) const;
+  void test_discretizeOCPNonUniformGrid(const Robot& robot) const;
 
   int N, max_num_events;
   double t, T, dt, min_dt;
@@ -229,11 +230,86 @@ void HybridTimeDiscretizationTest::test_discretizeOCPOnGrid(const Robot& robot)
 }
 
 
+void HybridTimeDiscretizationTest::test_discretizeOCPNonUniformGrid(const Robot& robot) const {
+  const double ratio = 1.05;
+  std::vector<double> dt_grid(N), t_grid(N+1, 0);
+  for (int i=0; i<N; ++i) {
+    dt_grid[i] = T * std::pow(ratio, i) * (ratio-1) / (std::pow(ratio, N)-1);
+    t_grid[i+1] = t_grid[i] + dt_grid[i];
+  }
+  // Each discrete event is in the middle of every three grids.
+  ContactStatus pre_contact_status = robot.createContactStatus();
+  pre_contact_status.setRandom();
+  ContactSequence contact_sequence(robot, max_num_events);
+  contact_sequence.setContactStatusUniformly(pre_contact_status);
+  ContactStatus post_contact_status = pre_contact_status;
+  std::vector<int> grid_index;
+  for (int i=0; i<max_num_events; ++i) {
+    DiscreteEvent tmp(robot.maxPointContacts());
+    tmp.setDiscreteEvent(pre_contact_status, post_contact_status);
+    while (!tmp.existDiscreteEvent()) {
+      post_contact_status.setRandom();
+      tmp.setDiscreteEvent(pre_contact_status, post_contact_status);
+    }
+    grid_index.push_back(3*i+1);
+    const double event_time = t + 0.5 * (t_grid[3*i+1]+t_grid[3*i+2]);
+    contact_sequence.push_back(tmp, event_time, false);
+    pre_contact_status = post_contact_status;
+  }
+  HybridTimeDiscretization discretization(T, N, max_num_events);
+  discretization.setGeometricDiscretizationGrid(ratio);
+  HybridTimeDiscretization discretization_user(T, N, max_num_events);
+  discretization_user.setDiscretizationGrid(dt_grid);
+  discretization.discretize(contact_sequence, t);
+  discretization_user.discretize(contact_sequence, t);
+  EXPECT_EQ(discretization.N(), N);
+  EXPECT_EQ(discretization_user.N(), N);
+  for (int i=0; i<N; ++i) {
+    EXPECT_NEAR(discretization.dt_grid(i), dt_grid[i], min_dt);
+    EXPECT_NEAR(discretization.t(i), t+t_grid[i], min_dt);
+    EXPECT_NEAR(discretization.dt(i), discretization_user.dt(i), min_dt);
+    EXPECT_NEAR(discretization.t(i), discretization_user.t(i), min_dt);
+  }
+  EXPECT_DOUBLE_EQ(discretization.t(N), t+T);
+  int impulse_index = 0;
+  int lift_index = 0;
+  for (int event_index=0; event_index<max_num_events; ++event_index) {
+    const int stage = grid_index[event_index];
+    if (contact_sequence.eventType(event_index) == DiscreteEventType::Impulse) {
+      EXPECT_EQ(discretization.timeStageBeforeImpulse(impulse_index), stage);
+      EXPECT_NEAR(discretization.dt(stage)+discretization.dt_aux(impulse_index), 
+                  dt_grid[stage], min_dt);
+      EXPECT_NEAR(discretization.dt(stage), 0.5*dt_grid[stage], min_dt);
+      ++impulse_index;
+    }
+    else {
+      EXPECT_EQ(discretization.timeStageBeforeLift(lift_index), stage);
+      EXPECT_NEAR(discretization.dt(stage)+discretization.dt_lift(lift_index), 
+                  dt_grid[stage], min_dt);
+      EXPECT_NEAR(discretization.dt(stage), 0.5*dt_grid[stage], min_dt);
+      ++lift_index;
+    }
+  }
+  for (int i=0; i<N; ++i) {
+    if (!discretization.isTimeStageBeforeImpulse(i) && !discretization.isTimeStageBeforeLift(i)) {
+      EXPECT_NEAR(discretization.dt(i), dt_grid[i], min_dt);
+    }
+  }
+  // The uniform grid is recovered by the ratio 1.
+  discretization.setGeometricDiscretizationGrid(1.0);
+  for (int i=0; i<N; ++i) {
+    EXPECT_DOUBLE_EQ(discretization.dt_grid(i), dt);
+  }
+  EXPECT_NO_THROW(discretization_user.showInfo());
+}
+
+
 TEST_F(HybridTimeDiscretizationTest, fixedBase) {
   auto robot = testhelper::CreateFixedBaseRobot(dt);
   test_constructor(robot);
   test_discretizeOCP(robot);
   test_discretizeOCPOnGrid(robot);
+  test_discretizeOCPNonUniformGrid(robot);
 }
 
 
@@ -242,6 +318,7 @@ TEST_F(HybridTimeDiscretizationTest, floatingBase) {
   test_constructor(robot);
   test_discretizeOCP(robot);
   test_discretizeOCPOnGrid(robot);
+  test_discretizeOCPNonUniformGrid(robot);
 }
 
 } // namespace idocp
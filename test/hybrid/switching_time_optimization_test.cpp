@@ -0,0 +1,317 @@
+#include <memory>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/utils/aligned_vector.hpp"
+#include "idocp/cost/cost_function.hpp"
+#include "idocp/cost/configuration_space_cost.hpp"
+#include "idocp/constraints/constraints.hpp"
+#include "idocp/ocp/ocp.hpp"
+#include "idocp/ocp/kkt_matrix.hpp"
+#include "idocp/ocp/kkt_residual.hpp"
+#include "idocp/ocp/direct_multiple_shooting.hpp"
+#include "idocp/hybrid/contact_sequence.hpp"
+#include "idocp/hybrid/switching_time_optimization.hpp"
+
+#include "robot_factory.hpp"
+#include "contact_sequence_factory.hpp"
+#include "solution_factory.hpp"
+#include "cost_factory.hpp"
+#include "constraints_factory.hpp"
+
+
+namespace idocp {
+
+class SwitchingTimeOptimizationTest : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    srand((unsigned int) time(0));
+    N = 20;
+    max_num_impulse = 5;
+    nthreads = 4;
+    T = 1;
+    t = std::abs(Eigen::VectorXd::Random(1)[0]);
+    dt = T / N;
+  }
+
+  virtual void TearDown() {
+  }
+
+  ContactSequence createContactSequence(const Robot& robot) const;
+  double lagrangian(OCP& ocp, aligned_vector<Robot>& robots,
+                    const ContactSequence& contact_sequence,
+                    const Eigen::VectorXd& q, const Eigen::VectorXd& v,
+                    const Solution& s) const;
+  void testGradient(const Robot& robot) const;
+  void test(const Robot& robot, const bool sto) const;
+
+  int N, max_num_impulse, nthreads;
+  double T, t, dt;
+};
+
+
+ContactSequence SwitchingTimeOptimizationTest::createContactSequence(
+    const Robot& robot) const {
+  // The events are in the middle of the grid intervals so that the small
+  // perturbations of the switching times do not change the discretization.
+  auto contact_status = robot.createContactStatus();
+  ContactSequence contact_sequence(robot, max_num_impulse);
+  contact_sequence.setContactStatusUniformly(contact_status);
+  const std::vector<double> event_stages = {2.5, 6.5, 10.5, 14.5};
+  for (int i=0; i<event_stages.size(); ++i) {
+    if (i%2 == 0) {
+      contact_status.activateContacts();
+    }
+    else {
+      contact_status.deactivateContacts();
+    }
+    const double perturbation = 0.2 * Eigen::VectorXd::Random(1)[0];
+    contact_sequence.push_back(contact_status,
+                               t+(event_stages[i]+perturbation)*dt, true);
+  }
+  return contact_sequence;
+}
+
+
+double SwitchingTimeOptimizationTest::lagrangian(
+    OCP& ocp, aligned_vector<Robot>& robots,
+    const ContactSequence& contact_sequence, const Eigen::VectorXd& q,
+    const Eigen::VectorXd& v, const Solution& s) const {
+  ocp.discretize(contact_sequence, t);
+  KKTMatrix kkt_matrix(robots[0], N, max_num_impulse);
+  KKTResidual kkt_residual(robots[0], N, max_num_impulse);
+  DirectMultipleShooting dms(N, max_num_impulse, nthreads);
+  dms.computeKKTResidual(ocp, robots, contact_sequence, q, v, s, kkt_matrix,
+                         kkt_residual);
+  const auto& discretization = ocp.discrete();
+  // Only the terms that depend on the time steps are summed up.
+  double L = 0;
+  auto stageLagrangian = [&](const SplitOCP& split_ocp,
+                             const SplitKKTResidual& split_kkt_residual,
+                             const Eigen::VectorXd& lmd_next,
+                             const Eigen::VectorXd& gmm_next) {
+    return split_ocp.stageCost() + lmd_next.dot(split_kkt_residual.Fq())
+                                 + gmm_next.dot(split_kkt_residual.Fv());
+  };
+  for (int i=0; i<discretization.N(); ++i) {
+    if (discretization.isTimeStageBeforeImpulse(i)) {
+      const int impulse_index = discretization.impulseIndexAfterTimeStage(i);
+      L += stageLagrangian(ocp[i], kkt_residual[i], s.impulse[impulse_index].lmd,
+                           s.impulse[impulse_index].gmm);
+    }
+    else if (discretization.isTimeStageBeforeLift(i)) {
+      const int lift_index = discretization.liftIndexAfterTimeStage(i);
+      L += stageLagrangian(ocp[i], kkt_residual[i], s.lift[lift_index].lmd,
+                           s.lift[lift_index].gmm);
+    }
+    else {
+      L += stageLagrangian(ocp[i], kkt_residual[i], s[i+1].lmd, s[i+1].gmm);
+    }
+  }
+  for (int i=0; i<discretization.N_impulse(); ++i) {
+    const int stage = discretization.timeStageAfterImpulse(i);
+    L += stageLagrangian(ocp.aux[i], kkt_residual.aux[i], s[stage].lmd,
+                         s[stage].gmm);
+    if (discretization.timeStageBeforeImpulse(i) > 0) {
+      const int stage = discretization.timeStageBeforeImpulse(i) - 1;
+      L += s[stage].xi_stack().dot(kkt_residual.switching[i].P());
+    }
+  }
+  for (int i=0; i<discretization.N_lift(); ++i) {
+    const int stage = discretization.timeStageAfterLift(i);
+    L += stageLagrangian(ocp.lift[i], kkt_residual.lift[i], s[stage].lmd,
+                         s[stage].gmm);
+  }
+  return L;
+}
+
+
+void SwitchingTimeOptimizationTest::testGradient(const Robot& robot) const {
+  // The terms of the contact dynamics vanish with the zero multipliers and
+  // the time-invariant cost does not depend on the switching times.
+  auto cost = std::make_shared<CostFunction>();
+  auto config_cost = std::make_shared<ConfigurationSpaceCost>(robot);
+  config_cost->set_q_weight(Eigen::VectorXd::Random(robot.dimv()).array().abs());
+  config_cost->set_q_ref(robot.generateFeasibleConfiguration());
+  config_cost->set_v_weight(Eigen::VectorXd::Random(robot.dimv()).array().abs());
+  config_cost->set_v_ref(Eigen::VectorXd::Random(robot.dimv()));
+  config_cost->set_a_weight(Eigen::VectorXd::Random(robot.dimv()).array().abs());
+  config_cost->set_u_weight(Eigen::VectorXd::Random(robot.dimu()).array().abs());
+  cost->push_back(config_cost);
+  auto constraints = std::make_shared<Constraints>();
+  const auto contact_sequence = createContactSequence(robot);
+  aligned_vector<Robot> robots(nthreads, robot);
+  auto ocp = OCP(robot, cost, constraints, T, N, max_num_impulse);
+  ocp.discretize(contact_sequence, t);
+  const Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+  const Eigen::VectorXd v = Eigen::VectorXd::Random(robot.dimv());
+  auto s = testhelper::CreateSolution(robot, contact_sequence, T, N, max_num_impulse, t);
+  auto zeroMultipliers = [](SplitSolution& s) {
+    s.beta.setZero();
+    s.mu_stack().setZero();
+    s.set_mu_vector();
+    s.nu_passive.setZero();
+  };
+  for (int i=0; i<=N; ++i) {
+    zeroMultipliers(s[i]);
+  }
+  for (int i=0; i<ocp.discrete().N_impulse(); ++i) {
+    zeroMultipliers(s.aux[i]);
+  }
+  for (int i=0; i<ocp.discrete().N_lift(); ++i) {
+    zeroMultipliers(s.lift[i]);
+  }
+  KKTMatrix kkt_matrix(robot, N, max_num_impulse);
+  KKTResidual kkt_residual(robot, N, max_num_impulse);
+  DirectMultipleShooting dms(N, max_num_impulse, nthreads);
+  dms.computeKKTResidual(ocp, robots, contact_sequence, q, v, s, kkt_matrix,
+                         kkt_residual);
+  SwitchingTimeOptimization sto_opt(max_num_impulse);
+  sto_opt.computeKKTResidual(ocp, kkt_matrix, s);
+  const int N_impulse = ocp.discrete().N_impulse();
+  const int N_lift = ocp.discrete().N_lift();
+  ASSERT_EQ(N_impulse, 2);
+  ASSERT_EQ(N_lift, 2);
+  const double eps = 1.0e-05;
+  for (int i=0; i<N_impulse; ++i) {
+    auto contact_sequence_plus = contact_sequence;
+    auto contact_sequence_minus = contact_sequence;
+    contact_sequence_plus.updateImpulseTime(i, contact_sequence.impulseTime(i)+eps);
+    contact_sequence_minus.updateImpulseTime(i, contact_sequence.impulseTime(i)-eps);
+    const double grad_fd
+        = (lagrangian(ocp, robots, contact_sequence_plus, q, v, s)
+            - lagrangian(ocp, robots, contact_sequence_minus, q, v, s)) / (2*eps);
+    const double grad = sto_opt.impulseTimeGradient().coeff(i);
+    EXPECT_NEAR(grad, grad_fd, 1.0e-04*std::max(1.0, std::abs(grad_fd)));
+  }
+  for (int i=0; i<N_lift; ++i) {
+    auto contact_sequence_plus = contact_sequence;
+    auto contact_sequence_minus = contact_sequence;
+    contact_sequence_plus.updateLiftTime(i, contact_sequence.liftTime(i)+eps);
+    contact_sequence_minus.updateLiftTime(i, contact_sequence.liftTime(i)-eps);
+    const double grad_fd
+        = (lagrangian(ocp, robots, contact_sequence_plus, q, v, s)
+            - lagrangian(ocp, robots, contact_sequence_minus, q, v, s)) / (2*eps);
+    const double grad = sto_opt.liftTimeGradient().coeff(i);
+    EXPECT_NEAR(grad, grad_fd, 1.0e-04*std::max(1.0, std::abs(grad_fd)));
+  }
+}
+
+
+void SwitchingTimeOptimizationTest::test(const Robot& robot,
+                                         const bool sto) const {
+  auto cost = testhelper::CreateCost(robot);
+  auto constraints = testhelper::CreateConstraints(robot);
+  DirectMultipleShooting dms(N, max_num_impulse, nthreads);
+  const auto contact_sequence
+      = testhelper::CreateContactSequence(robot, N, max_num_impulse, t, 3*dt, sto);
+  KKTMatrix kkt_matrix(robot, N, max_num_impulse);
+  KKTResidual kkt_residual(robot, N, max_num_impulse);
+  aligned_vector<Robot> robots(nthreads, robot);
+  auto ocp = OCP(robot, cost, constraints, T, N, max_num_impulse);
+  ocp.discretize(contact_sequence, t);
+  const Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+  const Eigen::VectorXd v = Eigen::VectorXd::Random(robot.dimv());
+  auto s = testhelper::CreateSolution(robot, contact_sequence, T, N, max_num_impulse, t);
+  dms.initConstraints(ocp, robots, contact_sequence, s);
+  dms.computeKKTSystem(ocp, robots, contact_sequence, q, v, s, kkt_matrix, kkt_residual);
+  SwitchingTimeOptimization sto_opt(max_num_impulse);
+  const double hessian = 1.0e02;
+  const double max_step_size = 0.5 * dt;
+  sto_opt.setParameters(hessian, max_step_size);
+  sto_opt.computeKKTResidual(ocp, kkt_matrix, s);
+  sto_opt.computeDirection(ocp);
+  const auto discretization = ocp.discrete();
+  const int N_impulse = discretization.N_impulse();
+  const int N_lift = discretization.N_lift();
+  const Eigen::VectorXd impulse_grad = sto_opt.impulseTimeGradient();
+  const Eigen::VectorXd lift_grad = sto_opt.liftTimeGradient();
+  if (!sto) {
+    EXPECT_TRUE(impulse_grad.isZero());
+    EXPECT_TRUE(lift_grad.isZero());
+  }
+  EXPECT_DOUBLE_EQ(sto_opt.KKTError(),
+                   impulse_grad.head(N_impulse).squaredNorm()
+                    +lift_grad.head(N_lift).squaredNorm());
+  // The direction is the gradient step scaled by the constant Hessian and
+  // clipped by the maximum step size.
+  for (int i=0; i<N_impulse; ++i) {
+    const double dir_ref = std::max(-max_step_size,
+                                    std::min(max_step_size,
+                                             -impulse_grad.coeff(i)/hessian));
+    EXPECT_DOUBLE_EQ(sto_opt.impulseTimeDirection().coeff(i), dir_ref);
+  }
+  for (int i=0; i<N_lift; ++i) {
+    const double dir_ref = std::max(-max_step_size,
+                                    std::min(max_step_size,
+                                             -lift_grad.coeff(i)/hessian));
+    EXPECT_DOUBLE_EQ(sto_opt.liftTimeDirection().coeff(i), dir_ref);
+  }
+  auto contact_sequence_updated = contact_sequence;
+  sto_opt.integrateSwitchingTimes(ocp, 1.0, contact_sequence_updated);
+  for (int i=0; i<N_impulse; ++i) {
+    const double ts = contact_sequence.impulseTime(i);
+    const double ts_updated = contact_sequence_updated.impulseTime(i);
+    if (sto) {
+      EXPECT_LE(std::abs(ts_updated-ts), max_step_size+1.0e-12);
+    }
+    else {
+      EXPECT_DOUBLE_EQ(ts_updated, ts);
+    }
+  }
+  for (int i=0; i<N_lift; ++i) {
+    const double ts = contact_sequence.liftTime(i);
+    const double ts_updated = contact_sequence_updated.liftTime(i);
+    if (sto) {
+      EXPECT_LE(std::abs(ts_updated-ts), max_step_size+1.0e-12);
+    }
+    else {
+      EXPECT_DOUBLE_EQ(ts_updated, ts);
+    }
+  }
+  // The updated switching times keep the order of the events.
+  double t_prev = t;
+  int impulse_index = 0;
+  int lift_index = 0;
+  for (int i=0; i<N_impulse+N_lift; ++i) {
+    double ts;
+    if (contact_sequence_updated.eventType(i) == DiscreteEventType::Impulse) {
+      ts = contact_sequence_updated.impulseTime(impulse_index);
+      ++impulse_index;
+    }
+    else {
+      ts = contact_sequence_updated.liftTime(lift_index);
+      ++lift_index;
+    }
+    EXPECT_TRUE(ts > t_prev);
+    t_prev = ts;
+  }
+  EXPECT_TRUE(t_prev < t+T);
+}
+
+
+TEST_F(SwitchingTimeOptimizationTest, fixedBase) {
+  auto robot = testhelper::CreateFixedBaseRobot(dt);
+  testGradient(robot);
+  test(robot, false);
+  test(robot, true);
+}
+
+
+TEST_F(SwitchingTimeOptimizationTest, floatingBase) {
+  auto robot = testhelper::CreateFloatingBaseRobot(dt);
+  testGradient(robot);
+  test(robot, false);
+  test(robot, true);
+}
+
+} // namespace idocp
+
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -36,6 +36,8 @@ protected:
                                       const ImpulseStatus& impulse_status);
   static void test_computeKKTSystem(Robot& robot, 
                                     const ImpulseStatus& impulse_status);
+  static void test_computeKKTSystemMultiLevel(
+      Robot& robot, const ImpulseStatus& impulse_status);
   static void test_evalOCP(Robot& robot, const ImpulseStatus& impulse_status);
 };
 
@@ -172,15 +174,45 @@ void ImpulseSplitOCPTest::test_evalOCP(Robot& robot, const ImpulseStatus& impuls
 }
 
 
+void ImpulseSplitOCPTest::test_computeKKTSystemMultiLevel(
+    Robot& robot, const ImpulseStatus& impulse_status) {
+  const auto s_prev = SplitSolution::Random(robot);
+  const auto s = ImpulseSplitSolution::Random(robot, impulse_status);
+  const auto s_next = SplitSolution::Random(robot);
+  auto cost = testhelper::CreateCost(robot);
+  auto constraints = testhelper::CreateConstraints(robot);
+  ImpulseSplitOCP ocp(robot, cost, constraints);
+  const double t = std::abs(Eigen::VectorXd::Random(1)[0]);
+  ocp.initConstraints(robot, s);
+  ImpulseSplitKKTMatrix kkt_matrix_ref(robot);
+  ImpulseSplitKKTResidual kkt_residual_ref(robot);
+  ocp.computeKKTSystem(robot, impulse_status, t, s_prev.q, s, s_next, 
+                       kkt_matrix_ref, kkt_residual_ref, IterationLevel::Full);
+  // At the same point, the other levels must reproduce the full KKT residual
+  // without modifying the KKT matrix.
+  for (const auto level : {IterationLevel::Jacobian, IterationLevel::Residual}) {
+    auto kkt_matrix = kkt_matrix_ref;
+    ImpulseSplitKKTResidual kkt_residual(robot);
+    kkt_residual.setRandom();
+    ocp.computeKKTSystem(robot, impulse_status, t, s_prev.q, s, s_next, 
+                         kkt_matrix, kkt_residual, level);
+    EXPECT_TRUE(kkt_matrix.isApprox(kkt_matrix_ref));
+    EXPECT_TRUE(kkt_residual.isApprox(kkt_residual_ref));
+  }
+}
+
+
 TEST_F(ImpulseSplitOCPTest, fixedBase) {
   const double dt = 0.001;
   auto robot = testhelper::CreateFixedBaseRobot(dt);
   auto impulse_status = robot.createImpulseStatus();
   test_computeKKTSystem(robot, impulse_status);
+  test_computeKKTSystemMultiLevel(robot, impulse_status);
   test_computeKKTResidual(robot, impulse_status);
   test_evalOCP(robot, impulse_status);
   impulse_status.activateImpulse(0);
   test_computeKKTSystem(robot, impulse_status);
+  test_computeKKTSystemMultiLevel(robot, impulse_status);
   test_computeKKTResidual(robot, impulse_status);
   test_evalOCP(robot, impulse_status);
 }
@@ -191,6 +223,7 @@ TEST_F(ImpulseSplitOCPTest, floatingBase) {
   auto robot = testhelper::CreateFloatingBaseRobot(dt);
   auto impulse_status = robot.createImpulseStatus();
   test_computeKKTSystem(robot, impulse_status);
+  test_computeKKTSystemMultiLevel(robot, impulse_status);
   test_computeKKTResidual(robot, impulse_status);
   test_evalOCP(robot, impulse_status);
   impulse_status.setRandom();
@@ -198,6 +231,7 @@ TEST_F(ImpulseSplitOCPTest, floatingBase) {
     impulse_status.activateImpulse(0);
   }
   test_computeKKTSystem(robot, impulse_status);
+  test_computeKKTSystemMultiLevel(robot, impulse_status);
   test_computeKKTResidual(robot, impulse_status);
   test_evalOCP(robot, impulse_status);
 }
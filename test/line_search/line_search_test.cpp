@@ -1,13 +1,17 @@
 #include <memory>
+#include <algorithm>
 
 #include <gtest/gtest.h>
 
 #include "Eigen/Core"
 
 #include "idocp/robot/robot.hpp"
+#include "idocp/utils/aligned_vector.hpp"
 #include "idocp/hybrid/contact_sequence.hpp"
+#include "idocp/constraints/constraints.hpp"
 #include "idocp/ocp/ocp.hpp"
 #include "idocp/ocp/direct_multiple_shooting.hpp"
+#include "idocp/riccati/riccati_recursion.hpp"
 #include "idocp/line_search/line_search_filter.hpp"
 #include "idocp/line_search/line_search.hpp"
 
@@ -46,6 +50,14 @@ protected:
   ContactSequence createContactSequence(const Robot& robot) const;
 
   void test(const Robot& robot) const;
+  void testSecondOrderCorrection(const Robot& robot) const;
+  void testSecondOrderCorrectionOfRejectedStep(const Robot& robot) const;
+  double stateEquationViolation(OCP& ocp, aligned_vector<Robot>& robots, 
+                                const ContactSequence& contact_sequence, 
+                                const Eigen::VectorXd& q, 
+                                const Eigen::VectorXd& v, const Solution& s, 
+                                const Direction& d, 
+                                const double step_size) const;
 
   int N, max_num_impulse, nthreads;
   double T, t, dt, step_size_reduction_rate, min_step_size;
@@ -107,11 +119,173 @@ void LineSearchTest::test(const Robot& robot) const {
 }
 
 
+void LineSearchTest::testSecondOrderCorrection(const Robot& robot) const {
+  auto cost = testhelper::CreateCost(robot);
+  auto constraints = testhelper::CreateConstraints(robot);
+  const auto contact_sequence = createContactSequence(robot);
+  auto kkt_matrix = KKTMatrix(robot, N, max_num_impulse);
+  auto kkt_residual = KKTResidual(robot, N, max_num_impulse);
+  const auto s = createSolution(robot, contact_sequence);
+  auto d = Direction(robot, N, max_num_impulse);
+  const Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+  const Eigen::VectorXd v = Eigen::VectorXd::Random(robot.dimv());
+  std::vector<Robot, Eigen::aligned_allocator<Robot>> robots(nthreads, robot);
+  auto ocp = OCP(robot, cost, constraints, T, N, max_num_impulse);
+  ocp.discretize(contact_sequence, t);
+  DirectMultipleShooting dms(N, max_num_impulse, nthreads);
+  dms.initConstraints(ocp, robots, contact_sequence, s);
+  dms.computeKKTSystem(ocp, robots, contact_sequence, q, v, s, kkt_matrix, kkt_residual);
+  RiccatiRecursion riccati_recursion(robot, N, max_num_impulse, nthreads);
+  RiccatiFactorization factorization(robot, N, max_num_impulse);
+  riccati_recursion.backwardRiccatiRecursion(ocp, kkt_matrix, kkt_residual, factorization);
+  dms.computeInitialStateDirection(ocp, robots, q, v, s, d);
+  riccati_recursion.forwardRiccatiRecursion(ocp, kkt_matrix, kkt_residual, d);
+  riccati_recursion.computeDirection(ocp, factorization, s, d);
+  const double max_primal_step_size = riccati_recursion.maxPrimalStepSize();
+  LineSearch line_search(robot, N, max_num_impulse, nthreads);
+  EXPECT_FALSE(line_search.secondOrderCorrection());
+  line_search.setSecondOrderCorrection(true);
+  EXPECT_TRUE(line_search.secondOrderCorrection());
+  const double step_size = line_search.computeStepSize(ocp, robots, contact_sequence, q, v, s, d, 
+                                                       max_primal_step_size, riccati_recursion, 
+                                                       kkt_matrix, factorization);
+  EXPECT_TRUE(step_size <= std::max(max_primal_step_size, min_step_size));
+  EXPECT_TRUE(step_size >= min_step_size);
+  EXPECT_FALSE(line_search.isFilterEmpty());
+}
+
+
+double LineSearchTest::stateEquationViolation(
+    OCP& ocp, aligned_vector<Robot>& robots, 
+    const ContactSequence& contact_sequence, const Eigen::VectorXd& q, 
+    const Eigen::VectorXd& v, const Solution& s, const Direction& d, 
+    const double step_size) const {
+  const Robot& robot = robots[0];
+  auto s_trial = s;
+  auto integrate = [&](const SplitSolution& s, const SplitDirection& d, 
+                       SplitSolution& s_trial) {
+    robot.integrateConfiguration(s.q, d.dq(), step_size, s_trial.q);
+    s_trial.v = s.v + step_size * d.dv();
+    s_trial.a = s.a + step_size * d.da();
+    s_trial.u = s.u + step_size * d.du;
+    if (s.hasActiveContacts()) {
+      s_trial.f_stack() = s.f_stack() + step_size * d.df();
+      s_trial.set_f_vector();
+    }
+  };
+  const int N_discrete = ocp.discrete().N();
+  const int N_impulse = ocp.discrete().N_impulse();
+  const int N_lift = ocp.discrete().N_lift();
+  for (int i=0; i<N_discrete; ++i) {
+    integrate(s[i], d[i], s_trial[i]);
+  }
+  robot.integrateConfiguration(s[N_discrete].q, d[N_discrete].dq(), step_size, 
+                               s_trial[N_discrete].q);
+  s_trial[N_discrete].v = s[N_discrete].v + step_size * d[N_discrete].dv();
+  for (int i=0; i<N_impulse; ++i) {
+    robot.integrateConfiguration(s.impulse[i].q, d.impulse[i].dq(), step_size, 
+                                 s_trial.impulse[i].q);
+    s_trial.impulse[i].v = s.impulse[i].v + step_size * d.impulse[i].dv();
+    s_trial.impulse[i].dv = s.impulse[i].dv + step_size * d.impulse[i].ddv();
+    s_trial.impulse[i].f_stack() = s.impulse[i].f_stack() 
+                                    + step_size * d.impulse[i].df();
+    s_trial.impulse[i].set_f_vector();
+    integrate(s.aux[i], d.aux[i], s_trial.aux[i]);
+  }
+  for (int i=0; i<N_lift; ++i) {
+    integrate(s.lift[i], d.lift[i], s_trial.lift[i]);
+  }
+  auto kkt_matrix = KKTMatrix(robot, N, max_num_impulse);
+  auto kkt_residual = KKTResidual(robot, N, max_num_impulse);
+  DirectMultipleShooting dms(N, max_num_impulse, nthreads);
+  dms.computeKKTResidual(ocp, robots, contact_sequence, q, v, s_trial, 
+                         kkt_matrix, kkt_residual);
+  double violation = 0;
+  for (int i=0; i<N_discrete; ++i) {
+    violation += kkt_residual[i].Fx.squaredNorm();
+  }
+  for (int i=0; i<N_impulse; ++i) {
+    violation += kkt_residual.impulse[i].Fx.squaredNorm();
+    violation += kkt_residual.aux[i].Fx.squaredNorm();
+  }
+  for (int i=0; i<N_lift; ++i) {
+    violation += kkt_residual.lift[i].Fx.squaredNorm();
+  }
+  return violation;
+}
+
+
+void LineSearchTest::testSecondOrderCorrectionOfRejectedStep(
+    const Robot& robot) const {
+  auto cost = testhelper::CreateCost(robot);
+  auto constraints = std::make_shared<Constraints>();
+  const auto contact_sequence = createContactSequence(robot);
+  auto kkt_matrix = KKTMatrix(robot, N, max_num_impulse);
+  auto kkt_residual = KKTResidual(robot, N, max_num_impulse);
+  const auto s = createSolution(robot, contact_sequence);
+  auto d = Direction(robot, N, max_num_impulse);
+  const Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+  const Eigen::VectorXd v = Eigen::VectorXd::Random(robot.dimv());
+  std::vector<Robot, Eigen::aligned_allocator<Robot>> robots(nthreads, robot);
+  auto ocp = OCP(robot, cost, constraints, T, N, max_num_impulse);
+  ocp.discretize(contact_sequence, t);
+  DirectMultipleShooting dms(N, max_num_impulse, nthreads);
+  dms.initConstraints(ocp, robots, contact_sequence, s);
+  dms.computeKKTSystem(ocp, robots, contact_sequence, q, v, s, kkt_matrix, kkt_residual);
+  RiccatiRecursion riccati_recursion(robot, N, max_num_impulse, nthreads);
+  RiccatiFactorization factorization(robot, N, max_num_impulse);
+  ASSERT_TRUE(riccati_recursion.backwardRiccatiRecursion(ocp, kkt_matrix, kkt_residual, factorization));
+  dms.computeInitialStateDirection(ocp, robots, q, v, s, d);
+  riccati_recursion.forwardRiccatiRecursion(ocp, kkt_matrix, kkt_residual, d);
+  riccati_recursion.computeDirection(ocp, factorization, s, d);
+  // The step size is kept below 1 so that the trial point violates the state
+  // equations.
+  const double max_primal_step_size = 0.5;
+  LineSearch line_search(robot, N, max_num_impulse, nthreads);
+  const double step_size = line_search.computeStepSize(ocp, robots, contact_sequence, q, v, s, d, 
+                                                       max_primal_step_size);
+  ASSERT_TRUE(step_size > min_step_size);
+  EXPECT_FALSE(line_search.isSecondOrderCorrectionComputed());
+  // The filter has already accepted the same trial point, so the full step is 
+  // rejected and the second-order correction is computed.
+  const auto d_plain = d;
+  line_search.setSecondOrderCorrection(true);
+  const double step_size_soc 
+      = line_search.computeStepSize(ocp, robots, contact_sequence, q, v, s, d, 
+                                    step_size, riccati_recursion, kkt_matrix, 
+                                    factorization);
+  EXPECT_TRUE(step_size_soc <= step_size);
+  EXPECT_TRUE(step_size_soc >= min_step_size);
+  EXPECT_TRUE(line_search.isSecondOrderCorrectionComputed());
+  const auto& d_corrected = line_search.correctedDirection();
+  const double violation_plain 
+      = stateEquationViolation(ocp, robots, contact_sequence, q, v, s, d_plain, 
+                               step_size);
+  const double violation_corrected 
+      = stateEquationViolation(ocp, robots, contact_sequence, q, v, s, 
+                               d_corrected, step_size);
+  EXPECT_LT(violation_corrected, violation_plain);
+  // The primal direction is replaced only if the corrected step is accepted.
+  if (step_size_soc == step_size) {
+    EXPECT_TRUE(d[0].dx.isApprox(d_corrected[0].dx));
+    EXPECT_TRUE(d[0].du.isApprox(d_corrected[0].du));
+  }
+  else {
+    EXPECT_TRUE(d[0].dx.isApprox(d_plain[0].dx));
+    EXPECT_TRUE(d[0].du.isApprox(d_plain[0].du));
+  }
+}
+
+
 TEST_F(LineSearchTest, fixedBase) {
   auto robot = testhelper::CreateFixedBaseRobot();
   test(robot);
   robot = testhelper::CreateFixedBaseRobot(dt);
   test(robot);
+  testSecondOrderCorrection(robot);
+  // The state equations of the fixed-base robot are linear, so the corrected
+  // step reduces their violation.
+  testSecondOrderCorrectionOfRejectedStep(robot);
 }
 
 
@@ -120,6 +294,7 @@ TEST_F(LineSearchTest, floatingBase) {
   test(robot);
   robot = testhelper::CreateFloatingBaseRobot(dt);
   test(robot);
+  testSecondOrderCorrection(robot);
 }
 
 } // namespace idocp
@@ -0,0 +1,181 @@
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/solver/control_policy.hpp"
+#include "idocp/utils/real_time_profile.hpp"
+#include "idocp/mpc/async_mpc.hpp"
+
+#include "robot_factory.hpp"
+
+
+namespace idocp {
+
+///
+/// @brief MPC whose control input is q + v of the latest state. Throws at the
+/// num_throw-th call of updateSolution() if num_throw is non-negative.
+///
+class MPCMock {
+public:
+  MPCMock(const Robot& robot)
+    : num_updates(0),
+      num_throw(-1),
+      is_profile_applied(false),
+      t_(0),
+      u_(Eigen::VectorXd::Zero(robot.dimu())) {
+  }
+
+  void updateSolution(const double t, const Eigen::VectorXd& q,
+                      const Eigen::VectorXd& v, const int num_iteration) {
+    if (num_updates.load() == num_throw.load()) {
+      num_throw = -1;
+      throw std::runtime_error("MPCMock failed!");
+    }
+    t_ = t;
+    u_ = q.head(u_.size()) + v.head(u_.size());
+    ++num_updates;
+  }
+
+  void getControlPolicy(ControlPolicy& policy) const {
+    policy.t = t_;
+    policy.u = u_;
+  }
+
+  bool applyRealTimeProfile(const RealTimeProfile& profile, const double t,
+                            const Eigen::VectorXd& q,
+                            const Eigen::VectorXd& v) {
+    is_profile_applied = true;
+    return true;
+  }
+
+  std::atomic<int> num_updates, num_throw;
+  std::atomic<bool> is_profile_applied;
+
+private:
+  double t_;
+  Eigen::VectorXd u_;
+
+};
+
+
+class AsyncMPCTest : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    srand((unsigned int) time(0));
+    robot = testhelper::CreateFixedBaseRobot();
+    q = Eigen::VectorXd::Random(robot.dimq());
+    v = Eigen::VectorXd::Random(robot.dimv());
+    t = std::abs(Eigen::VectorXd::Random(1)[0]);
+  }
+
+  virtual void TearDown() {
+  }
+
+  template <typename Predicate>
+  static bool waitFor(Predicate pred) {
+    const auto deadline
+        = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!pred()) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  }
+
+  Robot robot;
+  Eigen::VectorXd q, v;
+  double t;
+};
+
+
+TEST_F(AsyncMPCTest, solve) {
+  MPCMock mpc(robot);
+  AsyncMPC<MPCMock> async_mpc(mpc, robot);
+  EXPECT_FALSE(async_mpc.isRunning());
+  EXPECT_EQ(async_mpc.numSolves(), 0);
+  EXPECT_TRUE(async_mpc.getControlInput().isZero());
+  async_mpc.setRealTimeProfile(RealTimeProfile());
+  async_mpc.start();
+  EXPECT_TRUE(async_mpc.isRunning());
+  async_mpc.start();
+  EXPECT_TRUE(async_mpc.isRunning());
+  async_mpc.setState(t, q, v);
+  ASSERT_TRUE(waitFor([&] { return async_mpc.numSolves() >= 1; }));
+  EXPECT_TRUE(mpc.is_profile_applied);
+  EXPECT_TRUE(async_mpc.getControlInput().isApprox(q+v));
+  EXPECT_DOUBLE_EQ(async_mpc.getControlPolicy().t, t);
+  // The background thread waits for a new state.
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(async_mpc.numSolves(), 1);
+  const Eigen::VectorXd q_next = Eigen::VectorXd::Random(robot.dimq());
+  async_mpc.setState(t+0.1, q_next, v);
+  ASSERT_TRUE(waitFor([&] { return async_mpc.numSolves() >= 2; }));
+  EXPECT_TRUE(async_mpc.getControlInput().isApprox(q_next+v));
+  async_mpc.stop();
+  EXPECT_FALSE(async_mpc.isRunning());
+  async_mpc.stop();
+  EXPECT_FALSE(async_mpc.isRunning());
+  EXPECT_FALSE(async_mpc.hasFailed());
+  EXPECT_NO_THROW(async_mpc.rethrowIfFailed());
+  // The states set while stopped are solved after restarting.
+  async_mpc.setState(t+0.2, q, v);
+  async_mpc.start();
+  ASSERT_TRUE(waitFor([&] { return async_mpc.numSolves() >= 3; }));
+  EXPECT_TRUE(async_mpc.getControlInput().isApprox(q+v));
+}
+
+
+TEST_F(AsyncMPCTest, failure) {
+  MPCMock mpc(robot);
+  AsyncMPC<MPCMock> async_mpc(mpc, robot);
+  async_mpc.start();
+  async_mpc.setState(t, q, v);
+  ASSERT_TRUE(waitFor([&] { return async_mpc.numSolves() >= 1; }));
+  mpc.num_throw = mpc.num_updates.load();
+  const Eigen::VectorXd q_next = Eigen::VectorXd::Random(robot.dimq());
+  async_mpc.setState(t+0.1, q_next, v);
+  ASSERT_TRUE(waitFor([&] { return async_mpc.hasFailed(); }));
+  EXPECT_FALSE(async_mpc.isRunning());
+  EXPECT_EQ(async_mpc.numSolves(), 1);
+  // The last policy before the failure is kept.
+  EXPECT_TRUE(async_mpc.getControlInput().isApprox(q+v));
+  EXPECT_THROW(async_mpc.rethrowIfFailed(), std::runtime_error);
+  EXPECT_FALSE(async_mpc.hasFailed());
+  EXPECT_NO_THROW(async_mpc.rethrowIfFailed());
+  // Restarts after the failure.
+  async_mpc.start();
+  EXPECT_TRUE(async_mpc.isRunning());
+  async_mpc.setState(t+0.2, q_next, v);
+  ASSERT_TRUE(waitFor([&] { return async_mpc.numSolves() >= 2; }));
+  EXPECT_TRUE(async_mpc.getControlInput().isApprox(q_next+v));
+}
+
+
+TEST_F(AsyncMPCTest, failureWithoutStop) {
+  MPCMock mpc(robot);
+  mpc.num_throw = 0;
+  {
+    AsyncMPC<MPCMock> async_mpc(mpc, robot);
+    async_mpc.start();
+    async_mpc.setState(t, q, v);
+    ASSERT_TRUE(waitFor([&] { return async_mpc.hasFailed(); }));
+    // The destructor joins the failed thread.
+  }
+  EXPECT_EQ(mpc.num_updates.load(), 0);
+}
+
+} // namespace idocp
+
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -22,6 +22,7 @@ protected:
 
   static void test(const Robot& robot, const ContactStatus& contact_status);
   static void testIsApprox(const Robot& robot, const ContactStatus& contact_status);
+  static void testSparsity(const Robot& robot, const ContactStatus& contact_status);
 
   double dt;
 };
@@ -163,15 +164,58 @@ void SplitKKTMatrixTest::testIsApprox(const Robot& robot, const ContactStatus& c
 }
 
 
+void SplitKKTMatrixTest::testSparsity(const Robot& robot, const ContactStatus& contact_status) {
+  SplitKKTMatrix kkt_mat(robot);
+  // Unknown patterns are treated as dense.
+  EXPECT_EQ(kkt_mat.QffSparsity(), BlockSparsity::Dense);
+  EXPECT_EQ(kkt_mat.QqfSparsity(), BlockSparsity::Dense);
+  kkt_mat.setContactStatus(contact_status);
+  EXPECT_EQ(kkt_mat.QffSparsity(), BlockSparsity::Dense);
+  EXPECT_EQ(kkt_mat.QqfSparsity(), BlockSparsity::Dense);
+  kkt_mat.Qff().setRandom();
+  kkt_mat.Qqf().setRandom();
+  kkt_mat.setZero();
+  EXPECT_TRUE(kkt_mat.Qff().isZero());
+  EXPECT_TRUE(kkt_mat.Qqf().isZero());
+  EXPECT_EQ(kkt_mat.QffSparsity(), BlockSparsity::Dense);
+  EXPECT_EQ(kkt_mat.QqfSparsity(), BlockSparsity::Dense);
+  // Values written without declaring a sparser pattern are cleared.
+  kkt_mat.Qff().setRandom();
+  kkt_mat.Qqf().setRandom();
+  kkt_mat.setZero();
+  EXPECT_TRUE(kkt_mat.Qff().isZero());
+  EXPECT_TRUE(kkt_mat.Qqf().isZero());
+  kkt_mat.setQffSparsity(BlockSparsity::Diagonal);
+  kkt_mat.setQqfSparsity(BlockSparsity::Zero);
+  EXPECT_EQ(kkt_mat.QffSparsity(), BlockSparsity::Diagonal);
+  EXPECT_EQ(kkt_mat.QqfSparsity(), BlockSparsity::Zero);
+  kkt_mat.setContactStatus(contact_status);
+  EXPECT_EQ(kkt_mat.QffSparsity(), BlockSparsity::Diagonal);
+  EXPECT_EQ(kkt_mat.QqfSparsity(), BlockSparsity::Zero);
+  kkt_mat.Qff().diagonal().setRandom();
+  kkt_mat.setZero();
+  EXPECT_TRUE(kkt_mat.Qff().isZero());
+  EXPECT_EQ(kkt_mat.QffSparsity(), BlockSparsity::Dense);
+  EXPECT_EQ(kkt_mat.QqfSparsity(), BlockSparsity::Dense);
+  kkt_mat.setQffSparsity(BlockSparsity::Zero);
+  kkt_mat.setQqfSparsity(BlockSparsity::Zero);
+  kkt_mat.setRandom();
+  EXPECT_EQ(kkt_mat.QffSparsity(), BlockSparsity::Dense);
+  EXPECT_EQ(kkt_mat.QqfSparsity(), BlockSparsity::Dense);
+}
+
+
 TEST_F(SplitKKTMatrixTest, fixedBase) {
   auto robot = testhelper::CreateFixedBaseRobot(dt);
   auto contact_status = robot.createContactStatus();
   contact_status.deactivateContact(0);
   test(robot, contact_status);
   testIsApprox(robot, contact_status);
+  testSparsity(robot, contact_status);
   contact_status.activateContact(0);
   test(robot, contact_status);
   testIsApprox(robot, contact_status);
+  testSparsity(robot, contact_status);
 }
 
 
@@ -181,12 +225,14 @@ TEST_F(SplitKKTMatrixTest, floatingBase) {
   contact_status.deactivateContacts();
   test(robot, contact_status);
   testIsApprox(robot, contact_status);
+  testSparsity(robot, contact_status);
   contact_status.setRandom();
   if (!contact_status.hasActiveContacts()) {
     contact_status.activateContact(0);
   }
   test(robot, contact_status);
   testIsApprox(robot, contact_status);
+  testSparsity(robot, contact_status);
 }
 
 } // namespace idocp
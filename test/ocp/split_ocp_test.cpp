@@ -41,6 +41,9 @@ protected:
                                const bool switching_constraint=false) const;
   void test_computeKKTSystem(Robot& robot, const ContactStatus& contact_status, 
                              const bool switching_constraint=false) const;
+  void test_computeKKTSystemMultiLevel(Robot& robot, 
+                                      const ContactStatus& contact_status, 
+                                      const bool switching_constraint=false) const;
   void test_evalOCP(Robot& robot, const ContactStatus& contact_status, 
                     const bool switching_constraint=false) const;
 
@@ -118,6 +121,10 @@ void SplitOCPTest::test_computeKKTResidual(Robot& robot,
   EXPECT_DOUBLE_EQ(stage_cost, ocp.stageCost());
   EXPECT_TRUE(kkt_matrix.isApprox(kkt_matrix_ref));
   EXPECT_TRUE(kkt_residual.isApprox(kkt_residual_ref));
+  const double hamiltonian_ref = stage_cost / dt + s_next.lmd.dot(s.v) 
+                                  + s_next.gmm.dot(s.a);
+  EXPECT_NEAR(ocp.hamiltonian(dt, s, s_next), hamiltonian_ref, 
+              1.0e-08*std::abs(hamiltonian_ref));
 }
 
 
@@ -220,6 +227,86 @@ void SplitOCPTest::test_computeKKTSystem(Robot& robot,
 }
 
 
+void SplitOCPTest::test_computeKKTSystemMultiLevel(
+    Robot& robot, const ContactStatus& contact_status, 
+    const bool switching_constraint) const {
+  ImpulseStatus impulse_status;
+  if (switching_constraint) {
+    impulse_status = robot.createImpulseStatus();
+    impulse_status.setRandom();
+    if (!impulse_status.hasActiveImpulse()) {
+      impulse_status.activateImpulse(0);
+    }
+  }
+  SplitSolution stmp;
+  if (switching_constraint) {
+    stmp = SplitSolution::Random(robot, contact_status, impulse_status);
+  }
+  else {
+    stmp = SplitSolution::Random(robot, contact_status);
+  }
+  const auto s_prev = SplitSolution::Random(robot, contact_status);
+  const auto s = stmp;
+  const auto s_next = SplitSolution::Random(robot, contact_status);
+  auto cost = testhelper::CreateCost(robot);
+  auto constraints = testhelper::CreateConstraints(robot);
+  SplitOCP ocp(robot, cost, constraints);
+  ocp.initConstraints(robot, 10, s);
+  SplitKKTMatrix kkt_matrix_ref(robot);
+  SplitKKTResidual kkt_residual_ref(robot);
+  SplitSwitchingConstraintJacobian switch_jac_ref(robot);
+  SplitSwitchingConstraintResidual switch_res_ref(robot);
+  if (switching_constraint) {
+    ocp.computeKKTSystem(robot, contact_status, t, dt, s_prev.q, s, s_next, 
+                         kkt_matrix_ref, kkt_residual_ref, impulse_status, 
+                         dt_next, switch_jac_ref, switch_res_ref, 
+                         IterationLevel::Full);
+  }
+  else {
+    ocp.computeKKTSystem(robot, contact_status, t, dt, s_prev.q, s, s_next, 
+                         kkt_matrix_ref, kkt_residual_ref, IterationLevel::Full);
+  }
+  // At the same point, the other levels must reproduce the full KKT system.
+  // The Jacobian level restores the Hessians of the last full evaluation.
+  auto kkt_matrix = kkt_matrix_ref;
+  kkt_matrix.Qxx.setRandom();
+  kkt_matrix.Qxu.setRandom();
+  kkt_matrix.Quu.setRandom();
+  SplitKKTResidual kkt_residual(robot);
+  SplitSwitchingConstraintJacobian switch_jac(robot);
+  SplitSwitchingConstraintResidual switch_res(robot);
+  for (const auto level : {IterationLevel::Jacobian, IterationLevel::Residual}) {
+    kkt_residual.setRandom();
+    if (switching_constraint) {
+      ocp.computeKKTSystem(robot, contact_status, t, dt, s_prev.q, s, s_next, 
+                           kkt_matrix, kkt_residual, impulse_status, dt_next, 
+                           switch_jac, switch_res, level);
+      EXPECT_TRUE(switch_jac.isApprox(switch_jac_ref));
+      EXPECT_TRUE(switch_res.isApprox(switch_res_ref));
+    }
+    else {
+      ocp.computeKKTSystem(robot, contact_status, t, dt, s_prev.q, s, s_next, 
+                           kkt_matrix, kkt_residual, level);
+    }
+    EXPECT_TRUE(kkt_matrix.isApprox(kkt_matrix_ref));
+    EXPECT_TRUE(kkt_residual.isApprox(kkt_residual_ref));
+  }
+  // The Residual level does not modify the KKT matrix.
+  kkt_matrix.Qxx.setRandom();
+  const auto kkt_matrix_random = kkt_matrix;
+  if (switching_constraint) {
+    ocp.computeKKTSystem(robot, contact_status, t, dt, s_prev.q, s, s_next, 
+                         kkt_matrix, kkt_residual, impulse_status, dt_next, 
+                         switch_jac, switch_res, IterationLevel::Residual);
+  }
+  else {
+    ocp.computeKKTSystem(robot, contact_status, t, dt, s_prev.q, s, s_next, 
+                         kkt_matrix, kkt_residual, IterationLevel::Residual);
+  }
+  EXPECT_TRUE(kkt_matrix.isApprox(kkt_matrix_random));
+}
+
+
 void SplitOCPTest::test_evalOCP(Robot& robot, const ContactStatus& contact_status, 
                                     const bool switching_constraint) const {
   ImpulseStatus impulse_status;
@@ -300,6 +387,7 @@ TEST_F(SplitOCPTest, fixedBase) {
   auto contact_status = robot.createContactStatus();
   test_computeKKTResidual(robot, contact_status);
   test_computeKKTSystem(robot, contact_status);
+  test_computeKKTSystemMultiLevel(robot, contact_status);
   test_evalOCP(robot, contact_status);
   contact_status.setRandom();
   if (!contact_status.hasActiveContacts()) {
@@ -307,9 +395,11 @@ TEST_F(SplitOCPTest, fixedBase) {
   }
   test_computeKKTResidual(robot, contact_status);
   test_computeKKTSystem(robot, contact_status);
+  test_computeKKTSystemMultiLevel(robot, contact_status);
   test_evalOCP(robot, contact_status);
   test_computeKKTResidual(robot, contact_status, true);
   test_computeKKTSystem(robot, contact_status, true);
+  test_computeKKTSystemMultiLevel(robot, contact_status, true);
   test_evalOCP(robot, contact_status, true);
 }
 
@@ -319,6 +409,7 @@ TEST_F(SplitOCPTest, floatingBase) {
   auto contact_status = robot.createContactStatus();
   test_computeKKTResidual(robot, contact_status);
   test_computeKKTSystem(robot, contact_status);
+  test_computeKKTSystemMultiLevel(robot, contact_status);
   test_evalOCP(robot, contact_status);
   contact_status.setRandom();
   if (!contact_status.hasActiveContacts()) {
@@ -326,9 +417,11 @@ TEST_F(SplitOCPTest, floatingBase) {
   }
   test_computeKKTResidual(robot, contact_status);
   test_computeKKTSystem(robot, contact_status);
+  test_computeKKTSystemMultiLevel(robot, contact_status);
   test_evalOCP(robot, contact_status);
   test_computeKKTResidual(robot, contact_status, true);
   test_computeKKTSystem(robot, contact_status, true);
+  test_computeKKTSystemMultiLevel(robot, contact_status, true);
   test_evalOCP(robot, contact_status, true);
 }
 
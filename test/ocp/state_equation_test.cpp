@@ -61,6 +61,10 @@ TEST_F(StateEquationTest, fixedbase) {
   auto d_ref = d;
   state_equation.correctCostateDirection(d);
   EXPECT_TRUE(d.isApprox(d_ref));
+  kkt_residual.Fx.setRandom();
+  const Eigen::VectorXd Fx_ref = kkt_residual.Fx;
+  state_equation.correctStateEquationResidual(kkt_residual);
+  EXPECT_TRUE(kkt_residual.Fx.isApprox(Fx_ref));
 }
 
 
@@ -111,6 +115,11 @@ TEST_F(StateEquationTest, floatingBase) {
   d_ref.dlmd().head(6) 
       = - dsubtract_dq_prev_inv.topLeftCorner(6, 6).transpose() * d_ref.dlmd().head(6);
   EXPECT_TRUE(d.isApprox(d_ref));
+  kkt_residual.Fx.setRandom();
+  Eigen::VectorXd Fx_ref = kkt_residual.Fx;
+  Fx_ref.head(6) = - dsubtract_dq_inv.topLeftCorner(6, 6) * kkt_residual.Fx.head(6);
+  state_equation.correctStateEquationResidual(kkt_residual);
+  EXPECT_TRUE(kkt_residual.Fx.isApprox(Fx_ref));
 }
 
 } // namespace idocp
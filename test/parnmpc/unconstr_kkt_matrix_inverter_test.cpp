@@ -47,6 +47,33 @@ TEST_F(UnconstrKKTMatrixInverterTest, test) {
   EXPECT_TRUE((KKT_mat_inv*KKT_mat_ref).isIdentity());
 }
 
+
+TEST_F(UnconstrKKTMatrixInverterTest, factorize) {
+  const int dimx = 2*robot.dimv();
+  const int dimH = 3*robot.dimv();
+  const int dimKKT = 5*robot.dimv();
+  const Eigen::MatrixXd H_seed_mat = Eigen::MatrixXd::Random(dimH, dimH);
+  const Eigen::MatrixXd H_mat = H_seed_mat * H_seed_mat.transpose() + Eigen::MatrixXd::Identity(dimH, dimH);
+  Eigen::MatrixXd KKT_mat_inv_ref = Eigen::MatrixXd::Zero(dimKKT, dimKKT);
+  UnconstrKKTMatrixInverter inverter(robot);
+  inverter.invert(dt, H_mat, KKT_mat_inv_ref);
+  inverter.factorize(dt, H_mat);
+  EXPECT_TRUE(inverter.auxMat().isApprox(KKT_mat_inv_ref.topLeftCorner(dimx, dimx)));
+  EXPECT_TRUE(inverter.couplingMat().isApprox(KKT_mat_inv_ref.topRightCorner(dimx, dimx)));
+  EXPECT_TRUE(inverter.couplingMat().transpose().isApprox(KKT_mat_inv_ref.bottomLeftCorner(dimx, dimx)));
+  const Eigen::VectorXd kkt_res = Eigen::VectorXd::Random(dimKKT);
+  Eigen::VectorXd d = Eigen::VectorXd::Zero(dimKKT);
+  inverter.solve(kkt_res, d);
+  EXPECT_TRUE(d.isApprox(KKT_mat_inv_ref*kkt_res));
+  const Eigen::VectorXd x = Eigen::VectorXd::Random(dimx);
+  const Eigen::VectorXd dx = inverter.couplingMat() * x;
+  Eigen::VectorXd dH = Eigen::VectorXd::Zero(dimH);
+  inverter.backwardCorrection(x, dx, dH);
+  EXPECT_TRUE(dH.isApprox(KKT_mat_inv_ref.block(dimx, dimKKT-dimx, dimH, dimx)*x));
+  inverter.forwardCorrection(x, dH);
+  EXPECT_TRUE(dH.isApprox(KKT_mat_inv_ref.topLeftCorner(dimKKT-dimx, dimx)*x));
+}
+
 } // namespace idocp
 
 
@@ -8,6 +8,7 @@
 #include "idocp/riccati/split_riccati_factorization.hpp"
 #include "idocp/riccati/lqr_policy.hpp"
 #include "idocp/riccati/backward_riccati_recursion_factorizer.hpp"
+#include "idocp/utils/simd_kernels.hpp"
 
 #include "robot_factory.hpp"
 #include "kkt_factory.hpp"
@@ -26,15 +27,16 @@ protected:
   virtual void TearDown() {
   }
 
-  void test(const Robot& robot) const;
+  void test(const Robot& robot, const bool mixed_precision) const;
 
-  void testImpulse(const Robot& robot) const;
+  void testImpulse(const Robot& robot, const bool mixed_precision) const;
 
   double dt;
 };
 
 
-void BackwardRiccatiRecursionFactorizerTest::test(const Robot& robot) const {
+void BackwardRiccatiRecursionFactorizerTest::test(const Robot& robot, 
+                                                  const bool mixed_precision) const {
   const int dimv = robot.dimv();
   const int dimu = robot.dimu();
   const auto riccati_next = testhelper::CreateSplitRiccatiFactorization(robot);
@@ -43,6 +45,10 @@ void BackwardRiccatiRecursionFactorizerTest::test(const Robot& robot) const {
   const auto kkt_matrix_ref = kkt_matrix;
   const auto kkt_residual_ref = kkt_residual;
   BackwardRiccatiRecursionFactorizer factorizer(robot);
+  factorizer.setMixedPrecision(mixed_precision);
+  EXPECT_EQ(factorizer.isMixedPrecision(), mixed_precision);
+  // The single-precision products are accurate up to the precision of float.
+  const double prec = mixed_precision ? 1.0e-05 : Eigen::NumTraits<double>::dummy_precision();
   factorizer.factorizeKKTMatrix(riccati_next, kkt_matrix, kkt_residual);
   const Eigen::MatrixXd A = kkt_matrix.Fxx;
   Eigen::MatrixXd B = Eigen::MatrixXd::Zero(2*dimv, dimu);
@@ -51,11 +57,11 @@ void BackwardRiccatiRecursionFactorizerTest::test(const Robot& robot) const {
   const Eigen::MatrixXd H_ref = kkt_matrix_ref.Qxu + A.transpose() * riccati_next.P * B;
   const Eigen::MatrixXd G_ref = kkt_matrix_ref.Quu + B.transpose() * riccati_next.P * B;
   const Eigen::VectorXd lu_ref = B.transpose() * riccati_next.P * kkt_residual_ref.Fx - B.transpose() * riccati_next.s + kkt_residual_ref.lu;
-  EXPECT_TRUE(F_ref.isApprox(kkt_matrix.Qxx));
-  EXPECT_TRUE(kkt_matrix.Qxx.isApprox(kkt_matrix.Qxx.transpose()));
-  EXPECT_TRUE(H_ref.isApprox(kkt_matrix.Qxu));
-  EXPECT_TRUE(G_ref.isApprox(kkt_matrix.Quu));
-  EXPECT_TRUE(kkt_matrix.Quu.isApprox(kkt_matrix.Quu.transpose()));
+  EXPECT_TRUE(F_ref.isApprox(kkt_matrix.Qxx, prec));
+  EXPECT_TRUE(kkt_matrix.Qxx.isApprox(kkt_matrix.Qxx.transpose(), prec));
+  EXPECT_TRUE(H_ref.isApprox(kkt_matrix.Qxu, prec));
+  EXPECT_TRUE(G_ref.isApprox(kkt_matrix.Quu, prec));
+  EXPECT_TRUE(kkt_matrix.Quu.isApprox(kkt_matrix.Quu.transpose(), prec));
   EXPECT_TRUE(lu_ref.isApprox(kkt_residual.lu));
   SplitRiccatiFactorization riccati(robot), riccati_ref(robot);
   LQRPolicy lqr_policy(robot);
@@ -64,12 +70,14 @@ void BackwardRiccatiRecursionFactorizerTest::test(const Robot& robot) const {
   factorizer.factorizeRiccatiFactorization(riccati_next, kkt_matrix, kkt_residual, lqr_policy, riccati);
   riccati_ref.P = F_ref - lqr_policy.K.transpose() * G_ref * lqr_policy.K;
   riccati_ref.s = A.transpose() * riccati_next.s - A.transpose() * riccati_next.P * kkt_residual_ref.Fx - kkt_residual_ref.lx - H_ref * lqr_policy.k;
-  EXPECT_TRUE(riccati.isApprox(riccati_ref));
+  EXPECT_TRUE(riccati.P.isApprox(riccati_ref.P, prec));
+  EXPECT_TRUE(riccati.s.isApprox(riccati_ref.s, prec));
   EXPECT_TRUE(riccati.P.isApprox(riccati.P.transpose()));
 }
 
 
-void BackwardRiccatiRecursionFactorizerTest::testImpulse(const Robot& robot) const {
+void BackwardRiccatiRecursionFactorizerTest::testImpulse(const Robot& robot, 
+                                                         const bool mixed_precision) const {
   const int dimv = robot.dimv();
   const auto riccati_next = testhelper::CreateSplitRiccatiFactorization(robot);
   auto kkt_matrix = testhelper::CreateImpulseSplitKKTMatrix(robot);
@@ -77,31 +85,60 @@ void BackwardRiccatiRecursionFactorizerTest::testImpulse(const Robot& robot) con
   const auto kkt_matrix_ref = kkt_matrix;
   const auto kkt_residual_ref = kkt_residual;
   BackwardRiccatiRecursionFactorizer factorizer(robot);
+  factorizer.setMixedPrecision(mixed_precision);
+  EXPECT_EQ(factorizer.isMixedPrecision(), mixed_precision);
+  // The single-precision products are accurate up to the precision of float.
+  const double prec = mixed_precision ? 1.0e-05 : Eigen::NumTraits<double>::dummy_precision();
   factorizer.factorizeKKTMatrix(riccati_next, kkt_matrix);
   const Eigen::MatrixXd A = kkt_matrix.Fxx;
   const Eigen::MatrixXd F_ref = kkt_matrix_ref.Qxx + A.transpose() * riccati_next.P * A;
-  EXPECT_TRUE(F_ref.isApprox(kkt_matrix.Qxx));
-  EXPECT_TRUE(kkt_matrix.Qxx.isApprox(kkt_matrix.Qxx.transpose()));
+  EXPECT_TRUE(F_ref.isApprox(kkt_matrix.Qxx, prec));
+  EXPECT_TRUE(kkt_matrix.Qxx.isApprox(kkt_matrix.Qxx.transpose(), prec));
   SplitRiccatiFactorization riccati(robot), riccati_ref(robot);
   factorizer.factorizeRiccatiFactorization(riccati_next, kkt_matrix, kkt_residual, riccati);
   riccati_ref.P = F_ref;
   riccati_ref.s = A.transpose() * riccati_next.s - A.transpose() * riccati_next.P * kkt_residual_ref.Fx - kkt_residual_ref.lx;
-  EXPECT_TRUE(riccati.isApprox(riccati_ref));
+  EXPECT_TRUE(riccati.P.isApprox(riccati_ref.P, prec));
+  EXPECT_TRUE(riccati.s.isApprox(riccati_ref.s, prec));
   EXPECT_TRUE(riccati.P.isApprox(riccati.P.transpose()));
 }
 
 
 TEST_F(BackwardRiccatiRecursionFactorizerTest, fixedBase) {
   auto robot = testhelper::CreateFixedBaseRobot(dt);
-  test(robot);
-  testImpulse(robot);
+  test(robot, false);
+  testImpulse(robot, false);
+  test(robot, true);
+  testImpulse(robot, true);
 }
 
 
 TEST_F(BackwardRiccatiRecursionFactorizerTest, floating_base) {
   auto robot = testhelper::CreateFloatingBaseRobot(dt);
-  test(robot);
-  testImpulse(robot);
+  test(robot, false);
+  testImpulse(robot, false);
+  test(robot, true);
+  testImpulse(robot, true);
+}
+
+TEST_F(BackwardRiccatiRecursionFactorizerTest, instructionSets) {
+  const auto default_instruction_set = simd::instructionSet();
+  for (const auto instruction_set : {simd::InstructionSet::Generic, 
+                                     simd::InstructionSet::AVX2, 
+                                     simd::InstructionSet::AVX512}) {
+    if (!simd::setInstructionSet(instruction_set)) {
+      EXPECT_FALSE(simd::isSupported(instruction_set));
+      continue;
+    }
+    EXPECT_EQ(simd::instructionSet(), instruction_set);
+    auto robot = testhelper::CreateFixedBaseRobot(dt);
+    test(robot, false);
+    testImpulse(robot, false);
+    robot = testhelper::CreateFloatingBaseRobot(dt);
+    test(robot, false);
+    testImpulse(robot, false);
+  }
+  EXPECT_TRUE(simd::setInstructionSet(default_instruction_set));
 }
 
 } // namespace idocp
@@ -14,6 +14,7 @@
 #include "idocp/riccati/lqr_policy.hpp"
 #include "idocp/riccati/backward_riccati_recursion_factorizer.hpp"
 #include "idocp/riccati/riccati_factorizer.hpp"
+#include "idocp/riccati/iteration_level.hpp"
 
 #include "robot_factory.hpp"
 #include "kkt_factory.hpp"
@@ -35,7 +36,11 @@ protected:
 
   void test_backwardRecursion(const Robot& robot) const;
   void test_backwardRecursionWithSwitchingConstraint(const Robot& robot) const;
+  void test_backwardRecursionRegularization(const Robot& robot) const;
   void test_backwardRecursionImpulse(const Robot& robot) const;
+  void test_multiLevelIteration(const Robot& robot) const;
+  void test_multiLevelIterationWithSwitchingConstraint(const Robot& robot) const;
+  void test_multiLevelIterationImpulse(const Robot& robot) const;
   void test_forwardRecursion(const Robot& robot) const;
   void test_forwardRecursionImpulse(const Robot& robot) const;
 
@@ -135,6 +140,52 @@ void RiccatiFactorizerTest::test_backwardRecursionWithSwitchingConstraint(const
 }
 
 
+void RiccatiFactorizerTest::test_backwardRecursionRegularization(const Robot& robot) const {
+  const int dimu = robot.dimu();
+  const auto riccati_next = testhelper::CreateSplitRiccatiFactorization(robot);
+  auto kkt_matrix = testhelper::CreateSplitKKTMatrix(robot, dt);
+  auto kkt_residual = testhelper::CreateSplitKKTResidual(robot);
+  // Makes Quu indefinite so that the Cholesky factorization fails.
+  kkt_matrix.Quu.diagonal().array() -= 1.0e04;
+  auto kkt_matrix_ref = kkt_matrix;
+  auto kkt_residual_ref = kkt_residual;
+  RiccatiFactorizer factorizer(robot);
+  EXPECT_DOUBLE_EQ(factorizer.regularization(), 0);
+  LQRPolicy lqr_policy(robot), lqr_policy_ref(robot);
+  BackwardRiccatiRecursionFactorizer backward_recursion_ref(robot);
+  auto riccati = testhelper::CreateSplitRiccatiFactorization(robot);
+  auto riccati_ref = riccati;
+  factorizer.backwardRiccatiRecursion(riccati_next, kkt_matrix, kkt_residual, riccati, lqr_policy);
+  const double reg = factorizer.regularization();
+  EXPECT_TRUE(reg > 0);
+  EXPECT_FALSE(factorizer.hasFailed());
+  EXPECT_FALSE(lqr_policy.K.hasNaN());
+  EXPECT_FALSE(lqr_policy.k.hasNaN());
+  EXPECT_FALSE(riccati.P.hasNaN());
+  backward_recursion_ref.factorizeKKTMatrix(riccati_next, kkt_matrix_ref, kkt_residual_ref);
+  kkt_matrix_ref.Quu.diagonal().array() += reg;
+  EXPECT_TRUE(kkt_matrix.Quu.isApprox(kkt_matrix_ref.Quu));
+  Eigen::MatrixXd Ginv = kkt_matrix_ref.Quu.llt().solve(Eigen::MatrixXd::Identity(dimu, dimu));
+  lqr_policy_ref.K = - Ginv  * kkt_matrix_ref.Qxu.transpose();
+  lqr_policy_ref.k = - Ginv  * kkt_residual.lu;
+  backward_recursion_ref.factorizeRiccatiFactorization(riccati_next, kkt_matrix_ref, kkt_residual_ref, lqr_policy_ref, riccati_ref);
+  EXPECT_TRUE(riccati.isApprox(riccati_ref));
+  EXPECT_TRUE(lqr_policy_ref.isApprox(lqr_policy));
+  factorizer.resetRegularization();
+  EXPECT_DOUBLE_EQ(factorizer.regularization(), 0);
+  // The failure is reported if the maximum regularization is not enough.
+  RiccatiFactorizer factorizer_failed(robot);
+  factorizer_failed.setRegularizationParameters(1.0e-08, 1.0e-04, 10);
+  auto kkt_matrix_failed = kkt_matrix_ref;
+  kkt_matrix_failed.Quu.diagonal().array() -= 2.0e04;
+  factorizer_failed.backwardRiccatiRecursion(riccati_next, kkt_matrix_failed, 
+                                             kkt_residual, riccati, lqr_policy);
+  EXPECT_TRUE(factorizer_failed.hasFailed());
+  factorizer_failed.resetFailure();
+  EXPECT_FALSE(factorizer_failed.hasFailed());
+}
+
+
 void RiccatiFactorizerTest::test_backwardRecursionImpulse(const Robot& robot) const {
   const int dimv = robot.dimv();
   const auto riccati_next = testhelper::CreateSplitRiccatiFactorization(robot);
@@ -154,6 +205,151 @@ void RiccatiFactorizerTest::test_backwardRecursionImpulse(const Robot& robot) co
   EXPECT_TRUE(kkt_matrix.Qxx.isApprox(kkt_matrix.Qxx.transpose()));
 }
 
+void RiccatiFactorizerTest::test_multiLevelIteration(const Robot& robot) const {
+  const auto riccati_next = testhelper::CreateSplitRiccatiFactorization(robot);
+  const auto kkt_matrix = testhelper::CreateSplitKKTMatrix(robot, dt);
+  const auto kkt_residual = testhelper::CreateSplitKKTResidual(robot);
+  RiccatiFactorizer factorizer(robot);
+  LQRPolicy lqr_policy(robot);
+  auto riccati = testhelper::CreateSplitRiccatiFactorization(robot);
+  auto kkt_matrix_prev = kkt_matrix;
+  auto kkt_residual_prev = kkt_residual;
+  factorizer.backwardRiccatiRecursion(riccati_next, kkt_matrix_prev, 
+                                      kkt_residual_prev, riccati, lqr_policy,
+                                      IterationLevel::Full);
+  // Only the vectors change in the next iteration.
+  auto riccati_next_new = riccati_next;
+  riccati_next_new.s.setRandom();
+  const auto kkt_residual_new = testhelper::CreateSplitKKTResidual(robot);
+  auto kkt_matrix_ref = kkt_matrix;
+  auto kkt_residual_ref = kkt_residual_new;
+  auto riccati_ref = riccati;
+  LQRPolicy lqr_policy_ref(robot);
+  factorizer.backwardRiccatiRecursion(riccati_next_new, kkt_matrix_ref, 
+                                      kkt_residual_ref, riccati_ref, 
+                                      lqr_policy_ref);
+  auto kkt_matrix_jac = kkt_matrix;
+  auto kkt_residual_jac = kkt_residual_new;
+  auto riccati_jac = riccati;
+  auto lqr_policy_jac = lqr_policy;
+  factorizer.backwardRiccatiRecursion(riccati_next_new, kkt_matrix_jac, 
+                                      kkt_residual_jac, riccati_jac, 
+                                      lqr_policy_jac, IterationLevel::Jacobian);
+  EXPECT_TRUE(riccati_jac.isApprox(riccati_ref));
+  EXPECT_TRUE(lqr_policy_jac.isApprox(lqr_policy_ref));
+  EXPECT_TRUE(lqr_policy_jac.G_llt.reconstructedMatrix().isApprox(
+      lqr_policy_ref.G_llt.reconstructedMatrix()));
+  auto kkt_matrix_res = kkt_matrix;
+  // The Residual level reuses the stored factorization and does not read the
+  // Hessians.
+  kkt_matrix_res.Qxx.setZero();
+  kkt_matrix_res.Qxu.setZero();
+  kkt_matrix_res.Quu.setZero();
+  auto kkt_residual_res = kkt_residual_new;
+  auto riccati_res = riccati;
+  auto lqr_policy_res = lqr_policy;
+  factorizer.backwardRiccatiRecursion(riccati_next_new, kkt_matrix_res, 
+                                      kkt_residual_res, riccati_res, 
+                                      lqr_policy_res, IterationLevel::Residual);
+  EXPECT_TRUE(riccati_res.isApprox(riccati_ref));
+  EXPECT_TRUE(lqr_policy_res.isApprox(lqr_policy_ref));
+  EXPECT_TRUE(kkt_residual_res.lu.isApprox(kkt_residual_ref.lu));
+}
+
+
+void RiccatiFactorizerTest::test_multiLevelIterationWithSwitchingConstraint(const Robot& robot) const {
+  auto impulse_status = robot.createImpulseStatus();
+  impulse_status.setRandom();
+  if (!impulse_status.hasActiveImpulse()) {
+    impulse_status.activateImpulse(0);
+  }
+  const auto riccati_next = testhelper::CreateSplitRiccatiFactorization(robot);
+  const auto kkt_matrix = testhelper::CreateSplitKKTMatrix(robot, dt);
+  const auto kkt_residual = testhelper::CreateSplitKKTResidual(robot);
+  SplitSwitchingConstraintJacobian sc_jacobian(robot);
+  SplitSwitchingConstraintResidual sc_residual(robot);
+  sc_jacobian.setImpulseStatus(impulse_status);
+  sc_residual.setImpulseStatus(impulse_status);
+  sc_jacobian.Phix().setRandom();
+  sc_jacobian.Phia().setRandom();
+  sc_jacobian.Phiu().setRandom();
+  sc_residual.P().setRandom();
+  RiccatiFactorizer factorizer(robot);
+  LQRPolicy lqr_policy(robot);
+  auto riccati = testhelper::CreateSplitRiccatiFactorization(robot);
+  SplitConstrainedRiccatiFactorization c_riccati(robot);
+  auto kkt_matrix_prev = kkt_matrix;
+  auto kkt_residual_prev = kkt_residual;
+  factorizer.backwardRiccatiRecursion(riccati_next, kkt_matrix_prev, 
+                                      kkt_residual_prev, sc_jacobian, 
+                                      sc_residual, riccati, c_riccati, 
+                                      lqr_policy, IterationLevel::Full);
+  // Only the vectors change in the next iteration.
+  auto riccati_next_new = riccati_next;
+  riccati_next_new.s.setRandom();
+  const auto kkt_residual_new = testhelper::CreateSplitKKTResidual(robot);
+  auto sc_residual_new = sc_residual;
+  sc_residual_new.P().setRandom();
+  auto kkt_matrix_ref = kkt_matrix;
+  auto kkt_residual_ref = kkt_residual_new;
+  auto riccati_ref = riccati;
+  auto c_riccati_ref = c_riccati;
+  LQRPolicy lqr_policy_ref(robot);
+  factorizer.backwardRiccatiRecursion(riccati_next_new, kkt_matrix_ref, 
+                                      kkt_residual_ref, sc_jacobian, 
+                                      sc_residual_new, riccati_ref, 
+                                      c_riccati_ref, lqr_policy_ref);
+  auto kkt_matrix_res = kkt_matrix;
+  // The Residual level reuses the stored factorization and does not read the
+  // Hessians.
+  kkt_matrix_res.Qxx.setZero();
+  kkt_matrix_res.Qxu.setZero();
+  kkt_matrix_res.Quu.setZero();
+  auto kkt_residual_res = kkt_residual_new;
+  auto riccati_res = riccati;
+  auto c_riccati_res = c_riccati;
+  auto lqr_policy_res = lqr_policy;
+  factorizer.backwardRiccatiRecursion(riccati_next_new, kkt_matrix_res, 
+                                      kkt_residual_res, sc_jacobian, 
+                                      sc_residual_new, riccati_res, 
+                                      c_riccati_res, lqr_policy_res,
+                                      IterationLevel::Residual);
+  EXPECT_TRUE(riccati_res.isApprox(riccati_ref));
+  EXPECT_TRUE(lqr_policy_res.isApprox(lqr_policy_ref));
+  EXPECT_TRUE(c_riccati_res.M().isApprox(c_riccati_ref.M()));
+  EXPECT_TRUE(c_riccati_res.m().isApprox(c_riccati_ref.m()));
+}
+
+
+void RiccatiFactorizerTest::test_multiLevelIterationImpulse(const Robot& robot) const {
+  const auto riccati_next = testhelper::CreateSplitRiccatiFactorization(robot);
+  const auto kkt_matrix = testhelper::CreateImpulseSplitKKTMatrix(robot);
+  const auto kkt_residual = testhelper::CreateImpulseSplitKKTResidual(robot);
+  RiccatiFactorizer factorizer(robot);
+  auto riccati = testhelper::CreateSplitRiccatiFactorization(robot);
+  auto kkt_matrix_prev = kkt_matrix;
+  auto kkt_residual_prev = kkt_residual;
+  factorizer.backwardRiccatiRecursion(riccati_next, kkt_matrix_prev, 
+                                      kkt_residual_prev, riccati, 
+                                      IterationLevel::Full);
+  // Only the vectors change in the next iteration.
+  auto riccati_next_new = riccati_next;
+  riccati_next_new.s.setRandom();
+  const auto kkt_residual_new = testhelper::CreateImpulseSplitKKTResidual(robot);
+  auto kkt_matrix_ref = kkt_matrix;
+  auto kkt_residual_ref = kkt_residual_new;
+  auto riccati_ref = riccati;
+  factorizer.backwardRiccatiRecursion(riccati_next_new, kkt_matrix_ref, 
+                                      kkt_residual_ref, riccati_ref);
+  auto kkt_matrix_res = kkt_matrix;
+  auto kkt_residual_res = kkt_residual_new;
+  auto riccati_res = riccati;
+  factorizer.backwardRiccatiRecursion(riccati_next_new, kkt_matrix_res, 
+                                      kkt_residual_res, riccati_res, 
+                                      IterationLevel::Residual);
+  EXPECT_TRUE(riccati_res.isApprox(riccati_ref));
+}
+
 
 void RiccatiFactorizerTest::test_forwardRecursion(const Robot& robot) const {
   const int dimv = robot.dimv();
@@ -235,7 +431,11 @@ TEST_F(RiccatiFactorizerTest, fixedBase) {
   auto robot = testhelper::CreateFixedBaseRobot(dt);
   test_backwardRecursion(robot);
   test_backwardRecursionWithSwitchingConstraint(robot);
+  test_backwardRecursionRegularization(robot);
   test_backwardRecursionImpulse(robot);
+  test_multiLevelIteration(robot);
+  test_multiLevelIterationWithSwitchingConstraint(robot);
+  test_multiLevelIterationImpulse(robot);
   test_forwardRecursion(robot);
   test_forwardRecursionImpulse(robot);
 }
@@ -245,7 +445,11 @@ TEST_F(RiccatiFactorizerTest, floating_base) {
   auto robot = testhelper::CreateFloatingBaseRobot(dt);
   test_backwardRecursion(robot);
   test_backwardRecursionWithSwitchingConstraint(robot);
+  test_backwardRecursionRegularization(robot);
   test_backwardRecursionImpulse(robot);
+  test_multiLevelIteration(robot);
+  test_multiLevelIterationWithSwitchingConstraint(robot);
+  test_multiLevelIterationImpulse(robot);
   test_forwardRecursion(robot);
   test_forwardRecursionImpulse(robot);
 }
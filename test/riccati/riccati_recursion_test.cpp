@@ -50,6 +50,10 @@ protected:
                                 const ContactSequence& contact_sequence) const;
   void testRiccatiRecursion(const Robot& robot) const;
   void testComputeDirection(const Robot& robot) const;
+  void testMultiLevelIteration(const Robot& robot) const;
+
+  static bool isApprox(const RiccatiFactorization& lhs, 
+                       const RiccatiFactorization& rhs, const double prec);
 
   int N, max_num_impulse, nthreads;
   double T, t, dt;
@@ -72,6 +76,25 @@ Solution RiccatiRecursionTest::createSolution(const Robot& robot,
 }
 
 
+bool RiccatiRecursionTest::isApprox(const RiccatiFactorization& lhs, 
+                                    const RiccatiFactorization& rhs, 
+                                    const double prec) {
+  auto isApproxSplit = [prec](const SplitRiccatiFactorization& a, 
+                              const SplitRiccatiFactorization& b) {
+    return (a.P.isApprox(b.P, prec) && a.s.isApprox(b.s, prec));
+  };
+  for (int i=0; i<lhs.data.size(); ++i) {
+    if (!isApproxSplit(lhs[i], rhs[i])) return false;
+  }
+  for (int i=0; i<lhs.impulse.size(); ++i) {
+    if (!isApproxSplit(lhs.impulse[i], rhs.impulse[i])) return false;
+    if (!isApproxSplit(lhs.aux[i], rhs.aux[i])) return false;
+    if (!isApproxSplit(lhs.lift[i], rhs.lift[i])) return false;
+  }
+  return true;
+}
+
+
 KKTMatrix RiccatiRecursionTest::createKKTMatrix(const Robot& robot, 
                                                 const ContactSequence& contact_sequence) const {
   return testhelper::CreateKKTMatrix(robot, contact_sequence, N, max_num_impulse);
@@ -336,6 +359,75 @@ void RiccatiRecursionTest::testComputeDirection(const Robot& robot) const {
 }
 
 
+void RiccatiRecursionTest::testMultiLevelIteration(const Robot& robot) const {
+  auto cost = testhelper::CreateCost(robot);
+  auto constraints = testhelper::CreateConstraints(robot);
+  DirectMultipleShooting dms(N, max_num_impulse, nthreads);
+  const auto contact_sequence = createContactSequence(robot);
+  KKTMatrix kkt_matrix(robot, N, max_num_impulse);
+  KKTResidual kkt_residual(robot, N, max_num_impulse);
+  aligned_vector<Robot> robots(nthreads, robot);
+  auto ocp = OCP(robot, cost, constraints, T, N, max_num_impulse);
+  ocp.discretize(contact_sequence, t);
+  const Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+  const Eigen::VectorXd v = Eigen::VectorXd::Random(robot.dimv());
+  auto s = testhelper::CreateSolution(robot, contact_sequence, T, N, max_num_impulse, t);
+  dms.initConstraints(ocp, robots, contact_sequence, s);
+  dms.computeKKTSystem(ocp, robots, contact_sequence, q, v, s, kkt_matrix, kkt_residual);
+  RiccatiFactorization factorization(robot, N, max_num_impulse);
+  RiccatiRecursion riccati_recursion(robot, N, max_num_impulse, nthreads);
+  // Falls back to the full recursion without a previous factorization.
+  auto kkt_matrix_ref = kkt_matrix; 
+  auto kkt_residual_ref = kkt_residual; 
+  const bool is_factorized 
+      = riccati_recursion.backwardRiccatiRecursion(ocp, kkt_matrix_ref, 
+                                                   kkt_residual_ref, 
+                                                   factorization, 
+                                                   IterationLevel::Residual);
+  EXPECT_TRUE(riccati_recursion.iterationLevel() == IterationLevel::Full);
+  if (!is_factorized) {
+    // The failed factorization is never reused.
+    EXPECT_FALSE(riccati_recursion.isFactorizationReusable(ocp, kkt_residual_ref));
+    return;
+  }
+  const auto factorization_ref = factorization;
+  // The reused factorization is exact up to the round-off errors if the KKT 
+  // matrices are unchanged. The regularization, which adapts over the 
+  // recursions, is excluded from the comparison.
+  const bool is_regularized = (riccati_recursion.regularization() > 0);
+  const double prec = 1.0e-08;
+  for (const auto level : {IterationLevel::Jacobian, IterationLevel::Residual}) {
+    auto kkt_matrix_reuse = kkt_matrix; 
+    auto kkt_residual_reuse = kkt_residual; 
+    EXPECT_TRUE(riccati_recursion.backwardRiccatiRecursion(ocp, kkt_matrix_reuse, 
+                                                           kkt_residual_reuse, 
+                                                           factorization, level));
+    EXPECT_TRUE(riccati_recursion.iterationLevel() == level);
+    if (!is_regularized) {
+      EXPECT_TRUE(isApprox(factorization, factorization_ref, prec));
+    }
+    EXPECT_FALSE(testhelper::HasNaN(factorization));
+  }
+  // The KKT systems evaluated at the lower levels reuse the Hessians and the 
+  // Jacobians modified in-place by the previous recursion.
+  EXPECT_TRUE(riccati_recursion.isFactorizationReusable(ocp, kkt_residual_ref));
+  for (const auto level : {IterationLevel::Jacobian, IterationLevel::Residual}) {
+    auto kkt_matrix_reuse = kkt_matrix_ref; 
+    auto kkt_residual_reuse = kkt_residual_ref; 
+    dms.computeKKTSystem(ocp, robots, contact_sequence, q, v, s, 
+                         kkt_matrix_reuse, kkt_residual_reuse, level);
+    EXPECT_TRUE(riccati_recursion.backwardRiccatiRecursion(ocp, kkt_matrix_reuse, 
+                                                           kkt_residual_reuse, 
+                                                           factorization, level));
+    EXPECT_TRUE(riccati_recursion.iterationLevel() == level);
+    if (!is_regularized) {
+      EXPECT_TRUE(isApprox(factorization, factorization_ref, prec));
+    }
+    EXPECT_FALSE(testhelper::HasNaN(factorization));
+  }
+}
+
+
 TEST_F(RiccatiRecursionTest, fixedBase) {
   auto robot = testhelper::CreateFixedBaseRobot();
   testRiccatiRecursion(robot);
@@ -343,6 +435,7 @@ TEST_F(RiccatiRecursionTest, fixedBase) {
   robot = testhelper::CreateFixedBaseRobot(dt);
   testRiccatiRecursion(robot);
   testComputeDirection(robot);
+  testMultiLevelIteration(robot);
 }
 
 
@@ -353,6 +446,7 @@ TEST_F(RiccatiRecursionTest, floating_base) {
   robot = testhelper::CreateFloatingBaseRobot(dt);
   testRiccatiRecursion(robot);
   testComputeDirection(robot);
+  testMultiLevelIteration(robot);
 }
 
 } // namespace idocp
@@ -3,6 +3,8 @@
 
 #include "idocp/robot/robot.hpp"
 #include "idocp/riccati/split_riccati_factorization.hpp"
+#include "idocp/riccati/split_constrained_riccati_factorization.hpp"
+#include "idocp/hybrid/hybrid_container.hpp"
 
 #include "robot_factory.hpp"
 
@@ -19,6 +21,8 @@ protected:
   }
 
   static void test(const Robot& robot);
+  static void testExternalStorage(const Robot& robot);
+  static void testHybridContainer(const Robot& robot);
 };
 
 
@@ -44,15 +48,84 @@ void RiccatiFactorizationTest::test(const Robot& robot) {
 }
 
 
+void RiccatiFactorizationTest::testExternalStorage(const Robot& robot) {
+  const int dimx = 2 * robot.dimv();
+  const int size = SplitRiccatiFactorization::storageSize(robot);
+  EXPECT_EQ(size, dimx*dimx+dimx);
+  Eigen::VectorXd storage = Eigen::VectorXd::Random(size);
+  SplitRiccatiFactorization riccati(robot, storage.data());
+  EXPECT_TRUE(storage.isZero());
+  EXPECT_EQ(riccati.P.data(), storage.data());
+  EXPECT_EQ(riccati.s.data(), storage.data()+dimx*dimx);
+  riccati.P.setRandom();
+  riccati.s.setRandom();
+  const SplitRiccatiFactorization riccati_copy = riccati;
+  EXPECT_NE(riccati_copy.P.data(), storage.data());
+  EXPECT_TRUE(riccati_copy.isApprox(riccati));
+  SplitRiccatiFactorization riccati_owner(robot);
+  riccati_owner.P.setRandom();
+  riccati_owner.s.setRandom();
+  riccati = riccati_owner;
+  EXPECT_EQ(riccati.P.data(), storage.data());
+  EXPECT_TRUE(riccati.isApprox(riccati_owner));
+  riccati_owner.P.setRandom();
+  riccati_owner.s.setRandom();
+  const SplitRiccatiFactorization riccati_ref = riccati_owner;
+  riccati = std::move(riccati_owner);
+  EXPECT_EQ(riccati.P.data(), storage.data());
+  EXPECT_TRUE(riccati.isApprox(riccati_ref));
+  const SplitRiccatiFactorization riccati_moved(std::move(riccati));
+  EXPECT_EQ(riccati_moved.P.data(), storage.data());
+  EXPECT_TRUE(riccati_moved.isApprox(riccati_ref));
+}
+
+
+void RiccatiFactorizationTest::testHybridContainer(const Robot& robot) {
+  const int N = 10;
+  const int N_impulse = 3;
+  const int size = SplitRiccatiFactorization::storageSize(robot);
+  hybrid_container<SplitRiccatiFactorization, SplitRiccatiFactorization,
+                   SplitConstrainedRiccatiFactorization> 
+      factorization(robot, N, N_impulse);
+  for (int i=0; i<N; ++i) {
+    EXPECT_EQ(factorization[i].P.data()+size, factorization[i+1].P.data());
+  }
+  EXPECT_EQ(factorization[N].P.data()+size, factorization.impulse[0].P.data());
+  EXPECT_EQ(factorization.impulse[N_impulse-1].P.data()+size, 
+            factorization.aux[0].P.data());
+  EXPECT_EQ(factorization.aux[N_impulse-1].P.data()+size, 
+            factorization.lift[0].P.data());
+  for (int i=0; i<=N; ++i) {
+    factorization[i].P.setRandom();
+    factorization[i].s.setRandom();
+  }
+  auto factorization_copy = factorization;
+  for (int i=0; i<=N; ++i) {
+    EXPECT_TRUE(factorization_copy[i].isApprox(factorization[i]));
+    EXPECT_NE(factorization_copy[i].P.data(), factorization[i].P.data());
+  }
+  const double* data_begin = factorization[0].P.data();
+  const auto factorization_moved = std::move(factorization);
+  EXPECT_EQ(factorization_moved[0].P.data(), data_begin);
+  for (int i=0; i<=N; ++i) {
+    EXPECT_TRUE(factorization_copy[i].isApprox(factorization_moved[i]));
+  }
+}
+
+
 TEST_F(RiccatiFactorizationTest, fixed_base) {
   auto robot = testhelper::CreateFixedBaseRobot();
   test(robot);
+  testExternalStorage(robot);
+  testHybridContainer(robot);
 }
 
 
 TEST_F(RiccatiFactorizationTest, floating_base) {
   auto robot = testhelper::CreateFloatingBaseRobot();
   test(robot);
+  testExternalStorage(robot);
+  testHybridContainer(robot);
 }
 
 } // namespace idocp
@@ -0,0 +1,162 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/ocp/kkt_matrix.hpp"
+#include "idocp/ocp/kkt_residual.hpp"
+#include "idocp/ocp/direction.hpp"
+#include "idocp/riccati/unconstr_riccati_factorizer.hpp"
+#include "idocp/riccati/unconstr_riccati_recursion.hpp"
+#include "idocp/riccati/unconstr_partitioned_riccati_recursion.hpp"
+#include "idocp/riccati/unconstr_reduced_boundary_system.hpp"
+#include "idocp/riccati/unconstr_segment_coupling.hpp"
+
+#include "robot_factory.hpp"
+#include "kkt_factory.hpp"
+
+
+namespace idocp {
+
+class UnconstrPartitionedRiccatiRecursionTest : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    srand((unsigned int) time(0));
+    robot = testhelper::CreateFixedBaseRobot();
+    dimv = robot.dimv();
+    dimx = 2 * robot.dimv();
+    N = 20;
+    T = 1;
+    dt = T / N;
+    kkt_matrix = KKTMatrix(robot, N);
+    kkt_residual = KKTResidual(robot, N);
+    for (int i=0; i<=N; ++i) {
+      const Eigen::MatrixXd H_seed = Eigen::MatrixXd::Random(dimx+dimv, dimx+dimv);
+      const Eigen::MatrixXd H = H_seed * H_seed.transpose()
+                                  + Eigen::MatrixXd::Identity(dimx+dimv, dimx+dimv);
+      kkt_matrix[i].Qxx = H.topLeftCorner(dimx, dimx);
+      kkt_matrix[i].Qxu = H.topRightCorner(dimx, dimv);
+      kkt_matrix[i].Qaa = H.bottomRightCorner(dimv, dimv);
+      kkt_residual[i] = testhelper::CreateSplitKKTResidual(robot);
+    }
+  }
+
+  virtual void TearDown() {
+  }
+
+  void testPartitionedRecursion(const std::vector<int>& stage_begin) const;
+
+  Robot robot;
+  int N, dimv, dimx;
+  double T, dt;
+  KKTMatrix kkt_matrix;
+  KKTResidual kkt_residual;
+};
+
+
+void UnconstrPartitionedRiccatiRecursionTest::testPartitionedRecursion(
+    const std::vector<int>& stage_begin) const {
+  auto kkt_matrix_ref = kkt_matrix;
+  auto kkt_residual_ref = kkt_residual;
+  UnconstrRiccatiFactorization factorization_ref(N+1, SplitRiccatiFactorization(robot));
+  UnconstrRiccatiRecursion riccati_recursion(robot, T, N);
+  riccati_recursion.backwardRiccatiRecursion(kkt_matrix_ref, kkt_residual_ref,
+                                             factorization_ref);
+  Direction d_ref(robot, N);
+  d_ref[0].dx.setRandom();
+  riccati_recursion.forwardRiccatiRecursion(kkt_residual_ref, d_ref);
+  for (int i=0; i<=N; ++i) {
+    UnconstrRiccatiFactorizer::computeCostateDirection(factorization_ref[i],
+                                                       d_ref[i]);
+  }
+  const int num_segments = stage_begin.size();
+  std::vector<UnconstrPartitionedRiccatiRecursion> partitioned_recursion;
+  std::vector<KKTMatrix> kkt_matrix_seg;
+  std::vector<KKTResidual> kkt_residual_seg;
+  std::vector<UnconstrRiccatiFactorization> factorization_seg;
+  std::vector<Direction> d_seg;
+  std::vector<UnconstrSegmentCoupling> coupling(num_segments,
+                                                UnconstrSegmentCoupling(robot));
+  for (int j=0; j<num_segments; ++j) {
+    const int begin = stage_begin[j];
+    const int end = (j < num_segments-1) ? stage_begin[j+1] : N;
+    const int len = end - begin;
+    partitioned_recursion.emplace_back(robot, T, N, begin, end);
+    EXPECT_EQ(partitioned_recursion[j].numStages(), len);
+    EXPECT_EQ(partitioned_recursion[j].hasTerminalStage(), (end == N));
+    kkt_matrix_seg.emplace_back(robot, len);
+    kkt_residual_seg.emplace_back(robot, len);
+    for (int k=0; k<=len; ++k) {
+      kkt_matrix_seg[j][k] = kkt_matrix[begin+k];
+      kkt_residual_seg[j][k] = kkt_residual[begin+k];
+    }
+    factorization_seg.emplace_back(len+1, SplitRiccatiFactorization(robot));
+    d_seg.emplace_back(robot, len);
+    partitioned_recursion[j].backwardRiccatiRecursion(kkt_matrix_seg[j],
+                                                      kkt_residual_seg[j],
+                                                      factorization_seg[j],
+                                                      coupling[j]);
+  }
+  // The Riccati factorizations of the segments other than the last one differ
+  // from those of the whole horizon, while the directions coincide.
+  UnconstrReducedBoundarySystem reduced_system(robot, num_segments);
+  reduced_system.solve(coupling, d_ref[0].dx);
+  EXPECT_TRUE(reduced_system.sigma(num_segments-1).isZero());
+  for (int j=0; j<num_segments; ++j) {
+    const int begin = stage_begin[j];
+    const int len = partitioned_recursion[j].numStages();
+    EXPECT_TRUE(reduced_system.dxBegin(j).isApprox(d_ref[begin].dx));
+    d_seg[j][0].dx = reduced_system.dxBegin(j);
+    partitioned_recursion[j].forwardRiccatiRecursion(kkt_residual_seg[j],
+                                                     reduced_system.sigma(j),
+                                                     factorization_seg[j],
+                                                     d_seg[j]);
+    const int num_costates = partitioned_recursion[j].hasTerminalStage() ? len+1 : len;
+    for (int k=0; k<num_costates; ++k) {
+      UnconstrRiccatiFactorizer::computeCostateDirection(factorization_seg[j][k],
+                                                         d_seg[j][k]);
+      EXPECT_TRUE(d_seg[j][k].dx.isApprox(d_ref[begin+k].dx));
+      EXPECT_TRUE(d_seg[j][k].dlmdgmm.isApprox(d_ref[begin+k].dlmdgmm));
+      if (begin+k < N) {
+        EXPECT_TRUE(d_seg[j][k].da().isApprox(d_ref[begin+k].da()));
+      }
+    }
+    EXPECT_TRUE(d_seg[j][len].dx.isApprox(d_ref[begin+len].dx));
+  }
+}
+
+
+TEST_F(UnconstrPartitionedRiccatiRecursionTest, singleSegment) {
+  testPartitionedRecursion({0});
+}
+
+
+TEST_F(UnconstrPartitionedRiccatiRecursionTest, multipleSegments) {
+  testPartitionedRecursion({0, 5, 12});
+  testPartitionedRecursion({0, 1, 2, 19});
+}
+
+
+TEST_F(UnconstrPartitionedRiccatiRecursionTest, segmentCouplingStorage) {
+  Eigen::VectorXd storage = Eigen::VectorXd::Random(UnconstrSegmentCoupling::storageSize(robot));
+  UnconstrSegmentCoupling coupling(robot, storage.data());
+  EXPECT_EQ(coupling.P.data(), storage.data());
+  UnconstrSegmentCoupling moved(std::move(coupling));
+  EXPECT_EQ(moved.P.data(), storage.data());
+  UnconstrSegmentCoupling copied(moved);
+  EXPECT_NE(copied.P.data(), storage.data());
+  EXPECT_TRUE(copied.isApprox(moved));
+  copied.P.setRandom();
+  moved = copied;
+  EXPECT_EQ(moved.P.data(), storage.data());
+  EXPECT_TRUE(copied.isApprox(moved));
+}
+
+} // namespace idocp
+
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
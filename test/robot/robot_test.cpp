@@ -499,6 +499,9 @@ void RobotTest::testRNEA(const std::string& path_to_urdf,
   robot.RNEA(q, v, a, tau);
   Eigen::VectorXd tau_ref = pinocchio::rnea(model, data, q, v, a);
   EXPECT_TRUE(tau_ref.isApprox(tau));
+  Eigen::VectorXd a_fd = Eigen::VectorXd::Zero(model.nv);
+  robot.forwardDynamics(q, v, tau, a_fd);
+  EXPECT_TRUE(a_fd.isApprox(a));
   Eigen::MatrixXd dRNEA_dq = Eigen::MatrixXd::Zero(model.nv, model.nv);
   Eigen::MatrixXd dRNEA_dv = Eigen::MatrixXd::Zero(model.nv, model.nv);
   Eigen::MatrixXd dRNEA_da = Eigen::MatrixXd::Zero(model.nv, model.nv);
@@ -549,6 +552,9 @@ void RobotTest::testRNEA(const std::string& path_to_urdf,
   }
   const Eigen::VectorXd tau_ref = pinocchio::rnea(model, data, q, v, a, fjoint);
   EXPECT_TRUE(tau_ref.isApprox(tau));
+  Eigen::VectorXd a_fd = Eigen::VectorXd::Zero(model.nv);
+  robot.forwardDynamics(q, v, tau, a_fd);
+  EXPECT_TRUE(a_fd.isApprox(a));
   Eigen::MatrixXd dRNEA_dq = Eigen::MatrixXd::Zero(model.nv, model.nv);
   Eigen::MatrixXd dRNEA_dv = Eigen::MatrixXd::Zero(model.nv, model.nv);
   Eigen::MatrixXd dRNEA_da = Eigen::MatrixXd::Zero(model.nv, model.nv);
@@ -0,0 +1,126 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "Eigen/Core"
+#include "Eigen/Geometry"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/sim/compliant_contact_simulator.hpp"
+
+#include "robot_factory.hpp"
+
+
+namespace idocp {
+
+class CompliantContactSimulatorTest : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    srand((unsigned int) time(0));
+    time_step = 5.0e-04;
+    stiffness = 5.0e04;
+    damping = 1.0e03;
+    tangential_damping = 1.0e03;
+    mu = 0.7;
+    g = 9.81;
+  }
+
+  virtual void TearDown() {
+  }
+
+  double time_step, stiffness, damping, tangential_damping, mu, g;
+};
+
+
+TEST_F(CompliantContactSimulatorTest, freeFall) {
+  auto robot = testhelper::CreateFloatingBaseRobot(time_step);
+  Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+  q.coeffRef(2) = 10;
+  Eigen::VectorXd v = Eigen::VectorXd::Zero(robot.dimv());
+  const Eigen::VectorXd u = Eigen::VectorXd::Zero(robot.dimu());
+  const Eigen::VectorXd q0 = q;
+  robot.updateFrameKinematics(q0);
+  const Eigen::Vector3d com0 = robot.CoM();
+  CompliantContactSimulator sim(robot, time_step);
+  EXPECT_DOUBLE_EQ(sim.timeStep(), time_step);
+  const int num_steps = 200;
+  sim.integrate(num_steps*time_step, u, q, v);
+  // No contact touches the ground.
+  EXPECT_FALSE(sim.contactStatus().hasActiveContacts());
+  for (const auto& f : sim.contactForces()) {
+    EXPECT_TRUE(f.isZero());
+  }
+  // Without the contacts and the torques, the robot falls without changing
+  // its posture. The semi-implicit Euler method gives the height
+  // z0 - g * dt^2 * n * (n+1) / 2 after n steps.
+  const double drop = 0.5 * g * time_step * time_step * num_steps * (num_steps+1);
+  robot.updateFrameKinematics(q);
+  const Eigen::Vector3d com = robot.CoM();
+  EXPECT_NEAR(com.coeff(0), com0.coeff(0), 1.0e-08);
+  EXPECT_NEAR(com.coeff(1), com0.coeff(1), 1.0e-08);
+  EXPECT_NEAR(com.coeff(2), com0.coeff(2)-drop, 1.0e-08);
+  EXPECT_TRUE(q.tail(robot.dimu()).isApprox(q0.tail(robot.dimu())));
+  EXPECT_TRUE(v.tail(robot.dimu()).isZero(1.0e-08));
+}
+
+
+TEST_F(CompliantContactSimulatorTest, groundContact) {
+  auto robot = testhelper::CreateFloatingBaseRobot(time_step);
+  const auto& contact_frames = robot.contactFrames();
+  Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+  // Shifts the base so that the lowest contact penetrates the ground.
+  robot.updateKinematics(q);
+  int lowest = 0;
+  for (int i=0; i<contact_frames.size(); ++i) {
+    if (robot.framePosition(contact_frames[i]).coeff(2)
+          < robot.framePosition(contact_frames[lowest]).coeff(2)) {
+      lowest = i;
+    }
+  }
+  const double depth = 1.0e-03;
+  q.coeffRef(2) -= robot.framePosition(contact_frames[lowest]).coeff(2) + depth;
+  robot.updateKinematics(q);
+  std::vector<bool> is_penetrating;
+  for (int i=0; i<contact_frames.size(); ++i) {
+    is_penetrating.push_back(robot.framePosition(contact_frames[i]).coeff(2) < 0);
+  }
+  const Eigen::VectorXd u = Eigen::VectorXd::Random(robot.dimu());
+  CompliantContactSimulator sim(robot, time_step);
+  sim.setGroundModel(stiffness, damping, tangential_damping, mu);
+  // At rest, only the spring acts on the penetrating contacts.
+  Eigen::VectorXd q_sim = q;
+  Eigen::VectorXd v_sim = Eigen::VectorXd::Zero(robot.dimv());
+  sim.step(time_step, u, q_sim, v_sim);
+  EXPECT_TRUE(sim.contactStatus().isContactActive(lowest));
+  for (int i=0; i<contact_frames.size(); ++i) {
+    EXPECT_EQ(sim.contactStatus().isContactActive(i), is_penetrating[i]);
+    const double z = robot.framePosition(contact_frames[i]).coeff(2);
+    const Eigen::Vector3d f_ref
+        = is_penetrating[i] ? Eigen::Vector3d(0, 0, -stiffness*z)
+                            : Eigen::Vector3d::Zero();
+    EXPECT_TRUE(sim.contactForces()[i].isApprox(f_ref, 1.0e-08));
+  }
+  EXPECT_NEAR(sim.contactForces()[lowest].coeff(2), stiffness*depth, 1.0e-06);
+  // The horizontal translation of the base is resisted by the friction,
+  // which is saturated at the friction cone.
+  const Eigen::Quaterniond quat(q.coeff(6), q.coeff(3), q.coeff(4), q.coeff(5));
+  const Eigen::Vector3d v_world(1, 0, 0);
+  q_sim = q;
+  v_sim = Eigen::VectorXd::Zero(robot.dimv());
+  v_sim.head(3) = quat.toRotationMatrix().transpose() * v_world;
+  sim.step(time_step, u, q_sim, v_sim);
+  for (int i=0; i<contact_frames.size(); ++i) {
+    const double z = robot.framePosition(contact_frames[i]).coeff(2);
+    const Eigen::Vector3d f_ref
+        = is_penetrating[i] ? Eigen::Vector3d(mu*stiffness*z, 0, -stiffness*z)
+                            : Eigen::Vector3d::Zero();
+    EXPECT_TRUE(sim.contactForces()[i].isApprox(f_ref, 1.0e-08));
+  }
+}
+
+} // namespace idocp
+
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,283 @@
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/constraints/constraints.hpp"
+#include "idocp/solver/ocp_solver.hpp"
+#include "idocp/solver/control_policy.hpp"
+#include "idocp/solver/ocp_solver_trace.hpp"
+
+#include "test_helper.hpp"
+#include "robot_factory.hpp"
+#include "cost_factory.hpp"
+#include "constraints_factory.hpp"
+
+
+namespace idocp {
+
+class OCPSolverTest : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    srand((unsigned int) time(0));
+    N = 20;
+    max_num_impulse = 5;
+    nthreads = 4;
+    T = 1;
+    t = std::abs(Eigen::VectorXd::Random(1)[0]);
+    dt = T / N;
+  }
+
+  virtual void TearDown() {
+  }
+
+  OCPSolver createSolver(Robot& robot, Eigen::VectorXd& q,
+                         Eigen::VectorXd& v,
+                         const bool with_constraints=true) const;
+
+  int N, max_num_impulse, nthreads;
+  double T, t, dt;
+};
+
+
+OCPSolver OCPSolverTest::createSolver(Robot& robot, Eigen::VectorXd& q,
+                                      Eigen::VectorXd& v,
+                                      const bool with_constraints) const {
+  auto cost = testhelper::CreateCost(robot);
+  auto constraints = with_constraints ? testhelper::CreateConstraints(robot)
+                                      : std::make_shared<Constraints>();
+  OCPSolver ocp_solver(robot, cost, constraints, T, N, max_num_impulse,
+                       nthreads);
+  auto contact_status = robot.createContactStatus();
+  contact_status.activateContacts();
+  ocp_solver.setContactStatusUniformly(contact_status);
+  contact_status.deactivateContacts({0, 3});
+  ocp_solver.pushBackContactStatus(contact_status, t+0.25*T);
+  contact_status.activateContacts({0, 3});
+  ocp_solver.pushBackContactStatus(contact_status, t+0.55*T);
+  q = robot.generateFeasibleConfiguration();
+  v = Eigen::VectorXd::Zero(robot.dimv());
+  ocp_solver.setSolution("q", q);
+  ocp_solver.setSolution("v", v);
+  ocp_solver.initConstraints(t);
+  return ocp_solver;
+}
+
+
+TEST_F(OCPSolverTest, snapshot) {
+  auto robot = testhelper::CreateFloatingBaseRobot(dt);
+  Eigen::VectorXd q, v;
+  auto ocp_solver = createSolver(robot, q, v);
+  EXPECT_TRUE(ocp_solver.updateSolution(t, q, v));
+  const auto q_ref = ocp_solver.getSolution("q");
+  // The number of the time stages is reduced by the events on the grid.
+  const int N_discrete = q_ref.size() - 1;
+  std::vector<int> dimf;
+  for (int i=0; i<=N_discrete; ++i) {
+    dimf.push_back(ocp_solver.getSolution(i).dimf());
+  }
+  // Saving at another time must not re-discretize the solver.
+  std::stringstream ss_other_time;
+  EXPECT_TRUE(ocp_solver.saveSnapshot(ss_other_time, t+0.1*T));
+  for (int i=0; i<=N_discrete; ++i) {
+    EXPECT_EQ(ocp_solver.getSolution(i).dimf(), dimf[i]);
+  }
+  std::stringstream ss;
+  EXPECT_TRUE(ocp_solver.saveSnapshot(ss, t));
+  const auto q_saved = ocp_solver.getSolution("q");
+  ASSERT_EQ(q_saved.size(), q_ref.size());
+  for (int i=0; i<q_ref.size(); ++i) {
+    EXPECT_TRUE(q_saved[i].isApprox(q_ref[i]));
+  }
+  auto loaded_solver = OCPSolver(robot, testhelper::CreateCost(robot),
+                                 testhelper::CreateConstraints(robot),
+                                 T, N, max_num_impulse, nthreads);
+  EXPECT_TRUE(loaded_solver.loadSnapshot(ss));
+  const auto q_loaded = loaded_solver.getSolution("q");
+  ASSERT_EQ(q_loaded.size(), q_ref.size());
+  for (int i=0; i<q_ref.size(); ++i) {
+    EXPECT_TRUE(q_loaded[i].isApprox(q_ref[i]));
+  }
+  // The factorization of the last iteration is loaded as well.
+  Eigen::MatrixXd Kq = Eigen::MatrixXd::Zero(robot.dimu(), robot.dimv());
+  Eigen::MatrixXd Kv = Eigen::MatrixXd::Zero(robot.dimu(), robot.dimv());
+  Eigen::MatrixXd Kq_ref = Eigen::MatrixXd::Zero(robot.dimu(), robot.dimv());
+  Eigen::MatrixXd Kv_ref = Eigen::MatrixXd::Zero(robot.dimu(), robot.dimv());
+  for (int i=0; i<N_discrete; ++i) {
+    ocp_solver.getStateFeedbackGain(i, Kq_ref, Kv_ref);
+    loaded_solver.getStateFeedbackGain(i, Kq, Kv);
+    EXPECT_TRUE(Kq == Kq_ref);
+    EXPECT_TRUE(Kv == Kv_ref);
+  }
+  std::stringstream ss_loaded;
+  EXPECT_TRUE(loaded_solver.saveSnapshot(ss_loaded, t));
+  EXPECT_EQ(ss_loaded.str(), ss.str());
+  // A broken stream must not modify the solver.
+  std::stringstream ss_broken(ss.str().substr(0, ss.str().size()/2));
+  EXPECT_FALSE(loaded_solver.loadSnapshot(ss_broken));
+  std::stringstream ss_after_broken;
+  EXPECT_TRUE(loaded_solver.saveSnapshot(ss_after_broken, t));
+  EXPECT_EQ(ss_after_broken.str(), ss.str());
+}
+
+
+TEST_F(OCPSolverTest, recordAndReplay) {
+  auto robot = testhelper::CreateFloatingBaseRobot(dt);
+  auto cost = testhelper::CreateCost(robot);
+  auto constraints = testhelper::CreateConstraints(robot);
+  OCPSolver ocp_solver(robot, cost, constraints, T, N, max_num_impulse,
+                       nthreads);
+  auto contact_status = robot.createContactStatus();
+  contact_status.activateContacts();
+  ocp_solver.setContactStatusUniformly(contact_status);
+  contact_status.deactivateContacts({0, 3});
+  ocp_solver.pushBackContactStatus(contact_status, t+0.25*T);
+  contact_status.activateContacts({0, 3});
+  ocp_solver.pushBackContactStatus(contact_status, t+0.55*T);
+  const Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+  const Eigen::VectorXd v = Eigen::VectorXd::Zero(robot.dimv());
+  ocp_solver.setSolution("q", q);
+  ocp_solver.setSolution("v", v);
+  ocp_solver.initConstraints(t);
+  ocp_solver.setMultiLevelIteration(3, 2);
+  // The recording starts in the middle of the iterations, i.e., with the 
+  // line search filter and the factorization of the previous iterations.
+  const int num_iteration = 5;
+  for (int i=0; i<num_iteration; ++i) {
+    ocp_solver.updateSolution(t, q, v);
+  }
+  const std::string file_name = "ocp_solver_test_trace.bin";
+  ASSERT_TRUE(ocp_solver.startRecording(file_name, t));
+  std::vector<std::vector<Eigen::VectorXd>> q_rec, v_rec, u_rec;
+  for (int i=0; i<num_iteration; ++i) {
+    const Eigen::VectorXd dv0 = 0.01 * Eigen::VectorXd::Random(robot.dimv());
+    ocp_solver.updateSolution(t, q, v+dv0);
+    q_rec.push_back(ocp_solver.getSolution("q"));
+    v_rec.push_back(ocp_solver.getSolution("v"));
+    u_rec.push_back(ocp_solver.getSolution("u"));
+  }
+  ocp_solver.stopRecording();
+  OCPSolver replayed_solver(robot, cost, constraints, T, N, max_num_impulse,
+                            nthreads);
+  OCPSolverReplayer replayer(robot, file_name);
+  ASSERT_TRUE(replayer.init(replayed_solver));
+  int num_updates = 0;
+  while (replayer.replayNext(replayed_solver)) {
+    if (replayer.lastEvent() != OCPSolverTraceEvent::UpdateSolution) {
+      continue;
+    }
+    ASSERT_LT(num_updates, num_iteration);
+    // The replayed iterates are bit-identical to the recorded ones.
+    const auto q_replayed = replayed_solver.getSolution("q");
+    const auto v_replayed = replayed_solver.getSolution("v");
+    const auto u_replayed = replayed_solver.getSolution("u");
+    ASSERT_EQ(q_replayed.size(), q_rec[num_updates].size());
+    ASSERT_EQ(u_replayed.size(), u_rec[num_updates].size());
+    for (int i=0; i<q_replayed.size(); ++i) {
+      EXPECT_TRUE(q_replayed[i] == q_rec[num_updates][i]);
+      EXPECT_TRUE(v_replayed[i] == v_rec[num_updates][i]);
+    }
+    for (int i=0; i<u_replayed.size(); ++i) {
+      EXPECT_TRUE(u_replayed[i] == u_rec[num_updates][i]);
+    }
+    ++num_updates;
+  }
+  EXPECT_EQ(num_updates, num_iteration);
+  EXPECT_EQ(replayer.numReplayedUpdates(), num_iteration);
+  std::remove(file_name.c_str());
+}
+
+
+TEST_F(OCPSolverTest, controlPolicy) {
+  auto robot = testhelper::CreateFloatingBaseRobot(dt);
+  Eigen::VectorXd q, v;
+  // Without the inequality constraints, the primal step size is always 1 and
+  // the update of the initial control input is exactly the LQR policy.
+  auto ocp_solver = createSolver(robot, q, v, false);
+  auto ocp_solver_perturbed = ocp_solver;
+  EXPECT_TRUE(ocp_solver.updateSolution(t, q, v));
+  const int num_stages = 5;
+  ControlPolicy policy(robot, num_stages);
+  ocp_solver.getControlPolicy(policy);
+  EXPECT_DOUBLE_EQ(policy.t, t);
+  EXPECT_TRUE(policy.u.isApprox(ocp_solver.getSolution(0).u));
+  EXPECT_TRUE(policy.Kq.isApprox(policy.Kq_traj[0]));
+  EXPECT_TRUE(policy.Kv.isApprox(policy.Kv_traj[0]));
+  Eigen::MatrixXd Kq = Eigen::MatrixXd::Zero(robot.dimu(), robot.dimv());
+  Eigen::MatrixXd Kv = Eigen::MatrixXd::Zero(robot.dimu(), robot.dimv());
+  const auto t_traj = ocp_solver.getSolution("t");
+  for (int i=0; i<num_stages; ++i) {
+    EXPECT_DOUBLE_EQ(policy.t_traj.coeff(i), t_traj[i].coeff(0));
+    EXPECT_TRUE(policy.q_traj[i].isApprox(ocp_solver.getSolution(i).q));
+    EXPECT_TRUE(policy.v_traj[i].isApprox(ocp_solver.getSolution(i).v));
+    EXPECT_TRUE(policy.u_traj[i].isApprox(ocp_solver.getSolution(i).u));
+    ocp_solver.getStateFeedbackGain(i, Kq, Kv);
+    EXPECT_TRUE(policy.Kq_traj[i].isApprox(Kq));
+    EXPECT_TRUE(policy.Kv_traj[i].isApprox(Kv));
+  }
+  // The KKT matrix does not depend on the initial state, so the difference
+  // of the updated control inputs is the feedback of the LQR policy.
+  const Eigen::VectorXd dv0 = 0.01 * Eigen::VectorXd::Random(robot.dimv());
+  EXPECT_TRUE(ocp_solver_perturbed.updateSolution(t, q, v+dv0));
+  const Eigen::VectorXd du0 = ocp_solver_perturbed.getSolution(0).u
+                                - ocp_solver.getSolution(0).u;
+  EXPECT_TRUE(du0.isApprox(policy.Kv*dv0));
+}
+
+TEST_F(OCPSolverTest, multiLevelIteration) {
+  auto robot = testhelper::CreateFixedBaseRobot(dt);
+  auto cost = testhelper::CreateCost(robot);
+  auto constraints = std::make_shared<Constraints>();
+  OCPSolver ocp_solver(robot, cost, constraints, T, N, max_num_impulse,
+                       nthreads);
+  auto contact_status = robot.createContactStatus();
+  contact_status.activateContacts();
+  ocp_solver.setContactStatusUniformly(contact_status);
+  contact_status.deactivateContacts();
+  ocp_solver.pushBackContactStatus(contact_status, t+0.25*T);
+  contact_status.activateContacts();
+  ocp_solver.pushBackContactStatus(contact_status, t+0.55*T);
+  const Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+  const Eigen::VectorXd v = Eigen::VectorXd::Zero(robot.dimv());
+  ocp_solver.setSolution("q", q);
+  ocp_solver.setSolution("v", v);
+  ocp_solver.initConstraints(t);
+  auto ocp_solver_ref = ocp_solver;
+  ocp_solver.setMultiLevelIteration(3, 2);
+  const int num_iteration = 30;
+  for (int i=0; i<num_iteration; ++i) {
+    EXPECT_TRUE(ocp_solver_ref.updateSolution(t, q, v, false));
+    EXPECT_TRUE(ocp_solver.updateSolution(t, q, v, false));
+  }
+  ocp_solver_ref.computeKKTResidual(t, q, v);
+  ocp_solver.computeKKTResidual(t, q, v);
+  // The iterations reusing the KKT matrices converge to the same solution.
+  EXPECT_LT(ocp_solver.KKTError(), 1.0e-08);
+  const auto q_ref = ocp_solver_ref.getSolution("q");
+  const auto q_sol = ocp_solver.getSolution("q");
+  ASSERT_EQ(q_sol.size(), q_ref.size());
+  for (int i=0; i<q_ref.size(); ++i) {
+    EXPECT_TRUE(q_sol[i].isApprox(q_ref[i], 1.0e-06));
+  }
+  // Changing the contact sequence falls back to the full evaluation.
+  contact_status.deactivateContacts();
+  ocp_solver.setContactStatusUniformly(contact_status);
+  for (int i=0; i<num_iteration; ++i) {
+    EXPECT_TRUE(ocp_solver.updateSolution(t, q, v, false));
+  }
+  ocp_solver.computeKKTResidual(t, q, v);
+  EXPECT_LT(ocp_solver.KKTError(), 1.0e-08);
+}
+
+} // namespace idocp
+
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
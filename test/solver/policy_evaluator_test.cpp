@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include "Eigen/Core"
+
+#include "idocp/robot/robot.hpp"
+#include "idocp/solver/control_policy.hpp"
+#include "idocp/solver/policy_evaluator.hpp"
+
+#include "robot_factory.hpp"
+
+
+namespace idocp {
+
+class PolicyEvaluatorTest : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    srand((unsigned int) time(0));
+    num_stages = 10;
+    dt = 0.01;
+    t0 = std::abs(Eigen::VectorXd::Random(1)[0]);
+  }
+
+  virtual void TearDown() {
+  }
+
+  ControlPolicy createPolicy(const Robot& robot) const;
+  Eigen::VectorXd computeReference(const Robot& robot,
+                                   const ControlPolicy& policy,
+                                   const int stage, const double alpha,
+                                   const Eigen::VectorXd& q,
+                                   const Eigen::VectorXd& v) const;
+  void testAtGridPoints(const Robot& robot) const;
+  void testBetweenGridPoints(const Robot& robot) const;
+  void testOutOfHorizon(const Robot& robot) const;
+
+  int num_stages;
+  double dt, t0;
+};
+
+
+ControlPolicy PolicyEvaluatorTest::createPolicy(const Robot& robot) const {
+  ControlPolicy policy(robot, num_stages);
+  for (int i=0; i<num_stages; ++i) {
+    policy.t_traj.coeffRef(i) = t0 + i * dt;
+    policy.q_traj[i] = robot.generateFeasibleConfiguration();
+    policy.v_traj[i].setRandom();
+    policy.u_traj[i].setRandom();
+    policy.Kq_traj[i].setRandom();
+    policy.Kv_traj[i].setRandom();
+  }
+  policy.t = policy.t_traj.coeff(0);
+  policy.u = policy.u_traj[0];
+  policy.Kq = policy.Kq_traj[0];
+  policy.Kv = policy.Kv_traj[0];
+  return policy;
+}
+
+
+Eigen::VectorXd PolicyEvaluatorTest::computeReference(
+    const Robot& robot, const ControlPolicy& policy, const int stage,
+    const double alpha, const Eigen::VectorXd& q,
+    const Eigen::VectorXd& v) const {
+  const int i = stage;
+  Eigen::VectorXd q_ref = policy.q_traj[i];
+  Eigen::VectorXd v_ref = policy.v_traj[i];
+  Eigen::VectorXd u_ref = policy.u_traj[i];
+  if (alpha > 0) {
+    Eigen::VectorXd qdiff = Eigen::VectorXd::Zero(robot.dimv());
+    robot.subtractConfiguration(policy.q_traj[i+1], policy.q_traj[i], qdiff);
+    robot.integrateConfiguration(policy.q_traj[i], qdiff, alpha, q_ref);
+    v_ref = (1-alpha) * policy.v_traj[i] + alpha * policy.v_traj[i+1];
+    u_ref = (1-alpha) * policy.u_traj[i] + alpha * policy.u_traj[i+1];
+  }
+  Eigen::VectorXd dq = Eigen::VectorXd::Zero(robot.dimv());
+  robot.subtractConfiguration(q, q_ref, dq);
+  // The feedback gains are held over the time interval.
+  return u_ref + policy.Kq_traj[i] * dq + policy.Kv_traj[i] * (v - v_ref);
+}
+
+
+void PolicyEvaluatorTest::testAtGridPoints(const Robot& robot) const {
+  const auto policy = createPolicy(robot);
+  PolicyEvaluator evaluator(robot, num_stages);
+  evaluator.setPolicy(policy);
+  Eigen::VectorXd u = Eigen::VectorXd::Zero(robot.dimu());
+  for (int i=0; i<num_stages; ++i) {
+    const double t = policy.t_traj.coeff(i);
+    // On the nominal trajectory, the control input is the feedforward term.
+    evaluator.computeControlInput(t, policy.q_traj[i], policy.v_traj[i], u);
+    EXPECT_TRUE(u.isApprox(policy.u_traj[i]));
+    // Off the nominal trajectory, the feedback term is added.
+    const Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+    const Eigen::VectorXd v = Eigen::VectorXd::Random(robot.dimv());
+    evaluator.computeControlInput(t, q, v, u);
+    EXPECT_TRUE(u.isApprox(computeReference(robot, policy, i, 0, q, v)));
+    EXPECT_TRUE(evaluator.computeControlInput(t, q, v).isApprox(u));
+  }
+}
+
+
+void PolicyEvaluatorTest::testBetweenGridPoints(const Robot& robot) const {
+  const auto policy = createPolicy(robot);
+  PolicyEvaluator evaluator(robot, num_stages);
+  evaluator.setPolicy(policy);
+  Eigen::VectorXd u = Eigen::VectorXd::Zero(robot.dimu());
+  for (int i=0; i<num_stages-1; ++i) {
+    const double alpha = 0.1 + 0.8 * std::abs(Eigen::VectorXd::Random(1)[0]);
+    const double t = policy.t_traj.coeff(i) + alpha * dt;
+    const Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+    const Eigen::VectorXd v = Eigen::VectorXd::Random(robot.dimv());
+    evaluator.computeControlInput(t, q, v, u);
+    EXPECT_TRUE(u.isApprox(computeReference(robot, policy, i, alpha, q, v)));
+    EXPECT_TRUE(evaluator.computeControlInput(t, q, v).isApprox(u));
+  }
+  // The search of the time stage restarts if the time goes back.
+  const double alpha = 0.5;
+  const double t = policy.t_traj.coeff(1) + alpha * dt;
+  const Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+  const Eigen::VectorXd v = Eigen::VectorXd::Random(robot.dimv());
+  evaluator.computeControlInput(t, q, v, u);
+  EXPECT_TRUE(u.isApprox(computeReference(robot, policy, 1, alpha, q, v)));
+}
+
+
+void PolicyEvaluatorTest::testOutOfHorizon(const Robot& robot) const {
+  const auto policy = createPolicy(robot);
+  PolicyEvaluator evaluator(robot, num_stages);
+  evaluator.setPolicy(policy);
+  Eigen::VectorXd u = Eigen::VectorXd::Zero(robot.dimu());
+  const Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+  const Eigen::VectorXd v = Eigen::VectorXd::Random(robot.dimv());
+  // The time beyond the last stage holds the last stage.
+  const double t_end = policy.t_traj.coeff(num_stages-1) + 10 * dt;
+  evaluator.computeControlInput(t_end, q, v, u);
+  EXPECT_TRUE(u.isApprox(computeReference(robot, policy, num_stages-1, 0,
+                                          q, v)));
+  // The time before the first stage holds the first stage.
+  const double t_begin = policy.t_traj.coeff(0) - dt;
+  evaluator.computeControlInput(t_begin, q, v, u);
+  EXPECT_TRUE(u.isApprox(computeReference(robot, policy, 0, 0, q, v)));
+}
+
+
+TEST_F(PolicyEvaluatorTest, fixedBase) {
+  auto robot = testhelper::CreateFixedBaseRobot();
+  testAtGridPoints(robot);
+  testBetweenGridPoints(robot);
+  testOutOfHorizon(robot);
+}
+
+
+TEST_F(PolicyEvaluatorTest, floatingBase) {
+  auto robot = testhelper::CreateFloatingBaseRobot(dt);
+  testAtGridPoints(robot);
+  testBetweenGridPoints(robot);
+  testOutOfHorizon(robot);
+}
+
+
+TEST_F(PolicyEvaluatorTest, singleStage) {
+  auto robot = testhelper::CreateFixedBaseRobot();
+  num_stages = 1;
+  const auto policy = createPolicy(robot);
+  PolicyEvaluator evaluator(robot);
+  evaluator.setPolicy(policy);
+  const Eigen::VectorXd q = robot.generateFeasibleConfiguration();
+  const Eigen::VectorXd v = Eigen::VectorXd::Random(robot.dimv());
+  for (const double t : {t0-dt, t0, t0+dt}) {
+    EXPECT_TRUE(evaluator.computeControlInput(t, q, v).isApprox(
+        computeReference(robot, policy, 0, 0, q, v)));
+  }
+}
+
+} // namespace idocp
+
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
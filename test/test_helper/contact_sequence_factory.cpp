@@ -9,7 +9,8 @@ namespace testhelper {
 ContactSequence CreateContactSequence(const Robot& robot, const int N, 
                                       const int max_num_impulse,
                                       const double t0,
-                                      const double event_period) {
+                                      const double event_period,
+                                      const bool sto) {
   if (robot.maxPointContacts() > 0) {
     std::vector<DiscreteEvent> discrete_events;
     std::vector<double> event_times;
@@ -32,7 +33,7 @@ ContactSequence CreateContactSequence(const Robot& robot, const int N,
       pre_contact_status = post_contact_status;
     }
     for (int i=0; i<max_num_impulse; ++i) {
-      contact_sequence.push_back(discrete_events[i], event_times[i], false);
+      contact_sequence.push_back(discrete_events[i], event_times[i], sto);
     }
     return contact_sequence;
   }
@@ -11,7 +11,8 @@ namespace testhelper {
 ContactSequence CreateContactSequence(const Robot& robot, const int N, 
                                       const int max_num_impulse,
                                       const double t0,
-                                      const double event_period);
+                                      const double event_period,
+                                      const bool sto=false);
 
 } // namespace testhelper
 } // namespace idocp
@@ -0,0 +1,85 @@
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "idocp/utils/triple_buffer.hpp"
+
+
+namespace idocp {
+
+class TripleBufferTest : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+  }
+
+  virtual void TearDown() {
+  }
+};
+
+
+TEST_F(TripleBufferTest, singleThread) {
+  TripleBuffer<int> buffer(-1);
+  EXPECT_EQ(buffer.readBuffer(), -1);
+  EXPECT_FALSE(buffer.hasNewData());
+  EXPECT_FALSE(buffer.update());
+  EXPECT_EQ(buffer.readBuffer(), -1);
+  buffer.writeBuffer() = 1;
+  buffer.publish();
+  EXPECT_TRUE(buffer.hasNewData());
+  EXPECT_TRUE(buffer.update());
+  EXPECT_EQ(buffer.readBuffer(), 1);
+  EXPECT_FALSE(buffer.hasNewData());
+  EXPECT_FALSE(buffer.update());
+  EXPECT_EQ(buffer.readBuffer(), 1);
+  // Only the latest published buffer is taken.
+  buffer.writeBuffer() = 2;
+  buffer.publish();
+  buffer.writeBuffer() = 3;
+  buffer.publish();
+  EXPECT_TRUE(buffer.update());
+  EXPECT_EQ(buffer.readBuffer(), 3);
+  // The producer never writes to the buffer read by the consumer.
+  for (int i=4; i<10; ++i) {
+    buffer.writeBuffer() = i;
+    EXPECT_NE(&buffer.writeBuffer(), &buffer.readBuffer());
+    buffer.publish();
+    EXPECT_EQ(buffer.readBuffer(), 3);
+  }
+  EXPECT_TRUE(buffer.update());
+  EXPECT_EQ(buffer.readBuffer(), 9);
+}
+
+
+TEST_F(TripleBufferTest, multiThread) {
+  const int num_publish = 100000;
+  TripleBuffer<int> buffer(0);
+  std::thread producer([&buffer, num_publish] {
+    for (int i=1; i<=num_publish; ++i) {
+      buffer.writeBuffer() = i;
+      buffer.publish();
+    }
+  });
+  int last = 0;
+  bool is_monotonic = true;
+  while (last < num_publish) {
+    if (buffer.update()) {
+      const int value = buffer.readBuffer();
+      if (value <= last) {
+        is_monotonic = false;
+      }
+      last = value;
+    }
+  }
+  producer.join();
+  EXPECT_TRUE(is_monotonic);
+  EXPECT_EQ(last, num_publish);
+  EXPECT_FALSE(buffer.update());
+}
+
+} // namespace idocp
+
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}